@@ -251,6 +251,13 @@ void appTestRafsStatFs(void *buffer)
     }
 }
 
+static uint32 appTestRafsThroughput(uint32 bytes, uint32 microseconds)
+{
+    if( microseconds == 0 )
+        return 0;
+    return (uint32)(((uint64_t)bytes * 1000000) / microseconds);
+}
+
 void appTestRafsMakeLargeFile(char id, int nsectors, int nrows)
 {
     char filename[RAFS_MOUNTPOINT_LEN+RAFS_MAX_FILELEN];
@@ -262,6 +269,7 @@ void appTestRafsMakeLargeFile(char id, int nsectors, int nrows)
     }
 
     uint32 t1 = VmGetTimerTime();
+    uint32 total = 0;
 
     int sector, row;
     char buff[17];
@@ -277,6 +285,7 @@ void appTestRafsMakeLargeFile(char id, int nsectors, int nrows)
             {
                 DEBUG_LOG_ALWAYS("Rafs_Write=%d",result);
             }
+            total += actual;
         }
     }
     nrows %= 256;
@@ -290,20 +299,60 @@ void appTestRafsMakeLargeFile(char id, int nsectors, int nrows)
         {
             DEBUG_LOG_ALWAYS("Rafs_Write=%d",result);
         }
+        total += actual;
+    }
+
+    /* Closing writes out any buffered data, so it's part of the time taken */
+    result = Rafs_Close(test_rafs_file_id);
+    if( result != RAFS_OK )
+    {
+        DEBUG_LOG_ALWAYS("Rafs_Close=%d",result);
     }
 
     uint32 t2 = VmGetTimerTime();
     uint32 elapsed;
     if( t1 < t2 ) elapsed = t2 - t1;
     else elapsed = t1 - t2;
-    DEBUG_LOG_ALWAYS("appTestRafsMakeLargeFile(%c,%d,%d) took %lu microseconds",
-                     id, nsectors, nrows, elapsed);
+    DEBUG_LOG_ALWAYS("appTestRafsMakeLargeFile(%c,%d,%d) wrote %lu bytes in %lu microseconds, %lu bytes/s",
+                     id, nsectors, nrows, total, elapsed, appTestRafsThroughput(total, elapsed));
+}
 
-    result = Rafs_Close(test_rafs_file_id);
+void appTestRafsReadFile(char id, uint32 buffsize)
+{
+    rafs_file_t from;
+    void *buff = PanicUnlessMalloc(buffsize);
+
+    char filename[RAFS_MOUNTPOINT_LEN+RAFS_MAX_FILELEN];
+    snprintf(filename, sizeof(filename), MOUNT_POINT RAFS_PATH_SEPARATOR "%c_file", id);
+    rafs_errors_t result = Rafs_Open(&test_rafs_task, filename, RAFS_RDONLY, &from);
+    if( result != RAFS_OK )
+    {
+        DEBUG_LOG_ALWAYS("Rafs_Open=%d",result);
+    }
+
+    uint32 t1 = VmGetTimerTime();
+    uint32 total = 0;
+
+    rafs_size_t actual;
+    do {
+        result = Rafs_Read(from, buff, buffsize, &actual);
+        total += actual;
+    } while( result == RAFS_OK && actual == buffsize );
+
+    uint32 t2 = VmGetTimerTime();
+    uint32 elapsed;
+    if( t1 < t2 ) elapsed = t2 - t1;
+    else elapsed = t1 - t2;
+    DEBUG_LOG_ALWAYS("appTestRafsReadFile(%c,%lu) read %lu bytes in %lu microseconds, %lu bytes/s",
+                     id, buffsize, total, elapsed, appTestRafsThroughput(total, elapsed));
+
+    result = Rafs_Close(from);
     if( result != RAFS_OK )
     {
         DEBUG_LOG_ALWAYS("Rafs_Close=%d",result);
     }
+
+    free(buff);
 }
 
 void appTestRafsCopyFile(char fromId, char toId, uint32 buffsize)
@@ -122,13 +122,21 @@ void appTestRafsReadFs(void);
 
 /*!
  * \brief appTestRafsMakeLargeFile
- * Create a large file
+ * Create a large file, with 16 byte writes, and log the write throughput
  * \param id        The id in %c_file
  * \param nsectors  Number of 4KB sectors to fill
  * \param nrows     Number of rows (16 bytes) to append for a partial sector
  */
 void appTestRafsMakeLargeFile(char id, int nsectors, int nrows);
 
+/*!
+ * \brief appTestRafsReadFile
+ * Read a file from start to end, and log the read throughput.
+ * \param id        The id in %c_file
+ * \param buffsize  The number of bytes to read at a time
+ */
+void appTestRafsReadFile(char id, uint32 buffsize);
+
 /*!
  * \brief appTestRafsCopyFile
  * Copy a file into another file
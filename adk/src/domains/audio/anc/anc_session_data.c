@@ -20,6 +20,7 @@ DEBUG_LOG_DEFINE_LEVEL_VAR
 #include <stdlib.h>
 #include <ps_key_map.h>
 #include <ps.h>
+#include <ps_cache.h>
 
 #define anc_session_data_size_words       (sizeof(anc_session_data_t))/(sizeof(uint16))
 
@@ -70,7 +71,7 @@ static void ancSessionData_GetDefaults(anc_session_data_t* session_data)
 static void ancSessionData_ReadFromPS(anc_session_data_t* session_data)
 {
     DEBUG_LOG("ancSessionData_ReadFromPS reading ANC session data from PS\n");
-    PsRetrieve(PS_KEY_ANC_SESSION_DATA, session_data, anc_session_data_size_words);
+    PsCache_Retrieve(PS_KEY_ANC_SESSION_DATA, session_data, anc_session_data_size_words);
 }
 
 static bool ancSessionData_WriteToPS(anc_session_data_t* session_data)
@@ -78,7 +79,7 @@ static bool ancSessionData_WriteToPS(anc_session_data_t* session_data)
     uint16 written_words;
     bool write_status;
 
-    written_words = PsStore(PS_KEY_ANC_SESSION_DATA, session_data, anc_session_data_size_words);
+    written_words = PsCache_StoreNow(PS_KEY_ANC_SESSION_DATA, session_data, anc_session_data_size_words);
 
     if (written_words != anc_session_data_size_words)
     {
@@ -103,13 +104,13 @@ static bool ancSessionData_isSameAsStorage(anc_session_data_t* session_data)
     uint16 *anc_session_ps_data;
     bool storage_status = FALSE;
 
-    current_size_words = PsRetrieve(PS_KEY_ANC_SESSION_DATA, NULL, 0);
+    current_size_words = PsCache_Retrieve(PS_KEY_ANC_SESSION_DATA, NULL, 0);
 
     if(current_size_words != 0)
     {
         anc_session_ps_data = PanicUnlessMalloc(sizeof(anc_session_data_t));
 
-        PsRetrieve(PS_KEY_ANC_SESSION_DATA, anc_session_ps_data, anc_session_data_size_words);
+        PsCache_Retrieve(PS_KEY_ANC_SESSION_DATA, anc_session_ps_data, anc_session_data_size_words);
         storage_status = (memcmp(anc_session_ps_data, session_data, sizeof(anc_session_data_t)) == 0);
 
         free(anc_session_ps_data);
@@ -124,7 +125,7 @@ void AncSessionData_GetSessionData(anc_session_data_t* session_data)
 {
     uint16 current_size_words;
 
-    current_size_words = PsRetrieve(PS_KEY_ANC_SESSION_DATA, NULL, 0);
+    current_size_words = PsCache_Retrieve(PS_KEY_ANC_SESSION_DATA, NULL, 0);
 
     if (current_size_words != 0)
     { 
@@ -35,6 +35,7 @@
 #include "mirror_profile.h"
 #include "anc_state_manager.h"
 #include <vmal.h>
+#include <system_clock.h>
 #include "kymera_usb_audio.h"
 #include "kymera_usb_voice.h"
 #include "kymera_usb_sco.h"
@@ -465,6 +466,7 @@ void appKymeraPromptPlay(FILE_INDEX prompt, promptFormat format, uint32 rate, rt
     message->interruptible = interruptible;
     message->client_lock = client_lock;
     message->client_lock_mask = client_lock_mask;
+    message->request_time = SystemClockGetTimerTime();
 
     MessageCancelFirst(&theKymera->task, KYMERA_INTERNAL_PREPARE_FOR_PROMPT_TIMEOUT);
     MessageSendConditionally(&theKymera->task, KYMERA_INTERNAL_TONE_PROMPT_PLAY, message, &theKymera->lock);
@@ -487,6 +489,7 @@ void appKymeraTonePlay(const ringtone_note *tone, rtime_t ttp, bool interruptibl
     message->interruptible = interruptible;
     message->client_lock = client_lock;
     message->client_lock_mask = client_lock_mask;
+    message->request_time = SystemClockGetTimerTime();
 
     MessageCancelFirst(&theKymera->task, KYMERA_INTERNAL_PREPARE_FOR_PROMPT_TIMEOUT);
     MessageSendConditionally(&theKymera->task, KYMERA_INTERNAL_TONE_PROMPT_PLAY, message, &theKymera->lock);
@@ -863,6 +866,10 @@ static void kymera_msg_handler(Task task, MessageId id, Message msg)
             appKymeraTonePromptStop();
         break;
 
+        case KYMERA_INTERNAL_PROMPT_KEEP_WARM:
+            appKymeraHandleInternalPromptKeepWarm();
+        break;
+
         case KYMERA_INTERNAL_ANC_TUNING_START:
             KymeraAnc_TuningCreateChain((const KYMERA_INTERNAL_ANC_TUNING_START_T *)msg);
         break;
@@ -1556,7 +1563,8 @@ static void appKymeraHandleInternalLeaMicSynchronised(void)
 
 void appKymeraUsbAudioStart(uint8 channels, uint8 frame_size, Source src,
                             int16 volume_in_db, bool mute_status, uint32 rate,
-                            uint32 min_latency, uint32 max_latency, uint32 target_latency)
+                            uint32 min_latency, uint32 max_latency, uint32 target_latency,
+                            bool host_rate_feedback)
 {
     DEBUG_LOG("appKymeraUsbAudioStart");
     kymeraTaskData *theKymera = KymeraGetTaskData();
@@ -1571,6 +1579,7 @@ void appKymeraUsbAudioStart(uint8 channels, uint8 frame_size, Source src,
     message->min_latency_ms = min_latency;
     message->max_latency_ms = max_latency;
     message->target_latency_ms = target_latency;
+    message->host_rate_feedback = host_rate_feedback;
 
     MessageSendConditionally(&theKymera->task, KYMERA_INTERNAL_USB_AUDIO_START, message, &theKymera->lock);
 }
@@ -1599,6 +1608,11 @@ void appKymeraUsbAudioSetVolume(int16 volume_in_db)
     MessageSendConditionally(&theKymera->task, KYMERA_INTERNAL_USB_AUDIO_SET_VOL, message, &theKymera->lock);
 }
 
+bool appKymeraUsbAudioGetRateMismatch(int32 *mismatch_ppm)
+{
+    return KymeraUsbAudio_GetRateMismatch(mismatch_ppm);
+}
+
 void appKymeraUsbVoiceStart(usb_voice_mode_t mode, uint8 spkr_channels, uint8 spkr_frame_size,
                             uint32 spkr_sample_rate, uint32 mic_sample_rate, Source spkr_src,
                             Sink mic_sink, int16 volume_in_db, uint32 min_latency, uint32 max_latency,
@@ -996,11 +996,13 @@ void Kymera_LeAudioSyncMute(void);
     \param min_latency TTP minimum value in micro-seconds
     \param max_latency TTP max value in micro-seconds
     \param target_latency TTP default value in micro-seconds
+    \param host_rate_feedback TRUE if the host adapts its rate to a feedback
+           endpoint, so the chain must not correct the drift itself
 */
 void appKymeraUsbAudioStart(uint8 channels, uint8 frame_size,
                             Source src, int16 volume_in_db, bool mute_status,
                             uint32 rate, uint32 min_latency, uint32 max_latency,
-                            uint32 target_latency);
+                            uint32 target_latency, bool host_rate_feedback);
 
 /*! \brief Stop and destroy USB Audio chain.
     \param Source USB OUT endpoint source.
@@ -1014,6 +1016,13 @@ void appKymeraUsbAudioStop(Source usb_src,
 */
 void appKymeraUsbAudioSetVolume(int16 volume_in_db);
 
+/*! \brief Get the rate mismatch measured by the USB Audio chain.
+    \param mismatch_ppm Set to the mismatch between the local clock and the
+           USB packet rate in ppm, positive when the local clock is faster.
+    \return TRUE if the mismatch was read, FALSE if USB Audio is not active.
+*/
+bool appKymeraUsbAudioGetRateMismatch(int32 *mismatch_ppm);
+
 /*! \brief Create and start USB Voice.
     \param mode Type of mode (NB/WB etc)
     \param spkr_channels number of channels for speaker.
@@ -1071,6 +1080,25 @@ bool Kymera_PrepareForPrompt(promptFormat format, uint16 sample_rate);
  */
 bool Kymera_IsReadyForPrompt(promptFormat format, uint16 sample_rate);
 
+/*! \brief Keep the prompt chain ready while other audio is using the output chain.
+
+    Once a prompt has been played, a chain for the same format is created and
+    connected to the output chain's aux input whenever another user connects
+    to the output chain, and again after each tone or prompt. Prompts then
+    start without building or connecting a chain. Tones still use a chain
+    built on demand.
+
+    \param[in] enable TRUE to keep the chain ready, FALSE to build it on demand.
+ */
+void Kymera_SetPromptKeepWarm(bool enable);
+
+/*! \brief Cache the most frequently played short prompts in RAM.
+
+    \param[in] enable TRUE to enable the cache, FALSE to disable it and free
+               its memory.
+ */
+void Kymera_EnablePromptCache(bool enable);
+
 /*! \brief Get the stream transform connecting the A2DP media source to kymera
     \return The transform, or 0 if the A2DP audio chains are not active.
     \note This function will always return 0 if INCLUDE_MIRRORING is undefined.
@@ -26,6 +26,8 @@ static bool appKymeraA2dpMirrorMarshal(const tp_bdaddr *tp_bd_addr,
                        uint16 length,
                        uint16 *written);
 
+static uint16 appKymeraA2dpMirrorEstimateSize(const tp_bdaddr *tp_bd_addr);
+
 static bool appKymeraA2dpMirrorUnmarshal(const tp_bdaddr *tp_bd_addr,
                          const uint8 *buf,
                          uint16 length,
@@ -40,12 +42,15 @@ static void appKymeraA2dpMirrorHandoverComplete(const bool newRole);
 static void appKymeraA2dpMirrorHandoverAbort(void);
 
 const handover_interface kymera_a2dp_mirror_handover_if =
-        MAKE_BREDR_HANDOVER_IF(&appKymeraA2dpMirrorVeto,
-                               &appKymeraA2dpMirrorMarshal,
-                               &appKymeraA2dpMirrorUnmarshal,
-                               &appKymeraA2dpMirrorHandoverCommit,
-                               &appKymeraA2dpMirrorHandoverComplete,
-                               &appKymeraA2dpMirrorHandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                                  &appKymeraA2dpMirrorVeto,
+                                  NULL,
+                                  &appKymeraA2dpMirrorEstimateSize,
+                                  &appKymeraA2dpMirrorMarshal,
+                                  &appKymeraA2dpMirrorUnmarshal,
+                                  &appKymeraA2dpMirrorHandoverCommit,
+                                  &appKymeraA2dpMirrorHandoverComplete,
+                                  &appKymeraA2dpMirrorHandoverAbort);
 
 /******************************************************************************
  * Local Function Definitions
@@ -161,6 +166,20 @@ static bool appKymeraA2dpMirrorMarshal(const tp_bdaddr *tp_bd_addr,
     }
     return result;
 }
+
+/*! \brief Estimate the size of the data marshalled for TWM kymera A2DP
+ *  \return An upper bound of the bytes appKymeraA2dpMirrorMarshal() writes.
+ */
+static uint16 appKymeraA2dpMirrorEstimateSize(const tp_bdaddr *tp_bd_addr)
+{
+    UNUSED(tp_bd_addr);
+#ifdef INCLUDE_LATENCY_MANAGER
+    return Kymera_DynamicLatencyMarshalledSize() + Kymera_LatencyManagerMarshalledSize();
+#else
+    return 0;
+#endif
+}
+
 /*! \brief Handle request for unmarshalling data (if any) associated with
  *         TWM kymera A2DP
  *  \return TRUE if data unmarshalling is complete, FALSE otherwise.
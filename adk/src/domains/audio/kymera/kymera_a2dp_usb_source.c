@@ -95,6 +95,10 @@ static void kymeraA2dpUsbSource_ConfigureUsbRx(const KYMERA_INTERNAL_USB_AUDIO_S
 
     OperatorsConfigureUsbAudio(usb_rx_op, config);
 
+    /* The host follows our clock via the feedback endpoint, so the drift
+       must not also be corrected by rate matching in the chain */
+    OperatorsUsbAudioSetHostRateFeedback(usb_rx_op, usb_params->host_rate_feedback);
+
     /* In USB chains, the USB RX operator acts as the Time-To-Play buffer. */
     kymeraA2dpSource_ConfigureTtpBufferParams(usb_rx_op,
                                               usb_params->min_latency_ms,
@@ -251,6 +255,19 @@ void KymeraUsbAudio_Stop(KYMERA_INTERNAL_USB_AUDIO_STOP_T *audio_params)
     }
 }
 
+bool KymeraUsbAudio_GetRateMismatch(int32 *mismatch_ppm)
+{
+    Operator usb_rx_op;
+
+    if (appKymeraGetState() != KYMERA_STATE_USB_AUDIO_ACTIVE)
+    {
+        return FALSE;
+    }
+
+    usb_rx_op = ChainGetOperatorByRole(KymeraGetTaskData()->chain_input_handle, OPR_USB_AUDIO_RX);
+    return (usb_rx_op != INVALID_OPERATOR) && OperatorsUsbAudioGetRateMismatch(usb_rx_op, mismatch_ppm);
+}
+
 void KymeraUsbAudio_SetVolume(int16 volume_in_db)
 {
     UNUSED(volume_in_db);
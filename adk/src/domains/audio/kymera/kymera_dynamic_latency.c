@@ -143,6 +143,11 @@ uint16 Kymera_DynamicLatencyMarshal(uint8 *buf, uint16 length)
     return written;
 }
 
+uint16 Kymera_DynamicLatencyMarshalledSize(void)
+{
+    return sizeof(kymera_dynamic_latency_data_t);
+}
+
 uint16 Kymera_DynamicLatencyUnmarshal(const uint8 *buf, uint16 length)
 {
     uint16 read = 0;
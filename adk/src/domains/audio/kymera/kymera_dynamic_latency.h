@@ -103,6 +103,9 @@ void Kymera_DynamicLatencyHandleLatencyTimeout(void);
 */
 uint16 Kymera_DynamicLatencyMarshal(uint8 *buf, uint16 length);
 
+/*! \brief Get the number of bytes Kymera_DynamicLatencyMarshal() writes. */
+uint16 Kymera_DynamicLatencyMarshalledSize(void);
+
 /*! \brief Unarshal dynamic latency data.
     \param buf The buffer to read from.
     \param length The data in the buffer in bytes.
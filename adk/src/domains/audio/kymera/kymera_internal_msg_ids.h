@@ -119,6 +119,8 @@ enum app_kymera_internal_message_ids
     KYMERA_INTERNAL_USB_VOICE_MIC_MUTE,
     /*! Internal message indicating timeout waiting for prompt play */
     KYMERA_INTERNAL_PREPARE_FOR_PROMPT_TIMEOUT,
+    /*! Internal message to make the prompt chain ready while other audio is active */
+    KYMERA_INTERNAL_PROMPT_KEEP_WARM,
     /*! Internal message to retry mic connection for client ANC */
     KYMERA_INTERNAL_MIC_CONNECTION_TIMEOUT_ANC,
     /*! Internal message to retry connecting self speech after ANC transition is complete*/
@@ -679,6 +679,11 @@ uint16 Kymera_LatencyManagerMarshal(uint8 *buf, uint16 length)
     return bytes_written;
 }
 
+uint16 Kymera_LatencyManagerMarshalledSize(void)
+{
+    return sizeof(KymeraGetLatencyData()->current_latency);
+}
+
 uint16 Kymera_LatencyManagerUnmarshal(const uint8 *buf, uint16 length)
 {
     uint16 bytes_read = 0;
@@ -202,6 +202,9 @@ bool Kymera_LatencyManagerSetOverrideLatency(uint32 latency_ms);
 */
 uint16 Kymera_LatencyManagerMarshal(uint8 *buf, uint16 length);
 
+/*! \brief Get the number of bytes Kymera_LatencyManagerMarshal() writes. */
+uint16 Kymera_LatencyManagerMarshalledSize(void);
+
 /*! \brief Unarshal latency data.
     \param buf The buffer to read from.
     \param length The data in the buffer in bytes.
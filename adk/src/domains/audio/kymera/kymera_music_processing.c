@@ -19,6 +19,7 @@
 #include <operators.h>
 #include <ps.h>
 #include <ps_key_map.h>
+#include <ps_cache.h>
 
 #define PS_KEY_USER_EQ_PRESET_INDEX    0
 #define PS_KEY_USER_EQ_START_GAINS_INDEX    1
@@ -283,7 +284,7 @@ static void kymera_StoreBankToPsStore(void)
         data[i + 1] = KymeraGetTaskData()->eq.user.params[i].gain;
     }
 
-    PsStore(PS_KEY_USER_EQ, data, num_of_words);
+    PsCache_Store(PS_KEY_USER_EQ, data, num_of_words);
 
     free(data);
 
@@ -591,13 +592,13 @@ static void kymera_GetUserEqParamsFromPsStorage(void)
         kymera_GetEqParamsFromPsKey(USER_EQ_PSKEY, i, &theKymera->eq.user.params[i]);
     }
 
-    uint16 ps_key_size = PsRetrieve(PS_KEY_USER_EQ, NULL, 0);
+    uint16 ps_key_size = PsCache_Retrieve(PS_KEY_USER_EQ, NULL, 0);
 
     if(ps_key_size)
     {
         uint16 *data = PanicUnlessMalloc(ps_key_size * sizeof(uint16));
         uint16 retrieved_data_size = 0;
-        retrieved_data_size = PsRetrieve(PS_KEY_USER_EQ, data, ps_key_size);
+        retrieved_data_size = PsCache_Retrieve(PS_KEY_USER_EQ, data, ps_key_size);
         if(retrieved_data_size != ps_key_size)
         {
             Panic();
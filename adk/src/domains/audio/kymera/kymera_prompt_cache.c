@@ -0,0 +1,332 @@
+/*!
+\copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+            All Rights Reserved.
+            Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+\file
+\brief      RAM cache of the most frequently played short prompts.
+*/
+
+#include "kymera_prompt_cache.h"
+#include "kymera.h"
+
+#include <message.h>
+#include <panic.h>
+#include <logging.h>
+#include <stream.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! Number of prompts whose plays are counted, cached or not. */
+#ifndef KYMERA_PROMPT_CACHE_ENTRIES
+#define KYMERA_PROMPT_CACHE_ENTRIES         (6)
+#endif
+
+/*! Total RAM, in bytes, the cached prompts may use. */
+#ifndef KYMERA_PROMPT_CACHE_SIZE
+#define KYMERA_PROMPT_CACHE_SIZE            (6144)
+#endif
+
+/*! Longest prompt file, in bytes, that is cached. */
+#ifndef KYMERA_PROMPT_CACHE_MAX_PROMPT_SIZE
+#define KYMERA_PROMPT_CACHE_MAX_PROMPT_SIZE (3072)
+#endif
+
+/*! Plays after which a prompt is cached. */
+#ifndef KYMERA_PROMPT_CACHE_ADMIT_PLAYS
+#define KYMERA_PROMPT_CACHE_ADMIT_PLAYS     (2)
+#endif
+
+/*! Play count at which every count is halved, so prompts that were
+    frequent a long time ago make way for the current ones. */
+#define KYMERA_PROMPT_CACHE_MAX_PLAYS       (0xFF)
+
+/*! Internal message to cache the prompts played often enough. */
+#define KYMERA_PROMPT_CACHE_INTERNAL_LOAD   (0)
+
+/*! \brief A prompt being counted, and its content if cached. */
+typedef struct
+{
+    /*! The prompt file content, NULL if not cached. */
+    uint8 *data;
+
+    /*! The prompt file, FILE_NONE if the entry is free. */
+    FILE_INDEX prompt;
+
+    /*! Length of \c data in bytes. */
+    uint16 size;
+
+    /*! Recent plays of the prompt. */
+    uint8 plays;
+
+    /*! TRUE if the prompt is too long to cache. */
+    bool too_long:1;
+} kymera_prompt_cache_entry_t;
+
+typedef struct
+{
+    /*! Task for loading prompts into the cache. */
+    TaskData task;
+
+    kymera_prompt_cache_entry_t entries[KYMERA_PROMPT_CACHE_ENTRIES];
+
+    /*! The entry being streamed from, which must not be evicted. */
+    kymera_prompt_cache_entry_t *in_use;
+
+    /*! Total length of the cached prompts, in bytes. */
+    uint16 bytes_used;
+
+    bool enabled;
+} kymera_prompt_cache_t;
+
+static void kymeraPromptCache_HandleMessage(Task task, MessageId id, Message message);
+
+static kymera_prompt_cache_t prompt_cache =
+{
+    .task = { .handler = kymeraPromptCache_HandleMessage },
+};
+
+#define kymeraPromptCache_ForEachEntry(entry) \
+    for ((entry) = prompt_cache.entries; (entry) < &prompt_cache.entries[KYMERA_PROMPT_CACHE_ENTRIES]; (entry)++)
+
+static void kymeraPromptCache_Evict(kymera_prompt_cache_entry_t *entry)
+{
+    if (entry->data)
+    {
+        DEBUG_LOG_VERBOSE("kymeraPromptCache_Evict prompt %u, %u bytes", entry->prompt, entry->size);
+        prompt_cache.bytes_used -= entry->size;
+        free(entry->data);
+        entry->data = NULL;
+        entry->size = 0;
+    }
+}
+
+static void kymeraPromptCache_Forget(kymera_prompt_cache_entry_t *entry)
+{
+    kymeraPromptCache_Evict(entry);
+    memset(entry, 0, sizeof(*entry));
+    entry->prompt = FILE_NONE;
+}
+
+/*! \brief Check if \p a should be reused before \p b.
+    Entries without content go first, then the least played. */
+static bool kymeraPromptCache_IsBetterVictim(const kymera_prompt_cache_entry_t *a, const kymera_prompt_cache_entry_t *b)
+{
+    if ((a->data == NULL) != (b->data == NULL))
+    {
+        return (a->data == NULL);
+    }
+    return (a->plays < b->plays);
+}
+
+/*! \brief Find the entry for a prompt, taking over the least useful entry
+           if it isn't being counted yet. */
+static kymera_prompt_cache_entry_t *kymeraPromptCache_Track(FILE_INDEX prompt)
+{
+    kymera_prompt_cache_entry_t *entry;
+    kymera_prompt_cache_entry_t *victim = NULL;
+
+    kymeraPromptCache_ForEachEntry(entry)
+    {
+        if (entry->prompt == prompt)
+        {
+            return entry;
+        }
+        if (entry != prompt_cache.in_use &&
+            (victim == NULL || kymeraPromptCache_IsBetterVictim(entry, victim)))
+        {
+            victim = entry;
+        }
+    }
+
+    PanicNull(victim);
+    kymeraPromptCache_Forget(victim);
+    victim->prompt = prompt;
+    return victim;
+}
+
+static void kymeraPromptCache_CountPlay(kymera_prompt_cache_entry_t *entry)
+{
+    if (++entry->plays == KYMERA_PROMPT_CACHE_MAX_PLAYS)
+    {
+        kymera_prompt_cache_entry_t *aged;
+
+        kymeraPromptCache_ForEachEntry(aged)
+        {
+            aged->plays /= 2;
+        }
+    }
+}
+
+static bool kymeraPromptCache_IsWorthLoading(const kymera_prompt_cache_entry_t *entry)
+{
+    return (entry->prompt != FILE_NONE) && (entry->data == NULL) && !entry->too_long &&
+           (entry->plays >= KYMERA_PROMPT_CACHE_ADMIT_PLAYS);
+}
+
+/*! \brief Copy a prompt file into RAM.
+    \return The content, or NULL if the file is longer than
+            KYMERA_PROMPT_CACHE_MAX_PROMPT_SIZE or can't be read. */
+static uint8 *kymeraPromptCache_ReadFile(FILE_INDEX prompt, uint16 *size)
+{
+    Source source = StreamFileSource(prompt);
+    uint8 *data = NULL;
+    uint16 length = 0;
+    uint16 available;
+
+    if (source == NULL)
+    {
+        return NULL;
+    }
+
+    while ((available = SourceSize(source)) != 0)
+    {
+        if (available > KYMERA_PROMPT_CACHE_MAX_PROMPT_SIZE - length)
+        {
+            free(data);
+            data = NULL;
+            length = 0;
+            break;
+        }
+        data = PanicNull(realloc(data, length + available));
+        memcpy(&data[length], SourceMap(source), available);
+        SourceDrop(source, available);
+        length += available;
+    }
+
+    SourceClose(source);
+    *size = length;
+    return data;
+}
+
+/*! \brief Evict prompts played less than \p plays until \p size bytes are free.
+    \return TRUE if there is room. */
+static bool kymeraPromptCache_MakeRoom(uint16 size, uint8 plays)
+{
+    while (prompt_cache.bytes_used + size > KYMERA_PROMPT_CACHE_SIZE)
+    {
+        kymera_prompt_cache_entry_t *entry;
+        kymera_prompt_cache_entry_t *victim = NULL;
+
+        kymeraPromptCache_ForEachEntry(entry)
+        {
+            if (entry->data && entry != prompt_cache.in_use && entry->plays < plays &&
+                (victim == NULL || entry->plays < victim->plays))
+            {
+                victim = entry;
+            }
+        }
+
+        if (victim == NULL)
+        {
+            return FALSE;
+        }
+        kymeraPromptCache_Evict(victim);
+    }
+    return TRUE;
+}
+
+static void kymeraPromptCache_Load(kymera_prompt_cache_entry_t *entry)
+{
+    uint16 size = 0;
+    uint8 *data = kymeraPromptCache_ReadFile(entry->prompt, &size);
+
+    if (data == NULL)
+    {
+        DEBUG_LOG_INFO("kymeraPromptCache_Load prompt %u not cacheable", entry->prompt);
+        entry->too_long = TRUE;
+    }
+    else if (kymeraPromptCache_MakeRoom(size, entry->plays))
+    {
+        entry->data = data;
+        entry->size = size;
+        prompt_cache.bytes_used += size;
+        DEBUG_LOG_INFO("kymeraPromptCache_Load prompt %u, %u bytes, plays %u, %u bytes used",
+                       entry->prompt, size, entry->plays, prompt_cache.bytes_used);
+    }
+    else
+    {
+        free(data);
+    }
+}
+
+static void kymeraPromptCache_HandleMessage(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    UNUSED(message);
+
+    if (id == KYMERA_PROMPT_CACHE_INTERNAL_LOAD && prompt_cache.enabled)
+    {
+        kymera_prompt_cache_entry_t *entry;
+
+        kymeraPromptCache_ForEachEntry(entry)
+        {
+            if (kymeraPromptCache_IsWorthLoading(entry))
+            {
+                kymeraPromptCache_Load(entry);
+            }
+        }
+    }
+}
+
+Source KymeraPromptCache_GetSource(FILE_INDEX prompt, bool *cached)
+{
+    Source source = NULL;
+
+    if (prompt_cache.enabled)
+    {
+        kymera_prompt_cache_entry_t *entry = kymeraPromptCache_Track(prompt);
+
+        kymeraPromptCache_CountPlay(entry);
+        if (entry->data)
+        {
+            /* The region source goes away once it has all been read, which
+               disconnects the stream just as the end of a file does. */
+            source = StreamRegionSource(entry->data, entry->size);
+            prompt_cache.in_use = source ? entry : NULL;
+        }
+        else if (kymeraPromptCache_IsWorthLoading(entry))
+        {
+            /* Reading the file now would delay this play, cache it for the next one */
+            MessageCancelAll(&prompt_cache.task, KYMERA_PROMPT_CACHE_INTERNAL_LOAD);
+            MessageSend(&prompt_cache.task, KYMERA_PROMPT_CACHE_INTERNAL_LOAD, NULL);
+        }
+    }
+
+    *cached = (source != NULL);
+    if (source == NULL)
+    {
+        source = StreamFileSource(prompt);
+    }
+    return source;
+}
+
+void KymeraPromptCache_ReleaseSource(void)
+{
+    kymera_prompt_cache_entry_t *entry = prompt_cache.in_use;
+
+    prompt_cache.in_use = NULL;
+    if (entry && !prompt_cache.enabled)
+    {
+        kymeraPromptCache_Forget(entry);
+    }
+}
+
+void Kymera_EnablePromptCache(bool enable)
+{
+    DEBUG_LOG("Kymera_EnablePromptCache %u", enable);
+
+    if (!enable)
+    {
+        kymera_prompt_cache_entry_t *entry;
+
+        MessageCancelAll(&prompt_cache.task, KYMERA_PROMPT_CACHE_INTERNAL_LOAD);
+        kymeraPromptCache_ForEachEntry(entry)
+        {
+            if (entry != prompt_cache.in_use)
+            {
+                kymeraPromptCache_Forget(entry);
+            }
+        }
+    }
+    prompt_cache.enabled = enable;
+}
@@ -0,0 +1,46 @@
+/*!
+\copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+            All Rights Reserved.
+            Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+\file
+\brief      RAM cache of the most frequently played short prompts.
+
+            A prompt is normally streamed from the file system each time it
+            plays. Once a prompt has been played a few times, and if it is
+            short enough, its file content is copied into RAM and later plays
+            stream it from there with StreamRegionSource().
+
+            The content is cached as it is stored in the file, so PCM prompts
+            are held already decoded while SBC and AAC prompts still go through
+            the decoder in the prompt chain. Their decoded PCM is not kept: no
+            DSP capability holds audio between chains, and the encoded content
+            is several times smaller, so more prompts fit in the same RAM. With
+            Kymera_SetPromptKeepWarm() the decoder is already running when the
+            prompt starts.
+
+            The cache is disabled until Kymera_EnablePromptCache() is called.
+*/
+
+#ifndef KYMERA_PROMPT_CACHE_H
+#define KYMERA_PROMPT_CACHE_H
+
+#include <file.h>
+#include <source.h>
+
+/*! \brief Get a source for a prompt about to be played.
+
+    Counts the play, and queues the prompt to be cached once it has been
+    played often enough.
+
+    \param prompt   The prompt file.
+    \param cached   Set to TRUE if the source streams from the cache.
+
+    \return The source, from the cache or the file system.
+*/
+Source KymeraPromptCache_GetSource(FILE_INDEX prompt, bool *cached);
+
+/*! \brief Tell the cache the source from KymeraPromptCache_GetSource() has
+           been closed, so its content may be evicted. */
+void KymeraPromptCache_ReleaseSource(void);
+
+#endif // KYMERA_PROMPT_CACHE_H
@@ -19,8 +19,10 @@
 #include "kymera_msg.h"
 #include "kymera_op_msg.h"
 #include "kymera_fit_test.h"
+#include "kymera_prompt_cache.h"
 #include "system_clock.h"
 #include "timestamp_event.h"
+#include "metrics.h"
 #include <operators.h>
 
 #define BUFFER_SIZE_FACTOR 4
@@ -42,6 +44,7 @@
 #define PROMPT_TASK ((Task)&prompt_handler)
 
 static kymera_chain_handle_t kymera_GetTonePromptChain(void);
+static bool kymera_TonePromptIsReady(void);
 
 static void kymera_SetupPromptSource(Source source);
 static void kymera_ClosePromptSource(Source source);
@@ -49,6 +52,8 @@ static void kymera_ClosePromptSource(Source source);
 static bool kymera_OutputDisconnectRequest(void);
 static void kymera_PrepareForOutputChainDisconnect(void);
 static void kymera_CompleteOutputChainDisconnect(void);
+static void kymera_OutputConnectingIndication(output_users_t connecting_user, output_connection_t connection_type);
+static void kymera_OutputDisconnectedIndication(output_users_t disconnected_user, output_connection_t connection_type);
 
 static const output_callbacks_t output_callbacks =
 {
@@ -66,6 +71,12 @@ static const output_registry_entry_t output_info =
     .callbacks = &output_callbacks,
 };
 
+static const output_indications_registry_entry_t output_indications =
+{
+    .OutputConnectingIndication = kymera_OutputConnectingIndication,
+    .OutputDisconnectedIndication = kymera_OutputDisconnectedIndication,
+};
+
 static void kymera_PromptMsgHandler(Task task, MessageId id, Message msg);
 static const TaskData prompt_handler = {kymera_PromptMsgHandler};
 
@@ -77,11 +88,71 @@ static enum
     kymera_tone_playing
 } kymera_tone_state = kymera_tone_idle;
 
+/*! State of the prompt chain kept ready while other audio is active */
+static struct
+{
+    /*! Set by Kymera_SetPromptKeepWarm() */
+    bool enabled;
+    /*! TRUE once a prompt has been played, so format and rate are known */
+    bool format_known;
+    /*! TRUE while the chain has been made ready to keep it warm */
+    bool active;
+    /*! TRUE while the chain output is connected to the aux input without playing */
+    bool connected;
+    promptFormat format;
+    uint32 rate;
+} prompt_keep_warm;
+
+/*! TRUE if the prompt playing, or last played, streams from the prompt cache */
+static bool prompt_from_cache;
+
+METRIC_HISTOGRAM(prompt_sound_latency, METRIC_ID_PROMPT_SOUND_LATENCY_MS, 10, 20, 50, 100, 200, 500);
+METRIC_HISTOGRAM(cached_prompt_sound_latency, METRIC_ID_CACHED_PROMPT_SOUND_LATENCY_MS, 10, 20, 50, 100, 200, 500);
+METRIC_HISTOGRAM(warm_prompt_sound_latency, METRIC_ID_WARM_PROMPT_SOUND_LATENCY_MS, 10, 20, 50, 100, 200, 500);
+METRIC_COUNTER(prompts_played_from_cache, METRIC_ID_PROMPTS_PLAYED_FROM_CACHE);
+
+static Source kymera_OpenPromptSource(FILE_INDEX prompt)
+{
+    Source source = KymeraPromptCache_GetSource(prompt, &prompt_from_cache);
+
+    if (prompt_from_cache)
+    {
+        Metrics_Increment(prompts_played_from_cache);
+    }
+    return source;
+}
+
+static bool kymera_IsOutputInUseByOthers(void)
+{
+    return (Kymera_OutputGetConnectedUsers() & ~output_user_prompt) != output_user_none;
+}
+
+static void kymera_ScheduleKeepWarm(void)
+{
+    if (prompt_keep_warm.enabled && prompt_keep_warm.format_known)
+    {
+        kymeraTaskData *theKymera = KymeraGetTaskData();
+
+        /* Wait for the user connecting, or whatever stopped the prompt, to finish with the chains */
+        MessageCancelAll(&theKymera->task, KYMERA_INTERNAL_PROMPT_KEEP_WARM);
+        MessageSendConditionally(&theKymera->task, KYMERA_INTERNAL_PROMPT_KEEP_WARM, NULL, &theKymera->lock);
+    }
+}
+
+/*! \brief Release a chain kept warm, so it doesn't hold the output chain up */
+static void kymera_StopKeepWarm(void)
+{
+    if (prompt_keep_warm.active && kymera_TonePromptIsReady())
+    {
+        MessageSend(&KymeraGetTaskData()->task, KYMERA_INTERNAL_PREPARE_FOR_PROMPT_TIMEOUT, NULL);
+    }
+}
+
 static void kymera_StartPromptSource(FILE_INDEX prompt)
 {
     kymeraTaskData *theKymera = KymeraGetTaskData();
 
-    theKymera->prompt_source = PanicNull(StreamFileSource(prompt));
+    theKymera->prompt_source = PanicNull(kymera_OpenPromptSource(prompt));
     kymera_SetupPromptSource(theKymera->prompt_source);
     PanicFalse(ChainConnectInput(kymera_GetTonePromptChain(), theKymera->prompt_source, EPR_PROMPT_IN));
     KymeraOutput_SetAuxVolume(KYMERA_CONFIG_PROMPT_VOLUME);
@@ -145,6 +216,7 @@ static void kymera_ClosePromptSource(Source source)
         MessageStreamTaskFromSource(source, NULL);
         StreamDisconnect(source, NULL);
         SourceClose(source);
+        KymeraPromptCache_ReleaseSource();
     }
 }
 
@@ -266,8 +338,8 @@ static Source kymera_ConfigurePromptChain(const KYMERA_INTERNAL_TONE_PROMPT_PLAY
 {
     kymeraTaskData *theKymera = KymeraGetTaskData();
     theKymera->prompt = msg->prompt;
-    theKymera->prompt_source = PanicNull(StreamFileSource(msg->prompt));
-    DEBUG_LOG("kymera_ConfigurePromptChain prompt %u", msg->prompt);
+    theKymera->prompt_source = PanicNull(kymera_OpenPromptSource(msg->prompt));
+    DEBUG_LOG("kymera_ConfigurePromptChain prompt %u, cached %u", msg->prompt, prompt_from_cache);
     kymera_SetupPromptSource(theKymera->prompt_source);
 
     if (kymera_GetTonePromptChain())
@@ -323,7 +395,9 @@ static bool kymera_IsTheCorrectTonePromptChainReady(const KYMERA_INTERNAL_TONE_P
 {
     bool tone_chain_is_ready = ((kymera_tone_state == kymera_tone_ready_tone) && msg->tone != NULL);
     bool prompt_chain_is_ready = (((kymera_tone_state == kymera_tone_ready_prompt) && msg->prompt != FILE_NONE) &&
-                                               kymera_IsTheCorrectPromptChainReady(msg->prompt_format));
+                                               kymera_IsTheCorrectPromptChainReady(msg->prompt_format) &&
+                                               /* A chain kept warm is connected at the rate it was made ready for */
+                                               (!prompt_keep_warm.connected || msg->rate == prompt_keep_warm.rate));
     bool correct_chain_is_ready = tone_chain_is_ready || prompt_chain_is_ready;
 
     DEBUG_LOG("kymera_IsTheCorrectTonePromptChainReady %u, tone ready %u, prompt ready %u",
@@ -386,11 +460,47 @@ static Source kymera_PrepareInputChain(const KYMERA_INTERNAL_TONE_PROMPT_PLAY_T
     return output;
 }
 
+/*! \brief Record the latency of a tone or prompt whose chain has just been started.
+    \param msg The request.
+    \param chain_was_ready TRUE if the chain was ready when the request was handled.
+    \param ttp_set TRUE if the first sample plays at the request's time to play,
+           otherwise it plays as soon as the chain starts. */
+static void kymera_RecordPromptLatency(const KYMERA_INTERNAL_TONE_PROMPT_PLAY_T *msg, bool chain_was_ready, bool ttp_set)
+{
+    rtime_t started = SystemClockGetTimerTime();
+    rtime_t sounded = (ttp_set && rtime_gt(msg->time_to_play, started)) ? msg->time_to_play : started;
+    uint32 setup_us = (uint32)rtime_sub(started, msg->request_time);
+    uint32 sound_us = (uint32)rtime_sub(sounded, msg->request_time);
+
+    if (msg->request_time == 0)
+    {
+        return;
+    }
+
+    if (prompt_from_cache)
+    {
+        Metrics_Record(cached_prompt_sound_latency, sound_us / US_PER_MS);
+    }
+    else
+    {
+        Metrics_Record(prompt_sound_latency, sound_us / US_PER_MS);
+    }
+    if (chain_was_ready)
+    {
+        Metrics_Record(warm_prompt_sound_latency, sound_us / US_PER_MS);
+    }
+
+    DEBUG_LOG_INFO("kymera_RecordPromptLatency ready %u, cached %u, setup %uus, sound %uus",
+                   chain_was_ready, prompt_from_cache, setup_us, sound_us);
+}
+
 void appKymeraHandleInternalTonePromptPlay(const KYMERA_INTERNAL_TONE_PROMPT_PLAY_T *msg)
 {
     kymeraTaskData *theKymera = KymeraGetTaskData();
     output_source_t output = {0};
     int16 volume_db = (msg->tone != NULL) ? KYMERA_CONFIG_TONE_VOLUME : KYMERA_CONFIG_PROMPT_VOLUME;
+    bool chain_was_ready;
+    bool ttp_set;
 
     if (msg->tone != NULL && msg->is_loud)
     {
@@ -409,13 +519,28 @@ void appKymeraHandleInternalTonePromptPlay(const KYMERA_INTERNAL_TONE_PROMPT_PLA
         appKymeraTonePromptStop();
     }
 
+    chain_was_ready = kymera_TonePromptIsReady();
+    prompt_from_cache = FALSE;
+    if (msg->prompt != FILE_NONE)
+    {
+        prompt_keep_warm.format = msg->prompt_format;
+        prompt_keep_warm.rate = msg->rate;
+        prompt_keep_warm.format_known = TRUE;
+    }
+    prompt_keep_warm.active = FALSE;
+
     kymera_PrepareOutputChain(msg->rate);
     KymeraOutput_ChainStart();
     output.aux = kymera_PrepareInputChain(msg);
-    PanicFalse(Kymera_OutputConnect(output_user_prompt, &output));
+    /* A chain kept warm is already connected to the aux input */
+    if (!prompt_keep_warm.connected)
+    {
+        PanicFalse(Kymera_OutputConnect(output_user_prompt, &output));
+    }
     KymeraOutput_SetAuxVolume(volume_db);
 
-    if (KymeraOutput_SetAuxTtp(msg->time_to_play))
+    ttp_set = KymeraOutput_SetAuxTtp(msg->time_to_play);
+    if (ttp_set)
     {
         rtime_t now = SystemClockGetTimerTime();
         rtime_t delta = rtime_sub(msg->time_to_play, now);
@@ -429,6 +554,7 @@ void appKymeraHandleInternalTonePromptPlay(const KYMERA_INTERNAL_TONE_PROMPT_PLA
     {
         ChainStart(theKymera->chain_tone_handle);
     }
+    kymera_RecordPromptLatency(msg, chain_was_ready, ttp_set);
 
     kymera_tone_state = kymera_tone_playing;
     /* May need to exit low power mode to play tone simultaneously */
@@ -442,6 +568,26 @@ void appKymeraHandleInternalTonePromptPlay(const KYMERA_INTERNAL_TONE_PROMPT_PLA
     theKymera->tone_client_lock_mask = msg->client_lock_mask;
 }
 
+static void kymera_OutputConnectingIndication(output_users_t connecting_user, output_connection_t connection_type)
+{
+    UNUSED(connection_type);
+
+    if (connecting_user != output_user_prompt)
+    {
+        kymera_ScheduleKeepWarm();
+    }
+}
+
+static void kymera_OutputDisconnectedIndication(output_users_t disconnected_user, output_connection_t connection_type)
+{
+    UNUSED(connection_type);
+
+    if (disconnected_user != output_user_prompt && !kymera_IsOutputInUseByOthers())
+    {
+        kymera_StopKeepWarm();
+    }
+}
+
 static bool kymera_OutputDisconnectRequest(void)
 {
     // If idle it shouldn't be prepared/connected with the output chain
@@ -489,6 +635,8 @@ static void kymera_CompleteOutputChainDisconnect(void)
     }
 
     kymera_tone_state = kymera_tone_idle;
+    prompt_keep_warm.active = FALSE;
+    prompt_keep_warm.connected = FALSE;
 
      /* Return to low power mode (if applicable) */
     appKymeraConfigureDspPowerMode();
@@ -500,6 +648,8 @@ static void kymera_CompleteOutputChainDisconnect(void)
         theKymera->tone_client_lock = 0;
         theKymera->tone_client_lock_mask = 0;
     }
+
+    kymera_ScheduleKeepWarm();
 }
 
 void appKymeraTonePromptStop(void)
@@ -541,9 +691,55 @@ bool Kymera_PrepareForPrompt(promptFormat format, uint16 sample_rate)
     return prepared;
 }
 
+void appKymeraHandleInternalPromptKeepWarm(void)
+{
+    if (prompt_keep_warm.enabled && kymera_tone_state == kymera_tone_idle && kymera_IsOutputInUseByOthers())
+    {
+        kymera_output_chain_config config = {0};
+        KymeraOutput_SetDefaultOutputChainConfig(&config, prompt_keep_warm.rate, KICK_PERIOD_TONES, 0);
+
+        /* Unlike kymera_PrepareOutputChain() the DSP clock isn't boosted, the
+           chain is only being made ready */
+        if (Kymera_OutputPrepare(output_user_prompt, &config))
+        {
+            kymera_CreatePromptChain(prompt_keep_warm.format);
+            prompt_keep_warm.active = TRUE;
+
+            /* A PCM prompt has no chain, the file is connected when it plays */
+            if (kymera_GetTonePromptChain())
+            {
+                output_source_t output = {0};
+
+                output.aux = ChainGetOutput(kymera_GetTonePromptChain(), EPR_TONE_PROMPT_CHAIN_OUT);
+                KymeraOutput_SetAuxVolume(0);
+                prompt_keep_warm.connected = Kymera_OutputConnect(output_user_prompt, &output);
+            }
+        }
+    }
+
+    DEBUG_LOG("appKymeraHandleInternalPromptKeepWarm active %u, connected %u, format %u rate %u",
+              prompt_keep_warm.active, prompt_keep_warm.connected, prompt_keep_warm.format, prompt_keep_warm.rate);
+}
+
+void Kymera_SetPromptKeepWarm(bool enable)
+{
+    DEBUG_LOG("Kymera_SetPromptKeepWarm %u", enable);
+
+    prompt_keep_warm.enabled = enable;
+    if (enable)
+    {
+        kymera_ScheduleKeepWarm();
+    }
+    else
+    {
+        kymera_StopKeepWarm();
+    }
+}
+
 bool Kymera_IsReadyForPrompt(promptFormat format, uint16 sample_rate)
 {
-    bool is_ready_for_prompt = ((kymera_tone_state == kymera_tone_ready_prompt) && kymera_IsTheCorrectPromptChainReady(format));
+    bool is_ready_for_prompt = ((kymera_tone_state == kymera_tone_ready_prompt) && kymera_IsTheCorrectPromptChainReady(format) &&
+                                (!prompt_keep_warm.connected || sample_rate == prompt_keep_warm.rate));
     DEBUG_LOG("Kymera_IsReadyForPrompt %u, format %u rate %u", is_ready_for_prompt, format, sample_rate);
     return is_ready_for_prompt;
 }
@@ -567,4 +763,5 @@ void Kymera_PromptUnloadDownloadableCaps(void)
 void appKymeraTonePromptInit(void)
 {
     Kymera_OutputRegister(&output_info);
+    Kymera_OutputRegisterForIndications(&output_indications);
 }
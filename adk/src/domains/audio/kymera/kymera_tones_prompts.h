@@ -42,6 +42,9 @@ typedef struct
     uint16 *client_lock;
     /*! The mask of bits to clear in client_lock. */
     uint16 client_lock_mask;
+    /*! When the tone/prompt was requested, in microseconds. 0 if it isn't
+        to be included in the latency metrics. */
+    uint32 request_time;
 } KYMERA_INTERNAL_TONE_PROMPT_PLAY_T;
 
 /*! \brief Immediately stop playing the tone or prompt */
@@ -69,4 +72,9 @@ bool appKymeraIsPlayingPrompt(void);
 */
 void appKymeraHandleInternalTonePromptPlay(const KYMERA_INTERNAL_TONE_PROMPT_PLAY_T *msg);
 
+/*! \brief Make the prompt chain ready, if it is to be kept warm and other
+           audio is using the output chain.
+*/
+void appKymeraHandleInternalPromptKeepWarm(void);
+
 #endif // KYMERA_TONES_PROMPTS_H
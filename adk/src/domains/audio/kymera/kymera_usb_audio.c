@@ -49,6 +49,10 @@ static void kymeraUSbAudio_ConfigureInputChain(KYMERA_INTERNAL_USB_AUDIO_START_T
                                       MS_TO_US(usb_audio->max_latency_ms));
 
     OperatorsStandardSetTimeToPlayLatency(usb_audio_rx_op,MS_TO_US(usb_audio->target_latency_ms));
+
+    /* The host follows our clock via the feedback endpoint, so the drift
+       must not also be corrected by rate matching in the chain */
+    OperatorsUsbAudioSetHostRateFeedback(usb_audio_rx_op, usb_audio->host_rate_feedback);
     OperatorsStandardSetBufferSizeWithFormat(usb_audio_rx_op, TTP_BUFFER_SIZE,
                                                      operator_data_format_pcm);
 
@@ -242,6 +246,20 @@ void KymeraUsbAudio_SetVolume(int16 volume_in_db)
     }
 }
 
+bool KymeraUsbAudio_GetRateMismatch(int32 *mismatch_ppm)
+{
+    kymeraTaskData *theKymera = KymeraGetTaskData();
+    Operator usb_audio_rx_op;
+
+    if (appKymeraGetState() != KYMERA_STATE_USB_AUDIO_ACTIVE)
+    {
+        return FALSE;
+    }
+
+    usb_audio_rx_op = ChainGetOperatorByRole(theKymera->chain_input_handle, OPR_USB_AUDIO_RX);
+    return (usb_audio_rx_op != INVALID_OPERATOR) && OperatorsUsbAudioGetRateMismatch(usb_audio_rx_op, mismatch_ppm);
+}
+
 void KymeraUsbAudio_Init(void)
 {
     Kymera_OutputRegister(&output_info);
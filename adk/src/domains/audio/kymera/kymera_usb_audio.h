@@ -13,6 +13,7 @@ typedef struct
     uint32 min_latency_ms;
     uint32 max_latency_ms;
     uint32 target_latency_ms;
+    bool host_rate_feedback;
 } KYMERA_INTERNAL_USB_AUDIO_START_T;
 
 /*! \brief Disconnect message for USB Audio. */
@@ -71,6 +72,17 @@ void KymeraUsbAudio_SetVolume(int16 volume_in_db);
 #define KymeraUsbAudio_SetVolume(x) UNUSED(x)
 #endif
 
+/*! \brief Get the rate mismatch measured by the USB Audio chain.
+    \param mismatch_ppm Set to the mismatch between the local clock and the
+           USB packet rate in ppm, positive when the local clock is faster.
+    \return TRUE if the mismatch was read.
+*/
+#ifdef INCLUDE_USB_DEVICE
+bool KymeraUsbAudio_GetRateMismatch(int32 *mismatch_ppm);
+#else
+#define KymeraUsbAudio_GetRateMismatch(x) (UNUSED(x), FALSE)
+#endif
+
 /*! \brief Mute the A2DP Source output chain.
     \param mute Mute the USB audio
 */
@@ -191,7 +191,8 @@ static void kymeraAdaptation_ConnectUsbAudio(connect_parameters_t * params)
     appKymeraUsbAudioStart(usb_audio->channels, usb_audio->frame_size,
                            usb_audio->spkr_src, volume_in_db, usb_audio->mute_status,
                            usb_audio->sample_freq, usb_audio->min_latency_ms,
-                           usb_audio->max_latency_ms, usb_audio->target_latency_ms);
+                           usb_audio->max_latency_ms, usb_audio->target_latency_ms,
+                           usb_audio->host_rate_feedback);
 }
 
 #if defined(INCLUDE_LE_AUDIO_BROADCAST) || defined(INCLUDE_LE_AUDIO_UNICAST)
@@ -72,6 +72,8 @@ typedef struct
     uint32 min_latency_ms;
     uint32 max_latency_ms;
     uint32 target_latency_ms;
+    /* Host adapts its rate to an explicit feedback endpoint */
+    bool host_rate_feedback;
 } usb_audio_connect_parameters_t;
 
 typedef struct
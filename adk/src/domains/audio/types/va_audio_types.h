@@ -63,6 +63,9 @@ typedef struct
 {
     va_audio_encode_config_t encode_config;
     va_audio_mic_config_t    mic_config;
+    /*! Bytes of encoded audio to buffer before the client is given them,
+        0 to give it any data as soon as it arrives */
+    uint16                   wakeup_threshold;
 } va_audio_voice_capture_params_t;
 
 /*! \brief Defines the different Wake-Up-Word engines used for voice assistants audio */
@@ -137,6 +140,9 @@ typedef struct
     va_audio_encode_config_t encode_config;
     /*! Timestamp from which to start sending the buffered mic data */
     uint32 start_timestamp;
+    /*! Bytes of encoded audio to buffer before the client is given them,
+        0 to give it any data as soon as it arrives */
+    uint16 wakeup_threshold;
 } va_audio_wuw_capture_params_t;
 
 /*! \brief WuW engine version number */
@@ -60,6 +60,7 @@ Main AV task.
 #include <logging.h>
 #include "kymera.h"
 #include <ps_key_map.h>
+#include <ps_cache.h>
 #include <ps.h>
 
 #ifdef INCLUDE_APTX_ADAPTIVE
@@ -115,7 +116,7 @@ uint16 av_codec_pskey = 0xffff; /* default to all possible codecs */
 
 static void appAvCodecPskeyInit(void)
 {
-    PsRetrieve(PS_KEY_TEST_AV_CODEC, &av_codec_pskey, sizeof(av_codec_pskey));
+    PsCache_Retrieve(PS_KEY_TEST_AV_CODEC, &av_codec_pskey, sizeof(av_codec_pskey));
     DEBUG_LOG_ALWAYS("appAvCodecPskeyInit 0x%x", av_codec_pskey);
 }
 
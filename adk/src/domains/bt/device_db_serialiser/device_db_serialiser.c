@@ -40,6 +40,14 @@ static void deviceDbSeraliser_SerialiseDeviceLaterMessageHandler(Task task, Mess
 /*! This task is for the sole use of the serialise later functionality */
 static const TaskData ddb_serialise_device_later_task = {.handler = deviceDbSeraliser_SerialiseDeviceLaterMessageHandler};
 
+#if TRAPSET_OSAL
+/*! Index of the next device to serialise in the background */
+static uint8 ddb_serialise_background_index;
+
+/*! Set while a background serialisation is in progress */
+static bool ddb_serialise_background_pending;
+#endif
+
 void DeviceDbSerialiser_Init(void)
 {
     DeviceDbSerialiser_PdduInit();
@@ -159,7 +167,11 @@ void DeviceDbSerialiser_Serialise(void)
 
     DeviceList_Iterate(deviceDbSerialiser_SerialiseDeviceIter, NULL);
 
+    /* Also cancels any background serialisation, it has just been done */
     MessageFlushTask((Task)&ddb_serialise_device_later_task);
+#if TRAPSET_OSAL
+    ddb_serialise_background_pending = FALSE;
+#endif
 
     /* Completion of the serialisation less important */
     DEBUG_LOG_DEBUG("DeviceDbSerialiser_Serialise Completed");
@@ -219,6 +231,94 @@ bool DeviceDbSerialiser_SerialiseDevice(device_t device)
     return deviceDbSerialiser_SerialiseDevice(device);
 }
 
+#if TRAPSET_OSAL
+static bool deviceDbSerialiser_IsPeerDevice(device_t device)
+{
+    deviceType *device_type = NULL;
+    size_t size = sizeof(deviceType);
+
+    return Device_GetProperty(device, device_property_type, (void *)&device_type, &size)
+           && (*device_type == DEVICE_TYPE_SELF || *device_type == DEVICE_TYPE_EARBUD);
+}
+
+/*! \brief Serialise the next device in a background serialisation.
+
+    The SELF and EARBUD devices are serialised together in the first slice to
+    keep them in sync, every other device gets a slice of its own.
+*/
+static bool deviceDbSerialiser_SerialiseBackgroundSlice(Task task, void *context)
+{
+    bool both_peers_present = deviceDbSerialiser_AreBothPeersPresent();
+
+    UNUSED(task);
+    UNUSED(context);
+
+    if (ddb_serialise_background_index == 0 && both_peers_present)
+    {
+        deviceType device_type = DEVICE_TYPE_SELF;
+        device_t self = DeviceList_GetFirstDeviceWithPropertyValue(device_property_type, &device_type, sizeof(deviceType));
+
+        deviceDbSerialiser_SerialiseDevice(self);
+        deviceDbSerialiser_SerialiseOtherPeerDevice(DEVICE_TYPE_SELF);
+    }
+
+    while (ddb_serialise_background_index < MAX_NUM_DEVICES_IN_PDL)
+    {
+        device_t device = DeviceList_GetDeviceAtIndex(ddb_serialise_background_index++);
+
+        if (device && !(both_peers_present && deviceDbSerialiser_IsPeerDevice(device)))
+        {
+            deviceDbSerialiser_SerialiseDevice(device);
+            break;
+        }
+    }
+
+    if (ddb_serialise_background_index < MAX_NUM_DEVICES_IN_PDL)
+    {
+        return TRUE;
+    }
+
+    DEBUG_LOG_DEBUG("DeviceDbSerialiser_SerialiseInBackground Completed");
+    ddb_serialise_background_pending = FALSE;
+    return FALSE;
+}
+#endif /* TRAPSET_OSAL */
+
+void DeviceDbSerialiser_SerialiseInBackground(void)
+{
+#if TRAPSET_OSAL
+    Task t = (Task)&ddb_serialise_device_later_task;
+
+    DEBUG_LOG_INFO("DeviceDbSerialiser_SerialiseInBackground");
+
+    /* Devices already serialised in a background run in progress may have
+       changed since, so start again from the first device. */
+    MessageFlushTask(t);
+
+#ifdef INCLUDE_DEVICE_DB_BACKUP
+    if(deviceDbSerialiser_AreBothPeersPresent())
+    {
+        DeviceDbSerialiser_MakeBackup();
+    }
+#endif
+
+    ddb_serialise_background_index = 0;
+    ddb_serialise_background_pending = TRUE;
+    PanicFalse(MessageContinuationPost(t, deviceDbSerialiser_SerialiseBackgroundSlice, NULL));
+#else
+    DeviceDbSerialiser_Serialise();
+#endif
+}
+
+bool DeviceDbSerialiser_IsSerialisingInBackground(void)
+{
+#if TRAPSET_OSAL
+    return ddb_serialise_background_pending;
+#else
+    return FALSE;
+#endif
+}
+
 static void deviceDbSerialiser_DeserialisePddFrame(device_t device, uint8 *pdd_frame)
 {
     pdd_type_t this_pddu_id;
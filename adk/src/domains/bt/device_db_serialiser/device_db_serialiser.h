@@ -55,6 +55,30 @@ void DeviceDbSerialiser_RegisterPersistentDeviceDataUser(
 */
 void DeviceDbSerialiser_Serialise(void);
 
+/*! \brief Serialise the set of Persistent Device Data without blocking the
+           application for the whole database.
+
+    Each device is serialised in a continuation slice of its own, so messages
+    for other tasks are delivered between the PS store writes. The SELF and
+    EARBUD devices are still serialised together.
+
+    Only use this where the data doesn't need to be persisted before the
+    function returns, use DeviceDbSerialiser_Serialise() otherwise. A call to
+    DeviceDbSerialiser_Serialise() completes and cancels any background
+    serialisation in progress.
+
+    If the continuation traps aren't available this is the same as
+    DeviceDbSerialiser_Serialise().
+*/
+void DeviceDbSerialiser_SerialiseInBackground(void);
+
+/*! \brief Check whether a background serialisation is in progress.
+
+    \return TRUE if DeviceDbSerialiser_SerialiseInBackground() has been called
+            and not all the devices have been serialised yet.
+*/
+bool DeviceDbSerialiser_IsSerialisingInBackground(void);
+
 /*! \brief Serialise the set of Persistent Device Data for specified device only.
 
     \param device   Device for which PDD should be serialised.
@@ -21,6 +21,7 @@ Only one data_id is supported at the moment.
 #include <logging.h>
 #include <panic.h>
 #include <ps.h>
+#include <ps_cache.h>
 
 #include <stdlib.h>
 
@@ -199,7 +200,7 @@ static device_pskey_entry_t devicePsKey_GetEntry(device_t device, device_pskey_d
 
         DEBUG_LOG_VERBOSE("devicePsKey_GetEntry deleting ps key %d", new_entry.ps_key);
         /* Delete just allocated ps key in case it was used before */
-        PsStore(new_entry.ps_key, NULL, 0);
+        PsCache_Store(new_entry.ps_key, NULL, 0);
 
         if(serialise)
         {
@@ -229,7 +230,7 @@ uint16 DevicePsKey_Write(device_t device, device_pskey_data_id_t data_id, uint8
 
         memset(buffer, 0, num_of_words*sizeof(uint16));
         memcpy(buffer, data, data_size);
-        written_words = PsStore(pskey_id, buffer, num_of_words);
+        written_words = PsCache_StoreNow(pskey_id, buffer, num_of_words);
 
         free(buffer);
 
@@ -265,12 +266,12 @@ uint8 *DevicePsKey_Read(device_t device, device_pskey_data_id_t data_id, uint16
 
     if(pskey_id)
     {
-        uint16 num_of_words = PsRetrieve(pskey_id, NULL, 0);
+        uint16 num_of_words = PsCache_Retrieve(pskey_id, NULL, 0);
         if(num_of_words > 0)
         {
             uint16 *buffer = PanicUnlessMalloc(num_of_words*sizeof(uint16));
 
-            read_bytes = PsRetrieve(pskey_id, buffer, num_of_words) * sizeof(uint16);
+            read_bytes = PsCache_Retrieve(pskey_id, buffer, num_of_words) * sizeof(uint16);
 
             DEBUG_LOG_VERBOSE("DevicePsKey_Read num words %d, read bytes %d", num_of_words, read_bytes);
 
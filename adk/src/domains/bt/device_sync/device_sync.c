@@ -101,7 +101,8 @@ static const earbud_device_property_t self_properties_to_sync[] = {
 
 static bool deviceSync_Veto(void)
 {
-    if(MessageCancelAll((Task)&device_sync.task, DEVICE_SYNC_INTERNAL_PERSIST_DATA))
+    if(MessageCancelAll((Task)&device_sync.task, DEVICE_SYNC_INTERNAL_PERSIST_DATA)
+       || DeviceDbSerialiser_IsSerialisingInBackground())
     {
         DEBUG_LOG_INFO("deviceSync_Veto Persist data to not hold handover for too long");
         DeviceDbSerialiser_Serialise();
@@ -368,7 +369,7 @@ static void deviceSync_MessageHandler(Task task, MessageId id, Message message)
         case DEVICE_SYNC_INTERNAL_PERSIST_DATA:
         {
             DEBUG_LOG_VERBOSE("deviceSync_MessageHandler DEVICE_SYNC_INTERANL_PERSIST_DATA");
-            DeviceDbSerialiser_Serialise();
+            DeviceDbSerialiser_SerialiseInBackground();
 
         }
         break;
@@ -41,6 +41,49 @@ static bool FastPair_Veto(void)
 }
 
 
+/* Fill in the object marshalled for the connected RFcomm connection */
+static void fastPair_HandoverGetMarshalObj(const tp_bdaddr *tp_bd_addr, fast_pair_marshal_data *obj)
+{
+    uint8 remote_device_id = 0xFF;
+    uint8* session_nonce_ptr = NULL;
+    obj->rfcomm_channel = fastPair_RfcommGetRFCommChannel(&(tp_bd_addr->taddr.addr));
+    obj->rfcomm_dlci = fastPair_RfcommGetRFCommDlci(&(tp_bd_addr->taddr.addr));
+    obj->dev_info = fastPair_MsgStreamDevInfo_Get();
+    remote_device_id = FastPair_MsgStreamGetRemoteDeviceId(&(tp_bd_addr->taddr.addr));
+    session_nonce_ptr = FastPair_MsgStream_GetSessionNonce(remote_device_id);
+    if(session_nonce_ptr != NULL)
+    {
+        memcpy(obj->session_nonce, session_nonce_ptr, FASTPAIR_DEV_INFO_SESSION_NONCE_LEN);
+    }
+
+    if(!sass_con_status_data_shared_across)
+    {
+        obj->con_status_data.connection_state = Sass_GetConnectionState();
+        obj->con_status_data.custom_data = Sass_GetCustomData();
+        obj->con_status_data.connected_devices_bitmap = Sass_GetConnectedDeviceBitMap();
+    }
+}
+
+static uint16 FastPair_EstimateSize(const tp_bdaddr *tp_bd_addr)
+{
+    uint16 size = 0;
+
+    if (fastPair_RfcommIsConnectedForAddr(&(tp_bd_addr->taddr.addr)))
+    {
+        fast_pair_marshal_data obj;
+
+        fastPair_HandoverGetMarshalObj(tp_bd_addr, &obj);
+
+        /* Without a buffer the marshaller only works out how much it would write */
+        marshaller_t marshaller = MarshalInit(mtd_fast_pair, FAST_PAIR_MARSHAL_OBJ_TYPE_COUNT);
+        MarshalSetBuffer(marshaller, NULL, 0);
+        (void)Marshal(marshaller, &obj, MARSHAL_TYPE(fast_pair_marshal_data));
+        size = MarshalRemaining(marshaller);
+        MarshalDestroy(marshaller, FALSE);
+    }
+    return size;
+}
+
 static bool FastPair_Marshal(const tp_bdaddr *tp_bd_addr,
                              uint8 *buf,
                              uint16 length,
@@ -53,24 +96,8 @@ static bool FastPair_Marshal(const tp_bdaddr *tp_bd_addr,
     {
         bool marshalled;
         fast_pair_marshal_data obj;
-        uint8 remote_device_id = 0xFF;
-        uint8* session_nonce_ptr = NULL;
-        obj.rfcomm_channel = fastPair_RfcommGetRFCommChannel(&(tp_bd_addr->taddr.addr));
-        obj.rfcomm_dlci = fastPair_RfcommGetRFCommDlci(&(tp_bd_addr->taddr.addr));
-        obj.dev_info = fastPair_MsgStreamDevInfo_Get();
-        remote_device_id = FastPair_MsgStreamGetRemoteDeviceId(&(tp_bd_addr->taddr.addr));
-        session_nonce_ptr = FastPair_MsgStream_GetSessionNonce(remote_device_id);
-        if(session_nonce_ptr != NULL)
-        {
-            memcpy(obj.session_nonce, session_nonce_ptr, FASTPAIR_DEV_INFO_SESSION_NONCE_LEN);
-        }
 
-        if(!sass_con_status_data_shared_across)
-        {
-            obj.con_status_data.connection_state = Sass_GetConnectionState();
-            obj.con_status_data.custom_data = Sass_GetCustomData();
-            obj.con_status_data.connected_devices_bitmap = Sass_GetConnectedDeviceBitMap();
-        }
+        fastPair_HandoverGetMarshalObj(tp_bd_addr, &obj);
 
         DEBUG_LOG("FastPair_Marshal: Marashalling rfcomm info for addr[0x%06x]", tp_bd_addr->taddr.addr.lap);
 
@@ -184,10 +211,13 @@ static void FastPair_HandoverAbort(void)
 }
 
 handover_interface fast_pair_handover_if =
-        MAKE_BREDR_HANDOVER_IF(&FastPair_Veto,
-                               &FastPair_Marshal,
-                               &FastPair_Unmarshal,
-                               &FastPair_HandoverCommit,
-                               &FastPair_HandoverComplete,
-                               &FastPair_HandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                                  &FastPair_Veto,
+                                  NULL,
+                                  &FastPair_EstimateSize,
+                                  &FastPair_Marshal,
+                                  &FastPair_Unmarshal,
+                                  &FastPair_HandoverCommit,
+                                  &FastPair_HandoverComplete,
+                                  &FastPair_HandoverAbort);
 #endif
@@ -201,11 +201,11 @@ static void gattBatteryServer_HandoverAbort(void)
 
 /*! \brief On abort, Unicast manager handover interfaces */
 const handover_interface gatt_battery_server_handover_if =
-        MAKE_BLE_HANDOVER_IF(&gattBatteryServer_Veto,
-                             &gattBatteryServer_Marshal,
-                             &gattBatteryServer_Unmarshal,
-                             &gattBatteryServer_HandoverCommit,
-                             &gattBatteryServer_HandoverComplete,
-                             &gattBatteryServer_HandoverAbort);
+        MAKE_BLE_HANDOVER_IF_SNAPSHOT(&gattBatteryServer_Veto,
+                                      &gattBatteryServer_Marshal,
+                                      &gattBatteryServer_Unmarshal,
+                                      &gattBatteryServer_HandoverCommit,
+                                      &gattBatteryServer_HandoverComplete,
+                                      &gattBatteryServer_HandoverAbort);
 
 #endif /* INCLUDE_GATT_BATTERY_SERVER */
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <bdaddr.h>
 #include <gatt.h>
 #include <state_proxy.h>
+#include <handover_profile.h>
 
 #include <panic.h>
 
@@ -51,6 +52,8 @@ gattServerBatteryData gatt_server_battery = {0};
 static void gattServerBattery_AddClient(gatt_cid_t cid);
 static void gattServerBattery_RemoveClient(gatt_cid_t cid);
 
+extern const handover_interface gatt_battery_server_handover_if;
+
 static const gatt_connect_observer_callback_t gatt_battery_connect_observer_callback =
 {
     .OnConnection = gattServerBattery_AddClient,
@@ -135,6 +138,7 @@ static bool gattServerBattery_SendBatteryLevelIfChanged(gattServerBatteryInstanc
             {
                 cids[number_cids++] = instance->client_data[client_count].cid;
                 instance->client_data[client_count].sent_battery_level = battery_percent;
+                HandoverProfile_InvalidateP1Snapshot(&gatt_battery_server_handover_if);
             }
         }
     }
@@ -354,6 +358,7 @@ static void gattServerBattery_WriteClientConfig(const GATT_BATTERY_SERVER_WRITE_
     if (client_data != NULL)
     {
         client_data->config = ind->config_value;
+        HandoverProfile_InvalidateP1Snapshot(&gatt_battery_server_handover_if);
         
         /* Write client config to persistent store */
         gattServerBattery_WriteClientConfigToStore(ind->cid, battery_type, client_data->config);
@@ -474,6 +479,7 @@ static void gattServerBattery_AddClient(gatt_cid_t cid)
                 {
                     client_data->config = stored_client_config;
                 }
+                HandoverProfile_InvalidateP1Snapshot(&gatt_battery_server_handover_if);
             }
         }
         
@@ -500,6 +506,7 @@ static void gattServerBattery_RemoveClient(gatt_cid_t cid)
                 client_data->cid = 0;
                 client_data->config = 0;
                 client_data->sent_battery_level = BATTERY_LEVEL_UNSET;
+                HandoverProfile_InvalidateP1Snapshot(&gatt_battery_server_handover_if);
             }
         }
         
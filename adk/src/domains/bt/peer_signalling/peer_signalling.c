@@ -14,6 +14,7 @@
 #include "system_state.h"
 #include "bt_device.h"
 #include "adk_log.h"
+#include "metrics.h"
 #include <hfp_profile.h>
 #include "hfp_profile_instance.h"
 #include "mirror_profile.h"
@@ -125,6 +126,7 @@ static void appPeerSigSendConnectConfirmation(peerSigStatus status);
 static void appPeerSigSendDisconnectConfirmation(peerSigStatus status);
 static marshal_msg_channel_data_t* appPeerSigGetChannelData(peerSigMsgChannel channel);
 static void appPeerSigL2capProcessData(void);
+static void appPeerSigCoalesceFlush(void);
 
 /*!< Peer earbud signalling */
 peerSigTaskData app_peer_sig;
@@ -245,6 +247,13 @@ static void appPeerSigExitConnected(void)
     peerSigTaskData *peer_sig = PeerSigGetTaskData();
 
     DEBUG_LOG("appPeerSigExitConnected clearing wallclock for UI synchronisation");
+
+    /* Send (or fail) any messages still waiting in a coalesced SDU */
+    appPeerSigCoalesceFlush();
+
+    /* The next peer may not accept coalesced SDUs */
+    peer_sig->peer_accepts_coalesced = FALSE;
+
     LedManager_SetWallclock((Sink)0);
     AancQuietMode_SetWallClock((Sink)0);
     appPeerSigCancelInactivityTimer();
@@ -1548,6 +1557,15 @@ octet
  *  Peer signaling makes no assumptions about the contents, including
  *  not requiring that there be a response message in return. */
 #define PEER_SIG_TYPE_MARSHAL   0x1
+/*! Coalesced peer signalling message type.
+ *  Carries one or more marshalled messages, possibly for different channels,
+ *  in a single SDU. */
+#define PEER_SIG_TYPE_COALESCED 0x2
+
+/*! Header flag set by a sender that accepts PEER_SIG_TYPE_COALESCED SDUs.
+ *  Earlier versions leave it clear and ignore it, so coalesced SDUs are only
+ *  sent once the peer has been seen to set it. */
+#define PEER_SIG_HEADER_FLAG_ACCEPTS_COALESCED  0x4
 
 #define PEER_SIG_GET_HEADER_TYPE(hdr) ((hdr) & PEER_SIG_TYPE_MASK)
 #define PEER_SIG_SET_HEADER_TYPE(hdr, type) ((hdr) = (((hdr) & ~PEER_SIG_TYPE_MASK) | type))
@@ -1557,6 +1575,37 @@ octet
 #define PEER_SIG_MARSHAL_PAYLOAD_OFFSET     6
 #define PEER_SIG_MARSHAL_HEADER_SIZE        6
 
+/* Coalesced type
+
+octet
+0       |   Header
+1       |   Tx seq number
+2       |   Record 0 channel
+3       |   Record 0 flags
+4       |   Record 0 payload length
+5       |   Record 0 payload length
+6       |   Record 0 original length (only if compressed)
+7       |   Record 0 original length (only if compressed)
+..      |   Record 0 payload
+..      |   Record 1 channel
+...
+*/
+#define PEER_SIG_COALESCED_HEADER_SIZE          2
+#define PEER_SIG_RECORD_CHANNEL_OFFSET          0
+#define PEER_SIG_RECORD_FLAGS_OFFSET            1
+#define PEER_SIG_RECORD_LENGTH_OFFSET           2
+#define PEER_SIG_RECORD_HEADER_SIZE             4
+#define PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE    2
+
+/*! Record flag indicating the payload is compressed. */
+#define PEER_SIG_RECORD_FLAG_COMPRESSED         0x1
+
+/*! Octets of L2CAP basic mode header added to every SDU. */
+#define PEER_SIG_L2CAP_SDU_OVERHEAD             4
+
+METRIC_COUNTER_ARRAY(peer_sig_packets_saved, METRIC_ID_PEER_SIG_PACKETS_SAVED, PEER_SIG_MSG_CHANNEL_MAX);
+METRIC_COUNTER_ARRAY(peer_sig_bytes_saved, METRIC_ID_PEER_SIG_BYTES_SAVED, PEER_SIG_MSG_CHANNEL_MAX);
+
 enum peer_sig_reponse
 {
     peer_sig_success = 0,
@@ -1611,29 +1660,80 @@ static marshal_msg_channel_data_t* appPeerSigGetChannelData(peerSigMsgChannel ch
     return &peer_sig->marshal_msg_channel_state[channel];
 }
 
-static void appPeerSigL2capProcessMarshal(const uint8* data, uint16 size)
+static uint16 appPeerSigReadUint16(const uint8 *data)
 {
-    marshal_msg_channel_data_t* mmcd = NULL;
-    uint16 marshal_size = size - PEER_SIG_MARSHAL_HEADER_SIZE;
-    peerSigMsgChannel channel = appPeerSigReadUint32(&data[PEER_SIG_MARSHAL_CHANNELID_OFFSET]);
-    marshal_type_t type;
-    void* rx_msg;
+    return data[0] + (data[1] << 8);
+}
 
-//    DEBUG_LOG("appPeerSigL2capProcessMarshal channel %u data %p size %u", channel, data, size);
+static void appPeerSigWriteUint16(uint8 *data, uint16 val)
+{
+    data[0] = val & 0xFF;
+    data[1] = (val >> 8) & 0xFF;
+}
 
-#ifdef DUMP_MARSHALL_DATA
-    dump_buffer(data, size);
-#endif
+/*! \brief Get the specialised marshal functions of a type on a channel.
+
+    \return The functions, or NULL if the type descriptors must be used.
+*/
+static const marshal_specialised_t *appPeerSigGetSpecialised(const marshal_msg_channel_data_t *mmcd, marshal_type_t type)
+{
+    if (mmcd->specialised && type < mmcd->num_type_desc && mmcd->specialised[type].marshal)
+    {
+        return &mmcd->specialised[type];
+    }
+    return NULL;
+}
 
-    mmcd = appPeerSigGetChannelData(channel);
+/*! \brief Marshal a message into a buffer that has exactly the space it needs.
+
+    \param marshaller  The channel's marshaller, unused if \p specialised is set.
+    \param specialised The type's specialised functions, or NULL.
+*/
+static void appPeerSigMarshalInto(marshaller_t marshaller, const marshal_specialised_t *specialised,
+                                  marshal_type_t type, void *msg_ptr, uint8 *buf, size_t size)
+{
+    if (specialised)
+    {
+        size_t produced;
+        PanicFalse(specialised->marshal(msg_ptr, type, buf, size, &produced));
+    }
+    else
+    {
+        MarshalSetBuffer(marshaller, buf, size);
+        PanicFalse(Marshal(marshaller, msg_ptr, type));
+    }
+}
+
+/*! \brief Unmarshal a received payload and send it to the channel's client. */
+static void appPeerSigUnmarshalToClient(peerSigMsgChannel channel, const uint8* payload, uint16 marshal_size)
+{
+    marshal_msg_channel_data_t* mmcd = appPeerSigGetChannelData(channel);
+    marshal_type_t type;
+    void* rx_msg;
 
     if (mmcd->client_task)
     {
-        unmarshaller_t unmarshaller = PanicNull(UnmarshalInit(mmcd->type_desc, mmcd->num_type_desc));
+        const marshal_specialised_t *specialised = marshal_size ? appPeerSigGetSpecialised(mmcd, payload[0]) : NULL;
+        bool unmarshalled;
 
-        UnmarshalSetBuffer(unmarshaller, &data[PEER_SIG_MARSHAL_PAYLOAD_OFFSET], marshal_size);
+        if (specialised)
+        {
+            size_t consumed;
 
-        if (Unmarshal(unmarshaller, &rx_msg, &type))
+            type = payload[0];
+            rx_msg = specialised->unmarshal(type, payload, marshal_size, &consumed);
+            unmarshalled = (rx_msg != NULL);
+        }
+        else
+        {
+            unmarshaller_t unmarshaller = PanicNull(UnmarshalInit(mmcd->type_desc, mmcd->num_type_desc));
+
+            UnmarshalSetBuffer(unmarshaller, payload, marshal_size);
+            unmarshalled = Unmarshal(unmarshaller, &rx_msg, &type);
+            UnmarshalDestroy(unmarshaller, FALSE);
+        }
+
+        if (unmarshalled)
         {
             MAKE_MESSAGE(PEER_SIG_MARSHALLED_MSG_CHANNEL_RX_IND);
 
@@ -1642,7 +1742,139 @@ static void appPeerSigL2capProcessMarshal(const uint8* data, uint16 size)
             message->type = type;
             MessageSend(mmcd->client_task, PEER_SIG_MARSHALLED_MSG_CHANNEL_RX_IND, message);
         }
-        UnmarshalDestroy(unmarshaller, FALSE);
+    }
+}
+
+static void appPeerSigL2capProcessMarshal(const uint8* data, uint16 size)
+{
+    peerSigMsgChannel channel = appPeerSigReadUint32(&data[PEER_SIG_MARSHAL_CHANNELID_OFFSET]);
+
+//    DEBUG_LOG("appPeerSigL2capProcessMarshal channel %u data %p size %u", channel, data, size);
+
+#ifdef DUMP_MARSHALL_DATA
+    dump_buffer(data, size);
+#endif
+
+    appPeerSigUnmarshalToClient(channel, &data[PEER_SIG_MARSHAL_PAYLOAD_OFFSET], size - PEER_SIG_MARSHAL_HEADER_SIZE);
+}
+
+/*! \brief Check that every record of a coalesced SDU lies within the SDU.
+
+    \return TRUE if the SDU can be split into records, FALSE if it is malformed.
+*/
+static bool appPeerSigCoalescedIsValid(const uint8* data, uint16 size)
+{
+    uint16 offset = PEER_SIG_COALESCED_HEADER_SIZE;
+
+    if (size < PEER_SIG_COALESCED_HEADER_SIZE)
+    {
+        DEBUG_LOG("appPeerSigCoalescedIsValid, SDU too short %u", size);
+        return FALSE;
+    }
+
+    while (offset < size)
+    {
+        const uint8 *record = &data[offset];
+        uint16 remaining = size - offset;
+        uint16 length;
+
+        if (remaining < PEER_SIG_RECORD_HEADER_SIZE)
+        {
+            DEBUG_LOG("appPeerSigCoalescedIsValid, truncated record header at %u", offset);
+            return FALSE;
+        }
+
+        length = appPeerSigReadUint16(&record[PEER_SIG_RECORD_LENGTH_OFFSET]);
+        if (length > (remaining - PEER_SIG_RECORD_HEADER_SIZE))
+        {
+            DEBUG_LOG("appPeerSigCoalescedIsValid, record at %u length %u exceeds SDU", offset, length);
+            return FALSE;
+        }
+
+        if (record[PEER_SIG_RECORD_CHANNEL_OFFSET] >= PEER_SIG_MSG_CHANNEL_MAX)
+        {
+            DEBUG_LOG("appPeerSigCoalescedIsValid, record at %u invalid channel %u", offset, record[PEER_SIG_RECORD_CHANNEL_OFFSET]);
+            return FALSE;
+        }
+
+        if (record[PEER_SIG_RECORD_FLAGS_OFFSET] & PEER_SIG_RECORD_FLAG_COMPRESSED)
+        {
+            uint16 original_length;
+
+            if (length < PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE)
+            {
+                DEBUG_LOG("appPeerSigCoalescedIsValid, compressed record at %u too short %u", offset, length);
+                return FALSE;
+            }
+
+            /* Only records that fit in an SDU uncompressed are compressed */
+            original_length = appPeerSigReadUint16(&record[PEER_SIG_RECORD_HEADER_SIZE]);
+            if (original_length == 0 || original_length > PEER_SIG_L2CAP_MTU)
+            {
+                DEBUG_LOG("appPeerSigCoalescedIsValid, record at %u invalid original length %u", offset, original_length);
+                return FALSE;
+            }
+        }
+
+        offset += PEER_SIG_RECORD_HEADER_SIZE + length;
+    }
+
+    return TRUE;
+}
+
+/*! \brief Split a coalesced SDU into its records and deliver each one.
+
+    Malformed SDUs are dropped, as are records that fail to decompress.
+*/
+static void appPeerSigL2capProcessCoalesced(const uint8* data, uint16 size)
+{
+    uint16 offset = PEER_SIG_COALESCED_HEADER_SIZE;
+
+#ifdef DUMP_MARSHALL_DATA
+    dump_buffer(data, size);
+#endif
+
+    if (!appPeerSigCoalescedIsValid(data, size))
+    {
+        DEBUG_LOG("appPeerSigL2capProcessCoalesced, dropping malformed SDU size %u", size);
+        return;
+    }
+
+    while (offset < size)
+    {
+        const uint8 *record = &data[offset];
+        peerSigMsgChannel channel = record[PEER_SIG_RECORD_CHANNEL_OFFSET];
+        uint8 flags = record[PEER_SIG_RECORD_FLAGS_OFFSET];
+        uint16 length = appPeerSigReadUint16(&record[PEER_SIG_RECORD_LENGTH_OFFSET]);
+        const uint8 *payload = &record[PEER_SIG_RECORD_HEADER_SIZE];
+
+        offset += PEER_SIG_RECORD_HEADER_SIZE + length;
+
+        if (flags & PEER_SIG_RECORD_FLAG_COMPRESSED)
+        {
+            uint16 original_length = appPeerSigReadUint16(payload);
+            uint8 *original = malloc(original_length);
+
+            if (original == NULL)
+            {
+                DEBUG_LOG("appPeerSigL2capProcessCoalesced, no memory for %u octets, dropping record", original_length);
+            }
+            else if (!peerSig_DecompressPayload(&payload[PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE],
+                                                length - PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE,
+                                                original, original_length))
+            {
+                DEBUG_LOG("appPeerSigL2capProcessCoalesced, dropping record that failed to decompress");
+            }
+            else
+            {
+                appPeerSigUnmarshalToClient(channel, original, original_length);
+            }
+            free(original);
+        }
+        else
+        {
+            appPeerSigUnmarshalToClient(channel, payload, length);
+        }
     }
 }
 
@@ -1660,6 +1892,11 @@ static void appPeerSigL2capProcessData(void)
         uint8 type = PEER_SIG_GET_HEADER_TYPE(data[PEER_SIG_HEADER_OFFSET]);
         peer_sig->rx_seq = data[PEER_SIG_TX_SEQ_NUMBER_OFFSET];
 
+        if (data[PEER_SIG_HEADER_OFFSET] & PEER_SIG_HEADER_FLAG_ACCEPTS_COALESCED)
+        {
+            peer_sig->peer_accepts_coalesced = TRUE;
+        }
+
         /*DEBUG_LOG("appPeerSigL2capProcessData type 0x%x opid 0x%x", type, opid);*/
 
         switch (type)
@@ -1669,11 +1906,15 @@ static void appPeerSigL2capProcessData(void)
             appPeerSigL2capProcessMarshal(data, size);
             break;
 
+        case PEER_SIG_TYPE_COALESCED:
+            appPeerSigL2capProcessCoalesced(data, size);
+            break;
+
         default:
 #ifdef DUMP_MARSHALL_DATA
             dump_buffer(data, size);
 #endif
-            Panic();
+            DEBUG_LOG("appPeerSigL2capProcessData, dropping SDU of unknown type 0x%x size %u", type, size);
             break;
         }
 
@@ -1751,7 +1992,7 @@ static void appPeerSigHandleMMS(const MessageMoreSpace *mms)
 /*! \brief Write the marshalled message header into a buffer. */
 static void appPeerSigWriteMarshalMsgChannelHeader(uint8* bufptr, uint8 tx_seq, peerSigMsgChannel channel)
 {
-    uint8 hdr = 0;
+    uint8 hdr = PEER_SIG_HEADER_FLAG_ACCEPTS_COALESCED;
 
     bufptr[PEER_SIG_HEADER_OFFSET] = PEER_SIG_SET_HEADER_TYPE(hdr, PEER_SIG_TYPE_MARSHAL);
     bufptr[PEER_SIG_TX_SEQ_NUMBER_OFFSET] = tx_seq;
@@ -1759,6 +2000,183 @@ static void appPeerSigWriteMarshalMsgChannelHeader(uint8* bufptr, uint8 tx_seq,
     appPeerSigWriteUint32(&bufptr[PEER_SIG_MARSHAL_CHANNELID_OFFSET], channel);
 }
 
+/*! \brief Check if any marshalled messages are queued on the channel tasks. */
+static bool appPeerSigChannelMsgsPending(void)
+{
+    peerSigMsgChannel channel;
+
+    for (channel = 0; channel < PEER_SIG_MSG_CHANNEL_MAX; channel++)
+    {
+        marshal_msg_channel_data_t *mmcd = appPeerSigGetChannelData(channel);
+        if (mmcd->client_task && MessagesPendingForTask(&mmcd->channel_task, NULL) != 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*! \brief Transmit the coalesced SDU, if any, and confirm its messages to the clients. */
+static void appPeerSigCoalesceFlush(void)
+{
+    peerSigTaskData *peer_sig = PeerSigGetTaskData();
+    peer_sig_coalesce_t *coalesce = &peer_sig->coalesce;
+    peerSigStatus status = peerSigStatusSuccess;
+    uint8 i;
+
+    MessageCancelAll(&peer_sig->task, PEER_SIG_INTERNAL_COALESCE_TIMEOUT);
+
+    if (!coalesce->size)
+    {
+        return;
+    }
+
+    DEBUG_LOG("appPeerSigCoalesceFlush msgs %u size %u", coalesce->num_msgs, coalesce->size);
+
+    if (SinkIsValid(peer_sig->link_sink))
+    {
+#ifdef DUMP_MARSHALL_DATA
+        dump_buffer(SinkMap(peer_sig->link_sink), coalesce->size);
+#endif
+        SinkFlush(peer_sig->link_sink, coalesce->size);
+    }
+    else
+    {
+        status = peerSigStatusMarshalledMsgChannelTxFail;
+    }
+
+    for (i = 0; i < coalesce->num_msgs; i++)
+    {
+        appPeerSigMarshalledMsgChannelTxCfm(coalesce->msgs[i].client_task, coalesce->msgs[i].type,
+                                            status, coalesce->msgs[i].channel);
+    }
+
+    coalesce->size = 0;
+    coalesce->num_msgs = 0;
+
+    appPeerSigSetLockBasedOnSinkSlack();
+}
+
+/*! \brief Write a marshalled message as a record in the coalesced SDU.
+
+    The SDU is opened if necessary and transmitted when the latency window
+    expires, when it is full or when the next record does not fit.
+
+    \return FALSE if the message is too big to ever fit in a coalesced SDU.
+*/
+static bool appPeerSigCoalesceMarshal(marshal_msg_channel_data_t *mmcd,
+                                      marshaller_t marshaller,
+                                      const marshal_specialised_t *specialised,
+                                      marshal_type_t type,
+                                      void *msg_ptr,
+                                      uint16 payload_size)
+{
+    peerSigTaskData *peer_sig = PeerSigGetTaskData();
+    peer_sig_coalesce_t *coalesce = &peer_sig->coalesce;
+    uint16 record_size = PEER_SIG_RECORD_HEADER_SIZE + payload_size;
+    uint16 offset;
+    uint8 *bufptr;
+    uint8 *record;
+    uint8 flags = 0;
+
+    if ((PEER_SIG_COALESCED_HEADER_SIZE + record_size) > PEER_SIG_L2CAP_MTU)
+    {
+        /* Preserve ordering before the message is sent in an SDU of its own */
+        appPeerSigCoalesceFlush();
+        return FALSE;
+    }
+
+    if (coalesce->size && (coalesce->size + record_size) > PEER_SIG_L2CAP_MTU)
+    {
+        appPeerSigCoalesceFlush();
+    }
+
+    offset = coalesce->size ? coalesce->size : PEER_SIG_COALESCED_HEADER_SIZE;
+    bufptr = PanicNull(appPeerSigClaimSink(peer_sig->link_sink, offset + record_size));
+    record = &bufptr[offset];
+
+    if (!coalesce->size)
+    {
+        uint8 hdr = PEER_SIG_HEADER_FLAG_ACCEPTS_COALESCED;
+
+        /*Increment peer signalling tx sequence number*/
+        peer_sig->tx_seq++;
+
+        bufptr[PEER_SIG_HEADER_OFFSET] = PEER_SIG_SET_HEADER_TYPE(hdr, PEER_SIG_TYPE_COALESCED);
+        bufptr[PEER_SIG_TX_SEQ_NUMBER_OFFSET] = peer_sig->tx_seq;
+
+        MessageSendLater(&peer_sig->task, PEER_SIG_INTERNAL_COALESCE_TIMEOUT, NULL,
+                         appConfigPeerSigCoalesceWindowMs());
+    }
+    else
+    {
+        /* This message would otherwise have needed its own SDU and header */
+        Metrics_IncrementAt(peer_sig_packets_saved, mmcd->msg_channel_id);
+        Metrics_AddAt(peer_sig_bytes_saved, mmcd->msg_channel_id,
+                      PEER_SIG_L2CAP_SDU_OVERHEAD + PEER_SIG_MARSHAL_HEADER_SIZE - PEER_SIG_RECORD_HEADER_SIZE);
+    }
+
+    if (appConfigPeerSigCompressThreshold() && payload_size >= appConfigPeerSigCompressThreshold())
+    {
+        uint8 *original = PanicUnlessMalloc(payload_size);
+        uint8 *compressed = &record[PEER_SIG_RECORD_HEADER_SIZE + PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE];
+        uint16 compressed_size;
+
+        appPeerSigMarshalInto(marshaller, specialised, type, msg_ptr, original, payload_size);
+
+        compressed_size = peerSig_CompressPayload(original, payload_size, compressed,
+                                                  payload_size - PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE);
+        if (compressed_size)
+        {
+#ifdef PEER_SIG_VERIFY_COMPRESSION
+            /* Check the round trip before the record is committed */
+            uint8 *decompressed = PanicUnlessMalloc(payload_size);
+            PanicFalse(peerSig_DecompressPayload(compressed, compressed_size, decompressed, payload_size));
+            PanicFalse(memcmp(decompressed, original, payload_size) == 0);
+            free(decompressed);
+#endif
+            flags |= PEER_SIG_RECORD_FLAG_COMPRESSED;
+            appPeerSigWriteUint16(&record[PEER_SIG_RECORD_HEADER_SIZE], payload_size);
+            record_size = PEER_SIG_RECORD_HEADER_SIZE + PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE + compressed_size;
+            Metrics_AddAt(peer_sig_bytes_saved, mmcd->msg_channel_id,
+                          payload_size - PEER_SIG_RECORD_ORIGINAL_LENGTH_SIZE - compressed_size);
+        }
+        else
+        {
+            memcpy(&record[PEER_SIG_RECORD_HEADER_SIZE], original, payload_size);
+        }
+        free(original);
+    }
+    else
+    {
+        appPeerSigMarshalInto(marshaller, specialised, type, msg_ptr,
+                              &record[PEER_SIG_RECORD_HEADER_SIZE], payload_size);
+    }
+
+    record[PEER_SIG_RECORD_CHANNEL_OFFSET] = (uint8)mmcd->msg_channel_id;
+    record[PEER_SIG_RECORD_FLAGS_OFFSET] = flags;
+    appPeerSigWriteUint16(&record[PEER_SIG_RECORD_LENGTH_OFFSET], record_size - PEER_SIG_RECORD_HEADER_SIZE);
+
+    coalesce->size = offset + record_size;
+    coalesce->msgs[coalesce->num_msgs].client_task = mmcd->client_task;
+    coalesce->msgs[coalesce->num_msgs].type = type;
+    coalesce->msgs[coalesce->num_msgs].channel = mmcd->msg_channel_id;
+    coalesce->num_msgs++;
+
+    /* Only hold the SDU open while more messages are already waiting to join it */
+    if (coalesce->num_msgs == PEER_SIG_COALESCE_MAX_MESSAGES || !appPeerSigChannelMsgsPending())
+    {
+        appPeerSigCoalesceFlush();
+    }
+    else
+    {
+        appPeerSigSetLockBasedOnSinkSlack();
+    }
+
+    return TRUE;
+}
+
 /*! \brief Attempt to marshal a message to the peer. */
 static void appPeerSigMarshal(
                     marshal_msg_channel_data_t *mmcd,
@@ -1789,18 +2207,37 @@ static void appPeerSigMarshal(
                 return;
             }
 #endif
-            marshaller_t marshaller;
+            const marshal_specialised_t *specialised = appPeerSigGetSpecialised(mmcd, type);
+            marshaller_t marshaller = NULL;
             size_t space_required = 0;
             uint8* bufptr = NULL;
 
-            /* get the marshaller for this msg channel */
-            marshaller = PanicNull(MarshalInit(mmcd->type_desc, mmcd->num_type_desc));
-
             /* determine how much space the marshaller will need in order to claim
              * it from the l2cap sink, then try and claim that amount */
-            MarshalSetBuffer(marshaller, NULL, 0);
-            Marshal(marshaller, msg_ptr, type);
-            space_required = MarshalRemaining(marshaller);
+            if (specialised)
+            {
+                specialised->marshal(msg_ptr, type, NULL, 0, &space_required);
+            }
+            else
+            {
+                /* get the marshaller for this msg channel */
+                marshaller = PanicNull(MarshalInit(mmcd->type_desc, mmcd->num_type_desc));
+
+                MarshalSetBuffer(marshaller, NULL, 0);
+                Marshal(marshaller, msg_ptr, type);
+                space_required = MarshalRemaining(marshaller);
+            }
+
+            if (appConfigPeerSigCoalesceWindowMs() && peer_sig->peer_accepts_coalesced &&
+                appPeerSigCoalesceMarshal(mmcd, marshaller, specialised, type, msg_ptr, space_required))
+            {
+                if (marshaller)
+                {
+                    MarshalDestroy(marshaller, FALSE);
+                }
+                break;
+            }
+
             bufptr = appPeerSigClaimSink(peer_sig->link_sink, PEER_SIG_MARSHAL_HEADER_SIZE + space_required);
             PanicNull(bufptr);
 
@@ -1810,17 +2247,18 @@ static void appPeerSigMarshal(
             /* write the marshal msg header */
             appPeerSigWriteMarshalMsgChannelHeader(bufptr, peer_sig->tx_seq, mmcd->msg_channel_id);
 
-            /* tell the marshaller where in the buffer it can write */
-            MarshalSetBuffer(marshaller, &bufptr[PEER_SIG_MARSHAL_PAYLOAD_OFFSET], space_required);
-
             /* actually marshal this time and flush the sink to transmit it */
-            PanicFalse(Marshal(marshaller, msg_ptr, type));
+            appPeerSigMarshalInto(marshaller, specialised, type, msg_ptr,
+                                  &bufptr[PEER_SIG_MARSHAL_PAYLOAD_OFFSET], space_required);
 #ifdef DUMP_MARSHALL_DATA
             dump_buffer(bufptr, PEER_SIG_MARSHAL_HEADER_SIZE + space_required);
 #endif
             SinkFlush(peer_sig->link_sink, PEER_SIG_MARSHAL_HEADER_SIZE + space_required);
 
-            MarshalDestroy(marshaller, FALSE);
+            if (marshaller)
+            {
+                MarshalDestroy(marshaller, FALSE);
+            }
 
             /* tell the client the message was sent */
             appPeerSigMarshalledMsgChannelTxCfm(mmcd->client_task, type,
@@ -1970,6 +2408,10 @@ static void appPeerSigHandleMessage(Task task, MessageId id, Message message)
             appPeerSigHandleInternalShutdownReq();
             break;
 
+        case PEER_SIG_INTERNAL_COALESCE_TIMEOUT:
+            appPeerSigCoalesceFlush();
+            break;
+
 #ifdef USE_SYNERGY
         case PEER_SIG_INTERNAL_CLOSE_SDP:
             appPeerSigHandleInternalCloseSdp();
@@ -2061,10 +2503,22 @@ void appPeerSigMarshalledMsgChannelTaskRegister(Task task, peerSigMsgChannel cha
     mmcd->msg_channel_id = channel;
     mmcd->type_desc = PanicNull((void*)type_desc);
     mmcd->num_type_desc = PanicZero(num_type_desc);
+    mmcd->specialised = NULL;
 
     DEBUG_LOG("MarshalInit %p for task %p", mmcd->type_desc, task);
 }
 
+/*! \brief Use generated specialised marshal functions on a marshalled message channel. */
+void appPeerSigMarshalledMsgChannelSetSpecialised(Task task, peerSigMsgChannel channel,
+                                                  const marshal_specialised_t *specialised)
+{
+    marshal_msg_channel_data_t* mmcd = appPeerSigGetChannelData(channel);
+
+    PanicFalse(mmcd->client_task == task);
+
+    mmcd->specialised = specialised;
+}
+
 /*! \brief Unregister peerSigMsgChannel(s) for the a marshalled message channel. */
 void appPeerSigMarshalledMsgChannelTaskUnregister(Task task, peerSigMsgChannel channel)
 {
@@ -2102,19 +2556,11 @@ void appPeerSigMarshalledMsgChannelTx(Task task,
 */
 bool appPeerSigCheckForPendingMarshalledMsg(void)
 {
-    peerSigMsgChannel channel;
-    bool msg_pending = FALSE;
+    bool msg_pending = (PeerSigGetTaskData()->coalesce.num_msgs != 0) || appPeerSigChannelMsgsPending();
 
-    /*Check all channels for any pending messages in the message queue */
-    for (channel = 0; channel < PEER_SIG_MSG_CHANNEL_MAX; channel++)
+    if (msg_pending)
     {
-        marshal_msg_channel_data_t *mmcd = appPeerSigGetChannelData(channel);
-        if (mmcd->client_task && MessagesPendingForTask(&mmcd->channel_task, NULL) != 0)
-        {
-            msg_pending = TRUE;
-                DEBUG_LOG("appPeerSigCheckForPendingMarshalledMsg message is pending");
-            break;
-        }
+        DEBUG_LOG("appPeerSigCheckForPendingMarshalledMsg message is pending");
     }
 
     return msg_pending;
@@ -2169,7 +2615,8 @@ uint8 appPeerSigGetLastRxMsgSequenceNumber(void)
 uint8 appPeerSigGetPendingMarshalledMsgNum(void)
 {
     peerSigMsgChannel channel;
-    uint8 msg_pending_num = 0;
+    /* Messages in a coalesced SDU have not been transmitted yet */
+    uint8 msg_pending_num = PeerSigGetTaskData()->coalesce.num_msgs;
 
     DEBUG_LOG("appPeerSigGetPendingMarshalledMsgNum");
 
@@ -297,6 +297,10 @@ typedef enum
     /*! Message to release resources allocated for SDP search */
     PEER_SIG_INTERNAL_CLOSE_SDP,
 
+    /*! Message to transmit the coalesced SDU if it is still open when the
+        latency window expires */
+    PEER_SIG_INTERNAL_COALESCE_TIMEOUT,
+
     /*! This must be the final message */
     PEER_SIG_INTERNAL_MESSAGE_END
 } PEER_SIG_INTERNAL_MSG;
@@ -357,6 +361,21 @@ void appPeerSigMarshalledMsgChannelTaskRegister(Task task, peerSigMsgChannel cha
                                                 const marshal_type_descriptor_t * const * type_desc,
                                                 size_t num_type_desc);
 
+/*! \brief Use generated specialised marshal functions on a marshalled message channel.
+
+    Messages of types with specialised functions are marshalled and
+    unmarshalled by them rather than by walking the type descriptors. The
+    byte stream is the same, so the peer does not have to do the same.
+
+    \param[in] task         Task registered for the channel.
+    \param[in] channel      Channel registered by the task.
+    \param[in] specialised  Table generated by typegen for a typedef file with
+                            specialised="true", indexed by marshal type, or
+                            NULL to only use the type descriptors.
+*/
+void appPeerSigMarshalledMsgChannelSetSpecialised(Task task, peerSigMsgChannel channel,
+                                                  const marshal_specialised_t *specialised);
+
 /*! \brief Unregister peerSigMsgChannel(s) for the a marshalled message channel.
     \param[in] task             Task associated with the channel(s).
     \param[in] channel          Channel to unregister.
@@ -0,0 +1,135 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \version
+    \file       peer_signalling_compress.c
+    \ingroup    peer_signalling
+    \brief      Lightweight run-length compression of coalesced peer signalling payloads.
+
+    The encoding is a byte oriented PackBits variant. Each run starts with a
+    control octet:
+    - 0x00..0x7F: (control + 1) literal octets follow.
+    - 0x80..0xFF: the next octet is repeated (control - 0x80 + 3) times.
+
+    Marshalled ADK state is dominated by zero padding, unused addresses and
+    counters, which this scheme removes cheaply without any working memory.
+*/
+
+#include "peer_signalling_private.h"
+
+#include <string.h>
+
+/*! Shortest run that is worth encoding as a repeat. */
+#define PEER_SIG_RLE_MIN_RUN        (3)
+/*! Longest run a single repeat control octet can describe. */
+#define PEER_SIG_RLE_MAX_RUN        (0x7F + PEER_SIG_RLE_MIN_RUN)
+/*! Longest literal sequence a single control octet can describe. */
+#define PEER_SIG_RLE_MAX_LITERAL    (0x80)
+/*! Control octet flag indicating a repeat. */
+#define PEER_SIG_RLE_REPEAT         (0x80)
+
+static uint16 peerSig_RunLength(const uint8 *src, uint16 pos, uint16 len)
+{
+    uint16 run = 1;
+
+    while ((pos + run) < len && src[pos + run] == src[pos] && run < PEER_SIG_RLE_MAX_RUN)
+    {
+        run++;
+    }
+
+    return run;
+}
+
+uint16 peerSig_CompressPayload(const uint8 *src, uint16 src_len, uint8 *dst, uint16 dst_size)
+{
+    uint16 in = 0;
+    uint16 out = 0;
+
+    if (src_len <= PEER_SIG_RLE_MIN_RUN)
+    {
+        return 0;
+    }
+
+    /* Compressed output is only useful if it is smaller than the input */
+    if (dst_size >= src_len)
+    {
+        dst_size = src_len - 1;
+    }
+
+    while (in < src_len)
+    {
+        uint16 run = peerSig_RunLength(src, in, src_len);
+
+        if (run >= PEER_SIG_RLE_MIN_RUN)
+        {
+            if ((out + 2) > dst_size)
+            {
+                return 0;
+            }
+            dst[out++] = PEER_SIG_RLE_REPEAT | (uint8)(run - PEER_SIG_RLE_MIN_RUN);
+            dst[out++] = src[in];
+            in += run;
+        }
+        else
+        {
+            uint16 start = in;
+            uint16 count;
+
+            /* Gather literals until the next worthwhile run */
+            while (in < src_len && (in - start) < PEER_SIG_RLE_MAX_LITERAL &&
+                   peerSig_RunLength(src, in, src_len) < PEER_SIG_RLE_MIN_RUN)
+            {
+                in++;
+            }
+
+            count = in - start;
+            if ((out + 1 + count) > dst_size)
+            {
+                return 0;
+            }
+            dst[out++] = (uint8)(count - 1);
+            memcpy(&dst[out], &src[start], count);
+            out += count;
+        }
+    }
+
+    return out;
+}
+
+bool peerSig_DecompressPayload(const uint8 *src, uint16 src_len, uint8 *dst, uint16 dst_len)
+{
+    uint16 in = 0;
+    uint16 out = 0;
+
+    while (in < src_len)
+    {
+        uint8 control = src[in++];
+
+        if (control & PEER_SIG_RLE_REPEAT)
+        {
+            uint16 run = (control & ~PEER_SIG_RLE_REPEAT) + PEER_SIG_RLE_MIN_RUN;
+
+            if (in >= src_len || (out + run) > dst_len)
+            {
+                return FALSE;
+            }
+            memset(&dst[out], src[in++], run);
+            out += run;
+        }
+        else
+        {
+            uint16 count = control + 1;
+
+            if ((in + count) > src_len || (out + count) > dst_len)
+            {
+                return FALSE;
+            }
+            memcpy(&dst[out], &src[in], count);
+            in += count;
+            out += count;
+        }
+    }
+
+    return (out == dst_len);
+}
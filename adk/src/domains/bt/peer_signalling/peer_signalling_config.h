@@ -20,6 +20,17 @@
     After this many attempts the connection request will be failed. */
 #define appConfigPeerSigSdpSearchTryLimit()         (3)
 
+/*! Longest time in milliseconds that a marshalled message may be held back
+    so that further messages can be packed into the same L2CAP SDU.
+    A message is only held back while other marshalled messages are already
+    queued, otherwise it is sent straight away.
+    0 disables coalescing and every message is sent in its own SDU. */
+#define appConfigPeerSigCoalesceWindowMs()          (5)
+
+/*! Minimum size in octets of a marshalled message payload before compression
+    is attempted when it is added to a coalesced SDU. 0 disables compression. */
+#define appConfigPeerSigCompressThreshold()         (48)
+
 
 #endif /* PEER_SIGNALLING_CONFIG_H_ */
 /*! @} */
\ No newline at end of file
@@ -34,6 +34,9 @@
 #define PEER_SIG_CONNECT_TASKS_LIST_INIT_CAPACITY 1
 #define PEER_SIG_DISCONNECT_TASKS_LIST_INIT_CAPACITY 1
 
+/*! Maximum number of marshalled messages packed into one coalesced SDU. */
+#define PEER_SIG_COALESCE_MAX_MESSAGES 8
+
 /*! \brief Data held per client task for marshalled message channels. */
 typedef struct
 {
@@ -50,10 +53,41 @@ typedef struct
     /*! The number of type descriptors */
     uint8 num_type_desc;
 
+    /*! Generated specialised marshal functions for the channel's types, or
+        NULL to always use the type descriptors */
+    const marshal_specialised_t *specialised;
+
     /*! The channel */
     peerSigMsgChannel msg_channel_id;
 } marshal_msg_channel_data_t;
 
+/*! \brief A marshalled message written into the open coalesced SDU, kept
+           so the client can be confirmed once the SDU is transmitted. */
+typedef struct
+{
+    /*! The client to confirm */
+    Task client_task;
+
+    /*! Marshal type of the message */
+    marshal_type_t type;
+
+    /*! The channel the message was sent on */
+    peerSigMsgChannel channel;
+} peer_sig_coalesced_msg_t;
+
+/*! \brief State of the coalesced SDU currently being built in the link sink. */
+typedef struct
+{
+    /*! Number of octets claimed and written in the sink, 0 if no SDU is open */
+    uint16 size;
+
+    /*! Number of messages in the open SDU */
+    uint8 num_msgs;
+
+    /*! Messages waiting for the open SDU to be flushed */
+    peer_sig_coalesced_msg_t msgs[PEER_SIG_COALESCE_MAX_MESSAGES];
+} peer_sig_coalesce_t;
+
 /*! \brief Types of lock used to control receipt of messages by the peer sig task. */
 typedef enum
 {
@@ -99,6 +133,12 @@ typedef struct
     /*! Per-channel state */
     marshal_msg_channel_data_t marshal_msg_channel_state[PEER_SIG_MSG_CHANNEL_MAX];
 
+    /*! Coalesced SDU under construction */
+    peer_sig_coalesce_t coalesce;
+
+    /*! TRUE once the peer has shown that it accepts coalesced SDUs */
+    bool peer_accepts_coalesced;
+
     /* Record the Task which first requested a connect or disconnect */
     TASK_LIST_WITH_INITIAL_CAPACITY(PEER_SIG_CONNECT_TASKS_LIST_INIT_CAPACITY) connect_tasks;
     TASK_LIST_WITH_INITIAL_CAPACITY(PEER_SIG_DISCONNECT_TASKS_LIST_INIT_CAPACITY) disconnect_tasks;
@@ -128,5 +168,29 @@ extern peerSigTaskData app_peer_sig;
 */
 bool appPeerSigCheckForPendingMarshalledMsg(void);
 
+/*! \brief Compress a marshalled payload.
+
+    \param src         The payload to compress.
+    \param src_len     Length of the payload in octets.
+    \param dst         Buffer to write the compressed payload to.
+    \param dst_size    Size of dst in octets.
+
+    \return Length of the compressed payload, or 0 if it could not be made
+            smaller than src_len within dst_size octets.
+*/
+uint16 peerSig_CompressPayload(const uint8 *src, uint16 src_len, uint8 *dst, uint16 dst_size);
+
+/*! \brief Decompress a payload compressed with peerSig_CompressPayload().
+
+    \param src         The compressed payload.
+    \param src_len     Length of the compressed payload in octets.
+    \param dst         Buffer to write the original payload to.
+    \param dst_len     Expected length of the original payload in octets.
+
+    \return TRUE if exactly dst_len octets were decoded, FALSE if the payload
+            is malformed.
+*/
+bool peerSig_DecompressPayload(const uint8 *src, uint16 src_len, uint8 *dst, uint16 dst_len);
+
 #endif /* PEER_SIGNALLING_PRIVATE_H_ */
 /*! @} */
\ No newline at end of file
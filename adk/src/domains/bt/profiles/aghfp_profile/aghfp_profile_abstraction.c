@@ -15,6 +15,7 @@
 #include "aghfp_profile_port_protected.h"
 #include "ps.h"
 #include "ps_key_map.h"
+#include "ps_cache.h"
 
 /***************************** Macros ****************************************/
 
@@ -26,7 +27,7 @@ void AghfpProfileAbstract_Activate(uint16 supported_qce_codecs, uint16 supported
 #ifdef TEST_HFP_CODEC_PSKEY
     uint16 hfp_codec_pskey = 0xffff;    /* default to enable all codecs */
     uint16 supported_wbs_codecs = wbs_codec_cvsd;  /* cannot disable NB */
-    PsRetrieve(PS_KEY_TEST_HFP_CODEC, &hfp_codec_pskey, sizeof(hfp_codec_pskey));
+    PsCache_Retrieve(PS_KEY_TEST_HFP_CODEC, &hfp_codec_pskey, sizeof(hfp_codec_pskey));
 
     supported_wbs_codecs |= (hfp_codec_pskey & HFP_CODEC_PS_BIT_WB) ? wbs_codec_msbc : 0;
     supported_qce_codecs = (hfp_codec_pskey & HFP_CODEC_PS_BIT_SWB) ? AghfpProfilePort_GetSupportedQceCodec() : 0;
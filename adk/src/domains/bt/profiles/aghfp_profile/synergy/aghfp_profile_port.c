@@ -33,6 +33,7 @@
 #include "connection_manager.h"
 #include "telephony_messages.h"
 #include "ps_key_map.h"
+#include "ps_cache.h"
 
 static     uint16 ag_supported_qce_codec_modes;
 
@@ -1191,7 +1192,7 @@ void AghfpProfilePort_InitLibrary(uint16 supported_qce_codecs, uint16 supported_
 #ifdef TEST_HFP_CODEC_PSKEY
     uint16 hfp_codec_pskey = 0xffff;    /* default to enable all codecs */
 
-    PsRetrieve(PS_KEY_TEST_HFP_CODEC, &hfp_codec_pskey, sizeof(hfp_codec_pskey));
+    PsCache_Retrieve(PS_KEY_TEST_HFP_CODEC, &hfp_codec_pskey, sizeof(hfp_codec_pskey));
     DEBUG_LOG("AghfpProfilePort_InitLibrary Initial: hfp_codec_pskey 0x%x  supported_qce_codecs 0x%x  supported_features 0x%x", hfp_codec_pskey, supported_qce_codecs, supported_features);
 
     supported_features = (hfp_codec_pskey & HFP_CODEC_PS_BIT_WB) ? (supported_features | CSR_BT_HFG_SUPPORT_CODEC_NEGOTIATION) : (supported_features & ~CSR_BT_HFG_SUPPORT_CODEC_NEGOTIATION);
@@ -82,6 +82,12 @@ static bool btdbgProfile_Marshal(const tp_bdaddr *tp_bd_addr, uint8 *buf, uint16
     return marshalled;
 }
 
+static uint16 btdbgProfile_EstimateSize(const tp_bdaddr *tp_bd_addr)
+{
+    UNUSED(tp_bd_addr);
+    return sizeof(btdbg_profile_marshalled_t);
+}
+
 static bool btdbgProfile_Unmarshal(const tp_bdaddr *tp_bd_addr, const uint8 *buf, uint16 buf_length, uint16 *consumed)
 {
     DEBUG_LOG_VERBOSE("btdbgProfile_Unmarshal buf len %d, lap 0x%x", buf_length, tp_bd_addr->taddr.addr.lap);
@@ -143,12 +149,15 @@ static void btdbgProfile_Abort(void)
 }
 
 const handover_interface btdbg_profile_handover_if =
-        MAKE_HANDOVER_IF(&btdbgProfile_Veto,
-                         &btdbgProfile_Marshal,
-                         &btdbgProfile_Unmarshal,
-                         &btdbgProfile_Commit,
-                         &btdbgProfile_Complete,
-                         &btdbgProfile_Abort);
+        MAKE_HANDOVER_IF_ESTIMATE(HANDOVER_SUPPORT_ALL,
+                                  &btdbgProfile_Veto,
+                                  NULL,
+                                  &btdbgProfile_EstimateSize,
+                                  &btdbgProfile_Marshal,
+                                  &btdbgProfile_Unmarshal,
+                                  &btdbgProfile_Commit,
+                                  &btdbgProfile_Complete,
+                                  &btdbgProfile_Abort);
 
 
 
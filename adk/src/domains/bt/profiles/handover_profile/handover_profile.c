@@ -230,6 +230,10 @@ static void handoverProfile_HandleMessage(Task task,
             HandoverProfile_HandleInternalCloseSdpReq();
             break;
 #endif
+        case HANDOVER_PROFILE_INTERNAL_P1_SNAPSHOT_REFRESH:
+            handoverProfile_RefreshP1Snapshots();
+            break;
+
         default:
             DEBUG_LOG("handoverProfile_HandleMessage Unhandled message 0x%x",id);
             break;
@@ -64,6 +64,22 @@ typedef struct
 /*! brief Confirmation of the result of a disconnect request. */
 typedef HANDOVER_PROFILE_CONNECT_CFM_T HANDOVER_PROFILE_DISCONNECT_CFM_T;
 
+/*! brief Marshalling statistics for an appsP1 handover client, recorded
+    during the last handover. */
+typedef struct
+{
+    /*! Octets marshalled by the client */
+    uint16 marshal_len;
+    /*! Time in microseconds spent marshalling (or copying the snapshot of) the client */
+    uint32 marshal_time_us;
+    /*! Longest marshal time in microseconds seen for the client */
+    uint32 max_marshal_time_us;
+    /*! Number of times the client's pre-marshalled snapshot was used */
+    uint16 snapshot_hits;
+    /*! Number of times the client's marshal function was called */
+    uint16 marshal_calls;
+} handover_profile_p1_client_stats_t;
+
 /*! brief Client callback on handover start request when recieved on acceptor
 
     This callback shall indicate arrival of \ref HANDOVER_PROTOCOL_START_REQ 
@@ -193,6 +209,29 @@ void HandoverProfile_TerminateSdpPrimitive(void);
 */
 void HandoverProfile_RegisterAcceptorCb(const handover_profile_acceptor_cb_t *callback);
 
+/*! \brief Inform the handover profile that a client's marshalled state changed.
+
+    Only of use for clients whose handover interface was created with a
+    _SNAPSHOT macro. The handover profile keeps a pre-marshalled snapshot of
+    such clients and copies it into the handover data instead of calling the
+    client's marshal function, so only the clients whose state changed since
+    their snapshot was taken are marshalled while the links are frozen.
+
+    The client must call this every time any of its marshalled state changes.
+    This discards the client's snapshots and schedules new ones to be taken.
+
+    \param client The client's handover interface.
+*/
+void HandoverProfile_InvalidateP1Snapshot(const handover_interface *client);
+
+/*! \brief Get the marshalling statistics of an appsP1 handover client.
+
+    \param client_id Index of the client in handover_clients.
+    \param[out] stats Filled in with the statistics of the client.
+    \return TRUE if client_id is valid, otherwise FALSE.
+*/
+bool HandoverProfile_GetP1ClientStats(uint8 client_id, handover_profile_p1_client_stats_t *stats);
+
 #else
 
 #define HandoverProfile_Init(init_task) (FALSE)
@@ -213,6 +252,10 @@ void HandoverProfile_RegisterAcceptorCb(const handover_profile_acceptor_cb_t *ca
 
 #define HandoverProfile_RegisterAcceptorCb(callback)
 
+#define HandoverProfile_InvalidateP1Snapshot(client) UNUSED(client)
+
+#define HandoverProfile_GetP1ClientStats(client_id, stats) (FALSE)
+
 #endif /* INCLUDE_MIRRORING */
 
 #endif /*HANDOVER_PROFILE_H_*/
@@ -11,6 +11,9 @@
 
 #include "handover_profile_private.h"
 
+#include <vm.h>
+#include <rtime.h>
+
 #define FOR_EACH_HANDOVER_CLIENT(ho_client) \
         for (const handover_interface **ho_clientpp = handover_clients, *ho_client = *ho_clientpp; \
              ho_client != NULL; \
@@ -20,6 +23,9 @@
 #define handoverProfile_IsClientSupportTransport(ho_client, handover_transport) \
     (ho_client->supportedType == HANDOVER_SUPPORT_ALL || ho_client->supportedType == handover_transport)
 
+/*! Client index matching all handover clients, or no client */
+#define HANDOVER_PROFILE_P1_ALL_CLIENTS 0xFF
+
 handover_profile_status_t handoverProfile_VetoP1ClientsGlobal(void)
 {
     unsigned counter = 0;
@@ -110,13 +116,267 @@ static inline uint8* claimAllSpaceInSinkAndMap(Sink s, uint8 **end)
     return start;
 }
 
+/* Returns HANDOVER_PROFILE_P1_ALL_CLIENTS if the client is not listed in
+   handover_clients, which is the case in builds that leave it out. */
+static uint8 handoverProfile_GetP1ClientId(const handover_interface *client)
+{
+    uint8 client_id = 0;
+
+    FOR_EACH_HANDOVER_CLIENT(ho_client)
+    {
+        if (ho_client == client)
+        {
+            return client_id;
+        }
+        client_id++;
+    }
+    return HANDOVER_PROFILE_P1_ALL_CLIENTS;
+}
+
+static handover_profile_p1_client_stats_t *handoverProfile_GetP1ClientStatsArray(void)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+
+    if (ho_inst->p1_client_stats == NULL)
+    {
+        unsigned num_clients = 0;
+        size_t size;
+
+        FOR_EACH_HANDOVER_CLIENT(ho_client)
+        {
+            UNUSED(ho_client);
+            num_clients++;
+        }
+        size = num_clients * sizeof(*ho_inst->p1_client_stats);
+        if (size)
+        {
+            ho_inst->p1_client_stats = PanicUnlessMalloc(size);
+            memset(ho_inst->p1_client_stats, 0, size);
+        }
+    }
+    return ho_inst->p1_client_stats;
+}
+
+static handover_p1_snapshot_t *handoverProfile_FindP1Snapshot(uint8 client_id, const tp_bdaddr *bd_addr)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+    handover_p1_snapshot_t *snapshot;
+
+    for (snapshot = ho_inst->p1_snapshots; snapshot != NULL; snapshot = snapshot->next)
+    {
+        if (snapshot->client_id == client_id && BdaddrTpIsSame(&snapshot->addr, bd_addr))
+        {
+            return snapshot;
+        }
+    }
+    return NULL;
+}
+
+/* Remove the snapshots of one client (or all clients if client_id is
+   HANDOVER_PROFILE_P1_ALL_CLIENTS), optionally only those of devices that are
+   no longer connected. */
+static void handoverProfile_RemoveP1Snapshots(uint8 client_id, bool disconnected_only)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+    handover_p1_snapshot_t **snapshotpp = &ho_inst->p1_snapshots;
+
+    while (*snapshotpp != NULL)
+    {
+        handover_p1_snapshot_t *snapshot = *snapshotpp;
+
+        if ((client_id == HANDOVER_PROFILE_P1_ALL_CLIENTS || snapshot->client_id == client_id) &&
+            (!disconnected_only || !ConManagerIsTpConnected(&snapshot->addr)))
+        {
+            *snapshotpp = snapshot->next;
+            free(snapshot);
+        }
+        else
+        {
+            snapshotpp = &snapshot->next;
+        }
+    }
+}
+
+static bool handoverProfile_AnyP1SnapshotClients(void)
+{
+    FOR_EACH_HANDOVER_CLIENT(ho_client)
+    {
+        if (ho_client->snapshot)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void handoverProfile_ScheduleP1SnapshotRefresh(void)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+
+    MessageCancelAll(&ho_inst->task, HANDOVER_PROFILE_INTERNAL_P1_SNAPSHOT_REFRESH);
+    MessageSendLater(&ho_inst->task, HANDOVER_PROFILE_INTERNAL_P1_SNAPSHOT_REFRESH, NULL,
+                     HANDOVER_PROFILE_P1_SNAPSHOT_REFRESH_DELAY_MSEC);
+}
+
+/* Take snapshots of all clients in snapshot mode that have none for the device */
+static void handoverProfile_RefreshP1SnapshotsForDevice(const tp_bdaddr *bd_addr, uint8 *buffer, uint16 size)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+    uint8 client_id = 0;
+
+    FOR_EACH_HANDOVER_CLIENT(ho_client)
+    {
+        if (ho_client->snapshot && ho_client->pFnMarshal &&
+            handoverProfile_IsClientSupportTransport(ho_client, bd_addr->transport) &&
+            handoverProfile_FindP1Snapshot(client_id, bd_addr) == NULL)
+        {
+            uint16 client_len = 0;
+
+            if (ho_client->pFnMarshal(bd_addr, buffer, size, &client_len))
+            {
+                handover_p1_snapshot_t *snapshot = PanicUnlessMalloc(sizeof(*snapshot) + client_len);
+
+                snapshot->addr = *bd_addr;
+                snapshot->client_id = client_id;
+                snapshot->len = client_len;
+                memcpy(snapshot->data, buffer, client_len);
+                snapshot->next = ho_inst->p1_snapshots;
+                ho_inst->p1_snapshots = snapshot;
+                DEBUG_LOG("handoverProfile_RefreshP1SnapshotsForDevice client=%d, len=%d, lap=0x%x",
+                          client_id, client_len, bd_addr->taddr.addr.lap);
+            }
+        }
+        client_id++;
+    }
+}
+
+void handoverProfile_RefreshP1Snapshots(void)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+    cm_connection_iterator_t iterator;
+    tp_bdaddr addr;
+    uint8 *buffer;
+
+    /* Snapshots are only used by the primary when initiating handover */
+    if (ho_inst->state != HANDOVER_PROFILE_STATE_CONNECTED || !ho_inst->is_primary ||
+        !handoverProfile_AnyP1SnapshotClients())
+    {
+        return;
+    }
+
+    handoverProfile_RemoveP1Snapshots(HANDOVER_PROFILE_P1_ALL_CLIENTS, TRUE);
+
+    /* Client data is marshalled into the same space that is available to it
+       at handover time, then copied into a snapshot of the exact size. */
+    buffer = PanicUnlessMalloc(HANDOVER_PROFILE_MARSHAL_PIPE_BUFFER_SIZE);
+
+    if (ConManager_IterateFirstActiveConnection(&iterator, &addr))
+    {
+        do
+        {
+            /* Same handset links as are handed over, see handoverProfile_PrimarySetup */
+            if ((addr.transport == TRANSPORT_BREDR_ACL && !BdaddrIsSame(&addr.taddr.addr, &ho_inst->peer_addr))
+#ifdef ENABLE_LE_HANDOVER
+                || addr.transport == TRANSPORT_BLE_ACL
+#endif
+               )
+            {
+                handoverProfile_RefreshP1SnapshotsForDevice(&addr, buffer,
+                                                            HANDOVER_PROFILE_MARSHAL_PIPE_BUFFER_SIZE - sizeof(uint8) - sizeof(uint16));
+            }
+        } while (ConManager_IterateNextActiveConnection(&iterator, &addr));
+    }
+
+    free(buffer);
+}
+
+void handoverProfile_ClearP1Snapshots(void)
+{
+    handover_profile_task_data_t *ho_inst = Handover_GetTaskData();
+
+    MessageCancelAll(&ho_inst->task, HANDOVER_PROFILE_INTERNAL_P1_SNAPSHOT_REFRESH);
+    handoverProfile_RemoveP1Snapshots(HANDOVER_PROFILE_P1_ALL_CLIENTS, FALSE);
+}
+
+void HandoverProfile_InvalidateP1Snapshot(const handover_interface *client)
+{
+    uint8 client_id = handoverProfile_GetP1ClientId(client);
+
+    if (client_id != HANDOVER_PROFILE_P1_ALL_CLIENTS && client->snapshot)
+    {
+        /* The stale snapshot is dropped now, so a handover before the refresh
+           marshals the client directly */
+        handoverProfile_RemoveP1Snapshots(client_id, FALSE);
+        handoverProfile_ScheduleP1SnapshotRefresh();
+    }
+}
+
+bool HandoverProfile_GetP1ClientStats(uint8 client_id, handover_profile_p1_client_stats_t *stats)
+{
+    handover_profile_p1_client_stats_t *client_stats = handoverProfile_GetP1ClientStatsArray();
+    uint8 num_clients = 0;
+
+    PanicNull(stats);
+
+    FOR_EACH_HANDOVER_CLIENT(ho_client)
+    {
+        UNUSED(ho_client);
+        num_clients++;
+    }
+    if (client_id >= num_clients)
+    {
+        return FALSE;
+    }
+    *stats = client_stats[client_id];
+    return TRUE;
+}
+
+/* Size the marshal pipe for a device from the clients' snapshots and size
+   estimates. If any client's size is not known in advance the largest pipe is
+   used. */
+static uint16 handoverProfile_GetP1MarshalPipeSize(const tp_bdaddr *bd_addr)
+{
+    uint8 client_id = 0;
+    uint32 size = 0;
+
+    FOR_EACH_HANDOVER_CLIENT(ho_client)
+    {
+        if (ho_client->pFnMarshal && handoverProfile_IsClientSupportTransport(ho_client, bd_addr->transport))
+        {
+            handover_p1_snapshot_t *snapshot = handoverProfile_FindP1Snapshot(client_id, bd_addr);
+
+            size += sizeof(uint8) + sizeof(uint16);
+            if (snapshot)
+            {
+                size += snapshot->len;
+            }
+            else if (ho_client->pFnEstimateSize)
+            {
+                size += ho_client->pFnEstimateSize(bd_addr);
+            }
+            else
+            {
+                DEBUG_LOG("handoverProfile_GetP1MarshalPipeSize client=%d has no estimate", client_id);
+                return HANDOVER_PROFILE_MARSHAL_PIPE_BUFFER_SIZE;
+            }
+        }
+        client_id++;
+    }
+
+    size = MAX(size, HANDOVER_PROFILE_MARSHAL_PIPE_MIN_SIZE);
+    return MIN(size, HANDOVER_PROFILE_MARSHAL_PIPE_BUFFER_SIZE);
+}
+
 Source handoverProfile_MarshalP1Clients(const tp_bdaddr *bd_addr)
 {
     uint8 client_id = 0;
     stream_pipe_t pipe;
     uint8 *start, *end, *write_ptr;
+    handover_profile_p1_client_stats_t *stats = handoverProfile_GetP1ClientStatsArray();
+    rtime_t marshal_start = VmGetTimerTime();
+    uint16 pipe_size = handoverProfile_GetP1MarshalPipeSize(bd_addr);
 
-    pipe = makePipe(HANDOVER_PROFILE_MARSHAL_PIPE_BUFFER_SIZE);
+    pipe = makePipe(pipe_size);
     start = write_ptr = claimAllSpaceInSinkAndMap(pipe.sink, &end);
 
     FOR_EACH_HANDOVER_CLIENT(ho_client)
@@ -126,21 +386,70 @@ Source handoverProfile_MarshalP1Clients(const tp_bdaddr *bd_addr)
         {
             uint8 *client_start;
             uint16 client_len = 0;
+            rtime_t client_start_time = VmGetTimerTime();
+            handover_p1_snapshot_t *snapshot = handoverProfile_FindP1Snapshot(client_id, bd_addr);
+            handover_profile_p1_client_stats_t *client_stats = &stats[client_id];
+            uint32 client_time;
+
             *write_ptr++ = client_id;
             client_start = write_ptr + sizeof(client_len);
             PanicFalse(end > client_start);
-            PanicFalse(ho_client->pFnMarshal(bd_addr, client_start, end - client_start, &client_len));
+            if (snapshot)
+            {
+                /* Client state has not changed since the snapshot was taken */
+                PanicFalse(snapshot->len <= (end - client_start));
+                memcpy(client_start, snapshot->data, snapshot->len);
+                client_len = snapshot->len;
+                client_stats->snapshot_hits++;
+            }
+            else
+            {
+                PanicFalse(ho_client->pFnMarshal(bd_addr, client_start, end - client_start, &client_len));
+                client_stats->marshal_calls++;
+            }
             CONVERT_FROM_UINT16(write_ptr, client_len);
             write_ptr += sizeof(client_len);
             write_ptr += client_len;
-            DEBUG_LOG("handoverProfile_MarshalP1Clients client=%d, len=%d", client_id, client_len);
+
+            client_time = rtime_sub(VmGetTimerTime(), client_start_time);
+            client_stats->marshal_len = client_len;
+            client_stats->marshal_time_us = client_time;
+            client_stats->max_marshal_time_us = MAX(client_stats->max_marshal_time_us, client_time);
+            DEBUG_LOG("handoverProfile_MarshalP1Clients client=%d, len=%d, time=%dus, snapshot=%d",
+                      client_id, client_len, client_time, snapshot != NULL);
         }
         client_id++;
     }
     PanicFalse(SinkFlush(pipe.sink, write_ptr - start));
+    DEBUG_LOG_INFO("handoverProfile_MarshalP1Clients total len=%d, pipe=%d, time=%dus",
+                   write_ptr - start, pipe_size, rtime_sub(VmGetTimerTime(), marshal_start));
     return pipe.source;
 }
 
+handover_profile_status_t handoverProfile_MarshalP1ClientsForAllDevices(void)
+{
+    FOR_EACH_HANDOVER_DEVICE(device)
+    {
+        device->u.p.p1_source = handoverProfile_MarshalP1Clients(&device->addr);
+    }
+    return HANDOVER_PROFILE_STATUS_SUCCESS;
+}
+
+handover_profile_status_t handoverProfile_AbortP1Marshal(void)
+{
+    FOR_EACH_HANDOVER_DEVICE(device)
+    {
+        /* Discard marshal data that was not sent to the peer */
+        if (device->u.p.p1_source)
+        {
+            SourceDrop(device->u.p.p1_source, SourceSize(device->u.p.p1_source));
+            SourceClose(device->u.p.p1_source);
+            device->u.p.p1_source = 0;
+        }
+    }
+    return handoverProfile_AbortP1Clients();
+}
+
 bool handoverProfile_UnmarshalP1Client(tp_bdaddr *addr, const uint8 *src_addr, uint16 src_len, uint16 *consumed)
 {
     const uint8 *read_ptr = src_addr;
@@ -201,6 +510,13 @@ void handoverProfile_CommitP1Clients(const tp_bdaddr *addr, bool is_primary)
 
 void handoverProfile_CompleteP1Clients(bool is_primary)
 {
+    /* Snapshots were taken in the old role, the new primary takes its own */
+    handoverProfile_ClearP1Snapshots();
+    if (handoverProfile_AnyP1SnapshotClients())
+    {
+        handoverProfile_ScheduleP1SnapshotRefresh();
+    }
+
     FOR_EACH_HANDOVER_CLIENT(ho_client)
     {
         if(ho_client->pFnComplete)
@@ -44,6 +44,22 @@ handover_profile_status_t handoverProfile_AbortP1Clients(void);
 */
 Source handoverProfile_MarshalP1Clients(const tp_bdaddr *bd_addr);
 
+/*! \brief Marshal appsP1 clients data for all devices being handed over.
+
+    The marshal data of each device is stored in the device's p1_source until
+    it is sent to the peer. This allows marshalling to be performed while
+    waiting for the peer to respond to the handover start request.
+
+    \return Status of operation.
+*/
+handover_profile_status_t handoverProfile_MarshalP1ClientsForAllDevices(void);
+
+/*! \brief Discard any appsP1 marshal data not yet sent to the peer and call
+           the abort function of the appsP1 clients.
+    \return Status of operation.
+*/
+handover_profile_status_t handoverProfile_AbortP1Marshal(void);
+
 /*! \brief Unmarshal a single appsP1 client.
     \param bd_addr Bluetooth address of the link being unmarshalled.
     \param src_addr Address of data to unmarshal.
@@ -59,6 +75,14 @@ bool handoverProfile_UnmarshalP1Client(tp_bdaddr *addr, const uint8 *src_addr, u
 */
 void handoverProfile_CommitP1Clients(const tp_bdaddr *addr, bool is_primary);
 
+/*! \brief Marshal the snapshots of appsP1 clients in snapshot mode that
+           are missing or have been invalidated, for all handset links.
+*/
+void handoverProfile_RefreshP1Snapshots(void);
+
+/*! \brief Discard all appsP1 client snapshots. */
+void handoverProfile_ClearP1Snapshots(void);
+
 /*! \brief Calls complete function of the appsP1 clients.
     \param is_primary TRUE if the new role if primary, otherwise FALSE.
  */
@@ -53,5 +53,20 @@ typedef struct handover_device
 
 } handover_device_t;
 
+/*! Pre-marshalled appsP1 client data for one device */
+typedef struct handover_p1_snapshot
+{
+    /*! The next snapshot */
+    struct handover_p1_snapshot *next;
+    /*! The device address */
+    tp_bdaddr addr;
+    /*! Index of the client in handover_clients */
+    uint8 client_id;
+    /*! Length of the marshalled data */
+    uint16 len;
+    /*! The marshalled data */
+    uint8 data[1];
+} handover_p1_snapshot_t;
+
 #endif
 /*! @} */
\ No newline at end of file
@@ -193,6 +193,9 @@ static void handoverProfile_EnterConnected(void)
     {
         /* Primary will veto handover until secondary firmware version is known */
         ho_inst->peer_firmware = HANDOVER_PROFILE_PEER_FIRMWARE_UNKNOWN;
+
+        /* Pre-marshal the appsP1 clients in snapshot mode ready for handover */
+        MessageSend(&ho_inst->task, HANDOVER_PROFILE_INTERNAL_P1_SNAPSHOT_REFRESH, NULL);
     }
     else
     {
@@ -207,6 +210,8 @@ static void handoverProfile_EnterConnected(void)
 static void handoverProfile_ExitConnected(void)
 {
     DEBUG_LOG("handoverProfile_ExitConnected");
+
+    handoverProfile_ClearP1Snapshots();
 }
 
 /*! \brief Performs operation required while entering the HANDOVER_PROFILE_STATE_DISCONNECTED state.
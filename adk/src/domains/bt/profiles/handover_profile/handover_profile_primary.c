@@ -18,6 +18,7 @@ typedef enum handover_profile_primary_states
     HO_PRIMARY_STATE_SELF_VETO,
     HO_PRIMARY_STATE_VETO1,
     HO_PRIMARY_STATE_SEND_START_REQ,
+    HO_PRIMARY_STATE_MARSHAL_P1_DATA,
     HO_PRIMARY_STATE_WAIT_FOR_START_CFM,
     HO_PRIMARY_STATE_SEND_P1_MARSHAL_DATA,
     HO_PRIMARY_STATE_WAIT_FOR_MARSHAL_DATA_CFM,
@@ -65,6 +66,7 @@ handover_profile_status_t (* const state_handler_map[])(void) =
     [HO_PRIMARY_STATE_SELF_VETO] =                              handoverProfile_PrimarySelfVeto,
     [HO_PRIMARY_STATE_VETO1] =                                  handoverProfile_VetoP1Clients,
     [HO_PRIMARY_STATE_SEND_START_REQ] =                         handoverProtocol_SendStartReq,
+    [HO_PRIMARY_STATE_MARSHAL_P1_DATA] =                        handoverProfile_MarshalP1ClientsForAllDevices,
     [HO_PRIMARY_STATE_WAIT_FOR_START_CFM] =                     handoverProtocol_WaitForStartCfm,
     [HO_PRIMARY_STATE_SEND_P1_MARSHAL_DATA] =                   handoverProtocol_SendP1MarshalData,
     [HO_PRIMARY_STATE_WAIT_FOR_MARSHAL_DATA_CFM] =              handoverProtocol_WaitForUnmarshalP1Cfm,
@@ -107,8 +109,9 @@ handover_profile_status_t (*const state_failure_map[])(void) =
     [HO_PRIMARY_STATE_SELF_VETO] =                              NULL,
     [HO_PRIMARY_STATE_VETO1] =                                  NULL,
     [HO_PRIMARY_STATE_SEND_START_REQ] =                         handoverProtocol_SendCancelInd,
+    [HO_PRIMARY_STATE_MARSHAL_P1_DATA] =                        handoverProfile_AbortP1Marshal,
     [HO_PRIMARY_STATE_WAIT_FOR_START_CFM] =                     NULL,
-    [HO_PRIMARY_STATE_SEND_P1_MARSHAL_DATA] =                   handoverProfile_AbortP1Clients,
+    [HO_PRIMARY_STATE_SEND_P1_MARSHAL_DATA] =                   NULL,
     [HO_PRIMARY_STATE_WAIT_FOR_MARSHAL_DATA_CFM] =              NULL,
     [HO_PRIMARY_STATE_VETO2] =                                  NULL,
     [HO_PRIMARY_STATE_PERFORMANCE_REQUEST] =                    handoverProfile_PerformanceRelinquish,
@@ -106,6 +106,14 @@
 #define HandoverPioClr()
 #endif
 
+/*! Smallest appsP1 marshal pipe, used when the marshal data size is known to be small */
+#define HANDOVER_PROFILE_MARSHAL_PIPE_MIN_SIZE (16)
+
+/*! Delay after a client invalidates its appsP1 snapshot before the snapshots
+    are marshalled again. Allows bursts of state changes to be absorbed by a
+    single refresh. */
+#define HANDOVER_PROFILE_P1_SNAPSHOT_REFRESH_DELAY_MSEC     (100)
+
 /*! Special handle to be used with AclHandoverRoleCommit when there is no BR/EDR mirrored device */
 #define HANDOVER_PROFILE_INVALID_HANDLE 0xFF
 
@@ -236,6 +244,10 @@ typedef struct
     handover_type_t handover_type;
     /*! Pointer to application callback handling handover events on acceptor (Secondary) role */
     const handover_profile_acceptor_cb_t *handover_acceptor_cb;
+    /*! List of pre-marshalled appsP1 client snapshots */
+    handover_p1_snapshot_t *p1_snapshots;
+    /*! Per appsP1 client marshalling statistics, indexed as handover_clients */
+    handover_profile_p1_client_stats_t *p1_client_stats;
 } handover_profile_task_data_t;
 
 extern handover_profile_task_data_t ho_profile;
@@ -264,6 +276,9 @@ typedef enum
     /*! Message to release resources allocated for SDP search */
     HANDOVER_PROFILE_INTERNAL_CLOSE_SDP_REQ,
 
+    /*! Marshal the snapshots of appsP1 clients that are missing or invalidated */
+    HANDOVER_PROFILE_INTERNAL_P1_SNAPSHOT_REFRESH,
+
     /*! This must be the final message */
     HANDOVER_PROFILE_INTERNAL_MESSAGE_END
 } handover_profile_internal_msgs_t;
@@ -89,8 +89,16 @@ handover_profile_status_t handoverProtocol_SendP1MarshalData(void)
         const uint16 header_size = sizeof(opcode) + sizeof(tag);
 
         Sink sink = Handover_GetTaskData()->link_sink;
-        Source source = handoverProfile_MarshalP1Clients(&device->addr);
-        uint16 data_len = SourceSize(source);
+        Source source = device->u.p.p1_source;
+        uint16 data_len;
+
+        /* Data is normally marshalled while waiting for the start confirm */
+        if (!source)
+        {
+            source = handoverProfile_MarshalP1Clients(&device->addr);
+        }
+        device->u.p.p1_source = 0;
+        data_len = SourceSize(source);
         uint16 message_size = header_size + data_len;
         uint8 *write_ptr = handoverProtocol_SinkClaimAndMap(sink, header_size, message_size);
         if (write_ptr)
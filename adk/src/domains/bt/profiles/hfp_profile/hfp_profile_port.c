@@ -24,6 +24,7 @@
 #include <panic.h>
 #include <ps.h>
 #include <ps_key_map.h>
+#include <ps_cache.h>
 #include <sink.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -301,7 +302,7 @@ void hfpProfile_InitHfpLibrary(void)
 #ifdef TEST_HFP_CODEC_PSKEY
 
     uint16 hfp_codec_pskey = 0xffff;    /* enable all codecs by default */
-    PsRetrieve(PS_KEY_TEST_HFP_CODEC, &hfp_codec_pskey, sizeof(hfp_codec_pskey));
+    PsCache_Retrieve(PS_KEY_TEST_HFP_CODEC, &hfp_codec_pskey, sizeof(hfp_codec_pskey));
 
     DEBUG_LOG_ALWAYS("hfpProfile_InitHfpLibrary 0x%x", hfp_codec_pskey);
 
@@ -1559,6 +1559,8 @@ bool MirrorProfile_Init(Task task)
                                             PEER_SIG_MSG_CHANNEL_MIRROR_PROFILE,
                                             mirror_profile_marshal_type_descriptors,
                                             NUMBER_OF_MIRROR_PROFILE_MARSHAL_TYPES);
+    appPeerSigMarshalledMsgChannelSetSpecialised(MirrorProfile_GetTask(), PEER_SIG_MSG_CHANNEL_MIRROR_PROFILE,
+                                                 mirror_profile_marshal_specialised);
 
     /* Register for peer signaling notifications */
     appPeerSigClientRegister(MirrorProfile_GetTask());
@@ -147,6 +147,13 @@ static bool MirrorProfile_Marshal(const tp_bdaddr *tp_bd_addr,
     return TRUE;
 }
 
+static uint16 MirrorProfile_EstimateSize(const tp_bdaddr *tp_bd_addr)
+{
+    UNUSED(tp_bd_addr);
+    /* nothing is marshalled */
+    return 0;
+}
+
 static bool MirrorProfile_Unmarshal(const tp_bdaddr *tp_bd_addr,
                                     const uint8 *buf,
                                     uint16 length,
@@ -313,11 +320,14 @@ static void MirrorProfile_HandoverAbort(void)
 }
 
 const handover_interface mirror_handover_if =
-        MAKE_HANDOVER_IF(&MirrorProfile_Veto,
-                         &MirrorProfile_Marshal,
-                         &MirrorProfile_Unmarshal,
-                         &MirrorProfile_HandoverCommit,
-                         &MirrorProfile_HandoverComplete,
-                         &MirrorProfile_HandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(HANDOVER_SUPPORT_ALL,
+                                  &MirrorProfile_Veto,
+                                  NULL,
+                                  &MirrorProfile_EstimateSize,
+                                  &MirrorProfile_Marshal,
+                                  &MirrorProfile_Unmarshal,
+                                  &MirrorProfile_HandoverCommit,
+                                  &MirrorProfile_HandoverComplete,
+                                  &MirrorProfile_HandoverAbort);
 
 #endif /* INCLUDE_MIRRORING */
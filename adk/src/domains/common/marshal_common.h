@@ -93,7 +93,24 @@ extern const marshal_type_descriptor_t marshal_type_descriptor_typed_bdaddr;
 /*! Marshal type descriptor for peer_sig_rtime_t. */
 extern const marshal_type_descriptor_t marshal_type_descriptor_marshal_rtime_t;
 
-/*! \brief Set the L2CAP link sink into marshal common module for timestamp 
+/*! \brief Specialised marshal and unmarshal functions of a marshal type.
+
+    typegen generates a table of these, indexed by marshal type, for typedef
+    files with specialised="true". The functions of types that are not
+    specialised are NULL, the type descriptors must be used for them instead.
+*/
+typedef struct
+{
+    /*! Marshal an object into buf. Returns FALSE without writing anything if
+        space is too small, *produced is set to the space needed either way. */
+    bool (*marshal)(const void *object, marshal_type_t type, uint8 *buf, size_t space, size_t *produced);
+
+    /*! Unmarshal an object allocated with calloc from buf. Returns NULL if buf
+        does not hold a complete object of the type. */
+    void *(*unmarshal)(marshal_type_t type, const uint8 *buf, size_t size, size_t *consumed);
+} marshal_specialised_t;
+
+/*! \brief Set the L2CAP link sink into marshal common module for timestamp
 conversions(from local time to BT wall clock and vice versa). */
 void MarshalCommon_SetSink(Sink sink);
 
@@ -0,0 +1,86 @@
+/*!
+\copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+            All Rights Reserved.
+            Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+\file
+\brief      Registry of on-device performance metrics.
+*/
+
+#include "metrics.h"
+
+#include <panic.h>
+#include <string.h>
+#include <logging.h>
+
+#ifndef DISABLE_METRICS
+
+/*! \brief The registration table, kept in one place for pydbg to read. */
+typedef struct
+{
+    const metric_registration_t *begin;
+    const metric_registration_t *end;
+} metrics_registry_t;
+
+static const metrics_registry_t metrics_registry =
+{
+    .begin = metric_registrations_begin,
+    .end = metric_registrations_end,
+};
+
+#define Metrics_ForEach(reg) \
+    for ((reg) = metrics_registry.begin; (reg) < metrics_registry.end; (reg)++)
+
+void Metrics_RecordSample(const metric_registration_t *reg, uint32 value)
+{
+    uint8 bucket = 0;
+
+    /* Bounds are few and in increasing order, a linear search is quickest */
+    while (bucket < reg->number_of_bounds && value > reg->bounds[bucket])
+    {
+        bucket++;
+    }
+    reg->values[bucket]++;
+}
+
+const metric_registration_t *Metrics_Find(uint16 id)
+{
+    const metric_registration_t *reg;
+
+    Metrics_ForEach(reg)
+    {
+        if (reg->id == id)
+        {
+            return reg;
+        }
+    }
+    return NULL;
+}
+
+uint16 Metrics_GetNumberOf(void)
+{
+    return (uint16)(metrics_registry.end - metrics_registry.begin);
+}
+
+const metric_registration_t *Metrics_GetByIndex(uint16 index)
+{
+    PanicFalse(index < Metrics_GetNumberOf());
+
+    return &metrics_registry.begin[index];
+}
+
+void Metrics_Reset(void)
+{
+    const metric_registration_t *reg;
+
+    DEBUG_LOG("Metrics_Reset");
+
+    Metrics_ForEach(reg)
+    {
+        if (reg->type != metric_type_gauge)
+        {
+            memset(reg->values, 0, Metrics_NumberOfValues(reg) * sizeof(reg->values[0]));
+        }
+    }
+}
+
+#endif /* DISABLE_METRICS */
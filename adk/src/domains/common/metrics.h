@@ -0,0 +1,262 @@
+/*!
+\copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+            All Rights Reserved.
+            Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+\file
+\brief      Registry of on-device performance metrics.
+
+            A component creates its metrics at file scope with one of the
+            METRIC_COUNTER(), METRIC_COUNTER_ARRAY(), METRIC_GAUGE() or
+            METRIC_HISTOGRAM() macros, for example:
+
+            METRIC_COUNTER(gaia_stream_bytes, METRIC_ID_GAIA_DATA_STREAM_BYTES);
+            METRIC_HISTOGRAM(prompt_latency, METRIC_ID_PROMPT_SOUND_LATENCY_MS, 10, 20, 50, 100);
+
+            and updates them with Metrics_Increment(), Metrics_Add(),
+            Metrics_IncrementAt(), Metrics_AddAt(), Metrics_Set() and
+            Metrics_Record(). Counters and gauges are
+            updated in line and cost no more than updating a global variable.
+
+            The description of every metric is placed by the linker in a table
+            of registrations, so metrics need no run-time registration and
+            can be read back by id with Metrics_Find(), by the statistics
+            GAIA plugin, or by the pydbg "metrics" report.
+
+            Metric ids are allocated in metric_id_t so that they stay the same
+            across builds and devices can be compared with each other.
+
+            Defining DISABLE_METRICS removes the metrics and their storage.
+*/
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <csrtypes.h>
+#include <hydra_macros.h>
+
+/*! \brief Ids of the metrics, as reported to a host.
+    New ids must be added at the end, existing ids must not be reused. */
+typedef enum
+{
+    /*! Bytes of data sent by GAIA data transfer streams */
+    METRIC_ID_GAIA_DATA_STREAM_BYTES = 1,
+
+    /*! GAIA data transfer streams started */
+    METRIC_ID_GAIA_DATA_STREAMS_STARTED,
+
+    /*! GAIA data transfer streams in progress */
+    METRIC_ID_GAIA_DATA_STREAMS_ACTIVE,
+
+    /*! Time from a tone or prompt request until it is heard, in ms, for
+        tones and prompts not played from the RAM prompt cache */
+    METRIC_ID_PROMPT_SOUND_LATENCY_MS,
+
+    /*! Tones and prompts played from the RAM prompt cache */
+    METRIC_ID_PROMPTS_PLAYED_FROM_CACHE,
+
+    /*! USB mass storage sectors sent from the read-ahead buffer */
+    METRIC_ID_USB_MSC_READ_AHEAD_SECTORS,
+
+    /*! USB mass storage rate of large sequential reads, in kB/s */
+    METRIC_ID_USB_MSC_SEQUENTIAL_READ_RATE_KBPS,
+
+    /*! GAIA packets sent together in one RFCOMM sink flush */
+    METRIC_ID_GAIA_RFCOMM_PACKETS_PER_FLUSH,
+
+    /*! Bytes of GAIA payload copied into the RFCOMM sink */
+    METRIC_ID_GAIA_RFCOMM_BYTES_COPIED,
+
+    /*! Bytes of GAIA payload copied to build GATT notifications */
+    METRIC_ID_GAIA_GATT_BYTES_COPIED,
+
+    /*! Peer signalling L2CAP SDUs avoided by coalescing marshalled messages,
+        a counter for each marshalled message channel (peerSigMsgChannel) */
+    METRIC_ID_PEER_SIG_PACKETS_SAVED,
+
+    /*! Peer signalling octets avoided by coalescing and compression, a
+        counter for each marshalled message channel (peerSigMsgChannel) */
+    METRIC_ID_PEER_SIG_BYTES_SAVED,
+
+    /*! Time from a prompt request until it is heard, in ms, for prompts
+        played from the RAM prompt cache */
+    METRIC_ID_CACHED_PROMPT_SOUND_LATENCY_MS,
+
+    /*! Time from a tone or prompt request until it is heard, in ms, when
+        the chain was already ready, kept warm or prepared in advance. These
+        are also counted in one of the two prompt latency histograms above. */
+    METRIC_ID_WARM_PROMPT_SOUND_LATENCY_MS,
+} metric_id_t;
+
+/*! \brief The kinds of metric. */
+typedef enum
+{
+    /*! A value that only goes up, such as a number of events */
+    metric_type_counter,
+
+    /*! A value that is set to the current level of something */
+    metric_type_gauge,
+
+    /*! A count of samples in each of a fixed set of buckets */
+    metric_type_histogram,
+
+    /*! A counter for each of a fixed number of indices, such as channels */
+    metric_type_counter_array,
+} metric_type_t;
+
+/*! \brief Description of a metric, placed in the registration table by the linker. */
+typedef struct
+{
+    /*! The value of a counter or gauge, the buckets of a histogram, or the
+        counters of a counter array */
+    uint32 *values;
+
+    /*! Inclusive upper bound of each histogram bucket but the last, in
+        increasing order. The last bucket counts samples above all bounds.
+        NULL for counters and gauges. */
+    const uint32 *bounds;
+
+    /*! Id of the metric, a metric_id_t */
+    uint16 id;
+
+    /*! Kind of metric, a metric_type_t */
+    uint8 type;
+
+    /*! Number of entries in \c bounds */
+    uint8 number_of_bounds;
+
+    /*! Number of entries in \c values */
+    uint8 number_of_values;
+} metric_registration_t;
+
+/*! \brief Number of values a metric has.
+    \param reg The metric.
+    \return 1 for a counter or gauge, the number of buckets for a histogram,
+            the number of counters for a counter array. */
+#define Metrics_NumberOfValues(reg) ((uint16)(reg)->number_of_values)
+
+#ifndef DISABLE_METRICS
+
+/*! Symbols generated by linker for the beginning and end of the metric registrations */
+extern const metric_registration_t metric_registrations_begin[];
+extern const metric_registration_t metric_registrations_end[];
+
+/*! \brief Register a metric and define its storage. */
+#define METRIC_REGISTER(NAME, ID, TYPE, BOUNDS, NUMBER_OF_BOUNDS) \
+_Pragma("datasection metric_registrations") \
+const metric_registration_t NAME##_metric_registration = \
+    { NAME##_metric, (BOUNDS), (uint16)(ID), (uint8)(TYPE), (uint8)(NUMBER_OF_BOUNDS), \
+      (uint8)ARRAY_DIM(NAME##_metric) }
+
+/*! \brief Create a counter, a value that only goes up.
+    \param NAME Name of the counter, used to update it.
+    \param ID   Its metric_id_t. */
+#define METRIC_COUNTER(NAME, ID) \
+uint32 NAME##_metric[1]; \
+METRIC_REGISTER(NAME, ID, metric_type_counter, NULL, 0)
+
+/*! \brief Create a counter for each of a fixed number of indices.
+    \param NAME Name of the counters, used to update them.
+    \param ID   Its metric_id_t.
+    \param SIZE Number of counters, at most 255. */
+#define METRIC_COUNTER_ARRAY(NAME, ID, SIZE) \
+uint32 NAME##_metric[SIZE]; \
+METRIC_REGISTER(NAME, ID, metric_type_counter_array, NULL, 0)
+
+/*! \brief Create a gauge, a value that is set to the level of something.
+    \param NAME Name of the gauge, used to update it.
+    \param ID   Its metric_id_t. */
+#define METRIC_GAUGE(NAME, ID) \
+uint32 NAME##_metric[1]; \
+METRIC_REGISTER(NAME, ID, metric_type_gauge, NULL, 0)
+
+/*! \brief Create a histogram.
+    \param NAME Name of the histogram, used to record samples in it.
+    \param ID   Its metric_id_t.
+    \param ...  The inclusive upper bound of each bucket, in increasing order.
+                A last bucket is added for samples above the highest bound. */
+#define METRIC_HISTOGRAM(NAME, ID, ...) \
+static const uint32 NAME##_metric_bounds[] = { __VA_ARGS__ }; \
+uint32 NAME##_metric[ARRAY_DIM(NAME##_metric_bounds) + 1]; \
+METRIC_REGISTER(NAME, ID, metric_type_histogram, NAME##_metric_bounds, ARRAY_DIM(NAME##_metric_bounds))
+
+/*! \brief Declare a metric created in another file, so it can be updated from this one. */
+#define METRIC_DECLARE(NAME) \
+extern uint32 NAME##_metric[]; \
+extern const metric_registration_t NAME##_metric_registration
+
+/*! \brief Add one to a counter. */
+#define Metrics_Increment(NAME)         ((void)(NAME##_metric[0]++))
+
+/*! \brief Add \p value to a counter or gauge. */
+#define Metrics_Add(NAME, value)        ((void)(NAME##_metric[0] += (uint32)(value)))
+
+/*! \brief Add one to the counter at \p index of a counter array.
+    Indices beyond the end of the array are ignored. */
+#define Metrics_IncrementAt(NAME, index) \
+    ((void)((uint32)(index) < ARRAY_DIM(NAME##_metric) ? NAME##_metric[(index)]++ : 0))
+
+/*! \brief Add \p value to the counter at \p index of a counter array.
+    Indices beyond the end of the array are ignored. */
+#define Metrics_AddAt(NAME, index, value) \
+    ((void)((uint32)(index) < ARRAY_DIM(NAME##_metric) ? NAME##_metric[(index)] += (uint32)(value) : 0))
+
+/*! \brief Subtract \p value from a gauge. */
+#define Metrics_Subtract(NAME, value)   ((void)(NAME##_metric[0] -= (uint32)(value)))
+
+/*! \brief Set a gauge to \p value. */
+#define Metrics_Set(NAME, value)        ((void)(NAME##_metric[0] = (uint32)(value)))
+
+/*! \brief Count a sample in the bucket of a histogram it falls in. */
+#define Metrics_Record(NAME, value)     Metrics_RecordSample(&NAME##_metric_registration, (uint32)(value))
+
+/*! \brief Count a sample in a histogram.
+    Use Metrics_Record() rather than calling this directly.
+
+    \param reg      The histogram.
+    \param value    The sample.
+*/
+void Metrics_RecordSample(const metric_registration_t *reg, uint32 value);
+
+/*! \brief Find a metric by its id.
+    \param id The metric_id_t.
+    \return The metric, or NULL if it isn't built in.
+*/
+const metric_registration_t *Metrics_Find(uint16 id);
+
+/*! \brief Get the number of metrics that are built in. */
+uint16 Metrics_GetNumberOf(void);
+
+/*! \brief Get a metric by its position in the registration table.
+    \param index Position, less than Metrics_GetNumberOf().
+    \return The metric.
+*/
+const metric_registration_t *Metrics_GetByIndex(uint16 index);
+
+/*! \brief Zero every counter and histogram.
+    Gauges are left alone, as they reflect the current state.
+*/
+void Metrics_Reset(void);
+
+#else
+
+/*! NULL macros when metrics have been excluded from the build */
+#define METRIC_COUNTER(NAME, ID)            extern const metric_registration_t NAME##_metric_registration
+#define METRIC_COUNTER_ARRAY(NAME, ID, SIZE) extern const metric_registration_t NAME##_metric_registration
+#define METRIC_GAUGE(NAME, ID)              extern const metric_registration_t NAME##_metric_registration
+#define METRIC_HISTOGRAM(NAME, ID, ...)     extern const metric_registration_t NAME##_metric_registration
+#define METRIC_DECLARE(NAME)                extern const metric_registration_t NAME##_metric_registration
+#define Metrics_Increment(NAME)             ((void)0)
+#define Metrics_Add(NAME, value)            ((void)(value))
+#define Metrics_IncrementAt(NAME, index)    ((void)(index))
+#define Metrics_AddAt(NAME, index, value)   ((void)(index), (void)(value))
+#define Metrics_Subtract(NAME, value)       ((void)(value))
+#define Metrics_Set(NAME, value)            ((void)(value))
+#define Metrics_Record(NAME, value)         ((void)(value))
+#define Metrics_Find(id)                    ((void)(id), (const metric_registration_t *)NULL)
+#define Metrics_GetNumberOf()               ((uint16)0)
+#define Metrics_GetByIndex(index)           ((void)(index), (const metric_registration_t *)NULL)
+#define Metrics_Reset()                     ((void)0)
+
+#endif /* DISABLE_METRICS */
+
+#endif /* METRICS_H_ */
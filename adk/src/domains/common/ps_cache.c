@@ -0,0 +1,397 @@
+/*!
+\copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+            All Rights Reserved.\n
+            Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+\file
+\brief      Write-back cache in front of the PsRetrieve() and PsStore() traps.
+*/
+
+#include "ps_cache.h"
+
+#ifndef DISABLE_PS_CACHE
+
+#include <message.h>
+#include <panic.h>
+#include <logging.h>
+#include <system_clock.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! Number of keys held in the cache. */
+#ifndef PS_CACHE_ENTRIES
+#define PS_CACHE_ENTRIES            (12)
+#endif
+
+/*! Longest key, in words, that is cached. Longer keys go straight to the
+    traps. */
+#ifndef PS_CACHE_MAX_WORDS
+#define PS_CACHE_MAX_WORDS          (32)
+#endif
+
+/*! Default time a stored key may stay dirty before it is written back. */
+#ifndef PS_CACHE_WRITE_BACK_DELAY_MS
+#define PS_CACHE_WRITE_BACK_DELAY_MS (1000)
+#endif
+
+/*! Internal message to write back the dirty keys. */
+#define PS_CACHE_INTERNAL_WRITE_BACK (0)
+
+/*! \brief A cached key. */
+typedef struct
+{
+    /*! The cached value, NULL if \c words is 0. */
+    uint16 *data;
+
+    /*! The PS key. */
+    uint16 key;
+
+    /*! Length of the value in words, 0 if the key doesn't exist. */
+    uint16 words;
+
+    /*! Value of ps_cache_data_t::use_count when the key was last used. */
+    uint16 last_used;
+
+    /*! TRUE if the entry holds a key. */
+    bool valid:1;
+
+    /*! TRUE if the value hasn't been written back yet. */
+    bool dirty:1;
+} ps_cache_entry_t;
+
+/*! \brief The cache. */
+typedef struct
+{
+    /*! Task for the write-back timer. */
+    TaskData task;
+
+    /*! The cached keys. */
+    ps_cache_entry_t entries[PS_CACHE_ENTRIES];
+
+    /*! Incremented on each access, for least recently used eviction. */
+    uint16 use_count;
+
+    /*! Write-back delay, 0 for write through. */
+    uint32 write_back_delay_ms;
+
+    /*! Counters. */
+    ps_cache_statistics_t statistics;
+} ps_cache_data_t;
+
+static void psCache_HandleMessage(Task task, MessageId id, Message message);
+
+static ps_cache_data_t ps_cache =
+{
+    .task = { .handler = psCache_HandleMessage },
+    .write_back_delay_ms = PS_CACHE_WRITE_BACK_DELAY_MS,
+};
+
+/*! \brief Record the time taken by a trap made by the cache. */
+static void psCache_RecordTrap(rtime_t started)
+{
+    ps_cache.statistics.traps_made++;
+    ps_cache.statistics.trap_time_us += (uint32)rtime_sub(SystemClockGetTimerTime(), started);
+}
+
+static uint16 psCache_TrapRetrieve(uint16 key, void *buff, uint16 words)
+{
+    rtime_t started = SystemClockGetTimerTime();
+    uint16 result = PsRetrieve(key, buff, words);
+
+    psCache_RecordTrap(started);
+    return result;
+}
+
+static uint16 psCache_TrapStore(uint16 key, const void *buff, uint16 words)
+{
+    rtime_t started = SystemClockGetTimerTime();
+    uint16 result = PsStore(key, buff, words);
+
+    psCache_RecordTrap(started);
+    return result;
+}
+
+/*! \brief Write an entry back to the store if it is dirty.
+
+    \return FALSE if the write failed.
+*/
+static bool psCache_WriteBack(ps_cache_entry_t *entry)
+{
+    if (entry->valid && entry->dirty)
+    {
+        uint16 written = psCache_TrapStore(entry->key, entry->data, entry->words);
+
+        if (written != entry->words)
+        {
+            ps_cache.statistics.write_back_failures++;
+            DEBUG_LOG_ERROR("psCache_WriteBack key %u failed, words %u written %u",
+                            entry->key, entry->words, written);
+            return FALSE;
+        }
+        entry->dirty = FALSE;
+    }
+    return TRUE;
+}
+
+static void psCache_Release(ps_cache_entry_t *entry)
+{
+    free(entry->data);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static ps_cache_entry_t *psCache_Find(uint16 key)
+{
+    ps_cache_entry_t *entry;
+
+    for (entry = ps_cache.entries; entry < &ps_cache.entries[PS_CACHE_ENTRIES]; entry++)
+    {
+        if (entry->valid && entry->key == key)
+        {
+            entry->last_used = ++ps_cache.use_count;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/*! \brief Check if \p a should be evicted before \p b.
+    Clean entries go first, so eviction doesn't need a write, then the least
+    recently used. */
+static bool psCache_IsBetterVictim(const ps_cache_entry_t *a, const ps_cache_entry_t *b)
+{
+    if (a->dirty != b->dirty)
+    {
+        return !a->dirty;
+    }
+    return (uint16)(ps_cache.use_count - a->last_used) >
+           (uint16)(ps_cache.use_count - b->last_used);
+}
+
+/*! \brief Get an empty entry for a key, evicting the least recently used
+           clean entry, or dirty entry if every entry is dirty.
+
+    \return The entry, or NULL if every entry is dirty and the victim couldn't
+            be written back. The key must then go straight to the traps, the
+            victim's change would be lost if it was evicted.
+*/
+static ps_cache_entry_t *psCache_Allocate(uint16 key)
+{
+    ps_cache_entry_t *entry;
+    ps_cache_entry_t *victim = ps_cache.entries;
+
+    for (entry = ps_cache.entries; entry < &ps_cache.entries[PS_CACHE_ENTRIES]; entry++)
+    {
+        if (!entry->valid)
+        {
+            victim = entry;
+            break;
+        }
+        if (psCache_IsBetterVictim(entry, victim))
+        {
+            victim = entry;
+        }
+    }
+
+    if (victim->valid)
+    {
+        DEBUG_LOG_VERBOSE("psCache_Allocate evicting key %u for key %u, dirty %u",
+                          victim->key, key, victim->dirty);
+        if (!psCache_WriteBack(victim))
+        {
+            return NULL;
+        }
+        psCache_Release(victim);
+    }
+
+    victim->key = key;
+    victim->valid = TRUE;
+    victim->last_used = ++ps_cache.use_count;
+    return victim;
+}
+
+/*! \brief Replace an entry's value. */
+static void psCache_SetValue(ps_cache_entry_t *entry, const void *buff, uint16 words)
+{
+    free(entry->data);
+    entry->data = NULL;
+    entry->words = words;
+    if (words)
+    {
+        entry->data = PanicUnlessMalloc(words * sizeof(uint16));
+        memcpy(entry->data, buff, words * sizeof(uint16));
+    }
+}
+
+static void psCache_HandleMessage(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    UNUSED(message);
+
+    if (id == PS_CACHE_INTERNAL_WRITE_BACK && !PsCache_Flush())
+    {
+        /* Try the keys that failed again later */
+        MessageSendLater(&ps_cache.task, PS_CACHE_INTERNAL_WRITE_BACK, NULL,
+                         ps_cache.write_back_delay_ms);
+    }
+}
+
+uint16 PsCache_Retrieve(uint16 key, void *buff, uint16 words)
+{
+    ps_cache_entry_t *entry = psCache_Find(key);
+
+    if (entry)
+    {
+        ps_cache.statistics.retrieve_hits++;
+    }
+    else
+    {
+        uint16 length = psCache_TrapRetrieve(key, NULL, 0);
+
+        ps_cache.statistics.retrieve_misses++;
+        if (length > PS_CACHE_MAX_WORDS)
+        {
+            return psCache_TrapRetrieve(key, buff, words);
+        }
+
+        entry = psCache_Allocate(key);
+        if (entry == NULL)
+        {
+            return psCache_TrapRetrieve(key, buff, words);
+        }
+        if (length)
+        {
+            entry->data = PanicUnlessMalloc(length * sizeof(uint16));
+            entry->words = psCache_TrapRetrieve(key, entry->data, length);
+            if (entry->words == 0)
+            {
+                free(entry->data);
+                entry->data = NULL;
+            }
+        }
+    }
+
+    if (buff == NULL && words == 0)
+    {
+        return entry->words;
+    }
+    if (entry->words == 0 || entry->words > words)
+    {
+        return 0;
+    }
+    memcpy(buff, entry->data, entry->words * sizeof(uint16));
+    return entry->words;
+}
+
+uint16 PsCache_Store(uint16 key, const void *buff, uint16 words)
+{
+    ps_cache_entry_t *entry = psCache_Find(key);
+
+    if (words > PS_CACHE_MAX_WORDS || ps_cache.write_back_delay_ms == 0)
+    {
+        if (entry)
+        {
+            psCache_Release(entry);
+        }
+        return psCache_TrapStore(key, buff, words);
+    }
+
+    if (entry == NULL)
+    {
+        entry = psCache_Allocate(key);
+        if (entry == NULL)
+        {
+            /* Write through, there is no room to hold the key dirty */
+            return psCache_TrapStore(key, buff, words);
+        }
+    }
+    else if (entry->dirty)
+    {
+        ps_cache.statistics.stores_coalesced++;
+    }
+
+    psCache_SetValue(entry, buff, words);
+    entry->dirty = TRUE;
+
+    /* The first store starts the delay, later ones join the same write-back
+       so a key that keeps changing is still written regularly. */
+    if (!MessagePendingFirst(&ps_cache.task, PS_CACHE_INTERNAL_WRITE_BACK, NULL))
+    {
+        MessageSendLater(&ps_cache.task, PS_CACHE_INTERNAL_WRITE_BACK, NULL,
+                         ps_cache.write_back_delay_ms);
+    }
+
+    return words;
+}
+
+uint16 PsCache_StoreNow(uint16 key, const void *buff, uint16 words)
+{
+    ps_cache_entry_t *entry = psCache_Find(key);
+    uint16 written = psCache_TrapStore(key, buff, words);
+
+    if (entry)
+    {
+        if (written == words && words <= PS_CACHE_MAX_WORDS)
+        {
+            psCache_SetValue(entry, buff, words);
+            entry->dirty = FALSE;
+        }
+        else
+        {
+            /* What the store holds isn't known, read it again next time */
+            psCache_Release(entry);
+        }
+    }
+
+    return written;
+}
+
+bool PsCache_Flush(void)
+{
+    ps_cache_entry_t *entry;
+    bool written = TRUE;
+
+    MessageCancelAll(&ps_cache.task, PS_CACHE_INTERNAL_WRITE_BACK);
+
+    for (entry = ps_cache.entries; entry < &ps_cache.entries[PS_CACHE_ENTRIES]; entry++)
+    {
+        if (!psCache_WriteBack(entry))
+        {
+            written = FALSE;
+        }
+    }
+
+    DEBUG_LOG_VERBOSE("PsCache_Flush hits %u misses %u coalesced %u traps %u in %uus failures %u",
+                      ps_cache.statistics.retrieve_hits,
+                      ps_cache.statistics.retrieve_misses,
+                      ps_cache.statistics.stores_coalesced,
+                      ps_cache.statistics.traps_made,
+                      ps_cache.statistics.trap_time_us,
+                      ps_cache.statistics.write_back_failures);
+
+    return written;
+}
+
+void PsCache_Invalidate(uint16 key)
+{
+    ps_cache_entry_t *entry = psCache_Find(key);
+
+    if (entry)
+    {
+        psCache_Release(entry);
+    }
+}
+
+void PsCache_SetWriteBackDelay(uint32 delay_ms)
+{
+    ps_cache.write_back_delay_ms = delay_ms;
+    if (delay_ms == 0)
+    {
+        PsCache_Flush();
+    }
+}
+
+const ps_cache_statistics_t *PsCache_GetStatistics(void)
+{
+    return &ps_cache.statistics;
+}
+
+#endif /* DISABLE_PS_CACHE */
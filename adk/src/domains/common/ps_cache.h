@@ -0,0 +1,153 @@
+/*!
+\copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+            All Rights Reserved.\n
+            Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+\file       ps_cache.h
+\defgroup   ps_cache PS Cache
+\ingroup    common_domain
+\brief      Write-back cache in front of the PsRetrieve() and PsStore() traps.
+
+            Every PS trap is a round trip to P0, which reads or writes the
+            flash-backed store. Many keys are read several times during boot
+            and on each connection, and some are rewritten on every change of
+            a setting.
+
+            PsCache_Retrieve() keeps small keys in RAM after the first read,
+            including the fact that a key doesn't exist. PsCache_Store() updates
+            the cached copy and writes it back once the write-back delay has
+            passed, so a burst of changes to a key costs one PsStore(). Dirty
+            keys are also written back by PsCache_Flush(), which is called
+            before a reboot, power off or dormant.
+
+            A dirty key is lost if the device panics or loses power before it
+            is written back, and a write-back that fails is only reported by
+            the log and the statistics. Keys that must be in the store when
+            the call returns, or whose callers act on the result, must be
+            written with PsCache_StoreNow() instead.
+
+            A key must only be accessed through the cache once any client uses
+            the cache for it. Code that changes a key with the traps directly,
+            for example a test command, must call PsCache_Invalidate() after.
+
+            The cache can be removed by defining DISABLE_PS_CACHE, the API then
+            maps directly onto the traps.
+*/
+#ifndef PS_CACHE_H_
+#define PS_CACHE_H_
+
+#include <ps.h>
+
+/*! @{ */
+
+/*! \brief Counters for the traps the cache has made and avoided. */
+typedef struct
+{
+    /*! Retrieves served from RAM. */
+    uint32 retrieve_hits;
+
+    /*! Retrieves that had to read the key from the store. */
+    uint32 retrieve_misses;
+
+    /*! Stores that replaced a value still waiting to be written back. */
+    uint32 stores_coalesced;
+
+    /*! PsRetrieve() and PsStore() traps made by the cache. */
+    uint32 traps_made;
+
+    /*! Total time spent in those traps, in microseconds. */
+    uint32 trap_time_us;
+
+    /*! Deferred write-backs that failed. The key stays dirty and is retried
+        by the next flush. */
+    uint32 write_back_failures;
+} ps_cache_statistics_t;
+
+#ifndef DISABLE_PS_CACHE
+
+/*! \brief Read a PS key, from the cache if possible.
+
+    Has the same behaviour as PsRetrieve().
+
+    \param key    The PS key.
+    \param buff   The buffer to copy the key into, NULL to query its length.
+    \param words  The size of \p buff in words, 0 to query the key's length.
+
+    \return The key's length in words if \p buff is NULL and \p words is 0.
+            Otherwise the number of words copied, or 0 if the key doesn't
+            exist or is longer than \p words.
+*/
+uint16 PsCache_Retrieve(uint16 key, void *buff, uint16 words);
+
+/*! \brief Write a PS key through the cache.
+
+    The key is written back to the store after the write-back delay, or by
+    PsCache_Flush(). Keys too big to be cached are written immediately, as
+    are keys that would need a dirty key evicted when that key can't be
+    written back.
+
+    \param key    The PS key.
+    \param buff   The value to store.
+    \param words  The length of \p buff in words, 0 to delete the key.
+
+    \return The number of words accepted. This doesn't mean the key has been
+            written, a write-back that fails later is counted in
+            ps_cache_statistics_t::write_back_failures and retried by the next
+            flush.
+*/
+uint16 PsCache_Store(uint16 key, const void *buff, uint16 words);
+
+/*! \brief Write a PS key to the store now, and update the cached copy.
+
+    \param key    The PS key.
+    \param buff   The value to store.
+    \param words  The length of \p buff in words, 0 to delete the key.
+
+    \return The number of words written, as for PsStore().
+*/
+uint16 PsCache_StoreNow(uint16 key, const void *buff, uint16 words);
+
+/*! \brief Write every dirty key back to the store now.
+
+    \return TRUE if every dirty key was written, FALSE if any write failed.
+*/
+bool PsCache_Flush(void);
+
+/*! \brief Forget the cached copy of a key.
+
+    Any change that hasn't been written back is discarded, the caller is
+    expected to have just written the key with PsStore().
+
+    \param key  The PS key.
+*/
+void PsCache_Invalidate(uint16 key);
+
+/*! \brief Set how long a stored key may stay dirty before it is written back.
+
+    \param delay_ms  The write-back delay, 0 to write through.
+*/
+void PsCache_SetWriteBackDelay(uint32 delay_ms);
+
+/*! \brief Get the cache's counters.
+
+    The time a cached trap would have taken can be estimated from
+    trap_time_us / traps_made.
+
+    \return The counters since boot.
+*/
+const ps_cache_statistics_t *PsCache_GetStatistics(void);
+
+#else /* DISABLE_PS_CACHE */
+
+#define PsCache_Retrieve(key, buff, words) PsRetrieve((key), (buff), (words))
+#define PsCache_Store(key, buff, words) PsStore((key), (buff), (words))
+#define PsCache_StoreNow(key, buff, words) PsStore((key), (buff), (words))
+#define PsCache_Flush() (TRUE)
+#define PsCache_Invalidate(key) ((void)(key))
+#define PsCache_SetWriteBackDelay(delay_ms) ((void)(delay_ms))
+#define PsCache_GetStatistics() ((const ps_cache_statistics_t *)NULL)
+
+#endif /* DISABLE_PS_CACHE */
+
+/*! @} */
+
+#endif /* PS_CACHE_H_ */
@@ -24,6 +24,14 @@ static bool dfuPeer_HandoverVeto(void)
     return FALSE;
 }
 
+static uint16 dfuPeer_HandoverEstimateSize(const tp_bdaddr *tp_bd_addr)
+{
+    UNUSED(tp_bd_addr);
+
+    /* Nothing is marshalled */
+    return 0;
+}
+
 static bool dfuPeer_HandoverMarshal(const tp_bdaddr *tp_bd_addr,
                                     uint8 *buf,
                                     uint16 length,
@@ -102,11 +110,14 @@ static void dfuPeer_HandoverAbort(void)
 }
 
 const handover_interface dfu_peer_handover_if =
-        MAKE_HANDOVER_IF(&dfuPeer_HandoverVeto,
-                         &dfuPeer_HandoverMarshal,
-                         &dfuPeer_HandoverUnmarshal,
-                         &dfuPeer_HandoverCommit,
-                         &dfuPeer_HandoverComplete,
-                         &dfuPeer_HandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(HANDOVER_SUPPORT_ALL,
+                                  &dfuPeer_HandoverVeto,
+                                  NULL,
+                                  &dfuPeer_HandoverEstimateSize,
+                                  &dfuPeer_HandoverMarshal,
+                                  &dfuPeer_HandoverUnmarshal,
+                                  &dfuPeer_HandoverCommit,
+                                  &dfuPeer_HandoverComplete,
+                                  &dfuPeer_HandoverAbort);
 
 #endif /* INCLUDE_DFU_PEER */
@@ -80,6 +80,18 @@ static void gaiaCorePlugin_DataTransferGet(GAIA_TRANSPORT *t, uint16 payload_len
 */
 static void gaiaCorePlugin_DataTransferSet(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
 
+/*! \brief Function that handles 'Data Transfer Stream Start' command.
+*/
+static void gaiaCorePlugin_DataTransferStreamStart(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
+
+/*! \brief Function that handles 'Data Transfer Stream Credit' command.
+*/
+static void gaiaCorePlugin_DataTransferStreamCredit(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
+
+/*! \brief Function that handles 'Data Transfer Stream Stop' command.
+*/
+static void gaiaCorePlugin_DataTransferStreamStop(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
+
 /*! \brief Copies the data bytes of the Application Feature List from the offset specified.
 
     \param[IN/OUT] buf      The buffer that the data bytes will be copied to.
@@ -169,7 +181,7 @@ void GaiaCorePlugin_Init(void)
         .command_handler = gaiaCorePlugin_MainHandler,
         .send_all_notifications = gaiaCorePlugin_SendAllNotifications,
         .transport_connect = NULL,
-        .transport_disconnect = NULL,
+        .transport_disconnect = GaiaFramework_StopDataTransferStreams,
     };
 
     DEBUG_LOG("GaiaCorePlugin_Init");
@@ -264,6 +276,18 @@ static gaia_framework_command_status_t gaiaCorePlugin_MainHandler(GAIA_TRANSPORT
             gaiaCorePlugin_GetSystemInformation(t, payload_length, payload);
             break;
 
+        case data_transfer_stream_start:
+            gaiaCorePlugin_DataTransferStreamStart(t, payload_length, payload);
+            break;
+
+        case data_transfer_stream_credit:
+            gaiaCorePlugin_DataTransferStreamCredit(t, payload_length, payload);
+            break;
+
+        case data_transfer_stream_stop:
+            gaiaCorePlugin_DataTransferStreamStop(t, payload_length, payload);
+            break;
+
         default:
             DEBUG_LOG("gaiaCorePlugin_MainHandler, unhandled call for %u", pdu_id);
             return command_not_handled;
@@ -477,6 +501,48 @@ static void gaiaCorePlugin_DataTransferSet(GAIA_TRANSPORT *t, uint16 payload_len
     }
 }
 
+static void gaiaCorePlugin_DataTransferStreamStart(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload)
+{
+    DEBUG_LOG("gaiaCorePlugin_DataTransferStreamStart");
+    if (payload_length == GAIA_DATA_TRANSFER_STREAM_START_CMD_PAYLOAD_SIZE)
+    {
+        GaiaFramework_DataTransferStreamStart(t, payload_length, payload);
+    }
+    else
+    {
+        DEBUG_LOG("gaiaCorePlugin_DataTransferStreamStart, Invalid payload length: %d", payload_length);
+        GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_start, GAIA_STATUS_INVALID_PARAMETER);
+    }
+}
+
+static void gaiaCorePlugin_DataTransferStreamCredit(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload)
+{
+    DEBUG_LOG_VERBOSE("gaiaCorePlugin_DataTransferStreamCredit");
+    if (payload_length == GAIA_DATA_TRANSFER_STREAM_CREDIT_CMD_PAYLOAD_SIZE)
+    {
+        GaiaFramework_DataTransferStreamCredit(t, payload_length, payload);
+    }
+    else
+    {
+        DEBUG_LOG("gaiaCorePlugin_DataTransferStreamCredit, Invalid payload length: %d", payload_length);
+        GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_credit, GAIA_STATUS_INVALID_PARAMETER);
+    }
+}
+
+static void gaiaCorePlugin_DataTransferStreamStop(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload)
+{
+    DEBUG_LOG("gaiaCorePlugin_DataTransferStreamStop");
+    if (payload_length == GAIA_DATA_TRANSFER_STREAM_STOP_CMD_PAYLOAD_SIZE)
+    {
+        GaiaFramework_DataTransferStreamStop(t, payload_length, payload);
+    }
+    else
+    {
+        DEBUG_LOG("gaiaCorePlugin_DataTransferStreamStop, Invalid payload length: %d", payload_length);
+        GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_stop, GAIA_STATUS_INVALID_PARAMETER);
+    }
+}
+
 static uint16 gaiaCorePlugin_GetFormattedDataBytesFromStringList(uint8 *buf, const uint16 buf_size, gaia_user_defined_feature_data_t *list, const uint16 offset, uint16 *buf_used)
 {
 /*
@@ -18,7 +18,7 @@
 
 /*! \brief Gaia core plugin version
 */
-#define GAIA_CORE_PLUGIN_VERSION (5)
+#define GAIA_CORE_PLUGIN_VERSION (6)
 
 
 /*! \brief These are the built-in commands provided by the GAIA framework
@@ -61,6 +61,12 @@ typedef enum
     get_device_bluetooth_address = 16,
     /*! Get various System Information parameters */
     get_system_information = 17,
+    /*! The device pushes data bytes as notifications, within a window of credits granted by the mobile app. */
+    data_transfer_stream_start = 18,
+    /*! The mobile app grants more credits to a data transfer stream. */
+    data_transfer_stream_credit = 19,
+    /*! The mobile app stops a data transfer stream. */
+    data_transfer_stream_stop = 20,
     /*! Total number of commands */
     number_of_core_commands,
 } core_plugin_pdu_ids_t;
@@ -71,6 +77,8 @@ typedef enum
 {
     /*! The device can generate a Notification when the charger is plugged in or unplugged */
     charger_status_notification = 0,
+    /*! The device sends data bytes of a data transfer stream */
+    data_transfer_stream_data_notification = 1,
     /*! Total number of notifications */
     number_of_core_notifications,
 } core_plugin_notifications_t;
@@ -110,11 +110,20 @@ uint8* GaiaFramework_CreatePacket(GAIA_TRANSPORT *t, const gaia_features_t featu
     return Gaia_TransportCreatePacket(t, GAIA_V3_VENDOR_ID, command_id, size_payload);
 }
 
-void GaiaFramework_FlushPacket(GAIA_TRANSPORT *t, const uint16 size_payload, uint8 *payload)
+uint8* GaiaFramework_CreateNotificationPacket(GAIA_TRANSPORT *t, const gaia_features_t feature_id, const uint8 notification_id, const uint16 size_payload)
+{
+    DEBUG_LOG_DEBUG("GaiaFramework_CreateNotificationPacket, feature_id %u, notification_id %u, size_payload %u", feature_id, notification_id, size_payload);
+
+    uint16 command_id = gaiaFramework_BuildCommandId(feature_id, pdu_type_notification, notification_id);
+
+    return Gaia_TransportCreatePacket(t, GAIA_V3_VENDOR_ID, command_id, size_payload);
+}
+
+bool GaiaFramework_FlushPacket(GAIA_TRANSPORT *t, const uint16 size_payload, uint8 *payload)
 {
     DEBUG_LOG_DEBUG("GaiaFramework_FlushPacket, size_payload %u", size_payload);
 
-    Gaia_TransportFlushPacket(t, size_payload, payload);
+    return Gaia_TransportFlushPacket(t, size_payload, payload);
 }
 
 
@@ -186,13 +186,26 @@ uint16 GaiaFramework_GetPacketSpace(GAIA_TRANSPORT *t);
  */
 uint8* GaiaFramework_CreatePacket(GAIA_TRANSPORT *t, const gaia_features_t feature_id, const uint8 pdu_id, const uint16 size_payload);
 
+/*! \brief Create a notification packet with the specified payload size in the stream buffer
+
+    \param t                Transport to send notification on
+    \param feature_id       Feature ID for the plugin
+    \param notification_id  Notification ID for the message
+    \param size_payload     Length of the payload
+
+    \return A pointer to the start of the payload in the stream buffer.
+ */
+uint8* GaiaFramework_CreateNotificationPacket(GAIA_TRANSPORT *t, const gaia_features_t feature_id, const uint8 notification_id, const uint16 size_payload);
+
 /*! \brief Flush a packet in the stream buffer
 
     \param t            Transport to send response on
     \param size_payload Length of the payload
     \param payload      Payload data
+
+    \return TRUE if the packet was sent, FALSE if it was dropped.
  */
-void GaiaFramework_FlushPacket(GAIA_TRANSPORT *t, const uint16 size_payload, uint8 *payload);
+bool GaiaFramework_FlushPacket(GAIA_TRANSPORT *t, const uint16 size_payload, uint8 *payload);
 
 
 /*! \brief Creates a notification to be sent to the mobile application
@@ -10,8 +10,11 @@
 #include "gaia_core_plugin.h"
 #include "gaia_framework_data_channel.h"
 
+#include "metrics.h"
 #include <panic.h>
 #include <stdlib.h>
+#include <system_clock.h>
+#include <rtime.h>
 
 /* Enable debug log outputs with per-module debug log levels.
  * The log output level for this module can be changed with the PyDbg command:
@@ -30,6 +33,23 @@ DEBUG_LOG_DEFINE_LEVEL_VAR
 #define GAIA_FRAMEWORK_DATA_CH_PANIC()
 #endif
 
+/*! \brief Maximum notifications sent in one go, so other tasks get to run in between. */
+#define GAIA_DATA_TRANSFER_STREAM_MAX_BURST         (8)
+
+/*! \brief End offset of a stream that runs until the Feature has no more data. */
+#define GAIA_DATA_TRANSFER_STREAM_OPEN_END          (0xFFFFFFFFUL)
+
+METRIC_COUNTER(gaia_data_stream_bytes, METRIC_ID_GAIA_DATA_STREAM_BYTES);
+METRIC_COUNTER(gaia_data_streams_started, METRIC_ID_GAIA_DATA_STREAMS_STARTED);
+METRIC_GAUGE(gaia_data_streams_active, METRIC_ID_GAIA_DATA_STREAMS_ACTIVE);
+
+/*! \brief Internal messages of the data channel. */
+typedef enum
+{
+    /*! Send the next chunks of the active data transfer streams. */
+    GAIA_FW_DATA_CH_INTERNAL_STREAM_PUMP,
+} gaia_fw_data_ch_internal_message_t;
+
 
 /*! \brief Types of transport
 */
@@ -77,6 +97,19 @@ typedef struct __session_instance_t
     /*! Transform of a stream if in use, otherwise this is NULL. */
     Transform                       data_channel_transform;
 
+    /*! TRUE while data bytes are streamed on 'transport'. */
+    bool                            streaming;
+    /*! Number of notifications the mobile app is ready to receive. */
+    uint16                          stream_credits;
+    /*! Offset of the next data byte to stream. */
+    uint32                          stream_offset;
+    /*! Offset at which the stream ends. */
+    uint32                          stream_end;
+    /*! Data bytes streamed since the stream was (re)started. */
+    uint32                          stream_bytes;
+    /*! When the stream was (re)started. */
+    rtime_t                         stream_start_time;
+
     struct __session_instance_t *next;
 } session_instance_t;
 
@@ -150,9 +183,17 @@ static void gaiaFrameworkDataChannel_SendDataTransferSetupResponse(gaia_data_tra
 
 
 
+/*! \brief Send the next chunks of the data transfer streams.
+*/
+static void gaiaFrameworkDataChannel_HandleMessage(Task task, MessageId id, Message message);
+
+
 /*! \brief The root of the Session Instance linked list. */
 static session_instance_t *session_instance_linked_list = NULL;
 
+/*! \brief Task that sends the data transfer streams. */
+static TaskData gaia_framework_data_channel_task = { .handler = gaiaFrameworkDataChannel_HandleMessage };
+
 
 
 static uint8 gaiaFrameworkDataChannel_GetGaiaStatusFromDataTransferStatus(data_transfer_status_code_t status_code)
@@ -241,6 +282,12 @@ static bool gaiaFrameworkDataChannel_AddSessionInstance(GAIA_TRANSPORT *t, gaia_
         sr->feature_id = feature_id;
         sr->functions = (gaia_framework_data_channel_functions_t*) functions;
         sr->transport = t;
+        sr->streaming = FALSE;
+        sr->stream_credits = 0;
+        sr->stream_offset = 0;
+        sr->stream_end = 0;
+        sr->stream_bytes = 0;
+        sr->stream_start_time = 0;
         sr->next = NULL;
 
         if (session_instance_linked_list == NULL)
@@ -273,6 +320,10 @@ static bool gaiaFrameworkDataChannel_DeleteSessionInstance(gaia_data_transfer_se
             {
                 prev->next = instance->next;
             }
+            if (instance->streaming)
+            {
+                Metrics_Subtract(gaia_data_streams_active, 1);
+            }
             free(instance);
             return TRUE;
         }
@@ -428,6 +479,13 @@ bool GaiaFramework_DataTransferGet(GAIA_TRANSPORT *t, uint16 payload_length, con
         else
             payload_size = MIN(payload_size, ((uint16)value));
 
+        if (payload_size <= GAIA_DATA_TRANSFER_GET_RSP_HEADER_SIZE)
+        {
+            DEBUG_LOG_WARN("GaiaFramework_DataTransferGet, no space in the transport");
+            GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_get, GAIA_STATUS_INSUFFICIENT_RESOURCES);
+            return FALSE;
+        }
+
         tx_buf = GaiaFramework_CreatePacket(t, GAIA_CORE_FEATURE_ID, data_transfer_get, payload_size);
         PanicNull(tx_buf);
 
@@ -498,11 +556,268 @@ bool GaiaFramework_DataTransferSet(GAIA_TRANSPORT *t, uint16 payload_length, con
 }
 
 
+static void gaiaFrameworkDataChannel_SendSessionResponse(GAIA_TRANSPORT *t, gaia_data_transfer_session_id_t session_id, uint8 pdu_id)
+{
+    uint8 rsp_payload[GAIA_DATA_TRANSFER_STREAM_RSP_PAYLOAD_SIZE];
+
+    rsp_payload[0] = (uint8) ((session_id & 0xFF00) >> 8);
+    rsp_payload[1] = (uint8)  (session_id & 0x00FF);
+    GaiaFramework_SendResponse(t, GAIA_CORE_FEATURE_ID, pdu_id, sizeof(rsp_payload), rsp_payload);
+}
+
+
+static void gaiaFrameworkDataChannel_StopStream(session_instance_t *instance, data_transfer_status_code_t status)
+{
+    uint32 elapsed_ms = rtime_sub(SystemClockGetTimerTime(), instance->stream_start_time) / US_PER_MS;
+    uint32 bytes_per_s = 0;
+
+    if (elapsed_ms)
+        bytes_per_s = (instance->stream_bytes / elapsed_ms) * MS_PER_SEC + ((instance->stream_bytes % elapsed_ms) * MS_PER_SEC) / elapsed_ms;
+
+    /* The throughput of each transport is logged so that it can be compared. */
+    DEBUG_LOG_INFO("GaiaFW DataTransfer: Stream stopped, SessionID: 0x%04X, status %u, transport type %u, offset %u",
+                   instance->session_id, status, GaiaTransportGetType(instance->transport), instance->stream_offset);
+    DEBUG_LOG_INFO("GaiaFW DataTransfer: Stream sent %u bytes in %u ms, %u bytes/s",
+                   instance->stream_bytes, elapsed_ms, bytes_per_s);
+    instance->streaming = FALSE;
+    instance->stream_credits = 0;
+    Metrics_Subtract(gaia_data_streams_active, 1);
+}
+
+
+/*! \brief Send the next chunk of a stream as a notification, with as many
+           data bytes as the transport has space for.
+
+    \return TRUE if a notification was sent, FALSE if the transport is out of space.
+*/
+static bool gaiaFrameworkDataChannel_StreamChunk(session_instance_t *instance)
+{
+    GAIA_TRANSPORT *t = instance->transport;
+    const uint16 header_size = GAIA_DATA_TRANSFER_STREAM_DATA_NTF_HEADER_SIZE;
+    const uint16 space = Gaia_TransportIsConnected(t) ? GaiaFramework_GetPacketSpace(t) : 0;
+    data_transfer_status_code_t status = data_transfer_no_more_data;
+    uint16 data_size;
+    uint16 size_used = 0;
+    uint8 *tx_buf;
+
+    if (space <= header_size)
+        return FALSE;
+
+    data_size = (uint16) MIN((uint32)(space - header_size), instance->stream_end - instance->stream_offset);
+    tx_buf = GaiaFramework_CreateNotificationPacket(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_data_notification, header_size + data_size);
+    if (tx_buf == NULL)
+        return FALSE;
+
+    /* The data bytes are read straight into the transport's buffer. */
+    if (data_size)
+        status = instance->functions->get_transfer_data(instance->stream_offset, data_size, data_size, &tx_buf[header_size], &size_used);
+    if (status == data_transfer_status_success && size_used == 0)
+        status = data_transfer_no_more_data;
+    if (status != data_transfer_status_success)
+        size_used = 0;
+
+    tx_buf[0] = (uint8) ((instance->session_id & 0xFF00) >> 8);
+    tx_buf[1] = (uint8)  (instance->session_id & 0x00FF);
+    tx_buf[2] = (uint8) status;
+    tx_buf[3] = (uint8) ((instance->stream_offset & 0xFF000000UL) >> 24);
+    tx_buf[4] = (uint8) ((instance->stream_offset & 0x00FF0000UL) >> 16);
+    tx_buf[5] = (uint8) ((instance->stream_offset & 0x0000FF00UL) >>  8);
+    tx_buf[6] = (uint8)  (instance->stream_offset & 0x000000FFUL);
+
+    /* Nothing is consumed if the packet is dropped, the chunk is read again once there is space. */
+    if (!GaiaFramework_FlushPacket(t, header_size + size_used, tx_buf))
+        return FALSE;
+
+    if (status == data_transfer_status_success)
+    {
+        instance->stream_offset += size_used;
+        instance->stream_bytes += size_used;
+        Metrics_Add(gaia_data_stream_bytes, size_used);
+        instance->stream_credits -= 1;
+    }
+    else
+        gaiaFrameworkDataChannel_StopStream(instance, status);
+
+    return TRUE;
+}
+
+
+static void gaiaFrameworkDataChannel_PumpStreams(void)
+{
+    session_instance_t *instance;
+    bool more_to_send = FALSE;
+
+    MessageCancelAll(&gaia_framework_data_channel_task, GAIA_FW_DATA_CH_INTERNAL_STREAM_PUMP);
+
+    for (instance = session_instance_linked_list; instance != NULL; instance = instance->next)
+    {
+        uint16 burst = 0;
+
+        /* The end of a stream is signalled without using a credit. */
+        while (instance->streaming && burst < GAIA_DATA_TRANSFER_STREAM_MAX_BURST &&
+               (instance->stream_credits || instance->stream_offset == instance->stream_end))
+        {
+            if (!gaiaFrameworkDataChannel_StreamChunk(instance))
+            {
+                /* Carry on when the transport has space, see GaiaFramework_ResumeDataTransferStreams() */
+                Gaia_TransportRequestMoreSpaceInd(instance->transport);
+                break;
+            }
+            burst++;
+        }
+
+        if (instance->streaming && burst == GAIA_DATA_TRANSFER_STREAM_MAX_BURST)
+            more_to_send = TRUE;
+    }
+
+    if (more_to_send)
+        MessageSend(&gaia_framework_data_channel_task, GAIA_FW_DATA_CH_INTERNAL_STREAM_PUMP, NULL);
+}
+
+
+static void gaiaFrameworkDataChannel_HandleMessage(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    UNUSED(message);
+
+    switch (id)
+    {
+        case GAIA_FW_DATA_CH_INTERNAL_STREAM_PUMP:
+            gaiaFrameworkDataChannel_PumpStreams();
+            break;
+
+        default:
+            DEBUG_LOG_WARN("gaiaFrameworkDataChannel_HandleMessage, unhandled message 0x%04X", id);
+            break;
+    }
+}
+
+
+bool GaiaFramework_DataTransferStreamStart(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload)
+{
+    UNUSED(payload_length);
+    gaia_data_transfer_session_id_t session_id = (uint16)payload[0] << 8 | payload[1];
+    session_instance_t *instance = gaiaFrameworkDataChannel_FindSessionInstance(session_id);
+
+    DEBUG_LOG_DEBUG("GaiaFramework_DataTransferStreamStart");
+
+    if (instance == NULL || instance->functions->get_transfer_data == NULL)
+    {
+        GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_start, GAIA_STATUS_INVALID_PARAMETER);
+        return FALSE;
+    }
+    else
+    {
+        uint32 start_offset = (uint32)payload[2] << 24 | (uint32)payload[3] << 16 | (uint32)payload[4] << 8 | (uint32)payload[5];
+        uint32 size         = (uint32)payload[6] << 24 | (uint32)payload[7] << 16 | (uint32)payload[8] << 8 | (uint32)payload[9];
+        uint16 credits      = (uint16)payload[10] << 8 | payload[11];
+
+        if (instance->streaming)
+            gaiaFrameworkDataChannel_StopStream(instance, data_transfer_status_success);
+
+        /* Restarting from an offset resumes a stream, possibly on a new transport. */
+        instance->transport = t;
+        instance->streaming = TRUE;
+        instance->stream_credits = credits;
+        instance->stream_offset = start_offset;
+        instance->stream_end = (size && size <= GAIA_DATA_TRANSFER_STREAM_OPEN_END - start_offset) ? (start_offset + size)
+                                                                                                    : GAIA_DATA_TRANSFER_STREAM_OPEN_END;
+        instance->stream_bytes = 0;
+        instance->stream_start_time = SystemClockGetTimerTime();
+        Metrics_Increment(gaia_data_streams_started);
+        Metrics_Add(gaia_data_streams_active, 1);
+
+        DEBUG_LOG_INFO("GaiaFW DataTransfer: Stream started, SessionID: 0x%04X, offset %u, size %u, credits %u",
+                       session_id, start_offset, size, credits);
+        gaiaFrameworkDataChannel_SendSessionResponse(t, session_id, data_transfer_stream_start);
+        gaiaFrameworkDataChannel_PumpStreams();
+    }
+    return TRUE;
+}
+
+
+bool GaiaFramework_DataTransferStreamCredit(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload)
+{
+    UNUSED(payload_length);
+    gaia_data_transfer_session_id_t session_id = (uint16)payload[0] << 8 | payload[1];
+    session_instance_t *instance = gaiaFrameworkDataChannel_FindSessionInstance(session_id);
+
+    if (instance == NULL || !instance->streaming || instance->transport != t)
+    {
+        GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_credit, GAIA_STATUS_INCORRECT_STATE);
+        return FALSE;
+    }
+    else
+    {
+        uint16 credits = (uint16)payload[2] << 8 | payload[3];
+
+        instance->stream_credits = (uint16) MIN((uint32)instance->stream_credits + credits, 0xFFFF);
+        DEBUG_LOG_VERBOSE("GaiaFramework_DataTransferStreamCredit, SessionID: 0x%04X, credits %u", session_id, instance->stream_credits);
+
+        gaiaFrameworkDataChannel_SendSessionResponse(t, session_id, data_transfer_stream_credit);
+        gaiaFrameworkDataChannel_PumpStreams();
+    }
+    return TRUE;
+}
+
+
+bool GaiaFramework_DataTransferStreamStop(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload)
+{
+    UNUSED(payload_length);
+    gaia_data_transfer_session_id_t session_id = (uint16)payload[0] << 8 | payload[1];
+    session_instance_t *instance = gaiaFrameworkDataChannel_FindSessionInstance(session_id);
+
+    DEBUG_LOG_DEBUG("GaiaFramework_DataTransferStreamStop");
+
+    if (instance == NULL)
+    {
+        GaiaFramework_SendError(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_stop, GAIA_STATUS_INVALID_PARAMETER);
+        return FALSE;
+    }
+    else
+    {
+        uint8 rsp_payload[GAIA_DATA_TRANSFER_STREAM_STOP_RSP_PAYLOAD_SIZE];
+
+        if (instance->streaming)
+            gaiaFrameworkDataChannel_StopStream(instance, data_transfer_status_success);
+
+        rsp_payload[0] = (uint8) ((session_id & 0xFF00) >> 8);
+        rsp_payload[1] = (uint8)  (session_id & 0x00FF);
+        rsp_payload[2] = (uint8) ((instance->stream_offset & 0xFF000000UL) >> 24);
+        rsp_payload[3] = (uint8) ((instance->stream_offset & 0x00FF0000UL) >> 16);
+        rsp_payload[4] = (uint8) ((instance->stream_offset & 0x0000FF00UL) >>  8);
+        rsp_payload[5] = (uint8)  (instance->stream_offset & 0x000000FFUL);
+        GaiaFramework_SendResponse(t, GAIA_CORE_FEATURE_ID, data_transfer_stream_stop, sizeof(rsp_payload), rsp_payload);
+    }
+    return TRUE;
+}
+
+
+void GaiaFramework_StopDataTransferStreams(GAIA_TRANSPORT *t)
+{
+    session_instance_t *instance;
+
+    for (instance = session_instance_linked_list; instance != NULL; instance = instance->next)
+    {
+        if (instance->streaming && instance->transport == t)
+            gaiaFrameworkDataChannel_StopStream(instance, data_transfer_status_invalid_stream);
+    }
+}
+
+
+void GaiaFramework_ResumeDataTransferStreams(GAIA_TRANSPORT *t)
+{
+    DEBUG_LOG_VERBOSE("GaiaFramework_ResumeDataTransferStreams, transport %p", t);
+    gaiaFrameworkDataChannel_PumpStreams();
+}
+
+
 void GaiaFramework_ShutDownDataChannels(void)
 {
     session_instance_t *instance;
     bool result;
-    
+
+    MessageCancelAll(&gaia_framework_data_channel_task, GAIA_FW_DATA_CH_INTERNAL_STREAM_PUMP);
     while (TRUE)
     {
         instance = gaiaFrameworkDataChannel_GetFirstSessionInstance();
@@ -40,6 +40,25 @@
 /*! \brief The payload size of 'Data Transfer Set' response. */
 #define GAIA_DATA_TRANSFER_SET_RSP_PAYLOAD_SIZE                      (2)
 
+/*! \brief The payload size of Gaia 'Data Transfer Stream Start' command. */
+#define GAIA_DATA_TRANSFER_STREAM_START_CMD_PAYLOAD_SIZE            (12)
+
+/*! \brief The payload size of Gaia 'Data Transfer Stream Credit' command. */
+#define GAIA_DATA_TRANSFER_STREAM_CREDIT_CMD_PAYLOAD_SIZE           (4)
+
+/*! \brief The payload size of Gaia 'Data Transfer Stream Stop' command. */
+#define GAIA_DATA_TRANSFER_STREAM_STOP_CMD_PAYLOAD_SIZE             (2)
+
+/*! \brief The payload size of 'Data Transfer Stream Start/Credit' responses. */
+#define GAIA_DATA_TRANSFER_STREAM_RSP_PAYLOAD_SIZE                  (2)
+
+/*! \brief The payload size of 'Data Transfer Stream Stop' response. */
+#define GAIA_DATA_TRANSFER_STREAM_STOP_RSP_PAYLOAD_SIZE             (6)
+
+/*! \brief The header size of 'Data Transfer Stream Data' notification payload
+           (Session ID: 2 bytes, Status: 1 byte, Offset: 4 bytes). */
+#define GAIA_DATA_TRANSFER_STREAM_DATA_NTF_HEADER_SIZE              (7)
+
 /*! \brief The max data size that a single 'DataTransfer_Get' response can carry.
            This is based on the the calculation below:
                 Gaia header size(SOF~LEN,VendorID,CommandID): 8 bytes,
@@ -255,6 +274,104 @@ bool GaiaFramework_DataTransferGet(GAIA_TRANSPORT *t, uint16 payload_length, con
 bool GaiaFramework_DataTransferSet(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
 
 
+/*! \brief Handles 'Data Transfer Stream Start' Command from the mobile app.
+
+    \param t            GAIA transport the data bytes are streamed on.
+
+    \param payload_size Payload size. This must be 12 (bytes).
+
+    \param payload      Payload data that contains the command parameters:
+                            Session ID, Starting offset, Size and Credits.
+
+    Instead of requesting each chunk with a 'Data Transfer Get' command, the
+    mobile app grants the device a number of credits. The device sends one
+    'Data Transfer Stream Data' notification per credit, each with as many
+    data bytes as the transport has space for, without waiting for the mobile
+    app in between. The mobile app keeps the stream going by sending
+    'Data Transfer Stream Credit' commands as it consumes the notifications.
+
+    Command Payload formart:
+         0        1        2        3        4        5        6        7        8        9       10       11    (Byte)
+    +--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+
+    |    Session ID   |  (MSB)   Starting Offset   (LSB)  |  (MSB)         Size        (LSB)  |     Credits     |
+    +--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+
+        - Size              Number of data bytes to stream. Zero streams
+                            until the Feature has no more data.
+
+    Response Payload format: Session ID (2 bytes).
+
+    Notification Payload format (Data Transfer Stream Data):
+         0        1        2        3        4        5        6        7       ...    (7 + N) (Byte)
+    +--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+
+    |    Session ID   | Status |  (MSB)       Offset       (LSB)  | Data 0 |   ...  | Data N |
+    +--------+--------+--------+--------+--------+--------+--------+--------+--------+--------+
+        - Status            data_transfer_status_success for a notification
+                            carrying data bytes. Any other status code
+                            (data_transfer_status_code_t) ends the stream,
+                            with no data bytes and without using a credit.
+
+    A stream stops, keeping its offset, if the transport disconnects. It can
+    be resumed from the last offset received with another 'Data Transfer
+    Stream Start' command, on the same or on a newly connected transport.
+*/
+bool GaiaFramework_DataTransferStreamStart(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
+
+
+/*! \brief Handles 'Data Transfer Stream Credit' Command from the mobile app.
+
+    \param t            GAIA transport associated with this data transfer session.
+
+    \param payload_size Payload size. This must be 4 (bytes).
+
+    \param payload      Payload data that contains Session ID and Credits.
+
+    Command Payload formart:
+         0        1        2        3    (Byte)
+    +--------+--------+--------+--------+
+    |    Session ID   |     Credits     |
+    +--------+--------+--------+--------+
+
+    Response Payload format: Session ID (2 bytes).
+*/
+bool GaiaFramework_DataTransferStreamCredit(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
+
+
+/*! \brief Handles 'Data Transfer Stream Stop' Command from the mobile app.
+
+    \param t            GAIA transport associated with this data transfer session.
+
+    \param payload_size Payload size. This must be 2 (bytes).
+
+    \param payload      Payload data that contains Session ID.
+
+    Response Payload format:
+         0        1        2        3        4        5    (Byte)
+    +--------+--------+--------+--------+--------+--------+
+    |    Session ID   |  (MSB)     Next Offset     (LSB)  |
+    +--------+--------+--------+--------+--------+--------+
+*/
+bool GaiaFramework_DataTransferStreamStop(GAIA_TRANSPORT *t, uint16 payload_length, const uint8 *payload);
+
+
+/*! \brief Stop the data transfer streams on a transport, e.g. as it disconnects.
+
+    \param t            GAIA transport.
+
+    The sessions and their offsets are kept, so the streams can be resumed.
+*/
+void GaiaFramework_StopDataTransferStreams(GAIA_TRANSPORT *t);
+
+
+/*! \brief Carry on sending the data transfer streams now a transport has space.
+
+    \param t            GAIA transport that has space again.
+
+    Called on GAIA_MORE_SPACE_IND, which the streams request when they run
+    out of space in the transport.
+*/
+void GaiaFramework_ResumeDataTransferStreams(GAIA_TRANSPORT *t);
+
+
 /*! \brief Shut down all the data transfer channels. Free up the resources
            allocated for the data transfer channels.
 
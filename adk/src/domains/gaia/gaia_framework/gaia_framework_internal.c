@@ -21,6 +21,7 @@
 #include "adk_log.h"
 #include "gaia_framework_command.h"
 #include "gaia_framework_feature.h"
+#include "gaia_framework_data_channel.h"
 #include "gatt_handler.h"
 #include "gaia_transport.h"
 #include "gaia_profile.h"
@@ -340,6 +341,10 @@ static void gaiaFrameworkInternal_MessageHandler(Task task, MessageId id, Messag
             gaiaFrameworkInternal_HandleHandoverInd((const GAIA_HANDOVER_IND_T *)message);
             break;
 
+        case GAIA_MORE_SPACE_IND:               /* Indication that a transport has space to send again */
+            GaiaFramework_ResumeDataTransferStreams(((const GAIA_MORE_SPACE_IND_T *)message)->transport);
+            break;
+
         case GAIA_START_SERVICE_CFM:             /* Confirmation that a Gaia server has started */
             DEBUG_LOG("gaiaFrameworkInternal_MessageHandler, GAIA_START_SERVICE_CFM (nothing to do)");
             break;
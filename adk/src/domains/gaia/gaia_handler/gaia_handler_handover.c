@@ -101,6 +101,37 @@ static bool gaiaHandover_Veto(void)
 }
 
 
+static uint16 gaiaHandover_EstimateSize(const tp_bdaddr *tp_bd_addr)
+{
+    /* Number of transports */
+    uint32 size = 1;
+
+    /* Same transports as are marshalled by gaiaHandover_Marshal */
+    gaia_transport_index index = 0;
+    GAIA_TRANSPORT *t = Gaia_TransportFindByTpBdAddr(tp_bd_addr, &index);
+    while (t)
+    {
+        if (Gaia_TransportIsConnected(t) && Gaia_TransportHasFeature(t, GAIA_TRANSPORT_FEATURE_DYNAMIC_HANDOVER))
+        {
+            size += sizeof(gaia_transport_marshalled_t);
+            if (t->functions->handover_estimate_size)
+            {
+                size += t->functions->handover_estimate_size(t);
+            }
+            else
+            {
+                /* Size is not known in advance */
+                return 0xFFFF;
+            }
+        }
+        t = Gaia_TransportFindByTpBdAddr(tp_bd_addr, &index);
+    }
+
+    DEBUG_LOG_DEBUG("gaiaHandover_EstimateSize, %u bytes", size);
+    return (uint16)MIN(size, 0xFFFF);
+}
+
+
 static bool gaiaHandover_Marshal(const tp_bdaddr *tp_bd_addr,
                                         uint8 *buf, uint16 buf_length,
                                         uint16 *written)
@@ -361,12 +392,15 @@ static void gaiaHandover_Abort(void)
 
 
 const handover_interface gaia_handover_if =
-        MAKE_HANDOVER_IF(&gaiaHandover_Veto,
-                         &gaiaHandover_Marshal,
-                         &gaiaHandover_Unmarshal,
-                         &gaiaHandover_Commit,
-                         &gaiaHandover_Complete,
-                         &gaiaHandover_Abort);
+        MAKE_HANDOVER_IF_ESTIMATE(HANDOVER_SUPPORT_ALL,
+                                  &gaiaHandover_Veto,
+                                  NULL,
+                                  &gaiaHandover_EstimateSize,
+                                  &gaiaHandover_Marshal,
+                                  &gaiaHandover_Unmarshal,
+                                  &gaiaHandover_Commit,
+                                  &gaiaHandover_Complete,
+                                  &gaiaHandover_Abort);
 
 
 static Task gaiaHandoverTws_serverTask;
@@ -15,6 +15,7 @@
 #include "gatt_connect.h"
 #include "marshal.h"
 #include "gaia_transport_gatt_marshal_desc.h"
+#include "metrics.h"
 
 #include <pmalloc.h>
 #include <source.h>
@@ -36,6 +37,11 @@
 
 #define GAIA_TRANSPORT_GATT_MAX_RX_PENDING_PKTS  (4)
 
+/* Each ATT notification carries a single GAIA packet, as the GATT packet
+ * header has no length to find the next packet by. Packets built in place
+ * with create_packet/flush_packet are not copied so aren't counted. */
+METRIC_COUNTER(gaia_gatt_bytes_copied, METRIC_ID_GAIA_GATT_BYTES_COPIED);
+
 /* Transport specific data */
 typedef struct
 {
@@ -60,6 +66,9 @@ typedef struct
     Source att_stream_source;
     Sink   att_stream_sink;
 
+    uint8 *tx_pkt_claimed;                          /*!< Packet being built in place in the ATT stream */
+    uint16 tx_pkt_claimed_size;                     /*!< Length of the packet being built, including the handle */
+
     uint16 handle_data_endpoint;                    /*!< Data endpoint handle for ATT stream */
     uint16 handle_response_endpoint;                /*!< Response endpoint handle for ATT stream */
 
@@ -83,6 +92,7 @@ typedef struct
 #ifdef ENABLE_LE_HANDOVER
 #define GAIA_TR_GATT_HANDOVER_VETO_HANDLER          gaiaTransport_GattHandoverVeto
 #define GAIA_TR_GATT_HANDOVER_MARSHAL_HANDLER       gaiaTransport_GattHandoverMarshal
+#define GAIA_TR_GATT_HANDOVER_ESTIMATE_SIZE_HANDLER gaiaTransport_GattHandoverEstimateSize
 #define GAIA_TR_GATT_HANDOVER_UNMARSHAL_HANDLER     gaiaTransport_GattHandoverUnmarshal
 #define GAIA_TR_GATT_HANDOVER_COMMIT_HANDLER        gaiaTransport_GattHandoverCommit
 #define GAIA_TR_GATT_HANDOVER_ABORT_HANDLER         gaiaTransport_GattHandoverAbort
@@ -90,6 +100,7 @@ typedef struct
 #else
 #define GAIA_TR_GATT_HANDOVER_VETO_HANDLER          NULL
 #define GAIA_TR_GATT_HANDOVER_MARSHAL_HANDLER       NULL
+#define GAIA_TR_GATT_HANDOVER_ESTIMATE_SIZE_HANDLER NULL
 #define GAIA_TR_GATT_HANDOVER_UNMARSHAL_HANDLER     NULL
 #define GAIA_TR_GATT_HANDOVER_COMMIT_HANDLER        NULL
 #define GAIA_TR_GATT_HANDOVER_ABORT_HANDLER         NULL
@@ -154,6 +165,7 @@ typedef struct
 #endif /* USE_SYNERGY */
 
 static void gaiaTransport_GattHandleMessage(Task task, MessageId id, Message message);
+static bool gaiaTransport_GattGetInfo(gaia_transport *t, gaia_transport_info_key_t key, uint32 *value);
 
 
 /*************************************************************************
@@ -260,6 +272,8 @@ static void gaiaTransport_GattDestroyAttStream(gaia_transport_gatt_t *tg)
     StreamAttSourceRemoveAllHandles(gaiaTransport_GetCidFromConnId(tg->cid));
     tg->att_stream_sink = 0;
     tg->att_stream_source = 0;
+    tg->tx_pkt_claimed = NULL;
+    tg->tx_pkt_claimed_size = 0;
 }
 
 
@@ -300,6 +314,7 @@ static bool gaiaTransport_GattSendPacketWithHandle(gaia_transport_gatt_t *tg, ui
         /* Copy payload */
         memcpy(pkt_ptr, payload, size_payload);
         pkt_ptr += size_payload;
+        Metrics_Add(gaia_gatt_bytes_copied, size_payload);
 
         /* Send response */
         gaiaTransport_GattRes(tg, pkt_length, pkt_buf, handle);
@@ -349,6 +364,7 @@ static bool gaiaTransport_GattSendPacketWithStream(gaia_transport_gatt_t *tg, ui
             /* Copy payload */
             memcpy(pkt_ptr, payload, size_payload);
             pkt_ptr += size_payload;
+            Metrics_Add(gaia_gatt_bytes_copied, size_payload);
 
             DEBUG_LOG_VERBOSE("gaiaTransport_GattSendPacketWithStream, sending, handle %u, vendor_id %u, command_id %u, pkt_length %u", handle, vendor_id, command_id, pkt_length);
             DEBUG_LOG_DATA_V_VERBOSE(pkt_buf, pkt_length);
@@ -404,6 +420,134 @@ static bool gaiaTransport_GattSendDataPacket(gaia_transport *t, uint16 vendor_id
 }
 
 
+/*! @brief Check if packets can be built in place in the ATT stream
+ */
+static bool gaiaTransport_GattIsStreamed(gaia_transport_gatt_t *tg)
+{
+    return tg->response_notifications_enabled && tg->att_stream_sink;
+}
+
+/*! @brief Get the available space size (in bytes) in the stream buffer
+ *
+ *  @param[in] t Pointer to transport
+ *
+ *  @return The size of available payload space in bytes.
+ */
+static uint16 gaiaTransport_GattGetPacketSpace(gaia_transport *t)
+{
+    gaia_transport_gatt_t *tg = (gaia_transport_gatt_t *)t;
+    PanicNull(tg);
+    uint32 payload_size;
+    uint16 malloc_space;
+
+    /* A malloc'ed packet is kept small */
+    gaiaTransport_GattGetInfo(t, GAIA_TRANSPORT_PAYLOAD_SIZE, &payload_size);
+    malloc_space = MIN((uint16)payload_size, GAIA_TRANSPORT_MAX_MALLOC_TX_PACKET_SIZE - GAIA_GATT_HEADER_SIZE);
+
+    if (gaiaTransport_GattIsStreamed(tg))
+    {
+        const uint16 header_space = GAIA_HANDLE_SIZE + GAIA_GATT_HEADER_SIZE;
+        const uint16 slack = SinkSlack(tg->att_stream_sink);
+        uint16 stream_space;
+
+        payload_size = tg->mtu - GATT_HEADER_BYTES - GAIA_GATT_HEADER_SIZE;
+        stream_space = (slack > header_space) ? MIN(slack - header_space, (uint16)payload_size) : 0;
+
+        /* Fall back to a malloc'ed packet rather than report no space, if the
+           stream is still full when it is flushed the transport goes busy */
+        if (stream_space >= malloc_space)
+            return stream_space;
+    }
+
+    return malloc_space;
+}
+
+/*! @brief Create a packet with the specified payload size in the stream buffer
+ *
+ *  @param[in] t Pointer to transport
+ *  @param[in] vendor_id  GAIA Vendor ID.
+ *  @param[in] command_id GAIA Command ID (which is Feature-ID, PDU-Type and PDU-specific-ID).
+ *  @param[in] size_payload Size of payload to be claimed.
+ *
+ *  @return A pointer to the start of the payload in the stream buffer, or in
+ *          a malloc'ed buffer if there is no space in the stream.
+ */
+static uint8* gaiaTransport_GattCreatePacket(gaia_transport *t, const uint16 vendor_id, const uint16 command_id, const uint16 size_payload)
+{
+    gaia_transport_gatt_t *tg = (gaia_transport_gatt_t *)t;
+    PanicNull(tg);
+
+    if (gaiaTransport_GattIsStreamed(tg))
+    {
+        const uint16 pkt_length = gaiaTransport_GattCalcPacketLength(size_payload, GAIA_STATUS_NONE) + GAIA_HANDLE_SIZE;
+        const uint16 claimed = SinkClaim(tg->att_stream_sink, 0);
+        uint8 *pkt_ptr = SinkMap(tg->att_stream_sink);
+
+        if (pkt_ptr && (claimed >= pkt_length || SinkClaim(tg->att_stream_sink, pkt_length - claimed) != 0xFFFF))
+        {
+            tg->tx_pkt_claimed = pkt_ptr;
+            tg->tx_pkt_claimed_size = pkt_length;
+
+            *pkt_ptr++ = LOW(tg->handle_response_endpoint);
+            *pkt_ptr++ = HIGH(tg->handle_response_endpoint);
+            *pkt_ptr++ = HIGH(vendor_id);
+            *pkt_ptr++ = LOW(vendor_id);
+            *pkt_ptr++ = HIGH(command_id);
+            *pkt_ptr++ = LOW(command_id);
+            return pkt_ptr;
+        }
+
+        DEBUG_LOG_WARN("gaiaTransport_GattCreatePacket, failed to claim %u bytes, using malloc", pkt_length);
+    }
+
+    PanicNotNull(t->tx_pkt_buf);
+    t->tx_pkt_buf = (gaia_transport_tx_packet_buffer_t *)PanicUnlessMalloc(sizeof(gaia_transport_tx_packet_buffer_t) + size_payload);
+    t->tx_pkt_buf->vendor_id = vendor_id;
+    t->tx_pkt_buf->command_id = command_id;
+    t->tx_pkt_buf->payload_length = size_payload;
+    return &t->tx_pkt_buf->payload[0];
+}
+
+/*! @brief Flush a packet in the stream buffer
+ *
+ *  @param[in] t Pointer to transport
+ *  @param[in] size_payload Size of payload to be sent, no more than was claimed.
+ *  @param[in] payload Pointer to the start of the payload.
+ *
+ *  @return TRUE if the packet is flushed successfully, otherwise FALSE.
+ */
+static bool gaiaTransport_GattFlushPacket(gaia_transport *t, const uint16 size_payload, const uint8 *payload)
+{
+    gaia_transport_gatt_t *tg = (gaia_transport_gatt_t *)t;
+    PanicNull(tg);
+
+    if (tg->tx_pkt_claimed)
+    {
+        const uint16 pkt_length = gaiaTransport_GattCalcPacketLength(size_payload, GAIA_STATUS_NONE) + GAIA_HANDLE_SIZE;
+
+        PanicFalse(pkt_length <= tg->tx_pkt_claimed_size);
+        tg->tx_pkt_claimed = NULL;
+        tg->tx_pkt_claimed_size = 0;
+
+        /* The ATT stream sends each flush as one notification */
+        DEBUG_LOG_VERBOSE("gaiaTransport_GattFlushPacket, sending, pkt_length %u", pkt_length);
+        return gaiaTransport_GattIsStreamed(tg) && SinkFlush(tg->att_stream_sink, pkt_length);
+    }
+    else if (t->tx_pkt_buf)
+    {
+        bool sent = gaiaTransport_GattSendPacket(t, t->tx_pkt_buf->vendor_id, t->tx_pkt_buf->command_id,
+                                                 GAIA_STATUS_NONE, MIN(size_payload, t->tx_pkt_buf->payload_length), payload);
+        free(t->tx_pkt_buf);
+        t->tx_pkt_buf = NULL;
+        return sent;
+    }
+
+    DEBUG_LOG_ERROR("gaiaTransport_GattFlushPacket, no packet has been created");
+    Panic();
+    return FALSE;
+}
+
+
 static void gaiaTransport_GattReceivePacket(gaia_transport_gatt_t *tg, uint16 data_length, const uint8 *data_buf, gaia_data_endpoint_mode_t mode)
 {
     if (data_length >= GAIA_GATT_HEADER_SIZE)
@@ -955,10 +1099,7 @@ static void gaiaTransport_GattHandleMessage(Task task, MessageId id, Message mes
         break;
 
         case MESSAGE_MORE_SPACE:
-            if(tg->common.state == GAIA_TRANSPORT_BUSY)
-            {
-                tg->common.state = GAIA_TRANSPORT_CONNECTED;
-            }
+            Gaia_TransportMoreSpaceInd(&tg->common);
         break;
 
         default:
@@ -1054,6 +1195,49 @@ static bool gaiaTransport_GattHandoverVeto(gaia_transport *t)
     return FALSE;
 }
 
+/*! @brief Fill in the object marshalled for the specified connection
+ *
+ *  @param[in] tg           Pointer to GATT transport instance.
+ *  @param[out] obj         The object to fill in.
+ */
+static void gaiaTransport_GattHandoverGetMarshalObj(gaia_transport_gatt_t *tg, gaia_transport_gatt_marshal_data_t *obj)
+{
+    obj->cid                            = tg->cid;
+#ifdef USE_SYNERGY
+    obj->gatt_id                        = tg->gatt_id;
+#endif
+    obj->response_data_flags            =  ( (tg->data_indications_enabled << GAIA_TR_GATT_HO_DATA_IND_ENABLE_BITPOS)       |
+                                             (tg->data_notifications_enabled << GAIA_TR_GATT_HO_DATA_NOTF_ENABLE_BITPOS)    |
+                                             (tg->response_indications_enabled << GAIA_TR_GATT_HO_RESP_IND_ENABLE_BITPOS)   |
+                                             (tg->response_notifications_enabled << GAIA_TR_GATT_HO_RESP_NOTF_ENABLE_BITPOS) );
+    obj->size_response                  = tg->size_response;
+    obj->data_endpoint_mode             = tg->data_endpoint_mode;
+}
+
+/*! @brief Get the size of the data marshalled for the specified connection
+ *
+ *  @param[in] t            Pointer to transport instance.
+ *
+ *  @return Number of bytes gaiaTransport_GattHandoverMarshal() writes.
+ */
+static uint16 gaiaTransport_GattHandoverEstimateSize(gaia_transport *t)
+{
+    gaia_transport_gatt_marshal_data_t obj;
+    uint16 size;
+    PanicNull(t);
+
+    gaiaTransport_GattHandoverGetMarshalObj((gaia_transport_gatt_t*) t, &obj);
+
+    /* Without a buffer the marshaller only works out how much it would write */
+    marshaller_t marshaller = MarshalInit(mtd_gaia_transport_gatt_client, GAIA_TRANSPORT_GATT_MARSHAL_OBJ_TYPE_COUNT);
+    MarshalSetBuffer(marshaller, NULL, 0);
+    (void)Marshal(marshaller, &obj, MARSHAL_TYPE(gaia_transport_gatt_marshal_data_t));
+    size = MarshalRemaining(marshaller);
+    MarshalDestroy(marshaller, FALSE);
+
+    return size;
+}
+
 /*! @brief Marshal the data associated with the specified connection
  *
  *  @param[in] t            Pointer to transport instance.
@@ -1073,16 +1257,7 @@ static bool gaiaTransport_GattHandoverMarshal(gaia_transport *t, uint8 *buf, uin
 
     if (buf_length >= sizeof(gaia_transport_gatt_marshal_data_t))
     {
-        obj.cid                            = tg->cid;
-#ifdef USE_SYNERGY
-        obj.gatt_id                        = tg->gatt_id;
-#endif
-        obj.response_data_flags            =  ( (tg->data_indications_enabled << GAIA_TR_GATT_HO_DATA_IND_ENABLE_BITPOS)       |
-                                                (tg->data_notifications_enabled << GAIA_TR_GATT_HO_DATA_NOTF_ENABLE_BITPOS)    |
-                                                (tg->response_indications_enabled << GAIA_TR_GATT_HO_RESP_IND_ENABLE_BITPOS)   |
-                                                (tg->response_notifications_enabled << GAIA_TR_GATT_HO_RESP_NOTF_ENABLE_BITPOS) );
-        obj.size_response                  = tg->size_response;
-        obj.data_endpoint_mode             = tg->data_endpoint_mode;
+        gaiaTransport_GattHandoverGetMarshalObj(tg, &obj);
 
         marshaller_t marshaller = MarshalInit(mtd_gaia_transport_gatt_client, GAIA_TRANSPORT_GATT_MARSHAL_OBJ_TYPE_COUNT);
         MarshalSetBuffer(marshaller, (void*)buf, buf_length);
@@ -1273,9 +1448,13 @@ void GaiaTransport_GattInit(void)
         .features                   = gaiaTransport_GattFeatures,
         .get_info                   = gaiaTransport_GattGetInfo,
         .set_parameter              = gaiaTransport_GattSetParameter,
+        .get_packet_space           = gaiaTransport_GattGetPacketSpace,
+        .create_packet              = gaiaTransport_GattCreatePacket,
+        .flush_packet               = gaiaTransport_GattFlushPacket,
 #if defined(ENABLE_GAIA_DYNAMIC_HANDOVER) && defined(ENABLE_LE_HANDOVER)
         .handover_veto              = GAIA_TR_GATT_HANDOVER_VETO_HANDLER,
         .handover_marshal           = GAIA_TR_GATT_HANDOVER_MARSHAL_HANDLER,
+        .handover_estimate_size     = GAIA_TR_GATT_HANDOVER_ESTIMATE_SIZE_HANDLER,
         .handover_unmarshal         = GAIA_TR_GATT_HANDOVER_UNMARSHAL_HANDLER,
         .handover_commit            = GAIA_TR_GATT_HANDOVER_COMMIT_HANDLER,
         .handover_abort             = GAIA_TR_GATT_HANDOVER_ABORT_HANDLER,
@@ -14,6 +14,8 @@
 #include "gaia_transport.h"
 
 #include "app_handover_if.h"
+#include "domain_message.h"
+#include "metrics.h"
 
 #include "connection_abstraction.h"
 #include <source.h>
@@ -45,6 +47,9 @@
 
 #define GAIA_TRANSPORT_RFCOMM_MAX_RX_PENDING_PKTS     (2)
 
+/*! Most packets sent together in one RFCOMM sink flush */
+#define GAIA_TRANSPORT_RFCOMM_MAX_BATCHED_PKTS        (8)
+
 #define GAIA_RFCOMM_REGISTER_SERVICE_RECORD(task, rec_size, rec)    ConnectionRegisterServiceRecord(task, rec_size, rec);
 #define GAIA_RFCOMM_DEREGISTER_SERVICE_RECORD(task, handle)         ConnectionUnregisterServiceRecord(task, handle);
 #define IS_SDP_STATUS_SUCCESS(status) (status == sds_status_success)
@@ -64,8 +69,24 @@ typedef struct
     uint16 rx_data_pending;
     uint8 *tx_pkt_claimed;
     uint16 tx_pkt_claimed_size;
+    uint16 tx_batched;      /*!< Bytes of complete packets in the sink waiting to be flushed together. */
+    uint8  tx_batched_pkts; /*!< Number of packets in tx_batched. */
 } gaia_transport_rfcomm_t;
 
+/*! @brief Internal messages of the RFCOMM transport */
+typedef enum
+{
+    /*! Flush the packets batched in the sink */
+    GAIA_TRANSPORT_RFCOMM_INTERNAL_SEND_BATCH = INTERNAL_MESSAGE_BASE,
+
+    /*! This must be the final message */
+    GAIA_TRANSPORT_RFCOMM_INTERNAL_MESSAGE_END
+} gaia_transport_rfcomm_internal_message_t;
+ASSERT_INTERNAL_MESSAGES_NOT_OVERFLOWED(GAIA_TRANSPORT_RFCOMM_INTERNAL_MESSAGE_END)
+
+METRIC_HISTOGRAM(gaia_rfcomm_packets_per_flush, METRIC_ID_GAIA_RFCOMM_PACKETS_PER_FLUSH, 1, 2, 4);
+METRIC_COUNTER(gaia_rfcomm_bytes_copied, METRIC_ID_GAIA_RFCOMM_BYTES_COPIED);
+
 typedef struct
 {
     uint8 channel;
@@ -135,7 +156,60 @@ static const uint8 gaia_transport_spp_service_record[] =
 };
 
 
+/*! @brief Get the most bytes of packets that can be flushed together
+ *
+ *  A batch is kept no larger than the largest packet the host has agreed
+ *  to receive.
+ */
+static uint16 gaiaTransport_RfcommMaxBatchSize(gaia_transport_rfcomm_t *tr)
+{
+    if (tr->protocol_version < 4)
+        return MIN(tr->max_tx_size, GAIA_TRANSPORT_RFCOMM_8BIT_LENGTH_MAX_PKT_SIZE);
+
+    return tr->max_tx_size;
+}
+
+/*! @brief Flush the packets batched in the sink
+ *
+ *  If the flush fails the packets are dropped. Their bytes stay claimed in the
+ *  sink, and as TransportMgrClaimData() returns the start of the claimed space
+ *  the next packet is written over them rather than after them.
+ *
+ *  @return TRUE if there was nothing to send or the packets were sent, otherwise FALSE.
+ */
+static bool gaiaTransport_RfcommSendBatch(gaia_transport_rfcomm_t *tr)
+{
+    bool sent = TRUE;
+
+    MessageCancelAll(&tr->common.task, GAIA_TRANSPORT_RFCOMM_INTERNAL_SEND_BATCH);
+
+    if (tr->tx_batched)
+    {
+        sent = (transport_mgr_status_success == TransportMgrDataSend(transport_mgr_type_rfcomm, tr->channel, tr->tx_batched));
+        if (sent)
+        {
+            DEBUG_LOG_VERBOSE("gaiaTransport_RfcommSendBatch, sending, packets %u, length %u", tr->tx_batched_pkts, tr->tx_batched);
+            Metrics_Record(gaia_rfcomm_packets_per_flush, tr->tx_batched_pkts);
+        }
+        else
+            DEBUG_LOG_WARN("gaiaTransport_RfcommSendBatch, failed to send, packets %u, length %u", tr->tx_batched_pkts, tr->tx_batched);
+
+        /* Either way the claimed bytes are free for the next packet */
+        tr->tx_batched = 0;
+        tr->tx_batched_pkts = 0;
+    }
+
+    return sent;
+}
+
 /*! @brief Send a GAIA packet over RFCOMM
+ *
+ *  The packet is built in place in the sink after any packets already waiting
+ *  there. Packets written while handling the same message are flushed
+ *  together, unless the batch reaches the size of a packet the host accepts.
+ *
+ *  @return TRUE if the packet was sent or batched. A batched packet is only
+ *          sent later, if that fails it is dropped without further report.
  */
 static bool gaiaTransport_RfcommSendPacket(gaia_transport *t, uint16 vendor_id, uint16 command_id,
                                            uint8 status, uint16 size_payload, const void *payload)
@@ -143,22 +217,39 @@ static bool gaiaTransport_RfcommSendPacket(gaia_transport *t, uint16 vendor_id,
     gaia_transport_rfcomm_t *tr = (gaia_transport_rfcomm_t *)t;
     uint16 trans_info = tr->channel;
     const uint16 pkt_length = Gaia_TransportCommonCalcTxPacketLength(size_payload, status);
+    const uint16 max_batch_size = gaiaTransport_RfcommMaxBatchSize(tr);
+
+    /* Send the waiting packets on their own if this one doesn't fit with them */
+    if (tr->tx_batched + pkt_length > max_batch_size)
+        gaiaTransport_RfcommSendBatch(tr);
+
     const uint16 trans_space = TransportMgrGetAvailableSpace(transport_mgr_type_rfcomm, trans_info);
     if (trans_space >= pkt_length)
     {
-        uint8 *pkt_buf = TransportMgrClaimData(transport_mgr_type_rfcomm, trans_info, pkt_length);
-        if (pkt_buf)
+        uint8 *batch_buf = TransportMgrClaimData(transport_mgr_type_rfcomm, trans_info, tr->tx_batched + pkt_length);
+        if (batch_buf)
         {
+            uint8 *pkt_buf = batch_buf + tr->tx_batched;
+
             /* Build packet into buffer */
             Gaia_TransportCommonBuildPacket(tr->protocol_version, pkt_buf, pkt_length, vendor_id, command_id, status, size_payload, payload);
+            Metrics_Add(gaia_rfcomm_bytes_copied, size_payload);
+
+            DEBUG_LOG_VERBOSE("gaiaTransportRfcommSendPacket, batching, vendor_id %u, command_id %u, pkt_length %u", vendor_id, command_id, pkt_length);
+            DEBUG_LOG_DATA_V_VERBOSE(pkt_buf, pkt_length);
 
-            /* Send packet */
-            if (TransportMgrDataSend(transport_mgr_type_rfcomm, trans_info, pkt_length))
-            {
-                DEBUG_LOG_VERBOSE("gaiaTransportRfcommSendPacket, sending, vendor_id %u, command_id %u, pkt_length %u", vendor_id, command_id, pkt_length);
-                DEBUG_LOG_DATA_V_VERBOSE(pkt_buf, pkt_length);
-                return TRUE;
-            }
+            tr->tx_batched += pkt_length;
+            tr->tx_batched_pkts += 1;
+
+            /* Send now if no further packet could join the batch */
+            if (tr->tx_batched + Gaia_TransportCommonCalcTxPacketLength(0, GAIA_STATUS_NONE) > max_batch_size ||
+                tr->tx_batched_pkts >= GAIA_TRANSPORT_RFCOMM_MAX_BATCHED_PKTS)
+                return gaiaTransport_RfcommSendBatch(tr);
+
+            /* Otherwise send once the current message has been handled */
+            if (tr->tx_batched_pkts == 1)
+                MessageSend(&t->task, GAIA_TRANSPORT_RFCOMM_INTERNAL_SEND_BATCH, NULL);
+            return TRUE;
         }
     }
     else
@@ -293,6 +384,10 @@ static uint8* gaiaTransport_RfcommCreatePacket(gaia_transport *t, const uint16 v
     gaia_transport_rfcomm_t *tr = (gaia_transport_rfcomm_t *)t;
     PanicNull(tr);
     uint16 trans_info = tr->channel;
+
+    /* Packets are sent in order, so send any waiting packets before building this one */
+    gaiaTransport_RfcommSendBatch(tr);
+
     tr->tx_pkt_claimed_size = Gaia_TransportCommonCalcTxPacketLength(size_payload, GAIA_STATUS_NONE);
     tr->tx_pkt_claimed = TransportMgrClaimData(transport_mgr_type_rfcomm, trans_info, tr->tx_pkt_claimed_size);
 
@@ -422,6 +517,9 @@ static void gaiaTransport_RfcommResetParams(gaia_transport_rfcomm_t *tr)
     tr->protocol_version    = GAIA_TRANSPORT_RFCOMM_DEFAULT_PROTOCOL_VERSION;
     tr->tx_pkt_claimed      = NULL;
     tr->tx_pkt_claimed_size = 0;
+    tr->tx_batched          = 0;
+    tr->tx_batched_pkts     = 0;
+    MessageCancelAll(&tr->common.task, GAIA_TRANSPORT_RFCOMM_INTERNAL_SEND_BATCH);
 }
 
 
@@ -679,6 +777,18 @@ static bool gaiaTransport_RfcommHandoverMarshal(gaia_transport *t, uint8 *buf, u
     }
 }
 
+/*! @brief Get the size of the data marshalled for the specified connection
+ *
+ *  @param[in] t             Pointer to transport instance.
+ *
+ *  @return Number of bytes gaiaTransport_RfcommHandoverMarshal() writes.
+ */
+static uint16 gaiaTransport_RfcommHandoverEstimateSize(gaia_transport *t)
+{
+    UNUSED(t);
+    return sizeof(gaia_transport_rfcomm_marshalled_t);
+}
+
 /*! @brief Unmarshal the data associated with the specified connection
  *
  *  @param[in] t             Pointer to transport instance.
@@ -964,6 +1074,12 @@ static void gaiaTransport_RfcommHandleMessage(Task task, MessageId id, Message m
             break;
 
         case TRANSPORT_MGR_MORE_SPACE:
+            /* Packets can be sent again after running out of space */
+            Gaia_TransportMoreSpaceInd(&tr->common);
+            break;
+
+        case GAIA_TRANSPORT_RFCOMM_INTERNAL_SEND_BATCH:
+            gaiaTransport_RfcommSendBatch(tr);
             break;
 
         case TRANSPORT_MGR_REGISTER_CFM:
@@ -1031,6 +1147,7 @@ void GaiaTransport_RfcommInit(void)
         .set_parameter          = gaiaTransport_RfcommSetParameter,
         .handover_veto          = gaiaTransport_RfcommHandoverVeto,
         .handover_marshal       = gaiaTransport_RfcommHandoverMarshal,
+        .handover_estimate_size = gaiaTransport_RfcommHandoverEstimateSize,
         .handover_unmarshal     = gaiaTransport_RfcommHandoverUnmarshal,
         .handover_commit        = gaiaTransport_RfcommHandoverCommit,
         .handover_abort         = gaiaTransport_RfcommHandoverAbort,
@@ -0,0 +1,89 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+                All Rights Reserved.\n
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file
+    \ingroup    statistics_gaia_plugin_handlers
+    \brief      Source file for the statistics framework metrics registry handler
+*/
+
+#include "statistics_gaia_plugin_handlers_metrics.h"
+#include "statistics_gaia_plugin.h"
+#include "statistics_gaia_plugin_utils.h"
+#include "metrics.h"
+#include <gaia.h>
+#include <logging.h>
+#include <panic.h>
+
+#if defined(INCLUDE_STATISTICS)
+
+#define STATISTICS_METRICS_MAX_ID 0xFF
+
+static size_t statisticsGaiaPluginHandlersMetrics_GetSupportedStatisticIDs(statistics_gaia_plugin_statistic_id_t *ids, size_t max_length)
+{
+    size_t count = 0;
+
+    for (uint16 index = 0; index < Metrics_GetNumberOf(); index++)
+    {
+        uint16 id = Metrics_GetByIndex(index)->id;
+        size_t position = count;
+
+        if (id > STATISTICS_METRICS_MAX_ID || count == max_length)
+        {
+            continue;
+        }
+
+        /* The registrations are in link order, the ids must be reported in increasing order */
+        while (position > 0 && ids[position - 1] > id)
+        {
+            ids[position] = ids[position - 1];
+            position--;
+        }
+        ids[position] = (statistics_gaia_plugin_statistic_id_t)id;
+        count++;
+    }
+    return count;
+}
+
+static size_t statisticsGaiaPluginHandlersMetrics_GetStatisticValue(statistics_gaia_plugin_statistic_id_t statistic_id, uint8* value, size_t max_length)
+{
+    const metric_registration_t *reg = Metrics_Find(statistic_id);
+    size_t return_length = 0;
+
+    DEBUG_LOG_VERBOSE("statisticsGaiaPluginHandlersMetrics_GetStatisticValue id %d", statistic_id);
+
+    if (reg)
+    {
+        uint16 number_of_values = Metrics_NumberOfValues(reg);
+
+        if (number_of_values * sizeof(uint32) <= max_length)
+        {
+            for (uint16 index = 0; index < number_of_values; index++)
+            {
+                return_length += StatisticsGaiaPluginUtils_ReturnUInt32(reg->values[index], &value[return_length], max_length - return_length);
+            }
+        }
+        else
+        {
+            DEBUG_LOG_WARN("statisticsGaiaPluginHandlersMetrics_GetStatisticValue id %d has too many buckets, %d", statistic_id, number_of_values);
+        }
+    }
+
+    return return_length;
+}
+
+bool StatisticsGaiaPluginHandlersMetrics_Init(Task init_task)
+{
+    UNUSED(init_task);
+    static const statistics_gaia_plugin_handler_functions_t functions =
+    {
+        .get_supported_statistic_ids_handler = statisticsGaiaPluginHandlersMetrics_GetSupportedStatisticIDs,
+        .get_statistic_value_handler = statisticsGaiaPluginHandlersMetrics_GetStatisticValue,
+    };
+
+    DEBUG_LOG_VERBOSE("StatisticsGaiaPluginHandlersMetrics_Init, %d metrics", Metrics_GetNumberOf());
+
+    return StatisticsGaiaPlugin_RegisterCategoryHandler(statistics_gaia_plugin_handler_ids_metrics, &functions);
+}
+
+#endif
@@ -0,0 +1,31 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+                All Rights Reserved.\n
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file
+    \addtogroup statistics_gaia_plugin_handlers
+    \brief      Header file for the statistics metrics registry handler
+
+    Each metric in the registry (see metrics.h) is a statistic with the
+    metric's id. Counters and gauges are returned as a UInt32, histograms as
+    a UInt32 for each bucket, lowest first, and counter arrays as a UInt32
+    for each index, from 0. Only metrics with ids up to 255 are reported.
+    @{
+*/
+
+#ifndef STATISTICS_GAIA_PLUGIN_METRICS_H
+#define STATISTICS_GAIA_PLUGIN_METRICS_H
+
+#if defined(INCLUDE_STATISTICS)
+
+/*! \brief Registers the metrics registry statistics handler
+
+    \param  init_task       Task passed on initialisation by earbud_init/headset_init.
+                            Currently unused.
+*/
+bool StatisticsGaiaPluginHandlersMetrics_Init(Task init_task);
+
+#endif //INCLUDE_STATISTICS
+#endif // STATISTICS_GAIA_PLUGIN_METRICS_H
+
+/*! @} */
@@ -31,7 +31,8 @@
 #define STATISTICS_VALUES_RESPONSE_CATEGORY_ID_OFFSET 0
 #define STATISTICS_VALUES_RESPONSE_FLAGS_OFFSET 1
 
-#define STATISTICS_VALUE_MAX_VALUE_LENGTH 4
+/* Long enough for the buckets of a metrics histogram */
+#define STATISTICS_VALUE_MAX_VALUE_LENGTH 32
 
 #define STATISTICS_VALUE_CATEGORY_ID_OFFSET 0
 #define STATISTICS_VALUE_CATEGORY_ID_SIZE 2
@@ -19,6 +19,7 @@ typedef enum
 {
     statistics_gaia_plugin_handler_ids_streaming = 0x0001,                /*<! Streaming Statistics Handler */
     statistics_gaia_plugin_handler_ids_spatial_audio = 0x0002,            /*<! Spatial Audio Statistics Handler */
+    statistics_gaia_plugin_handler_ids_metrics = 0x0003,                  /*<! Metrics Registry Handler */
 } statistics_gaia_plugin_handler_category_ids_t;
 
 
@@ -20,6 +20,7 @@
 
 #include <dormant.h>
 #include <psu.h>
+#include <ps_cache.h>
 #include <panic.h>
 #include <logging.h>
 
@@ -134,6 +135,9 @@ void appPowerEnterDormantMode(bool extended_wakeup_events)
         Panic();
     }
 
+    /* Write back any PS keys still held by the cache */
+    PsCache_Flush();
+
     /* Make sure dormant will ignore any wake up time */
     PanicFalse(DormantConfigure(DEADLINE_VALID,FALSE));
 
@@ -161,6 +165,9 @@ bool appPowerDoPowerOff(void)
         Panic();
     }
 
+    /* Write back any PS keys still held by the cache */
+    PsCache_Flush();
+
     /* Try to power off.*/
     PsuConfigure(PSU_ALL, PSU_ENABLE, FALSE);
 
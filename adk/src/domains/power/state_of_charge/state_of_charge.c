@@ -15,6 +15,7 @@
 DEBUG_LOG_DEFINE_LEVEL_VAR
 
 #include <ps.h>
+#include <ps_cache.h>
 #include <panic.h>
 #include <pio.h>
 #include <vm.h>
@@ -250,7 +251,7 @@ static void soc_HandleMessage(Task task, MessageId id, Message message)
                 soc_data->state_of_charge = soc_ctx.soc_config_table[soc_data->config_index].percentage;
                 DEBUG_LOG_INFO("soc_StateOfChargeUpdate, charging %u%%", soc_data->state_of_charge);
 
-                if (!PsStore(BATTERY_STATE_OF_CHARGE_KEY, &soc_data->state_of_charge, 1))
+                if (!PsCache_StoreNow(BATTERY_STATE_OF_CHARGE_KEY, &soc_data->state_of_charge, 1))
                 {
                     DEBUG_LOG_WARN("soc_StateOfChargeUpdate, PS Store update for Battery SoC key failed.");
                 }
@@ -275,7 +276,7 @@ static void soc_HandleMessage(Task task, MessageId id, Message message)
                 soc_data->state_of_charge = soc_ctx.soc_config_table[soc_data->config_index].percentage;
                 DEBUG_LOG_INFO("soc_StateOfChargeUpdate, discharging %u%%", soc_data->state_of_charge);
                 /* in disconnected state this value seems ok as reduction or being same expected */            
-                if (!PsStore(BATTERY_STATE_OF_CHARGE_KEY, &soc_data->state_of_charge, 1))
+                if (!PsCache_StoreNow(BATTERY_STATE_OF_CHARGE_KEY, &soc_data->state_of_charge, 1))
                 {
                     DEBUG_LOG_WARN("soc_StateOfChargeUpdate, PS Store update for Battery SoC key failed.");
                 }
@@ -342,7 +343,7 @@ void Soc_Init(void)
     soc_data->task.handler = soc_HandleMessage;
     
     /* read PS Key */
-    if(PsRetrieve(BATTERY_STATE_OF_CHARGE_KEY, &soc, 1) != 0)
+    if(PsCache_Retrieve(BATTERY_STATE_OF_CHARGE_KEY, &soc, 1) != 0)
     {
         DEBUG_LOG("SoC_Init: PSRetrieve returned last value of Battery Charge: %u%%", soc);
         soc_data->state_of_charge = soc; 
@@ -17,6 +17,7 @@
 #include <panic.h>
 #include <ps.h>
 #include <ps_key_map.h>
+#include <ps_cache.h>
 
 #define APP_POWER_SEC_TO_US(s)    ((rtime_t) ((s) * (rtime_t) US_PER_SEC))
 
@@ -28,12 +29,12 @@ static reboot_action_t SystemReboot_RetrieveAction(void)
 {
     reboot_action_t reboot_action = reboot_action_default_state;
 
-    uint16 num_of_words = PsRetrieve(PS_KEY_REBOOT_ACTION, NULL, 0);
+    uint16 num_of_words = PsCache_Retrieve(PS_KEY_REBOOT_ACTION, NULL, 0);
     if(num_of_words > 0)
     {
         uint16 *key_cache = PanicUnlessMalloc( num_of_words * sizeof(uint16) );
 
-         uint16 read_words = PsRetrieve(PS_KEY_REBOOT_ACTION, key_cache, num_of_words);
+         uint16 read_words = PsCache_Retrieve(PS_KEY_REBOOT_ACTION, key_cache, num_of_words);
 
         if(read_words > 0)
         {
@@ -50,7 +51,8 @@ static void SystemReboot_SetAction(reboot_action_t reboot_action)
 {
         uint16 key_cache[REBOOT_PSKEY_STORAGE_LENGTH];
         key_cache[REBOOT_ACTION_STORE_OFFSET] = (uint16) reboot_action;
-        PsStore(PS_KEY_REBOOT_ACTION, key_cache, REBOOT_PSKEY_STORAGE_LENGTH);
+        /* Written through, the action must survive a panic or a power loss */
+        PsCache_StoreNow(PS_KEY_REBOOT_ACTION, key_cache, REBOOT_PSKEY_STORAGE_LENGTH);
 }
 
 reboot_action_t SystemReboot_GetAction(void)
@@ -72,6 +74,9 @@ void SystemReboot_RebootWithAction(reboot_action_t reboot_action)
     /* Store the reboot action in persistant storage*/
     SystemReboot_SetAction(reboot_action);
 
+    /* Write back any other PS keys still held by the cache */
+    PsCache_Flush();
+
     /* Reboot now */
     BootSetMode(BootGetMode());
     DEBUG_LOG("SystemReboot, post reboot");
@@ -15,23 +15,44 @@
 #include <logging.h>
 #include <vmtypes.h>
 #include <panic.h>
+#include <system_clock.h>
 
 #include <string.h>
 
 LOGGING_PRESERVE_MESSAGE_TYPE(system_state_messages_t)
 
+/*! Maximum number of overlapped steps that can be waiting to complete. */
+#ifndef SYSTEM_STATE_MAX_OVERLAPPED_STEPS
+#define SYSTEM_STATE_MAX_OVERLAPPED_STEPS (4)
+#endif
+
 typedef struct
 {
     const system_state_step_t *transition_table;
     unsigned transition_table_count;
 } transition_table_t;
 
+typedef struct
+{
+    unsigned index;
+    rtime_t started;
+} system_state_overlapped_step_t;
+
 typedef struct
 {
     transition_table_t *transition;
     unsigned index;
     TaskData task;
     system_state_state_t state_on_completition;
+
+    /*! TRUE while waiting for the step at index to complete. */
+    bool step_pending;
+    rtime_t step_started;
+    rtime_t transition_started;
+
+    system_state_overlapped_step_t overlapped[SYSTEM_STATE_MAX_OVERLAPPED_STEPS];
+    unsigned overlapped_count;
+    unsigned overlapped_total;
 } system_state_current_transition_t;
 
 typedef struct
@@ -141,33 +162,154 @@ static void systemState_SetState(system_state_state_t new_state)
 
 static void systemState_CompleteTransition(transition_table_t *table, bool success)
 {
+    system_state_current_transition_t *current = &system_state_ctx.current_transition;
+
     UNUSED(success);
     UNUSED(table);
-    systemState_SetState(system_state_ctx.current_transition.state_on_completition);
+
+    DEBUG_LOG_INFO("systemState_CompleteTransition, state 0x%x took %uus, %u steps overlapped",
+            current->state_on_completition,
+            rtime_sub(SystemClockGetTimerTime(), current->transition_started),
+            current->overlapped_total);
+
+    systemState_SetState(current->state_on_completition);
+}
+
+static void systemState_LogStep(transition_table_t *table, unsigned index, rtime_t started)
+{
+    rtime_t now = SystemClockGetTimerTime();
+
+    DEBUG_LOG_DEBUG("systemState_LogStep, step %u fn %p started at %uus took %uus",
+            index, table->transition_table[index].step,
+            rtime_sub(started, system_state_ctx.current_transition.transition_started),
+            rtime_sub(now, started));
+}
+
+/*! \brief Check if a step can run now, or has to wait for overlapped steps to complete. */
+static bool systemState_CanRunStep(const system_state_step_t *step)
+{
+    system_state_current_transition_t *current = &system_state_ctx.current_transition;
+    transition_table_t *table = current->transition;
+    unsigned i;
+
+    if(current->overlapped_count == 0)
+    {
+        return TRUE;
+    }
+
+    if(step->flags & system_state_step_wait_overlapped)
+    {
+        return FALSE;
+    }
+
+    if(step->async_message_id)
+    {
+        if((step->flags & system_state_step_overlap) &&
+           current->overlapped_count == SYSTEM_STATE_MAX_OVERLAPPED_STEPS)
+        {
+            return FALSE;
+        }
+
+        /* The completion message must identify a single step */
+        for(i = 0; i < current->overlapped_count; i++)
+        {
+            if(table->transition_table[current->overlapped[i].index].async_message_id == step->async_message_id)
+            {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
 }
 
 static void systemState_DoTransition(transition_table_t *table)
 {
-    ++system_state_ctx.current_transition.index;
+    system_state_current_transition_t *current = &system_state_ctx.current_transition;
 
-    while(system_state_ctx.current_transition.index < table->transition_table_count)
+    while(current->index < table->transition_table_count)
     {
-        table->transition_table[system_state_ctx.current_transition.index].step((Task)&system_state_ctx.current_transition.task);
+        const system_state_step_t *step = &table->transition_table[current->index];
 
-        if(table->transition_table[system_state_ctx.current_transition.index].async_message_id)
+        if(!systemState_CanRunStep(step))
         {
+            /* Resumed when the overlapped steps complete */
+            DEBUG_LOG_VERBOSE("systemState_DoTransition, step %u waiting for %u overlapped steps",
+                    current->index, current->overlapped_count);
             return;
         }
 
-        ++system_state_ctx.current_transition.index;
+        current->step_started = SystemClockGetTimerTime();
+
+        step->step((Task)&current->task);
+
+        if(step->async_message_id)
+        {
+            if(!(step->flags & system_state_step_overlap))
+            {
+                current->step_pending = TRUE;
+                return;
+            }
+
+            current->overlapped[current->overlapped_count].index = current->index;
+            current->overlapped[current->overlapped_count].started = current->step_started;
+            current->overlapped_count++;
+            current->overlapped_total++;
+        }
+        else
+        {
+            systemState_LogStep(table, current->index, current->step_started);
+        }
+
+        ++current->index;
+    }
+
+    if(current->overlapped_count == 0)
+    {
+        systemState_CompleteTransition(table, TRUE);
+    }
+}
+
+/*! \brief Handle the completion message of an overlapped step.
+
+    \return TRUE if the message completed an overlapped step.
+*/
+static bool systemState_HandleOverlappedStepComplete(transition_table_t *table, MessageId id, Message msg)
+{
+    system_state_current_transition_t *current = &system_state_ctx.current_transition;
+    unsigned i;
+
+    for(i = 0; i < current->overlapped_count; i++)
+    {
+        system_state_overlapped_step_t overlapped = current->overlapped[i];
+        const system_state_step_t *step = &table->transition_table[overlapped.index];
+
+        if(step->async_message_id == id)
+        {
+            if(step->async_handler)
+            {
+                step->async_handler(msg);
+            }
+
+            systemState_LogStep(table, overlapped.index, overlapped.started);
+
+            current->overlapped[i] = current->overlapped[--current->overlapped_count];
+
+            if(!current->step_pending)
+            {
+                systemState_DoTransition(table);
+            }
+            return TRUE;
+        }
     }
 
-    systemState_CompleteTransition(table, TRUE);
+    return FALSE;
 }
 
 static void systemState_MessageHandler(Task task, MessageId id, Message msg)
 {
-    transition_table_t *transition = system_state_ctx.current_transition.transition;
+    system_state_current_transition_t *current = &system_state_ctx.current_transition;
+    transition_table_t *transition = current->transition;
 
     UNUSED(task);
 
@@ -177,22 +319,31 @@ static void systemState_MessageHandler(Task task, MessageId id, Message msg)
         return;
     }
 
-    unsigned index = system_state_ctx.current_transition.index;
-    MessageId expected_id = transition->transition_table[index].async_message_id;
-    step_handler handler = transition->transition_table[index].async_handler;
+    unsigned index = current->index;
+    MessageId expected_id = current->step_pending ? transition->transition_table[index].async_message_id : 0;
 
-    if(id != expected_id)
+    if(!current->step_pending || id != expected_id)
     {
-        DEBUG_LOG_ERROR("systemState_MessageHandler ERROR: received message MESSAGE:0x%x at transition index 0x%x, but expected 0x%x message",
-                id, index, expected_id);
+        if(!systemState_HandleOverlappedStepComplete(transition, id, msg))
+        {
+            DEBUG_LOG_ERROR("systemState_MessageHandler ERROR: received message MESSAGE:0x%x at transition index 0x%x, but expected 0x%x message",
+                    id, index, expected_id);
+        }
         return;
     }
 
+    step_handler handler = transition->transition_table[index].async_handler;
+
     if(handler)
     {
         handler(msg);
     }
 
+    systemState_LogStep(transition, index, current->step_started);
+
+    current->step_pending = FALSE;
+    ++current->index;
+
     systemState_DoTransition(transition);
 }
 
@@ -218,9 +369,13 @@ Task SystemState_GetTransitionTask(void)
 static void systemState_SetupCurrentTransition(transition_table_t *table, system_state_state_t state_on_completition)
 {
     system_state_ctx.current_transition.transition = table;
-    system_state_ctx.current_transition.index = -1;
+    system_state_ctx.current_transition.index = 0;
     system_state_ctx.current_transition.task.handler = systemState_MessageHandler;
     system_state_ctx.current_transition.state_on_completition = state_on_completition;
+    system_state_ctx.current_transition.step_pending = FALSE;
+    system_state_ctx.current_transition.transition_started = SystemClockGetTimerTime();
+    system_state_ctx.current_transition.overlapped_count = 0;
+    system_state_ctx.current_transition.overlapped_total = 0;
 }
 
 static bool systemState_InitiateTransiton(system_state_state_t start_state,
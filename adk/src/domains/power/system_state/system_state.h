@@ -29,6 +29,18 @@ See functions starting transitions like SystemState_Initialise().
 
 Initial state is system_state_powered_off.
 
+Steps of a transition run in table order, an asynchronous step normally blocks
+the steps after it until it completes. An asynchronous step that later steps
+don't depend on can be marked with #system_state_step_overlap, the next steps
+then run while it completes. A step that depends on the overlapped steps before
+it is marked with #system_state_step_wait_overlapped. The transition only
+completes once all its steps have completed.
+
+Each step is logged at debug level with its start time, relative to the start
+of the transition, and its duration, including the wait for an asynchronous
+step to complete. Together these give the timeline of a transition, e.g. of the
+application's initialisation, and show which steps are on its critical path.
+
 @{
 */
 
@@ -81,6 +93,19 @@ typedef bool (*step_function)(Task step_task);
 */
 typedef bool (*step_handler)(Message message);
 
+/*! \brief How a step is ordered with respect to the steps around it */
+typedef enum
+{
+    /*! Asynchronous step that the following steps don't depend on.
+        The next step runs without waiting for the message with
+        async_message_id. */
+    system_state_step_overlap = (1 << 0),
+
+    /*! Wait for all the overlapped steps before this one to complete
+        before running it. */
+    system_state_step_wait_overlapped = (1 << 1),
+} system_state_step_flags_t;
+
 /*! \brief Transition step table entry
  */
 typedef struct
@@ -88,6 +113,7 @@ typedef struct
     step_function step; /*!< Step function to call. */
     uint16 async_message_id; /*!< Message ID to wait for, 0 if no message required */
     step_handler async_handler; /*!< Function to call when message with above ID is received. */
+    uint16 flags; /*!< Ordering of the step, see #system_state_step_flags_t. 0 to run after all previous steps have completed. */
 } system_state_step_t;
 
 typedef enum
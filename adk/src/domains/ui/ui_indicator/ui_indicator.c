@@ -14,6 +14,15 @@
 
 #include <logging.h>
 #include <domain_message.h>
+#include <panic.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*! Multiplier of the hash function tried first, 2^16 divided by the golden ratio. */
+#define UI_INDICATOR_LOOKUP_MULTIPLIER          (0x9E37)
+
+/*! Number of hash multipliers tried in search of one without collisions. */
+#define UI_INDICATOR_LOOKUP_MULTIPLIER_ATTEMPTS (32)
 
 bool UiIndicator_GetIndexFromMappingTable(const ui_event_indicator_table_t *mapping_table, uint16 mapping_table_size, MessageId id, uint16 * index)
 {
@@ -29,6 +38,126 @@ bool UiIndicator_GetIndexFromMappingTable(const ui_event_indicator_table_t *mapp
     return found;
 }
 
+static uint16 uiIndicator_HashSlot(const ui_indicator_lookup_t *lookup, MessageId id)
+{
+    return (uint16)((uint32)id * lookup->multiplier) >> (16 - lookup->bits);
+}
+
+/*! \brief Fill the hash slots using the given multiplier.
+    \return The most slots searched to find any System Event in the table. */
+static uint8 uiIndicator_FillLookupSlots(ui_indicator_lookup_t *lookup,
+                                         const ui_event_indicator_table_t *mapping_table,
+                                         uint16 mapping_table_size,
+                                         uint16 multiplier)
+{
+    uint16 slot_mask = (1U << lookup->bits) - 1;
+    uint8 max_probes = 0;
+
+    memset(lookup->slots, 0, 1U << lookup->bits);
+    lookup->multiplier = multiplier;
+
+    for (uint16 index = 0; index < mapping_table_size; index++)
+    {
+        MessageId sys_event = mapping_table[index].sys_event;
+        uint16 slot = uiIndicator_HashSlot(lookup, sys_event);
+        uint8 probes = 1;
+
+        while (lookup->slots[slot] != 0)
+        {
+            uint16 other = lookup->slots[slot] - 1;
+
+            if (mapping_table[other].sys_event == sys_event)
+            {
+                DEBUG_LOG_ERROR("UiIndicator_BuildMappingTableLookup sys_event 0x%04x at index %u is unreachable, already at index %u",
+                                sys_event, index, other);
+                Panic();
+            }
+            slot = (slot + 1) & slot_mask;
+            probes++;
+        }
+
+        lookup->slots[slot] = index + 1;
+        max_probes = MAX(max_probes, probes);
+    }
+
+    return max_probes;
+}
+
+void UiIndicator_BuildMappingTableLookup(ui_indicator_lookup_t *lookup, const ui_event_indicator_table_t *mapping_table, uint16 mapping_table_size)
+{
+    uint16 best_multiplier = UI_INDICATOR_LOOKUP_MULTIPLIER;
+    uint8 best_probes = 0xFF;
+
+    UiIndicator_FreeMappingTableLookup(lookup);
+
+    if (mapping_table_size == 0)
+    {
+        return;
+    }
+
+    /* The slots hold the index plus one */
+    PanicFalse(mapping_table_size <= 0xFF);
+
+    /* At least twice as many slots as events keeps the search for a
+       multiplier without collisions short */
+    lookup->bits = 1;
+    while ((1U << lookup->bits) < 2 * mapping_table_size)
+    {
+        lookup->bits++;
+    }
+    lookup->slots = PanicUnlessMalloc(1U << lookup->bits);
+
+    for (uint8 attempt = 0; attempt < UI_INDICATOR_LOOKUP_MULTIPLIER_ATTEMPTS && best_probes > 1; attempt++)
+    {
+        /* Odd multipliers only, an even one would waste the lowest bit of the event */
+        uint16 multiplier = UI_INDICATOR_LOOKUP_MULTIPLIER + 2 * attempt;
+        uint8 probes = uiIndicator_FillLookupSlots(lookup, mapping_table, mapping_table_size, multiplier);
+
+        if (probes < best_probes)
+        {
+            best_probes = probes;
+            best_multiplier = multiplier;
+        }
+    }
+
+    if (lookup->multiplier != best_multiplier)
+    {
+        uiIndicator_FillLookupSlots(lookup, mapping_table, mapping_table_size, best_multiplier);
+    }
+    lookup->max_probes = best_probes;
+
+    DEBUG_LOG("UiIndicator_BuildMappingTableLookup %u events, %u slots, multiplier 0x%04x, max probes %u",
+              mapping_table_size, 1U << lookup->bits, lookup->multiplier, lookup->max_probes);
+}
+
+void UiIndicator_FreeMappingTableLookup(ui_indicator_lookup_t *lookup)
+{
+    free(lookup->slots);
+    memset(lookup, 0, sizeof(*lookup));
+}
+
+bool UiIndicator_GetIndexFromMappingTableLookup(const ui_indicator_lookup_t *lookup, const ui_event_indicator_table_t *mapping_table, MessageId id, uint16 * index)
+{
+    if (lookup->slots != NULL)
+    {
+        uint16 slot_mask = (1U << lookup->bits) - 1;
+        uint16 slot = uiIndicator_HashSlot(lookup, id);
+
+        for (uint8 probes = 0; probes < lookup->max_probes && lookup->slots[slot] != 0; probes++)
+        {
+            uint16 candidate = lookup->slots[slot] - 1;
+
+            if (mapping_table[candidate].sys_event == id)
+            {
+                *index = candidate;
+                return TRUE;
+            }
+            slot = (slot + 1) & slot_mask;
+        }
+    }
+    return FALSE;
+}
+
 const ui_ind_data_t* UiIndicator_GetDataForIndex(const ui_event_indicator_table_t *mapping_table, uint16 mapping_table_size, uint16 index)
 {
     const ui_ind_data_t* data = NULL;
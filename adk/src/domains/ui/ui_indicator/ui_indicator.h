@@ -94,6 +94,28 @@ typedef struct {
 
 } ui_repeating_indication_table_t;
 
+/*! \brief Hash index of a System Event to UI Indication configuration table.
+
+    Built once when the table is configured, so looking up a System Event
+    costs a hash and, normally, a single comparison rather than a search of
+    the whole table.
+*/
+typedef struct
+{
+    /*! For each hash slot, the index plus one of the table entry, 0 if empty. */
+    uint8 *slots;
+
+    /*! Log2 of the number of hash slots. */
+    uint8 bits;
+
+    /*! Most slots searched to find any System Event in the table. */
+    uint8 max_probes;
+
+    /*! Multiplier of the hash function. */
+    uint16 multiplier;
+
+} ui_indicator_lookup_t;
+
 /*! \brief Get the index in the table, if present, for the specified System Event.
 
     \param mapping_table The configuration table mapping System Events to UI Indication data
@@ -108,6 +130,41 @@ bool UiIndicator_GetIndexFromMappingTable(
         MessageId id,
         uint16 * index);
 
+/*! \brief Build the hash index of a configuration table.
+
+    Any index the lookup already held is freed first. Panics if a System Event
+    appears more than once in the table, as only its first UI Indication could
+    ever be found.
+
+    \param lookup The hash index to build
+    \param mapping_table The configuration table mapping System Events to UI Indication data
+    \param mapping_table_size The length of the configuration table (i.e. the number of configured UI Indications)
+*/
+void UiIndicator_BuildMappingTableLookup(
+        ui_indicator_lookup_t * lookup,
+        const ui_event_indicator_table_t * mapping_table,
+        uint16 mapping_table_size);
+
+/*! \brief Free the hash index of a configuration table.
+
+    \param lookup The hash index to free
+*/
+void UiIndicator_FreeMappingTableLookup(ui_indicator_lookup_t * lookup);
+
+/*! \brief Get the index in the table, if present, for the specified System Event, using the hash index of the table.
+
+    \param lookup The hash index built by UiIndicator_BuildMappingTableLookup() for the table
+    \param mapping_table The configuration table mapping System Events to UI Indication data
+    \param id The System Event to lookup in the configuration table.
+    \param index a pointer to the index of the UI Indication in the configuration table
+    \return Boolean indicating whether the System Event was present in the configuration table
+*/
+bool UiIndicator_GetIndexFromMappingTableLookup(
+        const ui_indicator_lookup_t * lookup,
+        const ui_event_indicator_table_t * mapping_table,
+        MessageId id,
+        uint16 * index);
+
 /*! \brief Get the properties of a specific UI Indication from the configuration table.
 
     \param mapping_table The configuration table mapping System Events to UI Indication data
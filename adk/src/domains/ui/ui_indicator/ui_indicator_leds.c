@@ -22,9 +22,9 @@ ui_leds_task_data_t the_leds;
 
 static bool uiLeds_GetLedIndexFromMappingTable(MessageId id, uint16 * led_index)
 {
-    return UiIndicator_GetIndexFromMappingTable(
+    return UiIndicator_GetIndexFromMappingTableLookup(
+                &the_leds.event_mapping_table_lookup,
                 the_leds.sys_event_to_led_data_mappings,
-                the_leds.event_mapping_table_size,
                 id,
                 led_index);
 }
@@ -311,6 +311,11 @@ void UiLeds_SetLedConfiguration(const ui_event_indicator_table_t *ui_event_table
     the_leds.sys_event_to_led_data_mappings = ui_event_table;
     the_leds.event_mapping_table_size = ui_event_table_size;
 
+    UiIndicator_BuildMappingTableLookup(
+                &the_leds.event_mapping_table_lookup,
+                the_leds.sys_event_to_led_data_mappings,
+                the_leds.event_mapping_table_size);
+
     UiIndicator_RegisterInterestInConfiguredSystemEvents(
                 the_leds.sys_event_to_led_data_mappings,
                 the_leds.event_mapping_table_size,
@@ -40,6 +40,9 @@ typedef struct
     const ui_event_indicator_table_t * sys_event_to_led_data_mappings;
     uint8 event_mapping_table_size;
 
+    /*! Hash index of sys_event_to_led_data_mappings. */
+    ui_indicator_lookup_t event_mapping_table_lookup;
+
     /*! The configuration table of System Event to LED flash patterns, passed from the Application. */
     const ui_provider_context_consumer_indicator_table_t * context_to_led_data_mappings;
     uint8 context_mapping_table_size;
@@ -96,9 +96,9 @@ static const ui_prompt_data_t *uiPrompts_GetDataForUserPrompt(MessageId id)
 
 static bool uiPrompts_GetPromptIndexFromMappingTable(MessageId id, uint16 *prompt_index)
 {
-    return UiIndicator_GetIndexFromMappingTable(
+    return UiIndicator_GetIndexFromMappingTableLookup(
+                &the_prompts.mapping_table_lookup,
                 the_prompts.sys_event_to_prompt_data_mappings,
-                the_prompts.mapping_table_size,
                 id,
                 prompt_index);
 }
@@ -377,6 +377,11 @@ void UiPrompts_SetPromptConfiguration(const ui_event_indicator_table_t *table, u
     the_prompts.sys_event_to_prompt_data_mappings = table;
     the_prompts.mapping_table_size = size;
 
+    UiIndicator_BuildMappingTableLookup(
+                &the_prompts.mapping_table_lookup,
+                the_prompts.sys_event_to_prompt_data_mappings,
+                the_prompts.mapping_table_size);
+
     UiIndicator_RegisterInterestInConfiguredSystemEvents(
                 the_prompts.sys_event_to_prompt_data_mappings,
                 the_prompts.mapping_table_size,
@@ -427,6 +432,7 @@ bool UiPrompts_DeInit(void)
 
     the_prompts.sys_event_to_prompt_data_mappings = NULL;
     the_prompts.mapping_table_size = 0;
+    UiIndicator_FreeMappingTableLookup(&the_prompts.mapping_table_lookup);
 
     return TRUE;
 }
@@ -61,6 +61,9 @@ typedef struct
     const ui_event_indicator_table_t * sys_event_to_prompt_data_mappings;
     uint8 mapping_table_size;
 
+    /*! Hash index of sys_event_to_prompt_data_mappings. */
+    ui_indicator_lookup_t mapping_table_lookup;
+
     /*! This is a hold off time for after a voice prompt is played, in milliseconds. When a voice prompt
     is played, for the period of time specified, any repeat of this prompt will not be played. If the no
     repeat period set to zero, then all prompts will be played, regardless of whether the prompt was
@@ -45,9 +45,9 @@ static bool uiTones_IsRepeatingIndication(uint16 tone_index)
 
 static bool uiTones_GetToneIndexFromMappingTable(MessageId id, uint16 * tone_index)
 {
-    return UiIndicator_GetIndexFromMappingTable(
+    return UiIndicator_GetIndexFromMappingTableLookup(
+                &the_tones.mapping_table_lookup,
                 the_tones.sys_event_to_tone_data_mappings,
-                the_tones.mapping_table_size,
                 id,
                 tone_index);
 }
@@ -367,6 +367,11 @@ void UiTones_SetToneConfiguration(const ui_event_indicator_table_t * table,
     the_tones.configured_reminder_tone_mappings = reminder_table;
     the_tones.reminder_table_size = reminder_size;
 
+    UiIndicator_BuildMappingTableLookup(
+                &the_tones.mapping_table_lookup,
+                the_tones.sys_event_to_tone_data_mappings,
+                the_tones.mapping_table_size);
+
     UiIndicator_RegisterInterestInConfiguredSystemEvents(
                 the_tones.sys_event_to_tone_data_mappings,
                 the_tones.mapping_table_size,
@@ -409,6 +414,7 @@ bool UiTones_DeInit(void)
 
     the_tones.sys_event_to_tone_data_mappings = NULL;
     the_tones.mapping_table_size = 0;
+    UiIndicator_FreeMappingTableLookup(&the_tones.mapping_table_lookup);
 
     return TRUE;
 }
@@ -38,6 +38,9 @@ typedef struct
     const ui_event_indicator_table_t * sys_event_to_tone_data_mappings;
     uint8 mapping_table_size;
 
+    /*! Hash index of sys_event_to_tone_data_mappings. */
+    ui_indicator_lookup_t mapping_table_lookup;
+
     /*! Repeating tone reminders configuration table. */
     const ui_repeating_indication_table_t * configured_reminder_tone_mappings;
     uint8 reminder_table_size;
@@ -20,6 +20,7 @@
 #include <usb_audio.h>
 #include <usb_audio_class_10_descriptors.h>
 #include <usb_audio_class_10_default_descriptors.h>
+#include <usb_audio_class_20_default_descriptors.h>
 #include <usb_app_ucq_descriptor.h>
 
 #include "logging.h"
@@ -28,7 +29,11 @@
 
 static const usb_audio_config_params_t usb_audio_voice_config =
 {
+#ifdef USB_SUPPORTS_UAC2
+    .rev                     = USB_AUDIO_CLASS_REV_2,
+#else
     .rev                     = USB_AUDIO_CLASS_REV_1,
+#endif
     .volume_config.min_db    = -45,
     .volume_config.max_db    = 0,
     .volume_config.target_db = -9,
@@ -37,7 +42,9 @@ static const usb_audio_config_params_t usb_audio_voice_config =
     .max_latency_ms          = 40,
     .target_latency_ms       = 30,
 
-#ifdef USB_SUPPORTS_HD_AUDIO
+#if defined(USB_SUPPORTS_UAC2)
+    .intf_list = &uac2_hd_music_spkr_voice_mic_interfaces
+#elif defined(USB_SUPPORTS_HD_AUDIO)
     .intf_list = &uac1_hd_music_spkr_voice_mic_interfaces
 #else
     .intf_list = &uac1_music_spkr_voice_mic_interfaces
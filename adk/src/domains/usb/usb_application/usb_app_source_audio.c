@@ -21,6 +21,7 @@
 #include <usb_audio.h>
 #include <usb_audio_class_10_descriptors.h>
 #include <usb_audio_class_10_default_descriptors.h>
+#include <usb_audio_class_20_default_descriptors.h>
 #include "usb_app_ucq_descriptor.h"
 
 #include "logging.h"
@@ -34,7 +35,11 @@ extern usb_audio_interface_config_list_t usb_source_music_voice_interfaces;
 
 const usb_audio_config_params_t usb_source_audio_config =
 {
+#ifdef USB_SUPPORTS_UAC2
+    .rev                     = USB_AUDIO_CLASS_REV_2,
+#else
     .rev                     = USB_AUDIO_CLASS_REV_1,
+#endif
     .volume_config.min_db    = -45,
     .volume_config.max_db    = 0,
     .volume_config.target_db = 0,
@@ -43,7 +48,11 @@ const usb_audio_config_params_t usb_source_audio_config =
     .max_latency_ms          = 150,
     .target_latency_ms       = 90,
 
+#ifdef USB_SUPPORTS_UAC2
+    .intf_list = &uac2_hd_music_spkr_voice_mic_interfaces
+#else
     .intf_list = &usb_source_music_voice_interfaces
+#endif
 };
 
 
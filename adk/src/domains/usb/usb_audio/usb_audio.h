@@ -26,11 +26,12 @@
 
 /*!
    \brief USB Audio Class revision. This is passed in USB Audio create API.
-    Note: At present only USB Audio Class Specification 1.0 is supported.
 */
 typedef enum
 {
-    USB_AUDIO_CLASS_REV_1    = 0x1
+    USB_AUDIO_CLASS_REV_1    = 0x1,
+    /*! Speaker interfaces use an asynchronous endpoint with explicit feedback */
+    USB_AUDIO_CLASS_REV_2    = 0x2
 } usb_audio_class_rev_t;
 
 /*! 
@@ -177,6 +178,14 @@ typedef struct
 
     /*! Audio interface type */
     usb_audio_device_type_t type;
+
+    /*! Sampling rates of the interface clock, highest first. Only used with
+     *  USB_AUDIO_CLASS_REV_2, where the rates are not part of the
+     *  Audio Streaming descriptors. */
+    const uint32 *sample_rates;
+
+    /*! Number of entries in sample_rates */
+    uint8 num_sample_rates;
 } usb_audio_interface_config_t;
 
 /*! \brief Configuration for one or more Audio interfaces */
@@ -281,6 +290,21 @@ bool UsbAudio_SetAudioChainBusy(Source source);
  */
 void UsbAudio_ClearAudioChainBusy(Source source);
 
+/*! \brief Report the rate at which audio is consumed from a speaker interface.
+
+    With USB_AUDIO_CLASS_REV_2 the device clocks the speaker stream and tells
+    the host through the feedback endpoint how many samples to send in each
+    frame. While a headphone chain is active the driver calls this once a
+    second with the rate measured by the audio chain; until the first
+    measurement the nominal sampling rate is reported.
+
+    \param source Speaker source
+    \param deviation_ppm Measured rate minus the nominal sampling rate, in
+           parts per million of the nominal rate
+    \return TRUE if the speaker interface has a feedback endpoint
+ */
+bool UsbAudio_SetMeasuredRateDeviation(Source source, int32 deviation_ppm);
+
 /*! \brief Get a handle to the USB device.
 
     \return The device handle if a USB device is found, NULL otherwise.
@@ -80,6 +80,8 @@ typedef struct
     void (*SetInterface)(uac_ctx_t class_ctx, uint16 interface, uint16 alt_setting);
     bool (*Reset)(uac_ctx_t class_ctx);
     bool (*Delete)(uac_ctx_t class_ctx);
+    /*! Optional, for class drivers with feedback endpoints */
+    bool (*SetRateDeviation)(uac_ctx_t class_ctx, uint8 interface_index, int32 deviation_ppm);
 } usb_fn_tbl_uac_if;
 
 
@@ -0,0 +1,1178 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+                All Rights Reserved.\n
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file
+    \ingroup    usb_audio
+    \brief      USB Audio Class 2.0 Driver
+
+    Differences from the USB Audio Class 1.0 driver:
+    - interfaces are grouped by an Interface Association Descriptor,
+    - the sampling rate is a control of a Clock Source entity, which reports
+      the supported rates with a RANGE request,
+    - speaker (OUT) data endpoints are asynchronous. Each one is paired with
+      an explicit feedback endpoint, through which the device tells the host
+      how many samples to send per frame, so that the host follows the audio
+      clock of the device rather than the other way round.
+*/
+
+#include <message.h>
+#include <panic.h>
+#include <sink.h>
+#include <source.h>
+#include <string.h>
+#include <stream.h>
+#include <usb.h>
+#include <vmtypes.h>
+#include <stdlib.h>
+#include "logging.h"
+
+#include "usb_device_utils.h"
+#include "usb_audio_class_20.h"
+#include "usb_audio_class_20_descriptors.h"
+
+/* Audio Device Class Request Codes */
+#define REQ_CUR             0x01
+#define REQ_RANGE           0x02
+
+/* Helpers */
+#define REQ_CS(req)         (req.wValue >> 8)
+#define REQ_CN(req)         (req.wValue & 0xFF)
+#define REQ_UNIT(req)       (req.wIndex >> 8)
+#define REQ_INTERFACE(req)  (req.wIndex & 0xFF)
+#define REQ_IS_GET(req)     (req.bmRequestType & 0x80)
+
+#define USB_AUDIO_PACKET_RATE_HZ    1000
+
+/* Packets of an asynchronous endpoint may carry one sample more than the
+ * nominal number of samples per frame, rounded up. */
+#define UAC2_MAX_PACKET_SIZE(sample_rate_hz, channels, subslot_size) \
+    ((((sample_rate_hz) + USB_AUDIO_PACKET_RATE_HZ - 1) / USB_AUDIO_PACKET_RATE_HZ + 1) * \
+     (subslot_size) * (channels))
+
+/*! Largest number of sampling rates of a clock, sizes the RANGE response */
+#define UAC2_MAX_SAMPLE_RATES       8
+
+/*! Size of a RANGE response with \p n subranges of \p size bytes each */
+#define UAC2_RANGE_SIZE(n, size)    (2 + (n) * 3 * (size))
+
+/*! Host requested rate is kept within this many ppm of the nominal rate */
+#define UAC2_FEEDBACK_MAX_DEVIATION_PPM     1000
+
+/*! Feedback values queued when streaming starts, so that the host always
+    finds one when it polls the feedback endpoint */
+#define UAC2_FEEDBACK_PACKETS_QUEUED        2
+
+/*!  See usbAudioClass20_EnumerateStreaming() */
+#define INTF_DESC_INDEX_FROM_ALT_SETTINGS(alt_setting)     ((alt_setting)? (alt_setting)- 1:(alt_setting))
+
+#define I_INTERFACE_INDEX 0x00
+
+/*! USB Audio Class 2.0: 4.9.2 Class-Specific AS Interface Descriptor
+    This is only used for accessing descriptor values not for allocating memory */
+typedef struct
+{
+    uint8 bLength;
+    uint8 bDescriptorType;
+    uint8 bDescriptorSubtype;
+    uint8 bTerminalLink;
+    uint8 bmControls;
+    uint8 bFormatType;
+    uint8 bmFormats[4];
+    uint8 bNrChannels;
+    uint8 bmChannelConfig[4];
+    uint8 iChannelNames;
+} uac2_as_general_descriptor_t;
+
+/*! USB Audio Data Formats 2.0: 2.3.1.6 Type I Format Type Descriptor
+    This is only used for accessing descriptor values not for allocating memory */
+typedef struct
+{
+    uint8 bLength;
+    uint8 bDescriptorType;
+    uint8 bDescriptorSubtype;
+    uint8 bFormatType;
+    uint8 bSubslotSize;
+    uint8 bBitResolution;
+} uac2_format_descriptor_t;
+
+/*! Clock Source, Unit and Terminal descriptors all start with these */
+typedef struct
+{
+    uint8 bLength;
+    uint8 bDescriptorType;
+    uint8 bDescriptorSubtype;
+    uint8 bEntityID;
+} uac2_entity_descriptor_t;
+
+/*! State of a streaming interface not held in usb_audio_streaming_info_t */
+typedef struct
+{
+    /*! Feedback endpoint sink, 0 for interfaces without feedback */
+    Sink    feedback_sink;
+    /*! Measured rate minus nominal rate, in ppm */
+    int32   deviation_ppm;
+    /*! Clock Source of the interface */
+    uint8   clock_id;
+} uac2_stream_t;
+
+/*! USB audio device class state. */
+typedef struct uac2_data_t
+{
+    const usb_audio_config_params_t *config;
+    usb_audio_streaming_info_t      *streaming_info;
+    uac2_stream_t                   *streams;
+
+    uint8                    header_desc[UAC2_AC_IF_HEADER_DESC_SIZE];
+    uint8                    iad_desc[UAC2_IAD_DESC_SIZE];
+    Source                   control_source;
+    UsbInterface             control_interface;
+    uint8                    num_interfaces;
+
+    uac_event_handler_t      evt_handler;
+    struct uac2_data_t *     next;
+} uac2_data_t;
+
+static const UsbCodes uac2_codes_ac = {
+    UAC_IF_CLASS_AUDIO, /* bInterfaceClass */
+    UAC_IF_SUBCLASS_AUDIOCONTROL, /* bInterfaceSubClass */
+    UAC2_PROTOCOL_IP_VERSION_02_00, /* bInterfaceProtocol */
+    I_INTERFACE_INDEX /* iInterface */
+};
+
+static const UsbCodes uac2_codes_as = {
+    UAC_IF_CLASS_AUDIO, /* bInterfaceClass */
+    UAC_IF_SUBCLASS_AUDIOSTREAMING, /* bInterfaceSubClass */
+    UAC2_PROTOCOL_IP_VERSION_02_00, /* bInterfaceProtocol */
+    I_INTERFACE_INDEX /* iInterface */
+};
+
+static void usbAudioClass20_ControlHandler(Task task, MessageId id, Message message);
+static void usbAudioClass20_StreamingHandler(Task task, MessageId id, Message message);
+static void usbAudioClass20_FeedbackHandler(Task task, MessageId id, Message message);
+
+static TaskData uac2_control_task = { usbAudioClass20_ControlHandler };
+static TaskData uac2_streaming_task = { usbAudioClass20_StreamingHandler };
+static TaskData uac2_feedback_task = { usbAudioClass20_FeedbackHandler };
+
+static uac2_data_t *uac2_class_info = NULL;
+
+/****************************************************************************
+    To create an instance of audio class
+*/
+static uac2_data_t * usbAudioClass20_GetNewInstance(void)
+{
+    uac2_data_t *uac_info = (uac2_data_t *)PanicUnlessMalloc(sizeof(uac2_data_t));
+    memset(uac_info, 0, sizeof(uac2_data_t));
+
+    uac_info->next = uac2_class_info;
+    uac2_class_info = uac_info;
+    return uac_info;
+}
+
+/****************************************************************************
+    To check the audio class context is still valid
+*/
+static uac2_data_t * usbAudioClass20_FindInstance(uac_ctx_t class_ctx)
+{
+    uac2_data_t *uac_info = uac2_class_info;
+    while (uac_info)
+    {
+        if (uac_info == (uac2_data_t *)class_ctx)
+        {
+            return uac_info;
+        }
+        uac_info = uac_info->next;
+    }
+    return NULL;
+}
+
+/****************************************************************************
+    To get audio class context from control source
+*/
+static uac2_data_t * usbAudioClass20_GetInfoFromControlSource(Source source)
+{
+    uac2_data_t *uac_info = uac2_class_info;
+    while (uac_info)
+    {
+        if (uac_info->control_source == source)
+        {
+            return uac_info;
+        }
+        uac_info = uac_info->next;
+    }
+    return NULL;
+}
+
+/****************************************************************************
+    To get audio class context from streaming source
+*/
+static uac2_data_t * usbAudioClass20_GetInfoFromStreamingSource(Source source)
+{
+    uac2_data_t *uac_info = uac2_class_info;
+    while (uac_info)
+    {
+        for (uint8 i=0; i < uac_info->num_interfaces; i++)
+        {
+            if (uac_info->streaming_info[i].source == source)
+            {
+                return uac_info;
+            }
+        }
+        uac_info = uac_info->next;
+    }
+    return NULL;
+}
+
+/****************************************************************************
+    To get audio class context from feedback endpoint sink, also returns interface index
+*/
+static uac2_data_t * usbAudioClass20_GetInfoFromFeedbackSink(Sink sink, uint8 *intf_index_ptr)
+{
+    uac2_data_t *uac_info = uac2_class_info;
+    while (uac_info)
+    {
+        for (uint8 i=0; i < uac_info->num_interfaces; i++)
+        {
+            if (uac_info->streams[i].feedback_sink == sink)
+            {
+                *intf_index_ptr = i;
+                return uac_info;
+            }
+        }
+        uac_info = uac_info->next;
+    }
+    return NULL;
+}
+
+/****************************************************************************
+    To get the index of the interface a Clock Source or Feature Unit belongs to
+*/
+static bool usbAudioClass20_GetIntfIndexFromEntityID(uac2_data_t *uac_info, uint8 entity_id,
+                                                     bool *is_clock, uint8 *intf_index_ptr)
+{
+    for (uint8 i=0; i < uac_info->num_interfaces; i++)
+    {
+        if (uac_info->streams[i].clock_id == entity_id ||
+            uac_info->streaming_info[i].feature_unit_id == entity_id)
+        {
+            *is_clock = (uac_info->streams[i].clock_id == entity_id);
+            *intf_index_ptr = i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Parse AudioControl descriptors and find the id of the first entity of a type
+ */
+static bool usbAudioClass20_GetEntityID(const uac_control_config_t *control_desc,
+                                        uint8 subtype, uint8 *entity_id_ptr)
+{
+    const uint8 *ptr = control_desc->descriptor;
+    const uint8 *end = ptr + control_desc->size_descriptor;
+
+    while (ptr < end)
+    {
+        const uac2_entity_descriptor_t *desc = (const uac2_entity_descriptor_t *)ptr;
+
+        if (desc->bDescriptorType == UAC_CS_DESC_INTERFACE &&
+            desc->bDescriptorSubtype == subtype)
+        {
+            *entity_id_ptr = desc->bEntityID;
+            return TRUE;
+        }
+        ptr += desc->bLength;
+    }
+    return FALSE;
+}
+
+/*
+ * Parse AudioStreaming descriptors and return the descriptor of a subtype
+ */
+static const uint8 *usbAudioClass20_GetStreamingDescriptor(const uac_streaming_config_t *streaming_config,
+                                                           uint8 subtype)
+{
+    const uint8 *ptr = streaming_config->intf_descriptor;
+    const uint8 *end = ptr + streaming_config->size_descriptor;
+
+    while (ptr < end)
+    {
+        const uac2_entity_descriptor_t *desc = (const uac2_entity_descriptor_t *)ptr;
+
+        if (desc->bDescriptorType == UAC_CS_DESC_INTERFACE &&
+            desc->bDescriptorSubtype == subtype)
+        {
+            return ptr;
+        }
+        ptr += desc->bLength;
+    }
+    return NULL;
+}
+
+/****************************************************************************
+    To read channels and subslot size of an alternate setting
+*/
+static void usbAudioClass20_GetFormat(const uac_streaming_config_t *streaming_config,
+                                      uint8 *channels, uint8 *subslot_size)
+{
+    const uac2_as_general_descriptor_t *general = (const uac2_as_general_descriptor_t *)
+            PanicNull((void *)usbAudioClass20_GetStreamingDescriptor(streaming_config, UAC_AS_DESC_GENERAL));
+    const uac2_format_descriptor_t *format = (const uac2_format_descriptor_t *)
+            PanicNull((void *)usbAudioClass20_GetStreamingDescriptor(streaming_config, UAC_AS_DESC_FORMAT_TYPE));
+
+    *channels = general->bNrChannels;
+    *subslot_size = format->bSubslotSize;
+}
+
+/****************************************************************************
+    To check a sampling rate is supported by the interface clock
+*/
+static bool usbAudioClass20_IsSamplingRateSupported(const usb_audio_interface_config_t *intf_config,
+                                                    uint32 sampling_rate)
+{
+    for (uint8 i = 0; i < intf_config->num_sample_rates; i++)
+    {
+        if (intf_config->sample_rates[i] == sampling_rate)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/****************************************************************************
+    To get maximum sampling rate supported by the interface clock
+*/
+static uint32 usbAudioClass20_GetMaxSamplingRate(const usb_audio_interface_config_t *intf_config)
+{
+    uint32 max_rate = 0;
+
+    for (uint8 i = 0; i < intf_config->num_sample_rates; i++)
+    {
+        max_rate = MAX(max_rate, intf_config->sample_rates[i]);
+    }
+    return max_rate;
+}
+
+/****************************************************************************
+    To write a response of at most max_length bytes to sink
+*/
+static uint16 usbAudioClass20_WriteResponse(Sink sink, const uint8 *data,
+                                            uint16 length, uint16 max_length)
+{
+    uint8 *ptr;
+
+    length = MIN(length, max_length);
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    ptr = SinkMapClaim(sink, length);
+    if (ptr == NULL)
+    {
+        DEBUG_LOG_WARN("UAC2_WriteResponse: SinkClaim Failed");
+        return 0;
+    }
+    memcpy(ptr, data, length);
+    return length;
+}
+
+/****************************************************************************
+    To round the gain based on volume configuration.
+*/
+static int8 usbAudioClass20_RoundVolume(const usb_audio_volume_config_t *volume_config,
+                                        int8 volume)
+{
+    int8 max_db = volume_config->max_db;
+    int8 min_db = volume_config->min_db;
+    uint8 res_db = volume_config->res_db;
+
+    /* Don't round up to maximum or round down to minimum to avoid
+     * max/min prompts when host volume is at 99% / 1%. */
+
+    if (volume >= max_db)
+    {
+        return max_db;
+    }
+    else if (volume <= min_db)
+    {
+        return min_db;
+    }
+    /* round up volumes in the range (min_db, min_db + res_db] */
+    else if (volume <= min_db + res_db)
+    {
+        return (int8)(min_db + res_db);
+    }
+
+    /* this code rounds down, so values [max_db - res_db, max_db) are fine. */
+    return (int8)(min_db + (volume - min_db) / res_db * res_db);
+}
+
+/****************************************************************************
+    To handle a request to a Clock Source
+*/
+static bool usbAudioClass20_HandleClockRequest(uac2_data_t *uac_info, uint8 intf_index,
+                                               UsbResponse *usbresp, Source req, Sink sink)
+{
+    const usb_audio_interface_config_t *intf_config = &uac_info->config->intf_list->intf[intf_index];
+    usb_audio_streaming_info_t *streaming_info = &uac_info->streaming_info[intf_index];
+    uint8 control = REQ_CS(usbresp->original_request);
+    uint8 code = usbresp->original_request.bRequest;
+    uint16 max_length = usbresp->original_request.wLength;
+
+    if (REQ_IS_GET(usbresp->original_request))
+    {
+        if (control == UAC2_CS_CONTROL_SAM_FREQ && code == REQ_CUR)
+        {
+            uint8 rate[] = { UAC2_U32(streaming_info->current_sampling_rate) };
+
+            DEBUG_LOG_STATE("UAC2_Clock: Get intf - %d Rate %lu",
+                            streaming_info->interface, streaming_info->current_sampling_rate);
+            usbresp->data_length = usbAudioClass20_WriteResponse(sink, rate, sizeof(rate), max_length);
+        }
+        else if (control == UAC2_CS_CONTROL_SAM_FREQ && code == REQ_RANGE)
+        {
+            uint8 range[UAC2_RANGE_SIZE(UAC2_MAX_SAMPLE_RATES, 4)];
+            uint8 *ptr = range;
+
+            *ptr++ = intf_config->num_sample_rates;
+            *ptr++ = 0;
+            for (uint8 i = 0; i < intf_config->num_sample_rates; i++)
+            {
+                /* Each discrete rate is a subrange with equal MIN and MAX */
+                uint8 subrange[] = { UAC2_U32(intf_config->sample_rates[i]),
+                                     UAC2_U32(intf_config->sample_rates[i]),
+                                     UAC2_U32(0) };
+                memcpy(ptr, subrange, sizeof(subrange));
+                ptr += sizeof(subrange);
+            }
+            usbresp->data_length = usbAudioClass20_WriteResponse(sink, range, (uint16)(ptr - range), max_length);
+        }
+        else if (control == UAC2_CS_CONTROL_CLOCK_VALID && code == REQ_CUR)
+        {
+            /* The internal clock is always valid */
+            uint8 valid = TRUE;
+            usbresp->data_length = usbAudioClass20_WriteResponse(sink, &valid, sizeof(valid), max_length);
+        }
+        return (usbresp->data_length != 0);
+    }
+
+    if (control == UAC2_CS_CONTROL_SAM_FREQ && code == REQ_CUR && SourceBoundary(req) == 4)
+    {
+        const uint8 *rate = SourceMap(req);
+        uint32 new_rate = rate[0] | ((uint32)rate[1] << 8) | ((uint32)rate[2] << 16) | ((uint32)rate[3] << 24);
+
+        if (!usbAudioClass20_IsSamplingRateSupported(intf_config, new_rate))
+        {
+            DEBUG_LOG_WARN("UAC2_Clock: Unsupported rate %lu", new_rate);
+            return FALSE;
+        }
+
+        streaming_info->current_sampling_rate = new_rate;
+        DEBUG_LOG_STATE("UAC2_Clock: Set intf - %d Rate %lu", streaming_info->interface, new_rate);
+
+        /* notify change in sample rate */
+        uac_info->evt_handler(uac_info, intf_index, USB_AUDIO_CLASS_MSG_SAMPLE_RATE);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/****************************************************************************
+    To handle a request to a Feature Unit
+*/
+static bool usbAudioClass20_HandleFeatureUnitRequest(uac2_data_t *uac_info, uint8 intf_index,
+                                                     UsbResponse *usbresp, Source req, Sink sink)
+{
+    const usb_audio_volume_config_t *volume_config = &uac_info->config->volume_config;
+    usb_audio_streaming_info_t *streaming_info = &uac_info->streaming_info[intf_index];
+    uint8 control = REQ_CS(usbresp->original_request);
+    uint8 code = usbresp->original_request.bRequest;
+    uint16 max_length = usbresp->original_request.wLength;
+
+    if (REQ_CN(usbresp->original_request) != UAC_CHANNEL_MASTER)
+    {
+        return FALSE;
+    }
+
+    if (REQ_IS_GET(usbresp->original_request))
+    {
+        if (control == UAC_FU_CONTROL_MUTE && code == REQ_CUR)
+        {
+            uint8 mute = streaming_info->volume_status.mute_status;
+            usbresp->data_length = usbAudioClass20_WriteResponse(sink, &mute, sizeof(mute), max_length);
+        }
+        else if (control == UAC_FU_CONTROL_VOLUME && code == REQ_CUR)
+        {
+            /* Volume is in 1/256 dB, only integer values are supported */
+            uint8 volume[] = { 0, (uint8)streaming_info->volume_status.volume_db };
+            usbresp->data_length = usbAudioClass20_WriteResponse(sink, volume, sizeof(volume), max_length);
+        }
+        else if (control == UAC_FU_CONTROL_VOLUME && code == REQ_RANGE)
+        {
+            uint8 range[] = { UAC2_U16(1),
+                              0, (uint8)volume_config->min_db,
+                              0, (uint8)volume_config->max_db,
+                              0, volume_config->res_db };
+            usbresp->data_length = usbAudioClass20_WriteResponse(sink, range, sizeof(range), max_length);
+        }
+        return (usbresp->data_length != 0);
+    }
+
+    if (code == REQ_CUR)
+    {
+        uint16 data_len = SourceBoundary(req);
+        const uint8 *p_src = SourceMap(req);
+
+        if (control == UAC_FU_CONTROL_MUTE && data_len == 1)
+        {
+            streaming_info->volume_status.mute_status = p_src[0] ? 1 : 0;
+            DEBUG_LOG_STATE("UAC2_FeatureUnit: MUTE: intf - %d, VAL - %d",
+                            streaming_info->interface, streaming_info->volume_status.mute_status);
+            return TRUE;
+        }
+        else if (control == UAC_FU_CONTROL_VOLUME && data_len == 2)
+        {
+            /* ignore the low byte with 1/256 db fractions as we only support
+             * integer values. */
+            streaming_info->volume_status.volume_db =
+                    usbAudioClass20_RoundVolume(volume_config, (int8)p_src[1]);
+            DEBUG_LOG_STATE("UAC2_FeatureUnit: VOL: intf - %d, VAL - %d",
+                            streaming_info->interface, streaming_info->volume_status.volume_db);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/****************************************************************************
+    To send the response to a class request
+*/
+static void usbAudioClass20_SendResponse(Sink sink, UsbResponse *usbresp)
+{
+    if (usbresp->data_length)
+    {
+        (void)SinkFlushHeader(sink, usbresp->data_length, (void *)usbresp, sizeof(UsbResponse));
+    }
+    else
+    {
+        /* Sink packets can never be zero-length, so flush a dummy byte */
+        (void)SinkClaim(sink, 1);
+        (void)SinkFlushHeader(sink, 1, (void *)usbresp, sizeof(UsbResponse));
+    }
+}
+
+/****************************************************************************
+    To handle audio control request
+*/
+static void usbAudioClass20_HandleControlClassRequest(uac2_data_t *uac_info)
+{
+    Source req = uac_info->control_source;
+    Sink sink = StreamSinkFromSource(req);
+    uint16 packet_size;
+
+    /* Check for outstanding Class requests */
+    while ((packet_size = SourceBoundary(req)) != 0)
+    {
+        UsbResponse usbresp;
+        uint8 intf_index;
+        bool is_clock;
+        bool is_set;
+
+        memcpy(&usbresp.original_request, SourceMapHeader(req), sizeof(UsbRequest));
+
+        /* Reject by default */
+        usbresp.data_length = 0;
+        usbresp.success = FALSE;
+        is_set = !REQ_IS_GET(usbresp.original_request);
+
+        if (REQ_INTERFACE(usbresp.original_request) == uac_info->control_interface &&
+            usbAudioClass20_GetIntfIndexFromEntityID(uac_info, REQ_UNIT(usbresp.original_request),
+                                                     &is_clock, &intf_index))
+        {
+            if (is_clock)
+            {
+                usbresp.success = usbAudioClass20_HandleClockRequest(uac_info, intf_index,
+                                                                     &usbresp, req, sink);
+            }
+            else
+            {
+                usbresp.success = usbAudioClass20_HandleFeatureUnitRequest(uac_info, intf_index,
+                                                                           &usbresp, req, sink);
+                if (usbresp.success && is_set)
+                {
+                    /* Level has changed, notify application */
+                    uac_info->evt_handler(uac_info, intf_index, USB_AUDIO_CLASS_MSG_LEVELS);
+                }
+            }
+        }
+
+        if (!usbresp.success)
+        {
+            DEBUG_LOG_WARN("UAC2_ControlClassRequest: Unsupported request: bmRequestType 0x%x, "
+                           "bRequest %d, wValue 0x%x, wIndex 0x%x",
+                           usbresp.original_request.bmRequestType, usbresp.original_request.bRequest,
+                           usbresp.original_request.wValue, usbresp.original_request.wIndex);
+        }
+
+        usbAudioClass20_SendResponse(sink, &usbresp);
+
+        /* Discard the original request */
+        SourceDrop(req, packet_size);
+    }
+}
+
+/****************************************************************************
+    To handle audio streaming request. No AudioStreaming interface or endpoint
+    controls are advertised, so all requests are rejected.
+*/
+static void usbAudioClass20_HandleStreamingClassRequest(Source req)
+{
+    Sink sink = StreamSinkFromSource(req);
+    uint16 packet_size;
+
+    while ((packet_size = SourceBoundary(req)) != 0)
+    {
+        UsbResponse usbresp;
+        memcpy(&usbresp.original_request, SourceMapHeader(req), sizeof(UsbRequest));
+        usbresp.success = FALSE;
+        usbresp.data_length = 0;
+
+        DEBUG_LOG_WARN("UAC2_StreamingClassRequest: Unsupported request: bRequest %d, wValue 0x%x",
+                       usbresp.original_request.bRequest, usbresp.original_request.wValue);
+
+        usbAudioClass20_SendResponse(sink, &usbresp);
+        SourceDrop(req, packet_size);
+    }
+}
+
+/****************************************************************************
+    To calculate the number of samples per frame the host is asked to send,
+    in 10.14 format.
+*/
+static uint32 usbAudioClass20_GetFeedbackValue(uint32 sampling_rate, int32 deviation_ppm)
+{
+    uint32 nominal = (sampling_rate << 14) / USB_AUDIO_PACKET_RATE_HZ;
+
+    /* nominal / 16 * ppm / 62500 is nominal * ppm / 1000000 without overflow */
+    return (uint32)((int32)nominal + (int32)(nominal / 16) * deviation_ppm / 62500);
+}
+
+/****************************************************************************
+    To queue the current feedback value for the host to read
+*/
+static void usbAudioClass20_SendFeedback(uac2_data_t *uac_info, uint8 intf_index)
+{
+    uac2_stream_t *stream = &uac_info->streams[intf_index];
+    usb_audio_streaming_info_t *streaming_info = &uac_info->streaming_info[intf_index];
+    uint32 value;
+    uint8 *ptr;
+
+    if (streaming_info->alt_setting == INTF_ALT_SETTING_ZERO ||
+        SinkSlack(stream->feedback_sink) < UAC2_FEEDBACK_SIZE)
+    {
+        return;
+    }
+
+    ptr = SinkMapClaim(stream->feedback_sink, UAC2_FEEDBACK_SIZE);
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    value = usbAudioClass20_GetFeedbackValue(streaming_info->current_sampling_rate,
+                                             stream->deviation_ppm);
+    ptr[0] = (uint8)(value & 0xFF);
+    ptr[1] = (uint8)((value >> 8) & 0xFF);
+    ptr[2] = (uint8)((value >> 16) & 0xFF);
+    (void)SinkFlush(stream->feedback_sink, UAC2_FEEDBACK_SIZE);
+}
+
+/****************************************************************************
+    To handle audio control request from all device indexes
+*/
+static void usbAudioClass20_ControlHandler(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    if (id == MESSAGE_MORE_DATA)
+    {
+        Source class_source = ((MessageMoreData *)message)->source;
+        uac2_data_t *uac_info = usbAudioClass20_GetInfoFromControlSource(class_source);
+        if (uac_info != NULL)
+        {
+            usbAudioClass20_HandleControlClassRequest(uac_info);
+        }
+    }
+}
+
+/****************************************************************************
+    To handle audio streaming request
+*/
+static void usbAudioClass20_StreamingHandler(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    if (id == MESSAGE_MORE_DATA)
+    {
+        Source class_source = ((MessageMoreData *)message)->source;
+        if (usbAudioClass20_GetInfoFromStreamingSource(class_source) != NULL)
+        {
+            usbAudioClass20_HandleStreamingClassRequest(class_source);
+        }
+    }
+}
+
+/****************************************************************************
+    To refill the feedback endpoint each time the host has read a value
+*/
+static void usbAudioClass20_FeedbackHandler(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    if (id == MESSAGE_MORE_SPACE)
+    {
+        uint8 intf_index;
+        uac2_data_t *uac_info = usbAudioClass20_GetInfoFromFeedbackSink(((MessageMoreSpace *)message)->sink,
+                                                                        &intf_index);
+        if (uac_info != NULL)
+        {
+            usbAudioClass20_SendFeedback(uac_info, intf_index);
+        }
+    }
+}
+
+static const uint8 *usbAudioClass20_FindEndpointClassDescriptor(const uint8 *intf_desc,
+                                                                uint16 intf_desc_size)
+{
+    const uint8 *ptr = intf_desc;
+    const uint8 *end = ptr + intf_desc_size;
+
+    while (ptr < end)
+    {
+        const uac2_entity_descriptor_t *desc = (const uac2_entity_descriptor_t *)ptr;
+
+        if (desc->bDescriptorType == UAC_CS_DESC_ENDPOINT)
+        {
+            return ptr;
+        }
+        ptr += desc->bLength;
+    }
+    return NULL;
+}
+
+/****************************************************************************
+ * To add streaming interface for enumeration
+ *
+ * Alternate settings are added as in usbAudioClass10_EnumerateStreaming(),
+ * so streaming_desc_index = (bAlternateSetting - 1) where bAlternateSetting != 0.
+ *
+ * Speaker (from host) interfaces get an asynchronous data endpoint and an
+ * explicit feedback endpoint in every alternate setting. The standard
+ * endpoint descriptors of USB Audio class 2.0 have no extended fields.
+*/
+static void usbAudioClass20_EnumerateStreaming(usb_device_index_t usb_device_index,
+                                               usb_audio_streaming_info_t *streaming_info,
+                                               uac2_stream_t *stream,
+                                               const usb_audio_interface_config_t *intf_config)
+{
+    EndPointInfo ep_info[2];
+    uint16 num_endpoints = 1;
+    bool is_to_host = intf_config->streaming_config[0].endpoint->is_to_host;
+    uint32 max_rate = usbAudioClass20_GetMaxSamplingRate(intf_config);
+
+    if (!usbAudioClass20_GetEntityID(intf_config->control_desc, UAC_AC_DESC_FEATURE_UNIT,
+                                     &streaming_info->feature_unit_id) ||
+        !usbAudioClass20_GetEntityID(intf_config->control_desc, UAC2_AC_DESC_CLOCK_SOURCE,
+                                     &stream->clock_id))
+    {
+        DEBUG_LOG_ERROR("UAC2_EnumerateStreaming: Feature unit or clock id not found");
+        Panic();
+    }
+
+    memset(ep_info, 0, sizeof(ep_info));
+
+    /* USB endpoint information */
+    streaming_info->ep_address = UsbDevice_AllocateEndpointAddress(usb_device_index, is_to_host);
+    ep_info[0].bEndpointAddress = streaming_info->ep_address;
+    ep_info[0].bmAttributes = end_point_attr_iso;
+
+    if (!is_to_host)
+    {
+        ep_info[0].bmAttributes = (EndPointAttr)(end_point_attr_iso | UAC2_EP_SYNC_ASYNC);
+
+        ep_info[1].bEndpointAddress = UsbDevice_AllocateEndpointAddress(usb_device_index, TRUE);
+        ep_info[1].bmAttributes = (EndPointAttr)(end_point_attr_iso | UAC2_EP_USAGE_FEEDBACK);
+        ep_info[1].wMaxPacketSize = UAC2_FEEDBACK_SIZE;
+        ep_info[1].bInterval = 1;
+        num_endpoints = 2;
+    }
+
+    DEBUG_LOG_DEBUG("UAC2_EnumerateStreaming: alt_settings_count  : %d", intf_config->alt_settings_count);
+    PanicZero(intf_config->alt_settings_count);
+
+    for (uint8 index = 0; index < intf_config->alt_settings_count; index++)
+    {
+        const uac_streaming_config_t *streaming_config = &intf_config->streaming_config[index];
+        const uint8 *intf_desc = streaming_config->intf_descriptor;
+        uint16 intf_desc_size = streaming_config->size_descriptor;
+        const uint8 *ep_desc;
+        uint16 ep_desc_size = 0;
+        uint8 channels, subslot_size;
+
+        /* By convention Audio Endpoint Class descriptors are at the tail
+         * of Audio Interface Class descriptors. */
+        ep_desc = usbAudioClass20_FindEndpointClassDescriptor(intf_desc, intf_desc_size);
+        if (ep_desc)
+        {
+            uint16 new_intf_desc_size = (uint16)(ep_desc - intf_desc);
+            assert(new_intf_desc_size < intf_desc_size);
+
+            ep_desc_size = intf_desc_size - new_intf_desc_size;
+            intf_desc_size = new_intf_desc_size;
+        }
+
+        if (index == 0)
+        {
+            streaming_info->interface = UsbAddInterface(&uac2_codes_as, UAC_CS_DESC_INTERFACE,
+                                                        intf_desc, intf_desc_size);
+            if (streaming_info->interface == usb_interface_error)
+            {
+                DEBUG_LOG_ERROR("UAC2_EnumerateStreaming: UsbAddInterface Failed");
+                Panic();
+            }
+        }
+        else if (UsbAddAltInterface(streaming_info->interface, intf_desc, intf_desc_size) ==
+                 usb_alt_interface_error)
+        {
+            DEBUG_LOG_ERROR("UAC2_EnumerateStreaming: UsbAddAltInterface Failed");
+            Panic();
+        }
+
+        usbAudioClass20_GetFormat(streaming_config, &channels, &subslot_size);
+
+        ep_info[0].bInterval = streaming_config->endpoint->bInterval;
+        ep_info[0].wMaxPacketSize = streaming_config->endpoint->wMaxPacketSize ?
+                      streaming_config->endpoint->wMaxPacketSize :
+                      UAC2_MAX_PACKET_SIZE(max_rate, channels, subslot_size);
+
+        if (!UsbAddEndPoints(streaming_info->interface, num_endpoints, ep_info))
+        {
+            DEBUG_LOG_ERROR("UAC2_EnumerateStreaming: UsbAddEndPoints Failed");
+            Panic();
+        }
+
+        if (ep_desc)
+        {
+            uint16 type = ((ep_info[0].bEndpointAddress << 8) | UAC_CS_DESC_ENDPOINT);
+            if (!UsbAddDescriptor(streaming_info->interface, type, ep_desc, ep_desc_size))
+            {
+                DEBUG_LOG_ERROR("UAC2_EnumerateStreaming: UsbAddDescriptor ERROR");
+                Panic();
+            }
+        }
+    }
+
+    if (num_endpoints == 2)
+    {
+        stream->feedback_sink = StreamUsbEndPointSink(ep_info[1].bEndpointAddress);
+    }
+}
+
+/****************************************************************************
+    To add control interface and interface association for enumeration
+*/
+static void usbAudioClass20_EnumerateControl(uac2_data_t *uac_info)
+{
+    const usb_audio_interface_config_list_t *intf_list = uac_info->config->intf_list;
+    uint16 total_size = UAC2_AC_IF_HEADER_DESC_SIZE;
+    uint8 *header = uac_info->header_desc;
+    uint8 *iad = uac_info->iad_desc;
+
+    for (uint8 i=0; i < uac_info->num_interfaces; i++)
+    {
+        total_size += intf_list->intf[i].control_desc->size_descriptor;
+    }
+
+    header[0] = UAC2_AC_IF_HEADER_DESC_SIZE;    /* bLength */
+    header[1] = UAC_CS_DESC_INTERFACE;          /* bDescriptorType = CS_INTERFACE */
+    header[2] = UAC_AC_DESC_HEADER;             /* bDescriptorSubType = HEADER */
+    header[3] = UAC2_BCD_ADC_2_0 & 0xFF;        /* bcdADC */
+    header[4] = UAC2_BCD_ADC_2_0 >> 8;
+    header[5] = UAC2_FUNCTION_HEADSET;          /* bCategory */
+    header[6] = total_size & 0xFF;              /* wTotalLength */
+    header[7] = total_size >> 8;
+    header[8] = 0x00;                           /* bmControls = no latency control */
+
+    uac_info->control_interface = UsbAddInterface(&uac2_codes_ac, UAC_CS_DESC_INTERFACE,
+                                                  header, UAC2_AC_IF_HEADER_DESC_SIZE);
+    if (uac_info->control_interface == usb_interface_error)
+    {
+        DEBUG_LOG_ERROR("UAC2_EnumerateControl: usb_interface_error");
+        Panic();
+    }
+
+    /* USB Audio class 2.0 has no list of streaming interfaces in the header,
+     * the interfaces of the function are grouped by an IAD instead. Streaming
+     * interfaces will be added right after the control interface. */
+    iad[0] = UAC2_IAD_DESC_SIZE;                /* bLength */
+    iad[1] = USB_DT_INTERFACE_ASSOCIATION;      /* bDescriptorType = INTERFACE_ASSOCIATION */
+    iad[2] = (uint8)uac_info->control_interface;/* bFirstInterface */
+    iad[3] = uac_info->num_interfaces + 1;      /* bInterfaceCount */
+    iad[4] = UAC_IF_CLASS_AUDIO;                /* bFunctionClass */
+    iad[5] = UAC2_FUNCTION_SUBCLASS_UNDEFINED;  /* bFunctionSubClass */
+    iad[6] = UAC2_PROTOCOL_IP_VERSION_02_00;    /* bFunctionProtocol */
+    iad[7] = 0x00;                              /* iFunction = same as USB product string */
+
+    if (!UsbAddInterfaceAssociationDescriptor(uac_info->control_interface, iad, UAC2_IAD_DESC_SIZE))
+    {
+        DEBUG_LOG_ERROR("UAC2_EnumerateControl: UsbAddInterfaceAssociationDescriptor ERROR");
+        Panic();
+    }
+
+    for (uint8 i=0; i < uac_info->num_interfaces; i++)
+    {
+        if (!UsbAddDescriptor(uac_info->control_interface, UAC_CS_DESC_INTERFACE,
+                              intf_list->intf[i].control_desc->descriptor,
+                              intf_list->intf[i].control_desc->size_descriptor))
+        {
+            DEBUG_LOG_ERROR("UAC2_EnumerateControl: UsbAddDescriptor ERROR");
+            Panic();
+        }
+    }
+}
+
+/****************************************************************************
+    To manage stream connection of audio class
+*/
+static void usbAudioClass20_ManageStreamConnection(uac2_data_t *uac_info)
+{
+    Sink sink;
+
+    sink = StreamUsbClassSink(uac_info->control_interface);
+    uac_info->control_source = StreamSourceFromSink(sink);
+    MessageStreamTaskFromSink(sink, &uac2_control_task);
+
+    for (uint8 i=0; i < uac_info->num_interfaces; i++)
+    {
+        usb_audio_streaming_info_t *streaming_info = &uac_info->streaming_info[i];
+        Sink feedback_sink = uac_info->streams[i].feedback_sink;
+
+        sink = StreamUsbClassSink(streaming_info->interface);
+        streaming_info->source = StreamSourceFromSink(sink);
+        MessageStreamTaskFromSink(sink, &uac2_streaming_task);
+
+        if (feedback_sink)
+        {
+            MessageStreamTaskFromSink(feedback_sink, &uac2_feedback_task);
+            (void)SinkConfigure(feedback_sink, VM_SINK_MESSAGES, VM_MESSAGES_ALL);
+        }
+    }
+
+    StreamConfigure(VM_STREAM_USB_ALT_IF_MSG_ENABLED, 1);
+}
+
+static void usbAudioClass20_SetDefaults(uac2_data_t *uac_info)
+{
+    const usb_audio_config_params_t *config = uac_info->config;
+
+    for (uint8 i=0; i < uac_info->num_interfaces; i++)
+    {
+        const usb_audio_interface_config_t *intf_config = &config->intf_list->intf[i];
+        usb_audio_streaming_info_t *streaming_info = &uac_info->streaming_info[i];
+
+        streaming_info->alt_setting = INTF_ALT_SETTING_ZERO;
+        /* Using streaming_desc_index 0 as default */
+        streaming_info->streaming_desc_index = 0;
+        usbAudioClass20_GetFormat(intf_config->streaming_config,
+                                  &streaming_info->channels, &streaming_info->frame_size);
+
+        /* set default sampling Rate */
+        streaming_info->current_sampling_rate = usbAudioClass20_GetMaxSamplingRate(intf_config);
+        PanicZero(streaming_info->current_sampling_rate);
+
+        /* set speaker default volume */
+        streaming_info->volume_status.mute_status = 0;
+        streaming_info->volume_status.volume_db = config->volume_config.target_db;
+
+        uac_info->streams[i].deviation_ppm = 0;
+    }
+}
+
+/****************************************************************************
+    To add class 2.0 audio interface.
+*/
+static uac_ctx_t usbAudioClass20_Create(usb_device_index_t device_index,
+                                        const usb_audio_config_params_t *config,
+                                        usb_audio_streaming_info_t **streaming_info,
+                                        uac_event_handler_t evt_handler)
+{
+    DEBUG_LOG_DEBUG("usbAudioClass20_Create");
+    PanicZero(config);
+    PanicNull(streaming_info);
+    PanicZero(evt_handler);
+
+    const usb_audio_interface_config_list_t *intf_list = config->intf_list;
+
+    for (uint8 i=0; i < intf_list->num_interfaces; i++)
+    {
+        /* Clock rates are not part of the streaming descriptors */
+        PanicZero(intf_list->intf[i].num_sample_rates);
+        PanicFalse(intf_list->intf[i].num_sample_rates <= UAC2_MAX_SAMPLE_RATES);
+    }
+
+    uac2_data_t *uac_info = usbAudioClass20_GetNewInstance();
+
+    uac_info->config = config;
+    uac_info->num_interfaces = intf_list->num_interfaces;
+    uac_info->evt_handler = evt_handler;
+
+    uac_info->streaming_info = (usb_audio_streaming_info_t *)
+            PanicUnlessMalloc(sizeof(usb_audio_streaming_info_t) * uac_info->num_interfaces);
+    memset(uac_info->streaming_info, 0, sizeof(usb_audio_streaming_info_t) * uac_info->num_interfaces);
+
+    uac_info->streams = (uac2_stream_t *)PanicUnlessMalloc(sizeof(uac2_stream_t) * uac_info->num_interfaces);
+    memset(uac_info->streams, 0, sizeof(uac2_stream_t) * uac_info->num_interfaces);
+
+    *streaming_info = uac_info->streaming_info;
+
+    /* Attempt to register control interface */
+    usbAudioClass20_EnumerateControl(uac_info);
+
+    /* Set default volume and frequency */
+    usbAudioClass20_SetDefaults(uac_info);
+
+    /* Attempt to register all interface */
+    for (uint8 i=0; i < uac_info->num_interfaces; i++)
+    {
+        usbAudioClass20_EnumerateStreaming(device_index,
+                                           &uac_info->streaming_info[i],
+                                           &uac_info->streams[i],
+                                           &intf_list->intf[i]);
+    }
+
+    usbAudioClass20_ManageStreamConnection(uac_info);
+
+    DEBUG_LOG_INFO("usbAudioClass20_Create success");
+    return (uac_ctx_t) uac_info;
+}
+
+/****************************************************************************
+    To delete usb audio class 2.0 instance which created using usbAudioClass20_Create.
+*/
+static bool usbAudioClass20_Delete(uac_ctx_t class_ctx)
+{
+    uac2_data_t **uac_info_ptr = &uac2_class_info;
+
+    while (*uac_info_ptr)
+    {
+        if (*uac_info_ptr == (uac2_data_t *)class_ctx)
+        {
+            uac2_data_t *uac_info = *uac_info_ptr;
+
+            *uac_info_ptr = (*uac_info_ptr)->next;
+
+            free(uac_info->streams);
+            free(uac_info->streaming_info);
+            free(uac_info);
+
+            return TRUE;
+        }
+
+        uac_info_ptr = &((*uac_info_ptr)->next);
+    }
+
+    DEBUG_LOG_ERROR("usbAudioClass20_Delete Failed");
+
+    return FALSE;
+}
+
+static bool usbAudioClass20_Reset(uac_ctx_t class_ctx)
+{
+    uac2_data_t *uac_info = usbAudioClass20_FindInstance(class_ctx);
+
+    if (uac_info)
+    {
+        usbAudioClass20_SetDefaults(uac_info);
+        return TRUE;
+    }
+
+    DEBUG_LOG_ERROR("usbAudioClass20_Reset Failed");
+
+    return FALSE;
+}
+
+static void usbAudioClass20_SetInterface(uac_ctx_t class_ctx, uint16 interface, uint16 alt_setting)
+{
+    uac2_data_t *uac_info = usbAudioClass20_FindInstance(class_ctx);
+
+    if (uac_info == NULL)
+    {
+        return;
+    }
+
+    DEBUG_LOG_VERBOSE("usbAudioClass20_SetInterface %d %d ", interface, alt_setting);
+
+    for (uint8 index=0; index < uac_info->num_interfaces; index++)
+    {
+        const usb_audio_interface_config_t *intf_config = &uac_info->config->intf_list->intf[index];
+        usb_audio_streaming_info_t *streaming_info = &uac_info->streaming_info[index];
+
+        if (streaming_info->interface == interface)
+        {
+            streaming_info->alt_setting = alt_setting;
+
+            if (alt_setting != INTF_ALT_SETTING_ZERO)
+            {
+                uint8 streaming_intf_desc_index = INTF_DESC_INDEX_FROM_ALT_SETTINGS(alt_setting);
+
+                PanicFalse(streaming_intf_desc_index < intf_config->alt_settings_count);
+
+                usbAudioClass20_GetFormat(&intf_config->streaming_config[streaming_intf_desc_index],
+                                          &streaming_info->channels, &streaming_info->frame_size);
+                streaming_info->streaming_desc_index = streaming_intf_desc_index;
+
+                if (uac_info->streams[index].feedback_sink)
+                {
+                    for (uint8 i = 0; i < UAC2_FEEDBACK_PACKETS_QUEUED; i++)
+                    {
+                        usbAudioClass20_SendFeedback(uac_info, index);
+                    }
+                }
+            }
+
+            /* notify change in alternate interface */
+            uac_info->evt_handler(uac_info, index, USB_AUDIO_CLASS_MSG_ALT_INTF);
+            return;
+        }
+    }
+}
+
+static bool usbAudioClass20_SetRateDeviation(uac_ctx_t class_ctx, uint8 interface_index, int32 deviation_ppm)
+{
+    uac2_data_t *uac_info = usbAudioClass20_FindInstance(class_ctx);
+
+    if (uac_info == NULL || interface_index >= uac_info->num_interfaces ||
+        !uac_info->streams[interface_index].feedback_sink)
+    {
+        return FALSE;
+    }
+
+    /* The new value is picked up by the next feedback packet */
+    uac_info->streams[interface_index].deviation_ppm =
+            MAX(MIN(deviation_ppm, UAC2_FEEDBACK_MAX_DEVIATION_PPM), -UAC2_FEEDBACK_MAX_DEVIATION_PPM);
+    return TRUE;
+}
+
+static usb_fn_tbl_uac_if uac20_fn_tbl = {
+    .Create = usbAudioClass20_Create,
+    .SetInterface = usbAudioClass20_SetInterface,
+    .Reset = usbAudioClass20_Reset,
+    .Delete = usbAudioClass20_Delete,
+    .SetRateDeviation = usbAudioClass20_SetRateDeviation,
+};
+
+usb_fn_tbl_uac_if *UsbAudioClass20_GetFnTbl(void)
+{
+    return &uac20_fn_tbl;
+}
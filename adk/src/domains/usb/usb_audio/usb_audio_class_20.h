@@ -0,0 +1,26 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+                All Rights Reserved.\n
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file
+    \addtogroup usb_audio
+    \brief      Private Header file for USB Audio class 2.0 driver
+    @{
+*/
+
+#ifndef USB_AUDIO_CLASS_20_H_
+#define USB_AUDIO_CLASS_20_H_
+
+
+#include "usb_audio_class.h"
+
+/*! \brief Interface to get function pointers for class driver.
+
+    \return Return function table for usb_audio_class_20 driver interface .
+*/
+usb_fn_tbl_uac_if *UsbAudioClass20_GetFnTbl(void);
+
+
+#endif /* USB_AUDIO_CLASS_20_H_ */
+
+/*! @} */
@@ -0,0 +1,75 @@
+/*!
+   \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+               All Rights Reserved.\n
+               Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+   \file
+   \addtogroup usb_audio
+   \brief      Header file for using default descriptors of USB Audio class 2.0
+   @{
+*/
+
+#ifndef USB_AUDIO_CLASS_20_DEFAULT_DESCRIPTORS_H_
+#define USB_AUDIO_CLASS_20_DEFAULT_DESCRIPTORS_H_
+
+#include "usb_audio.h"
+#include "usb_audio_class_20_descriptors.h"
+
+/* Clock/Unit/Terminal IDs Used by default descriptors */
+#define UAC2D_MIC_VOICE_CLOCK   0x01
+#define UAC2D_MIC_VOICE_IT      0x02
+#define UAC2D_MIC_VOICE_FU      0x03
+#define UAC2D_MIC_VOICE_OT      0x04
+#define UAC2D_SPKR_AUDIO_CLOCK  0x05
+#define UAC2D_SPKR_AUDIO_IT     0x06
+#define UAC2D_SPKR_AUDIO_FU     0x07
+#define UAC2D_SPKR_AUDIO_OT     0x08
+
+#define UAC2D_VOICE_MIC_CHANNELS        USB_AUDIO_CHANNELS_MONO
+
+/* Speaker channels, may be 1, 2, 4 or 6 as long as the largest packet fits
+ * a full speed isochronous endpoint */
+#ifndef UAC2D_AUDIO_SPKR_CHANNELS
+#define UAC2D_AUDIO_SPKR_CHANNELS       USB_AUDIO_CHANNELS_STEREO
+#endif
+
+#if UAC2_CHANNEL_CONFIG(UAC2D_AUDIO_SPKR_CHANNELS) == 0
+#error NOT_SUPPORTED
+#endif
+
+#define UAC2D_VOICE_MIC_SAMPLE_SIZE     USB_SAMPLE_SIZE_16_BIT
+
+/* High resolution speaker format, the DSP accepts 16 and 24 bit subslots */
+#define UAC2D_HD_AUDIO_SPKR_SAMPLE_SIZE USB_SAMPLE_SIZE_24_BIT
+
+/* Highest speaker sampling rate in kHz, 48 or 96. A full speed isochronous
+ * packet of up to 1023 bytes carries 96 kHz 24 bit audio for up to 2 channels. */
+#ifndef UAC2D_AUDIO_SPKR_MAX_SAMPLE_RATE_KHZ
+#if UAC2D_AUDIO_SPKR_CHANNELS > USB_AUDIO_CHANNELS_STEREO
+#define UAC2D_AUDIO_SPKR_MAX_SAMPLE_RATE_KHZ    48
+#else
+#define UAC2D_AUDIO_SPKR_MAX_SAMPLE_RATE_KHZ    96
+#endif
+#endif
+
+#if ((UAC2D_AUDIO_SPKR_MAX_SAMPLE_RATE_KHZ + 1) * UAC2D_AUDIO_SPKR_CHANNELS * UAC2D_HD_AUDIO_SPKR_SAMPLE_SIZE) > 1023
+#error NOT_SUPPORTED
+#endif
+
+/* Voice Mic interface descriptors */
+extern const uac_control_config_t         uac2_voice_control_mic_desc;
+extern const uac_streaming_config_t       uac2_voice_streaming_mic_desc[];
+extern const uac_endpoint_config_t        uac2_voice_mic_endpoint;
+
+/* Audio Speaker interface descriptors */
+extern const uac_control_config_t         uac2_music_control_spkr_desc;
+extern const uac_streaming_config_t       uac2_hd_music_streaming_spkr_desc[];
+extern const uac_endpoint_config_t        uac2_music_spkr_endpoint;
+
+extern const usb_audio_interface_config_list_t uac2_hd_music_interfaces;
+
+/* HD Audio Speaker Voice Mic interface descriptors */
+extern const usb_audio_interface_config_list_t uac2_hd_music_spkr_voice_mic_interfaces;
+
+#endif /* USB_AUDIO_CLASS_20_DEFAULT_DESCRIPTORS_H_ */
+
+/*! @} */
@@ -0,0 +1,320 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+                All Rights Reserved.\n
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file
+    \ingroup    usb_audio
+    \brief      USB Audio class 2.0 descriptors
+*/
+
+#include "usb_audio_class_20_descriptors.h"
+#include "usb_audio_class_20_default_descriptors.h"
+
+
+static const uint8 control_intf_desc_voice_mic[] =
+{
+    /* Microphone Clock Source */
+    UAC2_CLOCK_SOURCE_DESC_SIZE,        /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC2_AC_DESC_CLOCK_SOURCE,          /* bDescriptorSubType = CLOCK_SOURCE */
+    UAC2D_MIC_VOICE_CLOCK,              /* bClockID */
+    UAC2_CLOCK_INTERNAL_PROGRAMMABLE,   /* bmAttributes = internal programmable clock */
+    UAC2_CLOCK_CONTROLS,                /* bmControls = frequency r/w, validity r/o */
+    0x00,                               /* bAssocTerminal = none */
+    0x00,                               /* iClockSource = no string */
+
+    /* Microphone IT */
+    UAC2_IT_TERM_DESC_SIZE,             /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AC_DESC_INPUT_TERMINAL,         /* bDescriptorSubType = INPUT_TERMINAL */
+    UAC2D_MIC_VOICE_IT,                 /* bTerminalID */
+    UAC_TRM_BIDI_HEADSET & 0xFF,        /* wTerminalType = Microphone*/
+    UAC_TRM_BIDI_HEADSET >> 8,
+    0x00,                               /* bAssocTerminal = none */
+    UAC2D_MIC_VOICE_CLOCK,              /* bCSourceID - Microphone Clock Source */
+    UAC2D_VOICE_MIC_CHANNELS,           /* bNrChannels = 1 */
+    UAC2_U32(UAC2_CHANNEL_CONFIG(UAC2D_VOICE_MIC_CHANNELS)), /* bmChannelConfig */
+    0x00,                               /* iChannelNames = no string */
+    UAC2_U16(0),                        /* bmControls = none */
+    0x00,                               /* iTerminal = same as USB product string */
+
+    /* Microphone Features */
+    UAC2_FU_DESC_SIZE(UAC2D_VOICE_MIC_CHANNELS), /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AC_DESC_FEATURE_UNIT,           /* bDescriptorSubType = FEATURE_UNIT*/
+    UAC2D_MIC_VOICE_FU,                 /* bUnitId*/
+    UAC2D_MIC_VOICE_IT,                 /* bSourceId - Microphone IT*/
+    UAC2_U32(UAC2_FU_CONTROLS(UAC_FU_CONTROL_MUTE)), /* bmaControls[0] (Mute on Master Channel)*/
+    UAC2_U32(0),                        /* bmaControls[1] (Front Left)*/
+    0x00,                               /* iFeature = same as USB product string*/
+
+    /* Microphone OT */
+    UAC2_OT_TERM_DESC_SIZE,             /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AC_DESC_OUTPUT_TERNINAL,        /* bDescriptorSubType = OUTPUT_TERMINAL */
+    UAC2D_MIC_VOICE_OT,                 /* bTerminalID */
+    UAC_TRM_USB_STREAMING & 0xFF,       /* wTerminalType = USB streaming */
+    UAC_TRM_USB_STREAMING >> 8,
+    0x00,                               /* bAssocTerminal = none */
+    UAC2D_MIC_VOICE_FU,                 /* bSourceID - Microphone Features */
+    UAC2D_MIC_VOICE_CLOCK,              /* bCSourceID - Microphone Clock Source */
+    UAC2_U16(0),                        /* bmControls = none */
+    0x00,                               /* iTerminal = same as USB product string */
+};
+
+static const uint8 control_intf_desc_audio_spkr[] =
+{
+    /* Speaker Clock Source */
+    UAC2_CLOCK_SOURCE_DESC_SIZE,        /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC2_AC_DESC_CLOCK_SOURCE,          /* bDescriptorSubType = CLOCK_SOURCE */
+    UAC2D_SPKR_AUDIO_CLOCK,             /* bClockID */
+    UAC2_CLOCK_INTERNAL_PROGRAMMABLE,   /* bmAttributes = internal programmable clock */
+    UAC2_CLOCK_CONTROLS,                /* bmControls = frequency r/w, validity r/o */
+    0x00,                               /* bAssocTerminal = none */
+    0x00,                               /* iClockSource = no string */
+
+    /* Speaker IT */
+    UAC2_IT_TERM_DESC_SIZE,             /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AC_DESC_INPUT_TERMINAL,         /* bDescriptorSubType = INPUT_TERMINAL */
+    UAC2D_SPKR_AUDIO_IT,                /* bTerminalID */
+    UAC_TRM_USB_STREAMING & 0xFF,       /* wTerminalType = USB streaming */
+    UAC_TRM_USB_STREAMING >> 8,
+    0x00,                               /* bAssocTerminal = none */
+    UAC2D_SPKR_AUDIO_CLOCK,             /* bCSourceID - Speaker Clock Source */
+    UAC2D_AUDIO_SPKR_CHANNELS,          /* bNrChannels */
+    UAC2_U32(UAC2_CHANNEL_CONFIG(UAC2D_AUDIO_SPKR_CHANNELS)), /* bmChannelConfig */
+    0x00,                               /* iChannelNames = no string */
+    UAC2_U16(0),                        /* bmControls = none */
+    0x00,                               /* iTerminal = same as USB product string */
+
+    /* Speaker Features */
+    UAC2_FU_DESC_SIZE(UAC2D_AUDIO_SPKR_CHANNELS), /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AC_DESC_FEATURE_UNIT,           /* bDescriptorSubType = FEATURE_UNIT*/
+    UAC2D_SPKR_AUDIO_FU,                /* bUnitId*/
+    UAC2D_SPKR_AUDIO_IT,                /* bSourceId - Speaker IT*/
+    UAC2_U32(UAC2_FU_CONTROLS(UAC_FU_CONTROL_MUTE) |
+             UAC2_FU_CONTROLS(UAC_FU_CONTROL_VOLUME)), /* bmaControls[0] (Mute & Vol on Master Channel)*/
+    UAC2_U32(0),                        /* bmaControls[1] (Front Left)*/
+#if UAC2D_AUDIO_SPKR_CHANNELS >= 2
+    UAC2_U32(0),                        /* bmaControls[2] (Front Right)*/
+#endif
+#if UAC2D_AUDIO_SPKR_CHANNELS == 6
+    UAC2_U32(0),                        /* bmaControls[3] (Front Center)*/
+    UAC2_U32(0),                        /* bmaControls[4] (Low Frequency Effects)*/
+#endif
+#if UAC2D_AUDIO_SPKR_CHANNELS >= 4
+    UAC2_U32(0),                        /* bmaControls (Back Left)*/
+    UAC2_U32(0),                        /* bmaControls (Back Right)*/
+#endif
+    0x00,                               /* iFeature = same as USB product string*/
+
+    /* Speaker OT */
+    UAC2_OT_TERM_DESC_SIZE,             /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AC_DESC_OUTPUT_TERNINAL,        /* bDescriptorSubType = OUTPUT_TERMINAL */
+    UAC2D_SPKR_AUDIO_OT,                /* bTerminalID */
+    UAC_TRM_OUTPUT_HEADPHONES & 0xFF,   /* wTerminalType = Speaker*/
+    UAC_TRM_OUTPUT_HEADPHONES >> 8,
+    0x00,                               /* bAssocTerminal = none */
+    UAC2D_SPKR_AUDIO_FU,                /* bSourceID - Speaker Features*/
+    UAC2D_SPKR_AUDIO_CLOCK,             /* bCSourceID - Speaker Clock Source */
+    UAC2_U16(0),                        /* bmControls = none */
+    0x00                                /* iTerminal = same as USB product string */
+};
+
+/* Class specific AS isochronous audio data endpoint descriptor, the same for all interfaces */
+#define UAC2D_AS_DATA_EP_DESC \
+    UAC2_AS_DATA_EP_DESC_SIZE,          /* bLength */ \
+    UAC_CS_DESC_ENDPOINT,               /* bDescriptorType = CS_ENDPOINT */ \
+    UAC_AS_EP_DESC_GENERAL,             /* bDescriptorSubType = EP_GENERAL */ \
+    0x00,                               /* bmAttributes = no max packets only */ \
+    0x00,                               /* bmControls = none */ \
+    0x00,                               /* bLockDelayUnits = undefined */ \
+    UAC2_U16(0)                         /* wLockDelay */
+
+/** Default USB streaming interface descriptors for speaker, 16 bit */
+static const uint8 streaming_intf_desc_audio_spkr[] =
+{
+    /* Class Specific AS interface descriptor */
+    UAC2_AS_IF_DESC_SIZE,               /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AS_DESC_GENERAL,                /* bDescriptorSubType = AS_GENERAL */
+    UAC2D_SPKR_AUDIO_IT,                /* bTerminalLink = Speaker IT */
+    0x00,                               /* bmControls = none */
+    UAC_AS_DESC_FORMAT_TYPE_I,          /* bFormatType = FORMAT_TYPE_I */
+    UAC2_U32(UAC2_DATA_FORMAT_TYPE_I_PCM), /* bmFormats = PCM */
+    UAC2D_AUDIO_SPKR_CHANNELS,          /* bNrChannels */
+    UAC2_U32(UAC2_CHANNEL_CONFIG(UAC2D_AUDIO_SPKR_CHANNELS)), /* bmChannelConfig */
+    0x00,                               /* iChannelNames = no string */
+
+    /* Type 1 format type descriptor */
+    UAC2_FORMAT_DESC_SIZE,              /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AS_DESC_FORMAT_TYPE,            /* bDescriptorSubType = FORMAT_TYPE */
+    UAC_AS_DESC_FORMAT_TYPE_I,          /* bFormatType = FORMAT_TYPE_I */
+    USB_SAMPLE_SIZE_16_BIT,             /* bSubslotSize = 2 bytes */
+    USB_SAMPLE_SIZE_16_BIT * 8,         /* bBitResolution */
+
+    UAC2D_AS_DATA_EP_DESC
+};
+
+/** Default USB streaming interface descriptors for speaker, high resolution */
+static const uint8 streaming_intf_desc_hd_audio_spkr[] =
+{
+    /* Class Specific AS interface descriptor */
+    UAC2_AS_IF_DESC_SIZE,               /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AS_DESC_GENERAL,                /* bDescriptorSubType = AS_GENERAL */
+    UAC2D_SPKR_AUDIO_IT,                /* bTerminalLink = Speaker IT */
+    0x00,                               /* bmControls = none */
+    UAC_AS_DESC_FORMAT_TYPE_I,          /* bFormatType = FORMAT_TYPE_I */
+    UAC2_U32(UAC2_DATA_FORMAT_TYPE_I_PCM), /* bmFormats = PCM */
+    UAC2D_AUDIO_SPKR_CHANNELS,          /* bNrChannels */
+    UAC2_U32(UAC2_CHANNEL_CONFIG(UAC2D_AUDIO_SPKR_CHANNELS)), /* bmChannelConfig */
+    0x00,                               /* iChannelNames = no string */
+
+    /* Type 1 format type descriptor */
+    UAC2_FORMAT_DESC_SIZE,              /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AS_DESC_FORMAT_TYPE,            /* bDescriptorSubType = FORMAT_TYPE */
+    UAC_AS_DESC_FORMAT_TYPE_I,          /* bFormatType = FORMAT_TYPE_I */
+    UAC2D_HD_AUDIO_SPKR_SAMPLE_SIZE,    /* bSubslotSize = 3 bytes */
+    UAC2D_HD_AUDIO_SPKR_SAMPLE_SIZE * 8,/* bBitResolution */
+
+    UAC2D_AS_DATA_EP_DESC
+};
+
+/** Default USB streaming interface descriptors for mic */
+static const uint8 streaming_intf_desc_voice_mic[] =
+{
+    /* Class Specific AS interface descriptor */
+    UAC2_AS_IF_DESC_SIZE,               /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AS_DESC_GENERAL,                /* bDescriptorSubType = AS_GENERAL */
+    UAC2D_MIC_VOICE_OT,                 /* bTerminalLink = Microphone OT */
+    0x00,                               /* bmControls = none */
+    UAC_AS_DESC_FORMAT_TYPE_I,          /* bFormatType = FORMAT_TYPE_I */
+    UAC2_U32(UAC2_DATA_FORMAT_TYPE_I_PCM), /* bmFormats = PCM */
+    UAC2D_VOICE_MIC_CHANNELS,           /* bNrChannels */
+    UAC2_U32(UAC2_CHANNEL_CONFIG(UAC2D_VOICE_MIC_CHANNELS)), /* bmChannelConfig */
+    0x00,                               /* iChannelNames = no string */
+
+    /* Type 1 format type descriptor */
+    UAC2_FORMAT_DESC_SIZE,              /* bLength */
+    UAC_CS_DESC_INTERFACE,              /* bDescriptorType = CS_INTERFACE */
+    UAC_AS_DESC_FORMAT_TYPE,            /* bDescriptorSubType = FORMAT_TYPE */
+    UAC_AS_DESC_FORMAT_TYPE_I,          /* bFormatType = FORMAT_TYPE_I */
+    UAC2D_VOICE_MIC_SAMPLE_SIZE,        /* bSubslotSize = 2 bytes */
+    UAC2D_VOICE_MIC_SAMPLE_SIZE * 8,    /* bBitResolution */
+
+    UAC2D_AS_DATA_EP_DESC
+};
+
+/* Sampling rates of the Clock Sources, highest first */
+static const uint32 voice_mic_sample_rates[] =
+{
+    SAMPLE_RATE_16K,
+    SAMPLE_RATE_8K
+};
+
+static const uint32 audio_spkr_sample_rates[] =
+{
+#if UAC2D_AUDIO_SPKR_MAX_SAMPLE_RATE_KHZ == 96
+    SAMPLE_RATE_96K,
+#endif
+    SAMPLE_RATE_48K,
+    SAMPLE_RATE_44K1
+};
+
+/* Voice Mic interface descriptors */
+const uac_control_config_t uac2_voice_control_mic_desc = {
+    control_intf_desc_voice_mic,
+    sizeof(control_intf_desc_voice_mic)
+};
+
+const uac_endpoint_config_t uac2_voice_mic_endpoint = {
+    .is_to_host = 1,
+    .wMaxPacketSize = 0,
+    .bInterval = 1
+};
+
+const uac_streaming_config_t uac2_voice_streaming_mic_desc[] = {
+    {
+        &uac2_voice_mic_endpoint,
+        streaming_intf_desc_voice_mic,
+        sizeof(streaming_intf_desc_voice_mic)
+    }
+};
+
+/* Audio Speaker interface descriptors */
+const uac_control_config_t uac2_music_control_spkr_desc = {
+    control_intf_desc_audio_spkr,
+    sizeof(control_intf_desc_audio_spkr)
+};
+
+const uac_endpoint_config_t uac2_music_spkr_endpoint = {
+    .is_to_host = 0,
+    .wMaxPacketSize = 0,
+    .bInterval = 1
+};
+
+const uac_streaming_config_t uac2_hd_music_streaming_spkr_desc[] = {
+    {
+        &uac2_music_spkr_endpoint,
+        streaming_intf_desc_audio_spkr,
+        sizeof(streaming_intf_desc_audio_spkr)
+    },
+    {
+        &uac2_music_spkr_endpoint,
+        streaming_intf_desc_hd_audio_spkr,
+        sizeof(streaming_intf_desc_hd_audio_spkr)
+    }
+};
+
+static const usb_audio_interface_config_t uac2_hd_music_intf_list[] =
+{
+    {
+        .type = USB_AUDIO_DEVICE_TYPE_AUDIO_SPEAKER,
+        .control_desc =   &uac2_music_control_spkr_desc,
+        .streaming_config = uac2_hd_music_streaming_spkr_desc,
+        .alt_settings_count = ARRAY_DIM(uac2_hd_music_streaming_spkr_desc),
+        .sample_rates = audio_spkr_sample_rates,
+        .num_sample_rates = ARRAY_DIM(audio_spkr_sample_rates)
+    }
+};
+
+const usb_audio_interface_config_list_t uac2_hd_music_interfaces =
+{
+    .intf = uac2_hd_music_intf_list,
+    .num_interfaces = ARRAY_DIM(uac2_hd_music_intf_list)
+};
+
+/* HD Audio Speaker Voice Mic interface descriptors */
+static const usb_audio_interface_config_t uac2_hd_music_spkr_voice_mic_intf_list[] =
+{
+    {
+        .type = USB_AUDIO_DEVICE_TYPE_VOICE_MIC,
+        .control_desc =   &uac2_voice_control_mic_desc,
+        .streaming_config = uac2_voice_streaming_mic_desc,
+        .alt_settings_count = ARRAY_DIM(uac2_voice_streaming_mic_desc),
+        .sample_rates = voice_mic_sample_rates,
+        .num_sample_rates = ARRAY_DIM(voice_mic_sample_rates)
+    },
+    {
+        .type = USB_AUDIO_DEVICE_TYPE_AUDIO_SPEAKER,
+        .control_desc =   &uac2_music_control_spkr_desc,
+        .streaming_config = uac2_hd_music_streaming_spkr_desc,
+        .alt_settings_count = ARRAY_DIM(uac2_hd_music_streaming_spkr_desc),
+        .sample_rates = audio_spkr_sample_rates,
+        .num_sample_rates = ARRAY_DIM(audio_spkr_sample_rates)
+    }
+};
+
+const usb_audio_interface_config_list_t uac2_hd_music_spkr_voice_mic_interfaces =
+{
+    .intf = uac2_hd_music_spkr_voice_mic_intf_list,
+    .num_interfaces = ARRAY_DIM(uac2_hd_music_spkr_voice_mic_intf_list)
+};
@@ -0,0 +1,125 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.\n
+                All Rights Reserved.\n
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file
+    \addtogroup usb_audio
+    \brief      Header file for creating descriptors for USB Audio class 2.0
+*/
+
+#ifndef USB_AUDIO_CLASS_20_DESCRIPTORS_H_
+#define USB_AUDIO_CLASS_20_DESCRIPTORS_H_
+
+#include "usb_audio_defines.h"
+#include "usb_audio_class_10_descriptors.h"
+
+/*! Audio Device Class v2.00 */
+#define UAC2_BCD_ADC_2_0            0x0200
+
+/*! Audio Function and Interface Protocol Code for USB Audio class 2.0 */
+#define UAC2_PROTOCOL_IP_VERSION_02_00  0x20
+
+/*! Audio Function Subclass Code */
+#define UAC2_FUNCTION_SUBCLASS_UNDEFINED    0x00
+
+/*! \brief Audio Function Category Codes */
+typedef enum
+{
+    UAC2_FUNCTION_DESKTOP_SPEAKER   = 0x01,
+    UAC2_FUNCTION_HEADSET           = 0x04,
+    UAC2_FUNCTION_OTHER             = 0xFF,
+} usb_audio_20_function_category_t;
+
+/*! \brief Audio Class-Specific AC Interface Descriptor Subtypes, in addition
+    to those of USB Audio class 1.0 */
+typedef enum
+{
+    UAC2_AC_DESC_CLOCK_SOURCE       = 0x0A,
+} usb_audio_20_ac_if_descriptor_subtype_t;
+
+/*! \brief Clock Source Control Selectors */
+typedef enum
+{
+    UAC2_CS_CONTROL_UNDEFINED       = 0x00,
+    UAC2_CS_CONTROL_SAM_FREQ        = 0x01,
+    UAC2_CS_CONTROL_CLOCK_VALID     = 0x02,
+} usb_audio_20_clock_source_control_selectors_t;
+
+/*! Clock Source bmAttributes: internal clock with programmable frequency */
+#define UAC2_CLOCK_INTERNAL_PROGRAMMABLE    0x03
+
+/*! bmControls bit pairs: control is read only or read/write by the host */
+#define UAC2_CONTROL_READ_ONLY(n)           (0x01UL << (2 * (n)))
+#define UAC2_CONTROL_READ_WRITE(n)          (0x03UL << (2 * (n)))
+
+/*! Clock Source bmControls: programmable frequency, read only validity */
+#define UAC2_CLOCK_CONTROLS                 (UAC2_CONTROL_READ_WRITE(0) | UAC2_CONTROL_READ_ONLY(1))
+
+/*! Feature Unit bmaControls bits, the USB Audio class 1.0 control selectors
+    are used to index the bit pairs */
+#define UAC2_FU_CONTROLS(control)           UAC2_CONTROL_READ_WRITE((control) - 1)
+
+/*! Audio Data Format Type I bmFormats bit */
+#define UAC2_DATA_FORMAT_TYPE_I_PCM         0x00000001UL
+
+/*! Spatial locations of channels in bmChannelConfig. These are macros
+    rather than an enum so that channel configurations can be checked by the
+    preprocessor. */
+#define UAC2_CHANNEL_FRONT_LEFT         0x0001
+#define UAC2_CHANNEL_FRONT_RIGHT        0x0002
+#define UAC2_CHANNEL_FRONT_CENTER       0x0004
+#define UAC2_CHANNEL_LOW_FREQ_EFFECTS   0x0008
+#define UAC2_CHANNEL_BACK_LEFT          0x0010
+#define UAC2_CHANNEL_BACK_RIGHT         0x0020
+
+/*! bmChannelConfig for a number of channels, 0 if it isn't supported */
+#define UAC2_CHANNEL_CONFIG(channels) \
+    ((channels) == 1 ? UAC2_CHANNEL_FRONT_LEFT : \
+     (channels) == 2 ? (UAC2_CHANNEL_FRONT_LEFT | UAC2_CHANNEL_FRONT_RIGHT) : \
+     (channels) == 4 ? (UAC2_CHANNEL_FRONT_LEFT | UAC2_CHANNEL_FRONT_RIGHT | \
+                        UAC2_CHANNEL_BACK_LEFT | UAC2_CHANNEL_BACK_RIGHT) : \
+     (channels) == 6 ? (UAC2_CHANNEL_FRONT_LEFT | UAC2_CHANNEL_FRONT_RIGHT | \
+                        UAC2_CHANNEL_FRONT_CENTER | UAC2_CHANNEL_LOW_FREQ_EFFECTS | \
+                        UAC2_CHANNEL_BACK_LEFT | UAC2_CHANNEL_BACK_RIGHT) : 0)
+
+/*! Endpoint bmAttributes bits not listed in EndPointAttr */
+#define UAC2_EP_SYNC_ASYNC          0x04
+#define UAC2_EP_USAGE_FEEDBACK      0x10
+
+/*! Size of an explicit feedback value on a full speed bus, in 10.14 format */
+#define UAC2_FEEDBACK_SIZE          3
+
+/*! To get Class-Specific AC Interface Header Descriptor length */
+#define UAC2_AC_IF_HEADER_DESC_SIZE              (0x09)
+
+/*! To get Clock Source Descriptor length */
+#define UAC2_CLOCK_SOURCE_DESC_SIZE              (0x08)
+
+/*! To get Input Terminal Descriptor length */
+#define UAC2_IT_TERM_DESC_SIZE                   (0x11)
+
+/*! To get Output Terminal Descriptor length */
+#define UAC2_OT_TERM_DESC_SIZE                   (0x0C)
+
+/*! To get Feature Unit Descriptor length from channel count */
+#define UAC2_FU_DESC_SIZE(ch_count)              (0x06 + ((ch_count) + 1) * 4)
+
+/*! To get Class-Specific AS Interface Descriptor length */
+#define UAC2_AS_IF_DESC_SIZE                     (0x10)
+
+/*! To get Type I Format Type Descriptor length */
+#define UAC2_FORMAT_DESC_SIZE                    (0x06)
+
+/*! To get Class-Specific AS Isochronous Audio Data Endpoint Descriptor length */
+#define UAC2_AS_DATA_EP_DESC_SIZE                (0x08)
+
+/*! To get Interface Association Descriptor length */
+#define UAC2_IAD_DESC_SIZE                       (0x08)
+
+/*! Little endian bytes of 16 and 32 bit descriptor fields */
+#define UAC2_U16(x)     (uint8)((x) & 0xFF), (uint8)(((x) >> 8) & 0xFF)
+#define UAC2_U32(x)     UAC2_U16(x), UAC2_U16((x) >> 16)
+
+#endif /* USB_AUDIO_CLASS_20_DESCRIPTORS_H_ */
+
+/*! @} */
@@ -9,6 +9,7 @@
 
 #include "usb_audio_fd.h"
 #include "usb_audio_class_10.h"
+#include "usb_audio_class_20.h"
 
 #include <panic.h>
 #include "kymera.h"
@@ -40,6 +41,12 @@ static uint8 usbAudio_VolumeToSteps(const usb_audio_volume_config_t *volume_conf
 
 #define USB_AUDIO_GET_DATA()         usbaudio_globaldata
 
+/*! Interval between reading the rate measured by the audio chain */
+#define USB_AUDIO_RATE_MEASURE_INTERVAL_MS  (1000)
+
+static void usbAudio_RateMeasureHandler(Task task, MessageId id, Message message);
+static TaskData usb_audio_rate_measure_task = { usbAudio_RateMeasureHandler };
+
 Task usb_audio_client_cb[USB_AUDIO_REGISTERED_CLIENT_COUNT] = {NULL};
 
 /****************************************************************************
@@ -144,6 +151,10 @@ static const usb_fn_tbl_uac_if * usbAudioGetFnTbl(usb_audio_class_rev_t rev)
             tbl = UsbAudioClass10_GetFnTbl();
             break;
 
+        case USB_AUDIO_CLASS_REV_2:
+            tbl = UsbAudioClass20_GetFnTbl();
+            break;
+
         default:
             DEBUG_LOG("Unsupported USB Class Revision 0x%x", rev);
             break;
@@ -1299,3 +1310,63 @@ void UsbAudio_ClearAudioChainBusy(Source source)
         UsbAudio_TryFreeData(usb_audio);
     }
 }
+
+static void usbAudio_RateMeasureHandler(Task task, MessageId id, Message message)
+{
+    usb_audio_info_t *usb_audio = USB_AUDIO_GET_DATA();
+    bool measuring = FALSE;
+    bool measured;
+    int32 mismatch_ppm = 0;
+
+    UNUSED(id);
+    UNUSED(message);
+
+    /* The audio clock runs this much faster than the USB frame clock, so the
+       host is asked for as many more samples per frame */
+    measured = appKymeraUsbAudioGetRateMismatch(&mismatch_ppm);
+
+    while (usb_audio)
+    {
+        if (!usb_audio->is_pending_delete && usb_audio->headphone != NULL &&
+            usb_audio->headphone->chain_active && usb_audio->usb_fn_uac->SetRateDeviation != NULL)
+        {
+            measuring = TRUE;
+            if (measured)
+            {
+                DEBUG_LOG_VERBOSE("usbAudio_RateMeasureHandler, mismatch %d ppm", mismatch_ppm);
+                UsbAudio_SetMeasuredRateDeviation(usb_audio->headphone->spkr_src, mismatch_ppm);
+            }
+        }
+        usb_audio = usb_audio->next;
+    }
+
+    if (measuring)
+    {
+        MessageSendLater(task, 0, NULL, USB_AUDIO_RATE_MEASURE_INTERVAL_MS);
+    }
+}
+
+void UsbAudio_StartRateMeasurement(void)
+{
+    MessageCancelAll(&usb_audio_rate_measure_task, 0);
+    MessageSendLater(&usb_audio_rate_measure_task, 0, NULL, USB_AUDIO_RATE_MEASURE_INTERVAL_MS);
+}
+
+bool UsbAudio_SetMeasuredRateDeviation(Source source, int32 deviation_ppm)
+{
+    usb_audio_info_t *usb_audio = UsbAudio_FindInfoBySource(source);
+
+    if (usb_audio == NULL || usb_audio->usb_fn_uac->SetRateDeviation == NULL)
+    {
+        return FALSE;
+    }
+
+    for (uint8 i=0; i < usb_audio->num_interfaces; i++)
+    {
+        if (StreamUsbEndPointSource(usb_audio->streaming_info[i].ep_address) == source)
+        {
+            return usb_audio->usb_fn_uac->SetRateDeviation(usb_audio->class_ctx, i, deviation_ppm);
+        }
+    }
+    return FALSE;
+}
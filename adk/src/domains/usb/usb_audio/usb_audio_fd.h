@@ -184,6 +184,13 @@ const voice_source_volume_interface_t * UsbAudioFd_GetVoiceSourceVolumeInterface
  */
 usb_result_t UsbAudio_TryFreeData(usb_audio_info_t *usb_audio);
 
+/*! \brief Start passing the rate measured by the audio chain to the class driver
+ *
+ *  The measurement is repeated while a headphone audio chain is active on a
+ *  class driver that feeds back the rate to the host.
+ */
+void UsbAudio_StartRateMeasurement(void);
+
 #endif // USB_AUDIO_FD_H
 
 /*! @} */
\ No newline at end of file
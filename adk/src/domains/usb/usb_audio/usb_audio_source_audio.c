@@ -79,6 +79,9 @@ static bool usbAudio_GetConnectParameters(audio_source_t source,
         connect_params->min_latency_ms = usb_audio->config->min_latency_ms;
         connect_params->target_latency_ms = usb_audio->config->target_latency_ms;
 
+        /* Only class drivers with a feedback endpoint can steer the host */
+        connect_params->host_rate_feedback = (usb_audio->usb_fn_uac->SetRateDeviation != NULL);
+
         /* usbAudio_Audio_KymeraStoppedHandler() need to know whether there is 
          * a pending connect request, so that it can reset chain_active to FALSE.
          */ 
@@ -91,6 +94,9 @@ static bool usbAudio_GetConnectParameters(audio_source_t source,
          */
         usb_audio->headphone->chain_active = TRUE;
 
+        /* The chain measures how the audio clock drifts from the host */
+        UsbAudio_StartRateMeasurement();
+
         DEBUG_LOG_VERBOSE("USB Audio channels = %x, frame=%x, Freq=%d",
             connect_params->channels, connect_params->frame_size, connect_params->sample_freq);
 
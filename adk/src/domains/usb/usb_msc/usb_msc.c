@@ -393,6 +393,7 @@ static usb_result_t usbMsc_Destroy(usb_class_context_t context)
         return USB_RESULT_NOT_FOUND;
     }
 
+    free(msc_class_data->read_ahead.buffer);
     free(msc_class_data);
     msc_class_data = NULL;
 
@@ -42,6 +42,20 @@ typedef struct
     uint32 end_sector;
 } FileInfoType;
 
+/* Number of data area sectors that can be read ahead of the host */
+#define READ_AHEAD_SECTORS 2
+
+/* Data area sectors read from the file before the host asks for them.
+ * The buffer is a ring of READ_AHEAD_SECTORS sectors holding file sectors
+ * first_sector to first_sector + count - 1. The file source is positioned
+ * at the sector following them. */
+typedef struct
+{
+    uint8 *buffer;
+    uint32 first_sector;
+    uint8 count;
+} ReadAheadType;
+
 typedef enum
 {
     FILE_INFO_FAT,
@@ -61,6 +75,9 @@ typedef struct usb_msc_class_data_t
     usb_msc_request_sense_response_t req_sense_rsp;
     uint8 info_read;
     FileInfoType file_info[FILE_INFO_MAX];
+    /* logical address following the last one read, to detect sequential reads */
+    uint32 next_read_address;
+    ReadAheadType read_ahead;
 } usb_msc_class_data_t;
 
 extern usb_msc_class_data_t *msc_class_data;
@@ -91,7 +108,8 @@ void UsbMsc_Fat16_Initialise(usb_msc_class_data_t *msc);
  * The data is read from the area starting at logical_address and ending
  * at the address depending on transfer_length.
  * All read data is written to the bulk endpoint to transfer data
- * back to the host. */
+ * back to the host. Data area sectors are read ahead of the host when it
+ * reads them sequentially. */
 void UsbMsc_Fat16_Read(usb_msc_class_data_t *msc, uint32 logical_address,
                        uint32 transfer_length);
 
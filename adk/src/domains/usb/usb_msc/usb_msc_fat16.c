@@ -10,6 +10,9 @@
 #include "usb_msc_common.h"
 #include "usb_msc_fat16.h"
 
+#include <vm.h>
+#include "metrics.h"
+
 /*
     The FAT16 implementation is split into sectors as shown below:  
   
@@ -20,6 +23,16 @@ sectors:         0     1 - 62      63       64 - 66      67 - 200     201 - 303
 
 */
 
+/* Read-ahead buffer slot holding a file sector */
+#define READ_AHEAD_SLOT(read_ahead, sector) \
+    (&(read_ahead)->buffer[((sector) % READ_AHEAD_SECTORS) * BYTES_PER_SECTOR])
+
+/* Sequential reads of at least this many sectors are timed for the read rate metric */
+#define READ_RATE_MIN_SECTORS 64
+
+METRIC_COUNTER(usb_msc_read_ahead_sectors, METRIC_ID_USB_MSC_READ_AHEAD_SECTORS);
+METRIC_HISTOGRAM(usb_msc_read_rate, METRIC_ID_USB_MSC_SEQUENTIAL_READ_RATE_KBPS, 100, 250, 500, 750, 1000);
+
 static const MasterBootRecordExeType mbr_exe = {
     {0x33,0xC0,0x8E,0xD0,0xBC,0x00,0x7C,0xFB,0x50,0x07,0x50,0x1F,0xFC,0xBE,0x1B,0x7C,0xBF,
      0x1B,0x06,0x50,0x57,0xB9,0xE5,0x01,0xF3,0xA4,0xCB,0xBE,0xBE,0x07,0xB1,0x04,0x38,0x2C,
@@ -170,26 +183,10 @@ static const DirectoryType default_root_file = {
             (SIZE_FAT_FILE & 0xff000000ul)>>24} /* file size */
 };
 
-static uint32 usbMsc_ReadSectors(Sink sink, FileInfoType *file_info,
-                           uint32 logical_address, uint32 transfer_length,
-                           uint32 area_start_sector)
+/* Position the file source at the start of sector, reopening the file to go backwards */
+static void usbMsc_SeekSector(FileInfoType *file_info, uint32 sector)
 {
-    uint32 start_sector;
-    uint32 end_sector;
-    uint32 file_end_sector = file_info->end_sector;
-
-    /* correct end sector for FAT2, as it's otherwise treated as FAT1 */
-    if (area_start_sector == FAT2_SECTOR)
-        file_end_sector += SECTORS_PER_FAT;
-    
-    /* find the start sector and end sector for this type of data */
-    start_sector = logical_address - area_start_sector;
-    end_sector = start_sector + transfer_length - 1;
-    end_sector = MIN(end_sector, (file_end_sector - area_start_sector));
-
-    DEBUG_LOG_DEBUG("UsbMsc::FAT16:     [%ld:%ld]", start_sector, end_sector);
-    
-    if (start_sector < file_info->current_start_sector)
+    if (sector < file_info->current_start_sector)
     {
         if (file_info->src)
         {
@@ -206,12 +203,12 @@ static uint32 usbMsc_ReadSectors(Sink sink, FileInfoType *file_info,
         else
             file_info->src = StreamFileSource(file_info->index);
         file_info->current_start_sector = 0;
-        
+
         DEBUG_LOG_DEBUG("UsbMsc::FAT16:     open file");
     }
-    
+
     /* seek through the file until the correct sector is reached */
-    while (file_info->current_start_sector < start_sector)
+    while (file_info->current_start_sector < sector)
     {
         uint16 bytes_to_drop = BYTES_PER_SECTOR;
         while (bytes_to_drop)
@@ -227,8 +224,65 @@ static uint32 usbMsc_ReadSectors(Sink sink, FileInfoType *file_info,
         file_info->current_start_sector++;
         DEBUG_LOG_DEBUG("UsbMsc::FAT16:     seeking... %ld",
                         file_info->current_start_sector);
-    }    
+    }
+}
+
+/* Copy the sector at the file source position to data, padding the part
+ * past the end of the file with zeros */
+static void usbMsc_CopySector(FileInfoType *file_info, uint8 *data)
+{
+    uint32 remaining_bytes = file_info->size -
+                               (file_info->current_start_sector * BYTES_PER_SECTOR);
+    uint16 data_size = (uint16)MIN(BYTES_PER_SECTOR, remaining_bytes);
+    uint16 data_pos = 0;
+
+    while (data_pos < data_size)
+    {
+        uint16 source_size = SourceSize(file_info->src);
+        uint16 bytes_to_read = MIN(source_size, data_size - data_pos);
+
+        if (!bytes_to_read)
+        {
+            DEBUG_LOG_ERROR("UsbMsc::FAT16:     file ended early");
+            break;
+        }
+
+        const uint8 *file_data = SourceMap(file_info->src);
+        memcpy(&data[data_pos], file_data, bytes_to_read);
+        SourceDrop(file_info->src, bytes_to_read);
+
+        data_pos += bytes_to_read;
+    }
+
+    if (data_pos < BYTES_PER_SECTOR)
+    {
+        memset(&data[data_pos], 0, BYTES_PER_SECTOR - data_pos);
+    }
+
+    file_info->current_start_sector += 1;
+}
+
+static uint32 usbMsc_ReadSectors(Sink sink, FileInfoType *file_info,
+                           uint32 logical_address, uint32 transfer_length,
+                           uint32 area_start_sector)
+{
+    uint32 start_sector;
+    uint32 end_sector;
+    uint32 file_end_sector = file_info->end_sector;
+
+    /* correct end sector for FAT2, as it's otherwise treated as FAT1 */
+    if (area_start_sector == FAT2_SECTOR)
+        file_end_sector += SECTORS_PER_FAT;
     
+    /* find the start sector and end sector for this type of data */
+    start_sector = logical_address - area_start_sector;
+    end_sector = start_sector + transfer_length - 1;
+    end_sector = MIN(end_sector, (file_end_sector - area_start_sector));
+
+    DEBUG_LOG_DEBUG("UsbMsc::FAT16:     [%ld:%ld]", start_sector, end_sector);
+
+    usbMsc_SeekSector(file_info, start_sector);
+
     /* send the data in the sectors from start_sector to end_sector */
     while (file_info->current_start_sector <= end_sector)
     {
@@ -242,32 +296,106 @@ static uint32 usbMsc_ReadSectors(Sink sink, FileInfoType *file_info,
             break;
         }
 
-        uint16 remaining_bytes = file_info->size -
-                                   (file_info->current_start_sector * BYTES_PER_SECTOR);
-        uint16 data_size = MIN(BYTES_PER_SECTOR, remaining_bytes);
-        uint16 data_pos = 0;
+        usbMsc_CopySector(file_info, tx_data);
+        SinkFlush(sink, BYTES_PER_SECTOR);
+    }
+    
+    /* return the next logical address to process */
+    return logical_address + end_sector - start_sector + 1;
+}
 
-        while (data_pos < data_size)
-        {
-            uint16 source_size = SourceSize(file_info->src);
-            uint16 bytes_to_read = MIN(source_size, data_size - data_pos);
+/* Read the sector following those in the read-ahead buffer from the file */
+static void usbMsc_ReadAheadSector(FileInfoType *file_info, ReadAheadType *read_ahead)
+{
+    uint32 sector = read_ahead->first_sector + read_ahead->count;
+
+    usbMsc_CopySector(file_info, READ_AHEAD_SLOT(read_ahead, sector));
+    read_ahead->count++;
+}
+
+/* Reads from the data area are served from the read-ahead buffer.
+ * While waiting for the host to make space in the sink, the sectors that
+ * follow are read from the file, so that the copy from the file overlaps
+ * the USB transfer. When the host reads sequentially, the buffer is also
+ * filled after the last sector of a command, ready for its next one. */
+static uint32 usbMsc_ReadDataSectors(usb_msc_class_data_t *msc, uint32 logical_address,
+                                     uint32 transfer_length, bool sequential)
+{
+    FileInfoType *file_info = &msc->file_info[FILE_INFO_DATA];
+    ReadAheadType *read_ahead = &msc->read_ahead;
+    Sink sink = msc->ep_sink;
+    uint32 file_end_sector = file_info->end_sector - DATA_SECTOR;
+    uint32 start_sector = logical_address - DATA_SECTOR;
+    uint32 end_sector = MIN(start_sector + transfer_length - 1, file_end_sector);
+    uint32 fill_end_sector = sequential ? file_end_sector : end_sector;
+    uint32 sector;
+
+    DEBUG_LOG_DEBUG("UsbMsc::FAT16:     [%ld:%ld] read ahead %d",
+                    start_sector, end_sector, read_ahead->count);
+
+    if (!read_ahead->buffer)
+    {
+        read_ahead->buffer = PanicUnlessMalloc(READ_AHEAD_SECTORS * BYTES_PER_SECTOR);
+        read_ahead->count = 0;
+    }
+
+    if ((start_sector < read_ahead->first_sector) ||
+        (start_sector >= read_ahead->first_sector + read_ahead->count))
+    {
+        /* not read ahead, start again from the requested sector */
+        usbMsc_SeekSector(file_info, start_sector);
+        read_ahead->first_sector = start_sector;
+        read_ahead->count = 0;
+    }
+    else
+    {
+        /* drop sectors the host has skipped */
+        read_ahead->count -= (uint8)(start_sector - read_ahead->first_sector);
+        read_ahead->first_sector = start_sector;
+    }
 
-            const uint8 *file_data = SourceMap(file_info->src);
-            memcpy(&tx_data[data_pos], file_data, bytes_to_read);
-            SourceDrop(file_info->src, bytes_to_read);
+    for (sector = start_sector; sector <= end_sector; sector++)
+    {
+        if (read_ahead->count)
+        {
+            Metrics_Increment(usb_msc_read_ahead_sectors);
+        }
+        else
+        {
+            usbMsc_ReadAheadSector(file_info, read_ahead);
+        }
 
-            data_pos += bytes_to_read;
+        /* read the following sectors while the host empties the sink */
+        while ((SinkSlack(sink) < BYTES_PER_SECTOR) &&
+                (UsbDeviceState() == usb_device_state_configured))
+        {
+            if ((read_ahead->count < READ_AHEAD_SECTORS) &&
+                (read_ahead->first_sector + read_ahead->count <= fill_end_sector))
+            {
+                usbMsc_ReadAheadSector(file_info, read_ahead);
+            }
         }
 
-        if (data_size < BYTES_PER_SECTOR)
+        uint8 *tx_data = SinkMapClaim(sink, BYTES_PER_SECTOR);
+        if (!tx_data)
         {
-            memset(&tx_data[data_size], 0, BYTES_PER_SECTOR - data_size);
+            DEBUG_LOG_ERROR("UsbMsc::FAT16:     sink claim failed");
+            break;
         }
 
+        memcpy(tx_data, READ_AHEAD_SLOT(read_ahead, sector), BYTES_PER_SECTOR);
         SinkFlush(sink, BYTES_PER_SECTOR);
-        file_info->current_start_sector += 1;
+        read_ahead->first_sector++;
+        read_ahead->count--;
     }
-    
+
+    /* have the next sectors ready while the host sends its next command */
+    while ((read_ahead->count < READ_AHEAD_SECTORS) &&
+           (read_ahead->first_sector + read_ahead->count <= fill_end_sector))
+    {
+        usbMsc_ReadAheadSector(file_info, read_ahead);
+    }
+
     /* return the next logical address to process */
     return logical_address + end_sector - start_sector + 1;
 }
@@ -306,9 +434,11 @@ void UsbMsc_Fat16_Read(usb_msc_class_data_t *msc, uint32 logical_address, uint32
 {       
     uint32 end_address = logical_address + transfer_length - 1;
     Sink sink_bulk_out = msc->ep_sink;
+    bool sequential = (logical_address == msc->next_read_address);
+    uint32 start_time = VmGetClock();
     
-    DEBUG_LOG_DEBUG("UsbMsc::FAT16: read [%ld:%ld]",
-            logical_address, end_address);
+    DEBUG_LOG_DEBUG("UsbMsc::FAT16: read [%ld:%ld] sequential %d",
+            logical_address, end_address, sequential);
     
     if (!msc->info_read)
     {
@@ -412,8 +542,8 @@ void UsbMsc_Fat16_Read(usb_msc_class_data_t *msc, uint32 logical_address, uint32
                 (logical_address <= msc->file_info[FILE_INFO_DATA].end_sector)) /* Data Area */
         {
             DEBUG_LOG_DEBUG("UsbMsc::FAT16:   DATA");
-            logical_address = usbMsc_ReadSectors(sink_bulk_out, &msc->file_info[FILE_INFO_DATA],
-                    logical_address, end_address - logical_address + 1, DATA_SECTOR);
+            logical_address = usbMsc_ReadDataSectors(msc, logical_address,
+                    end_address - logical_address + 1, sequential);
         }
         else /* sector with no data */
         {
@@ -433,6 +563,20 @@ void UsbMsc_Fat16_Read(usb_msc_class_data_t *msc, uint32 logical_address, uint32
             logical_address++;
         }
     }
+
+    msc->next_read_address = end_address + 1;
+
+    if (sequential && transfer_length >= READ_RATE_MIN_SECTORS)
+    {
+        uint32 elapsed_ms = VmGetClock() - start_time;
+        if (elapsed_ms)
+        {
+            /* bytes per ms is kB/s */
+            uint32 rate_kbps = (transfer_length * BYTES_PER_SECTOR) / elapsed_ms;
+            DEBUG_LOG_DEBUG("UsbMsc::FAT16: read rate %ld kB/s", rate_kbps);
+            Metrics_Record(usb_msc_read_rate, rate_kbps);
+        }
+    }
 }
 
 
@@ -93,6 +93,7 @@ typedef enum
     GAIA_COMMAND_RES,                   /*!< Indication that a command has been received */
     GAIA_UPGRADE_CONNECT_IND,           /*!< Indication of VM Upgrade successful connection */
     GAIA_UPGRADE_DISCONNECT_IND,        /*!< Indication of VM Upgrade is disconnected*/
+    GAIA_MORE_SPACE_IND,                /*!< Indication that a transport has space to send again */
 
     /* Library message limit */
     GAIA_MESSAGE_TOP
@@ -185,6 +186,14 @@ typedef struct
 } GAIA_HANDOVER_IND_T;
 
 
+/*! @brief Message indicating a transport has space to send again, see Gaia_TransportRequestMoreSpaceInd().
+ */
+typedef struct
+{
+    GAIA_TRANSPORT *transport;          /*!< Indicates the GAIA instance */
+} GAIA_MORE_SPACE_IND_T;
+
+
 /*! @brief Message confirming the status of a Start Service request initiated by a client task.
  */
 typedef struct
@@ -388,7 +397,10 @@ typedef struct
     /*! Indication that packet has been handled and transport can free any resources associated with packet */
     void (*packet_handled)(struct _gaia_transport *t, uint16 size_payload, const void *payload);
 
-    /*! Send packet over command channel */
+    /*! Send packet over command channel.
+        Returns TRUE once the packet has been accepted. A transport may batch
+        packets and send them after the current message has been handled, so
+        TRUE does not mean the packet has been sent. */
     bool (*send_command_packet)(struct _gaia_transport *t, uint16 vendor_id, uint16 command_id,
                                 uint8 status, uint16 size_payload, const void *payload);
 
@@ -401,7 +413,8 @@ typedef struct
     /*! Get data endpoint payload was received on */
     gaia_data_endpoint_mode_t (*get_payload_data_endpoint)(struct _gaia_transport *t, uint16 size_payload, const uint8 *payload);
 
-    /*! Send packet over data channel (maybe same as command channel on transports that don't support separate data channel) */
+    /*! Send packet over data channel (maybe same as command channel on transports that don't support separate data channel).
+        As with send_command_packet, TRUE may be returned before the packet is sent. */
     bool (*send_data_packet)(struct _gaia_transport *t, uint16 vendor_id, uint16 command_id,
                              uint8 status, uint16 size_payload, const void *payload);
 
@@ -429,6 +442,9 @@ typedef struct
     /*! Marshal the data associated with the specified connection */
     bool (*handover_marshal)(struct _gaia_transport *t, uint8 *buf, uint16 length, uint16 *written);
 
+    /*! Get the number of bytes handover_marshal will write for the connection */
+    uint16 (*handover_estimate_size)(struct _gaia_transport *t);
+
     /*! Unmarshal the data associated with the specified connection */
     bool (*handover_unmarshal)(struct _gaia_transport *t, const uint8 *buf, uint16 length, uint16 *consumed);
 
@@ -506,6 +522,7 @@ typedef struct _gaia_transport
     uint32 client_data;
     tp_bdaddr tp_bd_addr;
     gaia_transport_tx_packet_buffer_t *tx_pkt_buf;          /*!< Tx packet buffer malloc'ed in the heap. */
+    bool more_space_wanted;                                 /*!< GAIA_MORE_SPACE_IND is to be sent when there is space. */
 } gaia_transport;
 
 void Gaia_TransportRegister(gaia_transport_type, const gaia_transport_functions_t *);
@@ -538,6 +555,20 @@ void Gaia_TransportStopServiceCfm(gaia_transport *t, bool success);
  */
 void Gaia_TransportErrorInd(gaia_transport *t, gaia_transport_error error);
 
+/*! @brief Indication from transport that it has space to send again.
+
+    Ends the GAIA_TRANSPORT_BUSY state, and sends GAIA_MORE_SPACE_IND to the
+    client task if it was requested with Gaia_TransportRequestMoreSpaceInd().
+ */
+void Gaia_TransportMoreSpaceInd(gaia_transport *t);
+
+/*! @brief Request a GAIA_MORE_SPACE_IND the next time the transport has space to send.
+
+    The transport must deliver MESSAGE_MORE_SPACE, or an equivalent, to
+    Gaia_TransportMoreSpaceInd() for the indication to be sent.
+ */
+void Gaia_TransportRequestMoreSpaceInd(gaia_transport *t);
+
 /*! @brief Find transport of a specific type
  */
 gaia_transport *Gaia_TransportFindService(gaia_transport_type type, gaia_transport_index *index);
@@ -595,8 +626,10 @@ uint8* Gaia_TransportCreatePacket(gaia_transport *t, const uint16 vendor_id, con
     @param[in] t Pointer to transport
     @param[in] size_payload Size of payload to be claimed.
     @param[in] payload Pointer to the start of the payload.
+
+    @return TRUE if the packet was sent, FALSE if it was dropped.
  */
-void Gaia_TransportFlushPacket(gaia_transport *t, const uint16 size_payload, const uint8 *payload);
+bool Gaia_TransportFlushPacket(gaia_transport *t, const uint16 size_payload, const uint8 *payload);
 
 
 /*! @brief Set data endpoint mode for a given transport. (Only supported for GATT curently)
@@ -210,5 +210,7 @@ void gaia_TransportSendGaiaStopServiceCfm(gaia_transport_type transport_type, ga
 
 void gaia_TransportSendGaiaHandoverInd(gaia_transport *transport, bool success, bool is_primary);
 
+void gaia_TransportSendGaiaMoreSpaceInd(gaia_transport *transport);
+
 
 #endif /* ifdef _GAIA_PRIVATE_H_ */
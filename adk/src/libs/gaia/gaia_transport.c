@@ -146,21 +146,23 @@ uint8* Gaia_TransportCreatePacket(gaia_transport *t, const uint16 vendor_id, con
     return NULL;
 }
 
-void Gaia_TransportFlushPacket(gaia_transport *t, const uint16 size_payload, const uint8 *payload)
+bool Gaia_TransportFlushPacket(gaia_transport *t, const uint16 size_payload, const uint8 *payload)
 {
+    bool sent = FALSE;
+
     PanicNull(t);
     if (t->functions->flush_packet)
-        t->functions->flush_packet(t, size_payload, payload);
+        sent = t->functions->flush_packet(t, size_payload, payload);
     else
     {
         /* Fall back to pmalloc'ed packet that size is limited. */
         if (t->tx_pkt_buf)
         {
             PanicNull((void*)(t->functions->send_command_packet));
-            t->functions->send_command_packet(t, t->tx_pkt_buf->vendor_id,
-                                              t->tx_pkt_buf->command_id, GAIA_STATUS_NONE,
-                                              t->tx_pkt_buf->payload_length,
-                                              &t->tx_pkt_buf->payload[0]);
+            sent = t->functions->send_command_packet(t, t->tx_pkt_buf->vendor_id,
+                                                     t->tx_pkt_buf->command_id, GAIA_STATUS_NONE,
+                                                     t->tx_pkt_buf->payload_length,
+                                                     &t->tx_pkt_buf->payload[0]);
             free(t->tx_pkt_buf);
             t->tx_pkt_buf = NULL;
         }
@@ -170,6 +172,7 @@ void Gaia_TransportFlushPacket(gaia_transport *t, const uint16 size_payload, con
             Panic();
         }
     }
+    return sent;
 }
 
 
@@ -382,6 +385,7 @@ void Gaia_TransportDisconnectInd(gaia_transport *t)
         free(t->tx_pkt_buf);
         t->tx_pkt_buf = NULL;
     }
+    t->more_space_wanted = FALSE;
     t->state = GAIA_TRANSPORT_STARTED;
 }
 
@@ -397,6 +401,29 @@ void Gaia_TransportErrorInd(gaia_transport *t, gaia_transport_error error)
 }
 
 
+void Gaia_TransportMoreSpaceInd(gaia_transport *t)
+{
+    PanicNull(t);
+
+    /* Packets can be sent again after running out of space */
+    if (t->state == GAIA_TRANSPORT_BUSY)
+        t->state = GAIA_TRANSPORT_CONNECTED;
+
+    if (t->more_space_wanted && t->state == GAIA_TRANSPORT_CONNECTED)
+    {
+        t->more_space_wanted = FALSE;
+        gaia_TransportSendGaiaMoreSpaceInd(t);
+    }
+}
+
+
+void Gaia_TransportRequestMoreSpaceInd(gaia_transport *t)
+{
+    PanicNull(t);
+    t->more_space_wanted = TRUE;
+}
+
+
 gaia_transport *Gaia_TransportIterate(gaia_transport_index *index)
 {
     gaia_transport *t;
@@ -78,6 +78,13 @@ void gaia_TransportSendGaiaHandoverInd(gaia_transport *transport, bool success,
     MessageSend(gaia.app_task, GAIA_HANDOVER_IND, ghi);
 }
 
+void gaia_TransportSendGaiaMoreSpaceInd(gaia_transport *transport)
+{
+    MESSAGE_PMAKE(gmi, GAIA_MORE_SPACE_IND_T);
+    gmi->transport = (GAIA_TRANSPORT *)transport;
+    MessageSend(gaia.app_task, GAIA_MORE_SPACE_IND, gmi);
+}
+
 /*  It's that diagram again ... Gaia V1 protocol packet
  *  0 bytes  1        2        3        4        5        6        7        8          9    len+8      len+9
  *  +--------+--------+--------+--------+--------+--------+--------+--------+ +--------+--/ /---+ +--------+
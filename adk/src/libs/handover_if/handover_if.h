@@ -1,5 +1,5 @@
 /****************************************************************************
-Copyright (c) 2019-2021 Qualcomm Technologies International, Ltd.
+Copyright (c) 2019-2023 Qualcomm Technologies International, Ltd.
 
 
 FILE NAME
@@ -32,6 +32,15 @@ DESCRIPTION
         choose to implement the handover_veto_link function instead of, or as
         well as the handover_veto function. The _VPL macros may then be used
         to create the interface structure.
+        Libraries may optionally implement handover_estimate_size so that
+        the handover profile can size the marshal buffer exactly. The
+        MAKE_HANDOVER_IF_ESTIMATE macro may then be used to create the
+        interface structure.
+        Libraries whose handover_marshal has no side effects may ask the
+        handover profile to pre-marshal them ahead of handover by creating
+        the interface with the _SNAPSHOT macros. Such a library must call
+        HandoverProfile_InvalidateP1Snapshot() whenever any of its marshalled
+        state changes.
 
 \example Usage example
 
@@ -174,6 +183,19 @@ typedef bool (*handover_marshal)(const tp_bdaddr *tp_bd_addr,
 
 
 
+/*!
+    \brief Estimate the size of the marshal data for the specified connection
+
+    Called before handover_marshal for the same connection, without any
+    change of state in between.
+
+    \param tp_bd_addr Bluetooth address of the link to be marshalled
+    \return Number of bytes handover_marshal will write for the link. This must
+            not be less than what handover_marshal actually writes.
+
+*/
+typedef uint16 (*handover_estimate_size)(const tp_bdaddr *tp_bd_addr);
+
 /*!
     \brief Unmarshal the data associated with the specified connection
 
@@ -261,6 +283,8 @@ typedef struct
     handover_commit     pFnCommit;      /*!< Pointer to the component's handover_commit function */
     handover_complete   pFnComplete;    /*!< Pointer to the component's handover_complete function */
     handover_abort      pFnAbort;       /*!< Pointer to the component's handover_abort function */
+    handover_estimate_size pFnEstimateSize; /*!< Pointer to the component's optional handover_estimate_size function */
+    bool                snapshot;       /*!< TRUE if the component's marshal data may be pre-marshalled ahead of handover */
 } handover_interface;
 
 /*! Macro to define structure of handover interface that support only BR/EDR ACL handover */
@@ -287,5 +311,13 @@ typedef struct
 #define MAKE_BLE_HANDOVER_IF_VPL(VETO, VETO_LINK, MARSHAL, UNMARSHAL, COMMIT, COMPLETE, ABORT) \
     {TRANSPORT_BLE_ACL, VETO, VETO_LINK, MARSHAL, UNMARSHAL, COMMIT, COMPLETE, ABORT}
 
+/*! Macro to define structure of handover interface for the given transport, with a veto per link and a marshal size estimate */
+#define MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT, VETO, VETO_LINK, ESTIMATE_SIZE, MARSHAL, UNMARSHAL, COMMIT, COMPLETE, ABORT) \
+    {TRANSPORT, VETO, VETO_LINK, MARSHAL, UNMARSHAL, COMMIT, COMPLETE, ABORT, ESTIMATE_SIZE}
+
+/*! Macro to define structure of handover interface that support only BLE ACL handover, pre-marshalled ahead of handover */
+#define MAKE_BLE_HANDOVER_IF_SNAPSHOT(VETO, MARSHAL, UNMARSHAL, COMMIT, COMPLETE, ABORT) \
+    {TRANSPORT_BLE_ACL, VETO, NULL, MARSHAL, UNMARSHAL, COMMIT, COMPLETE, ABORT, NULL, TRUE}
+
 
 #endif /* HANDOVER_IF_H_ */
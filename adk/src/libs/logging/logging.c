@@ -1,5 +1,5 @@
 /*!
-\copyright  Copyright (c) 2008 - 2022 Qualcomm Technologies International, Ltd.\n
+\copyright  Copyright (c) 2008 - 2023 Qualcomm Technologies International, Ltd.\n
             All Rights Reserved.\n
             Qualcomm Technologies International, Ltd. Confidential and Proprietary.
 \version    
@@ -34,58 +34,135 @@ debug_log_level_t debug_log_level__global = DEFAULT_LOG_LEVEL;
 
 const debug_log_callbacks_t *debug_log_callbacks = NULL;
 
-void debugLogData(const uint8 *data, uint16 data_size)
-{
+/*! Maximum number of data octets logged by one DEBUG_LOG_DATA call,
+    longer buffers are truncated. Can be changed with DebugLog_ConfigureData(). */
+static uint16 debug_log_data_max_size = DEBUG_LOG_DATA_DEFAULT_MAX_SIZE;
+
+/*! Only one in this many calls of each DEBUG_LOG_DATA statement is logged. */
+static uint16 debug_log_data_sample_interval = 1;
+
+static debug_log_data_stats_t debug_log_data_stats;
+
 #if !defined(DESKTOP_BUILD) && defined(INSTALL_HYDRA_LOG)
-    while (data_size >= 8)
+
+/*! Number of data octets carried by one DATA log event.
+    Each event has the logged and total data size followed by the data
+    packed into 32 bit words, so it fits within the 16 arguments supported
+    by the logging macros. */
+#define DEBUG_LOG_DATA_WORDS_PER_RECORD     (12)
+#define DEBUG_LOG_DATA_OCTETS_PER_RECORD    (DEBUG_LOG_DATA_WORDS_PER_RECORD * 4)
+
+/*! Number of log buffer words used by the previous text format, which
+    logged 8 octets as 8 separate arguments per record. */
+#define DEBUG_LOG_DATA_TEXT_WORDS(size) \
+    ((((size) + 7) / 8) * (1 + EXTRA_LOGGING_NUM_PARAMS) + (size))
+
+/* The record format strings. The data words are packed most significant
+   octet first, so "%08x" displays the octets in buffer order. The final word
+   is padded with zero octets, the size in the header shows how many are valid. */
+HYDRA_LOG_STRING(debug_log_data_fmt_1,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_2,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_3,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_4,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_5,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_6,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_7,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_8,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_9,  EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_10, EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_11, EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x");
+HYDRA_LOG_STRING(debug_log_data_fmt_12, EXTRA_LOGGING_STRING "DATA %u/%u: %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x");
+
+static const char * const debug_log_data_fmt[DEBUG_LOG_DATA_WORDS_PER_RECORD] =
+{
+    debug_log_data_fmt_1,  debug_log_data_fmt_2,  debug_log_data_fmt_3,
+    debug_log_data_fmt_4,  debug_log_data_fmt_5,  debug_log_data_fmt_6,
+    debug_log_data_fmt_7,  debug_log_data_fmt_8,  debug_log_data_fmt_9,
+    debug_log_data_fmt_10, debug_log_data_fmt_11, debug_log_data_fmt_12
+};
+
+/*! \brief Log up to DEBUG_LOG_DATA_OCTETS_PER_RECORD octets as a single record.
+
+    \return Number of log buffer words used.
+*/
+static uint16 debugLogDataRecord(const uint8 *data, uint16 record_size, uint16 offset, uint16 total_size)
+{
+    uint32 w[DEBUG_LOG_DATA_WORDS_PER_RECORD] = {0};
+    uint16 num_words = (record_size + 3) / 4;
+    uint16 i;
+
+    for (i = 0; i < record_size; i++)
     {
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x %02x %02x %02x %02x %02x %02x",
-                             data[0], data[1], data[2], data[3],
-                             data[4], data[5], data[6], data[7]);
-        data += 8;
-        data_size -= 8;
+        w[i / 4] |= (uint32)data[i] << (8 * (3 - (i % 4)));
     }
 
-    switch (data_size)
+    /* Only the number of arguments given by the format string are read, the
+       remaining words are ignored. */
+    hydra_log_firm_variadic(debug_log_data_fmt[num_words - 1],
+                            2 + num_words + EXTRA_LOGGING_NUM_PARAMS EXTRA_LOGGING_PARAMS,
+                            offset + record_size, total_size,
+                            w[0], w[1], w[2], w[3], w[4], w[5],
+                            w[6], w[7], w[8], w[9], w[10], w[11]);
+
+    return 1 + EXTRA_LOGGING_NUM_PARAMS + 2 + num_words;
+}
+#endif
+
+void debugLogData(const uint8 *data, uint16 data_size, uint16 *sample_count)
+{
+    uint16 total_size = data_size;
+
+    /* Each DEBUG_LOG_DATA statement has its own count of calls since it last logged */
+    if (++(*sample_count) < debug_log_data_sample_interval)
     {
-    case 7:
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x %02x %02x %02x %02x %02x",
-                             data[0], data[1], data[2], data[3],
-                             data[4], data[5], data[6]);
-        break;
-    case 6:
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x %02x %02x %02x %02x",
-                             data[0], data[1], data[2], data[3],
-                             data[4], data[5]);
-        break;
-    case 5:
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x %02x %02x %02x",
-                             data[0], data[1], data[2], data[3],
-                             data[4]);
-        break;
-    case 4:
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x %02x %02x",
-                             data[0], data[1], data[2], data[3]);
-        break;
-    case 3:
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x %02x",
-                             data[0], data[1], data[2]);
-        break;
-    case 2:
-        _DEBUG_LOG_UNCONDITIONAL("%02x %02x",
-                             data[0], data[1]);
-        break;
-    case 1:
-        _DEBUG_LOG_UNCONDITIONAL("%02x",
-                             data[0]);
-        break;
-    default:
-        break;
+        debug_log_data_stats.records_skipped++;
+        return;
+    }
+    *sample_count = 0;
+
+    if (data_size > debug_log_data_max_size)
+    {
+        debug_log_data_stats.octets_truncated += data_size - debug_log_data_max_size;
+        data_size = debug_log_data_max_size;
+    }
+
+#if !defined(DESKTOP_BUILD) && defined(INSTALL_HYDRA_LOG)
+    {
+        uint16 offset = 0;
+        uint32 words = 0;
+
+        while (offset < data_size)
+        {
+            uint16 record_size = data_size - offset;
+
+            if (record_size > DEBUG_LOG_DATA_OCTETS_PER_RECORD)
+            {
+                record_size = DEBUG_LOG_DATA_OCTETS_PER_RECORD;
+            }
+
+            words += debugLogDataRecord(&data[offset], record_size, offset, total_size);
+            offset += record_size;
+        }
+
+        debug_log_data_stats.words_logged += words;
+        debug_log_data_stats.words_text_format += DEBUG_LOG_DATA_TEXT_WORDS(data_size);
     }
 #else
     UNUSED(data);
-    UNUSED(data_size);
+    UNUSED(total_size);
 #endif
+    debug_log_data_stats.records_logged++;
+}
+
+void DebugLog_ConfigureData(uint16 max_size, uint16 sample_interval)
+{
+    debug_log_data_max_size = max_size;
+    debug_log_data_sample_interval = sample_interval ? sample_interval : 1;
+}
+
+void DebugLog_GetDataStatistics(debug_log_data_stats_t *stats)
+{
+    *stats = debug_log_data_stats;
 }
 
 const debug_log_callbacks_t *DebugLog_RegisterCallbacks(const debug_log_callbacks_t *callback)
@@ -1,5 +1,5 @@
 /*!
-\copyright  Copyright (c) 2008 - 2022 Qualcomm Technologies International, Ltd.\n
+\copyright  Copyright (c) 2008 - 2023 Qualcomm Technologies International, Ltd.\n
             All Rights Reserved.\n
             Qualcomm Technologies International, Ltd. Confidential and Proprietary.
 \version    
@@ -319,7 +319,7 @@ typedef enum {
 #define DEBUG_LOG_FN_ENTRY DEBUG_LOG_DEBUG
 #define DEBUG_LOG_PANIC(...) do{DEBUG_LOG_ERROR(__VA_ARGS__); Panic();}while(0)
 
-extern void debugLogData(const uint8 *data, uint16 data_size);
+extern void debugLogData(const uint8 *data, uint16 data_size, uint16 *sample_count);
 
 #define DEBUG_LOG_DATA_ERROR(...)        _DEBUG_LOG_DATA_L(DEBUG_LOG_LEVEL_ERROR,     __VA_ARGS__)
 #define DEBUG_LOG_DATA_WARN(...)         _DEBUG_LOG_DATA_L(DEBUG_LOG_LEVEL_WARN,      __VA_ARGS__)
@@ -390,6 +390,49 @@ typedef struct
 */
 const debug_log_callbacks_t *DebugLog_RegisterCallbacks(const debug_log_callbacks_t *callbacks);
 
+/*! Default maximum number of octets logged by one DEBUG_LOG_DATA call.
+    There is no limit unless one is set with DebugLog_ConfigureData(). */
+#define DEBUG_LOG_DATA_DEFAULT_MAX_SIZE     (0xFFFF)
+
+/*! \brief Statistics of DEBUG_LOG_DATA logging. */
+typedef struct
+{
+    /*! Number of DEBUG_LOG_DATA calls that were logged */
+    uint32 records_logged;
+    /*! Number of DEBUG_LOG_DATA calls that were dropped by sampling */
+    uint32 records_skipped;
+    /*! Number of octets not logged because of the size limit */
+    uint32 octets_truncated;
+    /*! Number of log buffer words used by data records */
+    uint32 words_logged;
+    /*! Number of log buffer words the same data would have used when logged
+        as one text record per 8 octets */
+    uint32 words_text_format;
+} debug_log_data_stats_t;
+
+/*! \brief Configure DEBUG_LOG_DATA logging.
+
+    DEBUG_LOG_DATA logs the data as log events of up to 48 octets, packed
+    into 32 bit words that the log tools display with a "%08x" format as
+    "DATA <logged>/<total>: <words>".
+
+    By default all the data is logged, on every call.
+
+    \param max_size        Maximum number of octets logged per call, longer
+                            data is truncated. The total size is still shown.
+    \param sample_interval Only one in every sample_interval calls from the
+                            same DEBUG_LOG_DATA statement is logged, each
+                            statement is sampled separately. 0 or 1 logs
+                            every call.
+*/
+void DebugLog_ConfigureData(uint16 max_size, uint16 sample_interval);
+
+/*! \brief Get the statistics of DEBUG_LOG_DATA logging.
+
+    \param[out] stats  Filled in with the statistics.
+*/
+void DebugLog_GetDataStatistics(debug_log_data_stats_t *stats);
+
 /*! \brief Internal function. DO NOT USE.
 
     Implementation of debug_log_callback_t.
@@ -576,10 +619,11 @@ extern void DEBUG_LOG_FOR_LEVEL(LOG_LEVEL_CURRENT_SYMBOL,DEBUG_LOG_LEVEL_V_VERBO
 
 #define _DEBUG_LOG_DATA_L(level, data, data_size) \
             do { \
+                static uint16 log_data_sample_count; \
                 bool do_log = DebugLog_DataCallback(&LOG_LEVEL_CURRENT_SYMBOL, level, data, data_size); \
                 if(level<=LOG_LEVEL_CURRENT_SYMBOL && do_log) \
                 { \
-                    debugLogData(data, data_size); \
+                    debugLogData(data, data_size, &log_data_sample_count); \
                 } \
             } while (0)
 
@@ -596,9 +640,10 @@ extern void DEBUG_LOG_FOR_LEVEL(LOG_LEVEL_CURRENT_SYMBOL,DEBUG_LOG_LEVEL_V_VERBO
 
 #define _DEBUG_LOG_DATA_L(level, data, data_size) \
             do { \
+                static uint16 log_data_sample_count; \
                 if(level<=DEFAULT_LOG_FOR_DISABLED_LEVELS) \
                 { \
-                    debugLogData(data, data_size); \
+                    debugLogData(data, data_size, &log_data_sample_count); \
                 } \
             } while (0)
 
@@ -618,7 +663,10 @@ extern void DEBUG_LOG_FOR_LEVEL(LOG_LEVEL_CURRENT_SYMBOL,DEBUG_LOG_LEVEL_V_VERBO
             } while (0)
 
 #define _DEBUG_LOG_DATA_L(level, data, data_size) \
-            debugLogData(data, data_size)
+            do { \
+                static uint16 log_data_sample_count; \
+                debugLogData(data, data_size, &log_data_sample_count); \
+            } while (0)
 
 /* No per-module log levels */
 #define DEBUG_LOG_DEFINE_LEVEL_VAR
@@ -295,6 +295,12 @@ typedef struct
     uint16 subframe_resolution;
 } usb_audio_rx_configure_msg_t;
 
+typedef struct
+{
+    uint16 id;
+    uint16 enable;
+} usb_audio_rx_host_rate_feedback_msg_t;
+
 typedef struct
 {
     uint16 id;
@@ -1709,6 +1715,29 @@ void OperatorsUsbAudioSetConfig(Operator op, usb_config_t config)
     PanicFalse(VmalOperatorMessage(op, (void*)&msg, SIZEOF_OPERATOR_MESSAGE(msg), NULL, 0));
 }
 
+bool OperatorsUsbAudioGetRateMismatch(Operator op, int32 *mismatch_ppm)
+{
+    uint16 recv_msg[3];
+    uint16 msg_id = USB_AUDIO_GET_RATE_MISMATCH;
+
+    /* uint16 response[]: message_id, mismatch msw, mismatch lsw */
+    if (!VmalOperatorMessage(op, &msg_id, SIZEOF_OPERATOR_MESSAGE(msg_id), recv_msg, SIZEOF_OPERATOR_MESSAGE(recv_msg)))
+        return FALSE;
+
+    *mismatch_ppm = (int32)(((uint32)recv_msg[1] << 16) | recv_msg[2]);
+    return TRUE;
+}
+
+void OperatorsUsbAudioSetHostRateFeedback(Operator op, bool enable)
+{
+    usb_audio_rx_host_rate_feedback_msg_t msg;
+
+    msg.id = USB_AUDIO_SET_HOST_RATE_FEEDBACK;
+    msg.enable = enable ? 1 : 0;
+
+    PanicFalse(VmalOperatorMessage(op, (void*)&msg, SIZEOF_OPERATOR_MESSAGE(msg), NULL, 0));
+}
+
 void OperatorsSbcEncoderSetEncodingParams(Operator op, const sbc_encoder_params_t *params)
 {
     sbc_encoder_set_encoding_params_msg_t msg;
@@ -1189,6 +1189,22 @@ DESCRIPTION
  */
 void OperatorsUsbAudioSetConfig(Operator op, usb_config_t config);
 
+/****************************************************************************
+DESCRIPTION
+     Get the mismatch between the local clock and the USB packet rate measured
+     by a Usb Audio RX, in ppm. Positive when the local clock is faster.
+     Returns FALSE if the operator could not report it.
+ */
+bool OperatorsUsbAudioGetRateMismatch(Operator op, int32 *mismatch_ppm);
+
+/****************************************************************************
+DESCRIPTION
+     Tell a Usb Audio RX whether the host adapts its rate to an explicit
+     feedback endpoint. When enabled the operator reports a perfect rate so
+     the measured mismatch is not also corrected by rate matching.
+ */
+void OperatorsUsbAudioSetHostRateFeedback(Operator op, bool enable);
+
 /****************************************************************************
 DESCRIPTION
      Set SBC encoder encoding parameters.
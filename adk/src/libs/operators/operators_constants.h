@@ -61,6 +61,8 @@ DESCRIPTION
 #define GET_APVA_METADATA        0x0004
 
 #define USB_AUDIO_SET_CONNECTION_CONFIG 0x0002
+#define USB_AUDIO_GET_RATE_MISMATCH     0x0005
+#define USB_AUDIO_SET_HOST_RATE_FEEDBACK 0x0006
 
 #define SBC_ENCODER_SET_ENCODING_PARAMS 0x0001
 
@@ -188,6 +188,103 @@ static ProtobufCAllocator protobuf_c__allocator = {
     .allocator_data = NULL,
 };
 
+/* === arena === */
+
+/*
+ * Alignment of allocations from an arena. Sufficient for any field type,
+ * including 64-bit integers and doubles.
+ */
+#define PROTOBUF_C_ARENA_ALIGN		8
+
+/*
+ * Minimum size of a heap block allocated when the scratch buffer of an arena
+ * is exhausted. Larger requests get a block of their own.
+ */
+#define PROTOBUF_C_ARENA_BLOCK_SIZE	256
+
+struct ProtobufCArenaBlock {
+    ProtobufCArenaBlock	*next;
+    size_t			size;
+    size_t			used;
+    /* Keep data aligned. */
+    _uint64_t		data[1];
+};
+
+#define ARENA_ALIGN(size) \
+    (((size) + PROTOBUF_C_ARENA_ALIGN - 1) & ~((size_t) PROTOBUF_C_ARENA_ALIGN - 1))
+
+static void *
+arena_alloc(void *allocator_data, size_t size)
+{
+    ProtobufCArena *arena = allocator_data;
+    ProtobufCArenaBlock *block = arena->blocks;
+    void *ptr;
+
+    size = ARENA_ALIGN(size);
+
+    if (arena->size - arena->used >= size) {
+        ptr = arena->base + arena->used;
+        arena->used += size;
+        return ptr;
+    }
+
+    if (block == NULL || block->size - block->used < size) {
+        size_t block_size = size > PROTOBUF_C_ARENA_BLOCK_SIZE ?
+            size : PROTOBUF_C_ARENA_BLOCK_SIZE;
+
+        block = PanicUnlessMalloc(offsetof(ProtobufCArenaBlock, data) + block_size);
+        block->size = block_size;
+        block->used = 0;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        PRINT(("protobuf arena block %u\n", (unsigned) block_size));
+    }
+
+    ptr = (uint8_t *) block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+static void
+arena_free(void *allocator_data, void *data)
+{
+    /* Memory is released by protobuf_c_arena_reset() */
+    UNUSED(allocator_data);
+    UNUSED(data);
+}
+
+void
+protobuf_c_arena_init(ProtobufCArena *arena, void *buffer, size_t size)
+{
+    uint8_t *base = buffer;
+    size_t pad = 0;
+
+    /* Align the start of the scratch buffer */
+    if (base != NULL)
+        pad = ARENA_ALIGN((size_t) base) - (size_t) base;
+    if (pad > size)
+        pad = size;
+
+    arena->allocator.alloc = &arena_alloc;
+    arena->allocator.free = &arena_free;
+    arena->allocator.allocator_data = arena;
+    arena->base = base + pad;
+    arena->size = size - pad;
+    arena->used = 0;
+    arena->blocks = NULL;
+}
+
+void
+protobuf_c_arena_reset(ProtobufCArena *arena)
+{
+    while (arena->blocks != NULL) {
+        ProtobufCArenaBlock *block = arena->blocks;
+        arena->blocks = block->next;
+        free(block);
+    }
+    arena->used = 0;
+}
+
 /* === buffer-simple === */
 
 void
@@ -221,6 +318,38 @@ protobuf_c_buffer_simple_append(ProtobufCBuffer *buffer,
     simp->len = new_len;
 }
 
+/* === buffer-bounded === */
+
+static void
+buffer_bounded_append(ProtobufCBuffer *buffer, size_t len, const uint8_t *data)
+{
+    ProtobufCBufferBounded *bounded = (ProtobufCBufferBounded *) buffer;
+
+    if (bounded->overflow || len > bounded->max_len - bounded->len) {
+        bounded->overflow = TRUE;
+        return;
+    }
+    memcpy(bounded->data + bounded->len, data, len);
+    bounded->len += len;
+}
+
+size_t
+protobuf_c_message_pack_bounded(const ProtobufCMessage *message,
+                uint8_t *out, size_t max_len)
+{
+    ProtobufCBufferBounded bounded;
+
+    bounded.base.append = &buffer_bounded_append;
+    bounded.data = out;
+    bounded.max_len = max_len;
+    bounded.len = 0;
+    bounded.overflow = FALSE;
+
+    protobuf_c_message_pack_to_buffer(message, &bounded.base);
+
+    return bounded.overflow ? 0 : bounded.len;
+}
+
 /**
  * \defgroup packedsz protobuf_c_message_get_packed_size() implementation
  *
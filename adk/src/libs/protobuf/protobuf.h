@@ -349,6 +349,7 @@ struct ProtobufCAllocator;
 struct ProtobufCBinaryData;
 struct ProtobufCBuffer;
 struct ProtobufCBufferSimple;
+struct ProtobufCBufferBounded;
 struct ProtobufCEnumDescriptor;
 struct ProtobufCEnumValue;
 struct ProtobufCEnumValueIndex;
@@ -362,9 +363,12 @@ struct ProtobufCService;
 struct ProtobufCServiceDescriptor;
 
 typedef struct ProtobufCAllocator ProtobufCAllocator;
+typedef struct ProtobufCArena ProtobufCArena;
+typedef struct ProtobufCArenaBlock ProtobufCArenaBlock;
 typedef struct ProtobufCBinaryData ProtobufCBinaryData;
 typedef struct ProtobufCBuffer ProtobufCBuffer;
 typedef struct ProtobufCBufferSimple ProtobufCBufferSimple;
+typedef struct ProtobufCBufferBounded ProtobufCBufferBounded;
 typedef struct ProtobufCEnumDescriptor ProtobufCEnumDescriptor;
 typedef struct ProtobufCEnumValue ProtobufCEnumValue;
 typedef struct ProtobufCEnumValueIndex ProtobufCEnumValueIndex;
@@ -494,6 +498,63 @@ struct ProtobufCBufferSimple {
     ProtobufCAllocator	*allocator;
 };
 
+/**
+ * Bounded buffer "subclass" of `ProtobufCBuffer`.
+ *
+ * Used by protobuf_c_message_pack_bounded() to serialise a message into a
+ * fixed region, such as space already claimed in a stream sink, without first
+ * computing the packed size of the whole message. Bytes that don't fit are
+ * dropped and `overflow` is set, the region then holds a partial message.
+ */
+struct ProtobufCBufferBounded {
+    /** "Base class". */
+    ProtobufCBuffer		base;
+    /** The region to write to. */
+    uint8_t			*data;
+    /** Size of the region in bytes. */
+    size_t			max_len;
+    /** Number of bytes written. */
+    size_t			len;
+    /** Set if the message did not fit in the region. */
+    protobuf_c_boolean	overflow;
+};
+
+/**
+ * Arena allocator.
+ *
+ * A `ProtobufCArena` hands out memory from a scratch buffer provided by the
+ * user, typically on the stack, by bumping a pointer. Requests that do not fit
+ * are served from additional blocks allocated from the heap. Individual frees
+ * are ignored; all memory is released at once by protobuf_c_arena_reset().
+ *
+ * This suits `protobuf_c_message_unpack()`, which otherwise calls malloc() for
+ * every string, bytes field, repeated array and sub-message:
+ *
+~~~{.c}
+uint8_t scratch[256];
+ProtobufCArena arena;
+protobuf_c_arena_init(&arena, scratch, sizeof(scratch));
+msg = foo__unpack(&arena.allocator, len, data);
+...
+protobuf_c_arena_reset(&arena);
+~~~
+ *
+ * Calling `foo__free_unpacked()` on a message unpacked into an arena is
+ * allowed but does nothing.
+ */
+struct ProtobufCArena {
+    /** Allocator to pass to the unpack functions. */
+    ProtobufCAllocator	allocator;
+    /** Start of the scratch buffer. */
+    uint8_t			*base;
+    /** Size of the scratch buffer. */
+    size_t			size;
+    /** Number of bytes of the scratch buffer in use. */
+    size_t			used;
+    /** Heap blocks used when the scratch buffer is exhausted. */
+    ProtobufCArenaBlock	*blocks;
+};
+
 /**
  * Describes an enumeration as a whole, with all of its values.
  */
@@ -1088,6 +1149,62 @@ protobuf_c_buffer_simple_append(
     size_t len,
     const unsigned char *data);
 
+/**
+ * Serialise a message into a region of bounded size.
+ *
+ * The message is written as it is serialised, so unlike
+ * protobuf_c_message_pack() the size of the whole message is not computed
+ * first. Embedded messages are still sized for their length prefix.
+ *
+ * \param message
+ *      The message object to serialise.
+ * \param out
+ *      The region to write to.
+ * \param max_len
+ *      Size of `out` in bytes.
+ * \return
+ *      Number of bytes written.
+ * \retval 0
+ *      If the message did not fit in `out`. Part of it may have been
+ *      written, the caller must not use the region.
+ */
+PROTOBUF_C__API
+size_t
+protobuf_c_message_pack_bounded(
+    const ProtobufCMessage *message,
+    uint8_t *out,
+    size_t max_len);
+
+/**
+ * Initialise an arena allocator.
+ *
+ * \param arena
+ *      The arena to initialise.
+ * \param buffer
+ *      Scratch buffer used before any heap blocks are allocated. May be NULL.
+ * \param size
+ *      Size of `buffer`.
+ */
+PROTOBUF_C__API
+void
+protobuf_c_arena_init(
+    ProtobufCArena *arena,
+    void *buffer,
+    size_t size);
+
+/**
+ * Release all memory allocated from an arena.
+ *
+ * Frees the heap blocks used by the arena. The scratch buffer can be reused
+ * and the arena stays initialised.
+ *
+ * \param arena
+ *      The arena to reset.
+ */
+PROTOBUF_C__API
+void
+protobuf_c_arena_reset(ProtobufCArena *arena);
+
 PROTOBUF_C__API
 void
 protobuf_c_service_generated_init(
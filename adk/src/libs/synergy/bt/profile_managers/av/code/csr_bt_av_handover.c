@@ -318,6 +318,16 @@ static bool csrBtAvMarshal(const tp_bdaddr *vmTpAddrt,
     return CsrBtMarshalUtilStatus(avConverter);
 }
 
+static CsrUint16 csrBtAvEstimateSize(const tp_bdaddr *vmTpAddrt)
+{
+    CsrUint16 written = 0;
+
+    /* Serializing without a buffer only counts what csrBtAvMarshal writes */
+    (void) csrBtAvMarshal(vmTpAddrt, NULL, CSR_BT_MARSHAL_UTIL_MAX_LENGTH, &written);
+
+    return written;
+}
+
 static bool csrBtAvUnmarshal(const tp_bdaddr *vmTpAddrt,
                              const CsrUint8 *buf,
                              CsrUint16 length,
@@ -451,10 +461,13 @@ static void csrBtAvHandoverAbort(void)
 }
 
 const handover_interface csr_bt_av_handover_if =
-        MAKE_BREDR_HANDOVER_IF(&csrBtAvVeto,
-                               &csrBtAvMarshal,
-                               &csrBtAvUnmarshal,
-                               &csrBtAvHandoverCommit,
-                               &csrBtAvHandoverComplete,
-                               &csrBtAvHandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                                  &csrBtAvVeto,
+                                  NULL,
+                                  &csrBtAvEstimateSize,
+                                  &csrBtAvMarshal,
+                                  &csrBtAvUnmarshal,
+                                  &csrBtAvHandoverCommit,
+                                  &csrBtAvHandoverComplete,
+                                  &csrBtAvHandoverAbort);
 
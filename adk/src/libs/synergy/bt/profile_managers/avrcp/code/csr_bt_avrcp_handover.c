@@ -195,6 +195,16 @@ static bool csrBtAvrcpMarshal(const tp_bdaddr *vmTpAddrt,
     return CsrBtMarshalUtilStatus(avrcpConverter);
 }
 
+static CsrUint16 csrBtAvrcpEstimateSize(const tp_bdaddr *vmTpAddrt)
+{
+    CsrUint16 written = 0;
+
+    /* Serializing without a buffer only counts what csrBtAvrcpMarshal writes */
+    (void) csrBtAvrcpMarshal(vmTpAddrt, NULL, CSR_BT_MARSHAL_UTIL_MAX_LENGTH, &written);
+
+    return written;
+}
+
 static bool csrBtAvrcpUnmarshal(const tp_bdaddr *vmTpAddrt,
                                 const CsrUint8 *buf,
                                 CsrUint16 length,
@@ -329,10 +339,13 @@ static void csrBtAvrcpHandoverAbort(void)
 }
 
 const handover_interface csr_bt_avrcp_handover_if =
-        MAKE_BREDR_HANDOVER_IF(&csrBtAvrcpVeto,
-                               &csrBtAvrcpMarshal,
-                               &csrBtAvrcpUnmarshal,
-                               &csrBtAvrcpHandoverCommit,
-                               &csrBtAvrcpHandoverComplete,
-                               &csrBtAvrcpHandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                                  &csrBtAvrcpVeto,
+                                  NULL,
+                                  &csrBtAvrcpEstimateSize,
+                                  &csrBtAvrcpMarshal,
+                                  &csrBtAvrcpUnmarshal,
+                                  &csrBtAvrcpHandoverCommit,
+                                  &csrBtAvrcpHandoverComplete,
+                                  &csrBtAvrcpHandoverAbort);
 
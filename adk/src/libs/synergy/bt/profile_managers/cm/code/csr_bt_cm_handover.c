@@ -1147,6 +1147,16 @@ static bool csrBtCmMarshal(const tp_bdaddr *vmTpAddrt,
     return CsrBtMarshalUtilStatus(cmConverter->conv);
 }
 
+static CsrUint16 csrBtCmEstimateSize(const tp_bdaddr *vmTpAddrt)
+{
+    CsrUint16 written = 0;
+
+    /* Serializing without a buffer only counts what csrBtCmMarshal writes */
+    (void) csrBtCmMarshal(vmTpAddrt, NULL, CSR_BT_MARSHAL_UTIL_MAX_LENGTH, &written);
+
+    return written;
+}
+
 static bool csrBtCmUnmarshal(const tp_bdaddr *vmTpAddrt,
                              const CsrUint8 *buf,
                              CsrUint16 length,
@@ -1304,13 +1314,15 @@ static void csrBtCmHandoverAbort(void)
 }
 
 const handover_interface csr_bt_cm_handover_if =
-        MAKE_HANDOVER_IF_VPL(&csrBtCmVeto,
-                             &csrBtCmVetoLink,
-                             &csrBtCmMarshal,
-                             &csrBtCmUnmarshal,
-                             &csrBtCmHandoverCommit,
-                             &csrBtCmHandoverComplete,
-                             &csrBtCmHandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(HANDOVER_SUPPORT_ALL,
+                                  &csrBtCmVeto,
+                                  &csrBtCmVetoLink,
+                                  &csrBtCmEstimateSize,
+                                  &csrBtCmMarshal,
+                                  &csrBtCmUnmarshal,
+                                  &csrBtCmHandoverCommit,
+                                  &csrBtCmHandoverComplete,
+                                  &csrBtCmHandoverAbort);
 
 void CsrBtCmUpdateScoHandle(CsrBtConnId connId,
                             hci_connection_handle_t scoHandle)
@@ -314,6 +314,16 @@ static bool csrBtHfMarshal(const tp_bdaddr *vmTpAddrt,
     return CsrBtMarshalUtilStatus(hfConvInst);
 }
 
+static CsrUint16 csrBtHfEstimateSize(const tp_bdaddr *vmTpAddrt)
+{
+    CsrUint16 written = 0;
+
+    /* Serializing without a buffer only counts what csrBtHfMarshal writes */
+    (void) csrBtHfMarshal(vmTpAddrt, NULL, CSR_BT_MARSHAL_UTIL_MAX_LENGTH, &written);
+
+    return written;
+}
+
 static bool csrBtHfUnmarshal(const tp_bdaddr *vmTpAddrt,
                              const CsrUint8 *buf,
                              CsrUint16 length,
@@ -418,11 +428,14 @@ static void csrBtHfHandoverAbort(void)
 }
 
 const handover_interface csr_bt_hf_handover_if =
-        MAKE_BREDR_HANDOVER_IF(&csrBtHfVeto,
-                               &csrBtHfMarshal,
-                               &csrBtHfUnmarshal,
-                               &csrBtHfHandoverCommit,
-                               &csrBtHfHandoverComplete,
-                               &csrBtHfHandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                                  &csrBtHfVeto,
+                                  NULL,
+                                  &csrBtHfEstimateSize,
+                                  &csrBtHfMarshal,
+                                  &csrBtHfUnmarshal,
+                                  &csrBtHfHandoverCommit,
+                                  &csrBtHfHandoverComplete,
+                                  &csrBtHfHandoverAbort);
 
 
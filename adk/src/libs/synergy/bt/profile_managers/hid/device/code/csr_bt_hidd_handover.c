@@ -189,6 +189,16 @@ static bool csrBtHiddMarshal(const tp_bdaddr *vmTpAddrt,
     }
 }
 
+static CsrUint16 csrBtHiddEstimateSize(const tp_bdaddr *vmTpAddrt)
+{
+    CsrUint16 written = 0;
+
+    /* Serializing without a buffer only counts what csrBtHiddMarshal writes */
+    (void) csrBtHiddMarshal(vmTpAddrt, NULL, CSR_BT_MARSHAL_UTIL_MAX_LENGTH, &written);
+
+    return written;
+}
+
 static bool csrBtHiddUnmarshal(const tp_bdaddr *vmTpAddrt,
                                const CsrUint8 *buf,
                                CsrUint16 length,
@@ -261,11 +271,13 @@ static void csrBtHiddHandoverAbort(void)
 }
 
 const handover_interface csr_bt_hidd_handover_if =
-    MAKE_BREDR_HANDOVER_IF(
-    &csrBtHiddVeto,
-    &csrBtHiddMarshal,
-    &csrBtHiddUnmarshal,
-    &csrBtHiddHandoverCommit,
-    &csrBtHiddHandoverComplete,
-    &csrBtHiddHandoverAbort);
+    MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                              &csrBtHiddVeto,
+                              NULL,
+                              &csrBtHiddEstimateSize,
+                              &csrBtHiddMarshal,
+                              &csrBtHiddUnmarshal,
+                              &csrBtHiddHandoverCommit,
+                              &csrBtHiddHandoverComplete,
+                              &csrBtHiddHandoverAbort);
 
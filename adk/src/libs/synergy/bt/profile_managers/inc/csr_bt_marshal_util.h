@@ -26,12 +26,16 @@ CsrBtMarshalUtilInst *CsrBtMarshalUtilCreate(CsrBtMarshalUtilType type);
 /* Destroys serializer/deserializer */
 void CsrBtMarshalUtilDestroy(CsrBtMarshalUtilInst *inst);
 
-/* Sets buffer for serializer/deserializer to work on. Optionally, resets the internal index of the serializer/deserializer */
+/* Sets buffer for serializer/deserializer to work on. Optionally, resets the internal index of the serializer/deserializer.
+ * A serializer given a NULL buffer writes nothing, and only counts the octets it would have written. */
 void CsrBtMarshalUtilResetBuffer(CsrBtMarshalUtilInst *inst,
                                  CsrUint16 size,
                                  CsrUint8 *buf,
                                  CsrBool resetIndex);
 
+/* Buffer size to give a serializer that only counts octets */
+#define CSR_BT_MARSHAL_UTIL_MAX_LENGTH      (0xFFFF)
+
 /* Returns TRUE if serialization/deserialization was successful, else returns FALSE */
 CsrBool CsrBtMarshalUtilStatus(CsrBtMarshalUtilInst *inst);
 
@@ -87,16 +87,21 @@ CsrBool CsrBtMarshalUtilConvert(CsrBtMarshalUtilInst *conv, void *obj, CsrUint16
         {
             if (len <= conv->remainingLength)
             {
-                if (conv->type == CSR_BT_MARSHAL_UTIL_SERIALIZER)
+                if (!conv->buffer)
+                {
+                    /* Sizing only, nothing to copy */
+                }
+                else if (conv->type == CSR_BT_MARSHAL_UTIL_SERIALIZER)
                 {
                     CsrMemCpy(conv->buffer, obj, len); /* We don't care about endianess */
+                    conv->buffer += len;
                 }
                 else
                 {
                     CsrMemCpy(obj, conv->buffer, len); /* We don't care about endianess */
+                    conv->buffer += len;
                 }
 
-                conv->buffer += len;
                 conv->remainingLength -= len;
             }
             else
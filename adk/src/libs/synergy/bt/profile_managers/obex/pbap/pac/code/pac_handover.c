@@ -252,6 +252,16 @@ static bool pacMarshal(const tp_bdaddr *vmTpAddrt,
     return (serPacInstanceData(&tpAddrt.addrt.addr, buf, length, written));
 }
 
+static CsrUint16 pacEstimateSize(const tp_bdaddr *vmTpAddrt)
+{
+    CsrUint16 written = 0;
+
+    /* Serializing without a buffer only counts what pacMarshal writes */
+    (void) pacMarshal(vmTpAddrt, NULL, CSR_BT_MARSHAL_UTIL_MAX_LENGTH, &written);
+
+    return written;
+}
+
 
 static bool pacUnmarshal(const tp_bdaddr *vmTpAddrt,
                          const CsrUint8 *buf,
@@ -354,10 +364,13 @@ static void pacHandoverAbort(void)
 }
 
 const handover_interface pac_handover_if =
-        MAKE_BREDR_HANDOVER_IF(&pacVeto,
-                               &pacMarshal,
-                               &pacUnmarshal,
-                               &pacHandoverCommit,
-                               &pacHandoverComplete,
-                               &pacHandoverAbort);
+        MAKE_HANDOVER_IF_ESTIMATE(TRANSPORT_BREDR_ACL,
+                                  &pacVeto,
+                                  NULL,
+                                  &pacEstimateSize,
+                                  &pacMarshal,
+                                  &pacUnmarshal,
+                                  &pacHandoverCommit,
+                                  &pacHandoverComplete,
+                                  &pacHandoverAbort);
 
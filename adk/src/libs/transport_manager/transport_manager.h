@@ -326,9 +326,12 @@ transport_mgr_status_t TransportMgrDataConsumed(transport_mgr_type_t type,uint16
     underlying transport.In case of GATT it would be handle of a particular
     characteristic
     @param data_length: Length of data to be written.
+
+    Any space already claimed and not sent is counted towards data_length,
+    so space left claimed by a failed TransportMgrDataSend is reused.
  
     @return 
-    Pointer to claimed space when the claim is successful
+    Pointer to the start of the claimed space when the claim is successful
     else NULL
 */
 uint8 *TransportMgrClaimData(transport_mgr_type_t type, uint16 trans_link_info, uint16 data_length);
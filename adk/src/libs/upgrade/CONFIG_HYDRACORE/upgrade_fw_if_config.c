@@ -168,49 +168,49 @@ UpgradeHostErrorCode UpgradeFWIFValidateStart(hash_context_t *vctx)
     return errorCode;
 }
 
+/*
+ * The state of a signature check, split so that the RSA decrypt can run on
+ * another task. Held in the heap as the arrays are too big for a task stack.
+ */
+struct UpgradeFWIFSignatureCheck
+{
+    uint16 workSignature[RSA_SIGNATURE_SIZE];
+    uint16 sign_r2n[RSA_SIGNATURE_SIZE];
+    uint8 sectionHash[SHA_256_HASH_LENGTH];
+};
+
 /***************************************************************************
 NAME
-    UpgradeFWIFValidateFinish
+    UpgradeFWIFValidateFinishStart
 
 DESCRIPTION
-    Verify the accumulated data in the validation context against
-    the given signature - finish request.
+    Get the hash accumulated in the validation context and copy the
+    signature, ready for UpgradeFWIFValidateFinishDecrypt.
 
 PARAMS
     signature Pointer to the signature to compare against.
-    The signature contains the RSA-2048 encrypted, PSS padded, SHA-256 hash.
-    The RSA-2048 encrypted signature is 128 bytes.
-    (RSA-1024 can be used instead of RSA-2148 by defining the UPGRADE_RSA_1024
-    conditional compilation flag. The RSA-1024 encrypted signature is 64 bytes.)
-    After decryption the PSS padded signature is also 128 bytes.
-    After decoding, the SHA-256 signature hash is 32 bytes.
-    This is to be compared against the calculated SHA-256 hash that is
-    calculated from the IMAGE_SECTION_APPS_P0_HEADER in the SQIF.
 
 RETURNS
-    bool TRUE if validation is successful, FALSE otherwise.
+    The signature check, or NULL if the hash could not be finalised.
 */
-bool UpgradeFWIFValidateFinish(hash_context_t *vctx, uint8 *signature)
+UpgradeFWIFSignatureCheck *UpgradeFWIFValidateFinishStart(hash_context_t *vctx, const uint8 *signature)
 {
-    uint16 workSignature[RSA_SIGNATURE_SIZE];
-    uint16 reworkSignature[RSA_SIGNATURE_SIZE];
-    uint8 sectionHash[SHA_256_HASH_LENGTH];
-    uint16 sign_r2n[RSA_SIGNATURE_SIZE];
-    int verify_result;
+    UpgradeFWIFSignatureCheck *check = PanicUnlessMalloc(sizeof(*check));
 
     /* sanity check to make sure the use of defines for array sizes in the function 
      * matches the original use of sizeof(). sizeof() removed in case malloc used.
      */
-    COMPILE_TIME_ASSERT(sizeof(workSignature) == (sizeof(uint16) * RSA_SIGNATURE_SIZE),
+    COMPILE_TIME_ASSERT(sizeof(check->workSignature) == (sizeof(uint16) * RSA_SIGNATURE_SIZE),
             compiler_assumptions_changed_u16);
-    COMPILE_TIME_ASSERT(sizeof(sectionHash) == SHA_256_HASH_LENGTH,
+    COMPILE_TIME_ASSERT(sizeof(check->sectionHash) == SHA_256_HASH_LENGTH,
             compiler_assumptions_changed_u8);
 
     /* Get the result of the ImageUpgradeHashSectionUpdate */
-    if (!ImageUpgradeHashFinalise(vctx, sectionHash, SHA_256_HASH_LENGTH))
+    if (!ImageUpgradeHashFinalise(vctx, check->sectionHash, SHA_256_HASH_LENGTH))
     {
-        DEBUG_LOG_ERROR("UpgradeFWIFValidateFinish, ImageUpgradeHashSectionUpdate failed");
-        return FALSE;
+        DEBUG_LOG_ERROR("UpgradeFWIFValidateFinishStart, ImageUpgradeHashSectionUpdate failed");
+        free(check);
+        return NULL;
     }
 
     /*
@@ -219,22 +219,49 @@ bool UpgradeFWIFValidateFinish(hash_context_t *vctx, uint8 *signature)
      * output decrypted PSS padded SHA-256 signature, and we don't want to
      * trample on the original input supplied.
      */
-    ByteUtilsMemCpy16((uint8 *)workSignature, 0, (const uint16 *) signature, 0,
+    ByteUtilsMemCpy16((uint8 *)check->workSignature, 0, (const uint16 *) signature, 0,
                         RSA_SIGNATURE_SIZE * sizeof(uint16));
 
     /*
      * Copy the constant rsa_decrypt_constant_sign_r2n array into a writable
      * array as it will get modified in the rsa_decrypt process.
      */
-    memcpy(sign_r2n, rsa_decrypt_constant_sign_r2n, 
+    memcpy(check->sign_r2n, rsa_decrypt_constant_sign_r2n, 
                         RSA_SIGNATURE_SIZE * sizeof(uint16));
 
-    /*
-     * Decrypt the RSA-2048 encrypted PSS padded signature.
-     * The result is the PSS padded signature returned in the workSignature
-     * array that is also used fopr the input.
-     */
-    rsa_decrypt(workSignature, &rsa_decrypt_constant_mod, sign_r2n);
+    return check;
+}
+
+/***************************************************************************
+NAME
+    UpgradeFWIFValidateFinishDecrypt
+
+DESCRIPTION
+    Decrypt the RSA-2048 encrypted PSS padded signature. The result is the
+    PSS padded signature, returned in workSignature.
+
+    This only does arithmetic on the check, it calls no traps or libraries,
+    so it may run on the worker task.
+*/
+void UpgradeFWIFValidateFinishDecrypt(UpgradeFWIFSignatureCheck *check)
+{
+    rsa_decrypt(check->workSignature, &rsa_decrypt_constant_mod, check->sign_r2n);
+}
+
+/***************************************************************************
+NAME
+    UpgradeFWIFValidateFinishVerify
+
+DESCRIPTION
+    Verify the decrypted signature against the hash, then free the check.
+
+RETURNS
+    bool TRUE if validation is successful, FALSE otherwise.
+*/
+bool UpgradeFWIFValidateFinishVerify(UpgradeFWIFSignatureCheck *check)
+{
+    uint16 reworkSignature[RSA_SIGNATURE_SIZE];
+    int verify_result;
 
     /*
      * The ce_pkcs1_pss_padding_verify was failing on looking for 0xbc in the
@@ -243,31 +270,67 @@ bool UpgradeFWIFValidateFinish(hash_context_t *vctx, uint8 *signature)
      * reworkSignature and supply that as input to ce_pkcs1_pss_padding_verify
      * instead.
      */
-    ByteUtilsMemCpy16((uint8 *)reworkSignature, 0, (const uint16 *) workSignature, 0,
+    ByteUtilsMemCpy16((uint8 *)reworkSignature, 0, (const uint16 *) check->workSignature, 0,
                     RSA_SIGNATURE_SIZE * sizeof(uint16));
     /*
      * Verify the PSS padded signature in reworkSignature against the
      * SHA-256 hash in from the image section in the sectionHash.
      */
     verify_result = ce_pkcs1_pss_padding_verify(
-                                (const unsigned char *) sectionHash,
+                                (const unsigned char *) check->sectionHash,
                                 SHA_256_HASH_LENGTH,
                                 (const unsigned char *) reworkSignature,
                                 RSA_SIGNATURE_SIZE * sizeof(uint16),
                                 ce_pkcs1_pss_padding_verify_constant_saltlen,
                                 sizeof(rsa_decrypt_constant_mod.M) * 8);
+    free(check);
 
-    DEBUG_LOG_ERROR("UpgradeFWIFValidateFinish, ce_pkcs1_pss_padding_verify result %u", verify_result);
+    DEBUG_LOG_ERROR("UpgradeFWIFValidateFinishVerify, ce_pkcs1_pss_padding_verify result %u", verify_result);
     if (verify_result != CE_SUCCESS)
     {
-        DEBUG_LOG_ERROR("UpgradeFWIFValidateFinish, failed");
+        DEBUG_LOG_ERROR("UpgradeFWIFValidateFinishVerify, failed");
         return FALSE;
     }
 
-    DEBUG_LOG_INFO("UpgradeFWIFValidateFinish, passed");
+    DEBUG_LOG_INFO("UpgradeFWIFValidateFinishVerify, passed");
     return TRUE;
 }
 
+/***************************************************************************
+NAME
+    UpgradeFWIFValidateFinish
+
+DESCRIPTION
+    Verify the accumulated data in the validation context against
+    the given signature - finish request.
+
+PARAMS
+    signature Pointer to the signature to compare against.
+    The signature contains the RSA-2048 encrypted, PSS padded, SHA-256 hash.
+    The RSA-2048 encrypted signature is 128 bytes.
+    (RSA-1024 can be used instead of RSA-2148 by defining the UPGRADE_RSA_1024
+    conditional compilation flag. The RSA-1024 encrypted signature is 64 bytes.)
+    After decryption the PSS padded signature is also 128 bytes.
+    After decoding, the SHA-256 signature hash is 32 bytes.
+    This is to be compared against the calculated SHA-256 hash that is
+    calculated from the IMAGE_SECTION_APPS_P0_HEADER in the SQIF.
+
+RETURNS
+    bool TRUE if validation is successful, FALSE otherwise.
+*/
+bool UpgradeFWIFValidateFinish(hash_context_t *vctx, uint8 *signature)
+{
+    UpgradeFWIFSignatureCheck *check = UpgradeFWIFValidateFinishStart(vctx, signature);
+
+    if (!check)
+    {
+        return FALSE;
+    }
+
+    UpgradeFWIFValidateFinishDecrypt(check);
+    return UpgradeFWIFValidateFinishVerify(check);
+}
+
 UpgradeFWIFApplicationValidationStatus UpgradeFWIFValidateApplication(void)
 {
     return UPGRADE_FW_IF_APPLICATION_VALIDATION_SKIP;
@@ -66,6 +66,111 @@ NOTES
 static uint8 SigningMode = 1;
 uint8 first_word_size = FIRST_WORD_SIZE;
 
+#if TRAPSET_OSAL
+/*
+ * The RSA decrypt takes tens of milliseconds, so it is posted to the worker
+ * task rather than blocking the VM task. Only the decrypt itself, which is
+ * pure arithmetic, runs as the job. Finalising the hash and verifying the
+ * result use traps and libraries, so they stay on the VM task.
+ */
+typedef struct
+{
+    hash_context_t vctx;
+    UpgradeFWIFSignatureCheck *check;
+} upgradeValidateJob;
+
+static void upgradeValidateJobDoneHandler(Task task, MessageId id, Message message);
+static const TaskData upgradeValidateJobDoneTask = { upgradeValidateJobDoneHandler };
+
+/******************************************************************************
+NAME
+    upgradeValidateJobRun
+
+DESCRIPTION
+    Decrypt the signature, called on the worker task.
+*/
+static void upgradeValidateJobRun(void *context)
+{
+    upgradeValidateJob *job = (upgradeValidateJob *)context;
+
+    UpgradeFWIFValidateFinishDecrypt(job->check);
+}
+
+/******************************************************************************
+NAME
+    upgradeValidateJobDoneHandler
+
+DESCRIPTION
+    Pass the decrypted signature to the partition data state machine, which
+    verifies it, then free the job. If the DFU was aborted while the job was
+    running the check is freed without verifying it.
+*/
+static void upgradeValidateJobDoneHandler(Task task, MessageId id, Message message)
+{
+    const MessageWorkerDone *done = (const MessageWorkerDone *)message;
+    upgradeValidateJob *job = (upgradeValidateJob *)done->context;
+
+    UNUSED(task);
+
+    if (!UpgradePartitionDataHandleMessage(id, message))
+    {
+        DEBUG_LOG_INFO("upgradeValidateJobDoneHandler, result ignored");
+        free(job->check);
+    }
+
+    free(job);
+}
+#endif /* TRAPSET_OSAL */
+
+/******************************************************************************
+NAME
+    upgradeValidateFinish
+
+DESCRIPTION
+    Verify the accumulated hash against the signature.
+
+    If the worker task is available the decrypt is posted to it, the partition
+    data moves to UPGRADE_PARTITION_DATA_STATE_HASH_CHECK and the signature is
+    verified when MESSAGE_WORKER_DONE is delivered. Otherwise the check is done
+    immediately.
+
+RETURNS
+    TRUE if the check has been done, in which case hashCheckedOk holds the
+    result. FALSE if it was posted to the worker task.
+*/
+static bool upgradeValidateFinish(bool *hashCheckedOk)
+{
+    UpgradeCtx *ctx = UpgradeCtxGet();
+
+#if TRAPSET_OSAL
+    upgradeValidateJob *job;
+    UpgradeFWIFSignatureCheck *check = UpgradeFWIFValidateFinishStart(ctx->vctx, ctx->partitionData->signature);
+
+    if (!check)
+    {
+        *hashCheckedOk = FALSE;
+        return TRUE;
+    }
+
+    job = PanicUnlessMalloc(sizeof(*job));
+    job->vctx = ctx->vctx;
+    job->check = check;
+
+    if (MessageWorkerPost(upgradeValidateJobRun, job, (Task)&upgradeValidateJobDoneTask))
+    {
+        UpgradePartitionDataSetState(UPGRADE_PARTITION_DATA_STATE_HASH_CHECK);
+        return FALSE;
+    }
+    free(job);
+
+    UpgradeFWIFValidateFinishDecrypt(check);
+    *hashCheckedOk = UpgradeFWIFValidateFinishVerify(check);
+#else
+    *hashCheckedOk = UpgradeFWIFValidateFinish(ctx->vctx, ctx->partitionData->signature);
+#endif /* TRAPSET_OSAL */
+    return TRUE;
+}
+
 /******************************************************************************
 NAME
     UpgradePartitionDataGetHeaderID
@@ -789,12 +894,14 @@ bool UpgradePartitionDataHandleWaitForValidation(MessageId id, Message message)
             switch(UpgradeFWIFValidateStart(ctx->vctx))
             {
                 case UPGRADE_HOST_OEM_VALIDATION_SUCCESS:
-                    hashCheckedOk = UpgradeFWIFValidateFinish(ctx->vctx, ctx->partitionData->signature);
-                    if(!hashCheckedOk)
+                    if(upgradeValidateFinish(&hashCheckedOk))
                     {
-                        UpgradeFatalError(UPGRADE_HOST_ERROR_OEM_VALIDATION_FAILED_FOOTER);
+                        if(!hashCheckedOk)
+                        {
+                            UpgradeFatalError(UPGRADE_HOST_ERROR_OEM_VALIDATION_FAILED_FOOTER);
+                        }
+                        hashCheckDone = TRUE;
                     }
-                    hashCheckDone = TRUE;
                     break;
                     
                 case UPGRADE_HOST_HASHING_IN_PROGRESS:
@@ -839,12 +946,14 @@ bool UpgradePartitionDataHandleHashCheck(MessageId id, Message message)
             
             if(msg->status)
             {
-                hashCheckedOk = UpgradeFWIFValidateFinish(ctx->vctx, ctx->partitionData->signature);
-                if(!hashCheckedOk)
+                if(upgradeValidateFinish(&hashCheckedOk))
                 {
-                    UpgradeFatalError(UPGRADE_HOST_ERROR_OEM_VALIDATION_FAILED_FOOTER);
+                    if(!hashCheckedOk)
+                    {
+                        UpgradeFatalError(UPGRADE_HOST_ERROR_OEM_VALIDATION_FAILED_FOOTER);
+                    }
+                    hashCheckDone = TRUE;
                 }
-                hashCheckDone = TRUE;
             }
             else
             {
@@ -854,6 +963,29 @@ bool UpgradePartitionDataHandleHashCheck(MessageId id, Message message)
         }
         break;
 
+#if TRAPSET_OSAL
+        case MESSAGE_WORKER_DONE:
+        {
+            const MessageWorkerDone *msg = (const MessageWorkerDone *)message;
+            const upgradeValidateJob *job = (const upgradeValidateJob *)msg->context;
+
+            if(job->vctx != ctx->vctx)
+            {
+                /* The DFU was aborted while the job was running. */
+                return FALSE;
+            }
+
+            hashCheckedOk = UpgradeFWIFValidateFinishVerify(job->check);
+            DEBUG_LOG("UpgradePartitionDataHandleHashCheck, signature check %u", hashCheckedOk);
+            if(!hashCheckedOk)
+            {
+                UpgradeFatalError(UPGRADE_HOST_ERROR_OEM_VALIDATION_FAILED_FOOTER);
+            }
+            hashCheckDone = TRUE;
+        }
+        break;
+#endif /* TRAPSET_OSAL */
+
         default:
             return FALSE;
     }
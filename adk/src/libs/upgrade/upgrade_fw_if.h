@@ -196,6 +196,43 @@ UpgradeHostErrorCode UpgradeFWIFValidateStart(hash_context_t *vctx);
 */
 bool UpgradeFWIFValidateFinish(hash_context_t *vctx, uint8 *signature);
 
+/*!
+    @brief The state of a signature check that is split into steps.
+*/
+typedef struct UpgradeFWIFSignatureCheck UpgradeFWIFSignatureCheck;
+
+/*!
+    @brief First step of UpgradeFWIFValidateFinish(). Finalise the hash and
+           copy the signature.
+
+    @param vctx P0 Hash context.
+    @param signature Signature sequence.
+
+    @return The check to pass to UpgradeFWIFValidateFinishDecrypt(), or NULL
+            if the hash could not be finalised, which is a failed validation.
+*/
+UpgradeFWIFSignatureCheck *UpgradeFWIFValidateFinishStart(hash_context_t *vctx, const uint8 *signature);
+
+/*!
+    @brief Second step of UpgradeFWIFValidateFinish(). Decrypt the signature.
+
+    This is the slow step. It calls no traps or libraries, so unlike the
+    other steps it may be run as a worker job.
+
+    @param check The check returned by UpgradeFWIFValidateFinishStart().
+*/
+void UpgradeFWIFValidateFinishDecrypt(UpgradeFWIFSignatureCheck *check);
+
+/*!
+    @brief Last step of UpgradeFWIFValidateFinish(). Verify the decrypted
+           signature against the hash.
+
+    @param check The check, which is freed.
+
+    @return TRUE if a validation was successful, FALSE otherwise.
+*/
+bool UpgradeFWIFValidateFinishVerify(UpgradeFWIFSignatureCheck *check);
+
 /*!
 */
 UpgradeFWIFApplicationValidationStatus UpgradeFWIFValidateApplication(void);
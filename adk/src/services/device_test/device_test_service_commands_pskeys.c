@@ -16,6 +16,7 @@
 #include "device_test_parse.h"
 
 #include <ps.h>
+#include <ps_cache.h>
 #include <logging.h>
 #include <stdio.h>
 #include <ctype.h>
@@ -219,6 +220,9 @@ void DeviceTestServiceCommand_HandlePskeySet(Task task,
         DEBUG_LOG_VERBOSE("DeviceTestServiceCommand_HandlePskeySet. Storing key:%d length:%d",
                             local_key, key_len);
 
+        /* The key is written directly, drop any copy held by the cache */
+        PsCache_Invalidate(local_key);
+
         if (PsStore(local_key, key_to_store, key_len))
         {
             DeviceTestService_CommandResponseOk(task);
@@ -309,6 +313,9 @@ void DeviceTestServiceCommand_HandlePskeyGet(Task task,
         return;
     }
 
+    /* Read what the device will boot with, not an unwritten cached value */
+    PsCache_Flush();
+
     key_length_words = PsRetrieve(local_key, NULL, 0);
     if (key_length_words && key_length_words <= PSKEY_MAX_LENGTH_SUPPORTED)
     {
@@ -393,6 +400,7 @@ void DeviceTestServiceCommand_HandlePskeyClear(Task task,
     }
 
     /* No error to detect if clearing a key */
+    PsCache_Invalidate(local_key);
     PsStore(local_key, NULL, 0);
     DeviceTestService_CommandResponseOk(task);
 }
@@ -28,6 +28,7 @@
 #endif
 #include "timestamp_event.h"
 #include <ps_key_map.h>
+#include <ps_cache.h>
 #include "multidevice.h"
 
 /* Make the type used for message IDs available in debug tools */
@@ -324,7 +325,7 @@ peer_find_role_fixed_role_t PeerFindRole_GetFixedRole(void)
     {
         uint16 pskey_role;
 
-        if(PsRetrieve(PS_KEY_FIXED_ROLE, &pskey_role, FIXED_ROLE_PSKEY_LEN))
+        if(PsCache_Retrieve(PS_KEY_FIXED_ROLE, &pskey_role, FIXED_ROLE_PSKEY_LEN))
         {
             peer_find_role_fixed_role_t role =(peer_find_role_fixed_role_t)pskey_role;
             if(role == peer_find_role_fixed_role_automatic)
@@ -373,7 +374,7 @@ void PeerFindRole_SetFixedRole(peer_find_role_fixed_role_t role)
     {
         uint16 buffer = (uint16)role;
 
-        PanicFalse(PsStore(PS_KEY_FIXED_ROLE, &buffer, FIXED_ROLE_PSKEY_LEN));
+        PanicFalse(PsCache_StoreNow(PS_KEY_FIXED_ROLE, &buffer, FIXED_ROLE_PSKEY_LEN));
 
         peer_find_role.fixed_role = role;
     }
@@ -393,7 +394,7 @@ peer_find_role_preserved_role_t PeerFindRole_GetPreservedRole(void)
 
     uint16 pskey_role;
 
-    if(PsRetrieve(PS_KEY_EARBUD_PRESERVED_ROLE, &pskey_role, FIXED_ROLE_PSKEY_LEN))
+    if(PsCache_Retrieve(PS_KEY_EARBUD_PRESERVED_ROLE, &pskey_role, FIXED_ROLE_PSKEY_LEN))
     {
         peer_find_role.preserved_role =(peer_find_role_preserved_role_t)pskey_role;
     }
@@ -417,7 +418,7 @@ void PeerFindRole_SetPreservedRoleInPSStore(peer_find_role_preserved_role_t role
 
     uint16 buffer = (uint16)role;
 
-    PanicFalse(PsStore(PS_KEY_EARBUD_PRESERVED_ROLE, &buffer, FIXED_ROLE_PSKEY_LEN));
+    PanicFalse(PsCache_StoreNow(PS_KEY_EARBUD_PRESERVED_ROLE, &buffer, FIXED_ROLE_PSKEY_LEN));
 }
 
 /*! \brief Update a preserved role in the global variable
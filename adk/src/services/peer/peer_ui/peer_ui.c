@@ -533,6 +533,8 @@ bool PeerUi_Init(Task init_task)
                                                PEER_SIG_MSG_CHANNEL_PEER_UI,
                                                peer_ui_marshal_type_descriptors,
                                                NUMBER_OF_PEER_UI_MARSHAL_TYPES);
+    appPeerSigMarshalledMsgChannelSetSpecialised(peerUi_GetTask(), PEER_SIG_MSG_CHANNEL_PEER_UI,
+                                                 peer_ui_marshal_specialised);
 
     /* get notification of peer signalling availability to send ui_input messages to peer */
     appPeerSigClientRegister(peerUi_GetTask()); 
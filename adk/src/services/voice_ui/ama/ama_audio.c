@@ -381,6 +381,17 @@ static void amaAudio_SetCurrentLocaleFileIndex(void)
     }
 }
 
+/*! \brief Send a voice packet, written either into space claimed in the
+           transport or into a packet allocated by the caller. */
+static bool amaAudio_TransmitVoicePacket(uint8 *packet, uint16 length, bool packet_in_transport)
+{
+    if (packet_in_transport)
+    {
+        return AmaTransport_TransmitClaimedData(ama_stream_voice, packet, length);
+    }
+    return AmaTransport_TransmitData(ama_stream_voice, packet, length);
+}
+
 static bool amaAudio_SendMsbcVoiceData(Source source)
 {    
     #define MSBC_ENC_PKT_LEN 60
@@ -403,18 +414,24 @@ static bool amaAudio_SendMsbcVoiceData(Source source)
     {
         const uint8 *source_ptr = SourceMap(source);
         uint32 frame;
+        uint8 *packet = AmaTransport_ClaimPacketData(MSBC_FRAME_LEN * frames_to_send);
+        bool packet_in_transport = (packet != NULL);
 
-        if(!payload)
-            payload = AmaTransport_AllocatePacketData(MSBC_FRAME_LEN * frames_to_send);
+        if(!packet_in_transport)
+        {
+            if(!payload)
+                payload = AmaTransport_AllocatePacketData(MSBC_FRAME_LEN * frames_to_send);
+            packet = payload;
+        }
         
         payload_posn = 0;
 
         for (frame = 0; frame < frames_to_send; frame++)
         {
-            memmove(&payload[payload_posn], &source_ptr[(frame * MSBC_ENC_PKT_LEN) + 2], MSBC_FRAME_LEN);
+            memmove(&packet[payload_posn], &source_ptr[(frame * MSBC_ENC_PKT_LEN) + 2], MSBC_FRAME_LEN);
             payload_posn += MSBC_FRAME_LEN;
         }
-        sent_if_necessary = AmaTransport_TransmitData(ama_stream_voice, payload, MSBC_FRAME_LEN * frames_to_send);
+        sent_if_necessary = amaAudio_TransmitVoicePacket(packet, MSBC_FRAME_LEN * frames_to_send, packet_in_transport);
 
         if(sent_if_necessary)
         {
@@ -435,7 +452,8 @@ static bool amaAudio_SendMsbcVoiceData(Source source)
     return sent_if_necessary;
 }
 
-static bool amaAudio_SendOpusVoiceData(Source source)
+/*! \brief Get the length of the Opus frames sent in each transport packet */
+static uint16 amaAudio_GetOpusPacketLength(void)
 {
     /* Parameters used by Opus codec*/
     #define AMA_OPUS_HEADER_LEN         3
@@ -446,11 +464,6 @@ static bool amaAudio_SendOpusVoiceData(Source source)
     #define OPUS_32KBPS_RFCOMM_FRAME_COUNT  3
     #define OPUS_32KBPS_LE_FRAME_COUNT      2
 
-    uint16 payload_posn = 0;
-    uint16 lengthSourceThreshold;
-    uint8 *payload = NULL;
-    bool sent_if_necessary = FALSE;
-    uint8 no_of_transport_pkt = 0;
     ama_transport_type_t transport;
     uint16 opus_enc_pkt_len = OPUS_16KBPS_ENC_PKT_LEN; /* Make complier happy. */
     uint16 opus_frame_count = OPUS_16KBPS_RFCOMM_FRAME_COUNT;
@@ -490,30 +503,40 @@ static bool amaAudio_SendOpusVoiceData(Source source)
         case AUDIO_FORMAT__PCM_L16_16KHZ_MONO :
         case AUDIO_FORMAT__MSBC:
         default:
-            DEBUG_LOG_ERROR("amaAudio_SendOpusVoiceData: Unexpected audio format");
+            DEBUG_LOG_ERROR("amaAudio_GetOpusPacketLength: Unexpected audio format");
             Panic();
             break;
     }
 
-    lengthSourceThreshold = (opus_frame_count * opus_enc_pkt_len);
+    return (opus_frame_count * opus_enc_pkt_len);
+}
+
+static bool amaAudio_SendOpusVoiceData(Source source)
+{
+    uint16 lengthSourceThreshold;
+    uint8 *payload = NULL;
+    bool sent_if_necessary = FALSE;
+    uint8 no_of_transport_pkt = 0;
+
+    lengthSourceThreshold = amaAudio_GetOpusPacketLength();
 
     while (SourceSize(source) && (SourceSize(source) >= lengthSourceThreshold) && (no_of_transport_pkt < 3))
     {
         const uint8 *opus_ptr = SourceMap(source);
-        uint16 frame;
+        uint8 *packet = AmaTransport_ClaimPacketData(lengthSourceThreshold);
+        bool packet_in_transport = (packet != NULL);
 
-        if(!payload)
-            payload = AmaTransport_AllocatePacketData(lengthSourceThreshold);
-        
-        payload_posn = 0;
-
-        for (frame = 0; frame < opus_frame_count; frame++)
+        if(!packet_in_transport)
         {
-            memmove(&payload[payload_posn], &opus_ptr[(frame*opus_enc_pkt_len)], opus_enc_pkt_len);
-            payload_posn += opus_enc_pkt_len;
+            if(!payload)
+                payload = AmaTransport_AllocatePacketData(lengthSourceThreshold);
+            packet = payload;
         }
 
-        sent_if_necessary = AmaTransport_TransmitData(ama_stream_voice, payload, lengthSourceThreshold);
+        /* The Opus frames are contiguous in the source, so are moved as one run */
+        memmove(packet, opus_ptr, lengthSourceThreshold);
+
+        sent_if_necessary = amaAudio_TransmitVoicePacket(packet, lengthSourceThreshold, packet_in_transport);
 
         if(sent_if_necessary)
         {
@@ -534,6 +557,33 @@ static bool amaAudio_SendOpusVoiceData(Source source)
     return sent_if_necessary;
 }
 
+/*! \brief Get the encoded voice data needed to send a transport packet, so
+           the capture only wakes AMA once there is a packet to send. */
+static uint16 amaAudio_GetCaptureWakeupThreshold(void)
+{
+    uint16 threshold = 0;
+
+    switch(AmaData_GetAudioData()->codec)
+    {
+        case ama_codec_msbc:
+            threshold = (MSBC_ENC_PKT_LEN * MSBC_FRAME_COUNT) + 2;
+            break;
+
+        case ama_codec_opus:
+            if (Ama_GetSpeechAudioFormat() == AUDIO_FORMAT__OPUS_16KHZ_16KBPS_CBR_0_20MS ||
+                Ama_GetSpeechAudioFormat() == AUDIO_FORMAT__OPUS_16KHZ_32KBPS_CBR_0_20MS)
+            {
+                threshold = amaAudio_GetOpusPacketLength();
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return threshold;
+}
+
 static va_audio_codec_t amaAudio_ConvertCodecType(ama_codec_t codec_type)
 {
     switch(codec_type)
@@ -700,6 +750,7 @@ bool AmaAudio_WakeWordDetected(va_audio_wuw_capture_params_t *capture_params, co
         amaAudio_StartWakeWordCapture(PRE_ROLL_US, wuw_info->start_timestamp, wuw_info->end_timestamp, wuw_info->metadata);
         start_capture = TRUE;
         capture_params->encode_config = amaAudio_GetEncodeConfiguration();
+        capture_params->wakeup_threshold = amaAudio_GetCaptureWakeupThreshold();
         AmaData_SetState(ama_state_sending);
         amaAudio_StartSession();
     }
@@ -715,6 +766,7 @@ static bool amaAudio_StartVoiceCapture(void)
     audio_cfg.mic_config.max_number_of_mics = AMA_MAX_NUMBER_OF_MICS;
     audio_cfg.mic_config.min_number_of_mics = AMA_MIN_NUMBER_OF_MICS;
     audio_cfg.encode_config = amaAudio_GetEncodeConfiguration();
+    audio_cfg.wakeup_threshold = amaAudio_GetCaptureWakeupThreshold();
 
     voice_ui_audio_status_t status = VoiceUi_StartAudioCapture(Ama_GetVoiceUiHandle(), &audio_cfg);
     if (voice_ui_audio_failed == status)
@@ -28,8 +28,14 @@ ama_rx_code_t AmaReceive_Command(char * data, uint16 length)
 {
     if(data && length)
     {
-        ControlEnvelope* control_envelope_in = 
-                control_envelope__unpack(NULL, (size_t)length, (const uint8_t*)data);
+        ProtobufCArena arena;
+        ControlEnvelope* control_envelope_in;
+
+        /* Unpack into an arena so the envelope's fields and sub-messages share
+           a few heap blocks rather than each being allocated separately. No
+           scratch buffer is given, to keep the AMA stack usage unchanged. */
+        protobuf_c_arena_init(&arena, NULL, 0);
+        control_envelope_in = control_envelope__unpack(&arena.allocator, (size_t)length, (const uint8_t*)data);
 
         if(control_envelope_in)
         {
@@ -43,8 +49,9 @@ ama_rx_code_t AmaReceive_Command(char * data, uint16 length)
                 amaReceive_HandleCommand(control_envelope_in);
             }
 
-            control_envelope__free_unpacked(control_envelope_in, NULL);
         }
+
+        protobuf_c_arena_reset(&arena);
     }
 
     return ama_rx_code_success;
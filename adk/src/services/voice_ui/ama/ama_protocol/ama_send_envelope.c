@@ -11,6 +11,7 @@
 #ifdef INCLUDE_AMA
 #include <panic.h>
 #include <stdlib.h>
+#include <string.h>
 #include "logging.h"
 #include "ama_notify_app_msg.h"
 #include "ama_send_envelope.h"
@@ -18,20 +19,83 @@
 #include "ama_transport_version.h"
 #include "ama_transport.h"
 
-void AmaSendEnvelope_Send(ControlEnvelope* control_envelope_out)
-{    
-    size_t envelope_size = control_envelope__get_packed_size(control_envelope_out);
-    uint8 *packed_envelope = AmaTransport_AllocatePacketData(envelope_size);
+/*! Space claimed in the transport for a control envelope packet before the
+    envelope's size is known. Bigger envelopes are sized first and packed into
+    an allocated buffer. */
+#define AMA_SEND_ENVELOPE_CLAIM_SIZE    (512)
+
+/*! Largest envelope packed without sizing it first, leaving room for the
+    longest packet header of 4 bytes */
+#define AMA_SEND_ENVELOPE_BOUNDED_SIZE  (AMA_SEND_ENVELOPE_CLAIM_SIZE - 4)
+
+static bool amaSendEnvelope_SendClaimed(ControlEnvelope* control_envelope_out)
+{
+    uint8 *packet = AmaTransport_ClaimData(AMA_SEND_ENVELOPE_CLAIM_SIZE);
+    uint8 *packed_envelope;
+    uint16 header_size;
+    size_t envelope_size;
+
+    if(packet == NULL)
+    {
+        return FALSE;
+    }
+
+    /* Pack after the short header, which is all most envelopes need */
+    header_size = AmaTransport_VersionGetHeaderSize(0);
+    packed_envelope = &packet[header_size];
+    envelope_size = protobuf_c_message_pack_bounded(&control_envelope_out->base, packed_envelope,
+                                                    AMA_SEND_ENVELOPE_BOUNDED_SIZE);
+    if(envelope_size == 0)
+    {
+        /* Nothing is sent, the next claim reuses the space */
+        AmaTransport_FlushData(0);
+        return FALSE;
+    }
+
+    if(AmaTransport_VersionGetHeaderSize(envelope_size) != header_size)
+    {
+        header_size = AmaTransport_VersionGetHeaderSize(envelope_size);
+        memmove(&packet[header_size], packed_envelope, envelope_size);
+        packed_envelope = &packet[header_size];
+    }
+
+    AmaLog_ControlEnvelope(AMA_LOG_SENDING, control_envelope_out, packed_envelope, envelope_size);
+    AmaTransport_TransmitClaimedData(ama_stream_control, packed_envelope, envelope_size);
+    return TRUE;
+}
+
+static void amaSendEnvelope_SendAllocated(ControlEnvelope* control_envelope_out)
+{
+    size_t buffer_size = AMA_SEND_ENVELOPE_BOUNDED_SIZE;
+    uint8 *packed_envelope = AmaTransport_AllocatePacketData(buffer_size);
+    size_t envelope_size = protobuf_c_message_pack_bounded(&control_envelope_out->base, packed_envelope, buffer_size);
 
-    if(control_envelope__pack(control_envelope_out, packed_envelope) != envelope_size)
+    if(envelope_size == 0)
     {
-        DEBUG_LOG("AMA Error building packed envelope %d", envelope_size);
+        AmaTransport_FreePacketData(packed_envelope, buffer_size);
+
+        buffer_size = control_envelope__get_packed_size(control_envelope_out);
+        packed_envelope = AmaTransport_AllocatePacketData(buffer_size);
+        envelope_size = control_envelope__pack(control_envelope_out, packed_envelope);
+        if(envelope_size != buffer_size)
+        {
+            DEBUG_LOG("AMA Error building packed envelope %d", buffer_size);
+        }
     }
 
     AmaLog_ControlEnvelope(AMA_LOG_SENDING, control_envelope_out, packed_envelope, envelope_size);
     AmaTransport_TransmitData(ama_stream_control, packed_envelope, envelope_size);
 
-    AmaTransport_FreePacketData(packed_envelope, envelope_size);
+    AmaTransport_FreePacketData(packed_envelope, buffer_size);
+}
+
+void AmaSendEnvelope_Send(ControlEnvelope* control_envelope_out)
+{
+    /* Pack straight into space claimed in the transport, if it has room */
+    if(!amaSendEnvelope_SendClaimed(control_envelope_out))
+    {
+        amaSendEnvelope_SendAllocated(control_envelope_out);
+    }
 }
 
 #endif /* INCLUDE_AMA */
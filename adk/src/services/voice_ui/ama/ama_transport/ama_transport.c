@@ -50,6 +50,39 @@ bool AmaTransport_SendData(uint8 * data, uint16 length)
     return data_sent;
 }
 
+uint8 * AmaTransport_ClaimData(uint16 length)
+{
+    uint8 *data = NULL;
+
+    ama_transport_type_t active_transport = AmaTransport_GetActiveTransport();
+
+    if(active_transport != ama_transport_none)
+    {
+        ama_transport_t * transport_list = AmaTransport_GetTransportList();
+
+        PanicNull((void *)transport_list[active_transport].interface);
+
+        if(transport_list[active_transport].interface->claim_data && transport_list[active_transport].interface->flush_data)
+        {
+            data = transport_list[active_transport].interface->claim_data(length);
+        }
+    }
+
+    return data;
+}
+
+bool AmaTransport_FlushData(uint16 length)
+{
+    ama_transport_type_t active_transport = AmaTransport_GetActiveTransport();
+    ama_transport_t * transport_list = AmaTransport_GetTransportList();
+
+    PanicFalse(active_transport != ama_transport_none);
+    PanicNull((void *)transport_list[active_transport].interface);
+    PanicNull((void *)transport_list[active_transport].interface->flush_data);
+
+    return transport_list[active_transport].interface->flush_data(length);
+}
+
 void AmaTransport_RequestDisconnect(ama_local_disconnect_reason_t reason)
 {
     DEBUG_LOG("AmaTransport_RequestDisconnect");                                            
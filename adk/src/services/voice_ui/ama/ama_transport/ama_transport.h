@@ -27,6 +27,23 @@ void AmaTransport_RegisterParser(data_received_callback_t callback);
 */
 bool AmaTransport_SendData(uint8 * data, uint16 length);
 
+/*! \brief Claim space to write data directly into the active transport
+    \param length Length of the data to be written
+    \return Pointer to the space, or NULL if the transport doesn't support
+            it or has no room. The space must be sent with AmaTransport_FlushData()
+            before any other data is sent.
+*/
+uint8 * AmaTransport_ClaimData(uint16 length);
+
+/*! \brief Send the data written into space from AmaTransport_ClaimData()
+    \param length Length of the data to send from the start of the space, no
+           more than was claimed. Any space after it isn't sent and is reused
+           by the next claim, as is all of the space if 0.
+    \return TRUE if sent successfully, otherwise FALSE. If the data wasn't sent
+            it is dropped, the next claim reuses its space.
+*/
+bool AmaTransport_FlushData(uint16 length);
+
 /*! \brief Request transport disconnection
     \param reason The reason for requesting disconnection
 */
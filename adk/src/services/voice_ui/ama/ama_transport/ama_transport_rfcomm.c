@@ -33,6 +33,8 @@ typedef struct
 {
     uint8* sdp_record;
     Sink data_sink;
+    /* Bytes claimed in data_sink by ama_ClaimRfcommData */
+    uint16 claimed_length;
     uint8 server_channel;
     bool connections_allowed;
     ama_local_disconnect_reason_t reason;
@@ -84,6 +86,8 @@ static void amaRfcomm_MessageHandler(Task task, MessageId id, Message message);
 static const TaskData ama_rfcomm_task = {amaRfcomm_MessageHandler};
 
 static bool ama_SendRfcommData(uint8 * data, uint16 length);
+static uint8 * ama_ClaimRfcommData(uint16 length);
+static bool ama_FlushRfcommData(uint16 length);
 static bool ama_HandleRfcommDisconnectRequest(ama_local_disconnect_reason_t reason);
 static void ama_AllowRfcommConnections(void);
 static void ama_BlockRfcommConnections(void);
@@ -91,6 +95,8 @@ static void ama_BlockRfcommConnections(void);
 static ama_transport_if_t rfcomm_transport_if =
 {
     .send_data = ama_SendRfcommData,
+    .claim_data = ama_ClaimRfcommData,
+    .flush_data = ama_FlushRfcommData,
     .handle_disconnect_request = ama_HandleRfcommDisconnectRequest,
     .allow_connections = ama_AllowRfcommConnections,
     .block_connections = ama_BlockRfcommConnections
@@ -103,13 +109,42 @@ static Task AmaRfcomm_GetTask(void)
 
 static bool ama_SendRfcommData(uint8 * data, uint16 length)
 {
-    #define BAD_SINK_CLAIM (0xFFFF)
     bool status = FALSE;
+    uint8 *sink_data = ama_ClaimRfcommData(length);
+
+    if (sink_data)
+    {
+        memmove(sink_data, data, length);
+        status = ama_FlushRfcommData(length);
+    }
+    else
+    {
+        DEBUG_LOG_WARN("ama_SendRfcommData: Failed to send %d bytes", length);
+    }
+
+    return status;
+}
+
+static uint8 * ama_ClaimRfcommData(uint16 length)
+{
+    #define BAD_SINK_CLAIM (0xFFFF)
+    uint8 *data = NULL;
+
+    ama_rfcomm_data.claimed_length = 0;
 
     if (ama_rfcomm_data.data_sink)
     {
         Sink sink =  ama_rfcomm_data.data_sink;
-        uint16 offset = SinkClaim(sink, length);
+        /* Bytes left claimed by a flush that failed, or beyond the length of
+           the last flush, are reused so that they aren't sent in front of
+           this packet */
+        uint16 already_claimed = SinkClaim(sink, 0);
+        uint16 offset = already_claimed;
+
+        if (already_claimed != BAD_SINK_CLAIM && already_claimed < length)
+        {
+            offset = SinkClaim(sink, length - already_claimed);
+        }
 
         if (offset != BAD_SINK_CLAIM)
         {
@@ -117,22 +152,44 @@ static bool ama_SendRfcommData(uint8 * data, uint16 length)
 
             if (sink_data)
             {
-                sink_data += offset;
-                memmove(sink_data, data, length);
-                status = SinkFlush(sink, length + offset);
+                data = sink_data;
+                ama_rfcomm_data.claimed_length = length;
             }
         }
     }
 
+    return data;
+}
+
+static bool ama_FlushRfcommData(uint16 length)
+{
+    bool status = FALSE;
+
+    PanicFalse(length <= ama_rfcomm_data.claimed_length);
+
+    if (length == 0)
+    {
+        /* Nothing written is to be sent, the next claim reuses the space */
+        ama_rfcomm_data.claimed_length = 0;
+        return TRUE;
+    }
+
+    if (ama_rfcomm_data.data_sink)
+    {
+        status = SinkFlush(ama_rfcomm_data.data_sink, length);
+    }
+
     if(status)
     {
-        DEBUG_LOG_V_VERBOSE("ama_SendRfcommData: %d bytes send", length);
+        DEBUG_LOG_V_VERBOSE("ama_FlushRfcommData: %d bytes send", length);
     }
     else
     {
-        DEBUG_LOG_WARN("ama_SendRfcommData: Failed to send %d bytes", length);
+        DEBUG_LOG_WARN("ama_FlushRfcommData: Failed to send %d bytes", length);
     }
 
+    ama_rfcomm_data.claimed_length = 0;
+
     return status;
 }
 
@@ -93,6 +93,13 @@ bool AmaTransport_TransmitData(ama_stream_type_t stream_type, uint8 * payload, u
     return AmaTransport_SendData(packet, packet_size);
 }
 
+bool AmaTransport_TransmitClaimedData(ama_stream_type_t stream_type, uint8 * payload, uint16 payload_length)
+{
+    uint8* packet = payload - AmaTransport_VersionGetHeaderSize(payload_length);
+    uint16 packet_size = amaTransport_AddPacketHeader(stream_type, packet, payload_length);
+    return AmaTransport_FlushData(packet_size);
+}
+
 uint16 AmaTransport_VersionGetHeaderSize(const uint16 payload_len)
 {
     return payload_len > MAX_SMALL_PACKET_SIZE ? 4 : 3;
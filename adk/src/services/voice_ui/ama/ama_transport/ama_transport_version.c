@@ -11,6 +11,7 @@
 #ifdef INCLUDE_AMA
 
 #include "ama_transport_version.h"
+#include "ama_transport.h"
 
 #include "panic.h"
 #include "stdlib.h"
@@ -22,6 +23,13 @@ uint8* AmaTransport_AllocatePacketData(uint16 payload_length)
     return &packet[header_len];
 }
 
+uint8* AmaTransport_ClaimPacketData(uint16 payload_length)
+{
+    uint16 header_len = AmaTransport_VersionGetHeaderSize(payload_length);
+    uint8* packet = AmaTransport_ClaimData(payload_length + header_len);
+    return packet ? &packet[header_len] : NULL;
+}
+
 void AmaTransport_FreePacketData(uint8* payload, uint16 payload_length)
 {
     if(payload)
@@ -44,6 +44,21 @@ void AmaTransport_RxDataReset(void);
 */
 bool AmaTransport_TransmitData(ama_stream_type_t stream_type, uint8 * payload, uint16 payload_length);
 
+/*! \brief Claims space for the payload directly in the active transport
+    \param payload_length - length of payload
+    \return pointer to the payload space, or NULL if the transport can't
+            provide it. The payload must be sent with AmaTransport_TransmitClaimedData().
+*/
+uint8* AmaTransport_ClaimPacketData(uint16 payload_length);
+
+/*! \brief Transmits a payload written into space from AmaTransport_ClaimPacketData()
+    \param stream_type - control or voice
+    \param payload - payload of packet
+    \param payload_length - length of payload
+    \return TRUE if successful, otherwise FALSE
+*/
+bool AmaTransport_TransmitClaimedData(ama_stream_type_t stream_type, uint8 * payload, uint16 payload_length);
+
 /*! \brief Allocates memory for the payload
     \param payload_length - length of payload
     \return pointer to new payload memory
@@ -21,6 +21,10 @@
 typedef struct
 {
     bool(*send_data)(uint8 * data, uint16 length);
+    /*! Optional, claim space for data written directly into the transport */
+    uint8 *(*claim_data)(uint16 length);
+    /*! Optional, send the first length bytes written into space from claim_data */
+    bool(*flush_data)(uint16 length);
     bool(*handle_disconnect_request)(ama_local_disconnect_reason_t reason);
     void(*allow_connections)(void);
     void(*block_connections)(void);
@@ -66,6 +66,7 @@ typedef enum {
     RAFS_UNSUPPORTED_IOC,   /*!< The parameter set to \see Rafs_IoControl is not supported */
     RAFS_LOW_POWER,         /*!< There is insufficient power to start a new write operation */
     RAFS_FILE_SYSTEM_CLEAN, /*!< There is no work for \see Rafs_Compact to do - it's clean */
+    RAFS_WRITE_FAILED,      /*!< Failure to write the last of the data when closing a file for writing */
     RAFS_LAST
 } rafs_errors_t;
 
@@ -233,6 +234,9 @@ rafs_errors_t Rafs_Open(Task task, const char *pathname, rafs_mode_t flags, rafs
 /*! \brief Close a file.
     \param[in]  file_id     The id to close.
     \return RAFS_OK or an error code.
+    \note The file is closed whatever the result. If a file opened for writing
+          returns RAFS_WRITE_FAILED its data couldn't all be written, and it has
+          not been added to the directory.
  */
 rafs_errors_t Rafs_Close(rafs_file_t file_id);
 
@@ -11,8 +11,8 @@
 #include <panic.h>
 #include <csrtypes.h>
 #include <vmtypes.h>
-#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "rafs.h"
 #include "rafs_private.h"
@@ -20,79 +20,12 @@
 #include "rafs_utils.h"
 #include "rafs_extent.h"
 
-/*
- * Traverse extents callback functions
- * -----------------------------------
- */
-/*!
- * A function pointer, for functions that will receive a sector
- * id and a user-supplied context pointer.
- */
-typedef void (*extentfn)(uint16, void*);
-
-typedef struct {
-    extentfn    firstFree;  /*! Called on first sector of a new free extent */
-    extentfn    nextFree;   /*! Called for each consecutive sector in the same extent */
-    extentfn    firstUse;   /*! Called on first sector of a new in-use extent */
-    extentfn    nextUse;    /*! Called for each consecutive sector in the same extent */
-} extentfns_t;
-
-/* Rafs_FindLongestFreeExtent context and callbacks */
-/* ------------------------------------------------ */
-typedef struct {
-    inode_t     current;
-    inode_t     result;
-} find_longest;
-
-/* Rafs_CountFreeExtents context and callbacks */
-/* ------------------------------------------- */
-typedef struct {
-    uint16      count;
-} count_extents;
+/*! The number of extents the free extent list grows by when it is full */
+#define FREE_EXTENTS_GROWTH     8
 
-/* Rafs_GetFreeExtents context and callbacks */
-/* ----------------------------------------- */
-typedef struct {
-    inode_t     *list;
-    uint16      listlen;
-    uint16      count;
-    inode_t     current;
-} get_extents;
-
-static void Rafs_FindLongestFirstFree(uint16 sector, void *ctx);
-static void Rafs_FindLongestNextFree(uint16 sector, void *ctx);
-static void Rafs_FindLongestFirstUse(uint16 sector, void *ctx);
-
-static void Rafs_CountExtentsFirstFree(uint16 sector, void *ctx);
-
-static void Rafs_GetExtentsFirstFree(uint16 sector, void *ctx);
-static void Rafs_GetExtentsNextFree(uint16 sector, void *ctx);
-static void Rafs_GetExtentsFirstUse(uint16 sector, void *ctx);
 /* Sort inodes into largest to smallest size order */
 static int Rafs_SortInodeLengthDescending(const void *pa, const void *pb);
 
-static const extentfns_t find_longest_fns = {
-    Rafs_FindLongestFirstFree,
-    Rafs_FindLongestNextFree,
-    Rafs_FindLongestFirstUse,
-    0
-};
-
-static const extentfns_t count_extents_fns = {
-    Rafs_CountExtentsFirstFree,
-    0,
-    0,
-    0
-};
-
-static const extentfns_t get_extents_fns = {
-    Rafs_GetExtentsFirstFree,
-    Rafs_GetExtentsNextFree,
-    Rafs_GetExtentsFirstUse,
-    0
-};
-
-
 bool Rafs_AddExtentsToSectorMap(const inode_t inodes[], uint32 num)
 {
     bool ok = TRUE;
@@ -144,133 +77,177 @@ bool Rafs_RemoveExtentsFromSectorMap(const inode_t inodes[], uint32 num)
 }
 
 /*!
- * \brief Rafs_TraverseExtents
- * This scans the sector use map, looking for contiguous extents of free and in-use
- * sectors.  As new extents are discovered, one of the four supplied functions is
- * called.
- * \param fns   A pointer to the four functions to be called.
- * \param ctx   A context pointer to pass to the supplied functions.
+ * \brief Rafs_FindFreeExtentAfter
+ * Binary search the free extent list.
+ * \param sector    The sector to look for.
+ * \return the index of the first free extent that starts after sector.
  */
-static void Rafs_TraverseExtents(const extentfns_t *fns, void *ctx)
+static uint16 Rafs_FindFreeExtentAfter(uint16 sector)
 {
     rafs_instance_t *rafs_self = Rafs_GetTaskData();
-    const uint32 bits_per_word = sizeof(rafs_self->sector_in_use_map[0]) * CHAR_BIT;
-    bool free_run = (rafs_self->sector_in_use_map[0] & 1) == 0;
-    for(uint32 m = 0 ; m < rafs_self->sector_in_use_map_length ; m++ )
+    uint16 lo = 0;
+    uint16 hi = rafs_self->num_free_extents;
+    while( lo < hi )
     {
-        for(uint32 b = 0 ; b < bits_per_word ; b++ )
-        {
-            uint32 mask = 1u << b;
-            uint16 sector = (uint16)(m * bits_per_word + b);
-            if( (rafs_self->sector_in_use_map[m] & mask) == mask )
-            {
-                if( !free_run )
-                {
-                    if( fns->firstFree )
-                        fns->firstFree(sector, ctx);
-                    free_run = TRUE;
-                }
-                else
-                {
-                    if( fns->nextFree )
-                        fns->nextFree(sector, ctx);
-                }
-            }
-            else
-            {
-                if( free_run )
-                {
-                    if( fns->firstUse )
-                        fns->firstUse(sector, ctx);
-                    free_run = FALSE;
-                }
-                else
-                {
-                    if( fns->nextUse )
-                        fns->nextUse(sector, ctx);
-                }
-            }
-        }
+        uint16 mid = (uint16)((lo + hi) / 2);
+        if( rafs_self->free_extents[mid].offset <= sector )
+            lo = mid + 1;
+        else
+            hi = mid;
     }
+    return lo;
 }
 
+static void Rafs_InsertFreeExtent(uint16 index, uint16 offset, uint16 length)
+{
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    if( rafs_self->num_free_extents == rafs_self->free_extents_capacity )
+    {
+        rafs_self->free_extents_capacity += FREE_EXTENTS_GROWTH;
+        rafs_self->free_extents = PanicNull(realloc(rafs_self->free_extents,
+                                    rafs_self->free_extents_capacity * sizeof(*rafs_self->free_extents)));
+    }
+    memmove(&rafs_self->free_extents[index+1], &rafs_self->free_extents[index],
+            (rafs_self->num_free_extents - index) * sizeof(*rafs_self->free_extents));
+    rafs_self->free_extents[index].offset = offset;
+    rafs_self->free_extents[index].length = length;
+    rafs_self->num_free_extents++;
+}
 
-static void Rafs_FindLongestFirstFree(uint16 sector, void *ctx)
+static void Rafs_DeleteFreeExtent(uint16 index)
 {
-    find_longest *p = ctx;
-    p->current.offset = sector;
-    p->current.length = 1;
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    rafs_self->num_free_extents--;
+    memmove(&rafs_self->free_extents[index], &rafs_self->free_extents[index+1],
+            (rafs_self->num_free_extents - index) * sizeof(*rafs_self->free_extents));
 }
-static void Rafs_FindLongestNextFree(uint16 sector, void *ctx)
+
+/*!
+ * \brief Rafs_UpdateLongestFreeExtent
+ * Keep the cached longest extent up to date after an extent has grown.
+ * Ties go to the lowest offset, as a scan in address order would find.
+ * \param index     The index of the extent that has grown.
+ */
+static void Rafs_UpdateLongestFreeExtent(uint16 index)
 {
-    UNUSED(sector);
-    find_longest *p = ctx;
-    p->current.length++;
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    const inode_t *grown = &rafs_self->free_extents[index];
+    inode_t *longest = &rafs_self->longest_free_extent;
+    if( rafs_self->longest_free_extent_valid &&
+        ( grown->length > longest->length ||
+          ( grown->length == longest->length && grown->offset <= longest->offset ) ) )
+    {
+        *longest = *grown;
+    }
 }
-static void Rafs_FindLongestFirstUse(uint16 sector, void *ctx)
+
+void Rafs_ResetFreeExtents(void)
 {
-    UNUSED(sector);
-    find_longest *p = ctx;
-    if( p->current.length > p->result.length )
-        p->result = p->current;
-    p->current.offset = 0;
-    p->current.length = 0;
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    free(rafs_self->free_extents);
+    rafs_self->free_extents = NULL;
+    rafs_self->num_free_extents = 0;
+    rafs_self->free_extents_capacity = 0;
+    rafs_self->longest_free_extent.offset = 0;
+    rafs_self->longest_free_extent.length = 0;
+    rafs_self->longest_free_extent_valid = TRUE;
 }
 
-inode_t Rafs_FindLongestFreeExtent(void)
+void Rafs_AddFreeSectorToExtents(uint16 sector)
 {
-    find_longest    data = { { 0, 0 }, { 0, 0 } };
-    Rafs_TraverseExtents(&find_longest_fns, &data);
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    uint16 next = Rafs_FindFreeExtentAfter(sector);
+    inode_t *prev_extent = next > 0 ? &rafs_self->free_extents[next-1] : NULL;
+    inode_t *next_extent = next < rafs_self->num_free_extents ? &rafs_self->free_extents[next] : NULL;
+    bool joins_prev = prev_extent && prev_extent->offset + prev_extent->length == sector;
+    bool joins_next = next_extent && next_extent->offset == sector + 1;
 
-    inode_t    result;
-    if( data.current.length > data.result.length )
-        result = data.current;
+    if( joins_prev && joins_next )
+    {
+        prev_extent->length += 1 + next_extent->length;
+        Rafs_DeleteFreeExtent(next);
+        Rafs_UpdateLongestFreeExtent(next-1);
+    }
+    else if( joins_prev )
+    {
+        prev_extent->length++;
+        Rafs_UpdateLongestFreeExtent(next-1);
+    }
+    else if( joins_next )
+    {
+        next_extent->offset--;
+        next_extent->length++;
+        Rafs_UpdateLongestFreeExtent(next);
+    }
     else
-        result = data.result;
-    return result;
+    {
+        Rafs_InsertFreeExtent(next, sector, 1);
+        Rafs_UpdateLongestFreeExtent(next);
+    }
 }
 
-
-static void Rafs_CountExtentsFirstFree(uint16 sector, void *ctx)
+void Rafs_RemoveFreeSectorFromExtents(uint16 sector)
 {
-    UNUSED(sector);
-    count_extents *p = ctx;
-    p->count++;
-}
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    uint16 next = Rafs_FindFreeExtentAfter(sector);
+    if( next == 0 )
+        return;
 
-uint16 Rafs_CountFreeExtents(void)
-{
-    count_extents   data = { 0 };
-    Rafs_TraverseExtents(&count_extents_fns, &data);
-    return data.count;
-}
+    uint16 index = next - 1;
+    inode_t *extent = &rafs_self->free_extents[index];
+    uint16 end = extent->offset + extent->length;
+    if( sector >= end )
+        return;
 
+    if( rafs_self->longest_free_extent_valid &&
+        rafs_self->longest_free_extent.offset == extent->offset )
+    {
+        /* Found again by the next Rafs_FindLongestFreeExtent */
+        rafs_self->longest_free_extent_valid = FALSE;
+    }
 
-static void Rafs_GetExtentsFirstFree(uint16 sector, void *ctx)
-{
-    get_extents *p = ctx;
-    p->current.offset = sector;
-    p->current.length = 1;
-}
-static void Rafs_GetExtentsNextFree(uint16 sector, void *ctx)
-{
-    UNUSED(sector);
-    get_extents *p = ctx;
-    p->current.length++;
+    if( extent->length == 1 )
+    {
+        Rafs_DeleteFreeExtent(index);
+    }
+    else if( sector == extent->offset )
+    {
+        extent->offset++;
+        extent->length--;
+    }
+    else if( sector == end - 1 )
+    {
+        extent->length--;
+    }
+    else
+    {
+        extent->length = sector - extent->offset;
+        Rafs_InsertFreeExtent(next, sector + 1, end - (sector + 1));
+    }
 }
-static void Rafs_GetExtentsFirstUse(uint16 sector, void *ctx)
+
+inode_t Rafs_FindLongestFreeExtent(void)
 {
-    UNUSED(sector);
-    get_extents *p = ctx;
-    if( p->current.length > 0 )
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    if( !rafs_self->longest_free_extent_valid )
     {
-        if( p->count < p->listlen )
-            p->list[p->count] = p->current;
-        p->count++;
+        inode_t result = { 0, 0 };
+        for(uint16 i = 0 ; i < rafs_self->num_free_extents ; i++)
+        {
+            if( rafs_self->free_extents[i].length > result.length )
+                result = rafs_self->free_extents[i];
+        }
+        rafs_self->longest_free_extent = result;
+        rafs_self->longest_free_extent_valid = TRUE;
     }
-    p->current.offset = 0;
-    p->current.length = 0;
+    return rafs_self->longest_free_extent;
+}
+
+uint16 Rafs_CountFreeExtents(void)
+{
+    return Rafs_GetTaskData()->num_free_extents;
 }
+
 static int Rafs_SortInodeLengthDescending(const void *pa, const void *pb)
 {
     const inode_t   *a = pa;
@@ -294,17 +271,10 @@ static int Rafs_SortInodeLengthDescending(const void *pa, const void *pb)
 
 uint16 Rafs_GetFreeExtents(inode_t *inodes, uint16 num)
 {
-    get_extents   data = { inodes, num, 0, { 0, 0 } };
-    Rafs_TraverseExtents(&get_extents_fns, &data);
-    if( data.current.length > 0 )
-    {
-        if( data.count < data.listlen )
-            data.list[data.count] = data.current;
-        data.count++;
-    }
-
-    uint16 n = MIN(data.count,data.listlen);
-    qsort(data.list, n, sizeof(data.list[0]), Rafs_SortInodeLengthDescending);
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    uint16 n = MIN(rafs_self->num_free_extents, num);
+    memcpy(inodes, rafs_self->free_extents, n * sizeof(*inodes));
+    qsort(inodes, n, sizeof(inodes[0]), Rafs_SortInodeLengthDescending);
 
-    return data.count;
+    return rafs_self->num_free_extents;
 }
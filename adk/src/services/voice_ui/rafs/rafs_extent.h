@@ -10,6 +10,10 @@
    An extent is any contiguous sequence of either in-use or free sectors.
    A single extent can be addressed by a single inode.
 
+   The free extents are kept in a list in address order, which is updated
+   as sectors are marked free or in use, along with a copy of the longest.
+   So finding space for a file doesn't need a scan of the sector map.
+
 */
 
 #ifndef RAFS_EXTENT_H
@@ -31,6 +35,23 @@ bool Rafs_AddExtentsToSectorMap(const inode_t inodes[], uint32 num);
  */
 bool Rafs_RemoveExtentsFromSectorMap(const inode_t inodes[], uint32 num);
 
+/*!
+ * \brief Empty the free extent list, and release its memory.
+ */
+void Rafs_ResetFreeExtents(void);
+
+/*!
+ * \brief Add a sector, which has just become free, to the free extent list.
+ * \param sector    The sector
+ */
+void Rafs_AddFreeSectorToExtents(uint16 sector);
+
+/*!
+ * \brief Remove a sector, which has just come into use, from the free extent list.
+ * \param sector    The sector
+ */
+void Rafs_RemoveFreeSectorFromExtents(uint16 sector);
+
 /*!
  * \brief Find the largest contiguous block of free blocks
  * \return An inode representing the start and length of a writable block.
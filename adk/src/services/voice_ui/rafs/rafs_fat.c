@@ -114,7 +114,11 @@ void Rafs_SectorMapMarkFreeBlock(uint32 block_number)
     rafs_instance_t *rafs_self = Rafs_GetTaskData();
     uint32 idx, mask;
     Rafs_GetIndexAndMask(block_number, &idx, &mask);
-    rafs_self->sector_in_use_map[idx] |= mask;
+    if( (rafs_self->sector_in_use_map[idx] & mask) == 0 )
+    {
+        rafs_self->sector_in_use_map[idx] |= mask;
+        Rafs_AddFreeSectorToExtents((uint16)block_number);
+    }
 }
 
 void Rafs_SectorMapMarkUsedBlock(uint32 block_number)
@@ -122,7 +126,11 @@ void Rafs_SectorMapMarkUsedBlock(uint32 block_number)
     rafs_instance_t *rafs_self = Rafs_GetTaskData();
     uint32 idx, mask;
     Rafs_GetIndexAndMask(block_number, &idx, &mask);
-    rafs_self->sector_in_use_map[idx] &= ~mask;
+    if( (rafs_self->sector_in_use_map[idx] & mask) != 0 )
+    {
+        rafs_self->sector_in_use_map[idx] &= ~mask;
+        Rafs_RemoveFreeSectorFromExtents((uint16)block_number);
+    }
 }
 
 bool Rafs_SectorMapIsBlockInUse(uint32 block_number)
@@ -137,13 +145,9 @@ uint16 Rafs_CountFreeSectors(void)
 {
     uint16 result = 0;
     rafs_instance_t *rafs_self = Rafs_GetTaskData();
-    uint32  num_blocks = rafs_self->partition->part_info.partition_size / rafs_self->partition->part_info.block_size;
-    for(uint32 block = 0 ; block < num_blocks ; block++)
+    for(uint16 i = 0 ; i < rafs_self->num_free_extents ; i++)
     {
-        if( !Rafs_SectorMapIsBlockInUse(block) )
-        {
-            result++;
-        }
+        result += rafs_self->free_extents[i].length;
     }
     return result;
 }
@@ -165,6 +169,8 @@ void Rafs_InitialiseSectorMap(void)
     for(uint32 i = 0 ; i < rafs_self->sector_in_use_map_length ; i++)
         rafs_self->sector_in_use_map[i] = 0;
 
+    Rafs_ResetFreeExtents();
+
     for(uint32 i = 0 ; i < num_blocks ; i++)
         Rafs_SectorMapMarkFreeBlock(i);
 }
@@ -40,12 +40,14 @@ bool Rafs_IsDeletedEntry(const dir_entry_t *dir_entry);
 
 /*!
  * \brief Mark a block as being free for use
+ * The free extent list is updated to match.
  * \param block_number   The block
  */
 void Rafs_SectorMapMarkFreeBlock(uint32 block_number);
 
 /*!
  * \brief Mark a block as being in use
+ * The free extent list is updated to match.
  * \param block_number   The block
  */
 void Rafs_SectorMapMarkUsedBlock(uint32 block_number);
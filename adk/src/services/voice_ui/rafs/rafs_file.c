@@ -24,6 +24,15 @@
 #include "rafs_utils.h"
 #include "rafs_file.h"
 
+/*!
+ * The size of the write buffer for the file open for writing, a multiple of the
+ * flash program page size. Writes are gathered into one program per page, or
+ * go straight to flash if they cover whole pages.
+ */
+#ifndef RAFS_WRITE_BUFFER_SIZE
+#define RAFS_WRITE_BUFFER_SIZE  256
+#endif
+
 rafs_errors_t Rafs_ValidateOpen(const char *filename, rafs_mode_t flags, rafs_file_t *file_id)
 {
     PanicNull(file_id);
@@ -127,6 +136,8 @@ static rafs_errors_t rafs_doOpenWrite(Task task, const char *filename, rafs_mode
                             &rafs_self->files->open_files[*file_id]->file_dir_entry, filename, &free_space);
 
                 rafs_self->files->file_is_open_for_writing = TRUE;
+                rafs_self->files->write_buffer = PanicUnlessMalloc(RAFS_WRITE_BUFFER_SIZE);
+                rafs_self->files->write_buffer_used = 0;
 
                 rafs_self->files->num_open_files++;
 
@@ -145,6 +156,81 @@ static rafs_errors_t rafs_doOpenWrite(Task task, const char *filename, rafs_mode
     return result;
 }
 
+/*!
+ * \brief Rafs_FlushWriteBuffer
+ * Program the data gathered in the write buffer to flash.
+ * \return the result of the partition write.
+ */
+static raPartition_result Rafs_FlushWriteBuffer(void)
+{
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    fileinfo_t *files = rafs_self->files;
+    raPartition_result ra_result = RA_PARTITION_RESULT_SUCCESS;
+    if( files->write_buffer_used > 0 )
+    {
+        ra_result = Rafs_PartWrite(&rafs_self->partition->part_handle,
+                                   files->write_buffer_offset, files->write_buffer_used, files->write_buffer);
+        files->write_buffer_used = 0;
+    }
+    return ra_result;
+}
+
+/*!
+ * \brief Rafs_BufferedWrite
+ * Write data to the partition through the write buffer.
+ * The buffer holds data up to the end of one page. It's programmed when the page
+ * is full, when the next write isn't contiguous, or when the file is closed.
+ * \param offset    The partition offset to write to.
+ * \param length    The number of bytes to write.
+ * \param data      The data to write.
+ * \return the result of any partition write made.
+ */
+static raPartition_result Rafs_BufferedWrite(uint32 offset, uint32 length, const char *data)
+{
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+    fileinfo_t *files = rafs_self->files;
+    raPartition_result ra_result = RA_PARTITION_RESULT_SUCCESS;
+
+    if( files->write_buffer_used > 0 &&
+        files->write_buffer_offset + files->write_buffer_used != offset )
+    {
+        ra_result = Rafs_FlushWriteBuffer();
+    }
+
+    while( ra_result == RA_PARTITION_RESULT_SUCCESS && length > 0 )
+    {
+        if( files->write_buffer_used == 0 )
+        {
+            files->write_buffer_offset = offset;
+            if( offset % RAFS_WRITE_BUFFER_SIZE == 0 && length >= RAFS_WRITE_BUFFER_SIZE )
+            {
+                /* Whole pages don't need to be copied */
+                uint32 direct = length - length % RAFS_WRITE_BUFFER_SIZE;
+                ra_result = Rafs_PartWrite(&rafs_self->partition->part_handle, offset, direct, data);
+                offset += direct;
+                data += direct;
+                length -= direct;
+                continue;
+            }
+        }
+
+        uint32 space = RAFS_WRITE_BUFFER_SIZE - files->write_buffer_offset % RAFS_WRITE_BUFFER_SIZE
+                       - files->write_buffer_used;
+        uint32 this_len = MIN(length, space);
+        memcpy(&files->write_buffer[files->write_buffer_used], data, this_len);
+        files->write_buffer_used += (uint16)this_len;
+        offset += this_len;
+        data += this_len;
+        length -= this_len;
+
+        if( this_len == space )
+        {
+            ra_result = Rafs_FlushWriteBuffer();
+        }
+    }
+    return ra_result;
+}
+
 rafs_errors_t Rafs_DoOpen(Task task, const char *filename, rafs_mode_t flags, rafs_file_t *file_id)
 {
     rafs_errors_t result = RAFS_OK;
@@ -190,17 +276,32 @@ rafs_errors_t Rafs_DoClose(rafs_file_t file_id)
         rafs_instance_t *rafs_self = Rafs_GetTaskData();
         if( of->flags == RAFS_WRONLY )
         {
-            /* Finalise the length of the last used extent */
+            raPartition_result ra_result = Rafs_FlushWriteBuffer();
+            free(rafs_self->files->write_buffer);
+            rafs_self->files->write_buffer = NULL;
+
+            /* Finalise the length of the last used extent. Its sectors have been
+             * programmed even if the flush failed, so they are never reused */
             of->file_dir_entry.inodes[of->current_inode].length =
                     (uint16)(of->extent_position / rafs_self->partition->part_info.block_size +
                             (of->extent_position % rafs_self->partition->part_info.block_size != 0) );
             Rafs_AddExtentsToSectorMap(&of->file_dir_entry.inodes[of->current_inode], 1);
-            of->file_dir_entry.file_size = of->file_position;
-            bool pri_ok = Rafs_DirEntryWrite(PRI_FAT, &of->file_dir_entry, of->directory_index);
-            bool sec_ok = Rafs_DirEntryWrite(SEC_FAT, &of->file_dir_entry, of->directory_index);
-            if( !(pri_ok && sec_ok) )
+
+            if( ra_result != RA_PARTITION_RESULT_SUCCESS )
+            {
+                /* Don't create a directory entry for a file whose data is incomplete */
+                DEBUG_LOG_ALWAYS("Rafs_DoClose(%d)=%d", file_id, ra_result);
+                result = RAFS_WRITE_FAILED;
+            }
+            else
             {
-                result = RAFS_FAT_WRITE_FAILED;
+                of->file_dir_entry.file_size = of->file_position;
+                bool pri_ok = Rafs_DirEntryWrite(PRI_FAT, &of->file_dir_entry, of->directory_index);
+                bool sec_ok = Rafs_DirEntryWrite(SEC_FAT, &of->file_dir_entry, of->directory_index);
+                if( !(pri_ok && sec_ok) )
+                {
+                    result = RAFS_FAT_WRITE_FAILED;
+                }
             }
             rafs_self->files->file_is_open_for_writing = FALSE;
         }
@@ -236,7 +337,7 @@ rafs_errors_t Rafs_DoRead(rafs_file_t file_id, void *buf,
                 raPartition_result ra_result = Rafs_PartRead(&rafs_self->partition->part_handle,
                                                      extent_start, this_read_len, buff_ptr);
                 if( ra_result != RA_PARTITION_RESULT_SUCCESS )
-                    DEBUG_LOG_ALWAYS("Rafs_DoRead(%d,%lu)=%d", file_id, num_bytes_to_read, ra_result);
+                    DEBUG_LOG_ALWAYS("Rafs_DoRead(%d,%u)=%d", file_id, num_bytes_to_read, ra_result);
             }
 
             buff_ptr += this_read_len;
@@ -301,10 +402,9 @@ rafs_errors_t Rafs_DoWrite(rafs_file_t file_id, const void *buf,
 
             if( this_write_len > 0 )
             {
-                raPartition_result ra_result = Rafs_PartWrite(&rafs_self->partition->part_handle,
-                                                      extent_start, this_write_len, buff_ptr);
+                raPartition_result ra_result = Rafs_BufferedWrite(extent_start, this_write_len, buff_ptr);
                 if( ra_result != RA_PARTITION_RESULT_SUCCESS )
-                    DEBUG_LOG_ALWAYS("Rafs_DoWrite(%d,%lu)=%d", file_id, this_write_len, ra_result);
+                    DEBUG_LOG_ALWAYS("Rafs_DoWrite(%d,%u)=%d", file_id, this_write_len, ra_result);
             }
 
             buff_ptr += this_write_len;
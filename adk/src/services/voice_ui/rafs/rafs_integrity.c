@@ -66,7 +66,7 @@ static rafs_errors_t Rafs_CheckDirectoryEntries(void)
             }
             else if( pri_type == DT_UNKNOWN || sec_type == DT_UNKNOWN )
             {
-                DEBUG_LOG_ALWAYS("Rafs_CheckDirectoryEntries: Entry:%lu, unknown chars %x,%x", d, pri_ch, sec_ch);
+                DEBUG_LOG_ALWAYS("Rafs_CheckDirectoryEntries: Entry:%u, unknown chars %x,%x", d, pri_ch, sec_ch);
                 result = RAFS_INVALID_FAT;
                 ok = FALSE;
             }
@@ -77,7 +77,7 @@ static rafs_errors_t Rafs_CheckDirectoryEntries(void)
                     if( sec_type != DT_ERASED )
                     {
                         /* Secondary FAT is unusable at this point */
-                        DEBUG_LOG_ALWAYS("Rafs_CheckDirectoryEntries: Entry:%lu, secondary FAT improperly erased", d);
+                        DEBUG_LOG_ALWAYS("Rafs_CheckDirectoryEntries: Entry:%u, secondary FAT improperly erased", d);
                         result = RAFS_INVALID_FAT;
                         ok = FALSE;
                     }
@@ -88,13 +88,13 @@ static rafs_errors_t Rafs_CheckDirectoryEntries(void)
                     {
                         /* Expect this from interrupted file close (write) */
                         /* Recovery is to copy the primary to the secondary */
-                        DEBUG_LOG_DEBUG("Rafs_CheckDirectoryEntries: Entry:%lu, secondary FAT caught up to primary(write) - OK", d);
+                        DEBUG_LOG_DEBUG("Rafs_CheckDirectoryEntries: Entry:%u, secondary FAT caught up to primary(write) - OK", d);
                         ok = Rafs_DirEntryRead(PRI_FAT, rafs_self->files->scan_dir_entry, d);
                         ok = ok && Rafs_DirEntryWrite(SEC_FAT, rafs_self->files->scan_dir_entry, d);
                     }
                     else if( sec_type == DT_DELETED )
                     {
-                        DEBUG_LOG_ALWAYS("Rafs_CheckDirectoryEntries: Entry:%lu, secondary FAT improperly deleted", d);
+                        DEBUG_LOG_ALWAYS("Rafs_CheckDirectoryEntries: Entry:%u, secondary FAT improperly deleted", d);
                         result = RAFS_INVALID_FAT;
                         ok = FALSE;
                     }
@@ -105,7 +105,7 @@ static rafs_errors_t Rafs_CheckDirectoryEntries(void)
                     {
                         /* Repair backup FAT by marking the file as also deleted */
                         /* Expect this from interrupted file removal */
-                        DEBUG_LOG_DEBUG("Rafs_CheckDirectoryEntries: Entry:%lu, secondary FAT caught up to primary(remove) - OK", d);
+                        DEBUG_LOG_DEBUG("Rafs_CheckDirectoryEntries: Entry:%u, secondary FAT caught up to primary(remove) - OK", d);
                         ok = Rafs_DirEntryWriteMember(SEC_FAT, &pri_ch, d, offsetof(dir_entry_t,filename), sizeof(pri_ch));
                     }
                 }
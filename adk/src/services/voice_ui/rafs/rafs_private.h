@@ -53,6 +53,9 @@ typedef struct {
     bool                compact_is_needed;          /*!< Whether compact will find anything useful to do. */
     uint16              num_open_files;             /*!< How many files are open at the moment */
     uint16              sequence_number;            /*!< The next value to use as the file's 'created' age */
+    uint8              *write_buffer;               /*!< Small writes to the file open for writing are gathered here */
+    uint32              write_buffer_offset;        /*!< The partition offset of write_buffer[0] */
+    uint16              write_buffer_used;          /*!< The number of bytes held in write_buffer */
 } fileinfo_t;
 
 /*!
@@ -74,6 +77,11 @@ typedef struct {
     partinfo_t         *partition;  /*!< Data relating to the mounted partition */
     uint32             *sector_in_use_map;          /*!< Bitmap of used sectors */
     uint32              sector_in_use_map_length;   /*!< The number of data elements \see sector_in_use_map points to */
+    inode_t            *free_extents;               /*!< The free extents in the sector map, in address order */
+    uint16              num_free_extents;           /*!< The number of extents in free_extents */
+    uint16              free_extents_capacity;      /*!< The number of extents free_extents has space for */
+    inode_t             longest_free_extent;        /*!< A copy of the longest extent in free_extents */
+    bool                longest_free_extent_valid;  /*!< Whether longest_free_extent is up to date */
     fileinfo_t         *files;      /*!< Data relating to opened files */
     dirinfo_t          *directory;  /*!< Data for Rafs_ReadDirectory */
     rafs_power_t        power;      /*!< The charger and battery status */
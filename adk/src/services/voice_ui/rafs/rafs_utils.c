@@ -18,6 +18,7 @@
 #include "rafs.h"
 #include "rafs_private.h"
 #include "rafs_utils.h"
+#include "rafs_extent.h"
 
 #define LENGTH_OF_UNNAMED_PARTITION_NAME 1
 
@@ -197,11 +198,15 @@ void Rafs_FreeFilesStructure(void)
     {
         free(rafs_self->files->open_files[i]);
     }
+    /* Unwritten data of a file open for writing is dropped with it */
+    free(rafs_self->files->write_buffer);
     free(rafs_self->files);
     rafs_self->files = NULL;
 
     free(rafs_self->sector_in_use_map);
     rafs_self->sector_in_use_map = NULL;
+
+    Rafs_ResetFreeExtents();
 }
 
 void Rafs_FreePartitionStructure(void)
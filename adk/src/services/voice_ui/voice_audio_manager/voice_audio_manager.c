@@ -27,7 +27,7 @@ bool VoiceAudioManager_StartCapture(VaAudioCaptureDataReceived callback, const v
 
     if (VoiceAudioManager_UpdateState(live_capture_start))
     {
-        VoiceAudioManager_CaptureStarting(callback);
+        VoiceAudioManager_CaptureStarting(callback, capture_config->wakeup_threshold);
         Kymera_StartVoiceCapture(VoiceAudioManager_CaptureStarted, capture_config);
         status = TRUE;
     }
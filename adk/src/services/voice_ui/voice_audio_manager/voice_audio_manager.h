@@ -22,6 +22,19 @@
  */
 typedef bool (* VaAudioCaptureDataReceived)(Source capture_source);
 
+/*! \brief Statistics of the current or last voice capture */
+typedef struct
+{
+    /*! Times the captured data was checked */
+    uint32 wakeups;
+    /*! Times the client was given the captured data */
+    uint32 deliveries;
+    /*! Microseconds spent handling the captured data, including in the client */
+    uint32 busy_us;
+    /*! Milliseconds the capture has been running */
+    uint32 capture_ms;
+} voice_audio_manager_capture_statistics_t;
+
 /*! \brief Response to a Wake-Up-Word detected indication */
 typedef struct
 {
@@ -48,6 +61,11 @@ bool VoiceAudioManager_StartCapture(VaAudioCaptureDataReceived callback, const v
 */
 bool VoiceAudioManager_StopCapture(void);
 
+/*! \brief Get the statistics of the current or last voice capture
+    \param statistics Filled in with the statistics
+*/
+void VoiceAudioManager_GetCaptureStatistics(voice_audio_manager_capture_statistics_t *statistics);
+
 /*! \brief Start Wake-Up-Word detection
     \param callback Callback function to call once the Wake-Up-Word has been detected
     \param audio_config Configuration related to Wake-Up-Word detection
@@ -13,6 +13,9 @@
 #include <logging.h>
 #include <message.h>
 #include <panic.h>
+#include <rtime.h>
+#include <system_clock.h>
+#include <string.h>
 
 #define DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_PROCESSED_MS 5
 #define DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_NOT_PROCESSED_MS 30
@@ -27,6 +30,36 @@ static const TaskData msg_handler = { voiceAudioManager_MsgHandler };
 
 static VaAudioCaptureDataReceived mic_data_available = NULL;
 static Source capture_source = NULL;
+static uint16 capture_wakeup_threshold = 0;
+
+static struct
+{
+    /*! When the capture started */
+    rtime_t start_time;
+    /*! Mic data in the source when the capture started */
+    unsigned start_size;
+    /*! Mic data the client has consumed */
+    uint32 consumed;
+    voice_audio_manager_capture_statistics_t statistics;
+} capture_stats;
+
+/*! \brief Estimate how long until the source holds the wakeup threshold,
+           from the rate mic data has arrived since the capture started. */
+static Delay voiceAudioManager_TimeToWakeupThreshold(unsigned source_size, rtime_t now)
+{
+    uint32 elapsed_ms = rtime_sub(now, capture_stats.start_time) / US_PER_MS;
+    uint32 arrived = capture_stats.consumed + source_size;
+    Delay delay = DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_PROCESSED_MS;
+
+    if (arrived > capture_stats.start_size && source_size < capture_wakeup_threshold)
+    {
+        arrived -= capture_stats.start_size;
+        delay = ((capture_wakeup_threshold - source_size) * elapsed_ms) / arrived;
+        delay = MAX(delay, 1);
+        delay = MIN(delay, DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_NOT_PROCESSED_MS);
+    }
+    return delay;
+}
 
 static void voiceAudioManager_MicDataReceived(Source source)
 {
@@ -34,23 +67,36 @@ static void voiceAudioManager_MicDataReceived(Source source)
 
     if (VoiceAudioManager_IsMicDataExpected())
     {
+        rtime_t now = SystemClockGetTimerTime();
         unsigned mic_data_processed = TRUE;
         unsigned source_size = SourceSize(source);
+        Delay timeout = DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_PROCESSED_MS;
         PanicFalse(mic_data_available != NULL);
 
-        if (source_size)
+        capture_stats.statistics.wakeups++;
+
+        /* Below the wakeup threshold the client is left to sleep, as it would
+           only wait for more data before sending any */
+        if (source_size && source_size >= capture_wakeup_threshold)
         {
             mic_data_processed = mic_data_available(source);
+            capture_stats.statistics.deliveries++;
+            capture_stats.consumed += source_size;
+            source_size = SourceSize(source);
+            capture_stats.consumed -= source_size;
         }
 
-        if (mic_data_processed)
+        if (!mic_data_processed)
         {
-            MessageSendLater((Task) &msg_handler, CAPTURE_DATA_RECEIVED_TIMEOUT, NULL, DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_PROCESSED_MS);
+            timeout = DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_NOT_PROCESSED_MS;
         }
-        else
+        else if (capture_wakeup_threshold)
         {
-            MessageSendLater((Task) &msg_handler, CAPTURE_DATA_RECEIVED_TIMEOUT, NULL, DEFAULT_CAPTURE_TIMEOUT_WHEN_DATA_NOT_PROCESSED_MS);
+            timeout = voiceAudioManager_TimeToWakeupThreshold(source_size, now);
         }
+        MessageSendLater((Task) &msg_handler, CAPTURE_DATA_RECEIVED_TIMEOUT, NULL, timeout);
+
+        capture_stats.statistics.busy_us += rtime_sub(SystemClockGetTimerTime(), now);
     }
 }
 
@@ -81,8 +127,17 @@ static void voiceAudioManager_MsgHandler(Task task, MessageId id, Message messag
 
 static void voiceAudioManager_RegisterSource(Source source)
 {
+    /* With a wakeup threshold the source is polled when it is expected to
+       reach it, rather than on every frame the encoder writes */
+    vm_messages_settings messages = capture_wakeup_threshold ? VM_MESSAGES_NONE : VM_MESSAGES_SOME;
+
     MessageStreamTaskFromSource(source, (Task) &msg_handler);
-    PanicFalse(SourceConfigure(source, VM_SOURCE_MESSAGES, VM_MESSAGES_SOME));
+    PanicFalse(SourceConfigure(source, VM_SOURCE_MESSAGES, messages));
+}
+
+static void voiceAudioManager_UpdateCaptureTime(void)
+{
+    capture_stats.statistics.capture_ms = rtime_sub(SystemClockGetTimerTime(), capture_stats.start_time) / US_PER_MS;
 }
 
 static void voiceAudioManager_DeregisterSource(Source source)
@@ -97,12 +152,23 @@ void VoiceAudioManager_CaptureStopping(void)
         voiceAudioManager_DeregisterSource(capture_source);
         MessageFlushTask((Task) &msg_handler);
         capture_source = NULL;
+
+        voiceAudioManager_UpdateCaptureTime();
+        if (capture_stats.statistics.capture_ms)
+        {
+            DEBUG_LOG_INFO("VoiceAudioManager_CaptureStopping %u ms, %u wakeups/s, %u deliveries/s, %u us CPU per s",
+                           capture_stats.statistics.capture_ms,
+                           (capture_stats.statistics.wakeups * 1000) / capture_stats.statistics.capture_ms,
+                           (capture_stats.statistics.deliveries * 1000) / capture_stats.statistics.capture_ms,
+                           (uint32)(((uint64)capture_stats.statistics.busy_us * 1000) / capture_stats.statistics.capture_ms));
+        }
     }
 }
 
-void VoiceAudioManager_CaptureStarting(VaAudioCaptureDataReceived callback)
+void VoiceAudioManager_CaptureStarting(VaAudioCaptureDataReceived callback, uint16 wakeup_threshold)
 {
     mic_data_available = callback;
+    capture_wakeup_threshold = wakeup_threshold;
 }
 
 void VoiceAudioManager_CaptureStarted(Source source)
@@ -110,15 +176,29 @@ void VoiceAudioManager_CaptureStarted(Source source)
     if (VoiceAudioManager_IsMicDataExpected())
     {
         capture_source = source;
+        memset(&capture_stats, 0, sizeof(capture_stats));
+        capture_stats.start_time = SystemClockGetTimerTime();
+        capture_stats.start_size = SourceSize(source);
         voiceAudioManager_RegisterSource(source);
         voiceAudioManager_MicDataReceived(source);
     }
 }
 
+void VoiceAudioManager_GetCaptureStatistics(voice_audio_manager_capture_statistics_t *statistics)
+{
+    if (capture_source)
+    {
+        voiceAudioManager_UpdateCaptureTime();
+    }
+    *statistics = capture_stats.statistics;
+}
+
 void VoiceAudioManager_CaptureTestReset(void)
 {
     mic_data_available = NULL;
     capture_source = NULL;
+    capture_wakeup_threshold = 0;
+    memset(&capture_stats, 0, sizeof(capture_stats));
 }
 
 #endif /* INCLUDE_VOICE_UI */
@@ -15,8 +15,10 @@
 
 /*! \brief Must be called when a start capture is requested
     \param callback Will be called whenever mic data becomes available
+    \param wakeup_threshold Bytes of mic data to buffer before calling the callback,
+           0 to call it as soon as any data arrives
 */
-void VoiceAudioManager_CaptureStarting(VaAudioCaptureDataReceived callback);
+void VoiceAudioManager_CaptureStarting(VaAudioCaptureDataReceived callback, uint16 wakeup_threshold);
 
 /*! \brief Must be called when a capture has started
     \param source The capture/mic source
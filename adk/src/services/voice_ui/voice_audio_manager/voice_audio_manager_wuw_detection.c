@@ -33,7 +33,8 @@ kymera_wuw_detected_response_t VoiceAudioManager_WuwDetected(const va_audio_wuw_
         {
             PanicFalse(VoiceAudioManager_UpdateState(wuw_capture_start));
             PanicFalse(clients_response.capture_callback != NULL);
-            VoiceAudioManager_CaptureStarting(clients_response.capture_callback);
+            VoiceAudioManager_CaptureStarting(clients_response.capture_callback,
+                                              clients_response.capture_params.wakeup_threshold);
 
             response.start_capture = TRUE;
             response.capture_callback = VoiceAudioManager_CaptureStarted;
@@ -49,8 +49,8 @@ def _TypeDefEmitter(target, source, env):
     return target, source
 
 _TypeDefBuilder = SCons.Builder.Builder(
-        action=[r'$python $typegen ${SOURCE.abspath} --marshal_header > ${TARGET.base}.h',
-                r'$python $typegen ${SOURCE.abspath} --marshal_source > $TARGET',
+        action=[r'$python $typegen ${SOURCE.abspath} --marshal_header $TYPEGENFLAGS > ${TARGET.base}.h',
+                r'$python $typegen ${SOURCE.abspath} --marshal_source $TYPEGENFLAGS > $TARGET',
                 r'$python $typegen ${SOURCE.abspath} --typedef_header > ${TARGET.dir}/${SOURCE.filebase}_typedef.h'],
         suffix='.c',
         src_suffix='.typedef',
@@ -62,6 +62,8 @@ def generate(env):
 
     python.generate(env)
     env['typegen'] = _detect(env)
+    # Extra typegen options for the marshal files, e.g. --specialised
+    env.SetDefault(TYPEGENFLAGS='')
     env['BUILDERS']['TypeDefObject'] = _TypeDefBuilder
 
 def exists(env):
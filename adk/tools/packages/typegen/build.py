@@ -27,8 +27,9 @@ def redirect_stdout(new_target):
 
 
 class Builder(object):
-    def __init__(self, root):
+    def __init__(self, root, specialised=False):
         self._root = root
+        self._specialised = specialised
 
 
     def _get_files(self, path):
@@ -67,7 +68,7 @@ class Builder(object):
     def generate_typedefs(self, files):
         for file in files:
             file_name, _ = os.path.splitext(file)
-            typegen = TypesGenerator(self.get_xml(file))
+            typegen = TypesGenerator(self.get_xml(file), self._specialised, [os.path.dirname(os.path.abspath(file))])
             self.generate_file(file_name + '_typedef.h', typegen.generate_typedef_header)
             self.generate_file(file_name + '_marshal_typedef.h', typegen.generate_marshal_header)
             self.generate_file(file_name + '_marshal_typedef.c', typegen.generate_marshal_source)
@@ -91,9 +92,9 @@ def get_typedefs(x2pfile):
 
     return filelist
 
-def runbuilder(source, is_directory):
+def runbuilder(source, is_directory, specialised=False):
     root = os.getcwd()
-    builder = Builder(root)
+    builder = Builder(root, specialised)
     builder.run(source, is_directory)
 
 def process_commandline_arguments():
@@ -107,16 +108,17 @@ def process_commandline_arguments():
     group = parser.add_mutually_exclusive_group(required=True)
     group.add_argument('--file', dest='x2pfile', help='X2P File for reading the TYPEDEF list')    
     group.add_argument('--source', dest='dir', help='The root directory from which to search for*.typedef files')
+    parser.add_argument('--specialised', action='store_true', help='Also generate specialised marshal and unmarshal functions')
 
     return parser.parse_args()
 
 def main():
     args = process_commandline_arguments()
     if args.x2pfile:
-        runbuilder(get_typedefs(args.x2pfile), False)
+        runbuilder(get_typedefs(args.x2pfile), False, args.specialised)
 
     if args.dir:
-        runbuilder(args.dir, True)
+        runbuilder(args.dir, True, args.specialised)
 
 if __name__ == "__main__":
     main()
@@ -94,6 +94,44 @@ Description of XML format
     <inherit header="marshal_common.h" count="NUMBER_OF_COMMON_MARSHAL_OBJECT_TYPES" x_macro_table="MARSHAL_COMMON_TYPES_TABLE"/>
 
 
+8. Specialised marshalling
+  If the types element has specialised="true", or typegen is run with the
+  --specialised option, the <name>_marshal_typedef.[ch] files also declare and
+  define a pair of functions for each type that can be marshalled without the
+  marshal type descriptors:
+
+    bool marshal_specialised_<type>(const void *object, marshal_type_t type,
+                                    uint8 *buf, size_t space, size_t *produced);
+    void *unmarshal_specialised_<type>(marshal_type_t type, const uint8 *buf,
+                                       size_t size, size_t *consumed);
+
+  The functions copy each marshalled member with straight-line code (and BASIC
+  types with a single memcpy) rather than interpreting the descriptors member by
+  member at run time. They read and write the same byte stream as the marshal
+  library: the type (MARSHAL_TYPE(type) is passed by the caller), the number of
+  dynamic array elements (if any), the member values in descriptor order and the
+  end of objects marker. The object is marshalled in one go, marshal_specialised
+  returns FALSE without writing anything if the buffer is too small, setting
+  *produced to the space needed, and unmarshal_specialised returns NULL if the
+  buffer does not hold a complete object. The unmarshalled object is allocated
+  with calloc.
+
+  A standalone file also gets a table of the functions, in the same order as
+  its type descriptors, with NULL functions for the types that are not
+  specialised (including all inherited types):
+
+    extern const marshal_specialised_t <name>_marshal_specialised[];
+
+  The table can be passed to appPeerSigMarshalledMsgChannelSetSpecialised() to
+  have peer signalling use the functions for the channel's messages.
+
+  A type is specialised only if it and all its marshalled members are
+  structures or BASIC types defined in the typedef file, in a typedef file
+  whose <name>_typedef.h is included from the same directory, in marshal_common.h
+  or are aliased to such a type with a #define MARSHAL_TYPE_x MARSHAL_TYPE_y in
+  the typedef file. Types with pointer or union members, and types containing
+  a dynamic length member, are left to the descriptor driven marshaller.
+
 Note - Source code which is added as text (i.e. within <source>,<typedef_header_source> or <typedef_enum> tags) need to escape special characters
        '>', '<' as these cannot be parsed by XML parser. For example, '<' need to be replaced with '&lt;' in source.
   
@@ -162,9 +200,370 @@ except ImportError:
     sys.path.insert(0, os.path.join(parent_dir, "codegen"))
     from codegen import CommentBlock, CommentBlockDoxygen, HeaderGuards, ConditionalBlock, Enumeration, Array, StructTypedef, UnionTypedef, Include, Indented, EnumerationTypedef
 
+# The marshal_common.h types, as described by their descriptors in marshal_common.c.
+# Leaf types map to the C type used for the descriptor's size.
+COMMON_LEAF_TYPES = {
+    'uint8': 'uint8',
+    'uint16': 'uint16',
+    'uint32': 'uint32',
+    'uint64': 'unsigned long long',
+    'int8': 'int8',
+    'int16': 'int16',
+    'int32': 'int32',
+    'marshal_rtime_t': 'marshal_rtime_t',
+}
+
+# Leaf types copied with the custom copy callbacks of their descriptor.
+COMMON_CUSTOM_COPY_TYPES = {
+    'marshal_rtime_t': 'marshal_type_descriptor_marshal_rtime_t',
+}
+
+# Structure types, as (type, member) lists in descriptor order.
+COMMON_STRUCT_TYPES = {
+    'bdaddr': [('uint32', 'lap'), ('uint8', 'uap'), ('uint16', 'nap')],
+    'typed_bdaddr': [('uint8', 'type'), ('bdaddr', 'addr')],
+    'tp_bdaddr': [('typed_bdaddr', 'taddr'), ('TRANSPORT_T', 'transport')],
+}
+
+# The typed_bdaddr and tp_bdaddr descriptors have the size of a bdaddr, so an
+# array of them is not laid out as the descriptor driven marshaller expects.
+COMMON_NOT_ARRAYABLE_TYPES = ['typed_bdaddr', 'tp_bdaddr']
+
+COMMON_ALIASES = {
+    'TRANSPORT_T': 'uint8',
+}
+
+
+class SpecialisedType(object):
+    ''' The layout of a type as seen by the descriptor driven marshaller '''
+    def __init__(self, name, ctype=None, members=None, custom_copy=None,
+                 arrayable=True, array_elements_cb=None, unsupported=None):
+        self.name = name
+        # The C type whose size is used for a leaf, or None for a structure
+        self.ctype = ctype
+        # List of (type, member name, array elements or None) for a structure
+        self.members = members
+        # The descriptor providing custom copy callbacks for a leaf
+        self.custom_copy = custom_copy
+        self.arrayable = arrayable
+        # Callback giving the number of elements of a final dynamic array member
+        self.array_elements_cb = array_elements_cb
+        # Reason the type cannot be specialised
+        self.unsupported = unsupported
+
+    @property
+    def is_leaf(self):
+        return self.ctype is not None
+
+
+class SpecialisedCodeGenerator(object):
+    ''' Generate straight-line marshal and unmarshal functions for types that
+        do not need the run time interpretation of the descriptors '''
+    def __init__(self, root, regex, search_paths):
+        self._regex = regex
+        self._types = {}
+        self._aliases = dict(COMMON_ALIASES)
+        self._local = []
+        self._specialisable = {}
+        self._add_types(root, search_paths, set(), local=True)
+
+    def _add_types(self, root, search_paths, visited, local=False):
+        ''' Register the types and aliases defined in a typedef root, and
+            those of any typedef files it includes '''
+        for t in root:
+            if t.tag in ["source", "typedef_header_source"] and t.text:
+                for alias, target in re.findall(r"#define\s+MARSHAL_TYPE_(\w+)\s+MARSHAL_TYPE_(\w+)", t.text):
+                    self._aliases[alias] = target
+            elif t.tag == "include_header":
+                header = t.get('name')
+                if header.endswith("_typedef.h") and not header.endswith("_marshal_typedef.h"):
+                    self._add_included_types(header[:-len("_typedef.h")] + ".typedef", search_paths, visited)
+            elif t.tag in ["typedef_struct", "typedef_union", "typedef_enum"]:
+                spec = self._parse_type(t)
+                self._types[spec.name] = spec
+                if local:
+                    self._local.append(spec.name)
+
+    def _add_included_types(self, typedef_file, search_paths, visited):
+        for path in search_paths:
+            filename = os.path.join(path, typedef_file)
+            if os.path.isfile(filename) and filename not in visited:
+                visited.add(filename)
+                self._add_types(ET.parse(filename).getroot(), search_paths, visited)
+                return
+
+    def _parse_type(self, t):
+        name = t.get('name')
+        has = t.get('has')
+
+        if t.get('basic') == "true":
+            return SpecialisedType(name, ctype=name)
+        if t.tag == "typedef_enum":
+            return SpecialisedType(name, unsupported="enumeration is not BASIC")
+        if t.tag == "typedef_union":
+            return SpecialisedType(name, unsupported="union")
+        if has not in [None, "dynamic_array"]:
+            return SpecialisedType(name, unsupported="has " + has)
+        if has == "dynamic_array" and not t.get('array_elements_cb'):
+            return SpecialisedType(name, unsupported="no array_elements_cb")
+
+        members = []
+        for m in t.findall('member'):
+            if m.get('marshal') == "false":
+                continue
+            groups = self._regex.match(m.text).groups()
+            if groups[1] is not None:
+                return SpecialisedType(name, unsupported="pointer member " + groups[2])
+            elements = groups[3].split('[')[1].split(']')[0] if groups[3] else None
+            members.append((groups[0], groups[2], elements))
+
+        return SpecialisedType(name, members=members, array_elements_cb=t.get('array_elements_cb'))
+
+    def _resolve(self, name):
+        ''' Return the SpecialisedType of a marshal type name, or None if unknown '''
+        while name in self._aliases:
+            name = self._aliases[name]
+        if name in self._types:
+            return self._types[name]
+        if name in COMMON_LEAF_TYPES:
+            return SpecialisedType(name, ctype=COMMON_LEAF_TYPES[name],
+                                   custom_copy=COMMON_CUSTOM_COPY_TYPES.get(name),
+                                   arrayable=name not in COMMON_CUSTOM_COPY_TYPES)
+        if name in COMMON_STRUCT_TYPES:
+            return SpecialisedType(name, members=[(mt, mn, None) for mt, mn in COMMON_STRUCT_TYPES[name]],
+                                   arrayable=name not in COMMON_NOT_ARRAYABLE_TYPES)
+        return None
+
+    def _unsupported(self, name):
+        ''' Return the reason a type cannot be specialised, or None if it can '''
+        if name not in self._specialisable:
+            spec = self._resolve(name)
+            if spec is None:
+                reason = "unknown type " + name
+            elif spec.unsupported or spec.is_leaf:
+                reason = spec.unsupported
+            else:
+                reason = None
+                for member_type, member_name, elements in spec.members:
+                    member = self._resolve(member_type)
+                    if member is None:
+                        reason = "unknown type " + member_type
+                    elif member.array_elements_cb:
+                        reason = "dynamic length member " + member_name
+                    elif elements and not member.arrayable:
+                        reason = "array of " + member_type
+                    else:
+                        reason = self._unsupported(member_type)
+                    if reason:
+                        break
+            self._specialisable[name] = reason
+        return self._specialisable[name]
+
+    def specialised_types(self):
+        ''' Return the names of the specialised types defined in the root '''
+        return [name for name in self._local if not self._unsupported(name)]
+
+    def unspecialised_types(self):
+        ''' Return (name, reason) of the types defined in the root that are not specialised '''
+        return [(name, self._unsupported(name)) for name in self._local if self._unsupported(name)]
+
+    def _operations(self, name, base, offset, elements=None, depth=0):
+        ''' Return the copy operations of the type at base + offset.
+            An operation is either ('copy', base, offset, size, custom_copy) or
+            ('loop', count, base, offset, stride, depth, operations). The
+            elements of a loop at depth n are addressed by en and indexed by in. '''
+        spec = self._resolve(name)
+        if spec.is_leaf:
+            size = "sizeof({})".format(spec.ctype)
+            if elements:
+                # Arrays of leaves are copied as a single block
+                size = "{} * {}".format(elements, size)
+            return [('copy', base, offset, size, spec.custom_copy)]
+
+        if elements:
+            stride = "sizeof({})".format(name)
+            return [('loop', elements, base, offset, stride, depth,
+                     self._operations(name, "e{}".format(depth), "0", depth=depth + 1))]
+
+        operations = []
+        for index, (member_type, member_name, member_elements) in enumerate(spec.members):
+            member_offset = "offsetof({}, {})".format(name, member_name)
+            if offset != "0":
+                member_offset = offset + " + " + member_offset
+            if spec.array_elements_cb and index == len(spec.members) - 1:
+                member_elements = "elements"
+            operations.extend(self._operations(member_type, base, member_offset, member_elements, depth))
+        return operations
+
+    @staticmethod
+    def _size(operations):
+        sizes = []
+        for op in operations:
+            if op[0] == 'copy':
+                sizes.append(op[3])
+            else:
+                sizes.append("{} * ({})".format(op[1], SpecialisedCodeGenerator._size(op[6])))
+        return " + ".join(sizes) if sizes else "0"
+
+    @staticmethod
+    def _loop_depth(operations):
+        depth = 0
+        for op in operations:
+            if op[0] == 'loop':
+                depth = max(depth, op[5] + 1, SpecialisedCodeGenerator._loop_depth(op[6]))
+        return depth
+
+    def _print_operations(self, operations, marshal):
+        for op in operations:
+            if op[0] == 'copy':
+                _, base, offset, size, custom_copy = op
+                address = base if offset == "0" else "{} + {}".format(base, offset)
+                if marshal:
+                    dest, src, direction = "buf", address, "marshal_copy"
+                else:
+                    dest, src, direction = address, "buf", "unmarshal_copy"
+                if custom_copy:
+                    print(Indented.indent() + "(void){}.u.custom_copy_cbs->{}({}, {}, {});".format(
+                        custom_copy, direction, dest, src, size))
+                else:
+                    print(Indented.indent() + "memcpy({}, {}, {});".format(dest, src, size))
+                print(Indented.indent() + "buf += {};".format(size))
+            else:
+                _, count, base, offset, stride, depth, inner = op
+                address = base if offset == "0" else "{} + {}".format(base, offset)
+                print(Indented.indent() + "for (i{0} = 0; i{0} < {1}; i{0}++)".format(depth, count))
+                print(Indented.indent() + "{")
+                with Indented():
+                    print(Indented.indent() + "e{0} = {1} + i{0} * {2};".format(depth, address, stride))
+                    self._print_operations(inner, marshal)
+                print(Indented.indent() + "}")
+
+    def _print_locals(self, operations, marshal):
+        qualifier = "const " if marshal else ""
+        for depth in range(self._loop_depth(operations)):
+            print(Indented.indent() + "{}uint8 *e{};".format(qualifier, depth))
+            print(Indented.indent() + "uint32 i{};".format(depth))
+
+    def _print_elements(self, name, spec, obj):
+        print(Indented.indent() + "elements = {}({}, &{}_member_descriptors[ARRAY_DIM({}_member_descriptors) - 1], 0);".format(
+            spec.array_elements_cb, obj, name, name))
+
+    def generate_declarations(self, types_name, standalone):
+        names = self.specialised_types()
+        if names:
+            print("/* Specialised marshal functions, see typegen.py for a description. */")
+        for name in names:
+            print("bool marshal_specialised_{0}(const void *object, marshal_type_t type, uint8 *buf, size_t space, size_t *produced);".format(name))
+            print("void *unmarshal_specialised_{0}(marshal_type_t type, const uint8 *buf, size_t size, size_t *consumed);".format(name))
+        if standalone:
+            print("extern const marshal_specialised_t {}_marshal_specialised[];".format(types_name))
+        print("")
+
+    def generate_table(self, types_name, inherited_tables):
+        ''' Generate the table of specialised functions, indexed by marshal type '''
+        specialised = self.specialised_types()
+        entries = []
+        if inherited_tables:
+            print("#define EXPAND_AS_NOT_SPECIALISED(type) { NULL, NULL },")
+            entries.extend(["{}(EXPAND_AS_NOT_SPECIALISED)".format(table) for table in inherited_tables])
+        for name in self._local:
+            if name in specialised:
+                entries.append("{{ marshal_specialised_{0}, unmarshal_specialised_{0} }},".format(name))
+            else:
+                entries.append("{ NULL, NULL },")
+        with Array("const marshal_specialised_t", types_name + "_marshal_specialised", eol="") as arr:
+            arr.extend(entries)
+        if inherited_tables:
+            print("#undef EXPAND_AS_NOT_SPECIALISED\n")
+
+    def generate_definitions(self):
+        for name, reason in self.unspecialised_types():
+            print("/* {} is not specialised ({}) */".format(name, reason))
+        print("")
+        for name in self.specialised_types():
+            self._generate_marshal(name)
+            self._generate_unmarshal(name)
+
+    def _header_size(self, spec):
+        ''' The type, and for dynamic types the number of array elements '''
+        return "2" if spec.array_elements_cb else "1"
+
+    def _generate_marshal(self, name):
+        spec = self._resolve(name)
+        operations = self._operations(name, "object_base", "0")
+
+        print("bool marshal_specialised_{0}(const void *object, marshal_type_t type, uint8 *buf, size_t space, size_t *produced)".format(name))
+        print("{")
+        with Indented():
+            print(Indented.indent() + "const uint8 *object_base = (const uint8 *)object;")
+            if spec.array_elements_cb:
+                print(Indented.indent() + "uint32 elements;")
+            print(Indented.indent() + "size_t size;")
+            self._print_locals(operations, True)
+            print("")
+            if spec.array_elements_cb:
+                self._print_elements(name, spec, "object")
+                print(Indented.indent() + "PanicFalse(elements <= UCHAR_MAX);")
+            print(Indented.indent() + "size = {} + {} + 1;".format(self._header_size(spec), self._size(operations)))
+            print(Indented.indent() + "*produced = size;")
+            print(Indented.indent() + "if (size > space)")
+            print(Indented.indent() + "{")
+            with Indented():
+                print(Indented.indent() + "return FALSE;")
+            print(Indented.indent() + "}")
+            print(Indented.indent() + "*buf++ = type;")
+            if spec.array_elements_cb:
+                print(Indented.indent() + "*buf++ = (uint8)elements;")
+            self._print_operations(operations, True)
+            print(Indented.indent() + "*buf = MARSHAL_TYPES_MAX;")
+            print(Indented.indent() + "return TRUE;")
+        print("}\n")
+
+    def _generate_unmarshal(self, name):
+        spec = self._resolve(name)
+        operations = self._operations(name, "object_base", "0")
+        header = self._header_size(spec)
+
+        print("void *unmarshal_specialised_{0}(marshal_type_t type, const uint8 *buf, size_t size, size_t *consumed)".format(name))
+        print("{")
+        with Indented():
+            print(Indented.indent() + "uint8 *object_base;")
+            if spec.array_elements_cb:
+                print(Indented.indent() + "uint32 elements;")
+            print(Indented.indent() + "size_t object_size;")
+            print(Indented.indent() + "size_t marshalled_size;")
+            self._print_locals(operations, False)
+            print("")
+            print(Indented.indent() + "if (size < {} || buf[0] != type)".format(header))
+            print(Indented.indent() + "{")
+            with Indented():
+                print(Indented.indent() + "return NULL;")
+            print(Indented.indent() + "}")
+            if spec.array_elements_cb:
+                last = spec.members[-1]
+                print(Indented.indent() + "elements = buf[1];")
+                print(Indented.indent() + "object_size = offsetof({}, {}) + elements * {};".format(
+                    name, last[1], self._size(self._operations(last[0], "object_base", "0"))
+                    if self._resolve(last[0]).is_leaf else "sizeof({})".format(last[0])))
+            else:
+                print(Indented.indent() + "object_size = sizeof({});".format(name))
+            print(Indented.indent() + "marshalled_size = {} + {} + 1;".format(header, self._size(operations)))
+            print(Indented.indent() + "if (size < marshalled_size || buf[marshalled_size - 1] != MARSHAL_TYPES_MAX)")
+            print(Indented.indent() + "{")
+            with Indented():
+                print(Indented.indent() + "return NULL;")
+            print(Indented.indent() + "}")
+            print(Indented.indent() + "object_base = PanicNull(calloc(1, object_size));")
+            print(Indented.indent() + "buf += {};".format(header))
+            self._print_operations(operations, False)
+            print(Indented.indent() + "*consumed = marshalled_size;")
+            print(Indented.indent() + "return object_base;")
+        print("}\n")
+
+
 class TypesGenerator(object):
     ''' Type generator class '''
-    def __init__(self, element_tree_root):
+    def __init__(self, element_tree_root, specialised=False, search_paths=None):
         self._root = element_tree_root
         self._types_name = self._root.attrib['name'].lower()
         self._conditional = ""
@@ -178,6 +577,10 @@ class TypesGenerator(object):
         self._validate_inherit()
         self._extract_source_conditional()
 
+        self._specialised = None
+        if specialised or self._root.get('specialised', "false").lower() == "true":
+            self._specialised = SpecialisedCodeGenerator(self._root, self._regex, search_paths or [])
+
     def _validate_inherit(self):
         ''' Validate inherit tag usage '''
         inherit_count = len(self._root.findall('inherit'))
@@ -391,7 +794,11 @@ class TypesGenerator(object):
 
     def _generate_marshal_header_body(self):
         with HeaderGuards(self._types_name + "_MARSHAL_TYPEDEF"):
-            self._print_headers(["app/marshal/marshal_if.h"])
+            headers = ["app/marshal/marshal_if.h"]
+            if self._specialised and "marshal_common.h" not in [t.get('header') for t in self._root.findall("inherit")]:
+                # The specialised functions table type
+                headers.append("marshal_common.h")
+            self._print_headers(headers)
             if self._standalone:
                 self._generate_marshal_type_table()
                 self._generate_marshal_type_enum()
@@ -399,16 +806,26 @@ class TypesGenerator(object):
             else:
                 self._generate_marshal_type_descriptor_declarations()
                 self._generate_marshal_type_table()
+            if self._specialised:
+                self._specialised.generate_declarations(self._types_name, self._standalone)
     
     def _generate_marshal_source_body(self):
-        self._print_headers(["app/marshal/marshal_if.h",
-                            self._types_name + "_typedef.h",
-                            self._types_name + "_marshal_typedef.h"])
+        headers = ["app/marshal/marshal_if.h",
+                   self._types_name + "_typedef.h",
+                   self._types_name + "_marshal_typedef.h"]
+        if self._specialised:
+            headers.extend(["panic.h", "limits.h", "stddef.h", "stdlib.h", "string.h"])
+        self._print_headers(headers)
         self._generate_source()
         self._generate_marshal_member_descriptor_definitions()
         self._generate_marshal_type_descriptor_definitions()
         if self._standalone:
             self._generate_marshal_type_descriptors_array()
+        if self._specialised:
+            self._specialised.generate_definitions()
+            if self._standalone:
+                self._specialised.generate_table(self._types_name,
+                    [t.get('x_macro_table') for t in self._root if t.tag == "inherit"])
 
     def generate_typedef_header(self):
         ''' Generate a header file defining the C types in the root '''
@@ -446,13 +863,14 @@ def main():
     parser.add_argument('--typedef_header', action='store_true', help='Generate a C type definition of the type(s)')
     parser.add_argument('--marshal_header', action='store_true', help='Generate a C marshal type declaration of the type(s)')
     parser.add_argument('--marshal_source', action='store_true', help='Generate a C marshal type definition of the type(s)')
+    parser.add_argument('--specialised', action='store_true', help='Also generate specialised marshal and unmarshal functions for the type(s)')
     args = parser.parse_args()
 
     tree = ET.parse(args.filename)
         
     element_tree_root = tree.getroot()
 
-    tg = TypesGenerator(element_tree_root)
+    tg = TypesGenerator(element_tree_root, args.specialised, [os.path.dirname(os.path.abspath(args.filename))])
 
     # Generate the typedef header
     if args.typedef_header:
@@ -0,0 +1,34 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       host_traps.c
+    \brief      Host versions of the panic traps the protobuf library uses.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <csrtypes.h>
+#include <panic.h>
+
+bool HostPanicIf(bool cond, const char *file, int line)
+{
+    if( cond )
+    {
+        fprintf(stderr, "Panic at %s:%d\n", file, line);
+        exit(2);
+    }
+    return TRUE;
+}
+
+void *HostPanicNull(void *p, const char *file, int line)
+{
+    HostPanicIf(p == NULL, file, line);
+    return p;
+}
+
+void *HostPanicUnlessMalloc(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+    PanicNull(p);
+    return p;
+}
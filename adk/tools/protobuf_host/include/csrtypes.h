@@ -0,0 +1,29 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       csrtypes.h
+    \brief      Host stand-in for the firmware's basic types.
+*/
+#ifndef PROTOBUF_HOST_CSRTYPES_H
+#define PROTOBUF_HOST_CSRTYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+
+#ifndef TRUE
+#define TRUE    true
+#endif
+#ifndef FALSE
+#define FALSE   false
+#endif
+
+#endif /* PROTOBUF_HOST_CSRTYPES_H */
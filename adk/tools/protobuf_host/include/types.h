@@ -0,0 +1,13 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       types.h
+    \brief      Host stand-in for the application types protobuf.h includes.
+*/
+#ifndef PROTOBUF_HOST_TYPES_H
+#define PROTOBUF_HOST_TYPES_H
+
+#include <csrtypes.h>
+
+#endif /* PROTOBUF_HOST_TYPES_H */
@@ -0,0 +1,344 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       protobuf_host.c
+    \brief      Runs the protobuf library on a host with representative AMA
+                control envelopes.
+
+    protobuf_host check
+        For each envelope checks that protobuf_c_message_pack_bounded()
+        writes the same bytes as protobuf_c_message_pack(), and that for
+        every region smaller than the envelope it returns 0 without writing
+        past the region. Checks that an envelope unpacked into an arena packs
+        back to the same bytes. Exits non-zero on any failure.
+
+    protobuf_host bench
+        For each envelope reports the mean time to pack it as
+        AmaSendEnvelope_Send() used to (sizing it, then packing it) and with
+        protobuf_c_message_pack_bounded(), and to unpack it with the default
+        allocator and into an arena.
+
+    Options:
+        --iterations <n>    Repetitions of each timed operation, default 200000
+*/
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <csrtypes.h>
+#include <protobuf.h>
+
+#include "accessories.pb-c.h"
+
+/*! Largest packed envelope, bigger than any of the samples */
+#define MAX_PACKED_SIZE     512
+
+/*! Written after the region given to protobuf_c_message_pack_bounded() to
+    catch it writing past the end */
+#define GUARD_BYTE          0xA5
+#define GUARD_SIZE          16
+
+typedef struct
+{
+    const char *name;
+    ControlEnvelope *envelope;
+} sample_t;
+
+/* StartSpeech, sent when the user presses the voice assistant button */
+static Dialog start_dialog = DIALOG__INIT;
+static SpeechSettings start_settings = SPEECH_SETTINGS__INIT;
+static SpeechInitiator start_initiator = SPEECH_INITIATOR__INIT;
+static StartSpeech start_speech = START_SPEECH__INIT;
+static ControlEnvelope start_speech_envelope = CONTROL_ENVELOPE__INIT;
+
+/* SynchronizeState, sent on every change of a device state */
+static State sync_state = STATE__INIT;
+static SynchronizeState synchronize_state = SYNCHRONIZE_STATE__INIT;
+static ControlEnvelope synchronize_state_envelope = CONTROL_ENVELOPE__INIT;
+
+/* NotifySpeechState, received on every step of a dialog */
+static NotifySpeechState notify_speech_state = NOTIFY_SPEECH_STATE__INIT;
+static ControlEnvelope notify_speech_state_envelope = CONTROL_ENVELOPE__INIT;
+
+/* KeepAlive, the smallest envelope */
+static KeepAlive keep_alive = KEEP_ALIVE__INIT;
+static ControlEnvelope keep_alive_envelope = CONTROL_ENVELOPE__INIT;
+
+/* The response to GetDeviceInformation, the largest envelope in a session */
+static Transport device_transports[] = { TRANSPORT__BLUETOOTH_LOW_ENERGY, TRANSPORT__BLUETOOTH_RFCOMM };
+static SpeechInitiationType device_initiations[] = { SPEECH_INITIATION_TYPE__TAP, SPEECH_INITIATION_TYPE__WAKEWORD };
+static char *device_wakewords[] = { "alexa" };
+static DeviceInformation__MetadataEntry device_metadata_entries[2] =
+{
+    DEVICE_INFORMATION__METADATA_ENTRY__INIT,
+    DEVICE_INFORMATION__METADATA_ENTRY__INIT
+};
+static DeviceInformation__MetadataEntry *device_metadata[] = { &device_metadata_entries[0], &device_metadata_entries[1] };
+static uint32_t associated_devices[] = { 2 };
+static DeviceInformation device_information = DEVICE_INFORMATION__INIT;
+static Response device_information_response = RESPONSE__INIT;
+static ControlEnvelope device_information_envelope = CONTROL_ENVELOPE__INIT;
+
+static sample_t samples[] =
+{
+    { "KeepAlive",          &keep_alive_envelope },
+    { "SynchronizeState",   &synchronize_state_envelope },
+    { "NotifySpeechState",  &notify_speech_state_envelope },
+    { "StartSpeech",        &start_speech_envelope },
+    { "DeviceInformation",  &device_information_envelope },
+};
+
+#define NUM_SAMPLES (sizeof(samples) / sizeof(samples[0]))
+
+static void initSamples(void)
+{
+    start_dialog.id = 0x12345;
+    start_settings.audio_profile = AUDIO_PROFILE__NEAR_FIELD;
+    start_settings.audio_format = AUDIO_FORMAT__OPUS_16KHZ_32KBPS_CBR_0_20MS;
+    start_settings.audio_source = AUDIO_SOURCE__STREAM;
+    start_initiator.type = SPEECH_INITIATOR__TYPE__TAP;
+    start_speech.settings = &start_settings;
+    start_speech.initiator = &start_initiator;
+    start_speech.dialog = &start_dialog;
+    start_speech_envelope.command = COMMAND__START_SPEECH;
+    start_speech_envelope.payload_case = CONTROL_ENVELOPE__PAYLOAD_START_SPEECH;
+    start_speech_envelope.u.start_speech = &start_speech;
+
+    sync_state.feature = 0x203;
+    sync_state.value_case = STATE__VALUE_BOOLEAN;
+    sync_state.u.boolean = TRUE;
+    synchronize_state.state = &sync_state;
+    synchronize_state_envelope.command = COMMAND__SYNCHRONIZE_STATE;
+    synchronize_state_envelope.payload_case = CONTROL_ENVELOPE__PAYLOAD_SYNCHRONIZE_STATE;
+    synchronize_state_envelope.u.synchronize_state = &synchronize_state;
+
+    notify_speech_state.state = SPEECH_STATE__LISTENING;
+    notify_speech_state_envelope.command = COMMAND__NOTIFY_SPEECH_STATE;
+    notify_speech_state_envelope.payload_case = CONTROL_ENVELOPE__PAYLOAD_NOTIFY_SPEECH_STATE;
+    notify_speech_state_envelope.u.notify_speech_state = &notify_speech_state;
+
+    keep_alive_envelope.command = COMMAND__KEEP_ALIVE;
+    keep_alive_envelope.payload_case = CONTROL_ENVELOPE__PAYLOAD_KEEP_ALIVE;
+    keep_alive_envelope.u.keep_alive = &keep_alive;
+
+    device_metadata_entries[0].key = "firmware";
+    device_metadata_entries[0].value = "1.0.42";
+    device_metadata_entries[1].key = "manufacturer";
+    device_metadata_entries[1].value = "Qualcomm Technologies International";
+    device_information.serial_number = "00025B00EF1A";
+    device_information.name = "ADK Earbuds";
+    device_information.n_supported_transports = sizeof(device_transports) / sizeof(device_transports[0]);
+    device_information.supported_transports = device_transports;
+    device_information.device_type = "A32E8VQVU960EJ";
+    device_information.device_id = 1;
+    device_information.n_associated_devices = sizeof(associated_devices) / sizeof(associated_devices[0]);
+    device_information.associated_devices = associated_devices;
+    device_information.n_supported_speech_initiations = sizeof(device_initiations) / sizeof(device_initiations[0]);
+    device_information.supported_speech_initiations = device_initiations;
+    device_information.n_supported_wakewords = sizeof(device_wakewords) / sizeof(device_wakewords[0]);
+    device_information.supported_wakewords = device_wakewords;
+    device_information.n_metadata = sizeof(device_metadata) / sizeof(device_metadata[0]);
+    device_information.metadata = device_metadata;
+    device_information_response.error_code = ERROR_CODE__SUCCESS;
+    device_information_response.payload_case = RESPONSE__PAYLOAD_DEVICE_INFORMATION;
+    device_information_response.u.device_information = &device_information;
+    device_information_envelope.command = COMMAND__GET_DEVICE_INFORMATION;
+    device_information_envelope.payload_case = CONTROL_ENVELOPE__PAYLOAD_RESPONSE;
+    device_information_envelope.u.response = &device_information_response;
+}
+
+static uint64_t nowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static bool checkGuard(const uint8 *guard)
+{
+    unsigned i;
+
+    for (i = 0; i < GUARD_SIZE; i++)
+    {
+        if (guard[i] != GUARD_BYTE)
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static bool checkSample(const sample_t *sample)
+{
+    uint8 expected[MAX_PACKED_SIZE];
+    uint8 region[MAX_PACKED_SIZE + GUARD_SIZE];
+    size_t size = control_envelope__get_packed_size(sample->envelope);
+    size_t max_len;
+    bool ok = TRUE;
+
+    if (size > MAX_PACKED_SIZE || control_envelope__pack(sample->envelope, expected) != size)
+    {
+        printf("%-18s pack failed, size %zu\n", sample->name, size);
+        return FALSE;
+    }
+
+    /* Every region up to one byte bigger than the envelope */
+    for (max_len = 0; max_len <= size + 1 && max_len <= MAX_PACKED_SIZE; max_len++)
+    {
+        size_t written;
+
+        memset(region, GUARD_BYTE, sizeof(region));
+        written = protobuf_c_message_pack_bounded(&sample->envelope->base, region, max_len);
+
+        if (!checkGuard(&region[max_len]))
+        {
+            printf("%-18s wrote past a region of %zu bytes\n", sample->name, max_len);
+            ok = FALSE;
+        }
+        else if (max_len < size && written != 0)
+        {
+            printf("%-18s returned %zu for a region of %zu bytes\n", sample->name, written, max_len);
+            ok = FALSE;
+        }
+        else if (max_len >= size && (written != size || memcmp(region, expected, size) != 0))
+        {
+            printf("%-18s packed %zu bytes differently to protobuf_c_message_pack()\n", sample->name, written);
+            ok = FALSE;
+        }
+    }
+
+    {
+        ProtobufCArena arena;
+        ControlEnvelope *unpacked;
+        uint8 repacked[MAX_PACKED_SIZE];
+
+        protobuf_c_arena_init(&arena, NULL, 0);
+        unpacked = control_envelope__unpack(&arena.allocator, size, expected);
+        if (unpacked == NULL ||
+            control_envelope__get_packed_size(unpacked) != size ||
+            control_envelope__pack(unpacked, repacked) != size ||
+            memcmp(repacked, expected, size) != 0)
+        {
+            printf("%-18s did not survive unpacking into an arena\n", sample->name);
+            ok = FALSE;
+        }
+        protobuf_c_arena_reset(&arena);
+    }
+
+    printf("%-18s %3zu bytes %s\n", sample->name, size, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static void benchSample(const sample_t *sample, unsigned iterations)
+{
+    uint8 packed[MAX_PACKED_SIZE];
+    size_t size = control_envelope__pack(sample->envelope, packed);
+    volatile size_t sink = 0;
+    uint64_t start;
+    uint64_t size_and_pack_ns, bounded_ns, unpack_ns, arena_ns;
+    unsigned i;
+
+    start = nowNs();
+    for (i = 0; i < iterations; i++)
+    {
+        size_t packed_size = control_envelope__get_packed_size(sample->envelope);
+        sink += control_envelope__pack(sample->envelope, packed) + packed_size;
+    }
+    size_and_pack_ns = nowNs() - start;
+
+    start = nowNs();
+    for (i = 0; i < iterations; i++)
+    {
+        sink += protobuf_c_message_pack_bounded(&sample->envelope->base, packed, sizeof(packed));
+    }
+    bounded_ns = nowNs() - start;
+
+    start = nowNs();
+    for (i = 0; i < iterations; i++)
+    {
+        ControlEnvelope *unpacked = control_envelope__unpack(NULL, size, packed);
+        sink += unpacked->command;
+        control_envelope__free_unpacked(unpacked, NULL);
+    }
+    unpack_ns = nowNs() - start;
+
+    start = nowNs();
+    for (i = 0; i < iterations; i++)
+    {
+        ProtobufCArena arena;
+        ControlEnvelope *unpacked;
+
+        protobuf_c_arena_init(&arena, NULL, 0);
+        unpacked = control_envelope__unpack(&arena.allocator, size, packed);
+        sink += unpacked->command;
+        protobuf_c_arena_reset(&arena);
+    }
+    arena_ns = nowNs() - start;
+
+    (void)sink;
+    printf("%-18s %3zu bytes  size+pack %7.1f  bounded %7.1f  unpack %7.1f  arena %7.1f  ns\n",
+           sample->name, size,
+           (double)size_and_pack_ns / iterations, (double)bounded_ns / iterations,
+           (double)unpack_ns / iterations, (double)arena_ns / iterations);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: protobuf_host [--iterations <n>] check|bench\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "iterations", required_argument, NULL, 'i' },
+        { NULL, 0, NULL, 0 }
+    };
+    unsigned iterations = 200000;
+    unsigned i;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'i':
+                iterations = (unsigned)strtoul(optarg, NULL, 0);
+                break;
+            default:
+                usage();
+        }
+    }
+    if (optind != argc - 1 || iterations == 0)
+    {
+        usage();
+    }
+
+    initSamples();
+
+    if (strcmp(argv[optind], "check") == 0)
+    {
+        bool ok = TRUE;
+
+        for (i = 0; i < NUM_SAMPLES; i++)
+        {
+            ok = checkSample(&samples[i]) && ok;
+        }
+        return ok ? 0 : 1;
+    }
+    if (strcmp(argv[optind], "bench") == 0)
+    {
+        for (i = 0; i < NUM_SAMPLES; i++)
+        {
+            benchSample(&samples[i], iterations);
+        }
+        return 0;
+    }
+    usage();
+    return 1;
+}
@@ -27,6 +27,7 @@ from .audio_router import AudioRouter
 from .gatt_connect import GattConnect
 from .call_control_client import CallControlClient
 from .media_control_client import MediaControlClient
+from .metrics import Metrics
 
 @Reportable.has_subcomponents
 class CAAApp(FirmwareComponent):
@@ -134,4 +135,8 @@ class CAAApp(FirmwareComponent):
     @autolazy
     def generic_broadcast_scan_manager(self):
         return self.create_component_variant((GenericBroadcastScanManager, ), self.env, self._core, self)
-        
+
+    @Reportable.subcomponent
+    @autolazy
+    def metrics(self):
+        return self.create_component_variant((Metrics, ), self.env, self._core, self)
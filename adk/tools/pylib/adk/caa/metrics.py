@@ -0,0 +1,109 @@
+############################################################################
+# CONFIDENTIAL
+#
+# Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+#   %%version
+#
+############################################################################
+
+from csr.dev.fw.firmware_component import FirmwareComponent
+from csr.dev.model import interface
+
+class Metrics(FirmwareComponent):
+    """
+    Snapshot of the on-device metrics registry (metrics.h).
+    The report lists every metric built in, so that the same metrics can be
+    compared across devices:
+        >>> apps1.app.metrics().report()
+    or collected as a dictionary with:
+        >>> apps1.app.metrics().snapshot
+    """
+
+    def __init__(self, env, core, parent=None):
+
+        FirmwareComponent.__init__(self, env, core, parent=parent)
+
+        try:
+            self._registry = env.cu.metrics.local.metrics_registry
+        except AttributeError:
+            # The registry is excluded from the build by DISABLE_METRICS
+            raise self.NotDetected
+
+    def _id_name(self, metric_id):
+        try:
+            return self.env.enums["metric_id_t"][metric_id][len("METRIC_ID_"):]
+        except KeyError:
+            return str(metric_id)
+
+    @property
+    def registrations(self):
+        begin = self._registry.begin
+        count = (self._registry.end.value - begin.value) // begin.deref.size
+        if count == 0:
+            return []
+        return self.env.cast(begin, begin.deref.typename, array_len=count)
+
+    @property
+    def snapshot(self):
+        """
+        Dictionary of metric name to (type, bounds, values). Bounds is empty
+        for counters, counter arrays and gauges, values holds one entry, one
+        per bucket or one per index.
+        """
+        types = self.env.enums["metric_type_t"]
+        metrics = {}
+        for reg in self.registrations:
+            number_of_bounds = reg.number_of_bounds.value
+            bounds = []
+            if reg.bounds.value != 0:
+                bounds = [b.value for b in self.env.cast(reg.bounds, reg.bounds.deref.typename,
+                                                         array_len=number_of_bounds)]
+            values = [v.value for v in self.env.cast(reg.values, reg.values.deref.typename,
+                                                     array_len=reg.number_of_values.value)]
+            metric_type = types[reg.type.value][len("metric_type_"):]
+            metrics[self._id_name(reg.id.value)] = (metric_type, bounds, values)
+        return metrics
+
+    @staticmethod
+    def _bucket_names(bounds):
+        names = []
+        lower = 0
+        for bound in bounds:
+            names.append("{}-{}".format(lower, bound))
+            lower = bound + 1
+        names.append(">{}".format(bounds[-1]) if bounds else "")
+        return names
+
+    def _generate_report_body_elements(self):
+
+        content = []
+
+        scalars = interface.Table(["Metric", "Type", "Value"])
+        histograms = []
+        arrays = []
+
+        for name, (metric_type, bounds, values) in sorted(self.snapshot.items()):
+            if bounds:
+                grp = interface.Group(name)
+                tbl = interface.Table(["Bucket", "Count"])
+                for bucket, count in zip(self._bucket_names(bounds), values):
+                    tbl.add_row([bucket, count])
+                grp.append(tbl)
+                histograms.append(grp)
+            elif metric_type == "counter_array":
+                grp = interface.Group(name)
+                tbl = interface.Table(["Index", "Count"])
+                for index, count in enumerate(values):
+                    tbl.add_row([index, count])
+                grp.append(tbl)
+                arrays.append(grp)
+            else:
+                scalars.add_row([name, metric_type, values[0]])
+
+        grp = interface.Group("Counters and gauges")
+        grp.append(scalars)
+        content.append(grp)
+        content.extend(histograms)
+        content.extend(arrays)
+
+        return content
@@ -0,0 +1,301 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       flash_sim.c
+    \brief      A NOR flash simulator behind the RA partition traps.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <csrtypes.h>
+#include <vmtypes.h>
+#include <logging.h>
+#include <panic.h>
+#include <ra_partition_api.h>
+
+#include "flash_sim.h"
+
+#define FLASH_SIM_HANDLE    ((raPartition_handle)1)
+
+typedef struct {
+    flash_sim_config_t      config;
+    uint8                  *content;
+    bool                    is_open;
+    uint64_t                now_us;         /*!< The simulated clock */
+    uint64_t                busy_until_us;  /*!< When a background erase completes */
+    uint32                  cut_countdown;  /*!< Programs and erases left until the power cut, 0 if none */
+    uint32                  cut_seed;
+    jmp_buf                *cut_env;
+    flash_sim_statistics_t  statistics;
+} flash_sim_t;
+
+static flash_sim_t flash_sim;
+
+void FlashSim_GetDefaultConfig(flash_sim_config_t *config)
+{
+    /* Typical of the W25Q64FW the RAFS sources refer to, reached over the
+       P0 trap interface rather than directly. */
+    config->page_size        = 256;
+    config->block_size       = 4096;
+    config->partition_size   = 1024 * 1024;
+    config->read_call_us     = 30;
+    config->read_ns_per_byte = 50;
+    config->program_call_us  = 30;
+    config->program_page_us  = 400;
+    config->erase_block_us   = 45000;
+}
+
+bool FlashSim_Create(const flash_sim_config_t *config)
+{
+    if( config->page_size == 0 || config->block_size % config->page_size != 0 ||
+        config->partition_size % config->block_size != 0 ||
+        config->partition_size / config->block_size < 3 )
+    {
+        return FALSE;
+    }
+
+    FlashSim_Destroy();
+    memset(&flash_sim, 0, sizeof(flash_sim));
+    flash_sim.config = *config;
+    flash_sim.content = PanicUnlessMalloc(config->partition_size);
+    memset(flash_sim.content, 0xFF, config->partition_size);
+    return TRUE;
+}
+
+bool FlashSim_LoadImage(const char *path)
+{
+    bool ok = FALSE;
+    FILE *fp = fopen(path, "rb");
+    if( fp )
+    {
+        ok = fread(flash_sim.content, 1, flash_sim.config.partition_size, fp) == flash_sim.config.partition_size &&
+             fgetc(fp) == EOF;
+        fclose(fp);
+    }
+    return ok;
+}
+
+bool FlashSim_SaveImage(const char *path)
+{
+    bool ok = FALSE;
+    FILE *fp = fopen(path, "wb");
+    if( fp )
+    {
+        ok = fwrite(flash_sim.content, 1, flash_sim.config.partition_size, fp) == flash_sim.config.partition_size;
+        ok = fclose(fp) == 0 && ok;
+    }
+    return ok;
+}
+
+void FlashSim_Destroy(void)
+{
+    free(flash_sim.content);
+    flash_sim.content = NULL;
+}
+
+uint64_t FlashSim_GetTime(void)
+{
+    return flash_sim.now_us;
+}
+
+void FlashSim_ArmPowerCut(uint32 operations, uint32 seed, jmp_buf *env)
+{
+    flash_sim.cut_countdown = operations;
+    flash_sim.cut_seed = seed;
+    flash_sim.cut_env = env;
+}
+
+void FlashSim_PowerOn(void)
+{
+    flash_sim.is_open = FALSE;
+    flash_sim.cut_countdown = 0;
+    /* An erase in progress when the power went has stopped */
+    flash_sim.busy_until_us = flash_sim.now_us;
+}
+
+const flash_sim_statistics_t *FlashSim_GetStatistics(void)
+{
+    return &flash_sim.statistics;
+}
+
+const uint8 *FlashSim_GetContent(void)
+{
+    return flash_sim.content;
+}
+
+/*! \brief Wait for a background erase to finish, then spend \p us on this operation */
+static void flashSim_Spend(uint64_t us)
+{
+    if( flash_sim.busy_until_us > flash_sim.now_us )
+    {
+        flash_sim.now_us = flash_sim.busy_until_us;
+    }
+    flash_sim.now_us += us;
+}
+
+/*! \brief Count down to an armed power cut
+    \param length  The number of bytes the operation affects.
+    \param cut     Set to TRUE if the power is cut during this operation.
+    \return The number of bytes to complete, \p length if the power stays on. */
+static uint32 flashSim_BytesBeforeCut(uint32 length, bool *cut)
+{
+    *cut = flash_sim.cut_countdown != 0 && --flash_sim.cut_countdown == 0;
+    if( !*cut )
+    {
+        return length;
+    }
+    srand(flash_sim.cut_seed);
+    return length ? (uint32)rand() % length : 0;
+}
+
+static void flashSim_CutPower(void)
+{
+    DEBUG_LOG_INFO("flash_sim: power cut at %llu us", (unsigned long long)flash_sim.now_us);
+    flash_sim.statistics.power_cuts++;
+    flash_sim.is_open = FALSE;
+    longjmp(*flash_sim.cut_env, 1);
+}
+
+static bool flashSim_IsValid(const raPartition_handle *handle, uint32 offset, uint32 length)
+{
+    return flash_sim.is_open && handle != NULL && *handle == FLASH_SIM_HANDLE &&
+           offset <= flash_sim.config.partition_size &&
+           length <= flash_sim.config.partition_size - offset;
+}
+
+static void flashSim_Erase(uint32 offset, bool background)
+{
+    uint32 block = offset - offset % flash_sim.config.block_size;
+    bool cut;
+    uint32 done = flashSim_BytesBeforeCut(flash_sim.config.block_size, &cut);
+
+    DEBUG_LOG_VERBOSE("flash_sim: %s erase of block %u", background ? "background" : "", block / flash_sim.config.block_size);
+    flash_sim.statistics.erases++;
+    if( background )
+    {
+        flash_sim.statistics.bg_erases++;
+        flashSim_Spend(0);
+        flash_sim.busy_until_us = flash_sim.now_us + flash_sim.config.erase_block_us;
+    }
+    else
+    {
+        flashSim_Spend(flash_sim.config.erase_block_us);
+    }
+
+    /* An interrupted erase leaves the block neither erased nor intact */
+    memset(&flash_sim.content[block], 0xFF, done);
+    if( cut )
+    {
+        flashSim_CutPower();
+    }
+}
+
+static raPartition_result flashSim_Open(raPartition_handle *handle, raPartition_info *partition_info)
+{
+    if( handle == NULL || partition_info == NULL || flash_sim.content == NULL )
+    {
+        return RA_PARTITION_RESULT_INVALID_PARAM;
+    }
+    if( flash_sim.is_open )
+    {
+        return RA_PARTITION_RESULT_IN_USE;
+    }
+    flash_sim.is_open = TRUE;
+    *handle = FLASH_SIM_HANDLE;
+    partition_info->page_size = flash_sim.config.page_size;
+    partition_info->block_size = flash_sim.config.block_size;
+    partition_info->partition_size = flash_sim.config.partition_size;
+    return RA_PARTITION_RESULT_SUCCESS;
+}
+
+/* The RA partition traps */
+/* ----------------------- */
+raPartition_result RaPartitionOpen(raPartition_handle *handle, raPartition_info *partition_info)
+{
+    return flashSim_Open(handle, partition_info);
+}
+
+raPartition_result RaPartitionNamedOpen(const char *name, raPartition_handle *handle, raPartition_info *partition_info)
+{
+    /* There is only one partition, whatever it is called */
+    UNUSED(name);
+    return flashSim_Open(handle, partition_info);
+}
+
+raPartition_result RaPartitionClose(raPartition_handle *handle)
+{
+    if( !flashSim_IsValid(handle, 0, 0) )
+    {
+        return RA_PARTITION_RESULT_INVALID_PARAM;
+    }
+    flashSim_Spend(0);
+    flash_sim.is_open = FALSE;
+    *handle = RAPARTITION_HANDLE_INVALID;
+    return RA_PARTITION_RESULT_SUCCESS;
+}
+
+raPartition_result RaPartitionErase(raPartition_handle *handle, uint32 offset)
+{
+    if( !flashSim_IsValid(handle, offset, 1) )
+    {
+        return RA_PARTITION_RESULT_INVALID_PARAM;
+    }
+    flashSim_Erase(offset, FALSE);
+    return RA_PARTITION_RESULT_SUCCESS;
+}
+
+void RaPartitionBgErase(raPartition_handle *handle, uint32 offset)
+{
+    if( flashSim_IsValid(handle, offset, 1) )
+    {
+        flashSim_Erase(offset, TRUE);
+    }
+}
+
+raPartition_result RaPartitionWrite(raPartition_handle *handle, uint32 offset, uint32 length, const uint8 *buffer)
+{
+    if( !flashSim_IsValid(handle, offset, length) || buffer == NULL )
+    {
+        return RA_PARTITION_RESULT_INVALID_PARAM;
+    }
+
+    uint32 page_size = flash_sim.config.page_size;
+    uint32 pages = length ? (offset + length - 1) / page_size - offset / page_size + 1 : 0;
+    bool cut;
+    uint32 done = flashSim_BytesBeforeCut(length, &cut);
+
+    flash_sim.statistics.programs++;
+    flash_sim.statistics.program_bytes += length;
+    flashSim_Spend(flash_sim.config.program_call_us + (uint64_t)pages * flash_sim.config.program_page_us);
+
+    for( uint32 i = 0 ; i < done ; i++ )
+    {
+        uint8 *cell = &flash_sim.content[offset + i];
+        if( buffer[i] & ~*cell )
+        {
+            /* Programming can't set bits, the data written is lost */
+            flash_sim.statistics.program_conflicts++;
+            DEBUG_LOG_WARN("flash_sim: program of 0x%02x over 0x%02x at 0x%x", buffer[i], *cell, offset + i);
+        }
+        *cell &= buffer[i];
+    }
+    if( cut )
+    {
+        flashSim_CutPower();
+    }
+    return RA_PARTITION_RESULT_SUCCESS;
+}
+
+raPartition_result RaPartitionRead(raPartition_handle *handle, uint32 offset, uint32 length, uint8 *buffer)
+{
+    if( !flashSim_IsValid(handle, offset, length) || buffer == NULL )
+    {
+        return RA_PARTITION_RESULT_INVALID_PARAM;
+    }
+    flash_sim.statistics.reads++;
+    flash_sim.statistics.read_bytes += length;
+    flashSim_Spend(flash_sim.config.read_call_us + ((uint64_t)length * flash_sim.config.read_ns_per_byte) / 1000);
+    memcpy(buffer, &flash_sim.content[offset], length);
+    return RA_PARTITION_RESULT_SUCCESS;
+}
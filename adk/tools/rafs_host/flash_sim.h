@@ -0,0 +1,83 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       flash_sim.h
+    \brief      A NOR flash simulator behind the RA partition traps.
+
+    The partition is held in RAM and can be loaded from and saved to a raw
+    image file, which is what is programmed into the device's RA partition.
+
+    Like NOR flash, programming can only clear bits and erasing sets a whole
+    block to 0xFF. Each operation advances a simulated clock by the time the
+    real part would take, RaPartitionBgErase() returns at once but keeps the
+    flash busy for the erase time, delaying the next operation.
+
+    A power cut can be armed to happen part way through a later program or
+    erase. The operation is left half done and control returns to the
+    setjmp() given to FlashSim_ArmPowerCut().
+*/
+#ifndef FLASH_SIM_H
+#define FLASH_SIM_H
+
+#include <csrtypes.h>
+#include <setjmp.h>
+
+/*! \brief Geometry and timing of the simulated part, times in microseconds */
+typedef struct {
+    uint32      page_size;          /*!< Programming page size, in bytes */
+    uint32      block_size;         /*!< Erase block size, in bytes */
+    uint32      partition_size;     /*!< Partition size, in bytes */
+    uint32      read_call_us;       /*!< Fixed cost of a RaPartitionRead() */
+    uint32      read_ns_per_byte;   /*!< Transfer time of each byte read, in nanoseconds */
+    uint32      program_call_us;    /*!< Fixed cost of a RaPartitionWrite() */
+    uint32      program_page_us;    /*!< Time to program each page written to */
+    uint32      erase_block_us;     /*!< Time to erase a block */
+} flash_sim_config_t;
+
+/*! \brief Counts of the operations made on the partition */
+typedef struct {
+    uint32      reads;
+    uint32      read_bytes;
+    uint32      programs;
+    uint32      program_bytes;
+    uint32      erases;             /*!< Including background erases */
+    uint32      bg_erases;
+    uint32      program_conflicts;  /*!< Bytes that needed a bit set by a program */
+    uint32      power_cuts;
+} flash_sim_statistics_t;
+
+/*! \brief Default geometry and timing, typical of a 4KB sector SPI NOR part */
+void FlashSim_GetDefaultConfig(flash_sim_config_t *config);
+
+/*! \brief Create an erased partition
+    \return FALSE if the geometry is not usable */
+bool FlashSim_Create(const flash_sim_config_t *config);
+
+/*! \brief Load the partition content from a raw image
+    \return FALSE if the file can't be read or is the wrong size */
+bool FlashSim_LoadImage(const char *path);
+
+/*! \brief Save the partition content to a raw image */
+bool FlashSim_SaveImage(const char *path);
+
+void FlashSim_Destroy(void);
+
+/*! \brief The simulated time since the partition was created, in microseconds */
+uint64_t FlashSim_GetTime(void);
+
+/*! \brief Arm a power cut during the n'th program or erase from now
+    \param operations   The operation to interrupt, 1 for the next one, 0 to disarm.
+    \param seed         Decides how much of the interrupted operation completes.
+    \param env          Where to longjmp() to once the power has been cut. */
+void FlashSim_ArmPowerCut(uint32 operations, uint32 seed, jmp_buf *env);
+
+/*! \brief Restore power after a cut, closing any open handle */
+void FlashSim_PowerOn(void);
+
+const flash_sim_statistics_t *FlashSim_GetStatistics(void);
+
+/*! \brief Direct access to the partition content, for checks */
+const uint8 *FlashSim_GetContent(void);
+
+#endif /* FLASH_SIM_H */
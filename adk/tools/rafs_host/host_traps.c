@@ -0,0 +1,142 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       host_traps.c
+    \brief      Host versions of the message and panic traps RAFS uses.
+*/
+#include <execinfo.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <csrtypes.h>
+#include <logging.h>
+#include <panic.h>
+#include <message.h>
+
+#include "flash_sim.h"
+#include "host_traps.h"
+
+typedef struct host_message {
+    struct host_message *next;
+    Task                task;
+    MessageId           id;
+    void               *message;
+    uint64_t            due_us;
+} host_message_t;
+
+int rafs_host_log_level = 0;
+
+static host_message_t *message_queue;
+static void (*panic_hook)(void);
+
+bool HostPanicIf(bool cond, const char *file, int line)
+{
+    if( cond )
+    {
+        void *frames[32];
+        fprintf(stderr, "Panic at %s:%d\n", file, line);
+        backtrace_symbols_fd(frames, backtrace(frames, 32), fileno(stderr));
+        if( panic_hook )
+        {
+            panic_hook();
+        }
+        exit(2);
+    }
+    return TRUE;
+}
+
+void *HostPanicNull(void *p, const char *file, int line)
+{
+    HostPanicIf(p == NULL, file, line);
+    return p;
+}
+
+void *HostPanicUnlessMalloc(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+    PanicNull(p);
+    return p;
+}
+
+void HostTraps_SetPanicHook(void (*hook)(void))
+{
+    panic_hook = hook;
+}
+
+void MessageSendLater(Task task, MessageId id, void *message, uint32 delay)
+{
+    host_message_t *m = PanicUnlessNew(host_message_t);
+    host_message_t **tail = &message_queue;
+
+    m->next = NULL;
+    m->task = task;
+    m->id = id;
+    m->message = message;
+    m->due_us = FlashSim_GetTime() + (uint64_t)delay * 1000;
+
+    /* Keep the queue in due order, first in first out for equal times */
+    while( *tail && (*tail)->due_us <= m->due_us )
+    {
+        tail = &(*tail)->next;
+    }
+    m->next = *tail;
+    *tail = m;
+}
+
+void MessageSend(Task task, MessageId id, void *message)
+{
+    MessageSendLater(task, id, message, 0);
+}
+
+uint16 MessageCancelAll(Task task, MessageId id)
+{
+    uint16 cancelled = 0;
+    host_message_t **pm = &message_queue;
+
+    while( *pm )
+    {
+        host_message_t *m = *pm;
+        if( m->task == task && m->id == id )
+        {
+            *pm = m->next;
+            free(m->message);
+            free(m);
+            cancelled++;
+        }
+        else
+        {
+            pm = &m->next;
+        }
+    }
+    return cancelled;
+}
+
+uint32 HostTraps_RunUntilIdle(void)
+{
+    uint32 delivered = 0;
+
+    while( message_queue && message_queue->due_us <= FlashSim_GetTime() )
+    {
+        host_message_t *m = message_queue;
+        message_queue = m->next;
+        if( m->task && m->task->handler )
+        {
+            m->task->handler(m->task, m->id, m->message);
+        }
+        free(m->message);
+        free(m);
+        delivered++;
+    }
+    return delivered;
+}
+
+void HostTraps_DiscardMessages(void)
+{
+    while( message_queue )
+    {
+        host_message_t *m = message_queue;
+        message_queue = m->next;
+        free(m->message);
+        free(m);
+    }
+}
@@ -0,0 +1,29 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       host_traps.h
+    \brief      Host versions of the message and panic traps RAFS uses.
+
+    Messages are queued in the order they are sent and only delivered by
+    HostTraps_RunUntilIdle(), which stands in for the VM scheduler. Time is
+    the flash simulator's clock, so a MessageSendLater() is only delivered
+    once enough flash activity has happened.
+*/
+#ifndef HOST_TRAPS_H
+#define HOST_TRAPS_H
+
+#include <csrtypes.h>
+#include <message.h>
+
+/*! \brief Deliver every message that is due
+    \return The number of messages delivered */
+uint32 HostTraps_RunUntilIdle(void);
+
+/*! \brief Drop all queued messages, as a reset does */
+void HostTraps_DiscardMessages(void);
+
+/*! \brief Set a function to call before exiting on a panic, to report context */
+void HostTraps_SetPanicHook(void (*hook)(void));
+
+#endif /* HOST_TRAPS_H */
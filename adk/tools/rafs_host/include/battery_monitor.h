@@ -0,0 +1,13 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       battery_monitor.h
+    \brief      Host stand-in, RAFS needs nothing from the battery monitor.
+*/
+#ifndef RAFS_HOST_BATTERY_MONITOR_H
+#define RAFS_HOST_BATTERY_MONITOR_H
+
+#include <battery_region.h>
+
+#endif /* RAFS_HOST_BATTERY_MONITOR_H */
@@ -0,0 +1,36 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       battery_region.h
+    \brief      Host stand-in for the battery region monitor, the battery is always OK.
+*/
+#ifndef RAFS_HOST_BATTERY_REGION_H
+#define RAFS_HOST_BATTERY_REGION_H
+
+#include <domain_message.h>
+#include <message.h>
+
+enum battery_region_messages
+{
+    MESSAGE_BATTERY_REGION_INIT_CFM = BATTERY_REGION_MESSAGE_BASE,
+    MESSAGE_BATTERY_REGION_UPDATE,
+};
+
+typedef enum
+{
+    battery_region_unknown,
+    battery_region_unsafe,
+    battery_region_critical,
+    battery_region_ok,
+} battery_region_state_t;
+
+typedef struct
+{
+    battery_region_state_t state;
+} MESSAGE_BATTERY_REGION_UPDATE_STATE_T;
+
+#define BatteryRegion_Register(task)    (task == task)
+#define BatteryRegion_Unregister(task)
+
+#endif /* RAFS_HOST_BATTERY_REGION_H */
@@ -0,0 +1,26 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       charger_monitor.h
+    \brief      Host stand-in for the charger monitor, there is no charger.
+*/
+#ifndef RAFS_HOST_CHARGER_MONITOR_H
+#define RAFS_HOST_CHARGER_MONITOR_H
+
+#include <domain_message.h>
+#include <message.h>
+
+enum chargerMessages
+{
+    CHARGER_MESSAGE_ATTACHED = CHARGER_MESSAGE_BASE,
+    CHARGER_MESSAGE_DETACHED,
+    CHARGER_MESSAGE_COMPLETED,
+    CHARGER_MESSAGE_CHARGING_OK,
+    CHARGER_MESSAGE_CHARGING_LOW,
+};
+
+#define Charger_ClientRegister(task)    (UNUSED(task),TRUE)
+#define Charger_ClientUnregister(task)  (UNUSED(task))
+
+#endif /* RAFS_HOST_CHARGER_MONITOR_H */
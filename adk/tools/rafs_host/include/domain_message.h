@@ -0,0 +1,19 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       domain_message.h
+    \brief      Host stand-in for the message group definitions RAFS uses.
+*/
+#ifndef RAFS_HOST_DOMAIN_MESSAGE_H
+#define RAFS_HOST_DOMAIN_MESSAGE_H
+
+#include <message.h>
+
+#define INTERNAL_MESSAGE_BASE               0x0000
+#define CHARGER_MESSAGE_BASE                0x1000
+#define BATTERY_REGION_MESSAGE_BASE         0x1100
+
+#define ASSERT_INTERNAL_MESSAGES_NOT_OVERFLOWED(last_used_message)
+
+#endif /* RAFS_HOST_DOMAIN_MESSAGE_H */
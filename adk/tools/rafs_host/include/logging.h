@@ -0,0 +1,32 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       logging.h
+    \brief      Host stand-in for the ADK logging, writes to stderr.
+
+                The level is set by rafs_host_log_level, 0 logs errors only.
+*/
+#ifndef RAFS_HOST_LOGGING_H
+#define RAFS_HOST_LOGGING_H
+
+#include <stdio.h>
+
+extern int rafs_host_log_level;
+
+#define HOST_LOG(level, ...) \
+    do { if (rafs_host_log_level >= (level)) { fprintf(stderr, __VA_ARGS__); fputc('\n', stderr); } } while(0)
+
+#define DEBUG_LOG_ERROR(...)        HOST_LOG(0, __VA_ARGS__)
+#define DEBUG_LOG_WARN(...)         HOST_LOG(1, __VA_ARGS__)
+#define DEBUG_LOG_INFO(...)         HOST_LOG(2, __VA_ARGS__)
+#define DEBUG_LOG_DEBUG(...)        HOST_LOG(3, __VA_ARGS__)
+#define DEBUG_LOG_VERBOSE(...)      HOST_LOG(4, __VA_ARGS__)
+#define DEBUG_LOG_V_VERBOSE(...)    HOST_LOG(5, __VA_ARGS__)
+#define DEBUG_LOG(...)              DEBUG_LOG_INFO(__VA_ARGS__)
+#define DEBUG_LOG_ALWAYS            DEBUG_LOG_ERROR
+#define DEBUG_LOG_FN_ENTRY          DEBUG_LOG_DEBUG
+
+#define LOGGING_PRESERVE_MESSAGE_TYPE(_type)
+
+#endif /* RAFS_HOST_LOGGING_H */
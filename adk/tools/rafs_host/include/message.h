@@ -0,0 +1,37 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       message.h
+    \brief      Host stand-in for the message traps, see host_message.c.
+*/
+#ifndef RAFS_HOST_MESSAGE_H
+#define RAFS_HOST_MESSAGE_H
+
+#include <csrtypes.h>
+#include <panic.h>
+
+typedef uint16      MessageId;
+typedef const void *Message;
+typedef uint32      Delay;
+
+typedef struct TaskData TaskData;
+typedef TaskData   *Task;
+typedef void (*TaskHandler)(Task task, MessageId id, Message message);
+
+struct TaskData
+{
+    TaskHandler handler;
+};
+
+#define D_SEC(s)    ((Delay) ((s) * (Delay) 1000))
+#define D_MIN(m)    ((Delay) ((m) * (Delay) 1000 * (Delay) 60))
+
+#define MESSAGE_MAKE(NAME,TYPE) \
+TYPE * const NAME = PanicUnlessNew(TYPE)
+
+void MessageSend(Task task, MessageId id, void *message);
+void MessageSendLater(Task task, MessageId id, void *message, uint32 delay);
+uint16 MessageCancelAll(Task task, MessageId id);
+
+#endif /* RAFS_HOST_MESSAGE_H */
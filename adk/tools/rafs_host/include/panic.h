@@ -0,0 +1,32 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       panic.h
+    \brief      Host stand-in for the panic traps, see host_message.c.
+*/
+#ifndef RAFS_HOST_PANIC_H
+#define RAFS_HOST_PANIC_H
+
+#include <csrtypes.h>
+
+#define PanicFalse(x)       PanicZero(x)
+#define PanicZero(x)        ((unsigned int) HostPanicIf(!(x), __FILE__, __LINE__))
+#define PanicNull(x)        HostPanicNull((x), __FILE__, __LINE__)
+#define PanicNotZero(x)     HostPanicIf((x) != 0, __FILE__, __LINE__)
+#define PanicNotNull(x)     HostPanicIf((x) != NULL, __FILE__, __LINE__)
+#define Panic()             HostPanicIf(TRUE, __FILE__, __LINE__)
+#define PanicUnlessMalloc(sz) HostPanicUnlessMalloc(sz)
+#define PanicUnlessNew(T)   (T*)PanicUnlessMalloc(sizeof(T))
+
+/*! \brief Report the caller's file and line and exit if \p cond is TRUE.
+    \return TRUE, so PanicZero() has a value. */
+bool HostPanicIf(bool cond, const char *file, int line);
+
+/*! \brief Report the caller's file and line and exit if \p p is NULL.
+    \return \p p */
+void *HostPanicNull(void *p, const char *file, int line);
+
+void *HostPanicUnlessMalloc(size_t size);
+
+#endif /* RAFS_HOST_PANIC_H */
@@ -0,0 +1,13 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       pmalloc.h
+    \brief      Host stand-in, RAFS allocates with the C library on the host.
+*/
+#ifndef RAFS_HOST_PMALLOC_H
+#define RAFS_HOST_PMALLOC_H
+
+#include <stdlib.h>
+
+#endif /* RAFS_HOST_PMALLOC_H */
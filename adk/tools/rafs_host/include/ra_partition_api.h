@@ -0,0 +1,22 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       ra_partition_api.h
+    \brief      Host stand-in for the RA partition traps, see flash_sim.c.
+*/
+#ifndef RAFS_HOST_RA_PARTITION_API_H
+#define RAFS_HOST_RA_PARTITION_API_H
+
+#include <csrtypes.h>
+#include <app/ra_partition/ra_partition_if.h>
+
+raPartition_result RaPartitionOpen(raPartition_handle * handle, raPartition_info * partition_info);
+raPartition_result RaPartitionClose(raPartition_handle * handle);
+raPartition_result RaPartitionErase(raPartition_handle * handle, uint32 offset);
+raPartition_result RaPartitionWrite(raPartition_handle * handle, uint32 offset, uint32 length, const uint8 * buffer);
+raPartition_result RaPartitionRead(raPartition_handle * handle, uint32 offset, uint32 length, uint8 * buffer);
+void RaPartitionBgErase(raPartition_handle * handle, uint32 offset);
+raPartition_result RaPartitionNamedOpen(const char * name, raPartition_handle * handle, raPartition_info * partition_info);
+
+#endif /* RAFS_HOST_RA_PARTITION_API_H */
@@ -0,0 +1,929 @@
+/*!
+    \copyright  Copyright (c) 2023 Qualcomm Technologies International, Ltd.
+                All Rights Reserved.
+                Qualcomm Technologies International, Ltd. Confidential and Proprietary.
+    \file       rafs_host.c
+    \brief      Runs RAFS on a host over the flash simulator.
+
+    rafs_host image <image> <file>...
+        Formats a partition, copies the host files into it and saves the raw
+        partition, ready to be programmed into the RA partition at the factory.
+
+    rafs_host list <image>
+        Mounts an image and lists its files.
+
+    rafs_host stress <image>
+        Runs a random create/write/read/remove/compact/remount workload,
+        cutting the power part way through some of the operations. After each
+        cut the partition is remounted and every file is checked against a
+        model of what should have survived. Reports the operations per second
+        and the mean and worst case latency of each operation, in the time
+        the simulated flash would take. The final partition is saved.
+
+    Geometry and timing options, see flash_sim.h. RAFS itself only supports
+    a block size of DIRECTORY_SIZE:
+        --partition-size, --block-size, --page-size, --read-call-us,
+        --read-ns-per-byte, --program-call-us, --program-page-us, --erase-block-us
+    Other options:
+        --mount <name>  The mount point, default /VMdl
+        --ops <n>       Number of stress operations, default 2000
+        --seed <n>      Seed of the stress workload, default 1
+        --cut-rate <n>  Percentage of stress operations to cut the power in, default 10
+        -v              More logging, repeat for more
+*/
+#include <errno.h>
+#include <getopt.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <csrtypes.h>
+#include <vmtypes.h>
+#include <logging.h>
+#include <panic.h>
+#include <message.h>
+#include <ra_partition_api.h>
+
+#include "rafs.h"
+#include "rafs_private.h"
+#include "rafs_utils.h"
+
+#include "flash_sim.h"
+#include "host_traps.h"
+
+#define STRESS_NUM_NAMES        12      /*!< Distinct filenames used by the stress workload */
+#define STRESS_MAX_CHUNK        1536    /*!< Largest single read or write */
+#define STRESS_VERIFY_INTERVAL  50      /*!< Check every file after this many operations */
+#define STRESS_MAX_CUT_DEPTH    8       /*!< Cut the power within this many programs or erases */
+
+typedef enum {
+    op_create,
+    op_read,
+    op_remove,
+    op_compact,
+    op_remount,
+    op_statfs,
+    op_recover,
+    op_count
+} stress_op_t;
+
+static const char * const op_names[op_count] = {
+    "create", "read", "remove", "compact", "remount", "statfs", "recover"
+};
+
+typedef struct {
+    uint32      count;
+    uint64_t    total_us;
+    uint64_t    max_us;
+} op_statistics_t;
+
+/*! \brief What the stress workload expects a file to hold */
+typedef struct {
+    bool        present;
+    uint32      size;
+    uint32      seed;       /*!< The file content is generated from this */
+} model_file_t;
+
+/*! \brief The operation a power cut interrupted, which may or may not have taken effect */
+typedef struct {
+    int         index;      /*!< The file operated on, -1 if none */
+    model_file_t after;     /*!< The file if the operation took effect */
+} in_flight_t;
+
+static flash_sim_config_t flash_config;
+static const char *mount_point = RAFS_PATH_SEPARATOR "VMdl";
+static uint32 stress_ops = 2000;
+static uint32 stress_seed = 1;
+static uint32 stress_cut_rate = 10;
+
+/* Stress state. Static, as it has to survive the longjmp() of a power cut. */
+static model_file_t model[STRESS_NUM_NAMES];
+static in_flight_t in_flight;
+static op_statistics_t op_statistics[op_count];
+static jmp_buf power_cut_env;
+static uint32 op_number;
+static uint32 failures;
+static uint32 fs_full_count;
+static uint8 chunk[STRESS_MAX_CHUNK];
+
+/* Completion messages */
+static MessageId last_cfm_id;
+static rafs_errors_t last_cfm_status;
+static bool cfm_received;
+
+static void rafsHost_TaskHandler(Task task, MessageId id, Message message)
+{
+    UNUSED(task);
+    cfm_received = TRUE;
+    last_cfm_id = id;
+    switch(id)
+    {
+        case MESSAGE_RAFS_MOUNT_COMPLETE:
+            last_cfm_status = ((const rafs_mount_complete_cfm *)message)->status;
+            break;
+        case MESSAGE_RAFS_COMPACT_COMPLETE:
+            last_cfm_status = ((const rafs_compact_complete_cfm *)message)->status;
+            break;
+        case MESSAGE_RAFS_WRITE_COMPLETE:
+            last_cfm_status = ((const rafs_write_complete_cfm *)message)->result;
+            break;
+        case MESSAGE_RAFS_REMOVE_COMPLETE:
+            last_cfm_status = ((const rafs_remove_complete_cfm *)message)->status;
+            break;
+        default:
+            last_cfm_status = RAFS_LAST;
+            break;
+    }
+}
+
+static TaskData host_task = { rafsHost_TaskHandler };
+
+static void rafsHost_ReportPanic(void)
+{
+    fprintf(stderr, "During operation %u of the workload with --seed %u\n", op_number, stress_seed);
+}
+
+/*! \brief Run the message loop until RAFS sends \p id to the host task */
+static rafs_errors_t rafsHost_WaitFor(MessageId id)
+{
+    cfm_received = FALSE;
+    HostTraps_RunUntilIdle();
+    if( !cfm_received || last_cfm_id != id )
+    {
+        fprintf(stderr, "Expected message 0x%x, got %s0x%x\n", id,
+                cfm_received ? "" : "nothing, last ", last_cfm_id);
+        Panic();
+    }
+    return last_cfm_status;
+}
+
+static void rafsHost_MakePath(char *path, size_t len, const char *filename)
+{
+    snprintf(path, len, "%s%s%s", mount_point, RAFS_PATH_SEPARATOR, filename);
+}
+
+static rafs_errors_t rafsHost_Mount(void)
+{
+    rafs_errors_t result = Rafs_Mount(&host_task, mount_point);
+    if( result == RAFS_OK )
+    {
+        result = rafsHost_WaitFor(MESSAGE_RAFS_MOUNT_COMPLETE);
+    }
+    return result;
+}
+
+/*! \brief Throw away everything RAM held, as a reset after a power cut does */
+static void rafsHost_Reset(void)
+{
+    rafs_instance_t *rafs_self = Rafs_GetTaskData();
+
+    HostTraps_DiscardMessages();
+    if( rafs_self )
+    {
+        if( rafs_self->files )
+        {
+            free(rafs_self->files->scan_dir_entry);
+            Rafs_FreeFilesStructure();
+        }
+        free(rafs_self->directory);
+        Rafs_FreePartitionStructure();
+        free(rafs_self);
+        Rafs_SetTaskData(NULL);
+    }
+    FlashSim_PowerOn();
+}
+
+static bool rafsHost_Start(const char *image, bool format)
+{
+    if( !FlashSim_Create(&flash_config) )
+    {
+        fprintf(stderr, "Unusable partition geometry\n");
+        return FALSE;
+    }
+    if( !format && !FlashSim_LoadImage(image) )
+    {
+        fprintf(stderr, "Can't load a %u byte image from %s\n", flash_config.partition_size, image);
+        return FALSE;
+    }
+    PanicFalse(Rafs_Init(NULL));
+    if( format )
+    {
+        rafs_errors_t result = Rafs_Format(mount_point, format_normal);
+        if( result != RAFS_OK )
+        {
+            fprintf(stderr, "Rafs_Format=%d\n", result);
+            return FALSE;
+        }
+    }
+    rafs_errors_t result = rafsHost_Mount();
+    if( result != RAFS_OK )
+    {
+        fprintf(stderr, "Rafs_Mount=%d\n", result);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static bool rafsHost_Finish(const char *image)
+{
+    rafs_errors_t result = Rafs_Unmount(mount_point);
+    if( result != RAFS_OK )
+    {
+        fprintf(stderr, "Rafs_Unmount=%d\n", result);
+        return FALSE;
+    }
+    if( image && !FlashSim_SaveImage(image) )
+    {
+        fprintf(stderr, "Can't save the image to %s: %s\n", image, strerror(errno));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void rafsHost_PrintStatfs(void)
+{
+    rafs_statfs_t statfs;
+    if( Rafs_Statfs(mount_point, &statfs) == RAFS_OK )
+    {
+        printf("%u of %u bytes free, largest new file %u bytes, %u of %u directory entries used\n",
+               statfs.free_space, statfs.available_space, statfs.file_space,
+               statfs.num_dir_entries, statfs.max_dir_entries);
+    }
+}
+
+/* Image building */
+/* -------------- */
+static bool rafsHost_AddFile(const char *host_path)
+{
+    const char *filename = strrchr(host_path, '/');
+    filename = filename ? filename + 1 : host_path;
+
+    FILE *fp = fopen(host_path, "rb");
+    if( !fp )
+    {
+        fprintf(stderr, "Can't open %s: %s\n", host_path, strerror(errno));
+        return FALSE;
+    }
+
+    char path[RAFS_MOUNTPOINT_LEN + RAFS_MAX_FILELEN + 2];
+    rafs_file_t file_id;
+    rafsHost_MakePath(path, sizeof(path), filename);
+    rafs_errors_t result = Rafs_Open(NULL, path, RAFS_WRONLY, &file_id);
+    uint32 total = 0;
+    if( result == RAFS_OK )
+    {
+        size_t got;
+        while( result == RAFS_OK && (got = fread(chunk, 1, sizeof(chunk), fp)) > 0 )
+        {
+            rafs_size_t written = 0;
+            result = Rafs_Write(file_id, chunk, (rafs_size_t)got, &written);
+            total += written;
+        }
+        rafs_errors_t close_result = Rafs_Close(file_id);
+        if( result == RAFS_OK )
+        {
+            result = close_result;
+        }
+    }
+    fclose(fp);
+
+    if( result != RAFS_OK )
+    {
+        fprintf(stderr, "Can't add %s as %s, error %d after %u bytes\n", host_path, path, result, total);
+        return FALSE;
+    }
+    printf("%-16s %8u bytes\n", filename, total);
+    return TRUE;
+}
+
+static int rafsHost_Image(const char *image, int num_files, char * const files[])
+{
+    if( !rafsHost_Start(image, TRUE) )
+    {
+        return 1;
+    }
+    for( int i = 0 ; i < num_files ; i++ )
+    {
+        if( !rafsHost_AddFile(files[i]) )
+        {
+            return 1;
+        }
+    }
+    rafsHost_PrintStatfs();
+    return rafsHost_Finish(image) ? 0 : 1;
+}
+
+static int rafsHost_List(const char *image)
+{
+    char path[RAFS_MOUNTPOINT_LEN + 2];
+    rafs_dir_t dir_id;
+    uint16 num = 0;
+    rafs_stat_t stat;
+
+    if( !rafsHost_Start(image, FALSE) )
+    {
+        return 1;
+    }
+    rafsHost_MakePath(path, sizeof(path), "");
+    PanicFalse(Rafs_OpenDirectory(path, &dir_id, &num) == RAFS_OK);
+    while( Rafs_ReadDirectory(dir_id, &stat) == RAFS_OK )
+    {
+        printf("%-16s %8u bytes  created %5u  accessed %5u\n", stat.filename, stat.file_size,
+               stat.stat_counters.sequence_count, stat.stat_counters.access_count);
+    }
+    Rafs_CloseDirectory(dir_id);
+    rafsHost_PrintStatfs();
+    return rafsHost_Finish(NULL) ? 0 : 1;
+}
+
+/* Stress workload */
+/* --------------- */
+static uint8 rafsHost_ContentByte(uint32 seed, uint32 position)
+{
+    uint32 x = seed ^ (position * 0x9E3779B1u);
+    x ^= x >> 15;
+    x *= 0x2C1B3C6Du;
+    x ^= x >> 12;
+    return (uint8)x;
+}
+
+static void rafsHost_FillChunk(uint32 seed, uint32 position, uint32 length)
+{
+    for( uint32 i = 0 ; i < length ; i++ )
+    {
+        chunk[i] = rafsHost_ContentByte(seed, position + i);
+    }
+}
+
+static uint32 rafsHost_Random(uint32 range)
+{
+    return range ? (uint32)rand() % range : 0;
+}
+
+static void rafsHost_StressPath(char *path, size_t len, int index)
+{
+    char filename[RAFS_MAX_FILELEN];
+    snprintf(filename, sizeof(filename), "f%02d.dat", index);
+    rafsHost_MakePath(path, len, filename);
+}
+
+static void rafsHost_Fail(const char *what, int index, int value)
+{
+    fprintf(stderr, "FAIL op %u: %s, file %d, value %d\n", op_number, what, index, value);
+    failures++;
+}
+
+/*! \brief Pick a file that is, or isn't, present in the model, -1 if there is none */
+static int rafsHost_PickFile(bool present)
+{
+    int start = (int)rafsHost_Random(STRESS_NUM_NAMES);
+    for( int i = 0 ; i < STRESS_NUM_NAMES ; i++ )
+    {
+        int index = (start + i) % STRESS_NUM_NAMES;
+        if( model[index].present == present )
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+/*! \brief Read a file back and check it holds the content of \p expected */
+static bool rafsHost_CheckContent(int index, const model_file_t *expected)
+{
+    char path[RAFS_MOUNTPOINT_LEN + RAFS_MAX_FILELEN + 2];
+    uint8 buf[STRESS_MAX_CHUNK];
+    rafs_file_t file_id;
+    uint32 position = 0;
+    bool ok = TRUE;
+
+    rafsHost_StressPath(path, sizeof(path), index);
+    rafs_errors_t result = Rafs_Open(NULL, path, RAFS_RDONLY, &file_id);
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("open for read", index, result);
+        return FALSE;
+    }
+
+    if( expected->size && rafsHost_Random(4) == 0 )
+    {
+        /* Start part way through, to cover seeking */
+        position = rafsHost_Random(expected->size);
+        result = Rafs_SetPosition(file_id, position);
+        if( result != RAFS_OK )
+        {
+            rafsHost_Fail("seek", index, result);
+            ok = FALSE;
+        }
+    }
+
+    while( ok && position < expected->size )
+    {
+        rafs_size_t got = 0;
+        uint32 want = 1 + rafsHost_Random(STRESS_MAX_CHUNK);
+        result = Rafs_Read(file_id, buf, want, &got);
+        if( result != RAFS_OK || got == 0 || got > want )
+        {
+            rafsHost_Fail("read", index, result);
+            ok = FALSE;
+            break;
+        }
+        rafsHost_FillChunk(expected->seed, position, got);
+        for( uint32 i = 0 ; ok && i < got ; i++ )
+        {
+            if( buf[i] != chunk[i] )
+            {
+                fprintf(stderr, "Read 0x%02x, expected 0x%02x\n", buf[i], chunk[i]);
+                rafsHost_Fail("content mismatch at", index, (int)(position + i));
+                ok = FALSE;
+            }
+        }
+        position += got;
+    }
+    Rafs_Close(file_id);
+    return ok;
+}
+
+/*! \brief Check the directory and every file against the model
+
+    The file an interrupted operation worked on may be in either its old or
+    its new state, the model is updated to whichever was found. */
+static void rafsHost_Verify(void)
+{
+    char path[RAFS_MOUNTPOINT_LEN + 2];
+    rafs_dir_t dir_id;
+    uint16 num = 0;
+    rafs_stat_t stat;
+    bool listed[STRESS_NUM_NAMES] = { FALSE };
+    uint32 listed_size[STRESS_NUM_NAMES] = { 0 };
+
+    rafsHost_MakePath(path, sizeof(path), "");
+    rafs_errors_t result = Rafs_OpenDirectory(path, &dir_id, &num);
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("open directory", -1, result);
+        return;
+    }
+    while( Rafs_ReadDirectory(dir_id, &stat) == RAFS_OK )
+    {
+        int index = -1;
+        if( sscanf(stat.filename, "f%02d.dat", &index) != 1 || index < 0 ||
+            index >= STRESS_NUM_NAMES || listed[index] )
+        {
+            fprintf(stderr, "Unexpected directory entry '%s'\n", stat.filename);
+            rafsHost_Fail("unexpected file", index, (int)stat.file_size);
+            continue;
+        }
+        listed[index] = TRUE;
+        listed_size[index] = stat.file_size;
+    }
+    Rafs_CloseDirectory(dir_id);
+
+    for( int index = 0 ; index < STRESS_NUM_NAMES ; index++ )
+    {
+        const model_file_t *candidates[2] = { &model[index], NULL };
+        const model_file_t *match = NULL;
+
+        if( in_flight.index == index )
+        {
+            candidates[1] = &in_flight.after;
+        }
+        for( int c = 0 ; c < 2 && match == NULL ; c++ )
+        {
+            const model_file_t *m = candidates[c];
+            if( m && m->present == listed[index] && (!m->present || m->size == listed_size[index]) )
+            {
+                match = m;
+            }
+        }
+
+        if( match == NULL )
+        {
+            rafsHost_Fail(listed[index] ? "file present with the wrong size" : "file missing",
+                          index, (int)listed_size[index]);
+        }
+        else
+        {
+            if( match->present )
+            {
+                rafsHost_CheckContent(index, match);
+            }
+            model[index] = *match;
+        }
+    }
+    in_flight.index = -1;
+}
+
+static void rafsHost_StressCreate(void)
+{
+    char path[RAFS_MOUNTPOINT_LEN + RAFS_MAX_FILELEN + 2];
+    rafs_file_t file_id;
+    int index = rafsHost_PickFile(FALSE);
+    if( index < 0 )
+    {
+        return;
+    }
+
+    /* Mostly small files, with the occasional one big enough to need several extents */
+    uint32 size = rafsHost_Random(4) ? rafsHost_Random(8 * 1024) :
+                                       rafsHost_Random(flash_config.partition_size / 4);
+    bool background = rafsHost_Random(4) == 0;
+
+    DEBUG_LOG_INFO("op %u: create file %d, %u bytes%s", op_number, index, size, background ? " in the background" : "");
+    in_flight.index = index;
+    in_flight.after.present = TRUE;
+    in_flight.after.size = 0;
+    in_flight.after.seed = (uint32)rand();
+
+    rafsHost_StressPath(path, sizeof(path), index);
+    rafs_errors_t result = Rafs_Open(&host_task, path, RAFS_WRONLY, &file_id);
+    if( result == RAFS_FILE_SYSTEM_FULL )
+    {
+        fs_full_count++;
+        in_flight.index = -1;
+        return;
+    }
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("open for write", index, result);
+        in_flight.index = -1;
+        return;
+    }
+
+    while( result == RAFS_OK && in_flight.after.size < size )
+    {
+        uint32 length = MIN(1 + rafsHost_Random(STRESS_MAX_CHUNK), size - in_flight.after.size);
+        rafs_size_t written = 0;
+
+        rafsHost_FillChunk(in_flight.after.seed, in_flight.after.size, length);
+        if( background )
+        {
+            result = Rafs_WriteBackground(file_id, chunk, length);
+            if( result == RAFS_OK )
+            {
+                result = rafsHost_WaitFor(MESSAGE_RAFS_WRITE_COMPLETE);
+                written = length;
+            }
+        }
+        else
+        {
+            result = Rafs_Write(file_id, chunk, length, &written);
+        }
+        if( result == RAFS_FILE_SYSTEM_FULL || result == RAFS_FILE_FULL )
+        {
+            /* Whatever fitted is kept, the file is closed at that size */
+            fs_full_count++;
+        }
+        else if( result != RAFS_OK )
+        {
+            rafsHost_Fail("write", index, result);
+        }
+        in_flight.after.size += written;
+    }
+
+    rafs_size_t position = 0;
+    if( Rafs_GetPosition(file_id, &position) == RAFS_OK )
+    {
+        /* The write complete message of a short background write isn't
+           examined, the file position says how much went in */
+        in_flight.after.size = position;
+    }
+    result = Rafs_Close(file_id);
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("close", index, result);
+    }
+    model[index] = in_flight.after;
+    in_flight.index = -1;
+}
+
+static void rafsHost_StressRead(void)
+{
+    int index = rafsHost_PickFile(TRUE);
+    if( index >= 0 )
+    {
+        DEBUG_LOG_INFO("op %u: read file %d", op_number, index);
+        rafsHost_CheckContent(index, &model[index]);
+    }
+}
+
+static void rafsHost_StressRemove(void)
+{
+    char path[RAFS_MOUNTPOINT_LEN + RAFS_MAX_FILELEN + 2];
+    int index = rafsHost_PickFile(TRUE);
+    if( index < 0 )
+    {
+        return;
+    }
+
+    DEBUG_LOG_INFO("op %u: remove file %d", op_number, index);
+    in_flight.index = index;
+    in_flight.after.present = FALSE;
+    rafsHost_StressPath(path, sizeof(path), index);
+    rafs_errors_t result = Rafs_Remove(&host_task, path);
+    if( result == RAFS_OK )
+    {
+        result = rafsHost_WaitFor(MESSAGE_RAFS_REMOVE_COMPLETE);
+    }
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("remove", index, result);
+    }
+    else
+    {
+        model[index].present = FALSE;
+    }
+    in_flight.index = -1;
+}
+
+static void rafsHost_StressCompact(void)
+{
+    DEBUG_LOG_INFO("op %u: compact", op_number);
+    rafs_errors_t result = Rafs_Compact(&host_task, mount_point);
+    if( result == RAFS_OK )
+    {
+        result = rafsHost_WaitFor(MESSAGE_RAFS_COMPACT_COMPLETE);
+    }
+    if( result != RAFS_OK && result != RAFS_FILE_SYSTEM_CLEAN )
+    {
+        rafsHost_Fail("compact", -1, result);
+    }
+}
+
+static void rafsHost_StressRemount(void)
+{
+    DEBUG_LOG_INFO("op %u: remount", op_number);
+    rafs_errors_t result = Rafs_Unmount(mount_point);
+    if( result == RAFS_OK )
+    {
+        result = rafsHost_Mount();
+    }
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("remount", -1, result);
+    }
+}
+
+static void rafsHost_StressStatfs(void)
+{
+    rafs_statfs_t statfs;
+    rafs_errors_t result = Rafs_Statfs(mount_point, &statfs);
+    if( result != RAFS_OK )
+    {
+        rafsHost_Fail("statfs", -1, result);
+    }
+    else if( statfs.free_space > statfs.available_space ||
+             statfs.contiguous_space > statfs.free_space )
+    {
+        rafsHost_Fail("statfs sizes", -1, (int)statfs.free_space);
+    }
+}
+
+static stress_op_t rafsHost_PickOperation(void)
+{
+    uint32 r = rafsHost_Random(100);
+    if( r < 35 )
+        return op_create;
+    if( r < 60 )
+        return op_read;
+    if( r < 80 )
+        return op_remove;
+    if( r < 88 )
+        return op_compact;
+    if( r < 95 )
+        return op_remount;
+    return op_statfs;
+}
+
+static void rafsHost_RunOperation(stress_op_t op)
+{
+    switch(op)
+    {
+        case op_create:     rafsHost_StressCreate();    break;
+        case op_read:       rafsHost_StressRead();      break;
+        case op_remove:     rafsHost_StressRemove();    break;
+        case op_compact:    rafsHost_StressCompact();   break;
+        case op_remount:    rafsHost_StressRemount();   break;
+        case op_statfs:     rafsHost_StressStatfs();    break;
+        default:            Panic();                    break;
+    }
+}
+
+static void rafsHost_RecordLatency(stress_op_t op, uint64_t started_us)
+{
+    uint64_t us = FlashSim_GetTime() - started_us;
+    op_statistics[op].count++;
+    op_statistics[op].total_us += us;
+    if( us > op_statistics[op].max_us )
+    {
+        op_statistics[op].max_us = us;
+    }
+}
+
+static void rafsHost_PrintStressReport(double host_seconds)
+{
+    const flash_sim_statistics_t *fs = FlashSim_GetStatistics();
+    uint64_t total_us = 0;
+    uint32 total_ops = 0;
+
+    printf("%-8s %8s %12s %12s\n", "op", "count", "mean ms", "max ms");
+    for( int op = 0 ; op < op_count ; op++ )
+    {
+        const op_statistics_t *s = &op_statistics[op];
+        printf("%-8s %8u %12.3f %12.3f\n", op_names[op], s->count,
+               s->count ? (double)s->total_us / s->count / 1000.0 : 0.0, (double)s->max_us / 1000.0);
+        if( op != op_recover )
+        {
+            total_us += s->total_us;
+            total_ops += s->count;
+        }
+    }
+    printf("%u operations in %.3f s of flash time, %.1f ops/s on the device model, %.0f ops/s on this host\n",
+           total_ops, (double)total_us / 1e6, total_us ? total_ops * 1e6 / (double)total_us : 0.0,
+           host_seconds > 0 ? total_ops / host_seconds : 0.0);
+    printf("flash: %u reads (%u bytes), %u programs (%u bytes), %u erases (%u in the background)\n",
+           fs->reads, fs->read_bytes, fs->programs, fs->program_bytes, fs->erases, fs->bg_erases);
+    printf("%u power cuts, %u program conflicts, %u times the file system was full\n",
+           fs->power_cuts, fs->program_conflicts, fs_full_count);
+}
+
+static int rafsHost_Stress(const char *image)
+{
+    static stress_op_t op;
+    static uint64_t started_us;
+    static bool recovering;
+    struct timespec host_start, host_end;
+
+    srand(stress_seed);
+    in_flight.index = -1;
+    HostTraps_SetPanicHook(rafsHost_ReportPanic);
+    if( !rafsHost_Start(image, TRUE) )
+    {
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &host_start);
+
+    if( setjmp(power_cut_env) )
+    {
+        rafsHost_Reset();
+        recovering = TRUE;
+    }
+
+    while( op_number < stress_ops && failures == 0 )
+    {
+        bool cut = rafsHost_Random(100) < stress_cut_rate;
+        if( cut )
+        {
+            FlashSim_ArmPowerCut(1 + rafsHost_Random(STRESS_MAX_CUT_DEPTH), (uint32)rand(), &power_cut_env);
+        }
+
+        if( recovering )
+        {
+            /* Remount after the power cut, which can itself be cut */
+            DEBUG_LOG_INFO("op %u: mount after a power cut", op_number);
+            started_us = FlashSim_GetTime();
+            PanicFalse(Rafs_Init(NULL));
+            rafs_errors_t result = rafsHost_Mount();
+            FlashSim_ArmPowerCut(0, 0, NULL);
+            rafsHost_RecordLatency(op_recover, started_us);
+            if( result != RAFS_OK )
+            {
+                rafsHost_Fail("mount after power cut", -1, result);
+                break;
+            }
+            recovering = FALSE;
+            rafsHost_Verify();
+            continue;
+        }
+
+        op = rafsHost_PickOperation();
+        started_us = FlashSim_GetTime();
+        rafsHost_RunOperation(op);
+        FlashSim_ArmPowerCut(0, 0, NULL);
+        rafsHost_RecordLatency(op, started_us);
+
+        if( ++op_number % STRESS_VERIFY_INTERVAL == 0 )
+        {
+            rafsHost_Verify();
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &host_end);
+    if( failures == 0 )
+    {
+        rafsHost_Verify();
+    }
+    rafsHost_PrintStressReport((double)(host_end.tv_sec - host_start.tv_sec) +
+                               (double)(host_end.tv_nsec - host_start.tv_nsec) / 1e9);
+    rafsHost_PrintStatfs();
+    if( FlashSim_GetStatistics()->program_conflicts )
+    {
+        rafsHost_Fail("data programmed over data", -1, (int)FlashSim_GetStatistics()->program_conflicts);
+    }
+    if( failures == 0 && !rafsHost_Finish(image) )
+    {
+        failures++;
+    }
+    printf("%s: %u failures with --seed %u\n", failures ? "FAILED" : "PASSED", failures, stress_seed);
+    return failures ? 1 : 0;
+}
+
+/* Command line */
+/* ------------ */
+static void rafsHost_Usage(void)
+{
+    fprintf(stderr,
+            "usage: rafs_host [options] image <image> <file>...\n"
+            "       rafs_host [options] list <image>\n"
+            "       rafs_host [options] stress <image>\n"
+            "options: --partition-size --block-size --page-size --read-call-us --read-ns-per-byte\n"
+            "         --program-call-us --program-page-us --erase-block-us\n"
+            "         --mount <name> --ops <n> --seed <n> --cut-rate <percent> -v\n");
+}
+
+int main(int argc, char *argv[])
+{
+    enum {
+        opt_partition_size = 256, opt_block_size, opt_page_size, opt_read_call_us, opt_read_ns_per_byte,
+        opt_program_call_us, opt_program_page_us, opt_erase_block_us, opt_mount, opt_ops, opt_seed, opt_cut_rate
+    };
+    static const struct option options[] = {
+        { "partition-size",     required_argument, NULL, opt_partition_size },
+        { "block-size",         required_argument, NULL, opt_block_size },
+        { "page-size",          required_argument, NULL, opt_page_size },
+        { "read-call-us",       required_argument, NULL, opt_read_call_us },
+        { "read-ns-per-byte",   required_argument, NULL, opt_read_ns_per_byte },
+        { "program-call-us",    required_argument, NULL, opt_program_call_us },
+        { "program-page-us",    required_argument, NULL, opt_program_page_us },
+        { "erase-block-us",     required_argument, NULL, opt_erase_block_us },
+        { "mount",              required_argument, NULL, opt_mount },
+        { "ops",                required_argument, NULL, opt_ops },
+        { "seed",               required_argument, NULL, opt_seed },
+        { "cut-rate",           required_argument, NULL, opt_cut_rate },
+        { NULL, 0, NULL, 0 }
+    };
+    bool partition_size_given = FALSE;
+    int opt;
+
+    FlashSim_GetDefaultConfig(&flash_config);
+    while( (opt = getopt_long(argc, argv, "v", options, NULL)) != -1 )
+    {
+        uint32 value = optarg ? (uint32)strtoul(optarg, NULL, 0) : 0;
+        switch(opt)
+        {
+            case opt_partition_size:    flash_config.partition_size = value; partition_size_given = TRUE; break;
+            case opt_block_size:        flash_config.block_size = value;        break;
+            case opt_page_size:         flash_config.page_size = value;         break;
+            case opt_read_call_us:      flash_config.read_call_us = value;      break;
+            case opt_read_ns_per_byte:  flash_config.read_ns_per_byte = value;  break;
+            case opt_program_call_us:   flash_config.program_call_us = value;   break;
+            case opt_program_page_us:   flash_config.program_page_us = value;   break;
+            case opt_erase_block_us:    flash_config.erase_block_us = value;    break;
+            case opt_mount:             mount_point = optarg;                   break;
+            case opt_ops:               stress_ops = value;                     break;
+            case opt_seed:              stress_seed = value;                    break;
+            case opt_cut_rate:          stress_cut_rate = value;                break;
+            case 'v':                   rafs_host_log_level++;                  break;
+            default:                    rafsHost_Usage();                       return 1;
+        }
+    }
+
+    if( argc - optind < 2 )
+    {
+        rafsHost_Usage();
+        return 1;
+    }
+    const char *command = argv[optind];
+    const char *image = argv[optind + 1];
+
+    if( flash_config.block_size != DIRECTORY_SIZE )
+    {
+        /* RAFS places the second FAT at DIRECTORY_SIZE but erases it at block_size */
+        fprintf(stderr, "RAFS needs a block size of %u bytes, the size of the directory\n", DIRECTORY_SIZE);
+        return 1;
+    }
+
+    if( strcmp(command, "image") == 0 )
+    {
+        return rafsHost_Image(image, argc - optind - 2, &argv[optind + 2]);
+    }
+    if( strcmp(command, "list") == 0 )
+    {
+        struct stat st;
+        if( !partition_size_given && stat(image, &st) == 0 )
+        {
+            /* An image is the whole partition */
+            flash_config.partition_size = (uint32)st.st_size;
+        }
+        return rafsHost_List(image);
+    }
+    if( strcmp(command, "stress") == 0 )
+    {
+        return rafsHost_Stress(image);
+    }
+    rafsHost_Usage();
+    return 1;
+}
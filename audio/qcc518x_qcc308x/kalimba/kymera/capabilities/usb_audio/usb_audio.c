@@ -65,6 +65,8 @@ const opmsg_handler_lookup_table_entry usb_audio_opmsg_handler_table[] =
     {OPMSG_COMMON_SET_LATENCY_LIMITS, usb_audio_opmsg_set_latency_limits},
     {OPMSG_COMMON_SET_TTP_PARAMS,  usb_audio_opmsg_set_ttp_params},
     {OPMSG_USB_AUDIO_ID_SET_RUN_DECIM_FACTOR, usb_audio_opmsg_set_run_decim_factor},
+    {OPMSG_USB_AUDIO_ID_GET_RATE_MISMATCH, usb_audio_opmsg_get_rate_mismatch},
+    {OPMSG_USB_AUDIO_ID_SET_HOST_RATE_FEEDBACK, usb_audio_opmsg_set_host_rate_feedback},
 #ifdef ENABLE_GIP_AUDIO
     {OPMSG_USB_AUDIO_ID_ENABLE_GIP_HANDLING, usb_audio_opmsg_enable_gip_handling},
 #endif
@@ -350,6 +352,86 @@ bool usb_audio_opmsg_set_run_decim_factor(OPERATOR_DATA *op_data, void *message_
     return TRUE;
 }
 
+/**
+ * usb_audio_opmsg_get_rate_mismatch
+ * \brief message handler for OPMSG_USB_AUDIO_GET_RATE_MISMATCH message
+ *
+ * \param op_data Pointer to the operator instance data.
+ * \param message_data Pointer to the start request message
+ * \param resp_length pointer to location to write the response message length
+ * \param response_data Location to write a pointer to the response message
+ *
+ * \return Whether the response_data field has been populated with a valid
+ * response
+ */
+bool usb_audio_opmsg_get_rate_mismatch(OPERATOR_DATA *op_data, void *message_data,
+                                       unsigned *resp_length, OP_OPMSG_RSP_PAYLOAD **resp_data)
+{
+    USB_AUDIO_OP_DATA *usb_audio_data = get_instance_data(op_data);
+    int mismatch_ppm;
+
+    /* only the Rx endpoint measures the rate of the host */
+    if (USB_AUDIO_IS_TX_OPERATOR(usb_audio_data) || NULL == usb_audio_data->usb_audio_ep)
+    {
+        return FALSE;
+    }
+
+    *resp_length = OPMSG_RSP_PAYLOAD_SIZE_RAW_DATA(2);
+    *resp_data = (OP_OPMSG_RSP_PAYLOAD *)xzpmalloc(OPMSG_RSP_PAYLOAD_SIZE_RAW_DATA(2)*sizeof(unsigned));
+    if (*resp_data == NULL)
+    {
+        return FALSE;
+    }
+
+    /* echo the opmsgID/keyID */
+    (*resp_data)->msg_id = OPMGR_GET_OPCMD_MESSAGE_MSG_ID((OPMSG_HEADER*)message_data);
+
+    mismatch_ppm = stream_usb_audio_get_rate_mismatch_ppm(usb_audio_data->usb_audio_ep);
+    (*resp_data)->u.raw_data[0] = ((unsigned)mismatch_ppm >> 16) & 0xFFFF;
+    (*resp_data)->u.raw_data[1] = (unsigned)mismatch_ppm & 0xFFFF;
+
+    return TRUE;
+}
+
+/**
+ * usb_audio_opmsg_set_host_rate_feedback
+ * \brief message handler for OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK message
+ *
+ * \param op_data Pointer to the operator instance data.
+ * \param message_data Pointer to the start request message
+ * \param resp_length pointer to location to write the response message length
+ * \param response_data Location to write a pointer to the response message
+ *
+ * \return Whether the response_data field has been populated with a valid
+ * response
+ */
+bool usb_audio_opmsg_set_host_rate_feedback(OPERATOR_DATA *op_data, void *message_data,
+                                            unsigned *resp_length, OP_OPMSG_RSP_PAYLOAD **resp_data)
+{
+    USB_AUDIO_OP_DATA *usb_audio_data = get_instance_data(op_data);
+
+    /* only the Rx endpoint reports the rate of the host */
+    if (USB_AUDIO_IS_TX_OPERATOR(usb_audio_data))
+    {
+        return FALSE;
+    }
+
+    usb_audio_data->host_rate_feedback = (OPMSG_FIELD_GET(message_data,
+                                                          OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK,
+                                                          ENABLE) != 0);
+
+    /* the endpoint might not be connected yet, in which case
+     * the setting is passed on when it is */
+    if(NULL != usb_audio_data->usb_audio_ep)
+    {
+        stream_usb_audio_set_host_rate_feedback(usb_audio_data->usb_audio_ep,
+                                                usb_audio_data->host_rate_feedback);
+    }
+
+    L2_DBG_MSG1("USB Audio Rx Operator, host rate feedback: %d", usb_audio_data->host_rate_feedback);
+    return TRUE;
+}
+
 #ifdef ENABLE_GIP_AUDIO
 /**
  * usb_audio_opmsg_enable_gip_handling
@@ -861,6 +943,12 @@ bool usb_audio_connect(OPERATOR_DATA * op_data, void *message_data,
                 base_op_change_response_status(response_data, STATUS_CMD_FAILED);
                 return TRUE;
             }
+
+            if(USB_AUDIO_IS_RX_OPERATOR(usb_audio_data))
+            {
+                stream_usb_audio_set_host_rate_feedback(usb_audio_data->usb_audio_ep,
+                                                        usb_audio_data->host_rate_feedback);
+            }
         }
         /* connect the buffer */
         *bufp = OPMGR_GET_OP_CONNECT_BUFFER(message_data);
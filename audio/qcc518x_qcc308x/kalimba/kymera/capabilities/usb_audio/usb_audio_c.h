@@ -145,6 +145,10 @@ typedef struct
      */
      unsigned usb_audio_rx_decim_ms;
 
+    /* whether the host adapts its rate to an explicit feedback
+     * endpoint, passed to the endpoint once connected - Rx only */
+    bool host_rate_feedback;
+
     ttp_context *time_to_play;
     unsigned target_latency;
 
@@ -225,6 +229,10 @@ extern bool usb_audio_opmsg_set_connection_config(OPERATOR_DATA *op_data, void *
                                             OP_OPMSG_RSP_PAYLOAD **resp_data);
 extern bool usb_audio_opmsg_set_run_decim_factor(OPERATOR_DATA *op_data, void *message_data,
                                              unsigned *resp_length, OP_OPMSG_RSP_PAYLOAD **resp_data);
+extern bool usb_audio_opmsg_get_rate_mismatch(OPERATOR_DATA *op_data, void *message_data,
+                                              unsigned *resp_length, OP_OPMSG_RSP_PAYLOAD **resp_data);
+extern bool usb_audio_opmsg_set_host_rate_feedback(OPERATOR_DATA *op_data, void *message_data,
+                                                   unsigned *resp_length, OP_OPMSG_RSP_PAYLOAD **resp_data);
 extern bool usb_audio_opmsg_enable_gip_handling(OPERATOR_DATA *op_data, void *message_data,
                                           unsigned *resp_length, OP_OPMSG_RSP_PAYLOAD **resp_data);											 
 
@@ -2534,13 +2534,22 @@ typedef enum
                             less often.
     ENABLE_GIP_HANDLING   - This message enables gip protocol handling in the
                             operator.
+    GET_RATE_MISMATCH     - Send this message to the USB Audio Rx to read the
+                            measured mismatch between the local clock and the
+                            USB packet rate, in ppm.
+    SET_HOST_RATE_FEEDBACK - Send this message to the USB Audio Rx when the
+                             host adapts its sample rate to an explicit
+                             feedback endpoint, so the endpoint stops
+                             reporting the measured mismatch for rate matching.
 
 *******************************************************************************/
 typedef enum
 {
     OPMSG_USB_AUDIO_ID_SET_CONNECTION_CONFIG = 0x0002,
     OPMSG_USB_AUDIO_ID_SET_RUN_DECIM_FACTOR = 0x0003,
-    OPMSG_USB_AUDIO_ID_ENABLE_GIP_HANDLING = 0x0004
+    OPMSG_USB_AUDIO_ID_ENABLE_GIP_HANDLING = 0x0004,
+    OPMSG_USB_AUDIO_ID_GET_RATE_MISMATCH = 0x0005,
+    OPMSG_USB_AUDIO_ID_SET_HOST_RATE_FEEDBACK = 0x0006
 } OPMSG_USB_AUDIO_ID;
 /*******************************************************************************
 
@@ -15924,6 +15933,46 @@ typedef struct
 #define OPMSG_USB_AUDIO_SET_RUN_DECIM_FACTOR_UNMARSHALL(addr, opmsg_usb_audio_set_run_decim_factor_ptr) memcpy((void *)(opmsg_usb_audio_set_run_decim_factor_ptr), (void *)(addr), 2)
 
 
+/*******************************************************************************
+
+  NAME
+    Opmsg_Usb_Audio_Set_Host_Rate_Feedback
+
+  DESCRIPTION
+    sends the SET_HOST_RATE_FEEDBACK to the USB Audio Rx operator
+
+  MEMBERS
+    message_id - message id
+    enable     - 1 if the host follows an explicit feedback endpoint
+
+*******************************************************************************/
+typedef struct
+{
+    uint16 _data[2];
+} OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK;
+
+/* The following macros take OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK *opmsg_usb_audio_set_host_rate_feedback_ptr */
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_MESSAGE_ID_WORD_OFFSET (0)
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_MESSAGE_ID_GET(opmsg_usb_audio_set_host_rate_feedback_ptr) ((OPMSG_USB_AUDIO_ID)(opmsg_usb_audio_set_host_rate_feedback_ptr)->_data[0])
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_MESSAGE_ID_SET(opmsg_usb_audio_set_host_rate_feedback_ptr, message_id) ((opmsg_usb_audio_set_host_rate_feedback_ptr)->_data[0] = (uint16)(message_id))
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_ENABLE_WORD_OFFSET (1)
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_ENABLE_GET(opmsg_usb_audio_set_host_rate_feedback_ptr) ((opmsg_usb_audio_set_host_rate_feedback_ptr)->_data[1])
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_ENABLE_SET(opmsg_usb_audio_set_host_rate_feedback_ptr, enable) ((opmsg_usb_audio_set_host_rate_feedback_ptr)->_data[1] = (uint16)(enable))
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_WORD_SIZE (2)
+/*lint -e(773) allow unparenthesized*/
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_CREATE(message_id, enable) \
+    (uint16)(message_id), \
+    (uint16)(enable)
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_PACK(opmsg_usb_audio_set_host_rate_feedback_ptr, message_id, enable) \
+    do { \
+        (opmsg_usb_audio_set_host_rate_feedback_ptr)->_data[0] = (uint16)((uint16)(message_id)); \
+        (opmsg_usb_audio_set_host_rate_feedback_ptr)->_data[1] = (uint16)((uint16)(enable)); \
+    } while (0)
+
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_MARSHALL(addr, opmsg_usb_audio_set_host_rate_feedback_ptr) memcpy((void *)(addr), (void *)(opmsg_usb_audio_set_host_rate_feedback_ptr), 2)
+#define OPMSG_USB_AUDIO_SET_HOST_RATE_FEEDBACK_UNMARSHALL(addr, opmsg_usb_audio_set_host_rate_feedback_ptr) memcpy((void *)(opmsg_usb_audio_set_host_rate_feedback_ptr), (void *)(addr), 2)
+
+
 /*******************************************************************************
 
   NAME
@@ -983,6 +983,12 @@ typedef struct endpoint_usb_audio_state
      */
     unsigned norm_rate_ratio;
 
+    /* whether the host adapts its rate to an explicit feedback
+     * endpoint, in which case perfect rate is reported to rate
+     * match manager - RX only
+     */
+    bool host_rate_feedback;
+
     /* whether this ep is performing rate-matching - TX only */
     bool ep_ratematch_enacting;
 
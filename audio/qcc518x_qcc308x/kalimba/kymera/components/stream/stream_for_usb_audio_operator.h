@@ -41,4 +41,22 @@ extern bool stream_usb_audio_can_enact_rate_adjust(ENDPOINT *ep,
 extern void stream_usb_audio_set_cbops_sra_op(ENDPOINT *ep,
                                               cbops_op *rate_adjust_op);
 
+/**
+ * \brief gets the measured rate mismatch of the usb audio endpoint
+ *
+ * \param ep Pointer to the usb audio endpoint
+ *
+ * \return mismatch between local clock and usb packet rate in ppm,
+ *         positive when the local clock is faster.
+ */
+extern int stream_usb_audio_get_rate_mismatch_ppm(ENDPOINT *ep);
+
+/**
+ * \brief sets whether the host follows an explicit feedback endpoint
+ *
+ * \param ep     Pointer to the usb audio endpoint
+ * \param enable TRUE if the host adapts its rate to the feedback endpoint
+ */
+extern void stream_usb_audio_set_host_rate_feedback(ENDPOINT *ep, bool enable);
+
 #endif /* STREAM_FOR_USB_AUDIO_ENDPOINT_H */
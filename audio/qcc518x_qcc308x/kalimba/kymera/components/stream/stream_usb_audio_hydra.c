@@ -280,6 +280,47 @@ void stream_usb_audio_set_cbops_sra_op(ENDPOINT *ep, cbops_op* rate_adjust_op)
                                       !ep->state.usb_audio.ep_ratematch_enacting);
 }
 
+/**
+ * \brief gets the measured rate mismatch of the usb audio endpoint
+ *
+ * \param ep Pointer to the usb audio endpoint
+ *
+ * \return mismatch between local clock and usb packet rate in ppm,
+ *         positive when the local clock is faster.
+ */
+int stream_usb_audio_get_rate_mismatch_ppm(ENDPOINT *ep)
+{
+    patch_fn_shared(stream_usb_audio_hydra);
+
+    if(ep->stream_endpoint_type != endpoint_usb_audio ||
+       NULL == ep->state.usb_audio.rate_measure)
+    {
+        return 0;
+    }
+
+    return frac_mult(ep->state.usb_audio.rate_measure->sp_adjust >> USB_AUDIO_RATE_MEASURE_SHIFT, 1000000);
+}
+
+/**
+ * \brief sets whether the host follows an explicit feedback endpoint
+ *
+ * \param ep     Pointer to the usb audio endpoint
+ * \param enable TRUE if the host adapts its rate to the feedback endpoint
+ */
+void stream_usb_audio_set_host_rate_feedback(ENDPOINT *ep, bool enable)
+{
+    patch_fn_shared(stream_usb_audio_hydra);
+
+    if(ep->stream_endpoint_type != endpoint_usb_audio ||
+       ep->direction != SOURCE)
+    {
+        return;
+    }
+
+    ep->state.usb_audio.host_rate_feedback = enable;
+    L2_DBG_MSG1("EP_USB_AUDIO SOURCE: host rate feedback=%d", enable);
+}
+
 bool stream_query_usb_audio(AUDIO_DATA_SERVICE_EP_PARAMS *params)
 {
     unsigned buff_size = 0;
@@ -1590,6 +1631,14 @@ static bool usb_audio_get_config(ENDPOINT *ep, unsigned int key, ENDPOINT_GET_CO
                  * only timed playback rate matching happens */
                 result->u.value = RM_PERFECT_RATE;
             }
+            else if(ep->state.usb_audio.host_rate_feedback)
+            {
+                /* Rx only:
+                 * the host already follows our clock via the feedback
+                 * endpoint, correcting the measured mismatch here as
+                 * well would apply the drift compensation twice */
+                result->u.value = RM_PERFECT_RATE;
+            }
             else
             {
                 /* return estimated mismatch rate */
@@ -61,6 +61,15 @@ role selection. */
     with the highest priority first */
 #define AUDIO_TYPE_PRIORITIES {source_type_voice, source_type_audio}
 
+/*! Cache the most frequently played short prompts in RAM, so they aren't read
+    from the file system each time they play. See Kymera_EnablePromptCache(). */
+#define appConfigPromptCacheEnabled()   (TRUE)
+
+/*! Keep a prompt chain connected to the output chain while other audio is
+    playing, so UI prompts don't wait for a chain to be built and connected.
+    See Kymera_SetPromptKeepWarm(). */
+#define appConfigPromptKeepWarmEnabled()    (TRUE)
+
 /*! Initialize major and minor upgrade version information*/
 #define UPGRADE_INIT_VERSION_MAJOR (1)
 #define UPGRADE_INIT_VERSION_MINOR (0)
@@ -121,6 +121,7 @@ marshal_type_descriptors_out_of_sync_with_marshal_types);
 /* handover interface static function declarations */
 static bool earbudHandover_Veto(void);
 static bool earbudHandover_VetoLink(const tp_bdaddr *tp_bd_addr);
+static uint16 earbudHandover_EstimateSize(const tp_bdaddr *addr);
 static bool earbudHandover_Marshal(const tp_bdaddr *addr, uint8 *buffer, uint16 buffer_size, uint16 *written);
 static bool earbudHandover_Unmarshal(const tp_bdaddr *addr, const uint8 *buffer, uint16 buffer_size, uint16 *consumed);
 static void earbudHandover_Commit(const tp_bdaddr *tp_bd_addr, const bool role);
@@ -187,9 +188,11 @@ typedef struct {
 
 /* Handover interface */
 const handover_interface application_handover_interface =
-        MAKE_HANDOVER_IF_VPL(
+        MAKE_HANDOVER_IF_ESTIMATE(
+            HANDOVER_SUPPORT_ALL,
             &earbudHandover_Veto,
             &earbudHandover_VetoLink,
+            &earbudHandover_EstimateSize,
             &earbudHandover_Marshal,
             &earbudHandover_Unmarshal,
             &earbudHandover_Commit,
@@ -933,6 +936,68 @@ static bool earbudHandover_Marshal(const tp_bdaddr *addr, uint8 *buffer, uint16
     return marshalled;
 }
 
+/*! \brief Handover application's marshal size estimate interface.
+
+    Each object that earbudHandover_Marshal() will marshal is sized on its own
+    by a marshaller without a buffer. Objects referenced by more than one
+    marshal type are counted each time, so the result is an upper bound.
+
+    \param[in] addr address of handset.
+    \returns Upper bound of the bytes earbudHandover_Marshal() writes.
+ */
+static uint16 earbudHandover_EstimateSize(const tp_bdaddr *addr)
+{
+    handover_app_device_t *device;
+    uint32 size = 0;
+    void *data = NULL;
+
+    PanicNull((void*)addr);
+
+    if (!earbudHandover_IsAnyValidInterfaceRegistered(addr->transport))
+    {
+        return 0;
+    }
+
+    /* The same device is used by earbudHandover_Marshal() */
+    device = earbudHandover_GetOrCreateDevice(addr);
+
+    FOR_EACH_REGISTERED_INTERFACE(curr_inf)
+    {
+        if ((curr_inf->type_list) && (curr_inf->interface_type == addr->transport))
+        {
+            FOR_EACH_MARSHAL_TYPE_OF_INTERFACE(curr_inf, type_info)
+            {
+                if (earbudHandover_IsMarshalTypeCategoryPerInstance(type_info->category) || earbudHandover_IsGenericDataAllowedForDevice(device))
+                {
+                    bool client_marshalled = FALSE;
+
+                    if (curr_inf->interface_type == INTERFACE_TYPE_BREDR)
+                    {
+                        client_marshalled = curr_inf->Marshal.bredr(&(device->tp_bd_addr.taddr.addr), type_info->type, &data);
+                    }
+                    else if (curr_inf->interface_type == INTERFACE_TYPE_BLE)
+                    {
+                        client_marshalled = curr_inf->Marshal.le(&(device->tp_bd_addr.taddr), type_info->type, &data);
+                    }
+
+                    if (client_marshalled)
+                    {
+                        /* Without a buffer the marshaller only works out how much it would write */
+                        marshaller_t marshaller = PanicNull(MarshalInit(mtd_handover_app, NUMBER_OF_EARBUD_APP_MARSHAL_OBJECT_TYPES));
+                        MarshalSetBuffer(marshaller, NULL, 0);
+                        (void)Marshal(marshaller, data, type_info->type);
+                        size += MarshalRemaining(marshaller);
+                        MarshalDestroy(marshaller, FALSE);
+                    }
+                }
+            }
+        }
+    }
+
+    EB_HANDOVER_DEBUG_LOG_DEBUG("earbudHandover_EstimateSize: device:0x%06lx, size:%u", device->tp_bd_addr.taddr.addr.lap, size);
+    return (uint16)MIN(size, 0xFFFF);
+}
+
 /*! \brief Handover application's unmarshaling interface.
 
     \note Possible cases,
@@ -61,6 +61,7 @@
 #include "statistics_gaia_plugin.h"
 #include "statistics_gaia_plugin_handlers_streaming.h"
 #include "statistics_gaia_plugin_handlers_spatial_audio.h"
+#include "statistics_gaia_plugin_handlers_metrics.h"
 #include "gatt_handler.h"
 #include "gatt_connect.h"
 #include "gatt_server_battery.h"
@@ -798,14 +799,17 @@ static const system_state_step_t appInitTable[] =
 	{AudioRouterObserver_Init,  0, NULL},
     {Volume_InitMessages,   0, NULL},
     {VolumeService_Init,    0, NULL},
-    {appAvInit,             AV_INIT_CFM, NULL},
-    {appPeerSigInit,        PEER_SIG_INIT_CFM, NULL},
+    /* AV, peer signalling and HFP only wait for their profile or PSM to be
+       registered with the Bluetooth stack, nothing before KeySync_Init needs
+       that to have completed so these registrations overlap. */
+    {appAvInit,             AV_INIT_CFM, NULL, system_state_step_overlap},
+    {appPeerSigInit,        PEER_SIG_INIT_CFM, NULL, system_state_step_overlap},
     {LogicalInputSwitch_Init,     0, NULL},
     {Pairing_Init,          PAIRING_INIT_CFM, NULL},
     {FocusSelect_Init,   0, NULL},
     {Telephony_InitMessages, 0, NULL},
     {TelephonyService_Init, 0, NULL},
-    {HfpProfile_Init,            APP_HFP_INIT_CFM, NULL},
+    {HfpProfile_Init,            APP_HFP_INIT_CFM, NULL, system_state_step_overlap},
     {SingleEntity_Init,     0, NULL},
 #ifdef INCLUDE_BTDBG
     {BtdbgProfile_Init, 0, NULL},
@@ -814,7 +818,7 @@ static const system_state_step_t appInitTable[] =
 #ifdef INCLUDE_QCOM_CON_MANAGER
     {QcomConManagerInit,QCOM_CON_MANAGER_INIT_CFM,NULL},
 #endif
-    {KeySync_Init,          0, NULL},
+    {KeySync_Init,          0, NULL, system_state_step_wait_overlapped},
 #ifdef INCLUDE_L2CAP_MANAGER
     {L2capManager_Init,     0, NULL},
 #endif
@@ -940,6 +944,7 @@ static const system_state_step_t appInitTable[] =
 #if defined(INCLUDE_SPATIAL_AUDIO) && defined (INCLUDE_SPATIAL_DATA) && defined(INCLUDE_ATTITUDE_FILTER)
     {StatisticsGaiaPluginHandlersSpatialAudio_Init, 0, NULL},
 #endif /* SPATIAL AUDIO */
+    {StatisticsGaiaPluginHandlersMetrics_Init, 0, NULL},
 #endif /* INCLUDE_STATISTICS */
     {BatteryGaiaPlugin_Init,  0, NULL},
 #endif /* INCLUDE_GAIA */
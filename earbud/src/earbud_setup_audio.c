@@ -157,6 +157,7 @@
 #endif
 
 #include "earbud_setup_audio.h"
+#include "earbud_config.h"
 #include "source_prediction.h"
 #include "kymera.h"
 #include "cap_id_prim.h"
@@ -808,6 +809,8 @@ bool AppSetupAudio_InitAudio(Task init_task)
         Kymera_StoreLargestWuwEngine();
 #endif
         AudioOutputInit(&audio_hw_output_config);
+        Kymera_EnablePromptCache(appConfigPromptCacheEnabled());
+        Kymera_SetPromptKeepWarm(appConfigPromptKeepWarmEnabled());
     }
     return status;
 }
@@ -44,6 +44,7 @@
 #include "statistics_gaia_plugin.h"
 #include "statistics_gaia_plugin_handlers_streaming.h"
 #include "statistics_gaia_plugin_handlers_spatial_audio.h"
+#include "statistics_gaia_plugin_handlers_metrics.h"
 #ifdef ENABLE_GAIA_USER_FEATURE_LIST_DATA
 #include "app_gaia_user_feature_config.h"
 #endif
@@ -850,6 +851,7 @@ static const system_state_step_t app_init_table[] =
 #if defined(INCLUDE_SPATIAL_AUDIO) && defined (INCLUDE_SPATIAL_DATA) && defined(INCLUDE_ATTITUDE_FILTER)
     {StatisticsGaiaPluginHandlersSpatialAudio_Init, 0, NULL},
 #endif /* SPATIAL AUDIO */
+    {StatisticsGaiaPluginHandlersMetrics_Init, 0, NULL},
 #endif /* INCLUDE_STATISTICS */
     {BatteryGaiaPlugin_Init,  0, NULL},
 #endif /* INCLUDE_GAIA */
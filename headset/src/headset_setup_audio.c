@@ -15,6 +15,7 @@
 
 #include "headset_cap_ids.h"
 #include "headset_setup_audio.h"
+#include "headset_config.h"
 #include "headset_product_config.h"
 
 #include "chain_sco_nb.h"
@@ -753,6 +754,8 @@ bool AppSetupAudio_InitAudio(Task init_task)
 #endif
         WiredAudioSource_Configure(&wired_audio_config);
         AudioOutputInit(&audio_hw_output_config);
+        Kymera_EnablePromptCache(appConfigPromptCacheEnabled());
+        Kymera_SetPromptKeepWarm(appConfigPromptKeepWarmEnabled());
     }
     return status;
 }
@@ -565,6 +565,14 @@ This message is sent to the task registered with MessageOperatorFrameworkTask().
  */
 #define MESSAGE_LINK_STATUS_TRACKING (SYSTEM_MESSAGE_BASE_ + 88)
 
+/*!
+  Message to indicate that a job posted with MessageWorkerPost() has finished.
+  The message content is a #MessageWorkerDone.
+
+  This message is sent to the done task passed to MessageWorkerPost().
+ */
+#define MESSAGE_WORKER_DONE (SYSTEM_MESSAGE_BASE_ + 89)
+
 /*!
   #MESSAGE_MORE_DATA: Message type received when more data has arrived at a Source.
  */
@@ -982,4 +990,13 @@ typedef struct
     uint16                      connection_event;       /*!< Not supported reserved for future use */
 } MessageLinkStatusTracking;
 
+/*!
+  #MESSAGE_WORKER_DONE received when a worker job has finished.
+*/
+typedef struct
+{
+    void (*fn)(void *context); /*!< The job that finished */
+    void *context;             /*!< The context the job was posted with */
+} MessageWorkerDone;
+
 #endif
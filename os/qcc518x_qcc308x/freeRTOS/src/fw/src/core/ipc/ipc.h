@@ -60,6 +60,54 @@ extern void ipc_init(void);
 
 extern void ipc_send(IPC_SIGNAL_ID msg_id, const void *msg, uint16 len_bytes);
 
+#if IPC_PROTOCOL_ID == 2
+/**
+ * Non-blocking batched send: copies the supplied message into the IPC send
+ * buffer but only raises the IPC interrupt on the other processor once
+ * \c IPC_SEND_BATCH_MAX messages are waiting, on the next \c ipc_send() or
+ * \c ipc_transaction(), or when the sending task stops running. Any blocking
+ * call, and preemption by another task, switches the task out, so a batch is
+ * never held while its sender waits.
+ *
+ * For high-rate messages that don't need a response and can tolerate being
+ * delayed for as long as the sending task keeps running. Messages are still
+ * delivered in the order they were sent, relative to all other messages.
+ *
+ * @param msg_id ID of message to send
+ * @param msg Message body (note: the ID field is automatically set)
+ * @param len_bytes Length of message in bytes. Must be a multiple of 4.
+ *
+ * \ingroup ipc_send
+ */
+extern void ipc_send_batched(IPC_SIGNAL_ID msg_id, const void *msg,
+                             uint16 len_bytes);
+
+/**
+ * Raise the IPC interrupt on the other processor if any messages sent with
+ * \c ipc_send_batched() are still waiting for it.
+ *
+ * Blocks interrupts itself, so is for task context. The context switch uses
+ * \c ipc_send_flush_from_switch() instead.
+ *
+ * \ingroup ipc_send
+ */
+extern void ipc_send_flush(void);
+
+/**
+ * As \c ipc_send_flush(), but for the FreeRTOS context switch whenever a task
+ * is switched out. Interrupts are already held off there, so this leaves the
+ * \c block_interrupts() nesting count alone.
+ *
+ * \ingroup ipc_send
+ */
+extern void ipc_send_flush_from_switch(void);
+#else
+#define ipc_send_batched(msg_id, msg, len_bytes) \
+    ipc_send((msg_id), (msg), (len_bytes))
+#define ipc_send_flush() ((void)0)
+#define ipc_send_flush_from_switch() ((void)0)
+#endif /* IPC_PROTOCOL_ID == 2 */
+
 /**
  * Non-blocking out-of-band send: creates an \c IPC_TUNNELLED_PRIM_OUTBAND
  * pointing at the supplied payload and submits it via \c ipc_send().
@@ -10,8 +10,10 @@ void ipc_send_bluestack(uint16 protocol, void *prim)
     IPC_BLUESTACK_PRIM ipc_prim;
     ipc_prim.protocol = protocol;
     ipc_prim.prim = prim;
-    ipc_send(IPC_SIGNAL_ID_BLUESTACK_PRIM, &ipc_prim,
-                                                    sizeof(IPC_BLUESTACK_PRIM));
+    /* BlueStack primitives are high rate and never wait for a response, so
+       P0 is interrupted once for a batch of them. */
+    ipc_send_batched(IPC_SIGNAL_ID_BLUESTACK_PRIM, &ipc_prim,
+                     sizeof(IPC_BLUESTACK_PRIM));
 }
 
 void ipc_bluestack_handler(IPC_SIGNAL_ID id, const void *msg)
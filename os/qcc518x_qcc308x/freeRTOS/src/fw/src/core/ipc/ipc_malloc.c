@@ -11,7 +11,7 @@ void ipc_send_free(IPC_SIGNAL_ID free_id, void *pointer)
 {
     IPC_FREE free_msg;
     free_msg.pointer = pointer;
-    ipc_send(free_id, &free_msg, sizeof(IPC_FREE));
+    ipc_send_batched(free_id, &free_msg, sizeof(IPC_FREE));
 }
 
 void *ipc_send_smalloc(uint32 size_bytes, bool panic_on_failure)
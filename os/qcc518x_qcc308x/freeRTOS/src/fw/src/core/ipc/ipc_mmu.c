@@ -10,7 +10,9 @@ void ipc_send_buf_raw_update_tail_free(BUFFER *buf, uint16 new_tail)
     IPC_BUF_TAIL_FREE prim;
     prim.buffer = buf;
     prim.new_tail = new_tail;
-    ipc_send(IPC_SIGNAL_ID_BUF_TAIL_FREE, (const void *)&prim, sizeof(prim));
+    /* Buffer updates are high rate and never wait for a response. */
+    ipc_send_batched(IPC_SIGNAL_ID_BUF_TAIL_FREE, (const void *)&prim,
+                     sizeof(prim));
 }
 
 void ipc_send_buf_update_behind_free(BUFFER_MSG *msg_buf)
@@ -20,6 +22,6 @@ void ipc_send_buf_update_behind_free(BUFFER_MSG *msg_buf)
      * in shared memory. */
     IPC_BUF_UPDATE_BEHIND_FREE prim;
     prim.buffer_msg = msg_buf;
-    ipc_send(IPC_SIGNAL_ID_BUF_UPDATE_BEHIND_FREE,
+    ipc_send_batched(IPC_SIGNAL_ID_BUF_UPDATE_BEHIND_FREE,
                                         (const void *)&prim, sizeof(prim));
 }
@@ -12,6 +12,7 @@ static void ipc_recv_task_handler(void *parameters);
 
 void ipc_interrupt_handler(void)
 {
+    ++ipc_data.recv_interrupts;
     ipc_recv_kick_process_queue();
 }
 
@@ -4,17 +4,22 @@
 #include "ipc/ipc_private.h"
 #include "ipc_task.h"
 
+static void ipc_header_set(IPC_HEADER *header, const ipc_task_t *ipc_task,
+                           IPC_SIGNAL_ID msg_id, uint16 len_bytes)
+{
+    header->id = msg_id;
+    ipc_header_timestamp_set(header);
+    header->length_bytes = len_bytes;
+    header->client = ipc_task_tag(ipc_task);
+    header->priority = ipc_task_priority(ipc_task);
+}
+
 static void ipc_try_send(const ipc_task_t *ipc_task, IPC_SIGNAL_ID msg_id,
                          const void *msg, uint16 len_bytes)
 {
     IPC_HEADER header;
 
-    header.id = msg_id;
-    ipc_header_timestamp_set(&header);
-    header.length_bytes = len_bytes;
-    header.client = ipc_task_tag(ipc_task);
-    header.priority = ipc_task_priority(ipc_task);
-
+    ipc_header_set(&header, ipc_task, msg_id, len_bytes);
     ipc_try_send_common(&header, msg, len_bytes);
 }
 
@@ -24,11 +29,31 @@ void ipc_send(IPC_SIGNAL_ID msg_id, const void *msg, uint16 len_bytes)
     ipc_try_send(ipc_task, msg_id, msg, len_bytes);
 }
 
+void ipc_send_batched(IPC_SIGNAL_ID msg_id, const void *msg, uint16 len_bytes)
+{
+    ipc_task_t *ipc_task;
+    IPC_HEADER header;
+
+    if(!sched_is_running() || sched_in_interrupt())
+    {
+        /* Nothing would flush the batch. */
+        ipc_send(msg_id, msg, len_bytes);
+        return;
+    }
+
+    ipc_task = ipc_task_get_or_create();
+    ipc_header_set(&header, ipc_task, msg_id, len_bytes);
+    ipc_try_send_common_batched(&header, msg, len_bytes);
+}
+
 void ipc_transaction(IPC_SIGNAL_ID msg_id, const void *msg, uint16 len_bytes,
                      IPC_SIGNAL_ID rsp_id, void *blocking_msg)
 {
     ipc_task_t *ipc_task = ipc_task_get_or_create();
     ipc_task_response_set(ipc_task, rsp_id, blocking_msg);
+    block_interrupts();
+    ++ipc_data.transactions;
+    unblock_interrupts();
     ipc_try_send(ipc_task, msg_id, msg, len_bytes);
     ipc_task_response_wait(ipc_task);
 }
@@ -49,6 +49,17 @@
  */
 #define IPC_MAX_RECV_MSGS 10
 
+/**
+ * The maximum number of messages sent with ipc_send_batched() before the other
+ * processor is interrupted regardless. Bounds both the delay and the share of
+ * the send buffer a batch can take.
+ *
+ * \ingroup ipc_send_impl
+ */
+#ifndef IPC_SEND_BATCH_MAX
+#define IPC_SEND_BATCH_MAX 8
+#endif
+
 #define hal_set_reg_interproc_event_1 hal_set_reg_p1_to_p0_interproc_event_1
 #define hal_set_reg_interproc_event_2 hal_set_reg_p1_to_p0_interproc_event_2
 
@@ -114,6 +125,19 @@ typedef struct
     /** Record the maximum number of bytes used by the ipc_send buffer. */
     uint16 max_send_bytes_used;
 
+#if IPC_PROTOCOL_ID == 2
+    /** Number of messages in the send buffer that the other processor
+        hasn't been interrupted for yet. */
+    uint16 send_batched;
+
+    /** Counts of messages sent, IPC interrupts raised on the other processor,
+        round trip transactions and IPC interrupts received. */
+    uint32 send_msgs;
+    uint32 send_interrupts;
+    uint32 transactions;
+    uint32 recv_interrupts;
+#endif /* IPC_PROTOCOL_ID == 2 */
+
 
 #if IPC_PROTOCOL_ID < 2
     /** Linked list of pmalloced messages waiting for send buffer space. */
@@ -503,6 +527,20 @@ void ipc_recv_task_create(void);
  */
 void ipc_try_send_common(const IPC_HEADER *header, const void *msg,
                          uint16 len_bytes);
+
+/**
+ * @brief Copies the header and message into the IPC send buffer without
+ * interrupting the other processor, unless the batch is full.
+ *
+ * If there's no space in the IPC send buffer for the message this function will
+ * panic with PANIC_IPC_BUFFER_OVERFLOW.
+ *
+ * @param [in] header  The header for the message. Must not be NULL.
+ * @param [in] msg  The message to send. Must not be NULL.
+ * @param [in] len_bytes  The length of @p msg in bytes.
+ */
+void ipc_try_send_common_batched(const IPC_HEADER *header, const void *msg,
+                                 uint16 len_bytes);
 #endif /* IPC_PROTOCOL_ID == 2 */
 
 /**
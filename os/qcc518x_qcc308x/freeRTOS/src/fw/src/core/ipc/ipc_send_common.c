@@ -41,8 +41,13 @@ void ipc_send_signal(IPC_SIGNAL_ID sig_id)
     ipc_send(sig_id, &sig, sizeof(sig));
 }
 
-void ipc_send_no_checks(const IPC_HEADER *header, const void *msg,
-                        uint16 len_bytes)
+/**
+ * @brief Copies the header and message into the IPC send buffer.
+ *
+ * \note This function must be called with interrupts blocked!
+ */
+static void ipc_send_write(const IPC_HEADER *header, const void *msg,
+                           uint16 len_bytes)
 {
     IPC_HEADER *send;
 
@@ -58,9 +63,6 @@ void ipc_send_no_checks(const IPC_HEADER *header, const void *msg,
 
     ipc_buffer_update_write(ipc_data.send, len_bytes);
 
-    /* Raise IPC interrupt.  It doesn't matter what we write */
-    hal_set_reg_interproc_event_1(1);
-
     /* Update maximum IPC buffer utilisation. */
     if(ipc_buffer_used(ipc_data.send) > ipc_data.max_send_bytes_used)
     {
@@ -68,6 +70,31 @@ void ipc_send_no_checks(const IPC_HEADER *header, const void *msg,
     }
 }
 
+/**
+ * @brief Interrupts the other processor to read everything in the send buffer.
+ *
+ * \note This function must be called with interrupts blocked!
+ */
+static void ipc_send_interrupt(void)
+{
+    /* Raise IPC interrupt.  It doesn't matter what we write */
+    hal_set_reg_interproc_event_1(1);
+
+#if IPC_PROTOCOL_ID == 2
+    /* The other processor reads until the buffer is empty, so this covers any
+       batched messages written before this one. */
+    ipc_data.send_batched = 0;
+    ++ipc_data.send_interrupts;
+#endif
+}
+
+void ipc_send_no_checks(const IPC_HEADER *header, const void *msg,
+                        uint16 len_bytes)
+{
+    ipc_send_write(header, msg, len_bytes);
+    ipc_send_interrupt();
+}
+
 #if IPC_PROTOCOL_ID == 2
 void ipc_try_send_common(const IPC_HEADER *header, const void *msg,
                          uint16 len_bytes)
@@ -77,6 +104,29 @@ void ipc_try_send_common(const IPC_HEADER *header, const void *msg,
         if (ipc_buffer_has_space_for(ipc_data.send, len_bytes))
         {
             ipc_send_no_checks(header, msg, len_bytes);
+            ++ipc_data.send_msgs;
+        }
+        else
+        {
+            panic_diatribe(PANIC_IPC_BUFFER_OVERFLOW, len_bytes);
+        }
+    }
+    unblock_interrupts();
+}
+
+void ipc_try_send_common_batched(const IPC_HEADER *header, const void *msg,
+                                 uint16 len_bytes)
+{
+    block_interrupts();
+    {
+        if (ipc_buffer_has_space_for(ipc_data.send, len_bytes))
+        {
+            ipc_send_write(header, msg, len_bytes);
+            ++ipc_data.send_msgs;
+            if (++ipc_data.send_batched >= IPC_SEND_BATCH_MAX)
+            {
+                ipc_send_interrupt();
+            }
         }
         else
         {
@@ -85,4 +135,25 @@ void ipc_try_send_common(const IPC_HEADER *header, const void *msg,
     }
     unblock_interrupts();
 }
+
+void ipc_send_flush(void)
+{
+    block_interrupts();
+    {
+        if (ipc_data.send_batched)
+        {
+            ipc_send_interrupt();
+        }
+    }
+    unblock_interrupts();
+}
+
+void ipc_send_flush_from_switch(void)
+{
+    /* The context switch runs with interrupts already held off */
+    if (ipc_data.send_batched)
+    {
+        ipc_send_interrupt();
+    }
+}
 #endif
@@ -7,6 +7,7 @@
 #include "marshal_object_set.h"
 #include "assert.h"
 #include "pmalloc/pmalloc.h"
+#include <string.h>
 
 #ifdef INSTALL_MARSHAL
 
@@ -15,61 +16,247 @@
 #define BLOCK_SIZE 4
 #define BLOCK_SIZE_DIV_SHIFT 2
 
+/** The maximum number of blocks required to store MOBS_MAX_OBJECTS */
+#define BLOCKS_MAX ((MOBS_MAX_OBJECTS + BLOCK_SIZE - 1) / BLOCK_SIZE)
+
+/** The number of entries allocated when the blocks table is first created */
+#define BLOCKS_INITIAL 4
+
+/** The number of slots allocated when the index is first created. The index is
+ *  doubled in size whenever it becomes half full, so it never needs more than
+ *  512 slots. */
+#define INDEX_SLOTS_INITIAL 16
+
 struct marshal_object_block
 {
-    struct marshal_object_block *next;
     void *address[BLOCK_SIZE];
     marshal_type_t type[BLOCK_SIZE];
     uint8 disambiguator[BLOCK_SIZE];
 };
 
+#define BLOCK(set, index) ((set)->blocks[(index) >> BLOCK_SIZE_DIV_SHIFT])
+#define BLOCK_INDEX(index) ((index) % BLOCK_SIZE)
+
+static void get_object(mobs_t *set, mob_index_t index, mob_t *object)
+{
+    mob_block_t *b = BLOCK(set, index);
+    mob_index_t block_index = BLOCK_INDEX(index);
+
+    object->address = b->address[block_index];
+    object->type = b->type[block_index];
+    object->disambiguator = b->disambiguator[block_index];
+}
+
+static void set_object(mobs_t *set, mob_index_t index, const mob_t *object)
+{
+    mob_block_t *b = BLOCK(set, index);
+    mob_index_t block_index = BLOCK_INDEX(index);
+
+    b->address[block_index] = object->address;
+    b->type[block_index] = object->type;
+    b->disambiguator[block_index] = object->disambiguator;
+}
+
+/* Objects are keyed on address only, so a NULL address can match objects of
+   any type. Objects are word aligned so the low bits carry no information. */
+static uint16 index_home(const mobs_t *set, const void *address)
+{
+    uint32 hash = (uint32)((uintptr_t)address >> 2) * 0x9E3779B1UL;
+    return (uint16)((hash ^ (hash >> 16)) & (set->index_slots - 1));
+}
+
+#define INDEX_NEXT(set, slot) (((slot) + 1) & ((set)->index_slots - 1))
+
+static void index_insert(mobs_t *set, const void *address, mob_index_t index)
+{
+    uint16 slot = index_home(set, address);
+
+    while (set->index[slot] != MOBS_INVALID_INDEX)
+    {
+        slot = INDEX_NEXT(set, slot);
+    }
+    set->index[slot] = index;
+}
+
+static void index_resize(mobs_t *set, uint16 slots)
+{
+    mob_index_t index;
+
+    pfree(set->index);
+    set->index = pmalloc(slots * sizeof(*set->index));
+    set->index_slots = slots;
+    memset(set->index, MOBS_INVALID_INDEX, slots * sizeof(*set->index));
+
+    for (index = 0; index < set->elements; index++)
+    {
+        index_insert(set, BLOCK(set, index)->address[BLOCK_INDEX(index)], index);
+    }
+}
+
+/* Find the lowest index object matching the object's address and type. If
+   any_type is TRUE, a NULL address matches objects of any type. */
+static bool index_find(mobs_t *set, const mob_t *object, bool any_type,
+                       uint16 *slot_p, mob_index_t *index_p)
+{
+    mob_index_t found = MOBS_INVALID_INDEX;
+    uint16 slot;
+
+    if (!set->index_slots)
+    {
+        return FALSE;
+    }
+
+    /* The whole probe sequence is searched as objects of different types may
+       share an address and removals may reorder the sequence */
+    for (slot = index_home(set, object->address);
+         set->index[slot] != MOBS_INVALID_INDEX;
+         slot = INDEX_NEXT(set, slot))
+    {
+        mob_index_t index = set->index[slot];
+        mob_block_t *b = BLOCK(set, index);
+        mob_index_t block_index = BLOCK_INDEX(index);
+
+        if ((b->address[block_index] == object->address) &&
+            ((b->type[block_index] == object->type) ||
+             (any_type && object->address == NULL)) &&
+            (index < found))
+        {
+            found = index;
+            if (slot_p)
+            {
+                *slot_p = slot;
+            }
+        }
+    }
+
+    if (found != MOBS_INVALID_INDEX)
+    {
+        if (index_p)
+        {
+            *index_p = found;
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* Remove an entry from the index, moving later entries in the probe sequence
+   back into the gap so no tombstones are required */
+static void index_delete(mobs_t *set, uint16 gap)
+{
+    uint16 slot = gap;
+
+    for (;;)
+    {
+        mob_index_t index;
+        uint16 home;
+
+        slot = INDEX_NEXT(set, slot);
+        index = set->index[slot];
+        if (index == MOBS_INVALID_INDEX)
+        {
+            break;
+        }
+        home = index_home(set, BLOCK(set, index)->address[BLOCK_INDEX(index)]);
+
+        /* The entry may be moved if its home slot is not cyclically in the
+           range (gap, slot] */
+        if (((slot > gap) && ((home <= gap) || (home > slot))) ||
+            ((slot < gap) && ((home <= gap) && (home > slot))))
+        {
+            set->index[gap] = index;
+            gap = slot;
+        }
+    }
+    set->index[gap] = MOBS_INVALID_INDEX;
+}
+
+/* Find the index slot of the object at the index */
+static uint16 index_slot(mobs_t *set, mob_index_t index)
+{
+    uint16 slot = index_home(set, BLOCK(set, index)->address[BLOCK_INDEX(index)]);
+
+    while (set->index[slot] != index)
+    {
+        assert(set->index[slot] != MOBS_INVALID_INDEX);
+        slot = INDEX_NEXT(set, slot);
+    }
+    return slot;
+}
+
+/* Remove the object at the tail of the set's blocks, the caller is
+   responsible for updating the index */
+static void blocks_pop(mobs_t *set)
+{
+    mob_index_t index = set->elements - 1;
+
+    if (BLOCK_INDEX(index) == 0)
+    {
+        pfree(BLOCK(set, index));
+        BLOCK(set, index) = NULL;
+    }
+    --set->elements;
+}
+
 void mobs_init(mobs_t *set)
 {
-    set->head = NULL;
-    set->tail = NULL;
+    set->blocks = NULL;
+    set->index = NULL;
+    set->index_slots = 0;
+    set->blocks_len = 0;
     set->elements = 0;
 }
 
 void mobs_destroy(mobs_t *set)
 {
-    mob_block_t *block;
-    mob_block_t *next;
-    for (block = set->head; block; block = next)
+    /* Wider than mob_index_t as the index steps past MOBS_MAX_OBJECTS */
+    uint32 index;
+
+    for (index = 0; index < set->elements; index += BLOCK_SIZE)
     {
-        next = block->next;
-        pfree(block);
+        pfree(BLOCK(set, index));
     }
-    set->head = NULL;
-    set->tail = NULL;
-    set->elements = 0;
+    pfree(set->blocks);
+    pfree(set->index);
+    mobs_init(set);
 }
 
 void mobs_push_unique(mobs_t *set, mob_t *object)
 {
-    mob_block_t *tail = set->tail;
-    mob_index_t index = set->elements % BLOCK_SIZE;
+    mob_index_t index = set->elements;
 
     /* Limit size of set */
     assert(set->elements < MOBS_MAX_OBJECTS);
 
-    if (index == 0)
+    if (BLOCK_INDEX(index) == 0)
     {
-        tail = pmalloc(sizeof(*tail));
-        tail->next = NULL;
-        if (!set->head)
-        {
-            set->head = set->tail = tail;
-        }
-        else
+        uint8 block = index >> BLOCK_SIZE_DIV_SHIFT;
+
+        if (block == set->blocks_len)
         {
-            set->tail = set->tail->next = tail;
+            uint8 len = set->blocks_len ? set->blocks_len * 2 : BLOCKS_INITIAL;
+
+            if (len > BLOCKS_MAX)
+            {
+                len = BLOCKS_MAX;
+            }
+            set->blocks = prealloc(set->blocks, len * sizeof(*set->blocks));
+            set->blocks_len = len;
         }
+        set->blocks[block] = pmalloc(sizeof(mob_block_t));
     }
-    tail->address[index] = object->address;
-    tail->type[index] = object->type;
-    tail->disambiguator[index] = object->disambiguator;
-
+    set_object(set, index, object);
     set->elements++;
+
+    /* Keep the index at most half full */
+    if ((set->elements * 2) > set->index_slots)
+    {
+        index_resize(set, set->index_slots ? set->index_slots * 2 : INDEX_SLOTS_INITIAL);
+    }
+    else
+    {
+        index_insert(set, object->address, index);
+    }
 }
 
 bool mobs_push(mobs_t *set, mob_t *object)
@@ -85,181 +272,81 @@ bool mobs_push(mobs_t *set, mob_t *object)
 
 bool mobs_pop(mobs_t *set, mob_t *object)
 {
-    mob_block_t *tail = set->tail;
-    mob_index_t index = (set->elements - 1) % BLOCK_SIZE;
-
     if (set->elements)
     {
-        if (object)
-        {
-            object->address = tail->address[index];
-            object->type = tail->type[index];
-            object->disambiguator = tail->disambiguator[index];
-        }
+        mob_index_t index = set->elements - 1;
 
-        if (index == 0)
+        if (object)
         {
-            if (set->head == tail)
-            {
-                pfree(tail);
-                set->head = set->tail = NULL;
-            }
-            else
-            {
-                mob_block_t **b;
-                for (b = &set->head; (*b)->next != tail; b = &(*b)->next)
-                    ;
-                pfree((*b)->next);
-                (*b)->next = NULL;
-                set->tail = *b;
-            }
+            get_object(set, index, object);
         }
-        --set->elements;
+        index_delete(set, index_slot(set, index));
+        blocks_pop(set);
         return TRUE;
     }
     return FALSE;
 }
 
-/* A consequence of using blocks (versus a single element list) is inefficient
-   object removal, since elements after the removed have to be 'shunted' into
-   the place of the removed element */
+/* Elements after the removed element have to be 'shunted' into the place of
+   the removed element, and their entries in the index updated to match */
 bool mobs_remove(mobs_t *set, const mob_t *object)
 {
+    mob_index_t removed;
     mob_index_t index;
-    mob_block_t *b = set->head;
-
-    /* Two element pipeline of values for shunting across blocks boundaries */
-    void **addr0 = b->address;
-    void **addr1;
-    marshal_type_t *type0 = b->type;
-    marshal_type_t *type1;
-    uint8 *disam0 = b->disambiguator;
-    uint8 *disam1;
+    uint16 slot;
 
-    bool shunt = FALSE;
-
-    for (index = 0; index < set->elements; index++)
+    if (!index_find(set, object, FALSE, &slot, &removed))
     {
-        mob_index_t block_index = index % BLOCK_SIZE;
+        return FALSE;
+    }
 
-        if (!block_index)
-        {
-            if (index)
-            {
-                b = b->next;
-                assert(b);
-            }
-        }
-        /* Pass addresses down the pipeline */
-        addr1 = addr0;
-        type1 = type0;
-        disam1 = disam0;
-        addr0 = b->address + block_index;
-        type0 = b->type + block_index;
-        disam0 = b->disambiguator + block_index;
-
-        if (shunt)
-        {
-            /* Overwrite previous index's values with this index's values */
-            *addr1 = *addr0;
-            *type1 = *type0;
-            *disam1 = *disam0;
-        }
-        else if ((*addr0 == object->address) && (*type0 == object->type))
+    index_delete(set, slot);
+    for (slot = 0; slot < set->index_slots; slot++)
+    {
+        index = set->index[slot];
+        if ((index != MOBS_INVALID_INDEX) && (index > removed))
         {
-            shunt = TRUE;
+            set->index[slot] = index - 1;
         }
     }
-    if (shunt)
+
+    for (index = removed + 1; index < set->elements; index++)
     {
-        assert_fn(mobs_pop(set, NULL));
-        return TRUE;
+        mob_t shunted;
+        get_object(set, index, &shunted);
+        set_object(set, index - 1, &shunted);
     }
-    return FALSE;
+    blocks_pop(set);
+    return TRUE;
 }
 
 void mobs_difference_update(mobs_t *set, const mobs_t *remove)
 {
     mob_index_t index;
-    mob_block_t *b = remove->head;
 
     for (index = 0; index < remove->elements; index++)
     {
-        mob_index_t block_index = index % BLOCK_SIZE;
         mob_t object;
 
-        object.address = b->address[block_index];
-        object.type = b->type[block_index];
+        get_object((mobs_t *)remove, index, &object);
         /* Don't care if object was actually removed */
         (void)mobs_remove(set, &object);
-
-        if (block_index == (BLOCK_SIZE - 1))
-        {
-            b = b->next;
-        }
     }
 }
 
 bool mobs_has_object(mobs_t *set, const mob_t *object, mob_index_t *index_p)
 {
-    mob_index_t index;
-    mob_block_t *b = set->head;
-
-    for (index = 0; index < set->elements; index++)
-    {
-        mob_index_t block_index = index % BLOCK_SIZE;
-
-        if (object->address == b->address[block_index])
-        {
-            /* NULL address matches all types */
-            if ((b->type[block_index] == object->type) || (object->address == NULL))
-            {
-                if (index_p)
-                {
-                    *index_p = index;
-                }
-                return TRUE;
-            }
-        }
-
-        if (block_index == (BLOCK_SIZE - 1))
-        {
-            b = b->next;
-        }
-    }
-    return FALSE;
-}
-
-static mob_block_t *get_block(mobs_t *set, mob_index_t index)
-{
-    mob_block_t *b = NULL;
-
-    if (index < set->elements)
-    {
-        uint32 steps = index >> BLOCK_SIZE_DIV_SHIFT;
-        b = set->head;
-        while (steps--)
-        {
-            if (b)
-            {
-                b = b->next;
-            }
-        }
-    }
-    return b;
+    /* NULL address matches all types */
+    return index_find(set, object, TRUE, NULL, index_p);
 }
 
 bool mobs_get_object(mobs_t *set, mob_index_t index, mob_t *object)
 {
-    mob_block_t *b = get_block(set, index);
-    if (b)
+    if (index < set->elements)
     {
         if (object)
         {
-            mob_index_t block_index = index % BLOCK_SIZE;
-            object->address = b->address[block_index];
-            object->type = b->type[block_index];
-            object->disambiguator = b->disambiguator[block_index];
+            get_object(set, index, object);
         }
         return TRUE;
     }
@@ -268,27 +355,17 @@ bool mobs_get_object(mobs_t *set, mob_index_t index, mob_t *object)
 
 bool mobs_iterate(mobs_t *set, mob_index_t start, mobs_callback_t cb)
 {
-    mob_block_t *b = get_block(set, start);
-    if (b)
+    /* The callback may push objects, growing the blocks table, so the object
+       is fetched through the table on each iteration */
+    for ( ; start < set->elements; start++)
     {
-        for ( ; start < set->elements; start++)
-        {
-            mob_t object;
-            mob_index_t block_index = start % BLOCK_SIZE;
+        mob_t object;
 
-            object.address = b->address[block_index];
-            object.type = b->type[block_index];
-            object.disambiguator = b->disambiguator[block_index];
+        get_object(set, start, &object);
 
-            if (!cb(set, start, &object))
-            {
-                return FALSE;
-            }
-
-            if (block_index == (BLOCK_SIZE - 1))
-            {
-                b = b->next;
-            }
+        if (!cb(set, start, &object))
+        {
+            return FALSE;
         }
     }
     return TRUE;
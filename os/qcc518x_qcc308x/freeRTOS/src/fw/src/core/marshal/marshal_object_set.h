@@ -42,16 +42,28 @@ typedef struct marshal_object
  */
 typedef uint8 mob_index_t;
 
+/** Index value used to mark an unused slot in the object set's address index */
+#define MOBS_INVALID_INDEX ((mob_index_t)MOBS_MAX_OBJECTS)
+
 /** Opaque forward declaration of object block used in the object set */
 typedef struct marshal_object_block mob_block_t;
 
-/** The marshal object set stores unique marshal objects in a linked list of
- *  marshal object blocks.
+/** The marshal object set stores unique marshal objects in blocks of marshal
+ *  objects. A table of block pointers gives constant time access to the
+ *  object at any index and an open addressing hash table, keyed on the object
+ *  address, gives constant time (on average) membership tests.
  */
 typedef struct marshal_object_set
 {
-    mob_block_t *head;
-    mob_block_t *tail;
+    /** Table of pointers to the blocks holding the objects, in index order */
+    mob_block_t **blocks;
+    /** Hash table mapping object addresses to their index in the set.
+     *  Unused slots are set to MOBS_INVALID_INDEX. */
+    mob_index_t *index;
+    /** Number of slots in the index, zero or a power of two */
+    uint16 index_slots;
+    /** Number of entries allocated in the blocks table */
+    uint8 blocks_len;
     mob_index_t elements;
 } mobs_t;
 
@@ -37,6 +37,16 @@ void *pmalloc_blocks;
 size_t pmalloc_total_blocks;
 #endif
 
+/** Pool lookup tables for pmalloc() and pfree() */
+uint8 pmalloc_size_class[PMALLOC_SIZE_CLASSES];
+uint8 pmalloc_addr_class[PMALLOC_ADDR_CLASSES];
+
+#ifdef PMALLOC_STATS
+/** Count of pool lookups by table and by search */
+uint32 pmalloc_class_lookups;
+uint32 pmalloc_class_searches;
+#endif
+
 #ifdef PMALLOC_MONITOR_POOLS
 /** Monitoring of number of free blocks in a range of pools */
 const pmalloc_pool *pmalloc_monitored_pool_low;
@@ -159,6 +169,44 @@ void pmalloc_configure(pmalloc_pool_config *pool_config, unsigned pool_config_le
     }
 }
 
+/**
+ * Build the pool lookup tables once the pools have been configured. Relies
+ * on the pools being in order of increasing size and address.
+ */
+static void pmalloc_build_classes(void)
+{
+    const pmalloc_pool *pools_end = pmalloc_pools + pmalloc_num_pools;
+    const pmalloc_pool *pool;
+    size_t i;
+
+    /* Each size class starts with the smallest request it contains */
+    pool = pmalloc_pools;
+    for (i = 0; i < PMALLOC_SIZE_CLASSES; ++i)
+    {
+        size_t smallest = i ? (i - 1) * PMALLOC_ALIGN_BOUNDARY + 1 : 0;
+
+        while ((pool < pools_end) && (pool->size < smallest))
+        {
+            ++pool;
+        }
+        pmalloc_size_class[i] = (uint8)(pool - pmalloc_pools);
+    }
+
+    /* Each region starts with the first pool that hasn't ended before it */
+    pool = pmalloc_pools;
+    for (i = 0; i < PMALLOC_ADDR_CLASSES; ++i)
+    {
+        const char *start = (const char *) pmalloc_blocks
+                            + (i << PMALLOC_ADDR_CLASS_SHIFT);
+
+        while ((pool < pools_end) && ((const char *) pool->pool_end <= start))
+        {
+            ++pool;
+        }
+        pmalloc_addr_class[i] = (uint8)(pool - pmalloc_pools);
+    }
+}
+
 /**
   NAME
   init_pmalloc  -  initialse the private memory allocator
@@ -183,6 +231,9 @@ void init_pmalloc(void)
        (have to do this after the pools have been configured) */
     pools_end = pmalloc_pools + pmalloc_num_pools;
 
+    /* pfree() below needs the lookup tables */
+    pmalloc_build_classes();
+
 #ifdef PMALLOC_CUMULATIVE_BLOCKS
     pmalloc_total_blocks = 0;
 #endif
@@ -227,9 +278,16 @@ void init_pmalloc(void)
 #ifdef PMALLOC_STATS
         pool->max_ideal_size = 0;
         pool->curr_ideal_size = 0;
+        pool->hits = 0;
+        pool->spills = 0;
 #endif
     }
 
+#ifdef PMALLOC_STATS
+    pmalloc_class_lookups = 0;
+    pmalloc_class_searches = 0;
+#endif
+
 #ifdef PMALLOC_RECORD_USAGE_LEVEL
     pmalloc_current_bytes_out = 0;
     pmalloc_highest_bytes_out = 0;
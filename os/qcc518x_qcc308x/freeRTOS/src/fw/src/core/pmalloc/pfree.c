@@ -36,6 +36,10 @@ void pfree(void *ptr)
     size_t n;
     uint16 rmdr;
     pmalloc_pool *pool;
+    size_t region;
+#ifdef PMALLOC_STATS
+    bool looked_up = FALSE;
+#endif
 
 #ifdef IPC_MODULE_PRESENT
     /* For convenience we allow the processors not to care about whether a
@@ -68,9 +72,20 @@ void pfree(void *ptr)
             /* Initialising here helps the compiler to generate better code */
             pool = pmalloc_pools;
 
+            /* Start from the first pool overlapping the pointer's region, the
+               search below then only has to step over pools within it */
+            region = (size_t)((char *) ptr - (char *) pmalloc_blocks)
+                     >> PMALLOC_ADDR_CLASS_SHIFT;
+            if (region < PMALLOC_ADDR_CLASSES)
+            {
+                pool += pmalloc_addr_class[region];
+#ifdef PMALLOC_STATS
+                looked_up = TRUE;
+#endif
+            }
             /* Unroll the first few iterations of the search loop for speed */
             /*lint -e{960} continue statement used */
-            if (6 <= pmalloc_num_pools)
+            else if (6 <= pmalloc_num_pools)
             {
                 if (pool[0].pool_end <= ptr)
                 {
@@ -180,6 +195,15 @@ void pfree(void *ptr)
     PMALLOC_BLOCK_INTERRUPTS();
 
 #ifdef PMALLOC_STATS
+    if (looked_up)
+    {
+        ++pmalloc_class_lookups;
+    }
+    else
+    {
+        ++pmalloc_class_searches;
+    }
+
     if (n < PMALLOC_MAX_DEBUG_BLOCKS)
     {
         /* Work out which pool we theoretically would have stored it in... */
@@ -120,6 +120,14 @@ typedef struct pmalloc_pool
     /** How big the pool needed to be to prevent overflows */
     uint16 max_ideal_size;
     uint16 curr_ideal_size;
+
+    /** Allocations for which this was the ideal pool and it had a free
+        block */
+    uint32 hits;
+
+    /** Allocations for which this was the ideal pool but it was empty, so a
+        block was taken from a larger pool (or none was available) */
+    uint32 spills;
 #endif /* PMALLOC_STATS */
 
 } pmalloc_pool;
@@ -139,6 +147,56 @@ extern size_t pmalloc_total_blocks;
 /** Pointer to the first block in the first pool */
 extern void *pmalloc_blocks;
 
+/**
+ * Requests of up to this many bytes find their ideal pool with a single
+ * lookup in pmalloc_size_class[] instead of searching the pool control
+ * blocks. Larger requests fall back to the search.
+ */
+#ifndef PMALLOC_SIZE_CLASS_MAX
+#define PMALLOC_SIZE_CLASS_MAX (256)
+#endif
+
+/** Size class of a request, pool block sizes are multiples of the alignment
+    so requests are grouped in steps of it */
+#define PMALLOC_SIZE_CLASS(size) \
+    (((size) + PMALLOC_ALIGN_BOUNDARY - 1) / PMALLOC_ALIGN_BOUNDARY)
+#define PMALLOC_SIZE_CLASSES (PMALLOC_SIZE_CLASS(PMALLOC_SIZE_CLASS_MAX) + 1)
+
+/**
+ * Index of the first pool with blocks large enough for the smallest request
+ * in each size class, or pmalloc_num_pools if there is no such pool. Built by
+ * init_pmalloc().
+ */
+extern uint8 pmalloc_size_class[PMALLOC_SIZE_CLASSES];
+
+/**
+ * pfree() finds the pool containing a pointer by dividing the pool memory
+ * into regions of (1 << PMALLOC_ADDR_CLASS_SHIFT) bytes and looking up the
+ * first pool that overlaps the pointer's region, so at most the pools
+ * within one region need to be compared. Pointers beyond the regions
+ * covered fall back to searching the pool control blocks.
+ */
+#ifndef PMALLOC_ADDR_CLASS_SHIFT
+#define PMALLOC_ADDR_CLASS_SHIFT (9)
+#endif
+#ifndef PMALLOC_ADDR_CLASSES
+#define PMALLOC_ADDR_CLASSES (256)
+#endif
+
+/**
+ * Index of the first pool ending after the start of each region, or
+ * pmalloc_num_pools if the region lies beyond the last pool. Built by
+ * init_pmalloc().
+ */
+extern uint8 pmalloc_addr_class[PMALLOC_ADDR_CLASSES];
+
+#ifdef PMALLOC_STATS
+/** Number of pool lookups served by pmalloc_size_class[] and
+    pmalloc_addr_class[], and the number that had to search instead */
+extern uint32 pmalloc_class_lookups;
+extern uint32 pmalloc_class_searches;
+#endif
+
 #ifdef PMALLOC_MONITOR_POOLS
 /** Monitoring of number of free blocks in a range of pools */
 extern const pmalloc_pool *pmalloc_monitored_pool_low;
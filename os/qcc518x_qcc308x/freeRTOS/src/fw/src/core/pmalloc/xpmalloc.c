@@ -26,6 +26,7 @@ void *PMALLOC_TRACE_FN(xpmalloc, size_t size, pmalloc_owner_ref owner)
     pmalloc_pool *pool;
 #ifdef PMALLOC_STATS
     pmalloc_pool *ideal_pool;
+    bool looked_up = FALSE;
 #endif    
 #ifdef PMALLOC_RECORD_LENGTHS
     size_t requested_size = size;
@@ -66,6 +67,27 @@ void *PMALLOC_TRACE_FN(xpmalloc, size_t size, pmalloc_owner_ref owner)
         /* Initialising here helps the compiler to generate better code */
         pool = pmalloc_pools;
 
+        /* Most requests are small enough to look the pool up directly */
+        /*lint -e{960} continue statement used */
+        if (size <= PMALLOC_SIZE_CLASS_MAX)
+        {
+            pool += pmalloc_size_class[PMALLOC_SIZE_CLASS(size)];
+            /* A pool whose block size isn't a multiple of the alignment
+               splits a size class, so step over it if it's too small */
+            while ((pool < pools_end) && (pool->size < size))
+            {
+                ++pool;
+            }
+            if (pools_end <= pool)
+            {
+                return NULL;
+            }
+#ifdef PMALLOC_STATS
+            looked_up = TRUE;
+#endif
+            continue;
+        }
+
         /* Unroll the first few iterations of the search loop for speed */
         /*lint -e{960} continue statement used */
         if (6 <= pmalloc_num_pools)
@@ -184,6 +206,26 @@ void *PMALLOC_TRACE_FN(xpmalloc, size_t size, pmalloc_owner_ref owner)
             /* Update the count of allocated blocks in this pool */
             ++(pool->allocated);
 
+#ifdef PMALLOC_STATS
+            /* Record whether the ideal pool served the request */
+            if (pool == ideal_pool)
+            {
+                ++(pool->hits);
+            }
+            else
+            {
+                ++(ideal_pool->spills);
+            }
+            if (looked_up)
+            {
+                ++pmalloc_class_lookups;
+            }
+            else
+            {
+                ++pmalloc_class_searches;
+            }
+#endif
+
 #ifdef PMALLOC_RECORD_USAGE_LEVEL
             pmalloc_current_bytes_out += pool->size;
             if (pmalloc_highest_bytes_out < pmalloc_current_bytes_out)
@@ -296,5 +338,10 @@ void *PMALLOC_TRACE_FN(xpmalloc, size_t size, pmalloc_owner_ref owner)
     } while (++pool < pools_end);
 
     /* No free blocks if this point reached */
+#ifdef PMALLOC_STATS
+    PMALLOC_BLOCK_INTERRUPTS();
+    ++(ideal_pool->spills);
+    PMALLOC_UNBLOCK_INTERRUPTS();
+#endif
     return NULL;
 }
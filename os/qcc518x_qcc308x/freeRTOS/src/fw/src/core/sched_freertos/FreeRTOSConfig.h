@@ -107,6 +107,13 @@
         vApplicationPostSleepProcessingHook(x); \
     } while(0)
 
+/**
+ * Qualcomm Hydra chips batch IPC messages to P0 while a task is running, the
+ * batch is sent as soon as the task stops running for any reason.
+ */
+void vApplicationTaskSwitchedOutHook(void);
+#define traceTASK_SWITCHED_OUT() vApplicationTaskSwitchedOutHook()
+
 /**
  * Qualcomm Hydra chips do not require a tick hook.
  */
@@ -8,8 +8,10 @@
 #include "hydra_log/hydra_log.h"
 #include "pmalloc/pmalloc.h"
 #include "dorm/dorm.h"
+#include "ipc/ipc.h"
 #include "pl_timers/pl_timers_private.h"
 #include "trap_api/messaging.h"
+#include "trap_api/message_worker.h"
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -139,6 +141,7 @@ void init_sched(void)
     hal_set_reg_allow_goto_shallow_sleep(1);
 
     vm_task_create();
+    init_message_worker();
 }
 
 static void vm_task_create(void)
@@ -207,6 +210,11 @@ static void service_queue_events(message_queue_events_t events)
     {
         publish_faults_bg();
     }
+
+    if(events & (1 << vm_continuation))
+    {
+        message_continuation_bg();
+    }
 }
 
 void raise_bg_int(uint32 bg_int)
@@ -236,6 +244,17 @@ void vApplicationStackOverflowHook(TaskHandle_t task, char *name)
 }
 #endif
 
+/**
+ * See sched_freertos_hooks.h for documentation
+ */
+void vApplicationTaskSwitchedOutHook(void)
+{
+    /* P0 is only interrupted for batched IPC messages once the batch is full
+       or the sender stops running, whether it blocked or was preempted.
+       Interrupts are already held off by the context switch. */
+    ipc_send_flush_from_switch();
+}
+
 /**
  * See sched_freertos_hooks.h for documentation
  */
@@ -49,6 +49,12 @@ typedef enum bg_ints_ids_enum
      */
     fault_publish,
 
+    /**
+     * Background interrupt for running a slice of VM task continuation work.
+     * Handler: message_continuation_bg
+     */
+    vm_continuation,
+
     /**
      * Casual timers are handled slightly differently to other BG Ints, they are
      * processed every time the VM task gets a message or event. This entry
@@ -84,6 +90,14 @@ void appcmd_background_handler(void);
  */
 void publish_faults_bg(void);
 
+/**
+ * Run a slice of the next pending VM task continuation, see
+ * message_continuation.h.
+ *
+ * BG Int: vm_continuation
+ */
+void message_continuation_bg(void);
+
 /**
  * Functions for sending Background Interrupts
  */
@@ -162,7 +176,7 @@ bool sched_get_sleep_deadline(TIME *earliest, TIME *latest);
 /**
  * \brief Initialise the scheduler.
  *
- * Creates the VM task.
+ * Creates the VM task and the worker task.
  * The scheduler does not start running until sched() is called.
  */
 void init_sched(void);
@@ -219,6 +233,10 @@ typedef enum sched_task_priority_
     /** Lowest possible priority. */
     SCHED_TASK_PRIORITY_IDLE       = 0,
 
+    /** Priority for the worker task, below the VM task so that jobs posted
+        with MessageWorkerPost() never delay VM task messages. */
+    SCHED_TASK_PRIORITY_WORKER     = 1,
+
     /** Priority for the VM task, should be at least 2 so applications could
         create low priority tasks that are lower than the VM priority but above
         idle priority. */
@@ -35,6 +35,17 @@ TickType_t vApplicationPreSleepProcessingHook(TickType_t idle_ticks);
  */
 void vApplicationPostSleepProcessingHook(TickType_t idle_ticks);
 
+/**
+ * \brief Called by FreeRTOS through traceTASK_SWITCHED_OUT() whenever the
+ * running task is switched out.
+ *
+ * Sends any IPC messages the task batched with ipc_send_batched().
+ *
+ * NOTE: This is called from the context switch, so it must be short and
+ * MUST NOT call a FreeRTOS API.
+ */
+void vApplicationTaskSwitchedOutHook(void);
+
 /**
  * \brief Called by the FreeRTOS Idle task.
  *
@@ -0,0 +1,182 @@
+/* Copyright (c) 2020 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+
+/**
+ * \file
+ *
+ * Implementation of continuation work for VM tasks.
+ */
+
+#include "assert.h"
+#include "message_continuation.h"
+#include "messaging.h"
+#include "hydra_log/hydra_log.h"
+#include "pmalloc/pmalloc.h"
+#include "sched/sched.h"
+
+/**
+ * A pending continuation.
+ */
+typedef struct message_continuation_
+{
+    /** The next continuation to run. */
+    struct message_continuation_ *next;
+
+    /** The task the continuation is working for. */
+    Task task;
+
+    /** The slice function. */
+    MessageContinuationFn fn;
+
+    /** Passed to \c fn. */
+    void *context;
+} message_continuation_t;
+
+/**
+ * Continuations waiting for a slice, in the order they will run.
+ *
+ * Only accessed from the VM task so no locking is required.
+ */
+static message_continuation_t *pending_head;
+static message_continuation_t *pending_tail;
+
+/**
+ * The continuation whose slice is currently running, it isn't on the pending
+ * list while it runs.
+ */
+static message_continuation_t *running;
+
+/**
+ * Set if the running continuation is cancelled by its own slice.
+ */
+static bool running_cancelled;
+
+/**
+ * \brief Append a continuation to the pending list.
+ *
+ * \param [in] continuation  The continuation to append.
+ */
+static void message_continuation_append(message_continuation_t *continuation)
+{
+    continuation->next = NULL;
+    if(NULL == pending_tail)
+    {
+        pending_head = continuation;
+    }
+    else
+    {
+        pending_tail->next = continuation;
+    }
+    pending_tail = continuation;
+}
+
+bool message_continuation_post(Task task, MessageContinuationFn fn,
+                               void *context)
+{
+    message_continuation_t *continuation;
+
+    assert(fn);
+    assert(!sched_is_running() || sched_in_vm_task());
+
+    if(NULL != running && !running_cancelled &&
+       running->task == task && running->fn == fn)
+    {
+        return FALSE;
+    }
+    for(continuation = pending_head;
+        NULL != continuation;
+        continuation = continuation->next)
+    {
+        if(continuation->task == task && continuation->fn == fn)
+        {
+            return FALSE;
+        }
+    }
+
+    continuation = pnew(message_continuation_t);
+    continuation->task = task;
+    continuation->fn = fn;
+    continuation->context = context;
+    message_continuation_append(continuation);
+
+    GEN_BG_INT(vm_continuation);
+    return TRUE;
+}
+
+uint16 message_continuation_cancel(Task task)
+{
+    message_continuation_t **pcontinuation = &pending_head;
+    uint16 count = 0;
+
+    pending_tail = NULL;
+    while(NULL != *pcontinuation)
+    {
+        message_continuation_t *continuation = *pcontinuation;
+
+        if(continuation->task == task)
+        {
+            *pcontinuation = continuation->next;
+            pfree(continuation);
+            ++count;
+        }
+        else
+        {
+            pending_tail = continuation;
+            pcontinuation = &continuation->next;
+        }
+    }
+
+    if(NULL != running && !running_cancelled && running->task == task)
+    {
+        running_cancelled = TRUE;
+        ++count;
+    }
+
+    return count;
+}
+
+void message_continuation_bg(void)
+{
+    TIME started;
+    uint32 elapsed_us;
+    bool more;
+
+    running = pending_head;
+    if(NULL == running)
+    {
+        /* Everything was cancelled after the BG int was raised. */
+        return;
+    }
+    pending_head = running->next;
+    if(NULL == pending_head)
+    {
+        pending_tail = NULL;
+    }
+    running_cancelled = FALSE;
+
+    started = get_time();
+    more = running->fn(running->task, running->context);
+    elapsed_us = (uint32)time_sub(get_time(), started);
+
+    if(messaging_handler_over_budget(elapsed_us))
+    {
+        L1_DBG_MSG3("messaging: continuation 0x%08x for task 0x%08x took %u us",
+                    (uint32)running->fn, (uint32)running->task, elapsed_us);
+    }
+
+    if(more && !running_cancelled)
+    {
+        message_continuation_append(running);
+    }
+    else
+    {
+        pfree(running);
+    }
+    running = NULL;
+
+    if(NULL != pending_head)
+    {
+        /* Come back for the next slice after the next message, if any. */
+        GEN_BG_INT(vm_continuation);
+    }
+}
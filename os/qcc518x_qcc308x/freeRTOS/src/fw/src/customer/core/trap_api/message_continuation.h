@@ -0,0 +1,53 @@
+/* Copyright (c) 2020 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+
+/**
+ * \file
+ *
+ * Continuation work for VM tasks.
+ *
+ * All VM task handlers run to completion on the single VM task, so a handler
+ * that does a lot of work in one go delays every other message. Instead a
+ * handler can post a continuation, a function that does a bounded slice of the
+ * work each time it is called. The VM task calls one slice after each message
+ * it delivers, taking pending continuations in turn, until the continuation
+ * reports that it has finished. Messages that become due while there is
+ * continuation work are therefore delayed by at most one slice.
+ */
+
+#ifndef MESSAGE_CONTINUATION_H_
+#define MESSAGE_CONTINUATION_H_
+
+#include <message.h>
+
+#include "hydra/hydra_types.h"
+
+/**
+ * \brief Post a continuation for a VM task.
+ *
+ * Must be called from the VM task.
+ *
+ * \param [in] task  The task the continuation is working for, passed to
+ * \p fn and used to cancel it.
+ * \param [in] fn  Called once per slice, returns TRUE while there is more work
+ * to do and FALSE once it has finished.
+ * \param [in] context  Passed to \p fn.
+ *
+ * \return TRUE if the continuation was posted, FALSE if the same \p task and
+ * \p fn pair is already pending, in which case its context is unchanged.
+ */
+bool message_continuation_post(Task task, MessageContinuationFn fn,
+                               void *context);
+
+/**
+ * \brief Cancel all the continuations for a VM task.
+ *
+ * May be called from a continuation, including to cancel itself.
+ *
+ * \param [in] task  The task to cancel continuations for.
+ *
+ * \return The number of continuations cancelled.
+ */
+uint16 message_continuation_cancel(Task task);
+
+#endif /* !MESSAGE_CONTINUATION_H_ */
@@ -12,6 +12,71 @@
 #include "pmalloc/pmalloc.h"
 #include "pl_timers/pl_timers.h"
 
+#include <string.h>
+
+/**
+ * log2 of the number of milliseconds covered by a slot of a timer wheel level.
+ */
+#define MESSAGE_QUEUE_SLOT_MS_LOG2(level) \
+    (MESSAGE_QUEUE_WHEEL_SLOT_MS_LOG2 + \
+     (level) * MESSAGE_QUEUE_WHEEL_SLOTS_LOG2)
+
+/**
+ * The number of milliseconds covered by a slot of a timer wheel level.
+ */
+#define MESSAGE_QUEUE_SLOT_MS(level) \
+    ((MILLITIME)1 << MESSAGE_QUEUE_SLOT_MS_LOG2(level))
+
+/**
+ * The slot of a timer wheel level for a time.
+ */
+#define MESSAGE_QUEUE_SLOT(level, ms) \
+    (((ms) >> MESSAGE_QUEUE_SLOT_MS_LOG2(level)) & \
+     (MESSAGE_QUEUE_WHEEL_SLOTS - 1))
+
+/**
+ * The start of the slot of a timer wheel level containing a time.
+ */
+#define MESSAGE_QUEUE_SLOT_START(level, ms) \
+    ((ms) & ~(MESSAGE_QUEUE_SLOT_MS(level) - 1))
+
+/**
+ * The top level of the timer wheel.
+ */
+#define MESSAGE_QUEUE_TOP_LEVEL (MESSAGE_QUEUE_WHEEL_LEVELS - 1)
+
+/**
+ * The number of lists holding unconditional messages in delivery order. The
+ * slots of the lowest level, the slots following the current slot of each
+ * higher level, and the overflow list.
+ */
+#define MESSAGE_QUEUE_RANKS \
+    (MESSAGE_QUEUE_WHEEL_LEVELS * (MESSAGE_QUEUE_WHEEL_SLOTS - 1) + 2)
+
+/**
+ * Test whether a list is kept sorted. Lists in the higher levels of the wheel
+ * are sorted when they move down to the lowest level.
+ */
+#define MESSAGE_QUEUE_LIST_IS_SORTED(list) \
+    ((list) < MESSAGE_QUEUE_WHEEL_SLOTS || \
+     MESSAGE_QUEUE_LIST_OVERFLOW <= (list))
+
+/**
+ * Test whether a list index refers to a conditional message group.
+ */
+#define MESSAGE_QUEUE_LIST_IS_GROUP(list) \
+    (MESSAGE_QUEUE_LIST_CONDITION(0) <= (list) && \
+     (list) < MESSAGE_QUEUE_LIST_UNGROUPED)
+
+/**
+ * The most messages message_queue_preceding() looks at to find the message
+ * delivered before a new one, so that sending a message blocks interrupts
+ * for a bounded time however many messages are queued.
+ */
+#ifndef MESSAGE_QUEUE_PRECEDING_VISITS_MAX
+#define MESSAGE_QUEUE_PRECEDING_VISITS_MAX (16)
+#endif
+
 /**
  * \brief Test if a message is already in the queue.
  *
@@ -126,6 +191,664 @@ static void message_queue_kick(message_queue_t *queue);
  */
 static void message_queue_wait(const message_queue_t *queue);
 
+/**
+ * \brief Block interrupts for a message queue operation.
+ *
+ * \return The time interrupts were blocked at, if message telemetry is
+ * installed.
+ */
+static TIME message_queue_lock(void)
+{
+    block_interrupts();
+#ifdef INSTALL_MESSAGE_TELEMETRY
+    return get_time();
+#else /* INSTALL_MESSAGE_TELEMETRY */
+    return 0;
+#endif /* INSTALL_MESSAGE_TELEMETRY */
+}
+
+/**
+ * \brief Unblock interrupts after a message queue operation.
+ *
+ * If message telemetry is installed, how long interrupts were blocked for is
+ * recorded in the queue's statistics, even for operations that don't
+ * otherwise modify the queue.
+ *
+ * \param [in] queue  The queue the operation was on.
+ * \param [in] locked_at  The time returned by message_queue_lock().
+ */
+static void message_queue_unlock(const message_queue_t *queue, TIME locked_at)
+{
+#ifdef INSTALL_MESSAGE_TELEMETRY
+    message_queue_stats_t *stats = (message_queue_stats_t *)&queue->stats;
+    uint32 blocked_us = (uint32)time_sub(get_time(), locked_at);
+
+    if(blocked_us > stats->max_blocked_us)
+    {
+        stats->max_blocked_us = blocked_us;
+    }
+#else /* INSTALL_MESSAGE_TELEMETRY */
+    UNUSED(queue);
+    UNUSED(locked_at);
+#endif /* INSTALL_MESSAGE_TELEMETRY */
+    unblock_interrupts();
+}
+
+/**
+ * \brief Choose whichever of two task messages is to be delivered first.
+ *
+ * \param [in] first  The earliest task message found so far, may be NULL.
+ * \param [in] task_message  A task message to compare against \p first.
+ *
+ * \return \p task_message if it is due before \p first, or is due at the same
+ * time but was sent earlier, otherwise \p first.
+ */
+static message_queue_task_message_t *message_queue_earlier(
+    message_queue_task_message_t *first,
+    message_queue_task_message_t *task_message)
+{
+    INTERVAL diff_ms;
+
+    if(NULL == first)
+    {
+        return task_message;
+    }
+
+    /* The sequence numbers are 24 bits, shift the difference up to compare
+       them across a wrap. */
+    diff_ms = time_sub(task_message->message->due_ms, first->message->due_ms);
+    if(diff_ms < 0 ||
+       (0 == diff_ms &&
+        (int32)((uint32)(task_message->seq - first->seq) << 8) < 0))
+    {
+        return task_message;
+    }
+
+    return first;
+}
+
+/**
+ * \brief Get the index of the per-task index bucket for a task.
+ */
+static uint8 message_queue_task_bucket(Task task)
+{
+    uint32 hash = (uint32)(uintptr)task;
+
+    hash ^= hash >> 7;
+    return (uint8)((hash >> 2) & (MESSAGE_QUEUE_TASK_BUCKETS - 1));
+}
+
+/**
+ * \brief Get the unconditional message list at a position in delivery order.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] rank  The position of the list, from 0 for the current slot of
+ * the lowest level to MESSAGE_QUEUE_RANKS - 1 for the overflow list.
+ *
+ * \return The index of the list.
+ */
+static uint8 message_queue_unconditional_list(const message_queue_t *queue,
+                                              uint8 rank)
+{
+    uint8 level;
+
+    if(rank < MESSAGE_QUEUE_WHEEL_SLOTS)
+    {
+        return MESSAGE_QUEUE_LIST_WHEEL(0, rank);
+    }
+
+    rank -= MESSAGE_QUEUE_WHEEL_SLOTS;
+    level = (uint8)(1 + rank / (MESSAGE_QUEUE_WHEEL_SLOTS - 1));
+    if(level < MESSAGE_QUEUE_WHEEL_LEVELS)
+    {
+        /* The current slot of a higher level is never used, the messages due
+           in it have moved down a level. */
+        return MESSAGE_QUEUE_LIST_WHEEL(level,
+            (MESSAGE_QUEUE_SLOT(level, queue->wheel_ms) + 1 +
+             rank % (MESSAGE_QUEUE_WHEEL_SLOTS - 1)) &
+            (MESSAGE_QUEUE_WHEEL_SLOTS - 1));
+    }
+
+    return MESSAGE_QUEUE_LIST_OVERFLOW;
+}
+
+/**
+ * \brief Get the position in delivery order of an unconditional message list.
+ * The inverse of message_queue_unconditional_list().
+ */
+static uint8 message_queue_unconditional_rank(const message_queue_t *queue,
+                                              uint8 list)
+{
+    uint8 level = list / MESSAGE_QUEUE_WHEEL_SLOTS;
+    uint8 slot = list % MESSAGE_QUEUE_WHEEL_SLOTS;
+
+    if(0 == level)
+    {
+        return slot;
+    }
+    if(level < MESSAGE_QUEUE_WHEEL_LEVELS)
+    {
+        return (uint8)(MESSAGE_QUEUE_WHEEL_SLOTS +
+                       (level - 1) * (MESSAGE_QUEUE_WHEEL_SLOTS - 1) +
+                       ((slot - MESSAGE_QUEUE_SLOT(level, queue->wheel_ms) - 1) &
+                        (MESSAGE_QUEUE_WHEEL_SLOTS - 1)));
+    }
+    return MESSAGE_QUEUE_RANKS - 1;
+}
+
+/**
+ * \brief Get the earliest time a message in an unconditional message list
+ * could be due.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] rank  The position of a non-empty list in delivery order.
+ *
+ * \return The start of the list's slot, or for the overflow list the start of
+ * the lowest level slot containing its first message.
+ */
+static MILLITIME message_queue_rank_start(const message_queue_t *queue,
+                                          uint8 rank)
+{
+    uint8 level;
+
+    if(rank < MESSAGE_QUEUE_WHEEL_SLOTS)
+    {
+        return MESSAGE_QUEUE_SLOT_START(1, queue->wheel_ms) +
+               ((MILLITIME)rank << MESSAGE_QUEUE_SLOT_MS_LOG2(0));
+    }
+
+    rank -= MESSAGE_QUEUE_WHEEL_SLOTS;
+    level = (uint8)(1 + rank / (MESSAGE_QUEUE_WHEEL_SLOTS - 1));
+    if(level < MESSAGE_QUEUE_WHEEL_LEVELS)
+    {
+        return MESSAGE_QUEUE_SLOT_START(level, queue->wheel_ms) +
+               ((MILLITIME)(1 + rank % (MESSAGE_QUEUE_WHEEL_SLOTS - 1)) <<
+                MESSAGE_QUEUE_SLOT_MS_LOG2(level));
+    }
+
+    return MESSAGE_QUEUE_SLOT_START(0,
+        queue->lists[MESSAGE_QUEUE_LIST_OVERFLOW].head->message->due_ms);
+}
+
+/**
+ * \brief Find the first non-empty unconditional message list.
+ *
+ * \return The position in delivery order of the list, or MESSAGE_QUEUE_RANKS if
+ * there are no unconditional messages.
+ */
+static uint8 message_queue_first_rank(const message_queue_t *queue)
+{
+    uint8 rank;
+
+    for(rank = 0; rank < MESSAGE_QUEUE_RANKS; ++rank)
+    {
+        if(NULL != queue->lists[message_queue_unconditional_list(queue,
+                                                                 rank)].head)
+        {
+            break;
+        }
+    }
+
+    return rank;
+}
+
+/**
+ * \brief Choose the timer wheel list for an unconditional message.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] due_ms  The time the message is due.
+ *
+ * \return The index of the list to insert the message into.
+ */
+static uint8 message_queue_wheel_list(const message_queue_t *queue,
+                                      MILLITIME due_ms)
+{
+    uint8 level;
+
+    /* Messages that are already overdue go in the current slot. */
+    if(time_lt(due_ms, queue->wheel_ms))
+    {
+        due_ms = queue->wheel_ms;
+    }
+
+    for(level = 0; level < MESSAGE_QUEUE_WHEEL_LEVELS; ++level)
+    {
+        MILLITIME end_ms;
+
+        if(level < MESSAGE_QUEUE_TOP_LEVEL)
+        {
+            end_ms = MESSAGE_QUEUE_SLOT_START(level + 1, queue->wheel_ms) +
+                     MESSAGE_QUEUE_SLOT_MS(level + 1);
+        }
+        else
+        {
+            end_ms = MESSAGE_QUEUE_SLOT_START(level, queue->wheel_ms) +
+                     MESSAGE_QUEUE_SLOT_MS(level) * MESSAGE_QUEUE_WHEEL_SLOTS;
+        }
+
+        if(time_lt(due_ms, end_ms))
+        {
+            return MESSAGE_QUEUE_LIST_WHEEL(level,
+                                            MESSAGE_QUEUE_SLOT(level, due_ms));
+        }
+    }
+
+    return MESSAGE_QUEUE_LIST_OVERFLOW;
+}
+
+/**
+ * \brief Choose the delivery list for a message.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] message  The message to place on the queue.
+ *
+ * \return The index of the list to insert the message into.
+ */
+static uint8 message_queue_list_for(const message_queue_t *queue,
+                                    const message_queue_message_t *message)
+{
+    uint8 group;
+    uint8 list = MESSAGE_QUEUE_LIST_UNGROUPED;
+
+    if(!message_queue_message_conditional(message))
+    {
+        return message_queue_wheel_list(queue, message->due_ms);
+    }
+
+    for(group = 0; group < MESSAGE_QUEUE_CONDITION_GROUPS; ++group)
+    {
+        const message_queue_condition_t *condition = &queue->conditions[group];
+
+        if(condition->addr == message->condition_addr &&
+           condition->width == message->condition_width)
+        {
+            return MESSAGE_QUEUE_LIST_CONDITION(group);
+        }
+        if(NULL == condition->addr && MESSAGE_QUEUE_LIST_UNGROUPED == list)
+        {
+            list = MESSAGE_QUEUE_LIST_CONDITION(group);
+        }
+    }
+
+    return list;
+}
+
+/**
+ * \brief Find the last message in a delivery list that is delivered before a
+ * task message.
+ *
+ * Sorted lists are searched from the tail as messages are usually sent with
+ * later due times than those already queued.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] list  The index of the list to search.
+ * \param [in] task_message  The task message to compare against.
+ * \param [in,out] visits  If not NULL, the number of messages that may still be
+ * looked at. The search stops, with the count at 0, once it runs out.
+ *
+ * \return The last task message delivered before \p task_message, or NULL if
+ * there isn't one.
+ */
+static message_queue_task_message_t *message_queue_list_before(
+    const message_queue_t *queue, uint8 list,
+    message_queue_task_message_t *task_message, uint16 *visits)
+{
+    message_queue_task_message_t *prev = queue->lists[list].tail;
+
+    if(MESSAGE_QUEUE_LIST_IS_SORTED(list))
+    {
+        while(NULL != prev &&
+              task_message == message_queue_earlier(prev, task_message))
+        {
+            if(NULL != visits && 0 == --*visits)
+            {
+                return NULL;
+            }
+            prev = prev->prev;
+        }
+    }
+    else
+    {
+        message_queue_task_message_t *queued;
+
+        prev = NULL;
+        for(queued = queue->lists[list].head; NULL != queued;
+            queued = queued->next)
+        {
+            if(NULL != visits && 0 == --*visits)
+            {
+                return NULL;
+            }
+            if(queued == message_queue_earlier(queued, task_message) &&
+               (NULL == prev || prev == message_queue_earlier(prev, queued)))
+            {
+                prev = queued;
+            }
+        }
+    }
+
+    return prev;
+}
+
+/**
+ * \brief Find the message delivered immediately before a new message.
+ *
+ * Gives up after looking at MESSAGE_QUEUE_PRECEDING_VISITS_MAX messages. That
+ * only happens when many messages are due after the new one in its own slot of
+ * the timer wheel or in the conditional message lists.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] task_message  The new task message.
+ *
+ * \return The last message that would be delivered before \p task_message, or
+ * NULL if there isn't one or the search gave up.
+ */
+static const message_queue_task_message_t *message_queue_preceding(
+    const message_queue_t *queue, message_queue_task_message_t *task_message)
+{
+    uint16 visits = MESSAGE_QUEUE_PRECEDING_VISITS_MAX;
+    uint8 list = message_queue_wheel_list(queue, task_message->message->due_ms);
+    uint8 rank = message_queue_unconditional_rank(queue, list);
+    message_queue_task_message_t *preceding =
+        message_queue_list_before(queue, list, task_message, &visits);
+
+    while(NULL == preceding && rank > 0 && 0 != visits)
+    {
+        --rank;
+        preceding = message_queue_list_before(queue,
+            message_queue_unconditional_list(queue, rank), task_message,
+            &visits);
+    }
+
+    /* Any of the conditional messages may come between. */
+    for(list = MESSAGE_QUEUE_LIST_CONDITION(0);
+        list <= MESSAGE_QUEUE_LIST_UNGROUPED && 0 != visits; ++list)
+    {
+        message_queue_task_message_t *prev =
+            message_queue_list_before(queue, list, task_message, &visits);
+
+        if(NULL != prev && (NULL == preceding ||
+                            preceding == message_queue_earlier(preceding, prev)))
+        {
+            preceding = prev;
+        }
+    }
+
+    if(0 == visits)
+    {
+        return NULL;
+    }
+
+    return preceding;
+}
+
+/**
+ * \brief Link a task message into a delivery list.
+ *
+ * Sorted lists are kept in delivery order, task messages are appended to the
+ * tail of other lists.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] list  The index of the list to link into.
+ * \param [in] task_message  The task message to link.
+ */
+static void message_queue_list_link(message_queue_t *queue, uint8 list,
+                                    message_queue_task_message_t *task_message)
+{
+    message_queue_list_t *l = &queue->lists[list];
+    message_queue_task_message_t *prev = l->tail;
+
+    if(MESSAGE_QUEUE_LIST_IS_SORTED(list))
+    {
+        prev = message_queue_list_before(queue, list, task_message, NULL);
+    }
+
+    task_message->prev = prev;
+    if(NULL != prev)
+    {
+        task_message->next = prev->next;
+        prev->next = task_message;
+    }
+    else
+    {
+        task_message->next = l->head;
+        l->head = task_message;
+    }
+
+    if(NULL != task_message->next)
+    {
+        task_message->next->prev = task_message;
+    }
+    else
+    {
+        l->tail = task_message;
+    }
+
+    task_message->list = list;
+
+    if(MESSAGE_QUEUE_LIST_IS_GROUP(list))
+    {
+        message_queue_condition_t *condition =
+            &queue->conditions[list - MESSAGE_QUEUE_LIST_CONDITION(0)];
+
+        condition->addr = task_message->message->condition_addr;
+        condition->width = task_message->message->condition_width;
+    }
+}
+
+/**
+ * \brief Unlink a task message from its delivery list.
+ * Releases the condition group if the task message was the last in its group.
+ */
+static void message_queue_list_unlink(message_queue_t *queue,
+                                      message_queue_task_message_t *task_message)
+{
+    message_queue_list_t *l = &queue->lists[task_message->list];
+
+    if(NULL != task_message->prev)
+    {
+        task_message->prev->next = task_message->next;
+    }
+    else
+    {
+        l->head = task_message->next;
+    }
+
+    if(NULL != task_message->next)
+    {
+        task_message->next->prev = task_message->prev;
+    }
+    else
+    {
+        l->tail = task_message->prev;
+    }
+
+    if(NULL == l->head && MESSAGE_QUEUE_LIST_IS_GROUP(task_message->list))
+    {
+        queue->conditions[task_message->list -
+                          MESSAGE_QUEUE_LIST_CONDITION(0)].addr = NULL;
+    }
+
+    task_message->next = NULL;
+    task_message->prev = NULL;
+}
+
+/**
+ * \brief Add a task message to a queue.
+ *
+ * \warning This function must be called with interrupts blocked.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] list  The index of the list to link into.
+ * \param [in] task_message  The task message to add, its sequence number must
+ * already be set.
+ */
+static void message_queue_add_locked(message_queue_t *queue, uint8 list,
+                                     message_queue_task_message_t *task_message)
+{
+    message_queue_list_t *bucket =
+        &queue->tasks[message_queue_task_bucket(task_message->task)];
+
+    message_queue_list_link(queue, list, task_message);
+
+    task_message->task_next = NULL;
+    task_message->task_prev = bucket->tail;
+    if(NULL != bucket->tail)
+    {
+        bucket->tail->task_next = task_message;
+    }
+    else
+    {
+        bucket->head = task_message;
+    }
+    bucket->tail = task_message;
+
+    if(++queue->stats.queued > queue->stats.max_queued)
+    {
+        queue->stats.max_queued = queue->stats.queued;
+    }
+}
+
+/**
+ * \brief Remove a task message from a queue.
+ *
+ * \warning This function must be called with interrupts blocked.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] task_message  The task message to remove.
+ */
+static void message_queue_remove_locked(
+    message_queue_t *queue, message_queue_task_message_t *task_message)
+{
+    message_queue_list_t *bucket =
+        &queue->tasks[message_queue_task_bucket(task_message->task)];
+
+    message_queue_list_unlink(queue, task_message);
+
+    if(NULL != task_message->task_prev)
+    {
+        task_message->task_prev->task_next = task_message->task_next;
+    }
+    else
+    {
+        bucket->head = task_message->task_next;
+    }
+
+    if(NULL != task_message->task_next)
+    {
+        task_message->task_next->task_prev = task_message->task_prev;
+    }
+    else
+    {
+        bucket->tail = task_message->task_prev;
+    }
+
+    task_message->task_next = NULL;
+    task_message->task_prev = NULL;
+
+    --queue->stats.queued;
+}
+
+/**
+ * \brief Move the messages due before a time from a list to the timer wheel
+ * lists they now belong in.
+ *
+ * \warning This function must be called with interrupts blocked.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] list  The index of the list to move messages out of.
+ * \param [in] limit_ms  Messages due before this time are moved.
+ */
+static void message_queue_wheel_move(message_queue_t *queue, uint8 list,
+                                     MILLITIME limit_ms)
+{
+    message_queue_list_t *l = &queue->lists[list];
+
+    while(NULL != l->head && time_lt(l->head->message->due_ms, limit_ms))
+    {
+        message_queue_task_message_t *task_message = l->head;
+
+        message_queue_list_unlink(queue, task_message);
+        message_queue_list_link(queue,
+            message_queue_wheel_list(queue, task_message->message->due_ms),
+            task_message);
+    }
+}
+
+/**
+ * \brief Move messages down the timer wheel after it has advanced.
+ *
+ * Messages in the overflow list that are now within the top level are moved
+ * into the wheel, then the messages in the current slot of each higher level
+ * are moved down, highest level first.
+ *
+ * \warning This function must be called with interrupts blocked.
+ *
+ * \param [in] queue  A pointer to a queue.
+ */
+static void message_queue_wheel_cascade(message_queue_t *queue)
+{
+    uint8 level;
+
+    message_queue_wheel_move(queue, MESSAGE_QUEUE_LIST_OVERFLOW,
+        MESSAGE_QUEUE_SLOT_START(MESSAGE_QUEUE_TOP_LEVEL, queue->wheel_ms) +
+        MESSAGE_QUEUE_SLOT_MS(MESSAGE_QUEUE_TOP_LEVEL) *
+        MESSAGE_QUEUE_WHEEL_SLOTS);
+
+    for(level = MESSAGE_QUEUE_TOP_LEVEL; level > 0; --level)
+    {
+        MILLITIME slot_ms = MESSAGE_QUEUE_SLOT_START(level, queue->wheel_ms);
+
+        message_queue_wheel_move(queue,
+            MESSAGE_QUEUE_LIST_WHEEL(level,
+                                     MESSAGE_QUEUE_SLOT(level, slot_ms)),
+            slot_ms + MESSAGE_QUEUE_SLOT_MS(level));
+    }
+}
+
+/**
+ * \brief Advance the timer wheel towards the current time.
+ *
+ * The wheel never moves past a lowest level slot holding messages, so those
+ * messages stay in the current slot until they have been delivered. Empty
+ * slots are skipped in a single step, so this takes a bounded amount of time
+ * however long it has been since the wheel last advanced.
+ *
+ * \warning This function must be called with interrupts blocked.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [in] now_ms  The current time.
+ */
+static void message_queue_wheel_advance(message_queue_t *queue,
+                                        MILLITIME now_ms)
+{
+    MILLITIME target_ms = MESSAGE_QUEUE_SLOT_START(0, now_ms);
+
+    while(time_lt(queue->wheel_ms, target_ms))
+    {
+        uint8 rank = message_queue_first_rank(queue);
+        MILLITIME next_ms = target_ms;
+
+        if(rank < MESSAGE_QUEUE_RANKS)
+        {
+            MILLITIME start_ms = message_queue_rank_start(queue, rank);
+            if(time_lt(start_ms, next_ms))
+            {
+                next_ms = start_ms;
+            }
+        }
+
+        /* Moving within the current slot of the level above doesn't move any
+           messages between levels. */
+        queue->wheel_ms = next_ms;
+        if(rank < MESSAGE_QUEUE_WHEEL_SLOTS)
+        {
+            break;
+        }
+        message_queue_wheel_cascade(queue);
+    }
+}
+
 message_queue_t *message_queue_create(void)
 {
     message_queue_t *queue;
@@ -140,8 +863,8 @@ message_queue_t *message_queue_create(void)
         return NULL;
     }
 
-    queue->queued = NULL;
-    queue->events = 0;
+    memset(queue, 0, sizeof(*queue));
+    queue->wheel_ms = MESSAGE_QUEUE_SLOT_START(0, get_milli_time());
 
     /* Binary semaphores created with xSemaphoreCreateBinaryStatic are intially
        in the empty state, so a "Give" must be called before a "Take" will be
@@ -170,20 +893,21 @@ void message_queue_send_filtered(message_queue_t *queue,
                                  bool allow_duplicates)
 {
     bool sent = FALSE;
+    TIME locked_at;
 
     assert(queue);
     assert(task_message);
 
     message_queue_task_message_log(TRAP_API_LOG_SEND, task_message);
 
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
         if (allow_duplicates || !message_queue_already(queue, task_message))
         {
             sent = message_queue_send_locked(queue, task_message);
         }
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
     if(!sent)
     {
@@ -196,20 +920,35 @@ message_queue_already(message_queue_t *queue,
                       const message_queue_task_message_t *task_message)
 {
     message_queue_task_message_t *queued;
+    message_queue_task_message_t *first = NULL;
 
     assert(queue);
     assert(task_message);
 
-    for (queued = queue->queued; NULL != queued; queued = queued->next)
+    /* Similar and replaceable messages must have the same task, so only the
+       messages in the task's bucket need checking. Of those, the earliest due
+       is the one that is kept or replaced. */
+    for (queued = queue->tasks[message_queue_task_bucket(task_message->task)].head;
+         NULL != queued; queued = queued->task_next)
     {
         if (message_queue_task_message_similar(queued, task_message) ||
-            message_queue_task_message_replace(queued, task_message))
+            message_queue_task_message_replaceable(queued, task_message))
         {
-            return TRUE;
+            first = message_queue_earlier(first, queued);
         }
     }
 
-    return FALSE;
+    if (NULL == first)
+    {
+        return FALSE;
+    }
+
+    if (!message_queue_task_message_similar(first, task_message))
+    {
+        (void) message_queue_task_message_replace(first, task_message);
+    }
+
+    return TRUE;
 }
 
 void message_queue_event_raise(message_queue_t *queue,
@@ -239,14 +978,15 @@ void message_queue_send(message_queue_t *queue,
                         message_queue_task_message_t *task_message)
 {
     bool sent;
+    TIME locked_at;
 
     message_queue_task_message_log(TRAP_API_LOG_SEND, task_message);
 
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
         sent = message_queue_send_locked(queue, task_message);
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
     if(!sent)
     {
@@ -259,8 +999,7 @@ message_queue_send_locked(message_queue_t *queue,
                           message_queue_task_message_t *task_message)
 {
     bool sent = FALSE;
-    message_queue_task_message_t **p;
-    message_queue_task_message_t *prev = NULL;
+    const message_queue_task_message_t *preceding = NULL;
 
 #ifdef PANIC_ON_VM_MESSAGE_NULL_TASK_LIST
     assert(task);
@@ -268,18 +1007,23 @@ message_queue_send_locked(message_queue_t *queue,
     assert(queue);
     assert(task_message);
 
-    p = &queue->queued;
-    while (*p && time_ge(task_message->message->due_ms, (*p)->message->due_ms))
+    task_message->seq = queue->seq++;
+
+    /* Only search for the preceding message if it could be similar. If the
+       search gives up the message is queued anyway, these messages are only
+       filtered to avoid flooding the queue. */
+    if (message_queue_message_may_be_similar(task_message->message))
     {
-        prev = *p;
-        p = &prev->next;
+        preceding = message_queue_preceding(queue, task_message);
     }
 
-    if (NULL == prev ||
-        !message_queue_message_similar(prev->message, task_message->message))
+    if (NULL == preceding ||
+        !message_queue_message_similar(preceding->message,
+                                       task_message->message))
     {
-        task_message->next = *p;
-        *p = task_message;
+        message_queue_add_locked(queue,
+            message_queue_list_for(queue, task_message->message),
+            task_message);
 
         message_queue_kick(queue);
         sent = TRUE;
@@ -347,44 +1091,88 @@ static message_queue_events_t message_queue_take_events(message_queue_t *queue)
 static message_queue_task_message_t *message_queue_take_task_message(
     message_queue_t *queue)
 {
-    message_queue_task_message_t **ptask_message;
+    message_queue_task_message_t *first = NULL;
+    message_queue_task_message_t *task_message;
+    MILLITIME now_ms;
+    INTERVAL due_in_ms = 0;
+    bool kick = FALSE;
+    TIME locked_at;
+    uint8 rank;
+    uint8 group;
 
     assert(queue);
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
-        for(ptask_message = &queue->queued; NULL != *ptask_message;
-            ptask_message = &(*ptask_message)->next)
+        now_ms = get_milli_time();
+        message_queue_wheel_advance(queue, now_ms);
+
+        /* Only the lowest level of the wheel is sorted. Messages further up
+           the wheel aren't due yet, they move down as the wheel advances. */
+        rank = message_queue_first_rank(queue);
+        if(rank < MESSAGE_QUEUE_WHEEL_SLOTS)
         {
-            message_queue_task_message_t *task_message = *ptask_message;
-            message_queue_message_t *message = task_message->message;
-            if(message_queue_message_condition_satisfied(message))
+            first = queue->lists[MESSAGE_QUEUE_LIST_WHEEL(0, rank)].head;
+        }
+
+        /* All the messages in a group share a condition variable, so only the
+           head of each group needs testing. */
+        for(group = 0; group < MESSAGE_QUEUE_CONDITION_GROUPS; ++group)
+        {
+            task_message = queue->lists[MESSAGE_QUEUE_LIST_CONDITION(group)].head;
+            if(NULL != task_message &&
+               message_queue_message_condition_satisfied(task_message->message))
             {
-                MILLITIME now_ms = get_milli_time();
-                INTERVAL due_in_ms = message_queue_message_due_in_ms(message,
-                                                                     now_ms);
-                if(due_in_ms <= 0)
-                {
-                    *ptask_message = task_message->next;
+                first = message_queue_earlier(first, task_message);
+            }
+        }
 
-                    /* Interrupts have been blocked a while during searching the
-                       queue. Unblock interrupts before logging the message as
-                       logging can take a while. */
-                    unblock_interrupts();
+        for(task_message = queue->lists[MESSAGE_QUEUE_LIST_UNGROUPED].head;
+            NULL != task_message; task_message = task_message->next)
+        {
+            if(message_queue_message_condition_satisfied(task_message->message))
+            {
+                first = message_queue_earlier(first, task_message);
+                break;
+            }
+        }
 
-                    message_queue_task_message_log(TRAP_API_LOG_DELIVER,
-                                                   task_message);
+        if(NULL != first)
+        {
+            due_in_ms = message_queue_message_due_in_ms(first->message, now_ms);
+            kick = TRUE;
+            if(due_in_ms <= 0)
+            {
+                message_queue_remove_locked(queue, first);
 
-                    /* Unlink from this queue. */
-                    task_message->next = NULL;
-                    return task_message;
-                }
+                /* Unblock interrupts before logging the message as logging can
+                   take a while. */
+                message_queue_unlock(queue, locked_at);
 
-                message_queue_kick_in_ms(queue, due_in_ms);
-                break;
+                message_queue_task_message_log(TRAP_API_LOG_DELIVER, first);
+                return first;
             }
         }
+
+        if(MESSAGE_QUEUE_WHEEL_SLOTS <= rank && rank < MESSAGE_QUEUE_RANKS)
+        {
+            /* Wake up when the wheel reaches the next unconditional message if
+               that's sooner. */
+            INTERVAL wheel_in_ms =
+                time_sub(message_queue_rank_start(queue, rank), now_ms);
+
+            if(!kick || wheel_in_ms < due_in_ms)
+            {
+                kick = TRUE;
+                due_in_ms = wheel_in_ms;
+            }
+        }
+
+        if(kick)
+        {
+            message_queue_kick_in_ms(queue, due_in_ms);
+        }
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
     return NULL;
 }
@@ -468,34 +1256,47 @@ static void message_queue_wait(const message_queue_t *queue)
     assert_fn_ret(xSemaphoreTake(queue->sem, portMAX_DELAY), BaseType_t, pdPASS);
 }
 
+/**
+ * \brief Test whether a task message is for a task and optionally has an ID.
+ */
+static bool message_queue_task_message_matches(
+    const message_queue_task_message_t *task_message, Task task,
+    const MessageId *id)
+{
+    return task_message->task == task &&
+           (NULL == id || task_message->message->id == *id);
+}
+
 uint16 message_queue_messages_pending_for_task(const message_queue_t *queue,
                                                Task task,
                                                int32 *first_due_in_ms)
 {
     uint16 count = 0;
+    TIME locked_at;
 
     assert(queue);
 
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
+        message_queue_task_message_t *first = NULL;
         message_queue_task_message_t *task_message;
-        for(task_message = queue->queued; NULL != task_message;
-            task_message = task_message->next)
+        for(task_message = queue->tasks[message_queue_task_bucket(task)].head;
+            NULL != task_message; task_message = task_message->task_next)
         {
             if(task_message->task == task)
             {
-                message_queue_message_t *message = task_message->message;
-                if(0 == count && NULL != first_due_in_ms)
-                {
-                    *first_due_in_ms = time_sub(message->due_ms,
-                                                get_milli_time());
-                }
-
+                first = message_queue_earlier(first, task_message);
                 ++count;
             }
         }
+
+        if(NULL != first && NULL != first_due_in_ms)
+        {
+            *first_due_in_ms = time_sub(first->message->due_ms,
+                                        get_milli_time());
+        }
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
     return count;
 }
@@ -504,33 +1305,32 @@ bool message_queue_first_pending_for_task(const message_queue_t *queue,
                                           Task task, MessageId id,
                                           int32 *first_due_in_ms)
 {
-    bool result = FALSE;
+    message_queue_task_message_t *first = NULL;
+    TIME locked_at;
 
     assert(queue);
 
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
         message_queue_task_message_t *task_message;
-        for(task_message = queue->queued; NULL != task_message;
-            task_message = task_message->next)
+        for(task_message = queue->tasks[message_queue_task_bucket(task)].head;
+            NULL != task_message; task_message = task_message->task_next)
         {
-            message_queue_message_t *message = task_message->message;
-            if(task_message->task == task && message->id == id)
+            if(message_queue_task_message_matches(task_message, task, &id))
             {
-                if(NULL != first_due_in_ms)
-                {
-                    *first_due_in_ms = time_sub(message->due_ms,
-                                                get_milli_time());
-                }
-
-                result = TRUE;
-                break;
+                first = message_queue_earlier(first, task_message);
             }
         }
+
+        if(NULL != first && NULL != first_due_in_ms)
+        {
+            *first_due_in_ms = time_sub(first->message->due_ms,
+                                        get_milli_time());
+        }
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
-    return result;
+    return NULL != first;
 }
 
 uint16 message_queue_pending_match(const message_queue_t *queue,
@@ -538,14 +1338,15 @@ uint16 message_queue_pending_match(const message_queue_t *queue,
                                    MessageMatchFn match_fn)
 {
     uint16 count = 0;
+    TIME locked_at;
 
     assert(queue);
 
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
         message_queue_task_message_t *task_message;
-        for(task_message = queue->queued; NULL != task_message;
-            task_message = task_message->next)
+        for(task_message = queue->tasks[message_queue_task_bucket(task)].head;
+            NULL != task_message; task_message = task_message->task_next)
         {
             if(task_message->task == task)
             {
@@ -561,7 +1362,7 @@ uint16 message_queue_pending_match(const message_queue_t *queue,
             }
         }
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
     return count;
 }
@@ -572,6 +1373,7 @@ uint16 message_queue_cancel_messages(message_queue_t *queue, Task task,
     message_queue_task_message_t *removed = NULL;
     message_queue_task_message_t **removed_end = &removed;
     uint16 count = 0;
+    TIME locked_at;
 
     assert(queue);
 
@@ -579,38 +1381,63 @@ uint16 message_queue_cancel_messages(message_queue_t *queue, Task task,
        matching messages from the queue with interrupts blocked then do the
        expensive work of logging and destroying messages with interrupts
        unblocked. */
-    block_interrupts();
+    locked_at = message_queue_lock();
     {
-        /* Append to the end of the removed list to keep message destruction in
-           order, although it shouldn't matter. */
-        message_queue_task_message_t **ptask_message;
-        for(ptask_message = &queue->queued; NULL != *ptask_message; )
-        {
-            message_queue_task_message_t *task_message = *ptask_message;
-            message_queue_message_t *message = task_message->message;
+        message_queue_list_t *bucket =
+            &queue->tasks[message_queue_task_bucket(task)];
+        message_queue_task_message_t *task_message;
+        uint16 matched = 0;
 
-            if(task_message->task == task && (NULL == id || message->id == *id))
+        for(task_message = bucket->head; NULL != task_message;
+            task_message = task_message->task_next)
+        {
+            if(message_queue_task_message_matches(task_message, task, id))
             {
-                /* Remove from the queue. */
-                *ptask_message = task_message->next;
+                ++matched;
+            }
+        }
 
-                /* Append to the removed list. */
-                *removed_end = task_message;
-                removed_end = &task_message->next;
+        /* If all the matching messages are to be cancelled it's done in one
+           pass. Otherwise the earliest due are cancelled first, one per pass. */
+        while(count < matched && count < max_to_cancel)
+        {
+            message_queue_task_message_t *cancel = NULL;
+            message_queue_task_message_t *next;
 
-                ++count;
-                if(count >= max_to_cancel)
+            for(task_message = bucket->head; NULL != task_message;
+                task_message = next)
+            {
+                next = task_message->task_next;
+
+                if(message_queue_task_message_matches(task_message, task, id))
                 {
-                    break;
+                    if(matched <= max_to_cancel)
+                    {
+                        message_queue_remove_locked(queue, task_message);
+
+                        /* Append to the removed list. */
+                        *removed_end = task_message;
+                        removed_end = &task_message->next;
+                        ++count;
+                    }
+                    else
+                    {
+                        cancel = message_queue_earlier(cancel, task_message);
+                    }
                 }
             }
-            else
+
+            if(NULL != cancel)
             {
-                ptask_message = &task_message->next;
+                message_queue_remove_locked(queue, cancel);
+
+                *removed_end = cancel;
+                removed_end = &cancel->next;
+                ++count;
             }
         }
     }
-    unblock_interrupts();
+    message_queue_unlock(queue, locked_at);
 
     /* Terminate the removed list. */
     *removed_end = NULL;
@@ -626,3 +1453,16 @@ uint16 message_queue_cancel_messages(message_queue_t *queue, Task task,
 
     return count;
 }
+
+void message_queue_get_stats(const message_queue_t *queue,
+                             message_queue_stats_t *stats)
+{
+    assert(queue);
+    assert(stats);
+
+    block_interrupts();
+    {
+        *stats = queue->stats;
+    }
+    unblock_interrupts();
+}
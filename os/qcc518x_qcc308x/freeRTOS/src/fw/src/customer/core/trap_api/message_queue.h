@@ -50,17 +50,154 @@ typedef uint32 message_queue_events_t;
  */
 #define MESSAGE_QUEUE_EVENTS_MAX (CHAR_BIT * sizeof(message_queue_events_t))
 
+/**
+ * The number of levels in a message queue's timer wheel.
+ */
+#define MESSAGE_QUEUE_WHEEL_LEVELS (3)
+
+/**
+ * log2 of the number of slots in each level of a message queue's timer wheel.
+ */
+#define MESSAGE_QUEUE_WHEEL_SLOTS_LOG2 (4)
+
+/**
+ * The number of slots in each level of a message queue's timer wheel.
+ */
+#define MESSAGE_QUEUE_WHEEL_SLOTS (1 << MESSAGE_QUEUE_WHEEL_SLOTS_LOG2)
+
+/**
+ * log2 of the number of milliseconds covered by a slot of the lowest level of
+ * the timer wheel. Each level's slots cover MESSAGE_QUEUE_WHEEL_SLOTS times
+ * the span of the slots of the level below, so the slots of the three levels
+ * cover 32ms, 512ms and 8192ms.
+ */
+#define MESSAGE_QUEUE_WHEEL_SLOT_MS_LOG2 (5)
+
+/**
+ * The number of distinct condition variables that can have their conditional
+ * messages grouped together. Conditional messages for further condition
+ * variables share a single list that is searched message by message.
+ */
+#define MESSAGE_QUEUE_CONDITION_GROUPS (8)
+
+/**
+ * The number of buckets in the per-task index of a message queue.
+ * Must be a power of 2.
+ */
+#define MESSAGE_QUEUE_TASK_BUCKETS (16)
+
+/**
+ * Indices of the delivery lists of a message queue.
+ */
+#define MESSAGE_QUEUE_LIST_WHEEL(level, slot) \
+    ((level) * MESSAGE_QUEUE_WHEEL_SLOTS + (slot))
+#define MESSAGE_QUEUE_LIST_OVERFLOW \
+    MESSAGE_QUEUE_LIST_WHEEL(MESSAGE_QUEUE_WHEEL_LEVELS, 0)
+#define MESSAGE_QUEUE_LIST_CONDITION(group) \
+    (MESSAGE_QUEUE_LIST_OVERFLOW + 1 + (group))
+#define MESSAGE_QUEUE_LIST_UNGROUPED \
+    MESSAGE_QUEUE_LIST_CONDITION(MESSAGE_QUEUE_CONDITION_GROUPS)
+#define MESSAGE_QUEUE_LISTS (MESSAGE_QUEUE_LIST_UNGROUPED + 1)
+
+/**
+ * A doubly linked list of task messages.
+ */
+typedef struct message_queue_list_
+{
+    /** The first task message in the list. */
+    message_queue_task_message_t *head;
+
+    /** The last task message in the list. */
+    message_queue_task_message_t *tail;
+} message_queue_list_t;
+
+/**
+ * A condition variable shared by a group of conditional messages.
+ */
+typedef struct message_queue_condition_
+{
+    /** The address of the condition variable, NULL if the group is unused. */
+    const void *addr;
+
+    /** The width of the condition variable. */
+    CONDITION_WIDTH width;
+} message_queue_condition_t;
+
+/**
+ * Message queue statistics.
+ */
+typedef struct message_queue_stats_
+{
+    /**
+     * The longest time, in microseconds, that interrupts were blocked for by
+     * a message queue operation. Only measured when INSTALL_MESSAGE_TELEMETRY
+     * is defined, otherwise 0.
+     */
+    uint32 max_blocked_us;
+
+    /**
+     * The number of messages currently queued.
+     */
+    uint16 queued;
+
+    /**
+     * The largest number of messages that have been queued at once.
+     */
+    uint16 max_queued;
+} message_queue_stats_t;
+
 /**
  * The message queue structure.
  */
 typedef struct message_queue_
 {
     /**
-     * Singly linked list of messages to be delivered along with the task to
-     * deliver each message to. The list is sorted by delivery time, earliest
-     * deadline first.
+     * Lists of messages to be delivered along with the task to deliver each
+     * message to. Messages are delivered earliest deadline first, and messages
+     * due at the same time are delivered in the order they were sent.
+     *
+     * Unconditional messages are held in a hierarchical timer wheel. The
+     * lowest level holds the messages due before the end of the current slot
+     * of the level above, one sorted list per 32ms slot. Each higher level
+     * holds the messages due in its following slots, up to the end of the
+     * current slot of the level above, with the top level holding up to 15
+     * slots ahead. Only the lowest level is kept sorted, higher level slots
+     * are sorted as they move down a level when the wheel reaches them.
+     * Messages due later than the top level are held in the sorted overflow
+     * list.
+     *
+     * Conditional messages are grouped by their condition variable, so each
+     * condition variable is only read once when searching for a deliverable
+     * message rather than once per message.
+     */
+    message_queue_list_t lists[MESSAGE_QUEUE_LISTS];
+
+    /**
+     * The condition variables of the conditional message groups.
      */
-    message_queue_task_message_t *queued;
+    message_queue_condition_t conditions[MESSAGE_QUEUE_CONDITION_GROUPS];
+
+    /**
+     * Messages indexed by the hash of their destination task. Linked through
+     * the task_next and task_prev members of the task messages in the order
+     * they were sent.
+     */
+    message_queue_list_t tasks[MESSAGE_QUEUE_TASK_BUCKETS];
+
+    /**
+     * The start time of the current near slot of the timer wheel.
+     */
+    MILLITIME wheel_ms;
+
+    /**
+     * The sequence number for the next message sent on this queue.
+     */
+    uint32 seq;
+
+    /**
+     * Statistics for this queue.
+     */
+    message_queue_stats_t stats;
 
     /**
      * A bit set of events, used for implementing background interrupts in the
@@ -228,4 +365,13 @@ uint16 message_queue_pending_match(const message_queue_t *queue,
 uint16 message_queue_cancel_messages(message_queue_t *queue, Task task,
                                      const MessageId *id, uint16 max_to_cancel);
 
+/**
+ * \brief Get the statistics for a queue.
+ *
+ * \param [in] queue  A pointer to a queue.
+ * \param [out] stats  A pointer to memory to return the statistics in.
+ */
+void message_queue_get_stats(const message_queue_t *queue,
+                             message_queue_stats_t *stats);
+
 #endif /* !MESSAGE_QUEUE_H_ */
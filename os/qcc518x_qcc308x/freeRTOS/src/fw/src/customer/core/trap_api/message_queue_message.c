@@ -104,8 +104,25 @@ bool message_queue_message_similar(
     return FALSE;
 }
 
-bool message_queue_message_replace(message_queue_message_t *queued_message,
-                                   const message_queue_message_t *new_message)
+bool message_queue_message_may_be_similar(const message_queue_message_t *message)
+{
+    assert(message);
+
+    switch(message->id)
+    {
+    case MESSAGE_MORE_DATA:
+    case MESSAGE_MORE_SPACE:
+    case MESSAGE_PSFL_FAULT:
+    case MESSAGE_TX_POWER_CHANGE_EVENT:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+bool message_queue_message_replaceable(
+    const message_queue_message_t *queued_message,
+    const message_queue_message_t *new_message)
 {
     assert(queued_message);
     assert(new_message);
@@ -113,74 +130,88 @@ bool message_queue_message_replace(message_queue_message_t *queued_message,
     switch(queued_message->id)
     {
     case MESSAGE_USB_SUSPENDED:
+        return queued_message->id == new_message->id;
+
+    case MESSAGE_USB_ENUMERATED:
+    case MESSAGE_USB_DECONFIGURED:
+        return MESSAGE_USB_ENUMERATED == new_message->id ||
+               MESSAGE_USB_DECONFIGURED == new_message->id;
+
+    case MESSAGE_USB_ATTACHED:
+    case MESSAGE_USB_DETACHED:
+        return MESSAGE_USB_ATTACHED == new_message->id ||
+               MESSAGE_USB_DETACHED == new_message->id;
+
+    case MESSAGE_USB_ALT_INTERFACE:
         if(queued_message->id == new_message->id)
+        {
+            const MessageUsbAltInterface *ma = queued_message->app_message;
+            const MessageUsbAltInterface *mb = new_message->app_message;
+            return ma->interface == mb->interface;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return FALSE;
+}
+
+bool message_queue_message_replace(message_queue_message_t *queued_message,
+                                   const message_queue_message_t *new_message)
+{
+    if(!message_queue_message_replaceable(queued_message, new_message))
+    {
+        return FALSE;
+    }
+
+    switch(queued_message->id)
+    {
+    case MESSAGE_USB_SUSPENDED:
         {
             MessageUsbSuspended *ma =
                 MESSAGE_REMOVE_CONST(queued_message->app_message);
             const MessageUsbSuspended *mb =
                 (const MessageUsbSuspended *) new_message->app_message;
             *ma = *mb;
-            return TRUE;
         }
         break;
 
     case MESSAGE_USB_ENUMERATED:
     case MESSAGE_USB_DECONFIGURED:
-        switch(new_message->id)
         {
             /* This code is much reduced by giving the deconfigured message
              * the same kind of payload as the enumerated message. If the
              * deconfigured message didn't have a payload, you would have to
              * deal separately with the different permutations. */
-        case MESSAGE_USB_ENUMERATED:
-        case MESSAGE_USB_DECONFIGURED:
-            {
-                MessageUsbConfigValue *ma =
-                    MESSAGE_REMOVE_CONST(queued_message->app_message);
-                const MessageUsbConfigValue *mb = new_message->app_message;
-                /* copy across payload and update id */
-                *ma = *mb;
-                queued_message->id = new_message->id;
-                return TRUE;
-            }
-        default:
-            break;
+            MessageUsbConfigValue *ma =
+                MESSAGE_REMOVE_CONST(queued_message->app_message);
+            const MessageUsbConfigValue *mb = new_message->app_message;
+            /* copy across payload and update id */
+            *ma = *mb;
+            queued_message->id = new_message->id;
         }
         break;
 
     case MESSAGE_USB_ATTACHED:
     case MESSAGE_USB_DETACHED:
-        switch(new_message->id)
-        {
-        case MESSAGE_USB_ATTACHED:
-        case MESSAGE_USB_DETACHED:
-            /* No payload, just overwrite id */
-            queued_message->id = new_message->id;
-            return TRUE;
-        default:
-            break;
-        }
+        /* No payload, just overwrite id */
+        queued_message->id = new_message->id;
         break;
 
     case MESSAGE_USB_ALT_INTERFACE:
-        if(queued_message->id == new_message->id)
         {
             MessageUsbAltInterface *ma =
                 MESSAGE_REMOVE_CONST(queued_message->app_message);
             const MessageUsbAltInterface *mb = new_message->app_message;
-
-            if(ma->interface == mb->interface)
-            {
-                *ma = *mb;
-                return TRUE;
-            }
+            *ma = *mb;
         }
         break;
 
     default:
         break;
     }
-    return FALSE;
+    return TRUE;
 }
 
 bool message_queue_message_condition_satisfied(
@@ -207,6 +238,15 @@ bool message_queue_message_condition_satisfied(
     }
 }
 
+bool message_queue_message_conditional(const message_queue_message_t *message)
+{
+    assert(message);
+
+    return NULL != message->condition_addr &&
+           (CONDITION_WIDTH_16BIT == message->condition_width ||
+            CONDITION_WIDTH_32BIT == message->condition_width);
+}
+
 void message_queue_message_app_free(MessageId id, Message app_message)
 {
     void *nonconst_message = MESSAGE_REMOVE_CONST(app_message);
@@ -217,7 +257,8 @@ void message_queue_message_app_free(MessageId id, Message app_message)
         IPC_BLUESTACK_PRIM prim;
         prim.protocol = (uint16)(id - MESSAGE_BLUESTACK_BASE_);
         prim.prim = nonconst_message;
-        ipc_send(IPC_SIGNAL_ID_BLUESTACK_PRIM_RECEIVED, &prim, sizeof(prim));
+        ipc_send_batched(IPC_SIGNAL_ID_BLUESTACK_PRIM_RECEIVED, &prim,
+                         sizeof(prim));
     }
     else if(id == MESSAGE_MORE_SPACE || id == MESSAGE_MORE_DATA)
     {
@@ -225,8 +266,8 @@ void message_queue_message_app_free(MessageId id, Message app_message)
         IPC_APP_MESSAGE_RECEIVED rcvd_msg;
         rcvd_msg.id = id;
         rcvd_msg.msg = nonconst_message;
-        ipc_send(IPC_SIGNAL_ID_APP_MESSAGE_RECEIVED, &rcvd_msg,
-                 sizeof(rcvd_msg));
+        ipc_send_batched(IPC_SIGNAL_ID_APP_MESSAGE_RECEIVED, &rcvd_msg,
+                         sizeof(rcvd_msg));
     }
     else
     {
@@ -138,6 +138,28 @@ bool message_queue_message_similar(
     const message_queue_message_t *queued_message,
     const message_queue_message_t *new_message);
 
+/**
+ * \brief Test whether a message could be similar to another message.
+ *
+ * \param[in] message  The message to test.
+ * \return FALSE if message_queue_message_similar() is FALSE for \p message
+ * whatever it is compared against, TRUE otherwise.
+ */
+bool message_queue_message_may_be_similar(const message_queue_message_t *message);
+
+/**
+ * \brief Test whether one message could replace another.
+ *
+ * \param[in] queued_message  The message already placed on the queue.
+ * \param[in] new_message     The new message to compare against.
+ *
+ * \return TRUE if message_queue_message_replace() would replace
+ * \p queued_message with \p new_message.
+ */
+bool message_queue_message_replaceable(
+    const message_queue_message_t *queued_message,
+    const message_queue_message_t *new_message);
+
 /**
  * \brief Replace one message with another.
  *
@@ -162,4 +184,12 @@ bool message_queue_message_replace(
 bool message_queue_message_condition_satisfied(
     const message_queue_message_t *message);
 
+/**
+ * \brief Determine whether the message's delivery depends on a condition.
+ *
+ * \return TRUE if the message has a condition variable that is tested before
+ *  delivery, FALSE if the message's condition is always satisfied.
+ */
+bool message_queue_message_conditional(const message_queue_message_t *message);
+
 #endif /* !MESSAGE_QUEUE_MESSAGE_H_ */
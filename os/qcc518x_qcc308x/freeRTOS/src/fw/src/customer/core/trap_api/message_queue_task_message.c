@@ -22,8 +22,13 @@ void message_queue_task_message_init(message_queue_task_message_t *task_message,
     assert(message);
 
     task_message->next = NULL;
+    task_message->prev = NULL;
+    task_message->task_next = NULL;
+    task_message->task_prev = NULL;
     task_message->task = task;
     task_message->message = message;
+    task_message->seq = 0;
+    task_message->list = 0;
     message_queue_message_retain(message);
 }
 
@@ -53,6 +58,22 @@ bool message_queue_task_message_similar(
                                          new_task_message->message);
 }
 
+bool message_queue_task_message_replaceable(
+    const message_queue_task_message_t *queued,
+    const message_queue_task_message_t *new_task_message)
+{
+    assert(queued);
+    assert(new_task_message);
+
+    if (queued->task != new_task_message->task)
+    {
+        return FALSE;
+    }
+
+    return message_queue_message_replaceable(queued->message,
+                                             new_task_message->message);
+}
+
 bool message_queue_task_message_replace(
     message_queue_task_message_t *queued,
     const message_queue_task_message_t *new_task_message)
@@ -99,7 +120,7 @@ void message_queue_task_message_log(
     U8_OFF0_SET(header.action, action);
 
     /* Task */
-    U32_OFF1_SET(header.task, (uint32)task);
+    U32_OFF1_SET(header.task, (uint32)(uintptr)task);
 
     /* Handler */
     {
@@ -107,7 +128,7 @@ void message_queue_task_message_log(
         if(NULL != task &&
            message_router_handle_routes_to_default((MessageQueue)task))
         {
-            handler = (uint32)task->handler;
+            handler = (uint32)(uintptr)task->handler;
         }
         U32_OFF1_SET(header.handler, handler);
     }
@@ -120,7 +141,7 @@ void message_queue_task_message_log(
 
     /* Condition Address */
     {
-        uint32 condition_address = (uint32)message->condition_addr;
+        uint32 condition_address = (uint32)(uintptr)message->condition_addr;
         U32_OFF1_SET(header.condition_address, condition_address);
     }
 
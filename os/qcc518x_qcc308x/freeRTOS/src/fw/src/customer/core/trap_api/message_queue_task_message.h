@@ -12,6 +12,11 @@
 
 #include "message_queue_message.h"
 
+/**
+ * A VM task message handler.
+ */
+typedef void (*message_queue_handler_t)(Task, MessageId, Message);
+
 /**
  * A structure for associating a message with a single task.
  */
@@ -23,6 +28,18 @@ typedef struct message_queue_task_message_
      */
     struct message_queue_task_message_ *next;
 
+    /**
+     * The previous task message in the same message queue delivery list.
+     */
+    struct message_queue_task_message_ *prev;
+
+    /**
+     * Links for the message queue's per-task index, used to find the messages
+     * pending for a task without searching the whole queue.
+     */
+    struct message_queue_task_message_ *task_next;
+    struct message_queue_task_message_ *task_prev;
+
     /**
      * The task this message is to be delivered to.
      * This is either the MessageQueue handle value for FreeRTOS style message
@@ -37,6 +54,19 @@ typedef struct message_queue_task_message_
      * is destroyed.
      */
     message_queue_message_t *message;
+
+    /**
+     * Sequence number assigned when the task message is placed on a message
+     * queue, used to deliver messages due at the same time in the order they
+     * were sent. Wraps, so only compare the sequence numbers of messages sent
+     * fewer than 2^23 messages apart.
+     */
+    uint32 seq : 24;
+
+    /**
+     * The index of the message queue delivery list holding this task message.
+     */
+    uint32 list : 8;
 } message_queue_task_message_t;
 
 /**
@@ -79,6 +109,19 @@ bool message_queue_task_message_similar(
     const message_queue_task_message_t *queued,
     const message_queue_task_message_t *new_task_message);
 
+/**
+ * \brief Test whether a task message could be replaced by a new one.
+ *
+ * \param [in] queued  An existing task message.
+ * \param [in] new_task_message  The new task message pair.
+ *
+ * \return TRUE if message_queue_task_message_replace() would replace
+ * \p queued with \p new_task_message, FALSE otherwise.
+ */
+bool message_queue_task_message_replaceable(
+    const message_queue_task_message_t *queued,
+    const message_queue_task_message_t *new_task_message);
+
 /**
  * \brief Replace a message with a new message if they match.
  *
@@ -0,0 +1,137 @@
+/* Copyright (c) 2020 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+
+/**
+ * \file
+ *
+ * Implementation of the VM task delivery telemetry.
+ */
+
+#include "message_telemetry.h"
+
+#ifdef INSTALL_MESSAGE_TELEMETRY
+
+#include <string.h>
+
+#define MESSAGE_TELEMETRY_MASK (MESSAGE_TELEMETRY_ENTRIES - 1)
+
+/**
+ * The VM task delivery telemetry, read off-chip.
+ */
+static message_telemetry_t message_telemetry;
+
+/**
+ * \brief Find or allocate the entry for a handler and message ID group.
+ *
+ * \param [in] handler  The handler.
+ * \param [in] id_group  The message ID group.
+ * \return The entry, or the overflow entry if the table is full.
+ */
+static message_telemetry_entry_t *message_telemetry_entry(
+    message_queue_handler_t handler, uint16 id_group)
+{
+    uint32 slot = ((uint32)handler >> 2) ^ ((uint32)id_group * 0x9E3779B1UL);
+    uint16 probes;
+
+    slot ^= slot >> 16;
+    for(probes = 0; probes < MESSAGE_TELEMETRY_ENTRIES; ++probes)
+    {
+        message_telemetry_entry_t *entry =
+            &message_telemetry.entries[(slot + probes) & MESSAGE_TELEMETRY_MASK];
+
+        if(NULL == entry->handler)
+        {
+            /* Entries are never removed, so the first unused entry ends the
+               probe sequence. */
+            entry->handler = handler;
+            entry->id_group = id_group;
+            ++message_telemetry.used;
+            return entry;
+        }
+        if(entry->handler == handler && entry->id_group == id_group)
+        {
+            return entry;
+        }
+    }
+
+    return &message_telemetry.overflow;
+}
+
+/**
+ * \brief Get the lateness histogram bucket for a delivery.
+ *
+ * \param [in] late_ms  How late the message was delivered. Messages aren't
+ * delivered before they're due, so this is 0 for an on-time delivery.
+ * \return The histogram bucket.
+ */
+static uint16 message_telemetry_late_bucket(INTERVAL late_ms)
+{
+    uint16 bucket = 0;
+
+    while(late_ms > 0 && bucket < MESSAGE_TELEMETRY_LATE_BUCKETS - 1)
+    {
+        late_ms >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+void message_telemetry_record(const message_queue_task_message_t *task_message,
+                              message_queue_handler_t handler,
+                              MILLITIME delivered_ms,
+                              uint32 elapsed_us,
+                              uint16 vm_queued)
+{
+    const message_queue_message_t *message = task_message->message;
+    message_telemetry_entry_t *entry;
+
+    if(NULL == handler)
+    {
+        /* Nothing was executed. */
+        return;
+    }
+
+    entry = message_telemetry_entry(
+        handler, (uint16)(message->id >> MESSAGE_TELEMETRY_ID_GROUP_SHIFT));
+    if(entry == &message_telemetry.overflow)
+    {
+        message_telemetry.overflow_id = message->id;
+    }
+
+    ++entry->delivered;
+    entry->total_us += elapsed_us;
+    if(elapsed_us > entry->max_us)
+    {
+        entry->max_us = elapsed_us;
+    }
+    if(vm_queued > entry->max_vm_queued)
+    {
+        entry->max_vm_queued = vm_queued;
+    }
+
+    if(CONDITION_WIDTH_UNUSED == message->condition_width)
+    {
+        INTERVAL late_ms = time_sub(delivered_ms, message->due_ms);
+        uint16 bucket = message_telemetry_late_bucket(late_ms);
+
+        if(late_ms > 0 && (uint32)late_ms > entry->max_late_ms)
+        {
+            entry->max_late_ms = (uint32)late_ms;
+        }
+        /* Saturate rather than wrap so a busy entry can't look idle. */
+        if(entry->late[bucket] != 0xFFFF)
+        {
+            ++entry->late[bucket];
+        }
+    }
+}
+
+void message_telemetry_reset(void)
+{
+    /* This isn't synchronised with the VM task, a delivery being recorded at
+       the same time may be partly counted. That's fine for statistics. */
+    memset(&message_telemetry, 0, sizeof(message_telemetry));
+}
+
+#endif /* INSTALL_MESSAGE_TELEMETRY */
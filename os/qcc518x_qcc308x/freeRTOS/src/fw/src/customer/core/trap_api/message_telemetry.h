@@ -0,0 +1,166 @@
+/* Copyright (c) 2020 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+
+/**
+ * \file
+ *
+ * Delivery telemetry for messages executed by the VM task.
+ *
+ * Each message delivered to a VM task handler is accounted against an entry
+ * for its handler and message ID group. An entry records how many messages
+ * were delivered, a histogram of how late they were delivered compared with
+ * their due time, the total and longest handler execution time and the
+ * deepest the whole VM queue was when one of its messages was delivered.
+ * Together these show which handlers delay other messages and which handlers
+ * run while the queue is backed up. The queue depth covers the messages of
+ * all VM tasks, it isn't the backlog of the entry's own task.
+ *
+ * The telemetry is only built when INSTALL_MESSAGE_TELEMETRY is defined, the
+ * default table uses about 1.5KB of RAM. It is read off-chip by
+ * tools/pydbg_scripts/vm_task_telemetry.py.
+ */
+
+#ifndef MESSAGE_TELEMETRY_H_
+#define MESSAGE_TELEMETRY_H_
+
+#include "message_queue_task_message.h"
+#include "timed_event/rtime.h"
+
+#ifdef INSTALL_MESSAGE_TELEMETRY
+
+/**
+ * \brief The number of handler and message ID group pairs that are tracked.
+ *
+ * Messages for pairs that don't fit in the table are accounted against the
+ * overflow entry instead. Must be a power of 2.
+ */
+#ifndef MESSAGE_TELEMETRY_ENTRIES
+#define MESSAGE_TELEMETRY_ENTRIES 32
+#endif
+
+/**
+ * \brief Message IDs are grouped by discarding this many low bits.
+ *
+ * ADK modules allocate their message IDs from contiguous ranges so a group
+ * normally holds the related messages of a single module.
+ */
+#ifndef MESSAGE_TELEMETRY_ID_GROUP_SHIFT
+#define MESSAGE_TELEMETRY_ID_GROUP_SHIFT 4
+#endif
+
+/**
+ * \brief The number of delivery lateness histogram buckets.
+ *
+ * Bucket 0 counts messages delivered on time, bucket n counts messages
+ * delivered between 2^(n-1) and 2^n - 1 milliseconds late. The last bucket
+ * also counts any later messages.
+ */
+#define MESSAGE_TELEMETRY_LATE_BUCKETS 12
+
+/**
+ * Delivery telemetry for a handler and message ID group.
+ */
+typedef struct message_telemetry_entry_
+{
+    /**
+     * The handler the messages were delivered to. NULL for an unused entry
+     * and for the overflow entry.
+     */
+    message_queue_handler_t handler;
+
+    /**
+     * The number of messages delivered.
+     */
+    uint32 delivered;
+
+    /**
+     * The total time, in microseconds, spent executing the handler.
+     */
+    uint32 total_us;
+
+    /**
+     * The longest time, in microseconds, spent executing the handler for a
+     * single message.
+     */
+    uint32 max_us;
+
+    /**
+     * The latest, in milliseconds, that an unconditional message was
+     * delivered after it was due.
+     */
+    uint32 max_late_ms;
+
+    /**
+     * The message ID group, the message ID shifted right by
+     * MESSAGE_TELEMETRY_ID_GROUP_SHIFT.
+     */
+    uint16 id_group;
+
+    /**
+     * The largest number of messages still in the VM queue, for any task,
+     * when a message in this entry was delivered.
+     */
+    uint16 max_vm_queued;
+
+    /**
+     * Delivery lateness histogram of the unconditional messages. Messages
+     * sent with a condition are due as soon as they're sent but can't be
+     * delivered until the condition is met, so they aren't included.
+     */
+    uint16 late[MESSAGE_TELEMETRY_LATE_BUCKETS];
+} message_telemetry_entry_t;
+
+/**
+ * The VM task delivery telemetry.
+ */
+typedef struct message_telemetry_
+{
+    /**
+     * Entries hashed on handler and message ID group, with linear probing.
+     */
+    message_telemetry_entry_t entries[MESSAGE_TELEMETRY_ENTRIES];
+
+    /**
+     * Messages that didn't fit in the table.
+     */
+    message_telemetry_entry_t overflow;
+
+    /**
+     * The last message ID delivered in the overflow entry, to give a hint
+     * about what didn't fit.
+     */
+    MessageId overflow_id;
+
+    /**
+     * The number of entries in use.
+     */
+    uint16 used;
+} message_telemetry_t;
+
+/**
+ * \brief Account a delivered message.
+ *
+ * \param [in] task_message  The task message that was delivered.
+ * \param [in] handler  The handler the message was delivered to, captured
+ * before execution as the task may be freed by its handler.
+ * \param [in] delivered_ms  The time the handler was called.
+ * \param [in] elapsed_us  The time spent executing the handler.
+ * \param [in] vm_queued  The number of messages still in the VM queue, for
+ * all tasks.
+ */
+void message_telemetry_record(const message_queue_task_message_t *task_message,
+                              message_queue_handler_t handler,
+                              MILLITIME delivered_ms,
+                              uint32 elapsed_us,
+                              uint16 vm_queued);
+
+/**
+ * \brief Clear all the telemetry.
+ *
+ * Intended to be called from pydbg with appcmd at the start of a test run.
+ */
+void message_telemetry_reset(void);
+
+#endif /* INSTALL_MESSAGE_TELEMETRY */
+
+#endif /* !MESSAGE_TELEMETRY_H_ */
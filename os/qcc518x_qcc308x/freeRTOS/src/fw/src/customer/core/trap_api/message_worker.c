@@ -0,0 +1,210 @@
+/* Copyright (c) 2020 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+
+/**
+ * \file
+ *
+ * Implementation of the worker task.
+ */
+
+#include "assert.h"
+#include "message_worker.h"
+#include "messaging.h"
+#include "hydra_log/hydra_log.h"
+#include "pmalloc/pmalloc.h"
+#include "int/int.h"
+#include "sched/sched.h"
+#include "timed_event/rtime.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/**
+ * \brief The size of the worker task's stack in bytes.
+ *
+ * Jobs such as signature checks need more stack than most VM handlers, this
+ * can be overridden by the build system.
+ */
+#ifndef WORKER_TASK_STACK_BYTES
+#define WORKER_TASK_STACK_BYTES 2048
+#endif
+
+/**
+ * \brief The size of the worker task's stack in 32-bit words.
+ */
+#define WORKER_TASK_STACK_WORDS \
+    ((WORKER_TASK_STACK_BYTES + sizeof(StackType_t) - 1) / sizeof(StackType_t))
+
+/**
+ * The ID of job messages on the worker's queue. The queue only ever holds
+ * jobs so the value doesn't matter.
+ */
+#define MESSAGE_WORKER_JOB 0
+
+/**
+ * A job message sent to the worker's queue.
+ */
+typedef struct message_worker_job_
+{
+    /** The job. */
+    MessageWorkerFn fn;
+
+    /** Passed to \c fn. */
+    void *context;
+
+    /** The task to send #MESSAGE_WORKER_DONE to, may be NULL. */
+    Task done_task;
+} message_worker_job_t;
+
+/**
+ * Worker task data structure type.
+ */
+typedef struct message_worker_data_
+{
+    /**
+     * Memory area for the worker task's stack.
+     */
+    StackType_t stack[WORKER_TASK_STACK_WORDS];
+
+    /**
+     * The FreeRTOS worker task data structure.
+     */
+    StaticTask_t task_structure;
+
+    /**
+     * A handle to the FreeRTOS worker task.
+     */
+    TaskHandle_t task;
+
+    /**
+     * The queue jobs are posted to.
+     */
+    MessageQueue queue;
+
+    /**
+     * The number of jobs posted but not yet finished.
+     */
+    uint16 pending;
+
+    /**
+     * The longest time, in microseconds, a job has taken from being picked up
+     * to finishing, including any time the VM task preempted it.
+     */
+    uint32 max_job_us;
+} message_worker_data_t;
+
+/**
+ * The one worker task state.
+ */
+static message_worker_data_t worker;
+
+/**
+ * \brief Entrypoint for the FreeRTOS worker task.
+ *
+ * Does not return.
+ *
+ * \param [in] parameters Unused.
+ */
+static void message_worker_task_handler(void *parameters);
+
+/**
+ * \brief Run a job and report its completion.
+ *
+ * \param [in] job  The job to run.
+ */
+static void message_worker_run(const message_worker_job_t *job);
+
+void init_message_worker(void)
+{
+    worker.queue = messaging_queue_create();
+    /* Panic on failure to create the worker queue, as for the VM queue. */
+    assert(worker.queue);
+
+    worker.task = xTaskCreateStatic(/*pvTaskCode=*/message_worker_task_handler,
+                                    /*pcName=*/"WORKER",
+                                    /*ulStackDepth=*/WORKER_TASK_STACK_WORDS,
+                                    /*pvParameters=*/NULL,
+                                    /*uxPriority=*/SCHED_TASK_PRIORITY_WORKER,
+                                    /*puxStackBuffer=*/worker.stack,
+                                    /*pxTaskBuffer=*/&worker.task_structure);
+    assert(worker.task);
+}
+
+bool message_worker_post(MessageWorkerFn fn, void *context, Task done_task)
+{
+    message_worker_job_t *job;
+    Task worker_task;
+
+    assert(fn);
+
+    if(0 == worker.queue)
+    {
+        return FALSE;
+    }
+
+    job = pnew(message_worker_job_t);
+    job->fn = fn;
+    job->context = context;
+    job->done_task = done_task;
+
+    block_interrupts();
+    ++worker.pending;
+    unblock_interrupts();
+
+    worker_task = MessageQueueAsTask(worker.queue);
+    messaging_send(&worker_task, /*num_tasks=*/1, MESSAGE_WORKER_JOB, job,
+                   D_IMMEDIATE, /*condition_addr=*/NULL,
+                   CONDITION_WIDTH_UNUSED);
+    return TRUE;
+}
+
+bool message_worker_in_worker(void)
+{
+    return NULL != worker.task && worker.task == xTaskGetCurrentTaskHandle();
+}
+
+static void message_worker_task_handler(void *parameters)
+{
+    UNUSED(parameters);
+
+    for(;;)
+    {
+        Message message;
+        MessageId id = messaging_queue_wait(worker.queue, &message);
+
+        assert(MESSAGE_WORKER_JOB == id);
+        message_worker_run((const message_worker_job_t *)message);
+        messaging_free(id, message);
+    }
+}
+
+static void message_worker_run(const message_worker_job_t *job)
+{
+    TIME started = get_time();
+    uint32 elapsed_us;
+
+    job->fn(job->context);
+
+    elapsed_us = (uint32)time_sub(get_time(), started);
+    L3_DBG_MSG2("messaging: worker job 0x%08x took %u us",
+                (uint32)job->fn, elapsed_us);
+
+    block_interrupts();
+    --worker.pending;
+    if(elapsed_us > worker.max_job_us)
+    {
+        worker.max_job_us = elapsed_us;
+    }
+    unblock_interrupts();
+
+    if(NULL != job->done_task)
+    {
+        MessageWorkerDone *done = pnew(MessageWorkerDone);
+
+        done->fn = job->fn;
+        done->context = job->context;
+        messaging_send(&job->done_task, /*num_tasks=*/1, MESSAGE_WORKER_DONE,
+                       done, D_IMMEDIATE, /*condition_addr=*/NULL,
+                       CONDITION_WIDTH_UNUSED);
+    }
+}
@@ -0,0 +1,60 @@
+/* Copyright (c) 2020 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+
+/**
+ * \file
+ *
+ * Worker task for VM task jobs that aren't latency critical.
+ *
+ * The worker is a FreeRTOS task that runs below the VM task's priority. VM
+ * tasks post it jobs, a function and a context, and it runs them one at a
+ * time in the order they were posted. Because the worker is lower priority the
+ * VM task preempts it whenever a message is due, so a long job such as a
+ * signature check no longer delays UI or audio control messages. Once a job
+ * has finished the worker can send #MESSAGE_WORKER_DONE to a VM task.
+ *
+ * Jobs are queued on an ordinary message queue, the worker blocks on it while
+ * there is nothing to do. Deep sleep needs no special handling: the idle task,
+ * and so vApplicationIdleHook(), only runs once the worker and the VM task are
+ * both blocked.
+ *
+ * A job runs concurrently with the VM task. It must only use its own context
+ * and traps, it must not call into VM task libraries that aren't thread safe.
+ */
+
+#ifndef MESSAGE_WORKER_H_
+#define MESSAGE_WORKER_H_
+
+#include <message.h>
+
+#include "hydra/hydra_types.h"
+
+/**
+ * \brief Create the worker task and its job queue.
+ *
+ * Called once from init_sched(), the task starts running with the scheduler.
+ */
+void init_message_worker(void);
+
+/**
+ * \brief Post a job to the worker task.
+ *
+ * \param [in] fn  The job, called on the worker task.
+ * \param [in] context  Passed to \p fn, and returned in the done message.
+ * \param [in] done_task  The VM task to send #MESSAGE_WORKER_DONE to once
+ * \p fn has returned, or NULL for no message. It must remain valid until the
+ * message is delivered.
+ *
+ * \return TRUE if the job was posted, FALSE if the worker task hasn't been
+ * created yet.
+ */
+bool message_worker_post(MessageWorkerFn fn, void *context, Task done_task);
+
+/**
+ * \brief Determine whether the worker task is currently running.
+ *
+ * \return TRUE if called from a worker job, FALSE otherwise.
+ */
+bool message_worker_in_worker(void);
+
+#endif /* !MESSAGE_WORKER_H_ */
@@ -18,6 +18,17 @@
 #include "task_registry.h"
 #include "trap_api/trap_api_private.h"
 #include "message_queue_multitask_message.h"
+#include "message_telemetry.h"
+#include "message_continuation.h"
+#include "hydra_log/hydra_log.h"
+
+/**
+ * \brief The default handler execution time, in microseconds, above which
+ * a VM task handler or continuation slice is logged. 0 disables the check.
+ */
+#ifndef MESSAGING_HANDLER_BUDGET_US
+#define MESSAGING_HANDLER_BUDGET_US 10000
+#endif
 
 /**
  * \brief Global list of unfreed messages delivered to the application.
@@ -33,6 +44,11 @@
  */
 static message_queue_task_message_t *messages_delivered_but_not_freed = NULL;
 
+/**
+ * \brief The handler execution time budget in microseconds, 0 if disabled.
+ */
+static uint32 messaging_handler_budget_us = MESSAGING_HANDLER_BUDGET_US;
+
 /**
  * \brief Validate the message send parameters.
  *
@@ -86,6 +102,17 @@ messages_delivered_list_insert(message_queue_task_message_t *task_message);
 static message_queue_task_message_t *messages_delivered_list_find(
     MessageId id, Message app_message);
 
+/**
+ * \brief Execute the handler for a message delivered to a VM task.
+ *
+ * Times the handler, logging it if it goes over the budget.
+ *
+ * \param [in] vm_queue  The VM queue the message was taken from.
+ * \param [in] task_message  The delivered message.
+ */
+static void messaging_execute_vm(message_queue_t *vm_queue,
+                                 message_queue_task_message_t *task_message);
+
 void messaging_send(const Task *tasks, uint8 num_tasks, MessageId id,
                     Message app_message, MILLITIME delay_ms,
                     const void *condition_addr, CONDITION_WIDTH condition_width)
@@ -260,7 +287,7 @@ message_queue_events_t messaging_queue_wait_vm(message_queue_t *vm_queue)
             messages_delivered_list_insert(task_message);
         }
 
-        message_queue_task_message_execute(task_message);
+        messaging_execute_vm(vm_queue, task_message);
 
         if(NULL != app_message)
         {
@@ -279,6 +306,54 @@ message_queue_events_t messaging_queue_wait_vm(message_queue_t *vm_queue)
     return events;
 }
 
+static void messaging_execute_vm(message_queue_t *vm_queue,
+                                 message_queue_task_message_t *task_message)
+{
+    /* The handler is read before execution as the task may be freed by its
+       own handler. */
+    message_queue_handler_t handler =
+        task_message->task ? task_message->task->handler : NULL;
+    uint32 elapsed_us;
+    TIME started;
+#ifdef INSTALL_MESSAGE_TELEMETRY
+    MILLITIME delivered_ms = get_milli_time();
+    message_queue_stats_t stats;
+
+    message_queue_get_stats(vm_queue, &stats);
+#else /* INSTALL_MESSAGE_TELEMETRY */
+    UNUSED(vm_queue);
+#endif /* INSTALL_MESSAGE_TELEMETRY */
+
+    started = get_time();
+    message_queue_task_message_execute(task_message);
+    elapsed_us = (uint32)time_sub(get_time(), started);
+
+    if(messaging_handler_over_budget(elapsed_us))
+    {
+        L1_DBG_MSG3("messaging: handler 0x%08x took %u us for message 0x%04x",
+                    (uint32)handler, elapsed_us, task_message->message->id);
+    }
+
+#ifdef INSTALL_MESSAGE_TELEMETRY
+    message_telemetry_record(task_message, handler, delivered_ms, elapsed_us,
+                             stats.queued);
+#endif /* INSTALL_MESSAGE_TELEMETRY */
+}
+
+uint32 messaging_handler_budget_set(uint32 budget_us)
+{
+    uint32 previous_us = messaging_handler_budget_us;
+
+    messaging_handler_budget_us = budget_us;
+    return previous_us;
+}
+
+bool messaging_handler_over_budget(uint32 elapsed_us)
+{
+    return 0 != messaging_handler_budget_us &&
+           elapsed_us > messaging_handler_budget_us;
+}
+
 MessageQueue messaging_queue_create(void)
 {
     MessageQueue handle = 0;
@@ -567,6 +642,7 @@ uint16 messaging_task_flush(Task task)
 
     task_registry_remove(task);
     stream_task_registry_remove(task);
+    (void)message_continuation_cancel(task);
 
     dest = message_router_route((MessageQueue)task);
     return message_queue_cancel_messages(dest, task, /*id=*/NULL,
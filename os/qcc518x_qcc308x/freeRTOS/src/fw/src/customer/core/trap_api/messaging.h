@@ -256,4 +256,23 @@ uint16 messaging_task_flush(Task task);
  */
 message_queue_events_t messaging_queue_wait_vm(message_queue_t *vm_queue);
 
+/**
+ * \brief Set the VM task handler execution time budget.
+ *
+ * Any VM task handler or continuation slice that runs for longer than the
+ * budget is logged.
+ *
+ * \param[in] budget_us  The budget in microseconds, 0 to disable the check.
+ * \return The previous budget.
+ */
+uint32 messaging_handler_budget_set(uint32 budget_us);
+
+/**
+ * \brief Check a handler execution time against the budget.
+ *
+ * \param[in] elapsed_us  The time the handler took in microseconds.
+ * \return TRUE if the budget is enabled and \p elapsed_us exceeds it.
+ */
+bool messaging_handler_over_budget(uint32 elapsed_us);
+
 #endif /* !MESSAGING_H */
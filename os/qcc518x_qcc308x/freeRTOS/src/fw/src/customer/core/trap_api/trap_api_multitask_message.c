@@ -19,6 +19,8 @@
 #include <stream.h>
 
 #include "messaging.h"
+#include "message_continuation.h"
+#include "message_worker.h"
 #include "hydra/hydra_macros.h"
 #include "task_registry.h"
 #include "stream_task_registry.h"
@@ -237,6 +239,26 @@ MessageId MessageQueueWait(MessageQueue queue, Message *msg)
 {
     return messaging_queue_wait(queue, msg);
 }
+
+bool MessageContinuationPost(Task task, MessageContinuationFn fn, void *context)
+{
+    return message_continuation_post(task, fn, context);
+}
+
+uint16 MessageContinuationCancel(Task task)
+{
+    return message_continuation_cancel(task);
+}
+
+uint32 MessageHandlerBudgetSet(uint32 budget_us)
+{
+    return messaging_handler_budget_set(budget_us);
+}
+
+bool MessageWorkerPost(MessageWorkerFn fn, void *context, Task done_task)
+{
+    return message_worker_post(fn, context, done_task);
+}
 #endif /* TRAPSET_OSAL */
 
 /**
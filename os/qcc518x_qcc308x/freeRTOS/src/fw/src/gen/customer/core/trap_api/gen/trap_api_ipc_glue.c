@@ -401,7 +401,7 @@ void SourceDrop(Source source, uint16 amount)
     IPC_SOURCE_DROP ipc_send_prim;
     ipc_send_prim.source = SOURCE_TO_ID(source);
     ipc_send_prim.amount = amount;
-    ipc_send(IPC_SIGNAL_ID_SOURCE_DROP, &ipc_send_prim, sizeof(ipc_send_prim));
+    ipc_send_batched(IPC_SIGNAL_ID_SOURCE_DROP, &ipc_send_prim, sizeof(ipc_send_prim));
 }
 
 
@@ -623,6 +623,65 @@ void MessageQueueDestroy(MessageQueue queue);
  * \ingroup trapset_osal
  */
 MessageId MessageQueueWait(MessageQueue queue, Message * msg);
+
+/**
+ *  \brief Post continuation work for a VM task.
+ * Handlers run to completion on the VM task, so a handler with a lot of work
+ *  to do delays every other message. Instead it can post a continuation that
+ *  does a bounded slice of the work each time it is called. The VM task calls
+ *  one pending continuation slice after each message it delivers, taking the
+ *  pending continuations in turn, until the continuation returns FALSE.
+ * MessageFlushTask() cancels any continuations for the task.
+ * This function must only be called from the VM task.
+ *         
+ *  \param task The task the continuation is working for. 
+ *  \param fn Called once per slice, returns TRUE while there is more work to do.
+ *  \param context Passed to fn.
+ *  \return TRUE if the continuation was posted, FALSE if the same task and fn are
+ *  already pending.
+ * 
+ * \ingroup trapset_osal
+ */
+bool MessageContinuationPost(Task task, MessageContinuationFn fn, void * context);
+
+/**
+ *  \brief Cancel all the continuations for a VM task.
+ *  \param task The task to cancel continuations for.
+ *  \return The number of continuations cancelled.
+ * 
+ * \ingroup trapset_osal
+ */
+uint16 MessageContinuationCancel(Task task);
+
+/**
+ *  \brief Set the VM task handler execution time budget.
+ * Any message handler or continuation slice that runs for longer than the budget
+ *  is logged. The default budget is 10ms.
+ *         
+ *  \param budget_us The budget in microseconds, 0 to disable the check.
+ *  \return The previous budget.
+ * 
+ * \ingroup trapset_osal
+ */
+uint32 MessageHandlerBudgetSet(uint32 budget_us);
+
+/**
+ *  \brief Post a job to the worker task.
+ * The worker task runs below the VM task's priority, so a long job such as a
+ *  signature check runs whenever the VM task has no messages to deliver rather
+ *  than delaying them. Jobs run one at a time in the order they were posted.
+ * A job runs concurrently with the VM task, it must only use its own context
+ *  and traps, not VM task libraries.
+ *         
+ *  \param fn The job, called on the worker task. 
+ *  \param context Passed to fn.
+ *  \param done_task The task to send \#MESSAGE_WORKER_DONE to once fn has
+ *  returned, or NULL for no message.
+ *  \return TRUE if the job was posted.
+ * 
+ * \ingroup trapset_osal
+ */
+bool MessageWorkerPost(MessageWorkerFn fn, void * context, Task done_task);
 #endif /* TRAPSET_OSAL */
 #if TRAPSET_ATT
 
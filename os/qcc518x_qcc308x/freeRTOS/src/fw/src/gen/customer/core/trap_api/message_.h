@@ -31,6 +31,14 @@ Match function type.
 */
 typedef bool (*MessageMatchFn)(Task, MessageId, Message Payload);
 /*!
+Continuation function type, returns TRUE while there is more work to do.
+*/
+typedef bool (*MessageContinuationFn)(Task task, void *context);
+/*!
+Worker job function type.
+*/
+typedef void (*MessageWorkerFn)(void *context);
+/*!
 Interpret a MessageQueue as a Task
 */
 #define MessageQueueAsTask(_queue) ((Task)(_queue))
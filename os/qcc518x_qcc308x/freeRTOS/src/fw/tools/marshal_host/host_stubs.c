@@ -0,0 +1,87 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacements for the firmware services the marshal library uses.
+ */
+
+#include "pmalloc/pmalloc.h"
+#include <panic.h>
+#include <rtime.h>
+
+#include <stdio.h>
+#include <string.h>
+
+void *host_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+
+    if(NULL == ptr)
+    {
+        fprintf(stderr, "out of memory\n");
+        abort();
+    }
+    return ptr;
+}
+
+void *host_zmalloc(size_t size)
+{
+    void *ptr = host_malloc(size);
+
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void *host_realloc(void *ptr, size_t size)
+{
+    ptr = realloc(ptr, size);
+
+    if(NULL == ptr)
+    {
+        fprintf(stderr, "out of memory\n");
+        abort();
+    }
+    return ptr;
+}
+
+bool HostPanicIf(bool cond, const char *file, int line)
+{
+    if(cond)
+    {
+        fprintf(stderr, "%s:%d: panic\n", file, line);
+        abort();
+    }
+    return TRUE;
+}
+
+void *HostPanicNull(void *p, const char *file, int line)
+{
+    (void)HostPanicIf(NULL == p, file, line);
+    return p;
+}
+
+/* The peer's wallclock is offset from the local clock. */
+#define WALLCLOCK_OFFSET (0x12345678u)
+
+bool RtimeWallClockGetStateForSink(wallclock_state_t *state, Sink sink)
+{
+    UNUSED(state);
+    UNUSED(sink);
+    return TRUE;
+}
+
+bool RtimeLocalToWallClock(wallclock_state_t *state, rtime_t local,
+                           rtime_t *wallclock)
+{
+    UNUSED(state);
+    *wallclock = local + WALLCLOCK_OFFSET;
+    return TRUE;
+}
+
+bool RtimeWallClockToLocal(wallclock_state_t *state, rtime_t wallclock,
+                           rtime_t *local)
+{
+    UNUSED(state);
+    *local = wallclock - WALLCLOCK_OFFSET;
+    return TRUE;
+}
@@ -0,0 +1,20 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's assert.h.
+ */
+#ifndef MARSHAL_HOST_ASSERT_H
+#define MARSHAL_HOST_ASSERT_H
+
+#include_next <assert.h>
+
+#define assert_uses_param(x) ((void)(x))
+#define assert_fn(expr) \
+    do { bool assert_ret_ = (expr); assert(assert_ret_); \
+         (void)assert_ret_; } while(0)
+#define assert_fn_ret(expr, type, value) \
+    do { type assert_ret_ = (expr); assert(assert_ret_ == (value)); \
+         (void)assert_ret_; } while(0)
+
+#endif /* MARSHAL_HOST_ASSERT_H */
@@ -0,0 +1,17 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the ADK's bandwidth_manager.h.
+ */
+#ifndef MARSHAL_HOST_BANDWIDTH_MANAGER_H
+#define MARSHAL_HOST_BANDWIDTH_MANAGER_H
+
+#include <csrtypes.h>
+
+typedef void (*bandwidth_manager_callback_t)(bool throttle_required);
+
+/** As many features as the ADK defines. */
+#define BANDWIDTH_MGR_FEATURE_MAX   (8)
+
+#endif /* MARSHAL_HOST_BANDWIDTH_MANAGER_H */
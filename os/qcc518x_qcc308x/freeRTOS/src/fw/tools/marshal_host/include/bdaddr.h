@@ -0,0 +1,19 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the Bluetooth address types, from bdaddr_.h.
+ */
+#ifndef MARSHAL_HOST_BDADDR_H
+#define MARSHAL_HOST_BDADDR_H
+
+#include <csrtypes.h>
+
+typedef struct { uint32 lap; uint8 uap; uint16 nap; } bdaddr;
+typedef struct { uint8 type; bdaddr addr; } typed_bdaddr;
+/* An enumeration in bdaddr_.h, which the target sizes to one octet. */
+typedef uint8 TRANSPORT_T;
+enum {TRANSPORT_BREDR_ACL, TRANSPORT_BLE_ACL, TRANSPORT_NONE = 0xFF};
+typedef struct { typed_bdaddr taddr; TRANSPORT_T transport; } tp_bdaddr;
+
+#endif /* MARSHAL_HOST_BDADDR_H */
@@ -0,0 +1,22 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the ADK's basic types, see hydra/hydra_types.h.
+ */
+#ifndef MARSHAL_HOST_CSRTYPES_H
+#define MARSHAL_HOST_CSRTYPES_H
+
+#include "hydra/hydra_types.h"
+
+typedef uint16 MessageId;
+typedef const void *Message;
+typedef struct TaskData
+{
+    void (*handler)(struct TaskData *task, MessageId id, Message message);
+} TaskData;
+typedef TaskData *Task;
+typedef struct SINK_T *Sink;
+typedef uint32 Delay;
+
+#endif /* MARSHAL_HOST_CSRTYPES_H */
@@ -0,0 +1,35 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the ADK's domain_marshal_types.h, numbering only
+ * the domain types the harness uses after the common types.
+ */
+#ifndef MARSHAL_HOST_DOMAIN_MARSHAL_TYPES_H
+#define MARSHAL_HOST_DOMAIN_MARSHAL_TYPES_H
+
+#include "marshal_common.h"
+
+/** The audio router's sources, one octet enumerations in the ADK. */
+typedef uint8 audio_source_t;
+typedef uint8 voice_source_t;
+
+#include "bt_device_marshal_typedef.h"
+#include "bt_device_handover_marshal_typedef.h"
+#include "bandwidth_manager_marshal_typedef.h"
+
+#define MARSHAL_TYPE_hfp_profile MARSHAL_TYPE_uint16
+#define MARSHAL_TYPE_bool MARSHAL_TYPE_uint8
+
+#define EXPAND_AS_ENUMERATION(type) MARSHAL_TYPE(type),
+enum
+{
+    LAST_COMMON_MARSHAL_TYPE = NUMBER_OF_COMMON_MARSHAL_OBJECT_TYPES - 1,
+    BT_DEVICE_MARSHAL_TYPES_TABLE(EXPAND_AS_ENUMERATION)
+    BT_DEVICE_HANDOVER_MARSHAL_TYPES_TABLE(EXPAND_AS_ENUMERATION)
+    BANDWIDTH_MANAGER_MARSHAL_TYPES_TABLE(EXPAND_AS_ENUMERATION)
+    NUMBER_OF_DOMAIN_MARSHAL_OBJECT_TYPES
+};
+#undef EXPAND_AS_ENUMERATION
+
+#endif /* MARSHAL_HOST_DOMAIN_MARSHAL_TYPES_H */
@@ -0,0 +1,13 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The ADK includes the firmware's hydra_macros.h without its directory.
+ */
+#ifndef MARSHAL_HOST_HYDRA_MACROS_H
+#define MARSHAL_HOST_HYDRA_MACROS_H
+
+#include <csrtypes.h>
+#include "hydra/hydra_macros.h"
+
+#endif /* MARSHAL_HOST_HYDRA_MACROS_H */
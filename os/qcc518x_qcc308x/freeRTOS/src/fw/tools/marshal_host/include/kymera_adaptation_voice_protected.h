@@ -0,0 +1,21 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the ADK's kymera_adaptation_voice_protected.h.
+ */
+#ifndef MARSHAL_HOST_KYMERA_ADAPTATION_VOICE_PROTECTED_H
+#define MARSHAL_HOST_KYMERA_ADAPTATION_VOICE_PROTECTED_H
+
+#include <csrtypes.h>
+
+typedef enum
+{
+    hfp_codec_mode_none,
+    hfp_codec_mode_narrowband,
+    hfp_codec_mode_wideband,
+    hfp_codec_mode_ultra_wideband,
+    hfp_codec_mode_super_wideband
+} hfp_codec_mode_t;
+
+#endif /* MARSHAL_HOST_KYMERA_ADAPTATION_VOICE_PROTECTED_H */
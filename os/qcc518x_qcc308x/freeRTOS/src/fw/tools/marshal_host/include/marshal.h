@@ -0,0 +1,14 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the marshal traps' header. The harness calls the
+ * firmware's marshal library directly, see marshal_host.c.
+ */
+#ifndef MARSHAL_HOST_MARSHAL_H
+#define MARSHAL_HOST_MARSHAL_H
+
+#include <csrtypes.h>
+#include <app/marshal/marshal_if.h>
+
+#endif /* MARSHAL_HOST_MARSHAL_H */
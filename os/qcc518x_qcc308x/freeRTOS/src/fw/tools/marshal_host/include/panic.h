@@ -0,0 +1,23 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the panic traps, see host_stubs.c.
+ */
+#ifndef MARSHAL_HOST_PANIC_H
+#define MARSHAL_HOST_PANIC_H
+
+#include <csrtypes.h>
+
+#define PanicFalse(x)       PanicZero(x)
+#define PanicZero(x)        ((unsigned int)HostPanicIf(!(x), __FILE__, __LINE__))
+#define PanicNull(x)        HostPanicNull((x), __FILE__, __LINE__)
+#define Panic()             HostPanicIf(TRUE, __FILE__, __LINE__)
+
+/** Report the caller's file and line and exit if \c cond is TRUE. */
+bool HostPanicIf(bool cond, const char *file, int line);
+
+/** Report the caller's file and line and exit if \c p is NULL. */
+void *HostPanicNull(void *p, const char *file, int line);
+
+#endif /* MARSHAL_HOST_PANIC_H */
@@ -0,0 +1,11 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the ADK's peer_ui.h, which peer_ui.typedef includes
+ * for nothing the marshal types need.
+ */
+#ifndef MARSHAL_HOST_PEER_UI_H
+#define MARSHAL_HOST_PEER_UI_H
+
+#endif /* MARSHAL_HOST_PEER_UI_H */
@@ -0,0 +1,27 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's pool allocator.
+ */
+#ifndef PMALLOC_H
+#define PMALLOC_H
+
+#include <stdlib.h>
+
+#define pmalloc(size)       host_malloc(size)
+#define zpmalloc(size)      host_zmalloc(size)
+#define prealloc(ptr, size) host_realloc((ptr), (size))
+#define pnew(type)          ((type *)pmalloc(sizeof(type)))
+#define pfree(ptr)          free((void *)(ptr))
+
+/** malloc() that aborts when out of memory, like pmalloc(). */
+void *host_malloc(size_t size);
+
+/** Zeroed host_malloc(), like zpmalloc(). */
+void *host_zmalloc(size_t size);
+
+/** realloc() that aborts when out of memory, like prealloc(). */
+void *host_realloc(void *ptr, size_t size);
+
+#endif /* PMALLOC_H */
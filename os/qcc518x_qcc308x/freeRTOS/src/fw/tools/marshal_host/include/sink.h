@@ -0,0 +1,12 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the sink traps' header, Sink is in csrtypes.h.
+ */
+#ifndef MARSHAL_HOST_SINK_H
+#define MARSHAL_HOST_SINK_H
+
+#include <csrtypes.h>
+
+#endif /* MARSHAL_HOST_SINK_H */
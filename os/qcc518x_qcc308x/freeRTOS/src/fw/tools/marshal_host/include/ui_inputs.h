@@ -0,0 +1,15 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the ADK's ui_inputs.h.
+ */
+#ifndef MARSHAL_HOST_UI_INPUTS_H
+#define MARSHAL_HOST_UI_INPUTS_H
+
+#include <csrtypes.h>
+
+/** Marshalled as a uint16, see peer_ui.typedef. */
+typedef uint16 ui_input_t;
+
+#endif /* MARSHAL_HOST_UI_INPUTS_H */
@@ -0,0 +1,679 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host test and benchmark for the marshal library.
+ *
+ *   marshal_host check [--seed N] [--steps N]
+ *   marshal_host bench [--seed N] [--nodes N]
+ *
+ * check applies a random mix of pushes, pops, removals, lookups, iterations
+ * and difference updates to both the marshal object set and the linked list
+ * set it replaced, see ref_object_set.c, and compares every result. Objects
+ * of different types share addresses and NULL addresses are included, as a
+ * NULL address matches objects of any type. It then checks that marshalling
+ * graphs of every benchmarked size looks up the same indexes with both sets.
+ *
+ * check also marshals random objects of the peer signalling and handover
+ * types in specialised_types.c with the type descriptors and with the
+ * functions typegen specialises for them. The byte streams must be identical,
+ * and each must unmarshal with the other to an object that marshals to the
+ * same stream.
+ *
+ * bench times the object set calls marshal() makes for graphs of 10 to 1000
+ * nodes, see object_set_graph.c, with both sets. The set holds at most
+ * MOBS_MAX_OBJECTS, so graphs of more than GRAPH_BATCH_MAX nodes are
+ * marshalled in batches with the set cleared between them.
+ *
+ * bench then times marshalling and unmarshalling the peer signalling and
+ * handover types three ways: as peer signalling does with the type
+ * descriptors, initialising the marshaller and sizing the stream for every
+ * message; with a marshaller that is initialised once; and with the
+ * specialised functions, sizing the stream first as peer signalling does.
+ *
+ * The host's thread CPU time is used.
+ */
+
+#include "object_set_graph.h"
+#include "ref_object_set.h"
+#include "specialised_types.h"
+#include "pmalloc/pmalloc.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define POOL_ADDRESSES  (160)
+#define POOL_TYPES      (3)
+#define COMPARE_EVERY   (64)
+#define BENCH_MIN_NS    (100000000ull)
+#define OBJECTS_CHECKED (1000)
+#define STREAM_MAX      (256)
+#define OP_MIN_NS       (25000000ull)
+#define OP_BATCH        (1000)
+
+static const uint32 bench_nodes[] = {10, 50, 100, 200, 254, 500, 1000};
+
+static uint32 pool[POOL_ADDRESSES];
+static uint32 rng_state;
+static uint32 step;
+
+static uint32 rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32 rng_below(uint32 n)
+{
+    return rng() % n;
+}
+
+static void fail(const char *what)
+{
+    fprintf(stderr, "step %u: %s\n", step, what);
+    exit(1);
+}
+
+#define CHECK(cond) do { if(!(cond)) fail(#cond); } while(0)
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/** A random object from the pool, which includes the NULL address. */
+static void random_object(mob_t *object)
+{
+    uint32 address = rng_below(POOL_ADDRESSES + 1);
+
+    object->address = address ? &pool[address - 1] : NULL;
+    object->type = (marshal_type_t)rng_below(POOL_TYPES);
+    object->disambiguator = (uint8)rng();
+}
+
+static bool same_object(const mob_t *a, const mob_t *b)
+{
+    return a->address == b->address && a->type == b->type &&
+           a->disambiguator == b->disambiguator;
+}
+
+static void compare_sets(mobs_t *set, ref_mobs_t *ref)
+{
+    uint32 index;
+
+    CHECK(mobs_size(set) == ref_mobs_size(ref));
+    for(index = 0; index <= mobs_size(set); ++index)
+    {
+        mob_t object = MOB_ZERO();
+        mob_t ref_object = MOB_ZERO();
+        bool got = mobs_get_object(set, (mob_index_t)index, &object);
+
+        CHECK(got == ref_mobs_get_object(ref, (mob_index_t)index, &ref_object));
+        CHECK(!got || same_object(&object, &ref_object));
+    }
+}
+
+/* Iteration results are recorded in these, from the callbacks. */
+static mob_t iterated[MOBS_MAX_OBJECTS];
+static mob_t ref_iterated[MOBS_MAX_OBJECTS];
+static uint32 iterated_count;
+static uint32 ref_iterated_count;
+static uint32 iterate_limit;
+
+static bool record_iterated(mobs_t *set, mob_index_t index, mob_t *object)
+{
+    UNUSED(set);
+    CHECK(index == iterated_count);
+    iterated[iterated_count++] = *object;
+    return iterated_count < iterate_limit;
+}
+
+static bool record_ref_iterated(ref_mobs_t *set, mob_index_t index,
+                                mob_t *object)
+{
+    UNUSED(set);
+    CHECK(index == ref_iterated_count);
+    ref_iterated[ref_iterated_count++] = *object;
+    return ref_iterated_count < iterate_limit;
+}
+
+static void check_iterate(mobs_t *set, ref_mobs_t *ref)
+{
+    mob_index_t start = (mob_index_t)rng_below(mobs_size(set) + 1u);
+    bool completed;
+    uint32 i;
+
+    iterated_count = ref_iterated_count = start;
+    iterate_limit = start + 1 + rng_below(MOBS_MAX_OBJECTS);
+    completed = mobs_iterate(set, start, record_iterated);
+    CHECK(completed == ref_mobs_iterate(ref, start, record_ref_iterated));
+    CHECK(iterated_count == ref_iterated_count);
+    for(i = start; i < iterated_count; ++i)
+    {
+        CHECK(same_object(&iterated[i], &ref_iterated[i]));
+    }
+}
+
+static void check_difference_update(mobs_t *set, ref_mobs_t *ref)
+{
+    uint32 removals = rng_below(8);
+    ref_mobs_t ref_remove;
+    mobs_t remove;
+
+    mobs_init(&remove);
+    ref_mobs_init(&ref_remove);
+    while(removals--)
+    {
+        mob_t object;
+
+        random_object(&object);
+        CHECK(mobs_push(&remove, &object) ==
+              ref_mobs_push(&ref_remove, &object));
+    }
+    mobs_difference_update(set, &remove);
+    ref_mobs_difference_update(ref, &ref_remove);
+    mobs_destroy(&remove);
+    ref_mobs_destroy(&ref_remove);
+}
+
+/**
+ * \brief Apply one random operation to both sets.
+ */
+static void check_step(mobs_t *set, ref_mobs_t *ref)
+{
+    mob_index_t index = MOBS_INVALID_INDEX;
+    mob_index_t ref_index = MOBS_INVALID_INDEX;
+    mob_t object = MOB_ZERO();
+    mob_t ref_object = MOB_ZERO();
+    bool full = mobs_size(set) >= MOBS_MAX_OBJECTS;
+    uint32 op = rng_below(100);
+
+    /* Alternately fill the set to its limit and empty it, so the index is
+       resized both ways. */
+    if(0 != ((step / 20000) & 1))
+    {
+        op = op < 50 ? 50 + op : op;
+    }
+    else if(op >= 65 && op < 85 && rng_below(2))
+    {
+        op = 0;
+    }
+
+    random_object(&object);
+    if(op < 40)
+    {
+        if(!full)
+        {
+            CHECK(mobs_push(set, &object) == ref_mobs_push(ref, &object));
+        }
+    }
+    else if(op < 50)
+    {
+        if(!full && !ref_mobs_has_object(ref, &object, NULL))
+        {
+            mobs_push_unique(set, &object);
+            ref_mobs_push_unique(ref, &object);
+        }
+    }
+    else if(op < 65)
+    {
+        bool has = mobs_has_object(set, &object, &index);
+
+        CHECK(has == ref_mobs_has_object(ref, &object, &ref_index));
+        CHECK(!has || index == ref_index);
+    }
+    else if(op < 75)
+    {
+        bool popped = mobs_pop(set, &object);
+
+        CHECK(popped == ref_mobs_pop(ref, &ref_object));
+        CHECK(!popped || same_object(&object, &ref_object));
+    }
+    else if(op < 85)
+    {
+        /* Remove an object in the set more often than not. */
+        if(mobs_size(set) && rng_below(4))
+        {
+            index = (mob_index_t)rng_below(mobs_size(set));
+            CHECK(mobs_get_object(set, index, &object));
+        }
+        if(ref_mobs_size(ref))
+        {
+            CHECK(mobs_remove(set, &object) == ref_mobs_remove(ref, &object));
+        }
+    }
+    else if(op < 92)
+    {
+        check_iterate(set, ref);
+    }
+    else if(ref_mobs_size(ref))
+    {
+        check_difference_update(set, ref);
+    }
+
+    if(0 == step % COMPARE_EVERY)
+    {
+        compare_sets(set, ref);
+    }
+}
+
+/**
+ * \brief Build a graph, each node pointing to a random node in its batch or,
+ * one time in eight, to NULL.
+ * \return The nodes, each allocated separately.
+ */
+static graph_node_t **make_graph(uint32 count)
+{
+    graph_node_t **nodes = host_malloc(count * sizeof(*nodes));
+    uint32 batches = GRAPH_BATCHES(count);
+    uint32 batch;
+    uint32 i;
+
+    for(i = 0; i < count; ++i)
+    {
+        nodes[i] = pnew(graph_node_t);
+        nodes[i]->value = rng();
+    }
+    for(batch = 0; batch < batches; ++batch)
+    {
+        uint32 start = GRAPH_BATCH_START(count, batches, batch);
+        uint32 end = GRAPH_BATCH_START(count, batches, batch + 1);
+
+        for(i = start; i < end; ++i)
+        {
+            nodes[i]->other = rng_below(8) ?
+                nodes[start + rng_below(end - start)] : NULL;
+        }
+    }
+    return nodes;
+}
+
+static void free_graph(graph_node_t **nodes, uint32 count)
+{
+    uint32 i;
+
+    for(i = 0; i < count; ++i)
+    {
+        pfree(nodes[i]);
+    }
+    pfree(nodes);
+}
+
+/**
+ * \brief Marshal an object with the type descriptors, as peer signalling does.
+ * \return The length of the stream.
+ */
+static size_t descriptor_marshal(const specialised_type_t *t, void *object,
+                                 uint8 *buf)
+{
+    marshaller_t m = marshal_init(t->type_desc, t->num_type_desc);
+    size_t size;
+
+    marshal_set_buffer(m, NULL, 0);
+    (void)marshal(m, object, t->type);
+    size = marshal_remaining(m);
+    CHECK(size <= STREAM_MAX);
+
+    marshal_set_buffer(m, buf, size);
+    CHECK(marshal(m, object, t->type));
+    CHECK(marshal_produced(m) == size);
+    marshal_destroy(m, FALSE);
+    return size;
+}
+
+/**
+ * \brief Unmarshal an object with the type descriptors, as peer signalling
+ * does.
+ * \return The object, or NULL if the stream did not hold one of the type.
+ */
+static void *descriptor_unmarshal(const specialised_type_t *t,
+                                  const uint8 *buf, size_t size)
+{
+    unmarshaller_t u = unmarshal_init(t->type_desc, t->num_type_desc);
+    marshal_type_t type;
+    void *object = NULL;
+
+    unmarshal_set_buffer(u, buf, size);
+    if(!unmarshal(u, &object, &type))
+    {
+        object = NULL;
+    }
+    else
+    {
+        CHECK(type == t->type);
+        CHECK(unmarshal_consumed(u) == size);
+    }
+    unmarshal_destroy(u, FALSE);
+    return object;
+}
+
+static size_t specialised_marshal(const specialised_type_t *t,
+                                  const void *object, uint8 *buf)
+{
+    size_t size = 0;
+    size_t produced = 0;
+
+    CHECK(!t->specialised.marshal(object, t->type, NULL, 0, &size));
+    CHECK(size <= STREAM_MAX);
+    CHECK(!t->specialised.marshal(object, t->type, buf, size - 1, &produced));
+    CHECK(t->specialised.marshal(object, t->type, buf, size, &produced));
+    CHECK(produced == size);
+    return size;
+}
+
+static void *random_typed_object(const specialised_type_t *t)
+{
+    uint8 *object = host_malloc(t->size);
+    size_t i;
+
+    for(i = 0; i < t->size; ++i)
+    {
+        object[i] = (uint8)rng();
+    }
+    if(t->prepare)
+    {
+        t->prepare(object);
+    }
+    return object;
+}
+
+static void check_specialised_type(const specialised_type_t *t)
+{
+    uint8 stream[STREAM_MAX];
+    uint8 specialised[STREAM_MAX];
+    uint8 again[STREAM_MAX];
+    uint32 i;
+
+    for(i = 0; i < OBJECTS_CHECKED; ++i)
+    {
+        void *object = random_typed_object(t);
+        size_t consumed = 0;
+        size_t size = descriptor_marshal(t, object, stream);
+        void *copy;
+
+        CHECK(specialised_marshal(t, object, specialised) == size);
+        CHECK(0 == memcmp(stream, specialised, size));
+
+        /* The specialised unmarshal of the library's stream. */
+        copy = t->specialised.unmarshal(t->type, stream, size, &consumed);
+        CHECK(NULL != copy);
+        CHECK(consumed == size);
+        CHECK(descriptor_marshal(t, copy, again) == size);
+        CHECK(0 == memcmp(stream, again, size));
+        free(copy);
+
+        /* The library's unmarshal of the specialised stream. */
+        copy = descriptor_unmarshal(t, specialised, size);
+        CHECK(NULL != copy);
+        CHECK(specialised_marshal(t, copy, again) == size);
+        CHECK(0 == memcmp(stream, again, size));
+        pfree(copy);
+
+        /* A truncated stream is refused. */
+        CHECK(NULL == t->specialised.unmarshal(t->type, stream, size - 1,
+                                               &consumed));
+        pfree(object);
+    }
+}
+
+static int check(uint32 steps)
+{
+    ref_mobs_t ref;
+    mobs_t set;
+    uint32 i;
+
+    mobs_init(&set);
+    ref_mobs_init(&ref);
+    for(step = 0; step < steps; ++step)
+    {
+        check_step(&set, &ref);
+    }
+    compare_sets(&set, &ref);
+    mobs_destroy(&set);
+    ref_mobs_destroy(&ref);
+
+    for(i = 0; i < sizeof(bench_nodes) / sizeof(bench_nodes[0]); ++i)
+    {
+        graph_node_t **nodes = make_graph(bench_nodes[i]);
+
+        CHECK(object_set_graph_marshal(nodes, bench_nodes[i]) ==
+              object_set_graph_marshal_ref(nodes, bench_nodes[i]));
+        free_graph(nodes, bench_nodes[i]);
+    }
+
+    for(i = 0; i < specialised_types_len; ++i)
+    {
+        check_specialised_type(&specialised_types[i]);
+    }
+
+    printf("%u steps, graphs of %u to %u nodes, %u specialised types: ok\n",
+           steps, bench_nodes[0],
+           bench_nodes[sizeof(bench_nodes) / sizeof(bench_nodes[0]) - 1],
+           (unsigned)specialised_types_len);
+    return 0;
+}
+
+/**
+ * \brief Time marshalling a graph.
+ * \return The mean time in nanoseconds.
+ */
+static double time_graph(uint32 (*graph_marshal)(graph_node_t *const *, uint32),
+                         graph_node_t *const *nodes, uint32 count)
+{
+    volatile uint32 checksum = 0;
+    uint64_t start = now_ns();
+    uint64_t elapsed;
+    uint32 runs = 0;
+
+    do
+    {
+        checksum += graph_marshal(nodes, count);
+        ++runs;
+        elapsed = now_ns() - start;
+    } while(elapsed < BENCH_MIN_NS);
+
+    return (double)elapsed / runs;
+}
+
+static void bench_graph(uint32 count)
+{
+    graph_node_t **nodes = make_graph(count);
+    double new_ns = time_graph(object_set_graph_marshal, nodes, count);
+    double old_ns = time_graph(object_set_graph_marshal_ref, nodes, count);
+
+    printf("  %5u nodes %2u batches  new %8.1f us  old %8.1f us\n", count,
+           GRAPH_BATCHES(count), new_ns / 1000, old_ns / 1000);
+    free_graph(nodes, count);
+}
+
+/**
+ * An object of a specialised type and its stream, for timing.
+ */
+typedef struct
+{
+    const specialised_type_t *t;
+    void *object;
+    uint8 stream[STREAM_MAX];
+    size_t size;
+    marshaller_t m;
+    unmarshaller_t u;
+} type_bench_t;
+
+static void marshal_per_message(type_bench_t *b)
+{
+    (void)descriptor_marshal(b->t, b->object, b->stream);
+}
+
+static void marshal_reused(type_bench_t *b)
+{
+    marshal_set_buffer(b->m, b->stream, b->size);
+    (void)marshal(b->m, b->object, b->t->type);
+    marshal_clear_store(b->m);
+}
+
+static void marshal_specialised(type_bench_t *b)
+{
+    size_t size;
+
+    (void)b->t->specialised.marshal(b->object, b->t->type, NULL, 0, &size);
+    (void)b->t->specialised.marshal(b->object, b->t->type, b->stream, size,
+                                    &size);
+}
+
+static void unmarshal_per_message(type_bench_t *b)
+{
+    pfree(descriptor_unmarshal(b->t, b->stream, b->size));
+}
+
+static void unmarshal_reused(type_bench_t *b)
+{
+    marshal_type_t type;
+    void *object = NULL;
+
+    unmarshal_set_buffer(b->u, b->stream, b->size);
+    (void)unmarshal(b->u, &object, &type);
+    unmarshal_clear_store(b->u);
+    pfree(object);
+}
+
+static void unmarshal_specialised(type_bench_t *b)
+{
+    size_t consumed;
+
+    free(b->t->specialised.unmarshal(b->t->type, b->stream, b->size,
+                                     &consumed));
+}
+
+/**
+ * \brief Time an operation, in batches so reading the clock is not included.
+ * \return The mean time in nanoseconds.
+ */
+static double time_op(void (*op)(type_bench_t *), type_bench_t *b)
+{
+    uint64_t start = now_ns();
+    uint64_t elapsed;
+    uint32 runs = 0;
+
+    do
+    {
+        uint32 i;
+
+        for(i = 0; i < OP_BATCH; ++i)
+        {
+            op(b);
+        }
+        runs += OP_BATCH;
+        elapsed = now_ns() - start;
+    } while(elapsed < OP_MIN_NS);
+
+    return (double)elapsed / runs;
+}
+
+static void bench_specialised_type(const specialised_type_t *t)
+{
+    type_bench_t b;
+
+    b.t = t;
+    b.object = random_typed_object(t);
+    b.size = descriptor_marshal(t, b.object, b.stream);
+    b.m = marshal_init(t->type_desc, t->num_type_desc);
+    b.u = unmarshal_init(t->type_desc, t->num_type_desc);
+
+    printf("  %-32s %3u  %6.0f %6.0f %6.0f    %6.0f %6.0f %6.0f\n", t->name,
+           (unsigned)b.size,
+           time_op(marshal_per_message, &b), time_op(marshal_reused, &b),
+           time_op(marshal_specialised, &b),
+           time_op(unmarshal_per_message, &b), time_op(unmarshal_reused, &b),
+           time_op(unmarshal_specialised, &b));
+
+    marshal_destroy(b.m, FALSE);
+    unmarshal_destroy(b.u, FALSE);
+    pfree(b.object);
+}
+
+static int bench(uint32 nodes)
+{
+    uint32 i;
+
+    if(nodes)
+    {
+        bench_graph(nodes);
+        return 0;
+    }
+    for(i = 0; i < sizeof(bench_nodes) / sizeof(bench_nodes[0]); ++i)
+    {
+        bench_graph(bench_nodes[i]);
+    }
+
+    printf("\n  ns per object                    len  marshal                   "
+           "unmarshal\n"
+           "                                        message reused special.  "
+           "message reused special.\n");
+    for(i = 0; i < specialised_types_len; ++i)
+    {
+        bench_specialised_type(&specialised_types[i]);
+    }
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: marshal_host check [--seed N] [--steps N]\n"
+            "       marshal_host bench [--seed N] [--nodes N]\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32 steps = 200000;
+    uint32 nodes = 0;
+    uint32 seed = 1;
+    int i;
+
+    if(argc < 2)
+    {
+        usage();
+    }
+    for(i = 2; i < argc; ++i)
+    {
+        if(i + 1 >= argc)
+        {
+            usage();
+        }
+        if(0 == strcmp(argv[i], "--seed"))
+        {
+            seed = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--steps"))
+        {
+            steps = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--nodes"))
+        {
+            nodes = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            usage();
+        }
+    }
+    rng_state = seed ? seed : 1;
+
+    if(0 == strcmp(argv[1], "check"))
+    {
+        return check(steps);
+    }
+    if(0 == strcmp(argv[1], "bench"))
+    {
+        return bench(nodes);
+    }
+    usage();
+    return 2;
+}
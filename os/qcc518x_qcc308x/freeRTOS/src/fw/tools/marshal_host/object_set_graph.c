@@ -0,0 +1,146 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The calls marshal() makes on its object sets for a graph of nodes with one
+ * pointer member each, without the type descriptors and byte stream.
+ *
+ * Objects reached from a root are registered breadth first, the values of the
+ * new objects are visited and then the index of the object referred to by
+ * each pointer member is looked up, see marshal.c.
+ *
+ * This file is built twice, once with OBJECT_SET_GRAPH_REF defined to use the
+ * reference set in ref_object_set.c.
+ */
+
+#ifdef OBJECT_SET_GRAPH_REF
+#include "ref_object_set.h"
+#define mobs_t                      ref_mobs_t
+#define mobs_init                   ref_mobs_init
+#define mobs_destroy                ref_mobs_destroy
+#define mobs_push                   ref_mobs_push
+#define mobs_push_unique            ref_mobs_push_unique
+#define mobs_has_object             ref_mobs_has_object
+#define mobs_iterate                ref_mobs_iterate
+#define object_set_graph_marshal    object_set_graph_marshal_ref
+#endif
+
+#include "object_set_graph.h"
+#include "assert.h"
+
+#define NODE_TYPE   ((marshal_type_t)0)
+
+typedef struct
+{
+    mobs_t objects;
+    mobs_t pointer_members;
+    uint32 checksum;
+} graph_marshal_t;
+
+#define FROM_OBJECTS(set) \
+    ((graph_marshal_t *)((char *)(set) - offsetof(graph_marshal_t, objects)))
+#define FROM_POINTER_MEMBERS(set) \
+    ((graph_marshal_t *)((char *)(set) - \
+                         offsetof(graph_marshal_t, pointer_members)))
+
+static bool register_pointer_members(mobs_t *set, mob_index_t index,
+                                     mob_t *object)
+{
+    graph_marshal_t *g = FROM_OBJECTS(set);
+    graph_node_t *node = object->address;
+    mob_t referred;
+
+    UNUSED(index);
+
+    referred.type = NODE_TYPE;
+    referred.address = node->other;
+    referred.disambiguator = 0;
+    (void)mobs_push(&g->objects, &referred);
+
+    referred.address = &node->other;
+    mobs_push_unique(&g->pointer_members, &referred);
+    return TRUE;
+}
+
+static bool marshal_values(mobs_t *set, mob_index_t index, mob_t *object)
+{
+    graph_marshal_t *g = FROM_OBJECTS(set);
+    const graph_node_t *node = object->address;
+
+    UNUSED(index);
+
+    g->checksum += node->value;
+    return TRUE;
+}
+
+static bool marshal_pointer_indexes(mobs_t *set, mob_index_t index,
+                                    mob_t *object)
+{
+    graph_marshal_t *g = FROM_POINTER_MEMBERS(set);
+    mob_index_t referred_index = MOBS_INVALID_INDEX;
+    mob_t referred;
+
+    UNUSED(index);
+
+    referred.type = NODE_TYPE;
+    referred.address = *(void **)object->address;
+    referred.disambiguator = 0;
+    assert_fn(mobs_has_object(&g->objects, &referred, &referred_index));
+
+    g->checksum = g->checksum * 31 + referred_index;
+    return TRUE;
+}
+
+static void marshal_root(graph_marshal_t *g, graph_node_t *root)
+{
+    mob_index_t next_values_index = mobs_size(&g->objects);
+    mob_t object;
+
+    object.address = root;
+    object.type = NODE_TYPE;
+    object.disambiguator = 0;
+
+    if(mobs_push(&g->objects, &object))
+    {
+        assert_fn(mobs_iterate(&g->objects, next_values_index,
+                               register_pointer_members));
+        assert_fn(mobs_iterate(&g->objects, next_values_index,
+                               marshal_values));
+        assert_fn(mobs_iterate(&g->pointer_members, 0,
+                               marshal_pointer_indexes));
+
+        mobs_destroy(&g->pointer_members);
+        mobs_init(&g->pointer_members);
+    }
+}
+
+uint32 object_set_graph_marshal(graph_node_t *const *nodes, uint32 count)
+{
+    uint32 batches = GRAPH_BATCHES(count);
+    graph_marshal_t g;
+    uint32 batch;
+
+    g.checksum = 0;
+
+    for(batch = 0; batch < batches; ++batch)
+    {
+        uint32 end = GRAPH_BATCH_START(count, batches, batch + 1);
+        uint32 i = GRAPH_BATCH_START(count, batches, batch);
+        mob_t null_obj = MOB_ZERO();
+
+        mobs_init(&g.objects);
+        mobs_init(&g.pointer_members);
+        null_obj.type = MARSHAL_TYPES_MAX;
+        mobs_push_unique(&g.objects, &null_obj);
+
+        for( ; i < end; ++i)
+        {
+            marshal_root(&g, nodes[i]);
+        }
+        g.checksum += mobs_size(&g.objects);
+
+        mobs_destroy(&g.objects);
+        mobs_destroy(&g.pointer_members);
+    }
+    return g.checksum;
+}
@@ -0,0 +1,53 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Marshal object set workload of the marshaller, see object_set_graph.c.
+ */
+#ifndef OBJECT_SET_GRAPH_H
+#define OBJECT_SET_GRAPH_H
+
+#include "marshal_object_set.h"
+
+/**
+ * A graph node, with a single pointer member to another node in its batch.
+ */
+typedef struct graph_node_
+{
+    struct graph_node_ *other;
+    uint32 value;
+} graph_node_t;
+
+/** The most nodes marshalled with one object set. Index 0 of the set holds the
+ *  NULL object and the set is limited to MOBS_MAX_OBJECTS by the one octet
+ *  pointer index in the marshal byte stream. */
+#define GRAPH_BATCH_MAX (MOBS_MAX_OBJECTS - 1)
+
+/** The number of batches a graph of \c count nodes is split into. */
+#define GRAPH_BATCHES(count) (((count) + GRAPH_BATCH_MAX - 1) / GRAPH_BATCH_MAX)
+
+/** The first node of batch \c batch of \c batches, for a graph of \c count
+ *  nodes. Batch \c batches is the end of the graph. */
+#define GRAPH_BATCH_START(count, batches, batch) \
+    ((uint32)(((uint64_t)(count) * (batch)) / (batches)))
+
+/**
+ * \brief Marshal every node of a graph, as the marshaller uses the object set.
+ *
+ * Each node is marshalled in turn as a root, so nodes already reached through
+ * another node's pointer are skipped as duplicates. The object set is cleared
+ * between batches, as a caller must clear the marshaller's store before it
+ * fills.
+ *
+ * \param [in] nodes  The nodes, each pointing within its batch or to NULL.
+ * \param [in] count  The number of nodes.
+ * \return A checksum of the indexes written for the pointer members.
+ */
+uint32 object_set_graph_marshal(graph_node_t *const *nodes, uint32 count);
+
+/**
+ * \brief As object_set_graph_marshal(), with the reference set.
+ */
+uint32 object_set_graph_marshal_ref(graph_node_t *const *nodes, uint32 count);
+
+#endif /* OBJECT_SET_GRAPH_H */
@@ -0,0 +1,293 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The marshal object set before the address index, see ref_object_set.h.
+ */
+
+#include "ref_object_set.h"
+#include "assert.h"
+#include "pmalloc/pmalloc.h"
+/** Objects are stored in blocks. Block size may be changed to suit the size
+ *  of available pools. */
+#define BLOCK_SIZE 4
+#define BLOCK_SIZE_DIV_SHIFT 2
+
+struct ref_object_block
+{
+    struct ref_object_block *next;
+    void *address[BLOCK_SIZE];
+    marshal_type_t type[BLOCK_SIZE];
+    uint8 disambiguator[BLOCK_SIZE];
+};
+
+void ref_mobs_init(ref_mobs_t *set)
+{
+    set->head = NULL;
+    set->tail = NULL;
+    set->elements = 0;
+}
+
+void ref_mobs_destroy(ref_mobs_t *set)
+{
+    ref_mob_block_t *block;
+    ref_mob_block_t *next;
+    for (block = set->head; block; block = next)
+    {
+        next = block->next;
+        pfree(block);
+    }
+    set->head = NULL;
+    set->tail = NULL;
+    set->elements = 0;
+}
+
+void ref_mobs_push_unique(ref_mobs_t *set, mob_t *object)
+{
+    ref_mob_block_t *tail = set->tail;
+    mob_index_t index = set->elements % BLOCK_SIZE;
+
+    /* Limit size of set */
+    assert(set->elements < MOBS_MAX_OBJECTS);
+
+    if (index == 0)
+    {
+        tail = pmalloc(sizeof(*tail));
+        tail->next = NULL;
+        if (!set->head)
+        {
+            set->head = set->tail = tail;
+        }
+        else
+        {
+            set->tail = set->tail->next = tail;
+        }
+    }
+    tail->address[index] = object->address;
+    tail->type[index] = object->type;
+    tail->disambiguator[index] = object->disambiguator;
+
+    set->elements++;
+}
+
+bool ref_mobs_push(ref_mobs_t *set, mob_t *object)
+{
+    /* No duplicates */
+    if (!ref_mobs_has_object(set, object, NULL))
+    {
+        ref_mobs_push_unique(set, object);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+bool ref_mobs_pop(ref_mobs_t *set, mob_t *object)
+{
+    ref_mob_block_t *tail = set->tail;
+    mob_index_t index = (set->elements - 1) % BLOCK_SIZE;
+
+    if (set->elements)
+    {
+        if (object)
+        {
+            object->address = tail->address[index];
+            object->type = tail->type[index];
+            object->disambiguator = tail->disambiguator[index];
+        }
+
+        if (index == 0)
+        {
+            if (set->head == tail)
+            {
+                pfree(tail);
+                set->head = set->tail = NULL;
+            }
+            else
+            {
+                ref_mob_block_t **b;
+                for (b = &set->head; (*b)->next != tail; b = &(*b)->next)
+                    ;
+                pfree((*b)->next);
+                (*b)->next = NULL;
+                set->tail = *b;
+            }
+        }
+        --set->elements;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/* A consequence of using blocks (versus a single element list) is inefficient
+   object removal, since elements after the removed have to be 'shunted' into
+   the place of the removed element */
+bool ref_mobs_remove(ref_mobs_t *set, const mob_t *object)
+{
+    mob_index_t index;
+    ref_mob_block_t *b = set->head;
+
+    /* Two element pipeline of values for shunting across blocks boundaries */
+    void **addr0 = b->address;
+    void **addr1;
+    marshal_type_t *type0 = b->type;
+    marshal_type_t *type1;
+    uint8 *disam0 = b->disambiguator;
+    uint8 *disam1;
+
+    bool shunt = FALSE;
+
+    for (index = 0; index < set->elements; index++)
+    {
+        mob_index_t block_index = index % BLOCK_SIZE;
+
+        if (!block_index)
+        {
+            if (index)
+            {
+                b = b->next;
+                assert(b);
+            }
+        }
+        /* Pass addresses down the pipeline */
+        addr1 = addr0;
+        type1 = type0;
+        disam1 = disam0;
+        addr0 = b->address + block_index;
+        type0 = b->type + block_index;
+        disam0 = b->disambiguator + block_index;
+
+        if (shunt)
+        {
+            /* Overwrite previous index's values with this index's values */
+            *addr1 = *addr0;
+            *type1 = *type0;
+            *disam1 = *disam0;
+        }
+        else if ((*addr0 == object->address) && (*type0 == object->type))
+        {
+            shunt = TRUE;
+        }
+    }
+    if (shunt)
+    {
+        assert_fn(ref_mobs_pop(set, NULL));
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void ref_mobs_difference_update(ref_mobs_t *set, const ref_mobs_t *remove)
+{
+    mob_index_t index;
+    ref_mob_block_t *b = remove->head;
+
+    for (index = 0; index < remove->elements; index++)
+    {
+        mob_index_t block_index = index % BLOCK_SIZE;
+        mob_t object;
+
+        object.address = b->address[block_index];
+        object.type = b->type[block_index];
+        /* Don't care if object was actually removed */
+        (void)ref_mobs_remove(set, &object);
+
+        if (block_index == (BLOCK_SIZE - 1))
+        {
+            b = b->next;
+        }
+    }
+}
+
+bool ref_mobs_has_object(ref_mobs_t *set, const mob_t *object, mob_index_t *index_p)
+{
+    mob_index_t index;
+    ref_mob_block_t *b = set->head;
+
+    for (index = 0; index < set->elements; index++)
+    {
+        mob_index_t block_index = index % BLOCK_SIZE;
+
+        if (object->address == b->address[block_index])
+        {
+            /* NULL address matches all types */
+            if ((b->type[block_index] == object->type) || (object->address == NULL))
+            {
+                if (index_p)
+                {
+                    *index_p = index;
+                }
+                return TRUE;
+            }
+        }
+
+        if (block_index == (BLOCK_SIZE - 1))
+        {
+            b = b->next;
+        }
+    }
+    return FALSE;
+}
+
+static ref_mob_block_t *get_block(ref_mobs_t *set, mob_index_t index)
+{
+    ref_mob_block_t *b = NULL;
+
+    if (index < set->elements)
+    {
+        uint32 steps = index >> BLOCK_SIZE_DIV_SHIFT;
+        b = set->head;
+        while (steps--)
+        {
+            if (b)
+            {
+                b = b->next;
+            }
+        }
+    }
+    return b;
+}
+
+bool ref_mobs_get_object(ref_mobs_t *set, mob_index_t index, mob_t *object)
+{
+    ref_mob_block_t *b = get_block(set, index);
+    if (b)
+    {
+        if (object)
+        {
+            mob_index_t block_index = index % BLOCK_SIZE;
+            object->address = b->address[block_index];
+            object->type = b->type[block_index];
+            object->disambiguator = b->disambiguator[block_index];
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+bool ref_mobs_iterate(ref_mobs_t *set, mob_index_t start, ref_mobs_callback_t cb)
+{
+    ref_mob_block_t *b = get_block(set, start);
+    if (b)
+    {
+        for ( ; start < set->elements; start++)
+        {
+            mob_t object;
+            mob_index_t block_index = start % BLOCK_SIZE;
+
+            object.address = b->address[block_index];
+            object.type = b->type[block_index];
+            object.disambiguator = b->disambiguator[block_index];
+
+            if (!cb(set, start, &object))
+            {
+                return FALSE;
+            }
+
+            if (block_index == (BLOCK_SIZE - 1))
+            {
+                b = b->next;
+            }
+        }
+    }
+    return TRUE;
+}
@@ -0,0 +1,44 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The marshal object set as it was before the address index and block table,
+ * a linked list of blocks searched from the head. Used as the reference the
+ * marshal object set is checked and measured against.
+ */
+#ifndef REF_OBJECT_SET_H
+#define REF_OBJECT_SET_H
+
+#include "marshal_object_set.h"
+
+typedef struct ref_object_block ref_mob_block_t;
+
+/**
+ * A reference marshal object set.
+ */
+typedef struct ref_object_set
+{
+    ref_mob_block_t *head;
+    ref_mob_block_t *tail;
+    mob_index_t elements;
+} ref_mobs_t;
+
+typedef bool (*ref_mobs_callback_t)(ref_mobs_t *set, mob_index_t index,
+                                    mob_t *object);
+
+#define ref_mobs_size(set) (set)->elements
+
+void ref_mobs_init(ref_mobs_t *set);
+void ref_mobs_destroy(ref_mobs_t *set);
+bool ref_mobs_push(ref_mobs_t *set, mob_t *object);
+void ref_mobs_push_unique(ref_mobs_t *set, mob_t *object);
+bool ref_mobs_pop(ref_mobs_t *set, mob_t *object);
+bool ref_mobs_remove(ref_mobs_t *set, const mob_t *object);
+bool ref_mobs_has_object(ref_mobs_t *set, const mob_t *object,
+                         mob_index_t *index);
+bool ref_mobs_get_object(ref_mobs_t *set, mob_index_t index, mob_t *object);
+bool ref_mobs_iterate(ref_mobs_t *set, mob_index_t start,
+                      ref_mobs_callback_t cb);
+void ref_mobs_difference_update(ref_mobs_t *set, const ref_mobs_t *remove);
+
+#endif /* REF_OBJECT_SET_H */
@@ -0,0 +1,82 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * peer_ui and mirror_profile are peer signalling channels with their own
+ * type descriptors. bt_device_handover and bandwidth_manager are marshalled
+ * during handover with the domain type descriptors, of which the harness has
+ * only the types it uses, see include/domain_marshal_types.h.
+ */
+
+#include "specialised_types.h"
+
+/* Each standalone typedef file's enumeration of marshal types starts with a
+   DUMMY enumerator, so two of them are renamed to be included together. */
+#define DUMMY PEER_UI_DUMMY
+#include <peer_ui_marshal_typedef.h>
+#include <peer_ui_typedef.h>
+#undef DUMMY
+#define DUMMY MIRROR_PROFILE_DUMMY
+#include <mirror_profile_marshal_typedef.h>
+#include <mirror_profile_typedef.h>
+#undef DUMMY
+#include <domain_marshal_types.h>
+#include <bt_device_handover_typedef.h>
+#include <bandwidth_manager_typedef.h>
+
+/** The features active in the bandwidth manager when it is marshalled. */
+#define ACTIVE_FEATURES (4)
+
+#define EXPAND_AS_TYPE_DEFINITION(type) (const marshal_type_descriptor_t *)&marshal_type_descriptor_##type,
+static const marshal_type_descriptor_t * const domain_marshal_type_descriptors[] =
+{
+    MARSHAL_COMMON_TYPES_TABLE(EXPAND_AS_TYPE_DEFINITION)
+    BT_DEVICE_MARSHAL_TYPES_TABLE(EXPAND_AS_TYPE_DEFINITION)
+    BT_DEVICE_HANDOVER_MARSHAL_TYPES_TABLE(EXPAND_AS_TYPE_DEFINITION)
+    BANDWIDTH_MANAGER_MARSHAL_TYPES_TABLE(EXPAND_AS_TYPE_DEFINITION)
+};
+#undef EXPAND_AS_TYPE_DEFINITION
+
+/* The bandwidth manager returns its number of active features, which is
+   also kept in the object. */
+uint32 BandwidthManager_ActiveFeaturesSize_cb(const void *parent,
+                                              const marshal_member_descriptor_t *member_descriptor,
+                                              uint32 array_element)
+{
+    UNUSED(member_descriptor);
+    UNUSED(array_element);
+    return ((const bandwidth_manager_info_t *)parent)->active_features_num;
+}
+
+static void prepare_bandwidth_manager_info(void *object)
+{
+    ((bandwidth_manager_info_t *)object)->active_features_num = ACTIVE_FEATURES;
+}
+
+#define PEER_UI(type) \
+    #type, peer_ui_marshal_type_descriptors, NUMBER_OF_PEER_UI_MARSHAL_TYPES, \
+    MARSHAL_TYPE(type), sizeof(type), \
+    {marshal_specialised_##type, unmarshal_specialised_##type}
+
+#define MIRROR_PROFILE(type) \
+    #type, mirror_profile_marshal_type_descriptors, \
+    NUMBER_OF_MIRROR_PROFILE_MARSHAL_TYPES, MARSHAL_TYPE(type), sizeof(type), \
+    {marshal_specialised_##type, unmarshal_specialised_##type}
+
+#define DOMAIN(type) \
+    #type, domain_marshal_type_descriptors, \
+    NUMBER_OF_DOMAIN_MARSHAL_OBJECT_TYPES, MARSHAL_TYPE(type), sizeof(type), \
+    {marshal_specialised_##type, unmarshal_specialised_##type}
+
+const specialised_type_t specialised_types[] =
+{
+    {PEER_UI(peer_ui_event_t), NULL},
+    {MIRROR_PROFILE(mirror_profile_hfp_volume_ind_t), NULL},
+    {MIRROR_PROFILE(mirror_profile_stream_context_t), NULL},
+    {DOMAIN(bt_device_handover_t), NULL},
+    {DOMAIN(bt_device_handover_le_t), NULL},
+    {DOMAIN(bandwidth_manager_info_t), prepare_bandwidth_manager_info},
+};
+
+const size_t specialised_types_len =
+    sizeof(specialised_types) / sizeof(specialised_types[0]);
@@ -0,0 +1,37 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The peer signalling and handover types the specialised marshal functions
+ * are checked and measured on, see specialised_types.c.
+ */
+#ifndef SPECIALISED_TYPES_H
+#define SPECIALISED_TYPES_H
+
+#include <marshal_common.h>
+
+/**
+ * A type marshalled both with the type descriptors and with its specialised
+ * functions.
+ */
+typedef struct
+{
+    const char *name;
+
+    /** The type descriptors of the channel or handover client using the
+     *  type, indexed by marshal type. */
+    const marshal_type_descriptor_t * const *type_desc;
+    size_t num_type_desc;
+
+    marshal_type_t type;
+    size_t size;
+    marshal_specialised_t specialised;
+
+    /** Make an object filled with random octets valid to marshal, or NULL. */
+    void (*prepare)(void *object);
+} specialised_type_t;
+
+extern const specialised_type_t specialised_types[];
+extern const size_t specialised_types_len;
+
+#endif /* SPECIALISED_TYPES_H */
@@ -0,0 +1,164 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacements for the firmware services the message queue uses.
+ *
+ * Time is simulated so runs are repeatable. Blocking interrupts is timed with
+ * the host's clock instead, to measure the work done with interrupts blocked.
+ */
+
+#include "host_stubs.h"
+#include "assert.h"
+#include "int/int.h"
+#include "ipc/ipc.h"
+#include "longtimer/longtimer.h"
+#include "message_router.h"
+#include "pl_timers/pl_timers.h"
+#include "pmalloc/pmalloc.h"
+#include "semphr.h"
+
+#include <stdio.h>
+#include <time.h>
+
+static uint32 now_us;
+static host_blocked_t *recording;
+static unsigned blocked_depth;
+static struct timespec blocked_at;
+
+void host_record_blocked(host_blocked_t *blocked)
+{
+    recording = blocked;
+}
+
+void host_advance_ms(uint32 ms)
+{
+    now_us += ms * US_PER_MS;
+}
+
+TIME get_time(void)
+{
+    return now_us;
+}
+
+MILLITIME get_milli_time(void)
+{
+    return now_us / US_PER_MS;
+}
+
+void block_interrupts(void)
+{
+    if(0 == blocked_depth++ && NULL != recording)
+    {
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &blocked_at);
+    }
+}
+
+void unblock_interrupts(void)
+{
+    assert(blocked_depth > 0);
+    if(0 == --blocked_depth && NULL != recording)
+    {
+        struct timespec end;
+        uint32 ns;
+
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &end);
+        ns = (uint32)((end.tv_sec - blocked_at.tv_sec) * 1000000000L +
+                      (end.tv_nsec - blocked_at.tv_nsec));
+        if(recording->count < recording->size)
+        {
+            recording->ns[recording->count] = ns;
+        }
+        ++recording->count;
+        recording->total_ns += ns;
+        if(ns > recording->max_ns)
+        {
+            recording->max_ns = ns;
+        }
+    }
+}
+
+void *host_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+
+    if(NULL == ptr)
+    {
+        fprintf(stderr, "out of memory\n");
+        abort();
+    }
+    return ptr;
+}
+
+tTimerId timer_schedule_event_in(INTERVAL event_time, TimerEventFunction fn,
+                                 void *data)
+{
+    UNUSED(event_time);
+    UNUSED(fn);
+    UNUSED(data);
+    return 1;
+}
+
+bool timer_cancel_event_by_function(TimerEventFunction fn, void *data)
+{
+    UNUSED(fn);
+    UNUSED(data);
+    return TRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if(sem->given)
+    {
+        return errQUEUE_FULL;
+    }
+    sem->given = TRUE;
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken)
+{
+    *woken = pdFALSE;
+    return xSemaphoreGive(sem);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, uint32 ticks)
+{
+    UNUSED(ticks);
+
+    /* Nothing else runs, so waiting on an empty semaphore never ends. */
+    if(!sem->given)
+    {
+        fprintf(stderr, "waiting for a message that will never come\n");
+        abort();
+    }
+    sem->given = FALSE;
+    return pdPASS;
+}
+
+void ipc_send_batched(IPC_SIGNAL_ID sig_id, const void *prim, uint32 size_bytes)
+{
+    UNUSED(size_bytes);
+
+    /* P0 frees the messages it is told the application has seen. */
+    if(IPC_SIGNAL_ID_APP_MESSAGE_RECEIVED == sig_id)
+    {
+        free(((const IPC_APP_MESSAGE_RECEIVED *)prim)->msg);
+    }
+    else
+    {
+        free(((const IPC_BLUESTACK_PRIM *)prim)->prim);
+    }
+}
+
+bool message_router_handle_routes_to_default(MessageQueue destination)
+{
+    UNUSED(destination);
+    return TRUE;
+}
+
+void trap_api_multitask_message_log(trap_msg_header_t *header, Message msg)
+{
+    UNUSED(header);
+    UNUSED(msg);
+}
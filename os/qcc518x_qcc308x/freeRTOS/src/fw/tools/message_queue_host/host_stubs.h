@@ -0,0 +1,43 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Controls for the host replacements of the firmware services the message
+ * queue uses, see host_stubs.c.
+ */
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include "hydra/hydra_types.h"
+
+/**
+ * How long interrupts were blocked for, over a number of sections.
+ */
+typedef struct
+{
+    /** The length of each section in nanoseconds, up to \c size of them. */
+    uint32 *ns;
+    uint32 size;
+
+    /** The number of sections, which may be more than \c size. */
+    uint32 count;
+
+    /** The total and longest length of all the sections. */
+    uint64_t total_ns;
+    uint32 max_ns;
+} host_blocked_t;
+
+/**
+ * \brief Set where the lengths of the sections with interrupts blocked are
+ * recorded.
+ * \param [in] blocked  The record, or NULL to stop recording.
+ */
+void host_record_blocked(host_blocked_t *blocked);
+
+/**
+ * \brief Advance the simulated clock.
+ * \param [in] ms  The number of milliseconds to advance by.
+ */
+void host_advance_ms(uint32 ms);
+
+#endif /* HOST_STUBS_H */
@@ -0,0 +1,22 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the FreeRTOS types used by the message queue.
+ */
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include "hydra/hydra_types.h"
+
+typedef long BaseType_t;
+
+#define pdFALSE         ((BaseType_t)0)
+#define pdTRUE          ((BaseType_t)1)
+#define pdPASS          (pdTRUE)
+#define errQUEUE_FULL   ((BaseType_t)0)
+#define portMAX_DELAY   (0xffffffffUL)
+
+#define portYIELD_FROM_ISR(x) ((void)(x))
+
+#endif /* FREERTOS_H */
@@ -0,0 +1,17 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's assert.h.
+ */
+#ifndef MESSAGE_QUEUE_HOST_ASSERT_H
+#define MESSAGE_QUEUE_HOST_ASSERT_H
+
+#include_next <assert.h>
+
+#define assert_uses_param(x) ((void)(x))
+#define assert_fn_ret(expr, type, value) \
+    do { type assert_ret_ = (expr); assert(assert_ret_ == (value)); \
+         (void)assert_ret_; } while(0)
+
+#endif /* MESSAGE_QUEUE_HOST_ASSERT_H */
@@ -0,0 +1,33 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's basic types.
+ *
+ * The firmware's types.h defines uint32 as unsigned long, which is 64 bits on
+ * a 64 bit host, so the fixed width types are used instead.
+ */
+#ifndef HYDRA_TYPES_H
+#define HYDRA_TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+typedef uintptr_t   uintptr;
+typedef unsigned    bool;
+
+#define TRUE    ((bool)1)
+#define FALSE   ((bool)0)
+
+#define UNUSED(x)   ((void)(x))
+#define MIN(a, b)   (((a) < (b)) ? (a) : (b))
+#define MAX(a, b)   (((a) > (b)) ? (a) : (b))
+
+#endif /* HYDRA_TYPES_H */
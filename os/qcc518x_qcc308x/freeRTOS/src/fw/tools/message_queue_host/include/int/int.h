@@ -0,0 +1,14 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for blocking interrupts. Measures how long each section
+ * with interrupts blocked takes, see host_stubs.c.
+ */
+#ifndef INT_H
+#define INT_H
+
+void block_interrupts(void);
+void unblock_interrupts(void);
+
+#endif /* INT_H */
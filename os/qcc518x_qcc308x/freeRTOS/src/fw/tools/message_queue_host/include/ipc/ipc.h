@@ -0,0 +1,34 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the IPC to P0, only the primitives the message queue
+ * sends are provided.
+ */
+#ifndef IPC_H
+#define IPC_H
+
+#include "hydra/hydra_types.h"
+#include <message.h>
+
+typedef enum
+{
+    IPC_SIGNAL_ID_BLUESTACK_PRIM_RECEIVED,
+    IPC_SIGNAL_ID_APP_MESSAGE_RECEIVED
+} IPC_SIGNAL_ID;
+
+typedef struct
+{
+    uint16 protocol;
+    void *prim;
+} IPC_BLUESTACK_PRIM;
+
+typedef struct
+{
+    uint16 id;
+    void *msg;
+} IPC_APP_MESSAGE_RECEIVED;
+
+void ipc_send_batched(IPC_SIGNAL_ID sig_id, const void *prim, uint32 size_bytes);
+
+#endif /* IPC_H */
@@ -0,0 +1,32 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's time types, driven by a simulated clock.
+ */
+#ifndef LONGTIMER_H
+#define LONGTIMER_H
+
+#include "hydra/hydra_types.h"
+
+typedef uint32 TIME;
+typedef uint32 MILLITIME;
+typedef int32 INTERVAL;
+
+#define US_PER_MS       (1000)
+#define D_IMMEDIATE     ((MILLITIME)0)
+
+#define time_add(t1, t2)    ((uint32)(t1) + (uint32)(t2))
+#define time_sub(t1, t2)    ((INTERVAL)((uint32)(t1) - (uint32)(t2)))
+#define time_lt(t1, t2)     (time_sub((t1), (t2)) < 0)
+#define time_gt(t1, t2)     (time_sub((t1), (t2)) > 0)
+#define time_le(t1, t2)     (time_sub((t1), (t2)) <= 0)
+#define time_ge(t1, t2)     (time_sub((t1), (t2)) >= 0)
+
+/** The simulated time in microseconds. */
+TIME get_time(void);
+
+/** The simulated time in milliseconds. */
+MILLITIME get_milli_time(void);
+
+#endif /* LONGTIMER_H */
@@ -0,0 +1,60 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the message trap API header.
+ *
+ * The message types come from the generated message_.h. Only the system
+ * messages that the message queue treats specially are defined, with the same
+ * values and payloads as app/message/system_message.h.
+ */
+#ifndef MESSAGE_H
+#define MESSAGE_H
+
+#include "hydra/hydra_types.h"
+#include <message_.h>
+
+typedef struct __SINK *Sink;
+typedef struct __SOURCE *Source;
+
+#define SYSTEM_MESSAGE_BASE_            0x8000
+#define MESSAGE_BLUESTACK_BASE_         (SYSTEM_MESSAGE_BASE_)
+#define MESSAGE_BLUESTACK_END_          (MESSAGE_BLUESTACK_BASE_ + 23)
+#define MESSAGE_MORE_DATA               (SYSTEM_MESSAGE_BASE_ + 33)
+#define MESSAGE_MORE_SPACE              (SYSTEM_MESSAGE_BASE_ + 34)
+#define MESSAGE_USB_ENUMERATED          (SYSTEM_MESSAGE_BASE_ + 43)
+#define MESSAGE_USB_SUSPENDED           (SYSTEM_MESSAGE_BASE_ + 44)
+#define MESSAGE_PSFL_FAULT              (SYSTEM_MESSAGE_BASE_ + 46)
+#define MESSAGE_USB_DECONFIGURED        (SYSTEM_MESSAGE_BASE_ + 47)
+#define MESSAGE_USB_ALT_INTERFACE       (SYSTEM_MESSAGE_BASE_ + 48)
+#define MESSAGE_USB_ATTACHED            (SYSTEM_MESSAGE_BASE_ + 49)
+#define MESSAGE_USB_DETACHED            (SYSTEM_MESSAGE_BASE_ + 50)
+#define MESSAGE_TX_POWER_CHANGE_EVENT   (SYSTEM_MESSAGE_BASE_ + 52)
+
+typedef struct
+{
+    Source source;
+} MessageMoreData;
+
+typedef struct
+{
+    Sink sink;
+} MessageMoreSpace;
+
+typedef struct
+{
+    uint16 config_value;
+} MessageUsbConfigValue;
+
+typedef struct
+{
+    bool has_suspended;
+} MessageUsbSuspended;
+
+typedef struct
+{
+    uint16 interface;
+    uint16 altsetting;
+} MessageUsbAltInterface;
+
+#endif /* MESSAGE_H */
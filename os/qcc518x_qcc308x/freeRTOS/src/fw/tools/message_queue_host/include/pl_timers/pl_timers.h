@@ -0,0 +1,20 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's timed events. Events are never run, the
+ * message queue host test polls the queues instead.
+ */
+#ifndef PL_TIMERS_H
+#define PL_TIMERS_H
+
+#include "longtimer/longtimer.h"
+
+typedef void (*TimerEventFunction)(void *data);
+typedef uint32 tTimerId;
+
+tTimerId timer_schedule_event_in(INTERVAL event_time, TimerEventFunction fn,
+                                 void *data);
+bool timer_cancel_event_by_function(TimerEventFunction fn, void *data);
+
+#endif /* PL_TIMERS_H */
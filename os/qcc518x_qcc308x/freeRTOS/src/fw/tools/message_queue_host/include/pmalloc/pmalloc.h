@@ -0,0 +1,21 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's pool allocator.
+ */
+#ifndef PMALLOC_H
+#define PMALLOC_H
+
+#include <stdlib.h>
+
+#define pmalloc(size)   host_malloc(size)
+#define xpmalloc(size)  malloc(size)
+#define pnew(type)      ((type *)pmalloc(sizeof(type)))
+#define xpnew(type)     ((type *)xpmalloc(sizeof(type)))
+#define pfree(ptr)      free((void *)(ptr))
+
+/** malloc() that aborts when out of memory, like pmalloc(). */
+void *host_malloc(size_t size);
+
+#endif /* PMALLOC_H */
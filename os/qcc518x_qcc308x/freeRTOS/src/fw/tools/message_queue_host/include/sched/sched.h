@@ -0,0 +1,14 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the scheduler interface.
+ */
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "hydra/hydra_types.h"
+
+#define sched_in_interrupt() (FALSE)
+
+#endif /* SCHED_H */
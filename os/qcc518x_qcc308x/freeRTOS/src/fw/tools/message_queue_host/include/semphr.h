@@ -0,0 +1,28 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for FreeRTOS binary semaphores. The host test never waits
+ * on a queue, taking a semaphore that hasn't been given is an error.
+ */
+#ifndef SEMPHR_H
+#define SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct
+{
+    bool given;
+} StaticSemaphore_t;
+
+typedef StaticSemaphore_t *SemaphoreHandle_t;
+
+#define xSemaphoreCreateBinaryStatic(data) \
+    ((data)->given = FALSE, (SemaphoreHandle_t)(data))
+#define vSemaphoreDelete(sem) ((void)(sem))
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *woken);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, uint32 ticks);
+
+#endif /* SEMPHR_H */
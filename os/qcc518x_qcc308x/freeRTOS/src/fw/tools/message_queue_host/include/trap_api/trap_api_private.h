@@ -0,0 +1,53 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the private trap API definitions used by the message
+ * queue.
+ */
+#ifndef TRAP_API_PRIVATE_H_
+#define TRAP_API_PRIVATE_H_
+
+#include "hydra/hydra_types.h"
+#include "int/int.h"
+#include "sched/sched.h"
+#include "ipc/ipc.h"
+#include "pmalloc/pmalloc.h"
+#include <message.h>
+
+#define MESSAGE_REMOVE_CONST(m) ((void *)(uintptr)(m))
+#define VALIDATE_FN_PTR(fn)     ((void)(fn))
+
+typedef enum TRAP_API_LOG_ACTION
+{
+    TRAP_API_LOG_SEND,
+    TRAP_API_LOG_DELIVER,
+    TRAP_API_LOG_FREE,
+    TRAP_API_LOG_CANCEL
+} TRAP_API_LOG_ACTION;
+
+typedef enum
+{
+    CONDITION_WIDTH_UNUSED = 0,
+    CONDITION_WIDTH_16BIT = 16,
+    CONDITION_WIDTH_32BIT = 32
+} CONDITION_WIDTH;
+
+/* The message log isn't packed on the host. */
+#define U8_OFF0_SET(_dst, _src)     ((_dst) = (uint8)(_src))
+#define U16_OFF1_SET(_dst, _src)    ((_dst) = (uint16)(_src))
+#define U32_OFF1_SET(_dst, _src)    ((_dst) = (uint32)(_src))
+
+typedef struct trap_msg_header_
+{
+    uint8 action;
+    uint32 task;
+    uint32 handler;
+    uint16 id;
+    uint32 condition_address;
+    uint32 due_ms;
+} trap_msg_header_t;
+
+void trap_api_multitask_message_log(trap_msg_header_t *header, Message msg);
+
+#endif /* TRAP_API_PRIVATE_H_ */
@@ -0,0 +1,606 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host test and benchmark for the message queue.
+ *
+ * A random mix of the operations the trap API performs on a message queue is
+ * applied to both the message queue and the sorted list queue it replaced, see
+ * ref_queue.c. The workload includes timers up to 300s ahead, conditional
+ * messages on more condition variables than there are condition groups,
+ * filtered stream and USB messages, multicast messages, cancelling and the
+ * pending queries. A number of background timers are kept queued throughout to
+ * set the depth of the queue.
+ *
+ * With MESSAGE_QUEUE_HOST_CHECK defined every result and every delivered
+ * message is checked against the reference. message_queue_check raises
+ * MESSAGE_QUEUE_PRECEDING_VISITS_MAX so that the search for the preceding
+ * message is exhaustive and the results match exactly.
+ * message_queue_bounded keeps the production bound, and also defines
+ * MESSAGE_QUEUE_HOST_BOUNDED to let the reference queue the messages that
+ * the message queue keeps when its search gives up.
+ *
+ * The length of every section with interrupts blocked is measured for both
+ * queues and reported. The host's thread CPU time is used, so the lengths
+ * include the cost of reading it. The longest sections are also affected by
+ * the host's caches and interrupts, the percentiles are more repeatable.
+ */
+
+#include "message_queue.h"
+#include "message_queue_multitask_message.h"
+#include "ref_queue.h"
+#include "host_stubs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FOREGROUND_TASKS    (8)
+#define BACKGROUND_TASKS    (32)
+#define CONDITIONS          (12)
+#define BACKGROUND_ID       (0x100)
+#define MAX_SECTIONS        (1u << 22)
+
+typedef struct
+{
+    message_queue_t *queue;
+    ref_queue_t ref;
+    host_blocked_t blocked_new;
+    host_blocked_t blocked_ref;
+    uint32 step;
+    uint32 delivered;
+    uint32 background;
+    uint32 serial;
+} host_test_t;
+
+static TaskData tasks[FOREGROUND_TASKS + BACKGROUND_TASKS];
+static uint16 conditions16[CONDITIONS / 2];
+static uint32 conditions32[CONDITIONS / 2];
+static uint32 rng_state;
+
+static uint32 rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32 rng_below(uint32 n)
+{
+    return rng() % n;
+}
+
+static Task foreground_task(void)
+{
+    return &tasks[rng_below(FOREGROUND_TASKS)];
+}
+
+static Task any_task(void)
+{
+    return &tasks[rng_below(FOREGROUND_TASKS + BACKGROUND_TASKS)];
+}
+
+static void fail(const host_test_t *test, const char *what)
+{
+    fprintf(stderr, "step %u: %s\n", test->step, what);
+    exit(1);
+}
+
+#ifdef MESSAGE_QUEUE_HOST_CHECK
+#define CHECK(test, cond) do { if(!(cond)) fail((test), #cond); } while(0)
+#else
+#define CHECK(test, cond) ((void)(test), (void)sizeof(cond))
+#endif
+
+static size_t payload_size(MessageId id)
+{
+    switch(id)
+    {
+    case MESSAGE_MORE_DATA:
+        return sizeof(MessageMoreData);
+    case MESSAGE_MORE_SPACE:
+        return sizeof(MessageMoreSpace);
+    case MESSAGE_USB_ENUMERATED:
+    case MESSAGE_USB_DECONFIGURED:
+        return sizeof(MessageUsbConfigValue);
+    case MESSAGE_USB_SUSPENDED:
+        return sizeof(MessageUsbSuspended);
+    case MESSAGE_USB_ALT_INTERFACE:
+        return sizeof(MessageUsbAltInterface);
+    case MESSAGE_USB_ATTACHED:
+    case MESSAGE_USB_DETACHED:
+    case MESSAGE_PSFL_FAULT:
+    case MESSAGE_TX_POWER_CHANGE_EVENT:
+        return 0;
+    default:
+        return sizeof(uint32);
+    }
+}
+
+/**
+ * \brief Fill in a random payload for a message.
+ * \param [out] payload  At least 8 bytes.
+ */
+static void make_payload(host_test_t *test, MessageId id, void *payload)
+{
+    switch(id)
+    {
+    case MESSAGE_MORE_DATA:
+        ((MessageMoreData *)payload)->source =
+            (Source)(uintptr)(1 + rng_below(4));
+        break;
+    case MESSAGE_MORE_SPACE:
+        ((MessageMoreSpace *)payload)->sink = (Sink)(uintptr)(1 + rng_below(4));
+        break;
+    case MESSAGE_USB_ENUMERATED:
+    case MESSAGE_USB_DECONFIGURED:
+        ((MessageUsbConfigValue *)payload)->config_value =
+            (uint16)rng_below(3);
+        break;
+    case MESSAGE_USB_SUSPENDED:
+        ((MessageUsbSuspended *)payload)->has_suspended = rng_below(2);
+        break;
+    case MESSAGE_USB_ALT_INTERFACE:
+        ((MessageUsbAltInterface *)payload)->interface = (uint16)rng_below(3);
+        ((MessageUsbAltInterface *)payload)->altsetting = (uint16)rng_below(3);
+        break;
+    default:
+        memcpy(payload, &test->serial, sizeof(test->serial));
+        break;
+    }
+}
+
+static Message copy_payload(MessageId id, const void *payload)
+{
+    size_t size = payload_size(id);
+    void *copy;
+
+    if(0 == size)
+    {
+        return NULL;
+    }
+    copy = pmalloc(size);
+    memcpy(copy, payload, size);
+    return copy;
+}
+
+/**
+ * \brief Send the same message to both queues.
+ */
+static void send(host_test_t *test, const Task *dests, uint8 num_dests,
+                 MessageId id, MILLITIME delay_ms, const void *condition_addr,
+                 CONDITION_WIDTH condition_width, bool filtered)
+{
+    uint32 payload[2];
+    message_queue_multitask_message_t *mnew;
+    message_queue_multitask_message_t *mref;
+    uint8 i;
+
+    ++test->serial;
+    make_payload(test, id, payload);
+    mnew = message_queue_multitask_message_create(dests, num_dests, id,
+        copy_payload(id, payload), delay_ms, condition_addr, condition_width);
+    mref = message_queue_multitask_message_create(dests, num_dests, id,
+        copy_payload(id, payload), delay_ms, condition_addr, condition_width);
+
+    for(i = 0; i < num_dests; ++i)
+    {
+        bool sent_new = FALSE;
+        bool sent_ref;
+#ifdef MESSAGE_QUEUE_HOST_CHECK
+        message_queue_stats_t stats;
+        uint16 queued;
+
+        message_queue_get_stats(test->queue, &stats);
+        queued = stats.queued;
+#endif
+
+        host_record_blocked(&test->blocked_new);
+        if(filtered)
+        {
+            message_queue_send_filtered(test->queue, &mnew->task_message[i],
+                                        FALSE);
+        }
+        else
+        {
+            message_queue_send(test->queue, &mnew->task_message[i]);
+        }
+        host_record_blocked(NULL);
+
+#ifdef MESSAGE_QUEUE_HOST_CHECK
+        message_queue_get_stats(test->queue, &stats);
+        sent_new = stats.queued > queued;
+#endif
+#ifdef MESSAGE_QUEUE_HOST_BOUNDED
+        /* The bounded search for the preceding message may give up and queue
+           a message that the reference filters out. */
+        test->ref.keep_similar = sent_new;
+#endif
+
+        host_record_blocked(&test->blocked_ref);
+        if(filtered)
+        {
+            sent_ref = ref_queue_send_filtered(&test->ref,
+                                               &mref->task_message[i], FALSE);
+        }
+        else
+        {
+            sent_ref = ref_queue_send(&test->ref, &mref->task_message[i]);
+        }
+        host_record_blocked(NULL);
+
+        test->ref.keep_similar = FALSE;
+        CHECK(test, sent_new == sent_ref);
+    }
+}
+
+static void send_background(host_test_t *test)
+{
+    Task task = &tasks[FOREGROUND_TASKS + rng_below(BACKGROUND_TASKS)];
+
+    send(test, &task, 1, BACKGROUND_ID, 1 + rng_below(60000), NULL,
+         CONDITION_WIDTH_UNUSED, FALSE);
+    ++test->background;
+}
+
+static MILLITIME random_delay(void)
+{
+    uint32 r = rng_below(100);
+
+    if(r < 50)
+    {
+        return rng_below(100);
+    }
+    if(r < 80)
+    {
+        return rng_below(2000);
+    }
+    if(r < 95)
+    {
+        return rng_below(30000);
+    }
+    return rng_below(300000);
+}
+
+static void compare_delivered(host_test_t *test,
+                              const message_queue_task_message_t *a,
+                              const message_queue_task_message_t *b)
+{
+    CHECK(test, (NULL == a) == (NULL == b));
+    if(NULL != a && NULL != b)
+    {
+        MessageId id = a->message->id;
+
+        CHECK(test, a->task == b->task);
+        CHECK(test, id == b->message->id);
+        CHECK(test, 0 == payload_size(id) ||
+                    0 == memcmp(a->message->app_message,
+                                b->message->app_message, payload_size(id)));
+    }
+}
+
+/**
+ * \brief Deliver every message that is due from both queues.
+ */
+static void deliver(host_test_t *test)
+{
+    bool more = TRUE;
+
+    while(more)
+    {
+        message_queue_events_t events;
+        message_queue_task_message_t *a;
+        message_queue_task_message_t *b;
+
+        /* Raise an event so waiting returns rather than blocking when there
+           is no message. */
+        message_queue_event_raise(test->queue, 0);
+        host_record_blocked(&test->blocked_new);
+        a = message_queue_wait_for_message_or_events(test->queue, &events);
+        host_record_blocked(&test->blocked_ref);
+        b = ref_queue_take(&test->ref);
+        host_record_blocked(NULL);
+
+        compare_delivered(test, a, b);
+        more = (NULL != a || NULL != b);
+
+        if(NULL != a)
+        {
+            ++test->delivered;
+            if(BACKGROUND_ID == a->message->id)
+            {
+                --test->background;
+            }
+            message_queue_task_message_destroy(a);
+        }
+        message_queue_task_message_destroy(b);
+    }
+}
+
+static bool match_even(Task task, MessageId id, Message payload)
+{
+    UNUSED(task);
+    UNUSED(payload);
+    return 0 == (id & 1);
+}
+
+static void query(host_test_t *test)
+{
+    Task task = any_task();
+    MessageId id = (MessageId)rng_below(16);
+    int32 due_new = 0;
+    int32 due_ref = 0;
+    uint32 r = rng_below(3);
+
+    if(0 == r)
+    {
+        uint16 pending_new;
+        uint16 pending_ref;
+
+        host_record_blocked(&test->blocked_new);
+        pending_new = message_queue_messages_pending_for_task(test->queue, task,
+                                                              &due_new);
+        host_record_blocked(&test->blocked_ref);
+        pending_ref = ref_queue_messages_pending_for_task(&test->ref, task,
+                                                          &due_ref);
+        host_record_blocked(NULL);
+        CHECK(test, pending_new == pending_ref);
+        CHECK(test, due_new == due_ref);
+    }
+    else if(1 == r)
+    {
+        bool found_new;
+        bool found_ref;
+
+        host_record_blocked(&test->blocked_new);
+        found_new = message_queue_first_pending_for_task(test->queue, task, id,
+                                                         &due_new);
+        host_record_blocked(&test->blocked_ref);
+        found_ref = ref_queue_first_pending_for_task(&test->ref, task, id,
+                                                     &due_ref);
+        host_record_blocked(NULL);
+        CHECK(test, found_new == found_ref);
+        CHECK(test, due_new == due_ref);
+    }
+    else
+    {
+        bool once = rng_below(2);
+        uint16 matched_new;
+        uint16 matched_ref;
+
+        host_record_blocked(&test->blocked_new);
+        matched_new = message_queue_pending_match(test->queue, task, once,
+                                                  match_even);
+        host_record_blocked(&test->blocked_ref);
+        matched_ref = ref_queue_pending_match(&test->ref, task, once,
+                                              match_even);
+        host_record_blocked(NULL);
+        CHECK(test, matched_new == matched_ref);
+    }
+}
+
+static void cancel(host_test_t *test)
+{
+    Task task = foreground_task();
+    MessageId id = (MessageId)rng_below(16);
+    const MessageId *pid = rng_below(4) ? &id : NULL;
+    uint16 max_to_cancel = rng_below(2) ? 1 : 0xFFFF;
+    uint16 cancelled_new;
+    uint16 cancelled_ref;
+
+    host_record_blocked(&test->blocked_new);
+    cancelled_new = message_queue_cancel_messages(test->queue, task, pid,
+                                                  max_to_cancel);
+    host_record_blocked(&test->blocked_ref);
+    cancelled_ref = ref_queue_cancel_messages(&test->ref, task, pid,
+                                              max_to_cancel);
+    host_record_blocked(NULL);
+    CHECK(test, cancelled_new == cancelled_ref);
+}
+
+static void step(host_test_t *test)
+{
+    static const MessageId filtered_ids[] =
+    {
+        MESSAGE_MORE_DATA, MESSAGE_MORE_SPACE, MESSAGE_PSFL_FAULT,
+        MESSAGE_TX_POWER_CHANGE_EVENT, MESSAGE_USB_ENUMERATED,
+        MESSAGE_USB_DECONFIGURED, MESSAGE_USB_SUSPENDED,
+        MESSAGE_USB_ALT_INTERFACE, MESSAGE_USB_ATTACHED, MESSAGE_USB_DETACHED
+    };
+    uint32 r = rng_below(100);
+    Task task = foreground_task();
+
+    if(r < 30)
+    {
+        send(test, &task, 1, (MessageId)rng_below(16), random_delay(), NULL,
+             CONDITION_WIDTH_UNUSED, FALSE);
+    }
+    else if(r < 40)
+    {
+        /* Conditional messages are always sent for immediate delivery. */
+        uint32 c = rng_below(CONDITIONS);
+
+        if(c < CONDITIONS / 2)
+        {
+            send(test, &task, 1, (MessageId)rng_below(16), D_IMMEDIATE,
+                 &conditions16[c], CONDITION_WIDTH_16BIT, FALSE);
+        }
+        else
+        {
+            send(test, &task, 1, (MessageId)rng_below(16), D_IMMEDIATE,
+                 &conditions32[c - CONDITIONS / 2], CONDITION_WIDTH_32BIT,
+                 FALSE);
+        }
+    }
+    else if(r < 45)
+    {
+        uint32 c = rng_below(CONDITIONS);
+        uint32 value = rng_below(2);
+
+        if(c < CONDITIONS / 2)
+        {
+            conditions16[c] = (uint16)value;
+        }
+        else
+        {
+            conditions32[c - CONDITIONS / 2] = value;
+        }
+    }
+    else if(r < 60)
+    {
+        /* Filtered messages are always sent for immediate delivery. */
+        send(test, &task, 1,
+             filtered_ids[rng_below(sizeof(filtered_ids) /
+                                    sizeof(filtered_ids[0]))],
+             D_IMMEDIATE, NULL, CONDITION_WIDTH_UNUSED, TRUE);
+    }
+    else if(r < 63)
+    {
+        /* Messages that may be similar are also checked when sent
+           unfiltered. */
+        send(test, &task, 1,
+             filtered_ids[rng_below(4)], rng_below(2000), NULL,
+             CONDITION_WIDTH_UNUSED, FALSE);
+    }
+    else if(r < 66)
+    {
+        Task dests[3];
+        uint8 num_dests = (uint8)(2 + rng_below(2));
+        uint8 i;
+
+        for(i = 0; i < num_dests; ++i)
+        {
+            dests[i] = any_task();
+        }
+        send(test, dests, num_dests, (MessageId)rng_below(16), random_delay(),
+             NULL, CONDITION_WIDTH_UNUSED, FALSE);
+    }
+    else if(r < 72)
+    {
+        cancel(test);
+    }
+    else if(r < 80)
+    {
+        query(test);
+    }
+    else
+    {
+        host_advance_ms(rng_below(500) ? rng_below(20) : rng_below(10000));
+        deliver(test);
+    }
+}
+
+static int compare_uint32(const void *a, const void *b)
+{
+    uint32 x = *(const uint32 *)a;
+    uint32 y = *(const uint32 *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, host_blocked_t *blocked)
+{
+    uint32 n = MIN(blocked->count, blocked->size);
+    uint32 p99 = 0;
+    uint32 p999 = 0;
+
+    if(n > 0)
+    {
+        qsort(blocked->ns, n, sizeof(blocked->ns[0]), compare_uint32);
+        p99 = blocked->ns[n - 1 - n / 100];
+        p999 = blocked->ns[n - 1 - n / 1000];
+    }
+
+    printf("  %-4s sections %7u  mean %5.0f ns  p99 %6u ns  p99.9 %6u ns  "
+           "max %7u ns\n", name, blocked->count,
+           blocked->count ? (double)blocked->total_ns / blocked->count : 0.0,
+           p99, p999, blocked->max_ns);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: message_queue_host [--seed N] [--steps N] [--depth N]\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    host_test_t test;
+    message_queue_stats_t stats;
+    uint32 steps = 200000;
+    uint32 depth = 100;
+    uint32 seed = 1;
+    int i;
+
+    for(i = 1; i < argc; ++i)
+    {
+        if(i + 1 >= argc)
+        {
+            usage();
+        }
+        if(0 == strcmp(argv[i], "--seed"))
+        {
+            seed = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--steps"))
+        {
+            steps = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--depth"))
+        {
+            depth = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            usage();
+        }
+    }
+
+    memset(&test, 0, sizeof(test));
+    rng_state = seed ? seed : 1;
+    test.queue = message_queue_create();
+    test.blocked_new.ns = host_malloc(MAX_SECTIONS * sizeof(uint32));
+    test.blocked_new.size = MAX_SECTIONS;
+    test.blocked_ref.ns = host_malloc(MAX_SECTIONS * sizeof(uint32));
+    test.blocked_ref.size = MAX_SECTIONS;
+
+    for(test.step = 0; test.step < steps; ++test.step)
+    {
+        while(test.background < depth)
+        {
+            send_background(&test);
+        }
+        step(&test);
+    }
+
+    /* Let everything that can be delivered be delivered. */
+    memset(conditions16, 0, sizeof(conditions16));
+    memset(conditions32, 0, sizeof(conditions32));
+    host_advance_ms(400000);
+    deliver(&test);
+
+    message_queue_get_stats(test.queue, &stats);
+#ifdef MESSAGE_QUEUE_HOST_CHECK
+    CHECK(&test, NULL == test.ref.queued);
+#endif
+    if(0 != stats.queued)
+    {
+        fail(&test, "messages left on the queue");
+    }
+
+    printf("seed %u, %u steps, %u background timers, %u delivered, "
+           "peak %u queued\n", seed, steps, depth, test.delivered,
+           stats.max_queued);
+#ifdef MESSAGE_QUEUE_HOST_BOUNDED
+    printf("  %u similar messages kept by the bounded search\n",
+           test.ref.kept_similar);
+#endif
+    report("new", &test.blocked_new);
+    report("old", &test.blocked_ref);
+
+    message_queue_destroy(test.queue);
+    free(test.blocked_new.ns);
+    free(test.blocked_ref.ns);
+    return 0;
+}
@@ -0,0 +1,255 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The sorted list message queue, see ref_queue.h. Interrupts are blocked for
+ * the same operations as the original so the blocked sections can be compared.
+ */
+
+#include "ref_queue.h"
+#include "int/int.h"
+
+#include <assert.h>
+
+static bool ref_queue_send_locked(ref_queue_t *queue,
+                                  message_queue_task_message_t *task_message)
+{
+    message_queue_task_message_t **p = &queue->queued;
+    message_queue_task_message_t *prev = NULL;
+
+    while(*p && time_ge(task_message->message->due_ms, (*p)->message->due_ms))
+    {
+        prev = *p;
+        p = &prev->next;
+    }
+
+    if(NULL != prev &&
+       message_queue_message_similar(prev->message, task_message->message))
+    {
+        if(!queue->keep_similar)
+        {
+            return FALSE;
+        }
+        ++queue->kept_similar;
+    }
+
+    task_message->next = *p;
+    *p = task_message;
+    return TRUE;
+}
+
+static bool ref_queue_already(ref_queue_t *queue,
+                              const message_queue_task_message_t *task_message)
+{
+    message_queue_task_message_t *queued;
+
+    for(queued = queue->queued; NULL != queued; queued = queued->next)
+    {
+        if(message_queue_task_message_similar(queued, task_message) ||
+           message_queue_task_message_replace(queued, task_message))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+bool ref_queue_send(ref_queue_t *queue,
+                    message_queue_task_message_t *task_message)
+{
+    bool sent;
+
+    block_interrupts();
+    {
+        sent = ref_queue_send_locked(queue, task_message);
+    }
+    unblock_interrupts();
+
+    if(!sent)
+    {
+        message_queue_task_message_destroy(task_message);
+    }
+    return sent;
+}
+
+bool ref_queue_send_filtered(ref_queue_t *queue,
+                             message_queue_task_message_t *task_message,
+                             bool allow_duplicates)
+{
+    bool sent = FALSE;
+
+    block_interrupts();
+    {
+        if(allow_duplicates || !ref_queue_already(queue, task_message))
+        {
+            sent = ref_queue_send_locked(queue, task_message);
+        }
+    }
+    unblock_interrupts();
+
+    if(!sent)
+    {
+        message_queue_task_message_destroy(task_message);
+    }
+    return sent;
+}
+
+message_queue_task_message_t *ref_queue_take(ref_queue_t *queue)
+{
+    message_queue_task_message_t **ptask_message;
+
+    block_interrupts();
+    {
+        for(ptask_message = &queue->queued; NULL != *ptask_message;
+            ptask_message = &(*ptask_message)->next)
+        {
+            message_queue_task_message_t *task_message = *ptask_message;
+            message_queue_message_t *message = task_message->message;
+
+            if(message_queue_message_condition_satisfied(message))
+            {
+                if(message_queue_message_due_in_ms(message,
+                                                   get_milli_time()) <= 0)
+                {
+                    *ptask_message = task_message->next;
+                    unblock_interrupts();
+
+                    task_message->next = NULL;
+                    return task_message;
+                }
+                break;
+            }
+        }
+    }
+    unblock_interrupts();
+
+    return NULL;
+}
+
+uint16 ref_queue_messages_pending_for_task(const ref_queue_t *queue, Task task,
+                                           int32 *first_due_in_ms)
+{
+    message_queue_task_message_t *task_message;
+    uint16 count = 0;
+
+    block_interrupts();
+    {
+        for(task_message = queue->queued; NULL != task_message;
+            task_message = task_message->next)
+        {
+            if(task_message->task == task)
+            {
+                if(0 == count && NULL != first_due_in_ms)
+                {
+                    *first_due_in_ms = time_sub(task_message->message->due_ms,
+                                                get_milli_time());
+                }
+                ++count;
+            }
+        }
+    }
+    unblock_interrupts();
+
+    return count;
+}
+
+bool ref_queue_first_pending_for_task(const ref_queue_t *queue, Task task,
+                                      MessageId id, int32 *first_due_in_ms)
+{
+    message_queue_task_message_t *task_message;
+    bool result = FALSE;
+
+    block_interrupts();
+    {
+        for(task_message = queue->queued; NULL != task_message;
+            task_message = task_message->next)
+        {
+            if(task_message->task == task && task_message->message->id == id)
+            {
+                if(NULL != first_due_in_ms)
+                {
+                    *first_due_in_ms = time_sub(task_message->message->due_ms,
+                                                get_milli_time());
+                }
+                result = TRUE;
+                break;
+            }
+        }
+    }
+    unblock_interrupts();
+
+    return result;
+}
+
+uint16 ref_queue_pending_match(const ref_queue_t *queue, Task task, bool once,
+                               MessageMatchFn match_fn)
+{
+    message_queue_task_message_t *task_message;
+    uint16 count = 0;
+
+    block_interrupts();
+    {
+        for(task_message = queue->queued; NULL != task_message;
+            task_message = task_message->next)
+        {
+            if(task_message->task == task &&
+               match_fn(task, task_message->message->id,
+                        task_message->message->app_message))
+            {
+                count++;
+                if(once)
+                {
+                    break;
+                }
+            }
+        }
+    }
+    unblock_interrupts();
+
+    return count;
+}
+
+uint16 ref_queue_cancel_messages(ref_queue_t *queue, Task task,
+                                 const MessageId *id, uint16 max_to_cancel)
+{
+    message_queue_task_message_t *removed = NULL;
+    message_queue_task_message_t **removed_end = &removed;
+    message_queue_task_message_t **ptask_message;
+    uint16 count = 0;
+
+    block_interrupts();
+    {
+        for(ptask_message = &queue->queued; NULL != *ptask_message; )
+        {
+            message_queue_task_message_t *task_message = *ptask_message;
+
+            if(task_message->task == task &&
+               (NULL == id || task_message->message->id == *id))
+            {
+                *ptask_message = task_message->next;
+                *removed_end = task_message;
+                removed_end = &task_message->next;
+                if(++count >= max_to_cancel)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                ptask_message = &task_message->next;
+            }
+        }
+    }
+    unblock_interrupts();
+
+    *removed_end = NULL;
+    while(NULL != removed)
+    {
+        message_queue_task_message_t *task_message = removed;
+        removed = removed->next;
+        message_queue_task_message_destroy(task_message);
+    }
+
+    return count;
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * The message queue as it was before the timer wheel and per-task index, a
+ * single list sorted by due time. Used as the reference the message queue is
+ * checked and measured against.
+ */
+#ifndef REF_QUEUE_H
+#define REF_QUEUE_H
+
+#include "message_queue_task_message.h"
+
+/**
+ * A reference message queue.
+ */
+typedef struct ref_queue_
+{
+    /** Messages linked through their next member in delivery order. */
+    message_queue_task_message_t *queued;
+
+    /** Queue messages even if they are similar to the message delivered
+        before them, as the message queue does when its search for that
+        message gives up. */
+    bool keep_similar;
+
+    /** The number of messages queued because of keep_similar. */
+    uint32 kept_similar;
+} ref_queue_t;
+
+/**
+ * \brief Send a message.
+ * \return TRUE if the message was queued, FALSE if it was destroyed.
+ */
+bool ref_queue_send(ref_queue_t *queue,
+                    message_queue_task_message_t *task_message);
+
+/**
+ * \brief Send a message unless it is already queued.
+ * \return TRUE if the message was queued, FALSE if it was destroyed.
+ */
+bool ref_queue_send_filtered(ref_queue_t *queue,
+                             message_queue_task_message_t *task_message,
+                             bool allow_duplicates);
+
+/**
+ * \brief Remove the next deliverable message.
+ * \return The message, or NULL if no message is deliverable.
+ */
+message_queue_task_message_t *ref_queue_take(ref_queue_t *queue);
+
+uint16 ref_queue_messages_pending_for_task(const ref_queue_t *queue, Task task,
+                                           int32 *first_due_in_ms);
+
+bool ref_queue_first_pending_for_task(const ref_queue_t *queue, Task task,
+                                      MessageId id, int32 *first_due_in_ms);
+
+uint16 ref_queue_pending_match(const ref_queue_t *queue, Task task, bool once,
+                               MessageMatchFn match_fn);
+
+uint16 ref_queue_cancel_messages(ref_queue_t *queue, Task task,
+                                 const MessageId *id, uint16 max_to_cancel);
+
+#endif /* REF_QUEUE_H */
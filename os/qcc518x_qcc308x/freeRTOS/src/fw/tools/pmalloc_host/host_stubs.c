@@ -0,0 +1,59 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacements for the firmware services pmalloc uses.
+ */
+
+#include "host_stubs.h"
+#include "pmalloc/pmalloc_private.h"
+#include "optim/optim.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const pmalloc_pool_config *host_config;
+static unsigned host_config_len;
+static unsigned blocked_depth;
+
+void host_pmalloc_config(const pmalloc_pool_config *config, unsigned len)
+{
+    assert(len <= MAX_NUM_POOLS);
+    host_config = config;
+    host_config_len = len;
+}
+
+bool get_pmalloc_config(pmalloc_pool_config *pool_config, unsigned *pool_config_len)
+{
+    memset(pool_config, 0, MAX_NUM_POOLS * sizeof(pmalloc_pool_config));
+    memcpy(pool_config, host_config, host_config_len * sizeof(pmalloc_pool_config));
+    *pool_config_len = host_config_len;
+    return TRUE;
+}
+
+void block_interrupts(void)
+{
+    ++blocked_depth;
+}
+
+void unblock_interrupts(void)
+{
+    assert(blocked_depth > 0);
+    --blocked_depth;
+}
+
+uint32 udiv3216(uint16 *r, uint16 d, uint32 n)
+{
+    if(r)
+    {
+        *r = (uint16)(n % d);
+    }
+    return n / d;
+}
+
+void panic(panicid deathbed_confession)
+{
+    fprintf(stderr, "panic 0x%04x\n", (unsigned)deathbed_confession);
+    abort();
+}
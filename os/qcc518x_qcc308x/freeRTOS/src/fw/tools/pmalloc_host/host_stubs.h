@@ -0,0 +1,25 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Controls for the host replacements of the firmware services pmalloc uses,
+ * see host_stubs.c.
+ */
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include "pmalloc/pmalloc.h"
+
+/**
+ * \brief Set the pools the next init_pmalloc() creates.
+ *
+ * The firmware collates its configuration from pmalloc_config_P1.h and the
+ * application's pools, the host takes it ready sorted.
+ *
+ * \param [in] config  The pools in order of increasing size, which must
+ *                     remain valid until init_pmalloc() has been called.
+ * \param [in] len     The number of pools, at most MAX_NUM_POOLS.
+ */
+void host_pmalloc_config(const pmalloc_pool_config *config, unsigned len);
+
+#endif /* HOST_STUBS_H */
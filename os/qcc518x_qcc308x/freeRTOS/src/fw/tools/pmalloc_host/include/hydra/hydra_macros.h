@@ -0,0 +1,13 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's utility macros, pmalloc uses none
+ * beyond those in hydra_types.h.
+ */
+#ifndef HYDRA_MACROS_H
+#define HYDRA_MACROS_H
+
+#include "hydra/hydra_types.h"
+
+#endif /* HYDRA_MACROS_H */
@@ -0,0 +1,13 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's debug log, which is discarded.
+ */
+#ifndef HYDRA_LOG_H
+#define HYDRA_LOG_H
+
+#define L1_DBG_MSG1(fmt, p1)        ((void)(p1))
+#define L1_DBG_MSG2(fmt, p1, p2)    ((void)(p1), (void)(p2))
+
+#endif /* HYDRA_LOG_H */
@@ -0,0 +1,11 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the memory map. There is no P0 on the host, so pfree()
+ * never forwards a block over IPC.
+ */
+#ifndef MEMORY_MAP_H
+#define MEMORY_MAP_H
+
+#endif /* MEMORY_MAP_H */
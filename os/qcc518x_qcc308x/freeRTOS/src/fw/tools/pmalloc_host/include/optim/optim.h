@@ -0,0 +1,15 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for the firmware's optimised arithmetic.
+ */
+#ifndef OPTIM_H
+#define OPTIM_H
+
+#include "hydra/hydra_types.h"
+
+/** Divide n by d, storing the remainder in *r if r isn't NULL. */
+extern uint32 udiv3216(uint16 *r, uint16 d, uint32 n);
+
+#endif /* OPTIM_H */
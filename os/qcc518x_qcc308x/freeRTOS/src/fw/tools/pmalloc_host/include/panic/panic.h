@@ -0,0 +1,18 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host replacement for panic, which reports the panic id and aborts.
+ */
+#ifndef PANIC_H
+#define PANIC_H
+
+typedef enum
+{
+    PANIC_HYDRA_INVALID_PRIVATE_MEMORY_CONFIG = 0x1006,
+    PANIC_HYDRA_INVALID_PRIVATE_MEMORY_POINTER = 0x1007
+} panicid;
+
+void panic(panicid deathbed_confession) __attribute__((noreturn));
+
+#endif /* PANIC_H */
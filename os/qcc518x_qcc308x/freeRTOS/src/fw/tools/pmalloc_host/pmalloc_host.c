@@ -0,0 +1,640 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * Host test and benchmark for the pool lookup in xpmalloc() and pfree().
+ *
+ *   pmalloc_check check [--seed N] [--steps N]
+ *   pmalloc_host bench [--seed N] [--steps N]
+ *
+ * Both replay a trace of allocations and frees. Request sizes are spread
+ * over the earbud application's pools in proportion to their number of
+ * blocks, the trace alternates between filling and draining the pools so
+ * that requests spill to larger pools and fail, and blocks are freed through
+ * pointers into their middle as well as to their start.
+ *
+ * check first requests every size up to beyond the largest pool, then
+ * allocates every block and frees them all in a random order, then replays
+ * the trace. Every block must come from the first pool at least as large as
+ * the request that has a free block, and each free must return the block to
+ * its pool. The per pool hit and spill counts and the counts of lookups by
+ * table and by search must match. The trace is then replayed with the
+ * search the tables replaced, see ref_pmalloc.c, which must return the same
+ * blocks. This is done with the earbud pools and with a few widely spaced
+ * pools.
+ *
+ * bench times replaying the trace with the earbud pools with both. The
+ * host's thread CPU time is used.
+ */
+
+#include "host_stubs.h"
+#include "ref_pmalloc.h"
+#include "pmalloc/pmalloc_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PHASE_STEPS     (2000)
+#define BENCH_MIN_NS    (200000000ull)
+
+/** pmalloc_config_P1.h merged with earbud_pmalloc_pools.c, before spare
+    memory is shared between the pools. The host's free list pointers take 8
+    bytes, so the 4 byte pool is merged into the 8 byte pool. */
+static const pmalloc_pool_config earbud_pools[] =
+{
+    {   8, 46 },
+    {  12, 34 },
+    {  16, 21 },
+    {  20, 33 },
+    {  24, 20 },
+    {  28, 63 },
+    {  32, 21 },
+    {  36, 21 },
+    {  40, 10 },
+    {  56,  9 },
+    {  64,  7 },
+    {  80,  9 },
+    {  84,  1 },
+    { 100,  4 },
+    { 124, 15 },
+    { 160,  8 },
+    { 180,  2 },
+    { 220,  2 },
+    { 288,  1 },
+    { 512,  2 },
+    { 692,  2 },
+};
+
+/** Fewer pools than the search unrolls, and gaps of several size classes. */
+static const pmalloc_pool_config few_pools[] =
+{
+    {   8, 16 },
+    {  32, 16 },
+    { 128,  8 },
+    { 512,  4 },
+};
+
+#define POOLS(p) (p), (unsigned)(sizeof(p) / sizeof((p)[0]))
+
+/** An allocation into a slot, or a free of the block in it through a
+    pointer offset into the block. */
+typedef struct
+{
+    uint16 size;
+    uint16 slot;
+    uint16 offset;
+    bool release;
+} trace_op_t;
+
+typedef struct
+{
+    trace_op_t *ops;
+    uint32 count;
+    uint32 slots;
+} trace_t;
+
+static uint32 rng_state;
+static uint32 step;
+
+static void *slot_ptr[1024];
+
+static uint32 rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32 rng_below(uint32 n)
+{
+    return rng() % n;
+}
+
+static void fail(const char *what)
+{
+    fprintf(stderr, "step %u: %s\n", step, what);
+    exit(1);
+}
+
+#define CHECK(cond) do { if(!(cond)) fail(#cond); } while(0)
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void init_pools(const pmalloc_pool_config *config, unsigned len)
+{
+    host_pmalloc_config(config, len);
+    init_pmalloc();
+}
+
+static uint32 total_blocks(const pmalloc_pool_config *config, unsigned len)
+{
+    uint32 blocks = 0;
+    unsigned i;
+
+    for(i = 0; i < len; ++i)
+    {
+        blocks += (uint32)config[i].blocks;
+    }
+    return blocks;
+}
+
+/** A request size drawn from the pools in proportion to their blocks,
+    occasionally larger than any pool. */
+static uint16 random_size(const pmalloc_pool_config *config, unsigned len,
+                          uint32 blocks)
+{
+    uint32 pick;
+    unsigned i;
+    size_t smallest;
+
+    if(0 == rng_below(64))
+    {
+        return (uint16)(config[len - 1].size + 1 + rng_below(64));
+    }
+    pick = rng_below(blocks);
+    for(i = 0; pick >= config[i].blocks; ++i)
+    {
+        pick -= (uint32)config[i].blocks;
+    }
+    smallest = i ? config[i - 1].size + 1 : 0;
+    return (uint16)(smallest + rng_below((uint32)(config[i].size - smallest + 1)));
+}
+
+static void make_trace(trace_t *trace, const pmalloc_pool_config *config,
+                       unsigned len, uint32 count)
+{
+    uint32 blocks = total_blocks(config, len);
+    uint16 *live = malloc(sizeof(uint16) * (blocks + 64));
+    uint16 *live_size = malloc(sizeof(uint16) * (blocks + 64));
+    uint16 *unused = malloc(sizeof(uint16) * (blocks + 64));
+    uint32 live_count = 0;
+    uint32 unused_count;
+    uint32 i;
+
+    trace->slots = blocks + 64;
+    CHECK(trace->slots <= sizeof(slot_ptr) / sizeof(slot_ptr[0]));
+    trace->ops = malloc(sizeof(trace_op_t) * count);
+    trace->count = count;
+    for(unused_count = 0; unused_count < trace->slots; ++unused_count)
+    {
+        unused[unused_count] = (uint16)unused_count;
+    }
+
+    for(i = 0; i < count; ++i)
+    {
+        trace_op_t *op = &trace->ops[i];
+        bool filling = 0 == (i / PHASE_STEPS) % 2;
+        bool release = rng_below(4) < (filling ? 1u : 3u);
+
+        if(0 == live_count)
+        {
+            release = FALSE;
+        }
+        else if(0 == unused_count)
+        {
+            release = TRUE;
+        }
+
+        if(release)
+        {
+            uint32 at = rng_below(live_count);
+
+            op->release = TRUE;
+            op->slot = live[at];
+            op->size = live_size[at];
+            op->offset = (uint16)(op->size ? rng_below(MIN(op->size, 256u)) : 0);
+            unused[unused_count++] = live[at];
+            live[at] = live[--live_count];
+            live_size[at] = live_size[live_count];
+        }
+        else
+        {
+            op->release = FALSE;
+            op->slot = unused[--unused_count];
+            op->size = random_size(config, len, blocks);
+            op->offset = 0;
+            live[live_count] = op->slot;
+            live_size[live_count++] = op->size;
+        }
+    }
+
+    free(live);
+    free(live_size);
+    free(unused);
+}
+
+static void free_trace(trace_t *trace)
+{
+    free(trace->ops);
+}
+
+/** Replay a trace, recording the block of each allocation if blocks isn't
+    NULL. The slots are freed at the end. */
+static void replay(const trace_t *trace, void *(*alloc)(size_t),
+                   void (*release)(void *), void **blocks)
+{
+    const trace_op_t *op = trace->ops;
+    const trace_op_t *end = op + trace->count;
+    uint32 slot;
+
+    for(; op < end; ++op)
+    {
+        if(op->release)
+        {
+            void *ptr = slot_ptr[op->slot];
+
+            release(ptr ? (char *)ptr + op->offset : NULL);
+            slot_ptr[op->slot] = NULL;
+        }
+        else
+        {
+            slot_ptr[op->slot] = alloc(op->size);
+            if(blocks)
+            {
+                *blocks++ = slot_ptr[op->slot];
+            }
+        }
+    }
+
+    for(slot = 0; slot < trace->slots; ++slot)
+    {
+        if(slot_ptr[slot])
+        {
+            release(slot_ptr[slot]);
+            slot_ptr[slot] = NULL;
+        }
+    }
+}
+
+/* What xpmalloc() and pfree() should do, worked out from the pool control
+   blocks without the lookup tables. */
+
+#ifdef PMALLOC_STATS
+static uint32 expect_hits[MAX_NUM_POOLS];
+static uint32 expect_spills[MAX_NUM_POOLS];
+static uint32 expect_lookups;
+static uint32 expect_searches;
+#endif
+
+static void reset_expected(void)
+{
+#ifdef PMALLOC_STATS
+    memset(expect_hits, 0, sizeof(expect_hits));
+    memset(expect_spills, 0, sizeof(expect_spills));
+    expect_lookups = 0;
+    expect_searches = 0;
+#endif
+}
+
+static const char *pool_start(const pmalloc_pool *pool)
+{
+    return pool == pmalloc_pools ? pmalloc_blocks : pool[-1].pool_end;
+}
+
+static pmalloc_pool *pool_containing(const void *ptr)
+{
+    pmalloc_pool *pool;
+
+    for(pool = pmalloc_pools; pool < pmalloc_pools + pmalloc_num_pools; ++pool)
+    {
+        if(pool_start(pool) <= (const char *)ptr && ptr < pool->pool_end)
+        {
+            return pool;
+        }
+    }
+    return NULL;
+}
+
+static size_t blocks_in(const pmalloc_pool *pool)
+{
+#ifdef PMALLOC_CUMULATIVE_BLOCKS
+    return (pool + 1 < pmalloc_pools + pmalloc_num_pools
+            ? pool[1].cblocks : pmalloc_total_blocks) - pool->cblocks;
+#else
+    return pool->blocks;
+#endif
+}
+
+static void *checked_xpmalloc(size_t size)
+{
+    pmalloc_pool *pools_end = pmalloc_pools + pmalloc_num_pools;
+    pmalloc_pool *ideal = pmalloc_pools;
+    pmalloc_pool *expect;
+    void *ptr;
+
+    while(ideal < pools_end && ideal->size < size)
+    {
+        ++ideal;
+    }
+    for(expect = ideal; expect < pools_end; ++expect)
+    {
+        if(expect->allocated < blocks_in(expect))
+        {
+            break;
+        }
+    }
+
+    ptr = xpmalloc(size);
+
+    if(expect == pools_end)
+    {
+        CHECK(NULL == ptr);
+    }
+    else
+    {
+        CHECK(pool_containing(ptr) == expect);
+        CHECK(0 == ((const char *)ptr - pool_start(expect)) % expect->size);
+        CHECK(expect->allocated <= blocks_in(expect));
+    }
+
+#ifdef PMALLOC_STATS
+    if(ideal < pools_end)
+    {
+        if(expect == ideal)
+        {
+            ++expect_hits[ideal - pmalloc_pools];
+        }
+        else
+        {
+            ++expect_spills[ideal - pmalloc_pools];
+        }
+        if(expect < pools_end)
+        {
+            if(size <= PMALLOC_SIZE_CLASS_MAX)
+            {
+                ++expect_lookups;
+            }
+            else
+            {
+                ++expect_searches;
+            }
+        }
+    }
+#endif
+    ++step;
+    return ptr;
+}
+
+static void checked_pfree(void *ptr)
+{
+    pmalloc_pool *pool = ptr ? pool_containing(ptr) : NULL;
+    size_t allocated = pool ? pool->allocated : 0;
+
+    pfree(ptr);
+
+    if(pool)
+    {
+        CHECK(pool->allocated + 1 == allocated);
+        CHECK(PMALLOC_UNSCRAMBLE_ADDRESS(pool->free) ==
+              (const char *)ptr - ((const char *)ptr - pool_start(pool)) % pool->size);
+#ifdef PMALLOC_STATS
+        if((size_t)((const char *)ptr - (const char *)pmalloc_blocks)
+           >> PMALLOC_ADDR_CLASS_SHIFT < PMALLOC_ADDR_CLASSES)
+        {
+            ++expect_lookups;
+        }
+        else
+        {
+            ++expect_searches;
+        }
+#endif
+    }
+    ++step;
+}
+
+static void check_expected(void)
+{
+#ifdef PMALLOC_STATS
+    size_t i;
+
+    for(i = 0; i < pmalloc_num_pools; ++i)
+    {
+        CHECK(pmalloc_pools[i].hits == expect_hits[i]);
+        CHECK(pmalloc_pools[i].spills == expect_spills[i]);
+    }
+    CHECK(pmalloc_class_lookups == expect_lookups);
+    CHECK(pmalloc_class_searches == expect_searches);
+#endif
+}
+
+/** Request every size, freeing each block through a pointer into it. */
+static void check_sizes(void)
+{
+    size_t largest = pmalloc_pools[pmalloc_num_pools - 1].size;
+    size_t size;
+
+    for(size = 0; size <= largest + PMALLOC_ALIGN_BOUNDARY; ++size)
+    {
+        char *ptr = checked_xpmalloc(size);
+
+        checked_pfree(ptr ? ptr + (size ? rng_below((uint32)size) : 0) : NULL);
+    }
+}
+
+/** Allocate every block, then free them in a random order. */
+static void check_exhaust(uint32 blocks)
+{
+    void **all = malloc(sizeof(void *) * (blocks + 1));
+    uint32 count = 0;
+    size_t i;
+
+    while(NULL != (all[count] = checked_xpmalloc(0)))
+    {
+        CHECK(++count <= blocks);
+    }
+    CHECK(count == blocks);
+
+    while(count)
+    {
+        uint32 at = rng_below(count);
+        pmalloc_pool *pool = pool_containing(all[at]);
+
+        checked_pfree((char *)all[at] + rng_below((uint32)pool->size));
+        all[at] = all[--count];
+    }
+    for(i = 0; i < pmalloc_num_pools; ++i)
+    {
+        CHECK(0 == pmalloc_pools[i].allocated);
+    }
+
+    free(all);
+}
+
+static void check_pools(const char *name, const pmalloc_pool_config *config,
+                        unsigned len, uint32 steps)
+{
+    uint32 blocks = total_blocks(config, len);
+    trace_t trace;
+    void **got;
+    void **ref_got;
+    uint32 allocs = 0;
+    uint32 i;
+
+    make_trace(&trace, config, len, steps);
+    for(i = 0; i < trace.count; ++i)
+    {
+        allocs += !trace.ops[i].release;
+    }
+    got = malloc(sizeof(void *) * allocs);
+    ref_got = malloc(sizeof(void *) * allocs);
+
+    init_pools(config, len);
+    CHECK(pmalloc_num_pools == len);
+    reset_expected();
+    check_sizes();
+    check_exhaust(blocks);
+    check_expected();
+
+    /* Both replays start from freshly initialised pools */
+    init_pools(config, len);
+    reset_expected();
+    replay(&trace, checked_xpmalloc, checked_pfree, got);
+    check_expected();
+
+    init_pools(config, len);
+    replay(&trace, ref_xpmalloc, ref_pfree, ref_got);
+    for(step = 0; step < allocs; ++step)
+    {
+        CHECK(got[step] == ref_got[step]);
+    }
+
+    printf("%s pools: %u pools, %u blocks, %u steps ok\n",
+           name, len, blocks, trace.count);
+#ifdef PMALLOC_STATS
+    {
+        uint32 hits = 0;
+        uint32 spills = 0;
+
+        for(i = 0; i < len; ++i)
+        {
+            hits += expect_hits[i];
+            spills += expect_spills[i];
+        }
+        printf("  %u hits, %u spills, %u lookups by table, %u by search\n",
+               hits, spills, expect_lookups, expect_searches);
+    }
+#endif
+
+    free(got);
+    free(ref_got);
+    free_trace(&trace);
+}
+
+static int check(uint32 steps)
+{
+    check_pools("earbud", POOLS(earbud_pools), steps);
+    check_pools("few", POOLS(few_pools), steps);
+    return 0;
+}
+
+static double time_replay(const trace_t *trace, void *(*alloc)(size_t),
+                          void (*release)(void *))
+{
+    uint64_t total = 0;
+    uint32 runs = 0;
+
+    do
+    {
+        uint64_t start;
+
+        init_pmalloc();
+        start = now_ns();
+        replay(trace, alloc, release, NULL);
+        total += now_ns() - start;
+        ++runs;
+    } while(total < BENCH_MIN_NS);
+
+    return (double)total / ((double)runs * (trace->count + trace->slots));
+}
+
+static int bench(uint32 steps)
+{
+    trace_t trace;
+    uint32 allocs = 0;
+    uint32 small = 0;
+    uint32 i;
+    double tables;
+    double search;
+
+    init_pools(POOLS(earbud_pools));
+    make_trace(&trace, POOLS(earbud_pools), steps);
+    for(i = 0; i < trace.count; ++i)
+    {
+        if(!trace.ops[i].release)
+        {
+            ++allocs;
+            small += trace.ops[i].size <= PMALLOC_SIZE_CLASS_MAX;
+        }
+    }
+
+    tables = time_replay(&trace, xpmalloc, pfree);
+    search = time_replay(&trace, ref_xpmalloc, ref_pfree);
+
+    printf("earbud pools, %u pools, %u steps, %.1f%% of requests <= %u bytes\n",
+           (unsigned)pmalloc_num_pools, trace.count,
+           100.0 * small / allocs, (unsigned)PMALLOC_SIZE_CLASS_MAX);
+    printf("%-20s %10s\n", "", "ns/op");
+    printf("%-20s %10.1f\n", "lookup tables", tables);
+    printf("%-20s %10.1f\n", "search", search);
+
+    free_trace(&trace);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: pmalloc_host check|bench [--seed N] [--steps N]\n");
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32 steps = 200000;
+    uint32 seed = 1;
+    int i;
+
+    if(argc < 2)
+    {
+        usage();
+    }
+    for(i = 2; i < argc; ++i)
+    {
+        if(i + 1 >= argc)
+        {
+            usage();
+        }
+        if(0 == strcmp(argv[i], "--seed"))
+        {
+            seed = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else if(0 == strcmp(argv[i], "--steps"))
+        {
+            steps = (uint32)strtoul(argv[++i], NULL, 0);
+        }
+        else
+        {
+            usage();
+        }
+    }
+    rng_state = seed ? seed : 1;
+
+    if(0 == strcmp(argv[1], "check"))
+    {
+        return check(steps);
+    }
+    if(0 == strcmp(argv[1], "bench"))
+    {
+        return bench(steps);
+    }
+    usage();
+    return 2;
+}
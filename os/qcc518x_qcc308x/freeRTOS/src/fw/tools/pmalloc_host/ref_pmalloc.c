@@ -0,0 +1,337 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * xpmalloc() and pfree() before the pool lookup tables, see ref_pmalloc.h.
+ * Only the options the host builds use are kept.
+ */
+
+#include "ref_pmalloc.h"
+#include "pmalloc/pmalloc_private.h"
+#include "optim/optim.h"
+
+void *ref_xpmalloc(size_t size)
+{
+    void *ptr;
+    const pmalloc_pool *pools_end = pmalloc_pools + pmalloc_num_pools;
+    pmalloc_pool *pool;
+#ifdef PMALLOC_STATS
+    pmalloc_pool *ideal_pool;
+#endif
+#ifdef PMALLOC_RECORD_LENGTHS
+    size_t requested_size = size;
+#endif
+
+    PMALLOC_DEBUG_VALIDATE_POOL_CONTROL();
+
+    /* Determine the pool that contains the smallest blocks that can service
+       this request. */
+    do
+    {
+        pool = pmalloc_pools;
+
+        if (6 <= pmalloc_num_pools)
+        {
+            if (pool[0].size < size)
+            {
+                if (pool[1].size < size)
+                {
+                    if (pool[2].size < size)
+                    {
+                        if (pool[3].size < size)
+                        {
+                            if (pool[4].size < size)
+                            {
+                                if (pool[5].size < size)
+                                {
+                                    pool += 6; /* Continue search below */
+                                }
+                                else
+                                {
+                                    pool += 5;
+                                    continue;
+                                }
+                            }
+                            else
+                            {
+                                pool += 4;
+                                continue;
+                            }
+                        }
+                        else
+                        {
+                            pool += 3;
+                            continue;
+                        }
+                    }
+                    else
+                    {
+                        pool += 2;
+                        continue;
+                    }
+                }
+                else
+                {
+                    pool += 1;
+                    continue;
+                }
+            }
+            else
+            {
+                continue;
+            }
+        }
+
+        if (pools_end[-1].size < size)
+        {
+            return NULL;
+        }
+        while (pool->size < size)
+        {
+            ++pool;
+        }
+    } while (0);
+
+#ifdef PMALLOC_STATS
+    ideal_pool = pool;
+#endif
+
+    /* Find the first pool that has free blocks */
+    do {
+        PMALLOC_BLOCK_INTERRUPTS();
+
+        if (pool->free != PMALLOC_SCRAMBLE_ADDRESS(NULL))
+        {
+            ptr = PMALLOC_UNSCRAMBLE_ADDRESS(pool->free);
+            pool->free = * (void **) ptr;
+
+            ++(pool->allocated);
+
+            PMALLOC_DEBUG_VALIDATE_FREE_LIST(pool, ptr);
+
+            PMALLOC_UNBLOCK_INTERRUPTS();
+
+#ifdef PMALLOC_ADDRESS_CHECK
+            if ((ptr < (pool == pmalloc_pools
+                        ? pmalloc_blocks
+                        : pool[-1].pool_end))
+                || (pool->pool_end <= ptr))
+            {
+                panic(PANIC_HYDRA_INVALID_PRIVATE_MEMORY_POINTER);
+            }
+#endif
+
+            PMALLOC_DEBUG_CHECK_BLOCK(ptr, pool->size);
+
+#ifdef PMALLOC_RECORD_LENGTHS
+            {
+                size_t n;
+
+#ifdef PMALLOC_CUMULATIVE_BLOCKS
+                n = pool->cblocks;
+#else
+                pmalloc_pool *pool2;
+
+                n = 0;
+                for (pool2 = pmalloc_pools; pool2 < pool; ++pool2)
+                {
+                    n += pool2->blocks;
+                }
+#endif
+                n += (size_t)udiv3216(NULL, (uint16)(pool->size),
+                                      (uint32)(((char *) ptr - (char *) (pool == pmalloc_pools
+                                               ? pmalloc_blocks
+                                               : pool[-1].pool_end)))
+                                     );
+
+                if (n < PMALLOC_MAX_DEBUG_BLOCKS)
+                {
+                    if(requested_size <= 0xff)
+                    {
+                        PMALLOC_SET_LENGTH_ATOMIC(n, (uint8_t)requested_size);
+#ifdef PMALLOC_STATS
+                        ideal_pool->curr_ideal_size++;
+                        if (ideal_pool->max_ideal_size < ideal_pool->curr_ideal_size)
+                        {
+                            ideal_pool->max_ideal_size = ideal_pool->curr_ideal_size;
+                        }
+#endif
+                    }
+                }
+            }
+#endif /* PMALLOC_RECORD_LENGTHS */
+
+            return ptr;
+        }
+
+        PMALLOC_UNBLOCK_INTERRUPTS();
+
+    } while (++pool < pools_end);
+
+    return NULL;
+}
+
+void ref_pfree(void *ptr)
+{
+#ifdef PMALLOC_RECORD_LENGTHS
+    pmalloc_pool *pool2;
+#endif
+    size_t n;
+    uint16 rmdr;
+    pmalloc_pool *pool;
+
+    PMALLOC_DEBUG_VALIDATE_POOL_CONTROL();
+
+    /* Determine the pool that contains the specified pointer. */
+    if (pmalloc_blocks <= ptr)
+    {
+        do
+        {
+            pool = pmalloc_pools;
+
+            if (6 <= pmalloc_num_pools)
+            {
+                if (pool[0].pool_end <= ptr)
+                {
+                    if (pool[1].pool_end <= ptr)
+                    {
+                        if (pool[2].pool_end <= ptr)
+                        {
+                            if (pool[3].pool_end <= ptr)
+                            {
+                                if (pool[4].pool_end <= ptr)
+                                {
+                                    if (pool[5].pool_end <= ptr)
+                                    {
+                                        pool += 6; /* Continue search below */
+                                    }
+                                    else
+                                    {
+                                        pool += 5;
+                                        continue;
+                                    }
+                                }
+                                else
+                                {
+                                    pool += 4;
+                                    continue;
+                                }
+                            }
+                            else
+                            {
+                                pool += 3;
+                                continue;
+                            }
+                        }
+                        else
+                        {
+                            pool += 2;
+                            continue;
+                        }
+                    }
+                    else
+                    {
+                        pool += 1;
+                        continue;
+                    }
+                }
+                else
+                {
+                    continue;
+                }
+            }
+
+            if (pmalloc_pools[pmalloc_num_pools - 1].pool_end <= ptr)
+            {
+                panic(PANIC_HYDRA_INVALID_PRIVATE_MEMORY_POINTER);
+            }
+            while (pool->pool_end <= ptr)
+            {
+                ++pool;
+            }
+        } while(0);
+    }
+    else if (ptr == NULL)
+    {
+        return;
+    }
+    else
+    {
+        panic(PANIC_HYDRA_INVALID_PRIVATE_MEMORY_POINTER);
+    }
+
+    /* Round down to the base of the block */
+    n = udiv3216(&rmdr, (uint16)(pool->size),
+                 (uint32)((char *) ptr - (char *) (pool == pmalloc_pools
+                                           ? pmalloc_blocks
+                                           : pool[-1].pool_end))
+                );
+    ptr = (void *) ((char *) ptr - rmdr);
+
+#ifdef PMALLOC_RECORD_LENGTHS
+#ifdef PMALLOC_CUMULATIVE_BLOCKS
+    n += pool->cblocks;
+#else
+    for (pool2 = pmalloc_pools; pool2 < pool; ++pool2)
+    {
+        n += pool2->blocks;
+    }
+#endif
+#endif
+
+    PMALLOC_BLOCK_INTERRUPTS();
+
+#ifdef PMALLOC_STATS
+    if (n < PMALLOC_MAX_DEBUG_BLOCKS)
+    {
+        size_t rq_size = PMALLOC_GET_LENGTH(n);
+
+        if (pool == pmalloc_pools)
+        {
+            pool->curr_ideal_size--;
+        }
+        else
+        {
+            if (pool[-1].size < rq_size)
+            {
+                pool->curr_ideal_size--;
+            }
+            else
+            {
+                for (pool2 = pool-1; pool2 >= pmalloc_pools; pool2--)
+                {
+                    if (pool2->size < rq_size)
+                    {
+                        pool2[1].curr_ideal_size--;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+#endif
+
+#ifdef PMALLOC_RECORD_LENGTHS
+    if (n < PMALLOC_MAX_DEBUG_BLOCKS)
+    {
+        PMALLOC_SET_LENGTH(n, 0);
+    }
+#else
+    UNUSED(n);
+#endif
+
+    PFREE_DEBUG_VALIDATE_FREE_LIST(pool, ptr);
+
+    PFREE_SET_FREE_LIST_PTR(ptr, pool->free, pool->size);
+    pool->free = PMALLOC_SCRAMBLE_ADDRESS(ptr);
+
+#ifdef PMALLOC_POOL_CONTROL_CHECK
+    if (!pool->allocated)
+    {
+        panic(PANIC_HYDRA_INVALID_PRIVATE_MEMORY_POINTER);
+    }
+#endif
+    --(pool->allocated);
+
+    PMALLOC_UNBLOCK_INTERRUPTS();
+}
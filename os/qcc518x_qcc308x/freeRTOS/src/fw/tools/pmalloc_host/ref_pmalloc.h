@@ -0,0 +1,21 @@
+/* Copyright (c) 2023 Qualcomm Technologies International, Ltd. */
+/*   %%version */
+/**
+ * \file
+ * xpmalloc() and pfree() as they were before the pool lookup tables, finding
+ * the pool by searching the pool control blocks. Used as the reference the
+ * lookup tables are checked and measured against.
+ *
+ * Both work on the same pools as the firmware's functions, so the pools must
+ * be reinitialised with init_pmalloc() before switching between them.
+ */
+#ifndef REF_PMALLOC_H
+#define REF_PMALLOC_H
+
+#include "hydra/hydra_types.h"
+
+void *ref_xpmalloc(size_t size);
+
+void ref_pfree(void *ptr);
+
+#endif /* REF_PMALLOC_H */
@@ -0,0 +1,49 @@
+############################################################################
+# CONFIDENTIAL
+#
+# Copyright (c) 2020 Qualcomm Technologies International, Ltd.
+#   %%version
+#
+############################################################################
+"""
+Report the P1 IPC message, interrupt and round trip rates.
+
+Run with
+    python pydbg.py -f apps1:<path to elf> ipc_stats.py
+start the use case of interest, e.g. A2DP streaming with an LE scan running,
+then call ipc_stats() to sample the counters over a period.
+"""
+import time
+import csr
+
+device = csr.dev.attached_device
+apps1 = device.chip.apps_subsystem.p1
+apps1.fw.env.load=True # Force the firmware environment to load first
+
+_COUNTERS = ("send_msgs", "send_interrupts", "transactions", "recv_interrupts")
+
+
+def _sample():
+    ipc_data = apps1.fw.env.globalvars["ipc_data"]
+    return dict((name, getattr(ipc_data, name).value) for name in _COUNTERS)
+
+
+def ipc_stats(period_s=10.0):
+    """
+    Print the per second rate of each IPC counter over period_s seconds.
+    """
+    before = _sample()
+    time.sleep(period_s)
+    after = _sample()
+
+    for name in _COUNTERS:
+        delta = (after[name] - before[name]) & 0xFFFFFFFF
+        print("%-16s %10.1f/s" % (name, delta / period_s))
+
+    msgs = (after["send_msgs"] - before["send_msgs"]) & 0xFFFFFFFF
+    ints = (after["send_interrupts"] - before["send_interrupts"]) & 0xFFFFFFFF
+    if ints:
+        print("%.2f messages sent per interrupt raised on P0" %
+              (float(msgs) / ints))
+    print("Max send buffer bytes used: %d" %
+          apps1.fw.env.globalvars["ipc_data"].max_send_bytes_used.value)
@@ -0,0 +1,52 @@
+############################################################################
+# CONFIDENTIAL
+#
+# Copyright (c) 2020 Qualcomm Technologies International, Ltd.
+#   %%version
+#
+############################################################################
+"""
+Report how well the pmalloc pools serve the allocations made of them.
+
+The firmware must be built with PMALLOC_STATS defined. Run with
+    python pydbg.py -f apps1:<path to elf> pmalloc_stats.py
+then call pmalloc_stats() to print, for each pool, how many allocations it
+was the ideal pool for and how many of those it served itself (hits) rather
+than spilling into a larger pool because it was empty. A pool with a low hit
+rate is a candidate for more blocks in the pool configuration.
+"""
+import csr
+
+device = csr.dev.attached_device
+apps1 = device.chip.apps_subsystem.p1
+apps1.fw.env.load=True # Force the firmware environment to load first
+
+
+def _global(name):
+    return apps1.fw.env.globalvars[name]
+
+
+def pmalloc_stats():
+    """
+    Print the hit rate of each pool and of the pool lookup tables.
+    """
+    num_pools = _global("pmalloc_num_pools").value
+    pools = apps1.fw.env.cast(_global("pmalloc_pools").value, "pmalloc_pool",
+                              array_len=num_pools)
+
+    print("%6s %8s %8s %10s %10s %7s" %
+          ("size", "alloced", "max idl", "hits", "spills", "hit %"))
+    for pool in pools:
+        hits = pool.hits.value
+        spills = pool.spills.value
+        requests = hits + spills
+        rate = 100.0 * hits / requests if requests else 100.0
+        print("%6d %8d %8d %10d %10d %6.1f%%" %
+              (pool.size.value, pool.allocated.value,
+               pool.max_ideal_size.value, hits, spills, rate))
+
+    lookups = _global("pmalloc_class_lookups").value
+    searches = _global("pmalloc_class_searches").value
+    total = lookups + searches
+    print("Pool lookups: %d by table, %d by search (%.1f%% by table)" %
+          (lookups, searches, 100.0 * lookups / total if total else 100.0))
@@ -0,0 +1,84 @@
+############################################################################
+# CONFIDENTIAL
+#
+# Copyright (c) 2020 Qualcomm Technologies International, Ltd.
+#   %%version
+#
+############################################################################
+"""
+Report the VM task message delivery telemetry.
+
+The firmware must be built with INSTALL_MESSAGE_TELEMETRY defined. Run with
+    python pydbg.py -f apps1:<path to elf> vm_task_telemetry.py
+then call vm_task_telemetry() to print the table, sorted by the worst
+delivery lateness, and vm_task_telemetry_reset() to clear it before a test.
+"""
+import csr
+
+device = csr.dev.attached_device
+apps1 = device.chip.apps_subsystem.p1
+apps1.fw.env.load=True # Force the firmware environment to load first
+
+
+def _telemetry():
+    return apps1.fw.env.cus["message_telemetry.c"].localvars["message_telemetry"]
+
+
+def _handler_name(address):
+    try:
+        return apps1.fw.env.functions.get_function_of_pc(address)[1]
+    except Exception:
+        return "0x%08x" % address
+
+
+def _late_bucket_label(bucket, buckets):
+    if bucket == 0:
+        return "0"
+    if bucket == buckets - 1:
+        return ">=%d" % (1 << (bucket - 1))
+    return "%d-%d" % (1 << (bucket - 1), (1 << bucket) - 1)
+
+
+def _report_entry(name, entry, shift):
+    delivered = entry.delivered.value
+    late = [bucket.value for bucket in entry.late]
+    mean_us = entry.total_us.value // delivered if delivered else 0
+    print("%-40s ids 0x%04x+ %8d msgs  exec mean %6dus max %6dus  "
+          "late max %5dms  max VM queue %3d" %
+          (name, entry.id_group.value << shift, delivered, mean_us,
+           entry.max_us.value, entry.max_late_ms.value,
+           entry.max_vm_queued.value))
+    print("    late ms: " + "  ".join(
+        "%s:%d" % (_late_bucket_label(i, len(late)), count)
+        for i, count in enumerate(late) if count))
+
+
+def vm_task_telemetry(shift=4):
+    """
+    Print the telemetry for each handler and message ID group, latest
+    delivery first. shift must match MESSAGE_TELEMETRY_ID_GROUP_SHIFT.
+    """
+    telemetry = _telemetry()
+    used = [entry for entry in telemetry.entries if entry.handler.value]
+    used.sort(key=lambda entry: (entry.max_late_ms.value, entry.max_us.value),
+              reverse=True)
+    for entry in used:
+        _report_entry(_handler_name(entry.handler.value), entry, shift)
+    if telemetry.overflow.delivered.value:
+        print("Table full, %d messages not tracked (last ID 0x%04x)" %
+              (telemetry.overflow.delivered.value,
+               telemetry.overflow_id.value))
+        _report_entry("(overflow)", telemetry.overflow, shift)
+
+    vm = apps1.fw.env.cus["sched_freertos.c"].localvars["vm"]
+    stats = vm.queue.deref.stats
+    print("VM queue: %d queued, %d max queued, %dus max interrupts blocked" %
+          (stats.queued.value, stats.max_queued.value,
+           stats.max_blocked_us.value))
+
+
+def vm_task_telemetry_reset():
+    """
+    Clear the telemetry.
+    """
+    apps1.fw.call.message_telemetry_reset()